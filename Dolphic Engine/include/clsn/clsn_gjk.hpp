@@ -0,0 +1,100 @@
+﻿/**	@file	clsn_gjk.hpp
+ *	@brief	GJK/EPA 法による凸形状同士の衝突判定
+ */
+#pragma once
+#include "structs/t3.hpp"
+#include "math/fvec3.hpp"
+#include <unordered_map>
+
+namespace dlph {
+	class CollisionShape;
+
+	/**	@struct	GjkResult
+	 *	@brief	GJK/EPA の計算結果
+	 */
+	struct GjkResult final {
+		//!	@brief	形状 A 上の最近点 (貫通時は最深点)
+		Float3 pointA;
+		//!	@brief	形状 B 上の最近点 (貫通時は最深点)
+		Float3 pointB;
+		//!	@brief	A から B へ向かう単位法線
+		Float3 normal;
+		//!	@brief	距離 (貫通時は負の貫通深度)
+		float distance;
+		//!	@brief	反復回数
+		unsigned int iteration;
+		//!	@brief	接触 (貫通) しているかどうか
+		bool intersect;
+	};
+
+	/**	@class	GjkCache
+	 *	@brief	形状ペアごとの分離軸を保持するウォームスタート用キャッシュ
+	 *	@details	前フレームの分離軸から探索を再開するため、連続したフレームでは一、二回の反復で収束します。
+	 */
+	class GjkCache final {
+	public	:
+		//!	@brief	ムーブコンストラクタ
+		GjkCache(GjkCache&&) noexcept = default;
+		//!	@brief	コピーコンストラクタ
+		GjkCache(GjkCache const&) = default;
+		//!	@brief	ムーブ代入演算子
+		GjkCache& operator=(GjkCache&&) & noexcept = default;
+		//!	@brief	コピー代入演算子
+		GjkCache& operator=(GjkCache const&) & = default;
+
+		//!	@brief	デフォルトコンストラクタ
+		GjkCache() noexcept;
+		//!	@brief	デストラクタ
+		~GjkCache() noexcept = default;
+
+		/**	@brief	分離軸取得関数
+		 *	@param[in] a 形状 A
+		 *	@param[in] b 形状 B
+		 *	@param[out] axis A から B へ向かう分離軸
+		 *	@retval true キャッシュに存在しました。
+		 *	@retval false キャッシュに存在しませんでした。
+		 */
+		bool const find(CollisionShape const& a, CollisionShape const& b, FVector3& axis) const noexcept;
+		//!	@brief	分離軸保存関数
+		void store(CollisionShape const& a, CollisionShape const& b, FVector3 const& axis) noexcept;
+		//!	@brief	形状ペア削除関数
+		void erase(CollisionShape const& a, CollisionShape const& b) noexcept;
+		//!	@brief	全削除関数
+		void clear() noexcept;
+		//!	@brief	保持しているペア数取得関数
+		size_t const size() const noexcept;
+
+	private	:
+		//!	@brief	ペアキー生成関数
+		static unsigned long long const key(CollisionShape const& a, CollisionShape const& b) noexcept;
+
+		//!	@brief	識別子の小さい形状から大きい形状へ向かう分離軸
+		std::unordered_map<unsigned long long, Float3> m_axes;
+	};
+
+	/**	@brief	距離計算関数 (GJK 法)
+	 *	@param[in] a 形状 A
+	 *	@param[in] b 形状 B
+	 *	@param[in] cache ウォームスタート用キャッシュ (nullptr 可)
+	 *	@param[out] result 計算結果
+	 *	@return	形状間の距離 (接触時は 0)
+	 */
+	float const distance(CollisionShape const& a, CollisionShape const& b, GjkCache* cache, GjkResult& result) noexcept;
+
+	/**	@brief	交差判定関数 (GJK 法)
+	 *	@retval true 接触しています。
+	 *	@retval false 離れています。
+	 */
+	bool const intersect(CollisionShape const& a, CollisionShape const& b, GjkCache* cache = nullptr) noexcept;
+
+	/**	@brief	衝突計算関数 (GJK 法 + EPA 法)
+	 *	@details	芯形状同士の距離を GJK 法で求め、芯形状が重なっている場合のみ EPA 法で貫通深度を求めます。
+	 *	@param[in] a 形状 A
+	 *	@param[in] b 形状 B
+	 *	@param[in] cache ウォームスタート用キャッシュ (nullptr 可)
+	 *	@param[out] result 計算結果
+	 *	@retval true 接触しています。
+	 *	@retval false 離れています。
+	 */
+	bool const collide(CollisionShape const& a, CollisionShape const& b, GjkCache* cache, GjkResult& result) noexcept;
+}
@@ -0,0 +1,78 @@
+﻿/**	@file	clsn_hull.hpp
+ *	@brief	凸包クラス
+ */
+#pragma once
+#include "structs/t3.hpp"
+#include "math/fvec3.hpp"
+#include <vector>
+
+namespace dlph {
+	//!	@brief	隣り合う三角形を同一平面とみなす法線の内積の下限
+	static float constexpr HULL_COPLANAR_COS = 0.9999f;
+
+	/**	@struct	HullFace
+	 *	@brief	凸包の面 (同一平面上の三角形をまとめた凸多角形)
+	 */
+	struct HullFace final {
+		//!	@brief	面の頂点インデックスの開始位置 (indices の中、外側から見て反時計回り)
+		unsigned int first;
+		//!	@brief	面の頂点数 (3 以上)
+		unsigned int count;
+		//!	@brief	外向きの単位法線
+		Float3 normal;
+		//!	@brief	原点からの距離
+		float distance;
+	};
+
+	/**	@class	ConvexHull3
+	 *	@brief	Quickhull 法で構築する凸包
+	 *	@details	Quickhull 法は三角形の面しか作らないため、構築後に隣り合う同一平面上の三角形を一つの凸多角形にまとめます。
+	 *				箱のような形でも面が四角形になり、接触点のクリッピングで面全体を使えます。
+	 */
+	class ConvexHull3 final {
+	public	:
+		//!	@brief	ムーブコンストラクタ
+		ConvexHull3(ConvexHull3&&) noexcept = default;
+		//!	@brief	コピーコンストラクタ
+		ConvexHull3(ConvexHull3 const&) = default;
+		//!	@brief	ムーブ代入演算子
+		ConvexHull3& operator=(ConvexHull3&&) & noexcept = default;
+		//!	@brief	コピー代入演算子
+		ConvexHull3& operator=(ConvexHull3 const&) & = default;
+
+		//!	@brief	デフォルトコンストラクタ
+		ConvexHull3() noexcept;
+		//!	@brief	デストラクタ
+		~ConvexHull3() noexcept = default;
+
+		/**	@brief	初期化関数
+		 *	@param[in] points 点群の先頭へのポインタ
+		 *	@param[in] count 点数
+		 *	@retval true 構築に成功しました。
+		 *	@retval false 点群が退化している (同一平面上にある) ため構築に失敗しました。
+		 */
+		bool const init(Float3 const* points, size_t const& count) noexcept;
+		//!	@brief	終了関数
+		void exit() noexcept;
+
+		//!	@brief	ローカル空間の支持点取得関数
+		FVector3 const support(FVector3 const& dir) const noexcept;
+		//!	@brief	指定方向に最も向いている面のインデックス取得関数
+		size_t const face(FVector3 const& dir) const noexcept;
+
+		//!	@brief	頂点配列取得関数
+		std::vector<Float3> const& vertices() const noexcept;
+		//!	@brief	面配列取得関数
+		std::vector<HullFace> const& faces() const noexcept;
+		//!	@brief	面の頂点インデックス配列取得関数
+		std::vector<unsigned int> const& indices() const noexcept;
+
+	private	:
+		//!	@brief	頂点
+		std::vector<Float3> m_vertices;
+		//!	@brief	面
+		std::vector<HullFace> m_faces;
+		//!	@brief	面の頂点インデックス
+		std::vector<unsigned int> m_indices;
+	};
+}
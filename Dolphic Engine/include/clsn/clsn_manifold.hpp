@@ -0,0 +1,48 @@
+﻿/**	@file	clsn_manifold.hpp
+ *	@brief	接触多様体生成
+ */
+#pragma once
+#include "structs/t3.hpp"
+
+namespace dlph {
+	class CollisionShape;
+	class GjkCache;
+
+	//!	@brief	接触多様体の最大接触点数
+	static unsigned int constexpr MANIFOLD_POINT_CNT = 4U;
+
+	/**	@struct	ContactPoint
+	 *	@brief	接触点
+	 */
+	struct ContactPoint final {
+		//!	@brief	形状 A 上の接触点
+		Float3 pointA;
+		//!	@brief	形状 B 上の接触点
+		Float3 pointB;
+		//!	@brief	貫通深度 (正の値が貫通)
+		float depth;
+	};
+
+	/**	@struct	ContactManifold
+	 *	@brief	接触多様体
+	 */
+	struct ContactManifold final {
+		//!	@brief	接触点
+		ContactPoint points[MANIFOLD_POINT_CNT];
+		//!	@brief	A から B へ向かう単位法線
+		Float3 normal;
+		//!	@brief	接触点数
+		unsigned int count;
+	};
+
+	/**	@brief	接触多様体生成関数
+	 *	@details	GJK/EPA 法で求めた法線を基準に参照面と入射面をクリッピングし、最大四点の接触点を生成します。
+	 *	@param[in] a 形状 A
+	 *	@param[in] b 形状 B
+	 *	@param[in] cache ウォームスタート用キャッシュ (nullptr 可)
+	 *	@param[out] manifold 接触多様体
+	 *	@retval true 接触しています。
+	 *	@retval false 離れています。
+	 */
+	bool const createManifold(CollisionShape const& a, CollisionShape const& b, GjkCache* cache, ContactManifold& manifold) noexcept;
+}
@@ -0,0 +1,121 @@
+﻿/**	@file	clsn_shape.hpp
+ *	@brief	衝突判定用の凸形状クラス
+ */
+#pragma once
+#include "structs/t3.hpp"
+#include "structs/t4.hpp"
+#include "math/fvec3.hpp"
+#include "math/fquat.hpp"
+#include <vector>
+
+namespace dlph {
+	class ConvexHull3;
+
+	/**	@enum	ShapeType
+	 *	@brief	凸形状の種類
+	 */
+	enum class ShapeType : unsigned char {
+		//!	@brief	球
+		Sphere,
+		//!	@brief	直方体
+		Box,
+		//!	@brief	カプセル (ローカル Y 軸方向)
+		Capsule,
+		//!	@brief	凸包
+		Hull
+	};
+
+	/**	@class	CollisionShape
+	 *	@brief	支持写像で表現される凸形状
+	 *	@details	球とカプセルは芯形状 (点・線分) と半径 (マージン) に分けて保持します。
+	 */
+	class CollisionShape final {
+	public	:
+		//!	@brief	ムーブコンストラクタ
+		CollisionShape(CollisionShape&&) noexcept = default;
+		//!	@brief	コピーコンストラクタ
+		CollisionShape(CollisionShape const&) noexcept = default;
+		//!	@brief	ムーブ代入演算子
+		CollisionShape& operator=(CollisionShape&&) & noexcept = default;
+		//!	@brief	コピー代入演算子
+		CollisionShape& operator=(CollisionShape const&) & noexcept = default;
+
+		//!	@brief	デフォルトコンストラクタ
+		CollisionShape() noexcept;
+		//!	@brief	デストラクタ
+		~CollisionShape() noexcept = default;
+
+		//!	@brief	球形状初期化関数
+		CollisionShape& initSphere(float const& radius) noexcept;
+		//!	@brief	直方体形状初期化関数
+		CollisionShape& initBox(FVector3 const& half_extent) noexcept;
+		//!	@brief	カプセル形状初期化関数
+		CollisionShape& initCapsule(float const& radius, float const& half_height) noexcept;
+		/**	@brief	凸包形状初期化関数
+		 *	@param[in] hull 凸包 (形状より長く生存している必要があります)
+		 */
+		CollisionShape& initHull(ConvexHull3 const* hull) noexcept;
+		//!	@brief	終了関数
+		void exit() noexcept;
+
+		//!	@brief	識別子設定関数
+		CollisionShape& id(unsigned int const& arg) noexcept;
+		//!	@brief	位置設定関数
+		CollisionShape& position(FVector3 const& arg) noexcept;
+		//!	@brief	姿勢設定関数
+		CollisionShape& posture(FQuaternion const& arg) noexcept;
+
+		//!	@brief	識別子取得関数
+		unsigned int const id() const noexcept;
+		//!	@brief	形状の種類取得関数
+		ShapeType const type() const noexcept;
+		//!	@brief	位置取得関数
+		FVector3 const position() const noexcept;
+		//!	@brief	姿勢取得関数
+		FQuaternion const posture() const noexcept;
+		//!	@brief	マージン (芯形状を包む半径) 取得関数
+		float const margin() const noexcept;
+
+		/**	@brief	支持点取得関数
+		 *	@param[in] dir ワールド空間の探索方向
+		 *	@return	マージンを含めた最遠点
+		 */
+		FVector3 const support(FVector3 const& dir) const noexcept;
+		/**	@brief	芯形状の支持点取得関数
+		 *	@param[in] dir ワールド空間の探索方向
+		 *	@return	マージンを除いた最遠点
+		 */
+		FVector3 const supportCore(FVector3 const& dir) const noexcept;
+		/**	@brief	支持特徴取得関数
+		 *	@details	指定方向に最も向いている面 (カプセルは線分、球は点) を芯形状で出力します。
+		 *	@param[in] dir ワールド空間の探索方向
+		 *	@param[out] out 特徴を構成する頂点 (面の場合は反時計回り)
+		 */
+		void feature(FVector3 const& dir, std::vector<FVector3>& out) const noexcept;
+
+	private	:
+		//!	@brief	ワールド空間→ローカル空間の方向変換関数
+		FVector3 const toLocal(FVector3 const& dir) const noexcept;
+		//!	@brief	ローカル空間→ワールド空間の座標変換関数
+		FVector3 const toWorld(FVector3 const& pos) const noexcept;
+
+		//!	@brief	位置
+		Float3 m_position;
+		//!	@brief	姿勢
+		Float4 m_posture;
+		//!	@brief	ローカル軸 (姿勢から生成した回転行列の列成分)
+		Float3 m_axis[T3_CNT];
+		//!	@brief	直方体の半分の大きさ
+		Float3 m_extent;
+		//!	@brief	半径
+		float m_radius;
+		//!	@brief	カプセルの線分の半分の長さ
+		float m_halfHeight;
+		//!	@brief	凸包
+		ConvexHull3 const* m_hull;
+		//!	@brief	識別子
+		unsigned int m_id;
+		//!	@brief	形状の種類
+		ShapeType m_type;
+	};
+}
@@ -37,9 +37,13 @@ namespace dlph {
 		T const& operator[](size_t const& idx) const& noexcept;
 
 		//!	@brief	配列の先頭へのポインタ
-		T* const begin() const noexcept;
+		T* const begin() noexcept;
+		//!	@brief	配列の先頭へのポインタ
+		T const* const begin() const noexcept;
+		//!	@brief	配列の末端へのポインタ
+		T* const end() noexcept;
 		//!	@brief	配列の末端へのポインタ
-		T* const end() const noexcept;
+		T const* const end() const noexcept;
 
 		//!	@brief	配列長
 		size_t const size() const noexcept;
@@ -58,7 +62,7 @@ namespace dlph {
 	{
 		size_t idx = 0U;
 		for (T const& arg : args) {
-			if (idx > S) {
+			if (idx >= S) {
 				break;
 			}
 			m_array[idx] = arg;
@@ -96,13 +100,23 @@ namespace dlph {
 	}
 
 	template<typename T, size_t S>
-	inline T* const Array<T, S>::begin() const noexcept {
-		return &m_array[0];
+	inline T* const Array<T, S>::begin() noexcept {
+		return m_array;
+	}
+
+	template<typename T, size_t S>
+	inline T const* const Array<T, S>::begin() const noexcept {
+		return m_array;
+	}
+
+	template<typename T, size_t S>
+	inline T* const Array<T, S>::end() noexcept {
+		return m_array + S;
 	}
 
 	template<typename T, size_t S>
-	inline T* const Array<T, S>::end() const noexcept {
-		return &m_array[S];
+	inline T const* const Array<T, S>::end() const noexcept {
+		return m_array + S;
 	}
 
 	template<typename T, size_t S>
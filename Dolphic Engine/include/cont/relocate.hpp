@@ -0,0 +1,46 @@
+﻿/**	@file	relocate.hpp
+ *	@brief	要素移設関数群
+ */
+#pragma once
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace dlph {
+	/**	@brief	要素移設関数
+	 *	@details	移動元の要素を移動先へムーブ構築し、移動元を破棄します。
+	 *				自明にコピー可能な型は memcpy 一回で移します。領域が重なってはいけません。
+	 *	@param[out] dst 移動先 (未構築の領域)
+	 *	@param[in] src 移動元
+	 *	@param[in] count 要素数
+	 */
+	template<typename T>
+	inline void relocate_n(T* dst, T* src, size_t const& count) noexcept {
+		if (count == 0U) {
+			return;
+		}
+		if constexpr (std::is_trivially_copyable<T>::value) {
+			std::memcpy(static_cast<void*>(dst), static_cast<void const*>(src), sizeof(T) * count);
+		}
+		else {
+			for (size_t idx = 0U; idx < count; ++idx) {
+				::new (static_cast<void*>(dst + idx)) T(std::move(src[idx]));
+				src[idx].~T();
+			}
+		}
+	}
+
+	/**	@brief	要素破棄関数
+	 *	@param[in] ptr 先頭
+	 *	@param[in] count 要素数
+	 */
+	template<typename T>
+	inline void destruct_n(T* ptr, size_t const& count) noexcept {
+		if constexpr (!std::is_trivially_destructible<T>::value) {
+			for (size_t idx = 0U; idx < count; ++idx) {
+				ptr[idx].~T();
+			}
+		}
+	}
+}
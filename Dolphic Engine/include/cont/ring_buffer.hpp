@@ -0,0 +1,93 @@
+﻿/**	@file	ring_buffer.hpp
+ *	@brief	リングバッファクラス
+ */
+#pragma once
+#include "ifs/noncopyable.hpp"
+#include <memory>
+
+namespace dlph {
+	/**	@class	RingBuffer<T, A>
+	 *	@brief	リングバッファクラス
+	 *	@details	容量を 2 のべき乗に切り上げ、添字をビットマスクで折り返す先入れ先出しの配列です。
+	 *				容量は init でのみ変わり、満杯での追加は失敗として扱います。
+	 */
+	template <typename T, typename A = std::allocator<T>>
+	class RingBuffer final :
+		public INoncopyable<RingBuffer<T, A>>
+	{
+	public	:
+		//!	@brief	要素型
+		using value_type = T;
+		//!	@brief	アロケータ型
+		using allocator_type = A;
+
+		//!	@brief	ムーブコンストラクタ
+		RingBuffer(RingBuffer<T, A>&& arg) noexcept;
+		//!	@brief	ムーブ代入演算子
+		RingBuffer<T, A>& operator=(RingBuffer<T, A>&& rhs) & noexcept;
+
+		//!	@brief	アロケータ指定コンストラクタ
+		explicit RingBuffer(A const& alloc) noexcept;
+
+		//!	@brief	デフォルトコンストラクタ
+		RingBuffer() noexcept;
+		//!	@brief	デストラクタ
+		~RingBuffer() noexcept;
+
+		/**	@brief	初期化関数
+		 *	@param[in] capacity 容量 (2 のべき乗に切り上げます)
+		 */
+		bool const init(size_t const& capacity) noexcept;
+		//!	@brief	終了関数
+		void exit() noexcept;
+
+		//!	@brief	添字演算子 (先頭からの位置)
+		T& operator[](size_t const& idx) noexcept;
+		//!	@brief	添字演算子 (先頭からの位置)
+		T const& operator[](size_t const& idx) const noexcept;
+		//!	@brief	先頭要素
+		T& front() noexcept;
+		//!	@brief	末尾要素
+		T& back() noexcept;
+
+		//!	@brief	要素数
+		size_t const size() const noexcept;
+		//!	@brief	容量
+		size_t const capacity() const noexcept;
+		//!	@brief	空かどうか
+		bool const empty() const noexcept;
+		//!	@brief	満杯かどうか
+		bool const full() const noexcept;
+
+		//!	@brief	末尾追加関数
+		bool const push_back(T const& arg) noexcept;
+		//!	@brief	末尾追加関数
+		bool const push_back(T&& arg) noexcept;
+		//!	@brief	末尾構築関数
+		template <typename... Args>
+		T* const emplace_back(Args&&... args) noexcept;
+		//!	@brief	先頭削除関数
+		void pop_front() noexcept;
+		//!	@brief	先頭取り出し関数
+		bool const pop_front(T& out) noexcept;
+		//!	@brief	全削除関数
+		void clear() noexcept;
+
+	private	:
+		//!	@brief	アロケータ特性
+		using Traits = std::allocator_traits<A>;
+
+		//!	@brief	領域
+		T* m_data;
+		//!	@brief	容量 - 1
+		size_t m_mask;
+		//!	@brief	先頭位置 (折り返さない通し番号)
+		size_t m_head;
+		//!	@brief	末尾位置 (折り返さない通し番号)
+		size_t m_tail;
+		//!	@brief	アロケータ
+		A m_alloc;
+	};
+}
+
+#include "ring_buffer.inl"
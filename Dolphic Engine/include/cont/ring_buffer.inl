@@ -0,0 +1,197 @@
+﻿/**	@file	ring_buffer.inl
+ *	@brief	リングバッファクラス
+ */
+#pragma once
+#include "ring_buffer.hpp"
+#include <crtdbg.h>
+#include <new>
+#include <utility>
+
+namespace dlph {
+	template<typename T, typename A>
+	inline RingBuffer<T, A>::RingBuffer(RingBuffer<T, A>&& arg) noexcept :
+		RingBuffer(arg.m_alloc)
+	{
+		m_data = arg.m_data;
+		m_mask = arg.m_mask;
+		m_head = arg.m_head;
+		m_tail = arg.m_tail;
+		arg.m_data = nullptr;
+		arg.m_mask = 0U;
+		arg.m_head = 0U;
+		arg.m_tail = 0U;
+	}
+
+	template<typename T, typename A>
+	inline RingBuffer<T, A>& RingBuffer<T, A>::operator=(RingBuffer<T, A>&& rhs) & noexcept {
+		if (this == &rhs) {
+			return *this;
+		}
+		exit();
+		if constexpr (Traits::propagate_on_container_move_assignment::value) {
+			m_alloc = rhs.m_alloc;
+		}
+		else if (!(m_alloc == rhs.m_alloc)) {
+			//	アロケータが異なるため領域は奪えず、要素だけを移す
+			if (rhs.m_data && init(rhs.capacity())) {
+				while (!rhs.empty()) {
+					emplace_back(std::move(rhs.front()));
+					rhs.pop_front();
+				}
+			}
+			rhs.exit();
+			return *this;
+		}
+		m_data = rhs.m_data;
+		m_mask = rhs.m_mask;
+		m_head = rhs.m_head;
+		m_tail = rhs.m_tail;
+		rhs.m_data = nullptr;
+		rhs.m_mask = 0U;
+		rhs.m_head = 0U;
+		rhs.m_tail = 0U;
+		return *this;
+	}
+
+	template<typename T, typename A>
+	inline RingBuffer<T, A>::RingBuffer(A const& alloc) noexcept :
+		INoncopyable<RingBuffer<T, A>>(),
+		m_data(nullptr),
+		m_mask(0U),
+		m_head(0U),
+		m_tail(0U),
+		m_alloc(alloc)
+	{}
+
+	template<typename T, typename A>
+	inline RingBuffer<T, A>::RingBuffer() noexcept :
+		RingBuffer(A())
+	{}
+
+	template<typename T, typename A>
+	inline RingBuffer<T, A>::~RingBuffer() noexcept {
+		exit();
+	}
+
+	template<typename T, typename A>
+	inline bool const RingBuffer<T, A>::init(size_t const& capacity) noexcept {
+		exit();
+		if (capacity == 0U) {
+			return false;
+		}
+
+		size_t size = 1U;
+		while (size < capacity) {
+			size <<= 1U;
+		}
+		m_data = Traits::allocate(m_alloc, size);
+		m_mask = size - 1U;
+		return true;
+	}
+
+	template<typename T, typename A>
+	inline void RingBuffer<T, A>::exit() noexcept {
+		if (m_data == nullptr) {
+			return;
+		}
+		clear();
+		Traits::deallocate(m_alloc, m_data, m_mask + 1U);
+		m_data = nullptr;
+		m_mask = 0U;
+	}
+
+	template<typename T, typename A>
+	inline T& RingBuffer<T, A>::operator[](size_t const& idx) noexcept {
+#if	defined(_DEBUG) || defined(DEBUG)
+		_ASSERT_EXPR(idx < size(), L"ERROR : INDEX NUMBER EXCEED ARRAY LENGTH.");
+#endif
+		return m_data[(m_head + idx) & m_mask];
+	}
+
+	template<typename T, typename A>
+	inline T const& RingBuffer<T, A>::operator[](size_t const& idx) const noexcept {
+#if	defined(_DEBUG) || defined(DEBUG)
+		_ASSERT_EXPR(idx < size(), L"ERROR : INDEX NUMBER EXCEED ARRAY LENGTH.");
+#endif
+		return m_data[(m_head + idx) & m_mask];
+	}
+
+	template<typename T, typename A>
+	inline T& RingBuffer<T, A>::front() noexcept {
+		return (*this)[0U];
+	}
+
+	template<typename T, typename A>
+	inline T& RingBuffer<T, A>::back() noexcept {
+		return (*this)[size() - 1U];
+	}
+
+	template<typename T, typename A>
+	inline size_t const RingBuffer<T, A>::size() const noexcept {
+		return m_tail - m_head;
+	}
+
+	template<typename T, typename A>
+	inline size_t const RingBuffer<T, A>::capacity() const noexcept {
+		return m_data ? m_mask + 1U : 0U;
+	}
+
+	template<typename T, typename A>
+	inline bool const RingBuffer<T, A>::empty() const noexcept {
+		return m_tail == m_head;
+	}
+
+	template<typename T, typename A>
+	inline bool const RingBuffer<T, A>::full() const noexcept {
+		return size() == capacity();
+	}
+
+	template<typename T, typename A>
+	inline bool const RingBuffer<T, A>::push_back(T const& arg) noexcept {
+		return emplace_back(arg) != nullptr;
+	}
+
+	template<typename T, typename A>
+	inline bool const RingBuffer<T, A>::push_back(T&& arg) noexcept {
+		return emplace_back(std::move(arg)) != nullptr;
+	}
+
+	template<typename T, typename A>
+	template<typename... Args>
+	inline T* const RingBuffer<T, A>::emplace_back(Args&&... args) noexcept {
+		if (full()) {
+			return nullptr;
+		}
+		T* const ptr = ::new (static_cast<void*>(m_data + (m_tail & m_mask))) T(std::forward<Args>(args)...);
+		++m_tail;
+		return ptr;
+	}
+
+	template<typename T, typename A>
+	inline void RingBuffer<T, A>::pop_front() noexcept {
+#if	defined(_DEBUG) || defined(DEBUG)
+		_ASSERT_EXPR(!empty(), L"ERROR : POP FRONT FROM EMPTY RING BUFFER.");
+#endif
+		m_data[m_head & m_mask].~T();
+		++m_head;
+	}
+
+	template<typename T, typename A>
+	inline bool const RingBuffer<T, A>::pop_front(T& out) noexcept {
+		if (empty()) {
+			return false;
+		}
+		out = std::move(front());
+		pop_front();
+		return true;
+	}
+
+	template<typename T, typename A>
+	inline void RingBuffer<T, A>::clear() noexcept {
+		while (!empty()) {
+			pop_front();
+		}
+		m_head = 0U;
+		m_tail = 0U;
+	}
+}
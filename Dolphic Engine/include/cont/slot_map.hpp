@@ -0,0 +1,112 @@
+﻿/**	@file	slot_map.hpp
+ *	@brief	スロットマップクラス
+ */
+#pragma once
+#include "mem/handle.hpp"
+#include <memory>
+#include <vector>
+
+namespace dlph {
+	/**	@class	SlotMap<T, A, U>
+	 *	@brief	スロットマップクラス
+	 *	@details	値を隙間なく連続した配列に並べ、世代付きハンドルを安定したキーとして返します。
+	 *				削除は末尾の値と入れ替えるため O(1) ですが、値の並び順は保たれません。
+	 *				キーはスロット番号を介して値を引くため、値が移動しても無効になりません。
+	 */
+	template <typename T, typename A = std::allocator<T>, typename U = unsigned int>
+	class SlotMap final {
+	public	:
+		//!	@brief	要素型
+		using value_type = T;
+		//!	@brief	アロケータ型
+		using allocator_type = A;
+		//!	@brief	キー
+		using KeyType = Handle<T, U>;
+
+		//!	@brief	ムーブコンストラクタ
+		SlotMap(SlotMap<T, A, U>&& arg) noexcept = default;
+		//!	@brief	コピーコンストラクタ
+		SlotMap(SlotMap<T, A, U> const& arg) noexcept = default;
+		//!	@brief	ムーブ代入演算子
+		SlotMap<T, A, U>& operator=(SlotMap<T, A, U>&& rhs) & noexcept = default;
+		//!	@brief	コピー代入演算子
+		SlotMap<T, A, U>& operator=(SlotMap<T, A, U> const& rhs) & noexcept = default;
+
+		//!	@brief	アロケータ指定コンストラクタ
+		explicit SlotMap(A const& alloc) noexcept;
+
+		//!	@brief	デフォルトコンストラクタ
+		SlotMap() noexcept;
+		//!	@brief	デストラクタ
+		~SlotMap() noexcept = default;
+
+		/**	@brief	構築関数
+		 *	@return 追加した値のキー (スロット数がキーで表せる範囲を超えたら無効なキー)
+		 */
+		template <typename... Args>
+		KeyType const emplace(Args&&... args) noexcept;
+		//!	@brief	追加関数
+		KeyType const insert(T const& arg) noexcept;
+		//!	@brief	追加関数
+		KeyType const insert(T&& arg) noexcept;
+		/**	@brief	削除関数
+		 *	@retval true 削除しました。
+		 *	@retval false キーが無効か、既に削除されています。
+		 */
+		bool const erase(KeyType const& key) noexcept;
+		//!	@brief	全削除関数 (発行済みのキーは全て無効になります)
+		void clear() noexcept;
+		//!	@brief	容量予約関数
+		void reserve(size_t const& capacity) noexcept;
+
+		//!	@brief	取得関数 (無効なキーなら nullptr)
+		T* const get(KeyType const& key) noexcept;
+		//!	@brief	取得関数 (無効なキーなら nullptr)
+		T const* const get(KeyType const& key) const noexcept;
+		//!	@brief	キーが生存している値を指すかどうか
+		bool const contains(KeyType const& key) const noexcept;
+		//!	@brief	連続した配列上の位置からキーを得る関数
+		KeyType const key(size_t const& idx) const noexcept;
+
+		//!	@brief	値の先頭へのポインタ
+		T* const begin() noexcept;
+		//!	@brief	値の先頭へのポインタ
+		T const* const begin() const noexcept;
+		//!	@brief	値の末端へのポインタ
+		T* const end() noexcept;
+		//!	@brief	値の末端へのポインタ
+		T const* const end() const noexcept;
+		//!	@brief	値へのポインタ
+		T* const data() noexcept;
+
+		//!	@brief	要素数
+		size_t const size() const noexcept;
+		//!	@brief	空かどうか
+		bool const empty() const noexcept;
+
+	private	:
+		//!	@brief	番号配列のアロケータ
+		using IndexAllocator = typename std::allocator_traits<A>::template rebind_alloc<U>;
+		//!	@brief	番号配列
+		using IndexArray = std::vector<U, IndexAllocator>;
+
+		//!	@brief	空きスロットが無いことを表す番号
+		static U constexpr FREE_END = KeyType::INDEX_MASK;
+
+		//!	@brief	スロットの確保関数
+		U const acquire() noexcept;
+
+		//!	@brief	値 (連続)
+		std::vector<T, A> m_values;
+		//!	@brief	値の位置に対応するスロット番号
+		IndexArray m_owners;
+		//!	@brief	スロットの値の位置 (空きスロットは次の空きスロット番号)
+		IndexArray m_slots;
+		//!	@brief	スロットの世代 (生存中は奇数)
+		IndexArray m_generations;
+		//!	@brief	空きスロットの先頭
+		U m_free;
+	};
+}
+
+#include "slot_map.inl"
@@ -0,0 +1,163 @@
+﻿/**	@file	slot_map.inl
+ *	@brief	スロットマップクラス
+ */
+#pragma once
+#include "slot_map.hpp"
+#include <utility>
+
+namespace dlph {
+	template<typename T, typename A, typename U>
+	inline SlotMap<T, A, U>::SlotMap(A const& alloc) noexcept :
+		m_values(alloc),
+		m_owners(IndexAllocator(alloc)),
+		m_slots(IndexAllocator(alloc)),
+		m_generations(IndexAllocator(alloc)),
+		m_free(FREE_END)
+	{}
+
+	template<typename T, typename A, typename U>
+	inline SlotMap<T, A, U>::SlotMap() noexcept :
+		SlotMap(A())
+	{}
+
+	template<typename T, typename A, typename U>
+	template<typename... Args>
+	inline typename SlotMap<T, A, U>::KeyType const SlotMap<T, A, U>::emplace(Args&&... args) noexcept {
+		U const slot = acquire();
+		if (slot == FREE_END) {
+			OutputDebugStringA("ERROR : SLOT MAP EXCEEDED HANDLE INDEX RANGE.\n");
+			return {};
+		}
+
+		m_slots[slot] = static_cast<U>(m_values.size());
+		m_generations[slot] = (m_generations[slot] + 1U) & KeyType::GENERATION_MASK;
+		m_values.emplace_back(std::forward<Args>(args)...);
+		m_owners.push_back(slot);
+		return KeyType::make(slot, m_generations[slot]);
+	}
+
+	template<typename T, typename A, typename U>
+	inline typename SlotMap<T, A, U>::KeyType const SlotMap<T, A, U>::insert(T const& arg) noexcept {
+		return emplace(arg);
+	}
+
+	template<typename T, typename A, typename U>
+	inline typename SlotMap<T, A, U>::KeyType const SlotMap<T, A, U>::insert(T&& arg) noexcept {
+		return emplace(std::move(arg));
+	}
+
+	template<typename T, typename A, typename U>
+	inline bool const SlotMap<T, A, U>::erase(KeyType const& key) noexcept {
+		if (!contains(key)) {
+			return false;
+		}
+
+		U const slot = key.index();
+		U const idx = m_slots[slot];
+		U const last = static_cast<U>(m_values.size() - 1U);
+		if (idx != last) {
+			//	末尾の値を空いた位置へ移し、その持ち主のスロットを付け替える
+			m_values[idx] = std::move(m_values[last]);
+			m_owners[idx] = m_owners[last];
+			m_slots[m_owners[idx]] = idx;
+		}
+		m_values.pop_back();
+		m_owners.pop_back();
+
+		m_generations[slot] = (m_generations[slot] + 1U) & KeyType::GENERATION_MASK;
+		m_slots[slot] = m_free;
+		m_free = slot;
+		return true;
+	}
+
+	template<typename T, typename A, typename U>
+	inline void SlotMap<T, A, U>::clear() noexcept {
+		for (U const& slot : m_owners) {
+			m_generations[slot] = (m_generations[slot] + 1U) & KeyType::GENERATION_MASK;
+			m_slots[slot] = m_free;
+			m_free = slot;
+		}
+		m_values.clear();
+		m_owners.clear();
+	}
+
+	template<typename T, typename A, typename U>
+	inline void SlotMap<T, A, U>::reserve(size_t const& capacity) noexcept {
+		m_values.reserve(capacity);
+		m_owners.reserve(capacity);
+		m_slots.reserve(capacity);
+		m_generations.reserve(capacity);
+	}
+
+	template<typename T, typename A, typename U>
+	inline T* const SlotMap<T, A, U>::get(KeyType const& key) noexcept {
+		return contains(key) ? &m_values[m_slots[key.index()]] : nullptr;
+	}
+
+	template<typename T, typename A, typename U>
+	inline T const* const SlotMap<T, A, U>::get(KeyType const& key) const noexcept {
+		return contains(key) ? &m_values[m_slots[key.index()]] : nullptr;
+	}
+
+	template<typename T, typename A, typename U>
+	inline bool const SlotMap<T, A, U>::contains(KeyType const& key) const noexcept {
+		U const slot = key.index();
+		return key && slot < m_generations.size() && m_generations[slot] == key.generation();
+	}
+
+	template<typename T, typename A, typename U>
+	inline typename SlotMap<T, A, U>::KeyType const SlotMap<T, A, U>::key(size_t const& idx) const noexcept {
+		U const slot = m_owners[idx];
+		return KeyType::make(slot, m_generations[slot]);
+	}
+
+	template<typename T, typename A, typename U>
+	inline T* const SlotMap<T, A, U>::begin() noexcept {
+		return m_values.data();
+	}
+
+	template<typename T, typename A, typename U>
+	inline T const* const SlotMap<T, A, U>::begin() const noexcept {
+		return m_values.data();
+	}
+
+	template<typename T, typename A, typename U>
+	inline T* const SlotMap<T, A, U>::end() noexcept {
+		return m_values.data() + m_values.size();
+	}
+
+	template<typename T, typename A, typename U>
+	inline T const* const SlotMap<T, A, U>::end() const noexcept {
+		return m_values.data() + m_values.size();
+	}
+
+	template<typename T, typename A, typename U>
+	inline T* const SlotMap<T, A, U>::data() noexcept {
+		return m_values.data();
+	}
+
+	template<typename T, typename A, typename U>
+	inline size_t const SlotMap<T, A, U>::size() const noexcept {
+		return m_values.size();
+	}
+
+	template<typename T, typename A, typename U>
+	inline bool const SlotMap<T, A, U>::empty() const noexcept {
+		return m_values.empty();
+	}
+
+	template<typename T, typename A, typename U>
+	inline U const SlotMap<T, A, U>::acquire() noexcept {
+		if (m_free != FREE_END) {
+			U const slot = m_free;
+			m_free = m_slots[slot];
+			return slot;
+		}
+		if (m_generations.size() >= FREE_END) {
+			return FREE_END;
+		}
+		m_slots.push_back(0U);
+		m_generations.push_back(0U);
+		return static_cast<U>(m_generations.size() - 1U);
+	}
+}
@@ -0,0 +1,120 @@
+﻿/**	@file	small_vector.hpp
+ *	@brief	小容量最適化付き可変長配列クラス
+ */
+#pragma once
+#include <initializer_list>
+#include <memory>
+
+namespace dlph {
+	/**	@class	SmallVector<T, N, A>
+	 *	@brief	小容量最適化付き可変長配列クラス
+	 *	@details	N 要素までは内部の領域に置き、超えた時点でアロケータから確保します。
+	 *				伸長やムーブでは要素を relocate_n で移すため、自明にコピー可能な型は memcpy で移ります。
+	 */
+	template <typename T, size_t N, typename A = std::allocator<T>>
+	class SmallVector final {
+		static_assert(N > 0U, "SmallVector needs at least one inline element.");
+	public	:
+		//!	@brief	要素型
+		using value_type = T;
+		//!	@brief	アロケータ型
+		using allocator_type = A;
+
+		//!	@brief	ムーブコンストラクタ
+		SmallVector(SmallVector<T, N, A>&& arg) noexcept;
+		//!	@brief	コピーコンストラクタ
+		SmallVector(SmallVector<T, N, A> const& arg) noexcept;
+		//!	@brief	ムーブ代入演算子
+		SmallVector<T, N, A>& operator=(SmallVector<T, N, A>&& rhs) & noexcept;
+		//!	@brief	コピー代入演算子
+		SmallVector<T, N, A>& operator=(SmallVector<T, N, A> const& rhs) & noexcept;
+
+		//!	@brief	初期化子コンストラクタ
+		SmallVector(std::initializer_list<T> const& args, A const& alloc = A()) noexcept;
+		//!	@brief	アロケータ指定コンストラクタ
+		explicit SmallVector(A const& alloc) noexcept;
+
+		//!	@brief	デフォルトコンストラクタ
+		SmallVector() noexcept;
+		//!	@brief	デストラクタ
+		~SmallVector() noexcept;
+
+		//!	@brief	添字演算子
+		T& operator[](size_t const& idx) noexcept;
+		//!	@brief	添字演算子
+		T const& operator[](size_t const& idx) const noexcept;
+
+		//!	@brief	配列の先頭へのポインタ
+		T* const begin() noexcept;
+		//!	@brief	配列の先頭へのポインタ
+		T const* const begin() const noexcept;
+		//!	@brief	配列の末端へのポインタ
+		T* const end() noexcept;
+		//!	@brief	配列の末端へのポインタ
+		T const* const end() const noexcept;
+		//!	@brief	先頭要素
+		T& front() noexcept;
+		//!	@brief	末尾要素
+		T& back() noexcept;
+		//!	@brief	データへのポインタ
+		T* const data() noexcept;
+		//!	@brief	データへのポインタ
+		T const* const data() const noexcept;
+
+		//!	@brief	要素数
+		size_t const size() const noexcept;
+		//!	@brief	容量
+		size_t const capacity() const noexcept;
+		//!	@brief	空かどうか
+		bool const empty() const noexcept;
+		//!	@brief	内部の領域を使っているかどうか
+		bool const inlined() const noexcept;
+
+		//!	@brief	容量確保関数
+		void reserve(size_t const& capacity) noexcept;
+		//!	@brief	要素数変更関数
+		void resize(size_t const& size) noexcept;
+		//!	@brief	全削除関数 (容量は保持します)
+		void clear() noexcept;
+
+		//!	@brief	末尾追加関数
+		void push_back(T const& arg) noexcept;
+		//!	@brief	末尾追加関数
+		void push_back(T&& arg) noexcept;
+		//!	@brief	末尾構築関数
+		template <typename... Args>
+		T& emplace_back(Args&&... args) noexcept;
+		//!	@brief	末尾削除関数
+		void pop_back() noexcept;
+		//!	@brief	削除関数 (後続の要素を詰めます)
+		T* const erase(T const* pos) noexcept;
+		//!	@brief	削除関数 (末尾の要素と入れ替えるため順序は保たれません)
+		void erase_unordered(T const* pos) noexcept;
+
+	private	:
+		//!	@brief	アロケータ特性
+		using Traits = std::allocator_traits<A>;
+
+		//!	@brief	内部の領域へのポインタ
+		T* const local() noexcept;
+		//!	@brief	容量変更関数
+		void grow(size_t const& capacity) noexcept;
+		//!	@brief	他の配列の要素を奪う関数
+		void steal(SmallVector<T, N, A>& arg) noexcept;
+		//!	@brief	領域解放関数
+		void release() noexcept;
+
+		//!	@brief	要素の先頭
+		T* m_data;
+		//!	@brief	要素数
+		size_t m_size;
+		//!	@brief	容量
+		size_t m_capacity;
+		//!	@brief	アロケータ
+		A m_alloc;
+		//!	@brief	内部の領域
+		alignas(T) unsigned char m_inline[sizeof(T) * N];
+	};
+}
+
+#include "small_vector.inl"
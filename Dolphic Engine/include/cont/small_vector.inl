@@ -0,0 +1,297 @@
+﻿/**	@file	small_vector.inl
+ *	@brief	小容量最適化付き可変長配列クラス
+ */
+#pragma once
+#include "small_vector.hpp"
+#include "relocate.hpp"
+#include <crtdbg.h>
+
+namespace dlph {
+	template<typename T, size_t N, typename A>
+	inline SmallVector<T, N, A>::SmallVector(SmallVector<T, N, A>&& arg) noexcept :
+		SmallVector(arg.m_alloc)
+	{
+		steal(arg);
+	}
+
+	template<typename T, size_t N, typename A>
+	inline SmallVector<T, N, A>::SmallVector(SmallVector<T, N, A> const& arg) noexcept :
+		SmallVector(Traits::select_on_container_copy_construction(arg.m_alloc))
+	{
+		reserve(arg.m_size);
+		for (T const& elem : arg) {
+			push_back(elem);
+		}
+	}
+
+	template<typename T, size_t N, typename A>
+	inline SmallVector<T, N, A>& SmallVector<T, N, A>::operator=(SmallVector<T, N, A>&& rhs) & noexcept {
+		if (this == &rhs) {
+			return *this;
+		}
+		release();
+		if constexpr (Traits::propagate_on_container_move_assignment::value) {
+			m_alloc = rhs.m_alloc;
+			steal(rhs);
+		}
+		else if (m_alloc == rhs.m_alloc) {
+			steal(rhs);
+		}
+		else {
+			//	アロケータが異なる (std::pmr など) ため領域は奪えず、要素だけを移す
+			reserve(rhs.m_size);
+			relocate_n(m_data, rhs.m_data, rhs.m_size);
+			m_size = rhs.m_size;
+			rhs.m_size = 0U;
+			rhs.release();
+		}
+		return *this;
+	}
+
+	template<typename T, size_t N, typename A>
+	inline SmallVector<T, N, A>& SmallVector<T, N, A>::operator=(SmallVector<T, N, A> const& rhs) & noexcept {
+		if (this != &rhs) {
+			clear();
+			reserve(rhs.m_size);
+			for (T const& elem : rhs) {
+				push_back(elem);
+			}
+		}
+		return *this;
+	}
+
+	template<typename T, size_t N, typename A>
+	inline SmallVector<T, N, A>::SmallVector(std::initializer_list<T> const& args, A const& alloc) noexcept :
+		SmallVector(alloc)
+	{
+		reserve(args.size());
+		for (T const& arg : args) {
+			push_back(arg);
+		}
+	}
+
+	template<typename T, size_t N, typename A>
+	inline SmallVector<T, N, A>::SmallVector(A const& alloc) noexcept :
+		m_data(nullptr),
+		m_size(0U),
+		m_capacity(N),
+		m_alloc(alloc)
+	{
+		m_data = local();
+	}
+
+	template<typename T, size_t N, typename A>
+	inline SmallVector<T, N, A>::SmallVector() noexcept :
+		SmallVector(A())
+	{}
+
+	template<typename T, size_t N, typename A>
+	inline SmallVector<T, N, A>::~SmallVector() noexcept {
+		release();
+	}
+
+	template<typename T, size_t N, typename A>
+	inline T& SmallVector<T, N, A>::operator[](size_t const& idx) noexcept {
+#if	defined(_DEBUG) || defined(DEBUG)
+		_ASSERT_EXPR(idx < m_size, L"ERROR : INDEX NUMBER EXCEED ARRAY LENGTH.");
+#endif
+		return m_data[idx];
+	}
+
+	template<typename T, size_t N, typename A>
+	inline T const& SmallVector<T, N, A>::operator[](size_t const& idx) const noexcept {
+#if	defined(_DEBUG) || defined(DEBUG)
+		_ASSERT_EXPR(idx < m_size, L"ERROR : INDEX NUMBER EXCEED ARRAY LENGTH.");
+#endif
+		return m_data[idx];
+	}
+
+	template<typename T, size_t N, typename A>
+	inline T* const SmallVector<T, N, A>::begin() noexcept {
+		return m_data;
+	}
+
+	template<typename T, size_t N, typename A>
+	inline T const* const SmallVector<T, N, A>::begin() const noexcept {
+		return m_data;
+	}
+
+	template<typename T, size_t N, typename A>
+	inline T* const SmallVector<T, N, A>::end() noexcept {
+		return m_data + m_size;
+	}
+
+	template<typename T, size_t N, typename A>
+	inline T const* const SmallVector<T, N, A>::end() const noexcept {
+		return m_data + m_size;
+	}
+
+	template<typename T, size_t N, typename A>
+	inline T& SmallVector<T, N, A>::front() noexcept {
+		return (*this)[0U];
+	}
+
+	template<typename T, size_t N, typename A>
+	inline T& SmallVector<T, N, A>::back() noexcept {
+		return (*this)[m_size - 1U];
+	}
+
+	template<typename T, size_t N, typename A>
+	inline T* const SmallVector<T, N, A>::data() noexcept {
+		return m_data;
+	}
+
+	template<typename T, size_t N, typename A>
+	inline T const* const SmallVector<T, N, A>::data() const noexcept {
+		return m_data;
+	}
+
+	template<typename T, size_t N, typename A>
+	inline size_t const SmallVector<T, N, A>::size() const noexcept {
+		return m_size;
+	}
+
+	template<typename T, size_t N, typename A>
+	inline size_t const SmallVector<T, N, A>::capacity() const noexcept {
+		return m_capacity;
+	}
+
+	template<typename T, size_t N, typename A>
+	inline bool const SmallVector<T, N, A>::empty() const noexcept {
+		return m_size == 0U;
+	}
+
+	template<typename T, size_t N, typename A>
+	inline bool const SmallVector<T, N, A>::inlined() const noexcept {
+		return m_data == reinterpret_cast<T const*>(m_inline);
+	}
+
+	template<typename T, size_t N, typename A>
+	inline void SmallVector<T, N, A>::reserve(size_t const& capacity) noexcept {
+		if (capacity > m_capacity) {
+			grow(capacity);
+		}
+	}
+
+	template<typename T, size_t N, typename A>
+	inline void SmallVector<T, N, A>::resize(size_t const& size) noexcept {
+		if (size < m_size) {
+			destruct_n(m_data + size, m_size - size);
+			m_size = size;
+			return;
+		}
+		reserve(size);
+		for (; m_size < size; ++m_size) {
+			::new (static_cast<void*>(m_data + m_size)) T();
+		}
+	}
+
+	template<typename T, size_t N, typename A>
+	inline void SmallVector<T, N, A>::clear() noexcept {
+		destruct_n(m_data, m_size);
+		m_size = 0U;
+	}
+
+	template<typename T, size_t N, typename A>
+	inline void SmallVector<T, N, A>::push_back(T const& arg) noexcept {
+		emplace_back(arg);
+	}
+
+	template<typename T, size_t N, typename A>
+	inline void SmallVector<T, N, A>::push_back(T&& arg) noexcept {
+		emplace_back(std::move(arg));
+	}
+
+	template<typename T, size_t N, typename A>
+	template<typename... Args>
+	inline T& SmallVector<T, N, A>::emplace_back(Args&&... args) noexcept {
+		if (m_size == m_capacity) {
+			//	引数が自身の要素を指していても壊さないよう、新しい領域へ先に構築してから移す
+			size_t const capacity = m_capacity * 2U;
+			T* const ptr = Traits::allocate(m_alloc, capacity);
+			::new (static_cast<void*>(ptr + m_size)) T(std::forward<Args>(args)...);
+			relocate_n(ptr, m_data, m_size);
+			if (!inlined()) {
+				Traits::deallocate(m_alloc, m_data, m_capacity);
+			}
+			m_data = ptr;
+			m_capacity = capacity;
+		}
+		else {
+			::new (static_cast<void*>(m_data + m_size)) T(std::forward<Args>(args)...);
+		}
+		return m_data[m_size++];
+	}
+
+	template<typename T, size_t N, typename A>
+	inline void SmallVector<T, N, A>::pop_back() noexcept {
+#if	defined(_DEBUG) || defined(DEBUG)
+		_ASSERT_EXPR(m_size > 0U, L"ERROR : POP BACK FROM EMPTY ARRAY.");
+#endif
+		--m_size;
+		m_data[m_size].~T();
+	}
+
+	template<typename T, size_t N, typename A>
+	inline T* const SmallVector<T, N, A>::erase(T const* pos) noexcept {
+		T* const target = m_data + (pos - m_data);
+		for (T* ptr = target; ptr + 1 < end(); ++ptr) {
+			*ptr = std::move(*(ptr + 1));
+		}
+		pop_back();
+		return target;
+	}
+
+	template<typename T, size_t N, typename A>
+	inline void SmallVector<T, N, A>::erase_unordered(T const* pos) noexcept {
+		T* const target = m_data + (pos - m_data);
+		if (target != &back()) {
+			*target = std::move(back());
+		}
+		pop_back();
+	}
+
+	template<typename T, size_t N, typename A>
+	inline T* const SmallVector<T, N, A>::local() noexcept {
+		return reinterpret_cast<T*>(m_inline);
+	}
+
+	template<typename T, size_t N, typename A>
+	inline void SmallVector<T, N, A>::grow(size_t const& capacity) noexcept {
+		T* const ptr = Traits::allocate(m_alloc, capacity);
+		relocate_n(ptr, m_data, m_size);
+		if (!inlined()) {
+			Traits::deallocate(m_alloc, m_data, m_capacity);
+		}
+		m_data = ptr;
+		m_capacity = capacity;
+	}
+
+	template<typename T, size_t N, typename A>
+	inline void SmallVector<T, N, A>::steal(SmallVector<T, N, A>& arg) noexcept {
+		if (arg.inlined()) {
+			relocate_n(local(), arg.m_data, arg.m_size);
+			m_data = local();
+			m_capacity = N;
+		}
+		else {
+			m_data = arg.m_data;
+			m_capacity = arg.m_capacity;
+		}
+		m_size = arg.m_size;
+
+		arg.m_data = arg.local();
+		arg.m_size = 0U;
+		arg.m_capacity = N;
+	}
+
+	template<typename T, size_t N, typename A>
+	inline void SmallVector<T, N, A>::release() noexcept {
+		clear();
+		if (!inlined()) {
+			Traits::deallocate(m_alloc, m_data, m_capacity);
+		}
+		m_data = local();
+		m_capacity = N;
+	}
+}
@@ -0,0 +1,102 @@
+﻿/**	@file	static_vector.hpp
+ *	@brief	固定容量可変長配列クラス
+ */
+#pragma once
+#include <initializer_list>
+
+namespace dlph {
+	/**	@class	StaticVector<T, N>
+	 *	@brief	固定容量可変長配列クラス
+	 *	@details	容量 N の領域を内部に持ち、要素数だけを実行時に変えます。ヒープ確保は一切行いません。
+	 *				満杯での追加は失敗として扱います (push_back は false、emplace_back は nullptr を返します)。
+	 */
+	template <typename T, size_t N>
+	class StaticVector final {
+		static_assert(N > 0U, "StaticVector needs at least one element.");
+	public	:
+		//!	@brief	要素型
+		using value_type = T;
+
+		//!	@brief	ムーブコンストラクタ
+		StaticVector(StaticVector<T, N>&& arg) noexcept;
+		//!	@brief	コピーコンストラクタ
+		StaticVector(StaticVector<T, N> const& arg) noexcept;
+		//!	@brief	ムーブ代入演算子
+		StaticVector<T, N>& operator=(StaticVector<T, N>&& rhs) & noexcept;
+		//!	@brief	コピー代入演算子
+		StaticVector<T, N>& operator=(StaticVector<T, N> const& rhs) & noexcept;
+
+		//!	@brief	初期化子コンストラクタ (容量を超えた分は捨てます)
+		StaticVector(std::initializer_list<T> const& args) noexcept;
+
+		//!	@brief	デフォルトコンストラクタ
+		StaticVector() noexcept;
+		//!	@brief	デストラクタ
+		~StaticVector() noexcept;
+
+		//!	@brief	添字演算子
+		T& operator[](size_t const& idx) noexcept;
+		//!	@brief	添字演算子
+		T const& operator[](size_t const& idx) const noexcept;
+
+		//!	@brief	配列の先頭へのポインタ
+		T* const begin() noexcept;
+		//!	@brief	配列の先頭へのポインタ
+		T const* const begin() const noexcept;
+		//!	@brief	配列の末端へのポインタ
+		T* const end() noexcept;
+		//!	@brief	配列の末端へのポインタ
+		T const* const end() const noexcept;
+		//!	@brief	先頭要素
+		T& front() noexcept;
+		//!	@brief	末尾要素
+		T& back() noexcept;
+		//!	@brief	データへのポインタ
+		T* const data() noexcept;
+		//!	@brief	データへのポインタ
+		T const* const data() const noexcept;
+
+		//!	@brief	要素数
+		size_t const size() const noexcept;
+		//!	@brief	容量
+		static size_t constexpr capacity() noexcept {
+			return N;
+		}
+		//!	@brief	空かどうか
+		bool const empty() const noexcept;
+		//!	@brief	満杯かどうか
+		bool const full() const noexcept;
+
+		//!	@brief	要素数変更関数 (容量で切り詰めます)
+		void resize(size_t const& size) noexcept;
+		//!	@brief	全削除関数
+		void clear() noexcept;
+
+		//!	@brief	末尾追加関数
+		bool const push_back(T const& arg) noexcept;
+		//!	@brief	末尾追加関数
+		bool const push_back(T&& arg) noexcept;
+		//!	@brief	末尾構築関数
+		template <typename... Args>
+		T* const emplace_back(Args&&... args) noexcept;
+		//!	@brief	末尾削除関数
+		void pop_back() noexcept;
+		//!	@brief	削除関数 (後続の要素を詰めます)
+		T* const erase(T const* pos) noexcept;
+		//!	@brief	削除関数 (末尾の要素と入れ替えるため順序は保たれません)
+		void erase_unordered(T const* pos) noexcept;
+
+	private	:
+		//!	@brief	要素の先頭
+		T* const local() noexcept;
+		//!	@brief	要素の先頭
+		T const* const local() const noexcept;
+
+		//!	@brief	要素数
+		size_t m_size;
+		//!	@brief	領域
+		alignas(T) unsigned char m_storage[sizeof(T) * N];
+	};
+}
+
+#include "static_vector.inl"
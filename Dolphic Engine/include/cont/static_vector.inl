@@ -0,0 +1,219 @@
+﻿/**	@file	static_vector.inl
+ *	@brief	固定容量可変長配列クラス
+ */
+#pragma once
+#include "static_vector.hpp"
+#include "relocate.hpp"
+#include <crtdbg.h>
+
+namespace dlph {
+	template<typename T, size_t N>
+	inline StaticVector<T, N>::StaticVector(StaticVector<T, N>&& arg) noexcept :
+		StaticVector()
+	{
+		relocate_n(local(), arg.local(), arg.m_size);
+		m_size = arg.m_size;
+		arg.m_size = 0U;
+	}
+
+	template<typename T, size_t N>
+	inline StaticVector<T, N>::StaticVector(StaticVector<T, N> const& arg) noexcept :
+		StaticVector()
+	{
+		for (T const& elem : arg) {
+			push_back(elem);
+		}
+	}
+
+	template<typename T, size_t N>
+	inline StaticVector<T, N>& StaticVector<T, N>::operator=(StaticVector<T, N>&& rhs) & noexcept {
+		if (this != &rhs) {
+			clear();
+			relocate_n(local(), rhs.local(), rhs.m_size);
+			m_size = rhs.m_size;
+			rhs.m_size = 0U;
+		}
+		return *this;
+	}
+
+	template<typename T, size_t N>
+	inline StaticVector<T, N>& StaticVector<T, N>::operator=(StaticVector<T, N> const& rhs) & noexcept {
+		if (this != &rhs) {
+			clear();
+			for (T const& elem : rhs) {
+				push_back(elem);
+			}
+		}
+		return *this;
+	}
+
+	template<typename T, size_t N>
+	inline StaticVector<T, N>::StaticVector(std::initializer_list<T> const& args) noexcept :
+		StaticVector()
+	{
+		for (T const& arg : args) {
+			if (!push_back(arg)) {
+				break;
+			}
+		}
+	}
+
+	template<typename T, size_t N>
+	inline StaticVector<T, N>::StaticVector() noexcept :
+		m_size(0U)
+	{}
+
+	template<typename T, size_t N>
+	inline StaticVector<T, N>::~StaticVector() noexcept {
+		clear();
+	}
+
+	template<typename T, size_t N>
+	inline T& StaticVector<T, N>::operator[](size_t const& idx) noexcept {
+#if	defined(_DEBUG) || defined(DEBUG)
+		_ASSERT_EXPR(idx < m_size, L"ERROR : INDEX NUMBER EXCEED ARRAY LENGTH.");
+#endif
+		return local()[idx];
+	}
+
+	template<typename T, size_t N>
+	inline T const& StaticVector<T, N>::operator[](size_t const& idx) const noexcept {
+#if	defined(_DEBUG) || defined(DEBUG)
+		_ASSERT_EXPR(idx < m_size, L"ERROR : INDEX NUMBER EXCEED ARRAY LENGTH.");
+#endif
+		return local()[idx];
+	}
+
+	template<typename T, size_t N>
+	inline T* const StaticVector<T, N>::begin() noexcept {
+		return local();
+	}
+
+	template<typename T, size_t N>
+	inline T const* const StaticVector<T, N>::begin() const noexcept {
+		return local();
+	}
+
+	template<typename T, size_t N>
+	inline T* const StaticVector<T, N>::end() noexcept {
+		return local() + m_size;
+	}
+
+	template<typename T, size_t N>
+	inline T const* const StaticVector<T, N>::end() const noexcept {
+		return local() + m_size;
+	}
+
+	template<typename T, size_t N>
+	inline T& StaticVector<T, N>::front() noexcept {
+		return (*this)[0U];
+	}
+
+	template<typename T, size_t N>
+	inline T& StaticVector<T, N>::back() noexcept {
+		return (*this)[m_size - 1U];
+	}
+
+	template<typename T, size_t N>
+	inline T* const StaticVector<T, N>::data() noexcept {
+		return local();
+	}
+
+	template<typename T, size_t N>
+	inline T const* const StaticVector<T, N>::data() const noexcept {
+		return local();
+	}
+
+	template<typename T, size_t N>
+	inline size_t const StaticVector<T, N>::size() const noexcept {
+		return m_size;
+	}
+
+	template<typename T, size_t N>
+	inline bool const StaticVector<T, N>::empty() const noexcept {
+		return m_size == 0U;
+	}
+
+	template<typename T, size_t N>
+	inline bool const StaticVector<T, N>::full() const noexcept {
+		return m_size == N;
+	}
+
+	template<typename T, size_t N>
+	inline void StaticVector<T, N>::resize(size_t const& size) noexcept {
+		size_t const target = size < N ? size : N;
+		if (target < m_size) {
+			destruct_n(local() + target, m_size - target);
+			m_size = target;
+			return;
+		}
+		for (; m_size < target; ++m_size) {
+			::new (static_cast<void*>(local() + m_size)) T();
+		}
+	}
+
+	template<typename T, size_t N>
+	inline void StaticVector<T, N>::clear() noexcept {
+		destruct_n(local(), m_size);
+		m_size = 0U;
+	}
+
+	template<typename T, size_t N>
+	inline bool const StaticVector<T, N>::push_back(T const& arg) noexcept {
+		return emplace_back(arg) != nullptr;
+	}
+
+	template<typename T, size_t N>
+	inline bool const StaticVector<T, N>::push_back(T&& arg) noexcept {
+		return emplace_back(std::move(arg)) != nullptr;
+	}
+
+	template<typename T, size_t N>
+	template<typename... Args>
+	inline T* const StaticVector<T, N>::emplace_back(Args&&... args) noexcept {
+		if (m_size == N) {
+			return nullptr;
+		}
+		T* const ptr = ::new (static_cast<void*>(local() + m_size)) T(std::forward<Args>(args)...);
+		++m_size;
+		return ptr;
+	}
+
+	template<typename T, size_t N>
+	inline void StaticVector<T, N>::pop_back() noexcept {
+#if	defined(_DEBUG) || defined(DEBUG)
+		_ASSERT_EXPR(m_size > 0U, L"ERROR : POP BACK FROM EMPTY ARRAY.");
+#endif
+		--m_size;
+		local()[m_size].~T();
+	}
+
+	template<typename T, size_t N>
+	inline T* const StaticVector<T, N>::erase(T const* pos) noexcept {
+		T* const target = local() + (pos - local());
+		for (T* ptr = target; ptr + 1 < end(); ++ptr) {
+			*ptr = std::move(*(ptr + 1));
+		}
+		pop_back();
+		return target;
+	}
+
+	template<typename T, size_t N>
+	inline void StaticVector<T, N>::erase_unordered(T const* pos) noexcept {
+		T* const target = local() + (pos - local());
+		if (target != &back()) {
+			*target = std::move(back());
+		}
+		pop_back();
+	}
+
+	template<typename T, size_t N>
+	inline T* const StaticVector<T, N>::local() noexcept {
+		return reinterpret_cast<T*>(m_storage);
+	}
+
+	template<typename T, size_t N>
+	inline T const* const StaticVector<T, N>::local() const noexcept {
+		return reinterpret_cast<T const*>(m_storage);
+	}
+}
@@ -7,6 +7,8 @@
 #include "dlph/dlph_ttexsize.hpp"
 #include "dlph/dlph_tfile.hpp"
 #include "d3d12_tview.hpp"
+#include "d3d12_desc_alloc.hpp"
+#include "d3d12_mem_alloc.hpp"
 #include "d3d12_swapchain.hpp"
 #include <vector>
 #include <dxgi1_6.h>
@@ -54,12 +56,16 @@ namespace dlph {
 		ID3D12Resource2*& operator[](unsigned int const& idx)& noexcept;
 		//!	@brief	添え字演算子
 		ID3D12Resource2* const& operator[](unsigned int const& idx) const& noexcept;
+		//!	@brief	配置リソースのメモリ取得関数 (CreatePlacedResource で作った場合だけ使います)
+		D3D12Allocation& getAllocation(unsigned int const& idx)& noexcept;
 
 	private	:
-		//!	@brief	記述子ヒープ
-		ID3D12DescriptorHeap* m_heap;
+		//!	@brief	記述子の区間 (D3D12DescriptorAllocator から借りる)
+		D3D12DescriptorRange m_range;
 		//!	@brief	リソース
 		std::vector<ID3D12Resource2*> m_rsrces;
+		//!	@brief	配置リソースのメモリ
+		std::vector<D3D12Allocation> m_allocs;
 		//!	@brief	ヒープの種類
 		D3D12ViewType m_type;
 
@@ -84,6 +90,16 @@ namespace dlph {
 	 */
 	bool const createRenderTargetView(D3D12Buffer& buffer, D3D12SwapChain const& swapchain, unsigned int const& size) noexcept;
 
+	/**	@brief	GPU 専用バッファ生成関数
+	 *	@param[in] buffer 対象バッファ
+	 *	@param[in] data データの先頭ポインタ
+	 *	@param[in] bytes 大きさ
+	 *	@retval true 生成に成功しました。
+	 *	@retval false 生成に失敗しました。
+	 *	@details	DEFAULT ヒープから切り出した配置リソースを作り、データはコピーキューで転送します。
+	 */
+	bool const createGeometryBuffer(D3D12Buffer& buffer, void const* data, UINT64 const& bytes) noexcept;
+
 	/**	@brief	頂点バッファ生成関数
 	 *	@param[in] buffer 対象バッファ
 	 *	@param[in] vertex 頂点データの先頭ポインタ
@@ -105,14 +121,25 @@ namespace dlph {
 
 	/**	@brief	定数バッファ生成関数
 	 *	@param[in] buffer 対象バッファ
-	 *	@param[in] vertex インデックスデータの先頭ポインタ
+	 *	@param[in] data 初期値
 	 *	@param[in] size 定数バッファ数
 	 *	@retval true 生成に成功しました。
 	 *	@retval false 生成に失敗しました。
+	 *	@details	長く使う定数向けです。描画ごとに変わる定数は D3D12ConstantAllocator を使ってください。
 	 */
 	template <typename T>
 	bool const createConstantBufferView(D3D12Buffer& buffer, T const& data, unsigned int const& size) noexcept;
 
+	/**	@brief	定数バッファ更新関数
+	 *	@param[in] buffer 対象バッファ
+	 *	@param[in] idx 定数バッファの番号
+	 *	@param[in] data 書き込むデータ
+	 *	@retval true 更新に成功しました。
+	 *	@retval false 更新に失敗しました。
+	 */
+	template <typename T>
+	bool const updateConstantBufferView(D3D12Buffer& buffer, unsigned int const& idx, T const& data) noexcept;
+
 	/**	@brief	定数バッファ生成関数
 	 *	@param[in] buffer 対象バッファ
 	 *	@param[in] vertex インデックスデータの先頭ポインタ
@@ -3,60 +3,21 @@
  */
 #pragma once
 #include "d3d12_device.hpp"
+#include <cstring>
+#include <type_traits>
 
 namespace dlph {
 	template<typename Vertex>
 	bool const createVertexBufferView(D3D12Buffer& buffer, Vertex* vertecies, unsigned int const& size) noexcept {
-		HRESULT hResult = S_OK;
-
-		buffer.init(D3D12ViewType::Unknown, 1U);
-
-		D3D12_HEAP_PROPERTIES prop = {};
-		prop.Type = D3D12_HEAP_TYPE_UPLOAD;
-		prop.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
-		prop.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
-		prop.CreationNodeMask = 1;
-		prop.VisibleNodeMask = 1;
-
-		D3D12_RESOURCE_DESC desc = {};
-		desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-		desc.Alignment = 0;
-		desc.Width = static_cast<UINT64>(sizeof(Vertex)) * size;
-		desc.Height = 1;
-		desc.DepthOrArraySize = 1;
-		desc.MipLevels = 1;
-		desc.Format = DXGI_FORMAT_UNKNOWN;
-		desc.SampleDesc.Count = 1;
-		desc.SampleDesc.Quality = 0;
-		desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-		desc.Flags = D3D12_RESOURCE_FLAG_NONE;
-
-		hResult = D3D12Device::getInstance()->CreateCommittedResource(
-			&prop,
-			D3D12_HEAP_FLAG_NONE,
-			&desc,
-			D3D12_RESOURCE_STATE_GENERIC_READ,
-			nullptr,
-			__uuidof(buffer[0]),
-			reinterpret_cast<void**>(&buffer[0])
-		);
-		if (FAILED(hResult)) {
-			OutputDebugStringA("ERROR : COMMITING FAILED CONSTANT BUFFER RESOURCE.\n");
+		if (!buffer.init(D3D12ViewType::VBV, 1U)) {
 			return false;
 		}
 
-		void* ptr = nullptr;
-		buffer[0]->Map(0U, nullptr, &ptr);
-		if (FAILED(hResult)) {
-			OutputDebugStringA("ERROR : MAPPING FAILED CONSTANT BUFFER RESOURCE.\n");
+		if (!createGeometryBuffer(buffer, vertecies, static_cast<UINT64>(sizeof(Vertex)) * size)) {
+			OutputDebugStringA("ERROR : COMMITING FAILED VERTEX BUFFER RESOURCE.\n");
 			return false;
 		}
 
-		memcpy(ptr, vertecies, size * sizeof(Vertex));
-
-		buffer[0]->Unmap(0U, nullptr);
-		ptr = nullptr;
-
 		D3D12_VERTEX_BUFFER_VIEW view = {};
 		view.BufferLocation = buffer[0]->GetGPUVirtualAddress();
 		view.SizeInBytes = sizeof(Vertex) * static_cast<unsigned int>(size);
@@ -67,9 +28,16 @@ namespace dlph {
 	
 	template<typename T>
 	bool const createConstantBufferView(D3D12Buffer& buffer, T const& data, unsigned int const& size) noexcept {
+		static_assert(std::is_trivially_copyable<T>::value, "Constant data must be trivially copyable.");
 		HRESULT hResult = S_OK;
 
-		buffer.init(D3D12ViewType::CBV, size);
+		if (!buffer.init(D3D12ViewType::CBV, size)) {
+			return false;
+		}
+
+		//	CBV の大きさは 256 バイトの倍数でなければならない
+		UINT64 const width = (static_cast<UINT64>(sizeof(T)) + D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT - 1U)
+			& ~static_cast<UINT64>(D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT - 1U);
 
 		for (unsigned int idx = 0U; idx < size; ++idx) {
 			D3D12_HEAP_PROPERTIES prop = {};
@@ -82,7 +50,7 @@ namespace dlph {
 			D3D12_RESOURCE_DESC desc = {};
 			desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
 			desc.Alignment = 0U;
-			desc.Width = sizeof(T);
+			desc.Width = width;
 			desc.Height = 1U;
 			desc.DepthOrArraySize = 1U;
 			desc.MipLevels = 1U;
@@ -92,10 +60,6 @@ namespace dlph {
 			desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
 			desc.Flags = D3D12_RESOURCE_FLAG_NONE;
 
-			D3D12_CONSTANT_BUFFER_VIEW_DESC cbv = {};
-			cbv.SizeInBytes = sizeof(T);
-			cbv.BufferLocation = buffer.getGPUVirtualAddress(idx);
-
 			hResult = D3D12Device::getInstance()->CreateCommittedResource(
 				&prop,
 				D3D12_HEAP_FLAG_NONE,
@@ -110,22 +74,46 @@ namespace dlph {
 				return false;
 			}
 
+			D3D12_CONSTANT_BUFFER_VIEW_DESC cbv = {};
+			cbv.SizeInBytes = static_cast<UINT>(width);
+			cbv.BufferLocation = buffer.getGPUVirtualAddress(idx);
+
 			D3D12Device::getInstance()->CreateConstantBufferView(
 				&cbv,
 				buffer.getDescriptorHandle(idx).cpu
 			);
 
-			hResult = buffer[idx]->Map(
-				0U,
-				nullptr,
-				reinterpret_cast<void**>(&const_cast<T*>(&data))
-			);
+			//	Map したままにしておき (解放時に自動で閉じられる)、更新は updateConstantBufferView で行う
+			void* ptr = nullptr;
+			D3D12_RANGE const none = { 0U, 0U };
+			hResult = buffer[idx]->Map(0U, &none, &ptr);
 			if (FAILED(hResult)) {
 				OutputDebugStringA("ERROR : MAPPING FAILED CONSTANT BUFFER RESOURCE.\n");
 				return false;
 			}
+			memcpy(ptr, &data, sizeof(T));
+		}
+
+		return true;
+	}
+
+	template<typename T>
+	bool const updateConstantBufferView(D3D12Buffer& buffer, unsigned int const& idx, T const& data) noexcept {
+		static_assert(std::is_trivially_copyable<T>::value, "Constant data must be trivially copyable.");
+		HRESULT hResult = S_OK;
+
+		//	生成時の Map が残っているため、ここでの Map は同じアドレスを返すだけで済む
+		void* ptr = nullptr;
+		D3D12_RANGE const none = { 0U, 0U };
+		hResult = buffer[idx]->Map(0U, &none, &ptr);
+		if (FAILED(hResult)) {
+			OutputDebugStringA("ERROR : MAPPING FAILED CONSTANT BUFFER RESOURCE.\n");
+			return false;
 		}
+		memcpy(ptr, &data, sizeof(T));
 
+		D3D12_RANGE const written = { 0U, sizeof(T) };
+		buffer[idx]->Unmap(0U, &written);
 		return true;
 	}
 }
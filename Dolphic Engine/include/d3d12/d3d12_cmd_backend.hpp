@@ -0,0 +1,124 @@
+﻿/**	@file	d3d12_cmd_backend.hpp
+ *	@brief	描画コマンド列を Direct3D12 のコマンドリストへ変換するバックエンド
+ */
+#pragma once
+#include "ifs/nonmovable.hpp"
+#include "cont/slot_map.hpp"
+#include "dlph/dlph_cmd_stream.hpp"
+#include "d3d12_cmd_list.hpp"
+#include "d3d12_rsrc_barrier.hpp"
+#include <d3d12.h>
+
+namespace dlph {
+	//!	@brief	描画コマンド列のリソースの状態から Direct3D12 のリソースの状態への変換関数
+	D3D12_RESOURCE_STATES const to_d3d12_state(ResourceState const& state) noexcept;
+
+	/**	@struct	D3D12PipelineEntry
+	 *	@brief	パイプラインハンドルが指す Direct3D12 のオブジェクト
+	 */
+	struct D3D12PipelineEntry final {
+		//!	@brief	パイプラインステート
+		ID3D12PipelineState* state;
+		//!	@brief	ルートシグネチャ
+		ID3D12RootSignature* root;
+		//!	@brief	コンピュート用かどうか
+		bool compute;
+	};
+
+	/**	@class	D3D12ResourceTable
+	 *	@brief	描画コマンド列のハンドルと Direct3D12 のオブジェクトの対応表
+	 *	@details	登録したオブジェクトの参照カウントは増やしません。解放する前に登録を外してください。
+	 *				登録と解除はスレッドセーフではないため、読み込み時など記録していない間に行ってください。
+	 */
+	class D3D12ResourceTable final :
+		public INonmovable<D3D12ResourceTable>
+	{
+	public	:
+		//!	@brief	デフォルトコンストラクタ
+		D3D12ResourceTable() noexcept;
+		//!	@brief	デストラクタ
+		~D3D12ResourceTable() noexcept = default;
+
+		//!	@brief	リソース登録関数
+		RenderResource const registerResource(ID3D12Resource* resource) noexcept;
+		//!	@brief	リソース登録解除関数
+		void unregisterResource(RenderResource const& handle) noexcept;
+		//!	@brief	リソース取得関数 (無効なハンドルなら nullptr)
+		ID3D12Resource* const getResource(RenderResource const& handle) const noexcept;
+
+		//!	@brief	パイプライン登録関数
+		RenderPipeline const registerPipeline(D3D12PipelineEntry const& entry) noexcept;
+		//!	@brief	パイプライン登録解除関数
+		void unregisterPipeline(RenderPipeline const& handle) noexcept;
+		//!	@brief	パイプライン取得関数 (無効なハンドルなら nullptr)
+		D3D12PipelineEntry const* const getPipeline(RenderPipeline const& handle) const noexcept;
+
+		//!	@brief	全登録解除関数
+		void clear() noexcept;
+
+	private	:
+		//!	@brief	リソース
+		SlotMap<ID3D12Resource*> m_resources;
+		//!	@brief	パイプライン
+		SlotMap<D3D12PipelineEntry> m_pipelines;
+	};
+
+	/**	@class	D3D12CommandBackend
+	 *	@brief	描画コマンド列を Direct3D12 のコマンドリストへ変換するバックエンド
+	 *	@details	再生一回分の軽いオブジェクトで、記録先のリストごとに作ります。
+	 *				最初のグラフィックス用パイプラインの設定時にトポロジを三角形リストにします。
+	 *				ルートシグネチャは前と異なる時だけ設定します。
+	 *				バリアは D3D12ResourceBarrier に溜め、描画、コンピュートシェーダの実行、コピーの直前にまとめて記録します。
+	 *				再生の後に flush を呼び、末尾に残ったバリアを記録してください。
+	 */
+	class D3D12CommandBackend final : public IRenderBackend {
+	public	:
+		/**	@brief	コンストラクタ
+		 *	@param[in] table ハンドルの対応表
+		 *	@param[in] list 記録先のコマンドリスト (記録中であること)
+		 */
+		D3D12CommandBackend(D3D12ResourceTable const& table, D3D12CommandList& list) noexcept;
+		//!	@brief	デストラクタ
+		~D3D12CommandBackend() noexcept = default;
+
+		//!	@brief	描画
+		void draw(DrawCommand const& cmd) noexcept override;
+		//!	@brief	インデックス付き描画
+		void drawIndexed(DrawIndexedCommand const& cmd) noexcept override;
+		//!	@brief	コンピュートシェーダの実行
+		void dispatch(DispatchCommand const& cmd) noexcept override;
+		//!	@brief	パイプラインの設定
+		void setPipeline(SetPipelineCommand const& cmd) noexcept override;
+		//!	@brief	頂点バッファの設定
+		void bindVertexBuffer(BindVertexBufferCommand const& cmd) noexcept override;
+		//!	@brief	インデックスバッファの設定
+		void bindIndexBuffer(BindIndexBufferCommand const& cmd) noexcept override;
+		//!	@brief	定数の設定
+		void bindConstants(BindConstantsCommand const& cmd) noexcept override;
+		//!	@brief	リソースの設定
+		void bindResource(BindResourceCommand const& cmd) noexcept override;
+		//!	@brief	リソースの状態遷移
+		void barrier(BarrierCommand const& cmd) noexcept override;
+		//!	@brief	バッファのコピー
+		void copy(CopyCommand const& cmd) noexcept override;
+
+		//!	@brief	溜めたバリアの記録関数
+		void flush() noexcept;
+		//!	@brief	バリアの集計取得関数
+		StateTrackerStats const& barrierStats() const noexcept;
+
+	private	:
+		//!	@brief	ハンドルの対応表
+		D3D12ResourceTable const& m_table;
+		//!	@brief	記録先のコマンドリスト
+		D3D12CommandList& m_list;
+		//!	@brief	設定中のグラフィックス用ルートシグネチャ
+		ID3D12RootSignature* m_graphicsRoot;
+		//!	@brief	設定中のコンピュート用ルートシグネチャ
+		ID3D12RootSignature* m_computeRoot;
+		//!	@brief	設定中のパイプラインがコンピュート用かどうか
+		bool m_compute;
+		//!	@brief	溜めているバリア
+		D3D12ResourceBarrier m_barriers;
+	};
+}
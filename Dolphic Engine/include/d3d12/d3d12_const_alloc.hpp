@@ -0,0 +1,87 @@
+﻿/**	@file	d3d12_const_alloc.hpp
+ *	@brief	Direct3D12 用の定数データ確保器
+ */
+#pragma once
+#include "ifs/singleton.hpp"
+#include "mem/atomic_linear.hpp"
+#include "dlph/dlph_frame_pacer.hpp"
+#include "d3d12_cmd_list.hpp"
+#include <d3d12.h>
+
+namespace dlph {
+	//!	@brief	一フレームで使える定数データの大きさ
+	static UINT64 constexpr D3D12_CONSTANT_FRAME_SIZE = 4ULL * 1024ULL * 1024ULL;
+
+	/**	@struct	D3D12ConstantRange
+	 *	@brief	定数データの切り出し
+	 */
+	struct D3D12ConstantRange final {
+		//!	@brief	CPU から書き込む先 (失敗したら nullptr)
+		void* cpu;
+		//!	@brief	GPU アドレス (ルート CBV にそのまま渡せます)
+		D3D12_GPU_VIRTUAL_ADDRESS gpu;
+		//!	@brief	大きさ (256 バイトの倍数)
+		UINT64 size;
+	};
+
+	/**	@class	D3D12ConstantAllocator
+	 *	@brief	Direct3D12 用の定数データ確保器
+	 *	@details	UPLOAD ヒープのバッファを slot の数だけの区画に分けて常に Map しておき、
+	 *				描画ごとの定数を 256 バイト境界で切り出します。記述子は作らず、GPU アドレスをルート CBV に渡して使います。
+	 *				確保は AtomicLinearAllocator の fetch_add だけなので、複数のスレッドから同時に記録できます。
+	 *				区画は beginFrame で空にするため、GPU がその slot の前のフレームを終えてから呼び出してください。
+	 */
+	class D3D12ConstantAllocator final : public ISingleton<D3D12ConstantAllocator> {
+	public	:
+		//!	@brief	デフォルトコンストラクタ
+		D3D12ConstantAllocator() noexcept;
+		//!	@brief	デストラクタ
+		~D3D12ConstantAllocator() noexcept;
+
+		//!	@brief	初期化関数
+		bool const init(UINT64 const& size = D3D12_CONSTANT_FRAME_SIZE) noexcept;
+		//!	@brief	終了関数
+		void exit() noexcept;
+
+		//!	@brief	フレーム開始関数 (FramePacer の slot を渡します)
+		void beginFrame(unsigned int const& slot) noexcept;
+
+		/**	@brief	確保関数
+		 *	@param[in] size 大きさ (256 バイトの倍数に切り上げます)
+		 *	@return 切り出した領域 (このフレームが GPU で終わるまで有効です)
+		 */
+		D3D12ConstantRange const allocate(UINT64 const& size) noexcept;
+		//!	@brief	書き込み関数 (切り出して data をコピーします)
+		template <typename T>
+		D3D12ConstantRange const write(T const& data) noexcept;
+		//!	@brief	グラフィックス用ルート CBV への設定関数
+		template <typename T>
+		bool const bindGraphics(D3D12CommandList& list, UINT const& root, T const& data) noexcept;
+		//!	@brief	コンピュート用ルート CBV への設定関数
+		template <typename T>
+		bool const bindCompute(D3D12CommandList& list, UINT const& root, T const& data) noexcept;
+
+		//!	@brief	現在のフレームで使用中の大きさ
+		UINT64 const used() const noexcept;
+		//!	@brief	バッファ取得関数 (描画コマンド列のハンドル対応表への登録用)
+		ID3D12Resource* const getBuffer() const noexcept;
+		//!	@brief	切り出した領域のバッファ内での位置取得関数
+		UINT64 const getOffset(D3D12ConstantRange const& range) const noexcept;
+
+	private	:
+		//!	@brief	バッファ
+		ID3D12Resource2* m_buffer;
+		//!	@brief	バッファの書き込み先
+		unsigned char* m_mapped;
+		//!	@brief	バッファの GPU アドレス
+		D3D12_GPU_VIRTUAL_ADDRESS m_address;
+		//!	@brief	一区画の大きさ
+		UINT64 m_frameSize;
+		//!	@brief	区画ごとの切り出し
+		AtomicLinearAllocator m_frames[FRAME_LATENCY_MAX];
+		//!	@brief	現在の slot
+		unsigned int m_slot;
+	};
+}
+
+#include "d3d12_const_alloc.inl"
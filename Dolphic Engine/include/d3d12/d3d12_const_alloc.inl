@@ -0,0 +1,39 @@
+﻿/**	@file	d3d12_const_alloc.inl
+ *	@brief	Direct3D12 用の定数データ確保器
+ */
+#pragma once
+#include "d3d12_const_alloc.hpp"
+#include <cstring>
+#include <type_traits>
+
+namespace dlph {
+	template<typename T>
+	inline D3D12ConstantRange const D3D12ConstantAllocator::write(T const& data) noexcept {
+		static_assert(std::is_trivially_copyable<T>::value, "Constant data must be trivially copyable.");
+		D3D12ConstantRange const range = allocate(sizeof(T));
+		if (range.cpu != nullptr) {
+			memcpy(range.cpu, &data, sizeof(T));
+		}
+		return range;
+	}
+
+	template<typename T>
+	inline bool const D3D12ConstantAllocator::bindGraphics(D3D12CommandList& list, UINT const& root, T const& data) noexcept {
+		D3D12ConstantRange const range = write(data);
+		if (range.cpu == nullptr) {
+			return false;
+		}
+		list->SetGraphicsRootConstantBufferView(root, range.gpu);
+		return true;
+	}
+
+	template<typename T>
+	inline bool const D3D12ConstantAllocator::bindCompute(D3D12CommandList& list, UINT const& root, T const& data) noexcept {
+		D3D12ConstantRange const range = write(data);
+		if (range.cpu == nullptr) {
+			return false;
+		}
+		list->SetComputeRootConstantBufferView(root, range.gpu);
+		return true;
+	}
+}
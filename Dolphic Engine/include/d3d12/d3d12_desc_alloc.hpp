@@ -0,0 +1,158 @@
+﻿/**	@file	d3d12_desc_alloc.hpp
+ *	@brief	Direct3D12 用の記述子確保器
+ */
+#pragma once
+#include "ifs/singleton.hpp"
+#include "mem/range_alloc.hpp"
+#include "mem/range_ring.hpp"
+#include "d3d12_tview.hpp"
+#include <mutex>
+#include <vector>
+#include <d3d12.h>
+
+namespace dlph {
+	//!	@brief	シェーダから見える CBV / SRV / UAV 記述子のうち、長期確保に使う数
+	static unsigned int constexpr D3D12_DESCRIPTOR_PERSISTENT_CNT = 65536U;
+	//!	@brief	シェーダから見える CBV / SRV / UAV 記述子のうち、フレーム内の一時確保に使う数
+	static unsigned int constexpr D3D12_DESCRIPTOR_TRANSIENT_CNT = 16384U;
+	//!	@brief	CPU 側の CBV / SRV / UAV 記述子 (コピー元) の数
+	static unsigned int constexpr D3D12_DESCRIPTOR_STAGING_CNT = 16384U;
+	//!	@brief	シェーダから見えるサンプラ記述子の数 (ハードウェア上限)
+	static unsigned int constexpr D3D12_DESCRIPTOR_SAMPLER_CNT = 2048U;
+	//!	@brief	レンダーターゲット記述子の数
+	static unsigned int constexpr D3D12_DESCRIPTOR_RTV_CNT = 256U;
+	//!	@brief	深度バッファ記述子の数
+	static unsigned int constexpr D3D12_DESCRIPTOR_DSV_CNT = 64U;
+
+	/**	@enum	D3D12DescriptorHeapKind
+	 *	@brief	記述子の区間を切り出したヒープの種類
+	 */
+	enum class D3D12DescriptorHeapKind : unsigned char {
+		//!	@brief	シェーダから見える CBV / SRV / UAV (長期確保)
+		Resource = 0U,
+		//!	@brief	シェーダから見えるサンプラ
+		Sampler,
+		//!	@brief	レンダーターゲット
+		RenderTarget,
+		//!	@brief	深度バッファ
+		DepthStencil,
+		//!	@brief	CPU 側の CBV / SRV / UAV
+		Staging,
+		//!	@brief	シェーダから見える CBV / SRV / UAV (フレーム内の一時確保、環状に回収されます)
+		Transient,
+		//!	@brief	不明
+		Unknown
+	};
+
+	/**	@struct	D3D12DescriptorRange
+	 *	@brief	連続した記述子の区間
+	 */
+	struct D3D12DescriptorRange final {
+		//!	@brief	先頭の CPU 記述子ハンドル
+		D3D12_CPU_DESCRIPTOR_HANDLE cpu;
+		//!	@brief	先頭の GPU 記述子ハンドル (シェーダから見えないヒープでは 0)
+		D3D12_GPU_DESCRIPTOR_HANDLE gpu;
+		//!	@brief	ヒープ内の位置
+		unsigned int offset;
+		//!	@brief	個数
+		unsigned int count;
+		//!	@brief	ビューの種類
+		D3D12ViewType type;
+		//!	@brief	切り出したヒープの種類 (release はこれで返却先を選びます)
+		D3D12DescriptorHeapKind kind;
+	};
+
+	/**	@class	D3D12DescriptorAllocator
+	 *	@brief	Direct3D12 用の記述子確保器
+	 *	@details	記述子の種類ごとに大きなヒープを一つずつ作り、区間を切り出して配ります。
+	 *				CBV / SRV / UAV はシェーダから見える一つのヒープの前半を長期確保 (空きリスト)、後半をフレーム内の
+	 *				一時確保 (環状) に使うため、描画中にヒープを切り替える必要がありません。
+	 *				CPU 側のステージング用ヒープで作った記述子は copy で予約し、flush で一度の CopyDescriptors にまとめて写します。
+	 */
+	class D3D12DescriptorAllocator final : public ISingleton<D3D12DescriptorAllocator> {
+	public	:
+		//!	@brief	デフォルトコンストラクタ
+		D3D12DescriptorAllocator() noexcept;
+		//!	@brief	デストラクタ
+		~D3D12DescriptorAllocator() noexcept;
+
+		//!	@brief	初期化関数
+		bool const init() noexcept;
+		//!	@brief	終了関数
+		void exit() noexcept;
+
+		/**	@brief	長期確保関数
+		 *	@param[in] type ビューの種類 (CBV / SRV / UAV / ASV / Sampler / RTV / DSV)
+		 *	@param[in] count 個数
+		 *	@return 記述子の区間 (失敗したら count が 0)
+		 */
+		D3D12DescriptorRange const allocate(D3D12ViewType const& type, unsigned int const& count) noexcept;
+		//!	@brief	長期確保 / ステージング用確保の解放関数 (一時確保は環状に回収されるため渡せません)
+		void release(D3D12DescriptorRange& range) noexcept;
+		//!	@brief	フレーム内の一時確保関数 (シェーダから見える CBV / SRV / UAV)
+		D3D12DescriptorRange const allocateTransient(unsigned int const& count) noexcept;
+		//!	@brief	ステージング用の確保関数 (CPU 側の CBV / SRV / UAV)
+		D3D12DescriptorRange const allocateStaging(unsigned int const& count) noexcept;
+
+		//!	@brief	記述子のコピー予約関数 (flush でまとめて写します)
+		void copy(D3D12DescriptorRange const& dst, D3D12_CPU_DESCRIPTOR_HANDLE const& src, unsigned int const& count) noexcept;
+		//!	@brief	予約したコピーの実行関数
+		void flush() noexcept;
+
+		//!	@brief	フレーム開始関数 (FramePacer の slot を渡します)
+		void beginFrame(unsigned int const& slot) noexcept;
+		//!	@brief	フレーム終了関数
+		void endFrame(unsigned int const& slot) noexcept;
+
+		//!	@brief	シェーダから見える CBV / SRV / UAV ヒープ取得関数
+		ID3D12DescriptorHeap* const getResourceHeap() const noexcept;
+		//!	@brief	シェーダから見えるサンプラヒープ取得関数
+		ID3D12DescriptorHeap* const getSamplerHeap() const noexcept;
+		//!	@brief	記述子の大きさ取得関数
+		unsigned int const getIncrementSize(D3D12ViewType const& type) const noexcept;
+
+	private	:
+		//!	@brief	ヒープの種類
+		using HeapKind = D3D12DescriptorHeapKind;
+		//!	@brief	実際に作るヒープの数 (一時確保はシェーダから見える CBV / SRV / UAV ヒープの後半を使います)
+		static unsigned int constexpr HEAP_CNT = static_cast<unsigned int>(HeapKind::Transient);
+
+		/**	@struct	Heap
+		 *	@brief	記述子ヒープ
+		 */
+		struct Heap final {
+			//!	@brief	ヒープ
+			ID3D12DescriptorHeap* heap;
+			//!	@brief	先頭の CPU 記述子ハンドル
+			D3D12_CPU_DESCRIPTOR_HANDLE cpu;
+			//!	@brief	先頭の GPU 記述子ハンドル
+			D3D12_GPU_DESCRIPTOR_HANDLE gpu;
+			//!	@brief	記述子の大きさ
+			unsigned int increment;
+		};
+
+		//!	@brief	ヒープ生成関数
+		bool const createHeap(HeapKind const& kind, D3D12_DESCRIPTOR_HEAP_TYPE const& type, unsigned int const& count, bool const& visible) noexcept;
+		//!	@brief	ビューの種類からヒープを選ぶ関数
+		static HeapKind const selectHeap(D3D12ViewType const& type) noexcept;
+		//!	@brief	ヒープの添字取得関数
+		static unsigned int const toIndex(HeapKind const& kind) noexcept;
+		//!	@brief	区間生成関数
+		D3D12DescriptorRange const makeRange(HeapKind const& kind, D3D12ViewType const& type, unsigned int const& offset, unsigned int const& count) const noexcept;
+
+		//!	@brief	ヒープ
+		Heap m_heaps[HEAP_CNT];
+		//!	@brief	長期確保の空きリスト
+		RangeAllocator m_ranges[HEAP_CNT];
+		//!	@brief	フレーム内の一時確保
+		RangeRing m_transient;
+		//!	@brief	コピー先の先頭
+		std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> m_dstStarts;
+		//!	@brief	コピー元の先頭
+		std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> m_srcStarts;
+		//!	@brief	コピーする個数
+		std::vector<UINT> m_copySizes;
+		//!	@brief	排他
+		std::mutex m_mutex;
+	};
+}
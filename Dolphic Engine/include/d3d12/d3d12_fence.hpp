@@ -33,6 +33,12 @@ namespace dlph {
 		bool const presenting(D3D12CommandQueue const&) noexcept;
 		//!	@brief	フェンス待機処理関数
 		void wait(D3D12CommandQueue const&) noexcept;
+		//!	@brief	シグナル発行関数 (待機しません)
+		bool const signal(D3D12CommandQueue const&, UINT64 const&) noexcept;
+		//!	@brief	到達待機関数 (GPU が値に到達していなければ待ちます)
+		bool const waitFor(UINT64 const&) noexcept;
+		//!	@brief	GPU の到達値取得関数
+		UINT64 const completed() const noexcept;
 
 		//!	@brief	取得関数
 		ID3D12Fence1*& get() const noexcept;
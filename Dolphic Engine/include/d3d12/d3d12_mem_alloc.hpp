@@ -0,0 +1,90 @@
+﻿/**	@file	d3d12_mem_alloc.hpp
+ *	@brief	Direct3D12 用の GPU メモリ確保器
+ */
+#pragma once
+#include "ifs/singleton.hpp"
+#include "mem/tlsf_alloc.hpp"
+#include <mutex>
+#include <vector>
+#include <d3d12.h>
+
+namespace dlph {
+	//!	@brief	一つのヒープの大きさ (これを超える要求には専用のヒープを作ります)
+	static UINT64 constexpr D3D12_MEMORY_PAGE_SIZE = 64ULL * 1024ULL * 1024ULL;
+
+	/**	@struct	D3D12Allocation
+	 *	@brief	ヒープから切り出した GPU メモリ
+	 */
+	struct D3D12Allocation final {
+		//!	@brief	ヒープ (失敗したら nullptr)
+		ID3D12Heap* heap;
+		//!	@brief	ヒープ内の位置
+		UINT64 offset;
+		//!	@brief	大きさ
+		UINT64 size;
+		//!	@brief	ヒープの番号
+		unsigned int page;
+		//!	@brief	ヒープ内のブロック番号
+		unsigned int block;
+	};
+
+	/**	@class	D3D12MemoryAllocator
+	 *	@brief	Direct3D12 用の GPU メモリ確保器
+	 *	@details	DEFAULT ヒープを D3D12_MEMORY_PAGE_SIZE ずつまとめて作り、TlsfAllocator で切り出して配置リソースを作ります。
+	 *				リソースごとに CreateCommittedResource を呼ぶと OS の確保回数の上限に近づくため、それを避けるためのものです。
+	 *				ヒープはバッファ専用です (リソースヒープ階層 1 でも使えます)。
+	 */
+	class D3D12MemoryAllocator final : public ISingleton<D3D12MemoryAllocator> {
+	public	:
+		//!	@brief	デフォルトコンストラクタ
+		D3D12MemoryAllocator() noexcept;
+		//!	@brief	デストラクタ
+		~D3D12MemoryAllocator() noexcept;
+
+		//!	@brief	初期化関数
+		bool const init() noexcept;
+		//!	@brief	終了関数
+		void exit() noexcept;
+
+		/**	@brief	確保関数
+		 *	@param[in] info GetResourceAllocationInfo で得た大きさと境界
+		 *	@return 切り出したメモリ (失敗したら heap が nullptr)
+		 */
+		D3D12Allocation const allocate(D3D12_RESOURCE_ALLOCATION_INFO const& info) noexcept;
+		//!	@brief	解放関数
+		void release(D3D12Allocation& allocation) noexcept;
+
+		/**	@brief	バッファ生成関数
+		 *	@param[in] bytes 大きさ
+		 *	@param[out] allocation 切り出したメモリ
+		 *	@param[out] resource 生成したリソース (COMMON 状態で作ります)
+		 *	@retval true 生成に成功しました。
+		 *	@retval false 生成に失敗しました。
+		 */
+		bool const createBuffer(UINT64 const& bytes, D3D12Allocation& allocation, ID3D12Resource2*& resource) noexcept;
+
+		//!	@brief	使用中の大きさ
+		UINT64 const used() noexcept;
+		//!	@brief	確保済みのヒープの大きさの合計
+		UINT64 const reserved() noexcept;
+
+	private	:
+		/**	@struct	Page
+		 *	@brief	ヒープ一つ分
+		 */
+		struct Page final {
+			//!	@brief	ヒープ
+			ID3D12Heap* heap;
+			//!	@brief	切り出し
+			TlsfAllocator blocks;
+		};
+
+		//!	@brief	ヒープ生成関数
+		unsigned int const createPage(UINT64 const& size) noexcept;
+
+		//!	@brief	ヒープ
+		std::vector<Page> m_pages;
+		//!	@brief	排他
+		std::mutex m_mutex;
+	};
+}
@@ -0,0 +1,61 @@
+﻿/**	@file	d3d12_pso_cache.hpp
+ *	@brief	Direct3D12 用のパイプラインキャッシュ
+ */
+#pragma once
+#include "ifs/singleton.hpp"
+#include "dlph/dlph_pso_cache.hpp"
+#include <d3d12.h>
+#include <string>
+
+namespace dlph {
+	/**	@class	D3D12PipelineCache
+	 *	@brief	Direct3D12 用のパイプラインキャッシュ
+	 *	@details	PipelineCache でパイプラインステートを管理し、ID3D12PipelineState::GetCachedBlob のデータを
+	 *				ファイルに保存して次回の作成に CachedPSO として渡します。ドライバが変わってデータを受け付けなければ、
+	 *				データ無しで作り直します。作成はワーカースレッドで行うため、acquire は作成が終わるまで nullptr を返します。
+	 *				キーは makeKey で一度だけ計算し、毎フレームは find か acquire にキーを渡してください。
+	 *				ルートシグネチャはアドレスが起動ごとに変わるため、シリアライズしたデータのハッシュなどを rootKey で渡してください。
+	 */
+	class D3D12PipelineCache final : public ISingleton<D3D12PipelineCache> {
+	public	:
+		//!	@brief	デフォルトコンストラクタ
+		D3D12PipelineCache() noexcept;
+		//!	@brief	デストラクタ
+		~D3D12PipelineCache() noexcept;
+
+		/**	@brief	初期化関数
+		 *	@param[in] path キャッシュファイルのパス (nullptr なら保存しません)
+		 *	@param[in] tag 環境タグ (異なる環境で保存したファイルは読み込みません)
+		 */
+		bool const init(char const* const path, unsigned long long const& tag = 0ULL) noexcept;
+		//!	@brief	終了関数 (作成中のものを待ち、ファイルに保存してから全て解放します)
+		void exit() noexcept;
+
+		//!	@brief	グラフィックス用パイプラインのキー計算関数 (ポインタではなく指す先の内容から計算します)
+		static unsigned long long const makeKey(D3D12_GRAPHICS_PIPELINE_STATE_DESC const& desc, unsigned long long const& rootKey) noexcept;
+		//!	@brief	コンピュート用パイプラインのキー計算関数
+		static unsigned long long const makeKey(D3D12_COMPUTE_PIPELINE_STATE_DESC const& desc, unsigned long long const& rootKey) noexcept;
+
+		//!	@brief	作成済みのパイプラインの取得関数 (作成済みでなければ nullptr)
+		ID3D12PipelineState* const find(unsigned long long const& key) noexcept;
+		/**	@brief	グラフィックス用パイプラインの取得関数
+		 *	@details	作成済みでなければワーカースレッドでの作成を要求して nullptr を返します。desc の指す先は呼び出し中だけ有効であれば構いません。
+		 */
+		ID3D12PipelineState* const acquire(unsigned long long const& key, D3D12_GRAPHICS_PIPELINE_STATE_DESC const& desc) noexcept;
+		//!	@brief	コンピュート用パイプラインの取得関数
+		ID3D12PipelineState* const acquire(unsigned long long const& key, D3D12_COMPUTE_PIPELINE_STATE_DESC const& desc) noexcept;
+		//!	@brief	作成中のパイプラインを全て待つ関数 (読み込み画面などでの事前作成用)
+		void wait() noexcept;
+		//!	@brief	ファイル書き出し関数
+		bool const save() noexcept;
+
+		//!	@brief	集計取得関数
+		PipelineCacheStats const stats() const noexcept;
+
+	private	:
+		//!	@brief	パイプラインキャッシュ
+		PipelineCache m_cache;
+		//!	@brief	キャッシュファイルのパス
+		std::string m_path;
+	};
+}
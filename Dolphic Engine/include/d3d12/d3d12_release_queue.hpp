@@ -0,0 +1,71 @@
+﻿/**	@file	d3d12_release_queue.hpp
+ *	@brief	Direct3D12 用の遅延解放キュー
+ */
+#pragma once
+#include "ifs/singleton.hpp"
+#include "d3d12_desc_alloc.hpp"
+#include "d3d12_mem_alloc.hpp"
+#include <mutex>
+#include <vector>
+#include <d3d12.h>
+
+namespace dlph {
+	/**	@class	D3D12ReleaseQueue
+	 *	@brief	Direct3D12 用の遅延解放キュー
+	 *	@details	GPU が処理中のフレームから参照されているかもしれないリソース、配置リソースのメモリ、記述子の区間を預かり、
+	 *				記録中のフレームのフェンス値に GPU が到達してから返します。預かった順に返すため、
+	 *				同じバッファのリソースはメモリより先に解放されます。
+	 */
+	class D3D12ReleaseQueue final : public ISingleton<D3D12ReleaseQueue> {
+	public	:
+		//!	@brief	デフォルトコンストラクタ
+		D3D12ReleaseQueue() noexcept;
+		//!	@brief	デストラクタ
+		~D3D12ReleaseQueue() noexcept;
+
+		//!	@brief	初期化関数
+		bool const init() noexcept;
+		//!	@brief	終了関数 (GPU が全てのフレームを終えてから呼び出してください)
+		void exit() noexcept;
+
+		//!	@brief	リソースの遅延解放関数 (resource は nullptr になります)
+		void retire(ID3D12Resource2*& resource) noexcept;
+		//!	@brief	配置リソースのメモリの遅延解放関数
+		void retire(D3D12Allocation& allocation) noexcept;
+		//!	@brief	記述子の区間の遅延解放関数
+		void retire(D3D12DescriptorRange& range) noexcept;
+
+		/**	@brief	フレーム開始関数
+		 *	@param[in] completed GPU が到達したフェンス値 (これ以下の値で預かったものを返します)
+		 *	@param[in] value 記録を始めるフレームが提出時にシグナルするフェンス値
+		 */
+		void beginFrame(UINT64 const& completed, UINT64 const& value) noexcept;
+		//!	@brief	全解放関数 (GPU が全てのフレームを終えてから呼び出してください)
+		void flush() noexcept;
+
+	private	:
+		/**	@struct	Entry
+		 *	@brief	預かったもの
+		 */
+		struct Entry final {
+			//!	@brief	返してよくなるフェンス値
+			UINT64 value;
+			//!	@brief	リソース
+			ID3D12Resource2* resource;
+			//!	@brief	配置リソースのメモリ
+			D3D12Allocation allocation;
+			//!	@brief	記述子の区間
+			D3D12DescriptorRange range;
+		};
+
+		//!	@brief	先頭から count 個を返す関数
+		void release(size_t const& count) noexcept;
+
+		//!	@brief	預かったもの (フェンス値の小さい順)
+		std::vector<Entry> m_entries;
+		//!	@brief	記録中のフレームのフェンス値
+		UINT64 m_value;
+		//!	@brief	排他
+		std::mutex m_mutex;
+	};
+}
@@ -9,8 +9,23 @@
 #include "d3d12_cmd_queue.hpp"
 #include "d3d12_cmd_list.hpp"
 #include "d3d12_fence.hpp"
+#include "d3d12_cmd_backend.hpp"
+#include "dlph/dlph_state_filter.hpp"
+#include "dlph/dlph_batcher.hpp"
+#include "d3d12_transient.hpp"
+#include "dlph/dlph_cmd_pool.hpp"
+#include "dlph/dlph_frame_pacer.hpp"
 
 namespace dlph {
+	//!	@brief	フレームあたりのコマンドリスト数 (記録スレッド数 + 前後処理の 2 本)
+	static unsigned int constexpr D3D12_CMD_LIST_CNT = 16U;
+	//!	@brief	フレーム末尾のリスト用に予約するコマンドリスト数
+	static unsigned int constexpr D3D12_CMD_LIST_RESERVED = 1U;
+	//!	@brief	フレーム先頭のコマンドリストの提出順序
+	static unsigned int constexpr D3D12_ORDER_FIRST = 0U;
+	//!	@brief	フレーム末尾のコマンドリストの提出順序
+	static unsigned int constexpr D3D12_ORDER_LAST = ~0U;
+
 	/**	@struct	RendererDesc
 	 *	@brief	レンダラ初期化用データ
 	 */
@@ -23,6 +38,10 @@ namespace dlph {
 		unsigned int bSize;
 		//!	@brief	フレームレート
 		unsigned int fRate;
+		//!	@brief	同時に処理するフレーム数 (1 ～ FRAME_LATENCY_MAX、0 は既定値)
+		unsigned int latency;
+		//!	@brief	パイプラインキャッシュのファイルパス (nullptr は保存しません)
+		char const* pipelineCache;
 		//!	@brief	フルスクリーン設定
 		bool fullscreen;
 	};
@@ -59,8 +78,45 @@ namespace dlph {
 		//!	@brief	描画処理関数
 		bool const presenting() noexcept;
 
-		//!	@brief	コマンドリスト取得関数
+		//!	@brief	コマンドリスト取得関数 (フレーム先頭のリスト)
 		D3D12CommandList& getCmdList() noexcept;
+		/**	@brief	記録用コマンドリスト取得関数 (スレッドセーフ)
+		 *	@details	レンダーターゲット、ビューポート、シザー矩形を設定済みのリストを返します。
+		 *				リストは after_rendering で順序の小さい順に一度で提出されます。
+		 *	@param[in] order 提出順序 (D3D12_ORDER_FIRST より大きく D3D12_ORDER_LAST より小さい、フレーム内で一意の値)
+		 *	@return コマンドリスト (使い切ったら nullptr)
+		 */
+		D3D12CommandList* const acquireCmdList(unsigned int const& order) noexcept;
+		/**	@brief	描画コマンド列の実行関数 (スレッドセーフ)
+		 *	@details	記録用コマンドリストを取得し、重複した状態設定を取り除きながらコマンド列を再生します。
+		 *				並べ替えは呼び出し側で済ませてください。
+		 *	@param[in] stream 描画コマンド列
+		 *	@param[in] order 提出順序 (acquireCmdList と同じ)
+		 *	@retval true 記録しました。
+		 *	@retval false コマンドリストを使い切りました。
+		 */
+		bool const execute(RenderCommandStream const& stream, unsigned int const& order) noexcept;
+		/**	@brief	インスタンス描画の記録関数
+		 *	@details	まとめたインスタンスデータをこのフレームの定数データの領域へ書き込み、まとまりごとの描画を記録します。
+		 *	@param[in] batcher オブジェクトを追加済みのインスタンス描画器
+		 *	@param[in] stream 記録先の描画コマンド列
+		 *	@param[in] pipeline 描画に使うパイプライン
+		 *	@param[in] layer 並べ替えキーのレイヤー
+		 *	@param[in] pass 並べ替えキーのパス
+		 *	@retval true 記録しました。
+		 *	@retval false 定数データの領域が足りません。
+		 */
+		bool const recordBatches(DrawBatcher& batcher, RenderCommandStream& stream, RenderPipeline const& pipeline, unsigned int const& layer = 0U, unsigned int const& pass = 0U) noexcept;
+		/**	@brief	フレームグラフの一時リソースの実体化関数
+		 *	@details	このフレームの slot のヒープに一時リソースを置き、ハンドルをフレームグラフに設定します。
+		 *	@param[in] graph コンパイル済みのフレームグラフ
+		 *	@param[in] descs リソース番号ごとの記述 (外部リソースの分は読みません)
+		 *	@retval true 実体化しました。
+		 *	@retval false ヒープかリソースの作成に失敗しました。
+		 */
+		bool const realize(FrameGraph& graph, D3D12_RESOURCE_DESC const* descs) noexcept;
+		//!	@brief	描画コマンド列のハンドル対応表取得関数
+		D3D12ResourceTable& getResourceTable() noexcept;
 
 		//!	@brief	トリム矩形取得関数
 		D3D12_RECT const getTrimRect() const noexcept;
@@ -78,6 +134,11 @@ namespace dlph {
 		unsigned int const getCurrentBufferIndex() const noexcept;
 
 	private	:
+		//!	@brief	描画先の設定関数
+		void bindTargets(D3D12CommandList& list) noexcept;
+		//!	@brief	GPU の全フレーム完了待機関数
+		void flush() noexcept;
+
 		//!	@brief	ウィンドウハンドラ
 		HWND m_hWnd;
 		//!	@brief	バッファ数
@@ -96,15 +157,25 @@ namespace dlph {
 		D3D12ResourceBarrier m_barrier;
 		//!	@brief	コマンドキュー
 		D3D12CommandQueue m_queue;
-		//!	@brief	コマンドリスト
-		D3D12CommandList m_list;
+		//!	@brief	フレームペーサー
+		FramePacer m_pacer;
+		//!	@brief	フレームごとのコマンドリスト
+		CommandListPool<D3D12CommandList> m_lists;
+		//!	@brief	フレーム先頭のコマンドリスト
+		D3D12CommandList* m_list;
 		//!	@brief	スワップチェイン
 		D3D12SwapChain m_chain;
-		//!	@brief	フェンス
+		//!	@brief	フェンス (フレームごとの値は m_pacer が割り当てます)
 		D3D12Fence m_fence;
 		//!	@brief	レンダーターゲット
 		D3D12Buffer m_rtv;
 		//!	@brief	深度バッファ
 		D3D12Buffer m_dsv;
+		//!	@brief	描画コマンド列のハンドル対応表
+		D3D12ResourceTable m_resources;
+		//!	@brief	定数データのバッファのハンドル
+		RenderResource m_constants;
+		//!	@brief	フレームグラフの一時リソース用ヒープ
+		D3D12TransientHeap m_transients;
 	};
 }
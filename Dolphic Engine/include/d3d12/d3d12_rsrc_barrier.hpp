@@ -3,36 +3,76 @@
  */
 #pragma once
 #include "ifs/noncopyable.hpp"
+#include "dlph/dlph_state_tracker.hpp"
 #include "d3d12_cmd_list.hpp"
 #include <d3d12.h>
+#include <vector>
 
 namespace dlph {
-	/**	@file	D3D12ResourceBarrier
+	/**	@class	D3D12ResourceBarrier
 	 *	@brief	Direct3D12 用のリソースバリアクラス
+	 *	@details	リソースとサブリソースごとの状態を ResourceStateTracker で追跡し、要求されたバリアを溜めておきます。
+	 *				状態の変わらない遷移は捨て、続けて要求された同じサブリソースの遷移は一つにまとめます。
+	 *				溜めたバリアは描画、コンピュートシェーダの実行、コピーの直前に flush で一度の ResourceBarrier にまとめて記録してください。
+	 *				リソースはアドレスで識別するため、解放する前に untrack してください。
 	 */
-	class D3D12ResourceBarrier final {
+	class D3D12ResourceBarrier final :
+		public INoncopyable<D3D12ResourceBarrier>
+	{
 	public	:
-		//!	@brief	ムーブコンストラクタ
-		D3D12ResourceBarrier(D3D12ResourceBarrier&&) noexcept = default;
-		//!	@brief	コピーコンストラクタ
-		D3D12ResourceBarrier(D3D12ResourceBarrier const&) noexcept = default;
-		//!	@brief	ムーブコンストラクタ
-		D3D12ResourceBarrier& operator=(D3D12ResourceBarrier&&) & noexcept = default;
-		//!	@brief	コピーコンストラクタ
-		D3D12ResourceBarrier& operator=(D3D12ResourceBarrier const&) & noexcept = default;
-
 		//!	@brief	デフォルトコンストラクタ
 		D3D12ResourceBarrier() noexcept;
 		//!	@brief	デストラクタ
 		~D3D12ResourceBarrier() noexcept = default;
 
-		//!	@brief	レンダーターゲットモードに切り替える関数
-		D3D12ResourceBarrier& toRenderTargetMode(D3D12CommandList&, ID3D12Resource2*&) noexcept;
-		//!	@brief	プレゼントモードに切り替える関数
-		D3D12ResourceBarrier& toPresentMode(D3D12CommandList&, ID3D12Resource2*&) noexcept;
+		/**	@brief	リソース登録関数 (登録済みなら状態を上書きします)
+		 *	@param[in] rsrc リソース
+		 *	@param[in] state 現在の状態
+		 *	@param[in] subresources サブリソース数
+		 */
+		void track(ID3D12Resource* rsrc, ResourceState const& state, UINT const& subresources = 1U) noexcept;
+		//!	@brief	リソース登録解除関数
+		void untrack(ID3D12Resource* rsrc) noexcept;
+		//!	@brief	登録済みかどうか
+		bool const tracked(ID3D12Resource* rsrc) const noexcept;
+		//!	@brief	全削除関数 (溜めたバリアも捨てます)
+		void clear() noexcept;
+
+		/**	@brief	状態遷移の要求関数
+		 *	@param[in] rsrc リソース (登録済みであること)
+		 *	@param[in] after 遷移後の状態
+		 *	@param[in] subresource サブリソース番号
+		 *	@retval true 受け付けました。
+		 *	@retval false 登録されていないリソースです。
+		 */
+		bool const transition(ID3D12Resource* rsrc, ResourceState const& after, UINT const& subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES) noexcept;
+		//!	@brief	順序無しアクセスのバリアの要求関数
+		void uav(ID3D12Resource* rsrc) noexcept;
+		/**	@brief	まとめずに積むバリアの要求関数
+		 *	@param[in] rsrc リソース
+		 *	@param[in] before 遷移前の状態
+		 *	@param[in] after 遷移後の状態
+		 *	@param[in] kind 種類 (分割した遷移の開始と終了、メモリ共有)
+		 *	@param[in] subresource サブリソース番号
+		 */
+		void push(ID3D12Resource* rsrc, ResourceState const& before, ResourceState const& after, BarrierKind const& kind, UINT const& subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES) noexcept;
+
+		//!	@brief	溜めたバリアがあるかどうか
+		bool const pending() const noexcept;
+		//!	@brief	溜めたバリアを一度の ResourceBarrier で記録する関数
+		void flush(D3D12CommandList& list) noexcept;
+		//!	@brief	集計取得関数
+		StateTrackerStats const& stats() const noexcept;
+
+		//!	@brief	レンダーターゲットモードに切り替える関数 (未登録ならプレゼント状態として登録し、即座に記録します)
+		D3D12ResourceBarrier& toRenderTargetMode(D3D12CommandList& list, ID3D12Resource2*& rsrc) noexcept;
+		//!	@brief	プレゼントモードに切り替える関数 (即座に記録します)
+		D3D12ResourceBarrier& toPresentMode(D3D12CommandList& list, ID3D12Resource2*& rsrc) noexcept;
 
 	private	:
-		//!	@brief	リソースバリア
-		D3D12_RESOURCE_BARRIER m_barrier;
+		//!	@brief	状態追跡器
+		ResourceStateTracker m_tracker;
+		//!	@brief	記録用のバリアの配列 (再確保を避けるため使い回します)
+		std::vector<D3D12_RESOURCE_BARRIER> m_descs;
 	};
 }
@@ -3,6 +3,7 @@
  */
 #pragma once
 #include "ifs/noncopyable.hpp"
+#include "dlph/dlph_shader_lib.hpp"
 #include <d3d12.h>
 
 namespace dlph {
@@ -25,6 +26,12 @@ namespace dlph {
 
 		//!	@brief	初期化関数
 		bool const init(wchar_t const* const&) noexcept;
+		/**	@brief	シェーダライブラリからの初期化関数
+		 *	@details	バイトコードは複製せずにライブラリの中を指すため、ライブラリはこのシェーダより後に閉じてください。
+		 *	@param[in] library シェーダライブラリ
+		 *	@param[in] name 名前
+		 */
+		bool const init(ShaderLibrary const& library, char const* const name) noexcept;
 		//!	@brief	終了関数
 		void uninit() noexcept;
 
@@ -34,5 +41,7 @@ namespace dlph {
 	private:
 		//!	@brief	シェーダの塊
 		ID3DBlob* m_shader;
+		//!	@brief	シェーダライブラリ内のバイトコード
+		ShaderView m_view;
 	};
 }
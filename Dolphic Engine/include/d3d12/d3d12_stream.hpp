@@ -0,0 +1,97 @@
+﻿/**	@file	d3d12_stream.hpp
+ *	@brief	Direct3D12 用の非同期転送器
+ */
+#pragma once
+#include "dlph/dlph_streamer.hpp"
+#include "d3d12_cmd_backend.hpp"
+#include "d3d12_cmd_queue.hpp"
+#include "d3d12_cmd_list.hpp"
+#include "d3d12_fence.hpp"
+#include <d3d12.h>
+
+namespace dlph {
+	//!	@brief	非同期転送用の一時領域の大きさ
+	static UINT64 constexpr D3D12_STREAM_STAGING_SIZE = 64ULL * 1024ULL * 1024ULL;
+	//!	@brief	非同期転送で使い回すコマンドリストの数
+	static unsigned int constexpr D3D12_STREAM_LIST_COUNT = 3U;
+
+	/**	@class	D3D12TransferEngine
+	 *	@brief	Direct3D12 用の非同期転送器
+	 *	@details	描画やフレーム毎のアップロードとは別のコピーキューと専用のフェンスを持ち、
+	 *				常に Map したままの UPLOAD ヒープを一時領域として ResourceStreamer に貸します。
+	 *				コマンドリストは提出ごとに切り替え、そのリストのコピーが終わるまで再利用しません。
+	 *				転送先は COMMON 状態で対応表に登録し、完了の通知を受けるまで登録を外さないでください。
+	 *				テクスチャの行は GetCopyableFootprints の行 (圧縮形式はブロック一行) で数えます。
+	 */
+	class D3D12TransferEngine final :
+		public ITransferEngine,
+		public INonmovable<D3D12TransferEngine>
+	{
+	public	:
+		//!	@brief	デフォルトコンストラクタ
+		D3D12TransferEngine() noexcept;
+		//!	@brief	デストラクタ
+		~D3D12TransferEngine() noexcept;
+
+		/**	@brief	初期化関数
+		 *	@param[in] table ハンドルの対応表 (終了するまで生かしておくこと)
+		 *	@param[in] size 一時領域の大きさ
+		 */
+		bool const init(D3D12ResourceTable const& table, UINT64 const& size = D3D12_STREAM_STAGING_SIZE) noexcept;
+		//!	@brief	終了関数 (提出済みのコピーの完了を待ちます)
+		void exit() noexcept;
+
+		//!	@brief	一時領域の先頭
+		unsigned char* const staging() noexcept override;
+		//!	@brief	一時領域の大きさ
+		unsigned long long const stagingSize() const noexcept override;
+		//!	@brief	コピー元の位置の境界
+		unsigned long long const placementAlignment() const noexcept override;
+		//!	@brief	テクスチャの行の間隔の境界
+		unsigned long long const pitchAlignment() const noexcept override;
+
+		//!	@brief	コピーを積む関数
+		bool const copy(StreamCopy const& copy) noexcept override;
+		//!	@brief	積んだコピーの提出関数
+		unsigned long long const submit() noexcept override;
+		//!	@brief	到達したフェンス値
+		unsigned long long const completed() noexcept override;
+		//!	@brief	フェンス値への到達を待つ関数
+		void wait(unsigned long long const& value) noexcept override;
+
+		/**	@brief	GPU 側で転送の完了を待たせる関数
+		 *	@param[in] waiter 待たせるキュー
+		 *	@param[in] value フェンス値
+		 */
+		bool const queueWait(D3D12CommandQueue const& waiter, UINT64 const& value) const noexcept;
+		//!	@brief	コピーキュー
+		D3D12CommandQueue const& queue() const noexcept;
+
+	private	:
+		//!	@brief	テクスチャのコピーを積む関数
+		bool const copyTexture(ID3D12Resource* dst, StreamCopy const& copy) noexcept;
+
+		//!	@brief	ハンドルの対応表
+		D3D12ResourceTable const* m_table;
+		//!	@brief	一時領域
+		ID3D12Resource2* m_buffer;
+		//!	@brief	一時領域の書き込み先
+		unsigned char* m_mapped;
+		//!	@brief	一時領域の大きさ
+		UINT64 m_size;
+		//!	@brief	コピーキュー
+		D3D12CommandQueue m_queue;
+		//!	@brief	コマンドリスト
+		D3D12CommandList m_lists[D3D12_STREAM_LIST_COUNT];
+		//!	@brief	コマンドリストごとの最後に提出したフェンス値
+		UINT64 m_values[D3D12_STREAM_LIST_COUNT];
+		//!	@brief	記録に使うコマンドリストの番号
+		unsigned int m_current;
+		//!	@brief	記録中かどうか
+		bool m_recording;
+		//!	@brief	フェンス
+		D3D12Fence m_fence;
+		//!	@brief	最後に提出したフェンス値
+		UINT64 m_value;
+	};
+}
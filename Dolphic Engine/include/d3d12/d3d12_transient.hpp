@@ -0,0 +1,84 @@
+﻿/**	@file	d3d12_transient.hpp
+ *	@brief	フレームグラフの一時リソース用ヒープ
+ */
+#pragma once
+#include "ifs/nonmovable.hpp"
+#include "dlph/dlph_frame_graph.hpp"
+#include "dlph/dlph_frame_pacer.hpp"
+#include "d3d12_cmd_backend.hpp"
+#include <vector>
+#include <d3d12.h>
+
+namespace dlph {
+	/**	@class	D3D12TransientHeap
+	 *	@brief	フレームグラフの一時リソース用ヒープ
+	 *	@details	フレームの slot ごとにヒープを一つ持ち、コンパイル済みのフレームグラフが決めた位置に配置リソースを作ります。
+	 *				寿命の重ならないリソースは同じメモリに置かれます。記述と位置と最初の状態が前回と同じリソースは作り直しません。
+	 *				バッファとテクスチャを同じヒープに置くため、リソースヒープ階層 2 が必要です。
+	 *				realize は GPU がその slot の前のフレームを終えてから呼び出してください。
+	 */
+	class D3D12TransientHeap final :
+		public INonmovable<D3D12TransientHeap>
+	{
+	public	:
+		//!	@brief	デフォルトコンストラクタ
+		D3D12TransientHeap() noexcept;
+		//!	@brief	デストラクタ
+		~D3D12TransientHeap() noexcept;
+
+		//!	@brief	終了関数
+		void exit(D3D12ResourceTable& table) noexcept;
+
+		//!	@brief	リソースの記述から一時リソースの大きさを求める関数
+		static FrameGraphResourceDesc const describe(D3D12_RESOURCE_DESC const& desc) noexcept;
+		/**	@brief	実体化関数
+		 *	@param[in] slot フレームの slot
+		 *	@param[in] graph コンパイル済みのフレームグラフ (一時リソースのハンドルを設定します)
+		 *	@param[in] descs リソース番号ごとの記述 (外部リソースの分は読みません)
+		 *	@param[in] table ハンドルの対応表
+		 *	@retval true 実体化しました。
+		 *	@retval false ヒープかリソースの作成に失敗しました。
+		 */
+		bool const realize(unsigned int const& slot, FrameGraph& graph, D3D12_RESOURCE_DESC const* descs, D3D12ResourceTable& table) noexcept;
+
+		//!	@brief	ヒープの大きさ
+		UINT64 const size(unsigned int const& slot) const noexcept;
+
+	private	:
+		/**	@struct	Placed
+		 *	@brief	配置したリソース
+		 */
+		struct Placed final {
+			//!	@brief	記述
+			D3D12_RESOURCE_DESC desc;
+			//!	@brief	ヒープ内の位置
+			UINT64 offset;
+			//!	@brief	作成時の状態
+			ResourceState state;
+			//!	@brief	リソース
+			ID3D12Resource* resource;
+			//!	@brief	ハンドル
+			RenderResource handle;
+		};
+
+		/**	@struct	Frame
+		 *	@brief	フレームの slot ごとのヒープ
+		 */
+		struct Frame final {
+			//!	@brief	ヒープ
+			ID3D12Heap* heap;
+			//!	@brief	ヒープの大きさ
+			UINT64 size;
+			//!	@brief	リソース番号ごとの配置したリソース
+			std::vector<Placed> placed;
+		};
+
+		//!	@brief	配置したリソースの解放関数
+		static void release(Placed& placed, D3D12ResourceTable& table) noexcept;
+		//!	@brief	slot の全解放関数
+		static void release(Frame& frame, D3D12ResourceTable& table) noexcept;
+
+		//!	@brief	slot ごとのヒープ
+		Frame m_frames[FRAME_LATENCY_MAX];
+	};
+}
@@ -0,0 +1,105 @@
+﻿/**	@file	d3d12_upload.hpp
+ *	@brief	Direct3D12 用のアップロードキュー
+ */
+#pragma once
+#include "ifs/singleton.hpp"
+#include "mem/range_ring.hpp"
+#include "d3d12_cmd_queue.hpp"
+#include "d3d12_cmd_list.hpp"
+#include "d3d12_fence.hpp"
+#include <mutex>
+#include <d3d12.h>
+
+namespace dlph {
+	//!	@brief	アップロード用リングバッファの大きさ
+	static UINT64 constexpr D3D12_UPLOAD_RING_SIZE = 64ULL * 1024ULL * 1024ULL;
+	//!	@brief	アップロード用リングバッファの確保単位 (定数バッファの境界)
+	static UINT64 constexpr D3D12_UPLOAD_ALIGNMENT = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT;
+
+	/**	@struct	D3D12UploadRange
+	 *	@brief	アップロード用リングバッファから切り出した領域
+	 */
+	struct D3D12UploadRange final {
+		//!	@brief	CPU から書き込む先 (失敗したら nullptr)
+		void* cpu;
+		//!	@brief	GPU アドレス
+		D3D12_GPU_VIRTUAL_ADDRESS gpu;
+		//!	@brief	リソース
+		ID3D12Resource* resource;
+		//!	@brief	リソース内の位置
+		UINT64 offset;
+	};
+
+	/**	@class	D3D12UploadQueue
+	 *	@brief	Direct3D12 用のアップロードキュー
+	 *	@details	常に Map したままの UPLOAD ヒープを RangeRing でフレーム単位に切り出し、
+	 *				そこから DEFAULT ヒープのリソースへのコピーをコピーキューに積みます。
+	 *				submit でコピーを提出し、描画キューにはその完了を GPU 側で待たせます。
+	 *				リングの領域は描画キューのフレームが終わった時点で返るため、コピーも必ず終わっています。
+	 *				リングの半分を超えるデータは分けて積み、リングが埋まったときは積んだコピーを提出して完了を待ってから
+	 *				全ての領域を返します (読み込み時のようにフレームが進まないときでも失敗しません)。
+	 */
+	class D3D12UploadQueue final : public ISingleton<D3D12UploadQueue> {
+	public	:
+		//!	@brief	デフォルトコンストラクタ
+		D3D12UploadQueue() noexcept;
+		//!	@brief	デストラクタ
+		~D3D12UploadQueue() noexcept;
+
+		//!	@brief	初期化関数
+		bool const init(UINT64 const& size = D3D12_UPLOAD_RING_SIZE) noexcept;
+		//!	@brief	終了関数
+		void exit() noexcept;
+
+		/**	@brief	アップロード関数
+		 *	@param[in] dst コピー先 (COMMON 状態のバッファ)
+		 *	@param[in] offset コピー先の位置
+		 *	@param[in] data データの先頭ポインタ
+		 *	@param[in] size 大きさ (リングより大きくても構いません)
+		 *	@retval true コピーを積みました。
+		 *	@retval false 積めませんでした。
+		 */
+		bool const upload(ID3D12Resource* dst, UINT64 const& offset, void const* data, UINT64 const& size) noexcept;
+		/**	@brief	提出関数
+		 *	@param[in] waiter コピーの完了を待たせるキュー
+		 */
+		bool const submit(D3D12CommandQueue const& waiter) noexcept;
+		//!	@brief	全コピーの完了を CPU で待つ関数
+		void wait() noexcept;
+
+		//!	@brief	フレーム開始関数 (FramePacer の slot を渡します)
+		void beginFrame(unsigned int const& slot) noexcept;
+		//!	@brief	フレーム終了関数
+		void endFrame(unsigned int const& slot) noexcept;
+
+	private	:
+		/**	@brief	一時領域の確保関数 (m_mutex を取ってから呼び出します)
+		 *	@param[in] size 大きさ (D3D12_UPLOAD_ALIGNMENT に切り上げます、リングの半分まで)
+		 *	@return 切り出した領域 (リングが埋まっていれば、積んだコピーの完了を待って全ての領域を返してから切り出します)
+		 */
+		D3D12UploadRange const allocate(UINT64 const& size) noexcept;
+		//!	@brief	記録中のコピーの提出関数 (m_mutex を取ってから呼び出します)
+		bool const execute() noexcept;
+
+		//!	@brief	リングバッファ
+		ID3D12Resource2* m_buffer;
+		//!	@brief	リングバッファの書き込み先
+		unsigned char* m_mapped;
+		//!	@brief	リングバッファの切り出し (D3D12_UPLOAD_ALIGNMENT 単位)
+		RangeRing m_ring;
+		//!	@brief	コピーキュー
+		D3D12CommandQueue m_queue;
+		//!	@brief	コピーコマンドリスト
+		D3D12CommandList m_list;
+		//!	@brief	フェンス
+		D3D12Fence m_fence;
+		//!	@brief	最後に提出したコピーのフェンス値
+		UINT64 m_value;
+		//!	@brief	描画キューに待たせたフェンス値
+		UINT64 m_waited;
+		//!	@brief	記録中かどうか
+		bool m_recording;
+		//!	@brief	排他
+		std::mutex m_mutex;
+	};
+}
@@ -0,0 +1,148 @@
+﻿/**	@file	dlph_batcher.hpp
+ *	@brief	同じメッシュの描画をまとめるインスタンス描画器
+ */
+#pragma once
+#include "ifs/nonmovable.hpp"
+#include "structs/flt4x4.hpp"
+#include "dlph_cmd_stream.hpp"
+#include <vector>
+
+namespace dlph {
+	//!	@brief	インスタンスデータを流す頂点バッファのスロット
+	static unsigned int constexpr BATCH_INSTANCE_SLOT = 1U;
+	//!	@brief	無効なメッシュ番号
+	static unsigned int constexpr BATCH_INVALID = ~0U;
+
+	/**	@struct	BatchMesh
+	 *	@brief	まとめて描画するメッシュ
+	 */
+	struct BatchMesh final {
+		//!	@brief	頂点バッファ
+		RenderResource vertices;
+		//!	@brief	インデックスバッファ
+		RenderResource indices;
+		//!	@brief	頂点一つのバイト数
+		unsigned int stride;
+		//!	@brief	インデックス数
+		unsigned int indexCount;
+		//!	@brief	先頭のインデックスの位置
+		unsigned int firstIndex;
+		//!	@brief	インデックスに足す値
+		int baseVertex;
+		//!	@brief	インデックスの形式
+		IndexFormat indexFormat;
+	};
+
+	/**	@struct	BatchInstance
+	 *	@brief	インスタンスごとのデータ
+	 *	@details	行ベクトル規約のアフィン変換行列の先頭三列を転置して詰めたものです。
+	 *				シェーダでは dot(float4(position, 1), rows[i]) で i 番目の成分が求まります。
+	 *				入力レイアウトでは BATCH_INSTANCE_SLOT のインスタンス単位のデータとして読み込みます。
+	 */
+	struct BatchInstance final {
+		//!	@brief	転置した変換行列の先頭三列
+		float rows[3][4];
+		//!	@brief	マテリアル番号
+		unsigned int material;
+	};
+	static_assert(sizeof(BatchInstance) == 52U, "BatchInstance must be tightly packed.");
+
+	/**	@struct	DrawBatch
+	 *	@brief	インスタンス描画一回分のまとまり
+	 */
+	struct DrawBatch final {
+		//!	@brief	メッシュ番号
+		unsigned int mesh;
+		//!	@brief	マテリアル番号
+		unsigned int material;
+		//!	@brief	先頭のインスタンスの位置
+		unsigned int firstInstance;
+		//!	@brief	インスタンス数
+		unsigned int instanceCount;
+	};
+
+	/**	@class	DrawBatcher
+	 *	@brief	同じメッシュの描画をまとめるインスタンス描画器
+	 *	@details	フレームごとに描画するオブジェクトを submit で集め、build でメッシュとマテリアルの組ごとに基数ソートして
+	 *				インスタンスデータを書き込み先へ組ごとに連続して書き出します。record は組ごとに一回のインスタンス描画を記録し、
+	 *				インスタンスデータは BATCH_INSTANCE_SLOT に束ねた一つのバッファから firstInstance で読み分けます。
+	 *				メッシュは登録したまま使い回し、reset ではオブジェクトだけを捨てます。スレッドセーフではありません。
+	 */
+	class DrawBatcher final :
+		public INonmovable<DrawBatcher>
+	{
+	public	:
+		//!	@brief	デフォルトコンストラクタ
+		DrawBatcher() noexcept;
+		//!	@brief	デストラクタ
+		~DrawBatcher() noexcept;
+
+		/**	@brief	初期化関数
+		 *	@param[in] instances 予約しておくオブジェクト数
+		 */
+		bool const init(size_t const& instances) noexcept;
+		//!	@brief	終了関数
+		void exit() noexcept;
+		//!	@brief	オブジェクトの全削除関数 (メッシュと容量は残します)
+		void reset() noexcept;
+
+		//!	@brief	メッシュ登録関数 (失敗したら BATCH_INVALID)
+		unsigned int const addMesh(BatchMesh const& mesh) noexcept;
+		//!	@brief	メッシュの全削除関数
+		void clearMeshes() noexcept;
+
+		/**	@brief	オブジェクト追加関数
+		 *	@param[in] mesh メッシュ番号
+		 *	@param[in] material マテリアル番号
+		 *	@param[in] world ワールド変換行列 (行ベクトル規約のアフィン変換)
+		 */
+		bool const submit(unsigned int const& mesh, unsigned int const& material, Float4x4 const& world) noexcept;
+		/**	@brief	まとめ関数
+		 *	@param[in] dst インスタンスデータの書き込み先 (bytes() 以上の大きさ)
+		 *	@param[in] capacity 書き込み先のバイト数
+		 *	@retval true まとめました。
+		 *	@retval false 書き込み先が足りません。
+		 */
+		bool const build(void* const dst, size_t const& capacity) noexcept;
+		/**	@brief	記録関数
+		 *	@param[in] stream 記録先の描画コマンド列
+		 *	@param[in] pipeline 描画に使うパイプライン
+		 *	@param[in] instances build で書き込んだバッファ
+		 *	@param[in] offset バッファ内の書き込み先の位置
+		 *	@param[in] layer 並べ替えキーのレイヤー
+		 *	@param[in] pass 並べ替えキーのパス
+		 */
+		void record(RenderCommandStream& stream, RenderPipeline const& pipeline, RenderResource const& instances, unsigned long long const& offset, unsigned int const& layer = 0U, unsigned int const& pass = 0U) const noexcept;
+
+		//!	@brief	オブジェクト数
+		size_t const instanceCount() const noexcept;
+		//!	@brief	インスタンスデータのバイト数
+		size_t const bytes() const noexcept;
+		//!	@brief	まとまりの数
+		size_t const batchCount() const noexcept;
+		//!	@brief	まとまりの先頭
+		DrawBatch const* const batches() const noexcept;
+
+	private	:
+		/**	@struct	Item
+		 *	@brief	並べ替えの単位
+		 */
+		struct Item final {
+			//!	@brief	メッシュ番号とマテリアル番号を並べたキー
+			unsigned long long key;
+			//!	@brief	インスタンスデータの位置
+			unsigned int index;
+		};
+
+		//!	@brief	メッシュ
+		std::vector<BatchMesh> m_meshes;
+		//!	@brief	インスタンスデータ (追加順)
+		std::vector<BatchInstance> m_instances;
+		//!	@brief	並べ替えの単位
+		std::vector<Item> m_items;
+		//!	@brief	並べ替えの作業領域
+		std::vector<Item> m_scratch;
+		//!	@brief	まとまり
+		std::vector<DrawBatch> m_batches;
+	};
+}
@@ -0,0 +1,106 @@
+﻿/**	@file	dlph_cmd_pool.hpp
+ *	@brief	フレームごとのコマンドリストプール
+ */
+#pragma once
+#include "ifs/nonmovable.hpp"
+#include <atomic>
+#include <memory>
+
+namespace dlph {
+	/**	@class	CommandListPool<L>
+	 *	@brief	フレームごとのコマンドリストプール
+	 *	@details	フレームバッファごとに一組のコマンドリスト (アロケータ込み) を用意し、複数のスレッドへ配ります。
+	 *				配るときに受け取った順序番号で並べ直してから閉じるため、記録したスレッドの速さに関係なく
+	 *				提出順は毎フレーム同じになります。順序番号はフレーム内で重複させないでください。
+	 *				末尾に予約したリストは acquireReserved でだけ配るため、acquire で使い切っても
+	 *				フレームの後処理 (Present 用のバリアなど) を記録できます。
+	 *				L は init(...) / exit() / recording() / closing() を持つコマンドリスト型です。
+	 *				フレームを再利用する前に、そのフレームのリストを GPU が使い終えていることは呼び出し側で保証してください。
+	 */
+	template <typename L>
+	class CommandListPool final :
+		public INonmovable<CommandListPool<L>>
+	{
+	public	:
+		//!	@brief	デフォルトコンストラクタ
+		CommandListPool() noexcept;
+		//!	@brief	デストラクタ
+		~CommandListPool() noexcept;
+
+		/**	@brief	初期化関数
+		 *	@param[in] frames フレーム数
+		 *	@param[in] lists フレームあたりのリスト数 (予約分を含みます)
+		 *	@param[in] reserved フレームあたりの予約リスト数 (lists より小さい値)
+		 *	@param[in] args リストの初期化引数
+		 */
+		template <typename... Args>
+		bool const init(size_t const& frames, size_t const& lists, size_t const& reserved, Args const&... args) noexcept;
+		//!	@brief	終了関数
+		void exit() noexcept;
+
+		/**	@brief	フレーム開始関数
+		 *	@param[in] frame フレーム番号 (バックバッファ番号)
+		 */
+		bool const begin(size_t const& frame) noexcept;
+		/**	@brief	リスト取得関数 (スレッドセーフ)
+		 *	@param[in] order 提出順序 (フレーム内で一意の値)
+		 *	@return 記録を開始したリスト (予約分以外を使い切ったら nullptr)
+		 */
+		L* const acquire(unsigned int const& order) noexcept;
+		/**	@brief	予約リスト取得関数 (スレッドセーフ)
+		 *	@param[in] order 提出順序 (フレーム内で一意の値)
+		 *	@return 記録を開始したリスト (予約分を使い切ったら nullptr)
+		 */
+		L* const acquireReserved(unsigned int const& order) noexcept;
+		/**	@brief	フレーム終了関数
+		 *	@details	配ったリストを全て閉じ、提出順に func へ渡します。全スレッドの記録が終わってから呼んでください。
+		 *				順序番号が重複していた場合はエラーを出力し、該当するリストは配った順に並べます。
+		 *	@param[in] func 関数 (L&)
+		 *	@return 渡したリスト数
+		 */
+		template <typename F>
+		size_t const finish(F const& func) noexcept;
+
+		//!	@brief	フレーム数
+		size_t const frameCount() const noexcept;
+		//!	@brief	フレームあたりのリスト数 (予約分を含みます)
+		size_t const listCount() const noexcept;
+		//!	@brief	現在のフレームで配ったリスト数 (予約分を含みます)
+		size_t const used() const noexcept;
+
+	private	:
+		/**	@struct	Entry
+		 *	@brief	配ったリストの記録
+		 */
+		struct Entry final {
+			//!	@brief	提出順序
+			unsigned int order;
+			//!	@brief	フレーム内の番号
+			unsigned int slot;
+			//!	@brief	記録を開始できたかどうか
+			bool valid;
+		};
+
+		//!	@brief	リストの記録開始関数
+		L* const start(size_t const& slot, unsigned int const& order) noexcept;
+
+		//!	@brief	コマンドリスト (フレーム順に listCount 個ずつ)
+		std::unique_ptr<L[]> m_lists;
+		//!	@brief	現在のフレームで配ったリストの記録
+		std::unique_ptr<Entry[]> m_entries;
+		//!	@brief	フレーム数
+		size_t m_frames;
+		//!	@brief	フレームあたりのリスト数
+		size_t m_count;
+		//!	@brief	フレームあたりの予約リスト数
+		size_t m_reserved;
+		//!	@brief	現在のフレーム
+		size_t m_frame;
+		//!	@brief	現在のフレームで配った予約分以外のリスト数
+		std::atomic<size_t> m_used;
+		//!	@brief	現在のフレームで配った予約リスト数
+		std::atomic<size_t> m_usedReserved;
+	};
+}
+
+#include "dlph_cmd_pool.inl"
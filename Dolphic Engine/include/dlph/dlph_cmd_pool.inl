@@ -0,0 +1,167 @@
+﻿/**	@file	dlph_cmd_pool.inl
+ *	@brief	フレームごとのコマンドリストプール
+ */
+#pragma once
+#include "dlph_cmd_pool.hpp"
+#include <algorithm>
+#include <new>
+
+namespace dlph {
+	template<typename L>
+	inline CommandListPool<L>::CommandListPool() noexcept :
+		INonmovable<CommandListPool<L>>(),
+		m_lists(),
+		m_entries(),
+		m_frames(0U),
+		m_count(0U),
+		m_reserved(0U),
+		m_frame(0U),
+		m_used(0U),
+		m_usedReserved(0U)
+	{}
+
+	template<typename L>
+	inline CommandListPool<L>::~CommandListPool() noexcept {
+		exit();
+	}
+
+	template<typename L>
+	template<typename... Args>
+	inline bool const CommandListPool<L>::init(size_t const& frames, size_t const& lists, size_t const& reserved, Args const&... args) noexcept {
+		exit();
+		if (frames == 0U || lists <= reserved) {
+			OutputDebugStringA("ERROR : COMMAND LIST POOL NEEDS AT LEAST ONE UNRESERVED LIST.\n");
+			return false;
+		}
+
+		m_lists.reset(new (std::nothrow) L[frames * lists]);
+		m_entries.reset(new (std::nothrow) Entry[lists]);
+		if (!m_lists || !m_entries) {
+			exit();
+			OutputDebugStringA("ERROR : CREATE FAILED COMMAND LIST POOL.\n");
+			return false;
+		}
+		for (size_t idx = 0U; idx < frames * lists; ++idx) {
+			if (!m_lists[idx].init(args...)) {
+				exit();
+				return false;
+			}
+		}
+
+		m_frames = frames;
+		m_count = lists;
+		m_reserved = reserved;
+		return true;
+	}
+
+	template<typename L>
+	inline void CommandListPool<L>::exit() noexcept {
+		if (m_lists) {
+			for (size_t idx = 0U; idx < m_frames * m_count; ++idx) {
+				m_lists[idx].exit();
+			}
+		}
+		m_lists.reset();
+		m_entries.reset();
+		m_frames = 0U;
+		m_count = 0U;
+		m_reserved = 0U;
+		m_frame = 0U;
+		m_used.store(0U);
+		m_usedReserved.store(0U);
+	}
+
+	template<typename L>
+	inline bool const CommandListPool<L>::begin(size_t const& frame) noexcept {
+		if (frame >= m_frames) {
+			OutputDebugStringA("ERROR : COMMAND LIST POOL FRAME INDEX OUT OF RANGE.\n");
+			return false;
+		}
+		m_frame = frame;
+		m_used.store(0U);
+		m_usedReserved.store(0U);
+		return true;
+	}
+
+	template<typename L>
+	inline L* const CommandListPool<L>::acquire(unsigned int const& order) noexcept {
+		size_t const slot = m_used.fetch_add(1U);
+		if (slot >= m_count - m_reserved) {
+			OutputDebugStringA("ERROR : COMMAND LIST POOL EXHAUSTED.\n");
+			return nullptr;
+		}
+		return start(slot, order);
+	}
+
+	template<typename L>
+	inline L* const CommandListPool<L>::acquireReserved(unsigned int const& order) noexcept {
+		size_t const idx = m_usedReserved.fetch_add(1U);
+		if (idx >= m_reserved) {
+			OutputDebugStringA("ERROR : COMMAND LIST POOL RESERVED LISTS EXHAUSTED.\n");
+			return nullptr;
+		}
+		return start(m_count - m_reserved + idx, order);
+	}
+
+	template<typename L>
+	inline L* const CommandListPool<L>::start(size_t const& slot, unsigned int const& order) noexcept {
+		L& list = m_lists[m_frame * m_count + slot];
+		bool const valid = list.recording();
+		m_entries[slot] = { order, static_cast<unsigned int>(slot), valid };
+		return valid ? &list : nullptr;
+	}
+
+	template<typename L>
+	template<typename F>
+	inline size_t const CommandListPool<L>::finish(F const& func) noexcept {
+		//	予約分の記録を配った分の直後へ詰めてから並べる
+		size_t const general = std::min(m_used.load(), m_count - m_reserved);
+		size_t const reserved = std::min(m_usedReserved.load(), m_reserved);
+		for (size_t idx = 0U; idx < reserved; ++idx) {
+			m_entries[general + idx] = m_entries[m_count - m_reserved + idx];
+		}
+		size_t const count = general + reserved;
+		std::sort(&m_entries[0], &m_entries[0] + count, [](Entry const& lhs, Entry const& rhs) {
+			return lhs.order != rhs.order ? lhs.order < rhs.order : lhs.slot < rhs.slot;
+		});
+		for (size_t idx = 1U; idx < count; ++idx) {
+			if (m_entries[idx - 1U].order == m_entries[idx].order) {
+				OutputDebugStringA("ERROR : COMMAND LIST ORDER IS DUPLICATED.\n");
+#if	defined(_DEBUG) || defined(DEBUG)
+				_ASSERT_EXPR(false, L"ERROR : COMMAND LIST ORDER IS DUPLICATED.");
+#endif
+			}
+		}
+
+		size_t result = 0U;
+		for (size_t idx = 0U; idx < count; ++idx) {
+			Entry const& entry = m_entries[idx];
+			if (!entry.valid) {
+				continue;
+			}
+			L& list = m_lists[m_frame * m_count + entry.slot];
+			if (list.closing()) {
+				func(list);
+				++result;
+			}
+		}
+		m_used.store(0U);
+		m_usedReserved.store(0U);
+		return result;
+	}
+
+	template<typename L>
+	inline size_t const CommandListPool<L>::frameCount() const noexcept {
+		return m_frames;
+	}
+
+	template<typename L>
+	inline size_t const CommandListPool<L>::listCount() const noexcept {
+		return m_count;
+	}
+
+	template<typename L>
+	inline size_t const CommandListPool<L>::used() const noexcept {
+		return std::min(m_used.load(), m_count - m_reserved) + std::min(m_usedReserved.load(), m_reserved);
+	}
+}
@@ -0,0 +1,407 @@
+﻿/**	@file	dlph_cmd_stream.hpp
+ *	@brief	バックエンドに依存しない描画コマンド列
+ */
+#pragma once
+#include "ifs/nonmovable.hpp"
+#include "mem/arena.hpp"
+#include "mem/handle.hpp"
+#include "dlph_sort_key.hpp"
+#include <vector>
+
+namespace dlph {
+	//!	@brief	リソースハンドルの印
+	struct RenderResourceTag;
+	//!	@brief	パイプラインハンドルの印
+	struct RenderPipelineTag;
+	//!	@brief	リソースハンドル (値の解釈はバックエンドが行います)
+	using RenderResource = Handle32<RenderResourceTag>;
+	//!	@brief	パイプラインハンドル (値の解釈はバックエンドが行います)
+	using RenderPipeline = Handle32<RenderPipelineTag>;
+	//!	@brief	全てのサブリソースを表す番号
+	static unsigned int constexpr SUBRESOURCE_ALL = ~0U;
+
+	/**	@enum	RenderCommandType
+	 *	@brief	描画コマンドの種類
+	 */
+	enum class RenderCommandType : unsigned char {
+		//!	@brief	描画
+		Draw = 0U,
+		//!	@brief	インデックス付き描画
+		DrawIndexed,
+		//!	@brief	コンピュートシェーダの実行
+		Dispatch,
+		//!	@brief	パイプラインの設定
+		SetPipeline,
+		//!	@brief	頂点バッファの設定
+		BindVertexBuffer,
+		//!	@brief	インデックスバッファの設定
+		BindIndexBuffer,
+		//!	@brief	定数 (GPU アドレス) の設定
+		BindConstants,
+		//!	@brief	リソースの設定
+		BindResource,
+		//!	@brief	リソースの状態遷移
+		Barrier,
+		//!	@brief	バッファのコピー
+		Copy,
+		//!	@brief	種類の数
+		Count
+	};
+
+	/**	@enum	ResourceState
+	 *	@brief	リソースの状態
+	 */
+	enum class ResourceState : unsigned char {
+		//!	@brief	共通
+		Common = 0U,
+		//!	@brief	頂点バッファ / 定数バッファ
+		VertexAndConstant,
+		//!	@brief	インデックスバッファ
+		Index,
+		//!	@brief	シェーダからの読み取り
+		ShaderResource,
+		//!	@brief	順序無しアクセス
+		UnorderedAccess,
+		//!	@brief	レンダーターゲット
+		RenderTarget,
+		//!	@brief	深度の書き込み
+		DepthWrite,
+		//!	@brief	深度の読み取り
+		DepthRead,
+		//!	@brief	コピー元
+		CopySource,
+		//!	@brief	コピー先
+		CopyDest,
+		//!	@brief	画面表示
+		Present,
+	};
+
+	/**	@enum	BarrierKind
+	 *	@brief	バリアの種類
+	 */
+	enum class BarrierKind : unsigned char {
+		//!	@brief	状態遷移
+		Transition = 0U,
+		//!	@brief	分割した状態遷移の開始 (後の End と対にします)
+		Begin,
+		//!	@brief	分割した状態遷移の終了
+		End,
+		//!	@brief	順序無しアクセスの書き込み完了待ち (状態は変えません)
+		UnorderedAccess,
+		//!	@brief	メモリを共有するリソースの使用開始 (状態は不定になります)
+		Aliasing,
+	};
+
+	/**	@enum	IndexFormat
+	 *	@brief	インデックスの形式
+	 */
+	enum class IndexFormat : unsigned char {
+		//!	@brief	32 ビット
+		UInt32 = 0U,
+		//!	@brief	16 ビット
+		UInt16,
+	};
+
+	/**	@struct	RenderCommandHeader
+	 *	@brief	描画コマンドの先頭
+	 */
+	struct RenderCommandHeader final {
+		//!	@brief	種類
+		RenderCommandType type;
+		//!	@brief	本体を含めたバイト数
+		unsigned short size;
+	};
+
+	/**	@struct	DrawCommand
+	 *	@brief	描画コマンド
+	 */
+	struct DrawCommand final {
+		//!	@brief	種類
+		static RenderCommandType constexpr TYPE = RenderCommandType::Draw;
+		//!	@brief	頂点数
+		unsigned int vertexCount;
+		//!	@brief	インスタンス数
+		unsigned int instanceCount;
+		//!	@brief	先頭の頂点
+		unsigned int firstVertex;
+		//!	@brief	先頭のインスタンス
+		unsigned int firstInstance;
+	};
+
+	/**	@struct	DrawIndexedCommand
+	 *	@brief	インデックス付き描画コマンド
+	 */
+	struct DrawIndexedCommand final {
+		//!	@brief	種類
+		static RenderCommandType constexpr TYPE = RenderCommandType::DrawIndexed;
+		//!	@brief	インデックス数
+		unsigned int indexCount;
+		//!	@brief	インスタンス数
+		unsigned int instanceCount;
+		//!	@brief	先頭のインデックス
+		unsigned int firstIndex;
+		//!	@brief	頂点番号に足す値
+		int baseVertex;
+		//!	@brief	先頭のインスタンス
+		unsigned int firstInstance;
+	};
+
+	/**	@struct	DispatchCommand
+	 *	@brief	コンピュートシェーダの実行コマンド
+	 */
+	struct DispatchCommand final {
+		//!	@brief	種類
+		static RenderCommandType constexpr TYPE = RenderCommandType::Dispatch;
+		//!	@brief	X 方向のグループ数
+		unsigned int x;
+		//!	@brief	Y 方向のグループ数
+		unsigned int y;
+		//!	@brief	Z 方向のグループ数
+		unsigned int z;
+	};
+
+	/**	@struct	SetPipelineCommand
+	 *	@brief	パイプラインの設定コマンド
+	 */
+	struct SetPipelineCommand final {
+		//!	@brief	種類
+		static RenderCommandType constexpr TYPE = RenderCommandType::SetPipeline;
+		//!	@brief	パイプライン
+		RenderPipeline pipeline;
+	};
+
+	/**	@struct	BindVertexBufferCommand
+	 *	@brief	頂点バッファの設定コマンド
+	 */
+	struct BindVertexBufferCommand final {
+		//!	@brief	種類
+		static RenderCommandType constexpr TYPE = RenderCommandType::BindVertexBuffer;
+		//!	@brief	バッファ
+		RenderResource buffer;
+		//!	@brief	スロット
+		unsigned int slot;
+		//!	@brief	頂点の大きさ
+		unsigned int stride;
+		//!	@brief	バッファ内の位置
+		unsigned long long offset;
+	};
+
+	/**	@struct	BindIndexBufferCommand
+	 *	@brief	インデックスバッファの設定コマンド
+	 */
+	struct BindIndexBufferCommand final {
+		//!	@brief	種類
+		static RenderCommandType constexpr TYPE = RenderCommandType::BindIndexBuffer;
+		//!	@brief	バッファ
+		RenderResource buffer;
+		//!	@brief	バッファ内の位置
+		unsigned long long offset;
+		//!	@brief	インデックスの形式
+		IndexFormat format;
+	};
+
+	/**	@struct	BindConstantsCommand
+	 *	@brief	定数の設定コマンド
+	 */
+	struct BindConstantsCommand final {
+		//!	@brief	種類
+		static RenderCommandType constexpr TYPE = RenderCommandType::BindConstants;
+		//!	@brief	ルート引数の番号
+		unsigned int root;
+		//!	@brief	定数の GPU アドレス
+		unsigned long long address;
+	};
+
+	/**	@struct	BindResourceCommand
+	 *	@brief	リソースの設定コマンド
+	 */
+	struct BindResourceCommand final {
+		//!	@brief	種類
+		static RenderCommandType constexpr TYPE = RenderCommandType::BindResource;
+		//!	@brief	ルート引数の番号
+		unsigned int root;
+		//!	@brief	リソース
+		RenderResource resource;
+	};
+
+	/**	@struct	BarrierCommand
+	 *	@brief	リソースの状態遷移コマンド
+	 */
+	struct BarrierCommand final {
+		//!	@brief	種類
+		static RenderCommandType constexpr TYPE = RenderCommandType::Barrier;
+		//!	@brief	リソース
+		RenderResource resource;
+		//!	@brief	遷移前の状態
+		ResourceState before;
+		//!	@brief	遷移後の状態
+		ResourceState after;
+		//!	@brief	バリアの種類
+		BarrierKind kind;
+		//!	@brief	サブリソース番号 (SUBRESOURCE_ALL は全て)
+		unsigned int subresource;
+	};
+
+	/**	@struct	CopyCommand
+	 *	@brief	バッファのコピーコマンド
+	 */
+	struct CopyCommand final {
+		//!	@brief	種類
+		static RenderCommandType constexpr TYPE = RenderCommandType::Copy;
+		//!	@brief	コピー先
+		RenderResource dst;
+		//!	@brief	コピー元
+		RenderResource src;
+		//!	@brief	コピー先の位置
+		unsigned long long dstOffset;
+		//!	@brief	コピー元の位置
+		unsigned long long srcOffset;
+		//!	@brief	大きさ
+		unsigned long long size;
+	};
+
+	/**	@struct	RenderCommandPacket<T>
+	 *	@brief	先頭と本体を並べた描画コマンドの塊
+	 */
+	template <typename T>
+	struct RenderCommandPacket final {
+		//!	@brief	先頭
+		RenderCommandHeader header;
+		//!	@brief	本体
+		T body;
+	};
+
+	/**	@class	IRenderBackend
+	 *	@brief	描画コマンドの再生先
+	 *	@details	RenderCommandStream::submit がコマンドを一つずつ解読して呼び出します。
+	 *				Direct3D12 などの実際の API に変換するものと、検証と計数だけを行うものがあります。
+	 */
+	class IRenderBackend {
+	public	:
+		//!	@brief	デストラクタ
+		virtual ~IRenderBackend() noexcept = default;
+
+		//!	@brief	描画
+		virtual void draw(DrawCommand const& cmd) noexcept = 0;
+		//!	@brief	インデックス付き描画
+		virtual void drawIndexed(DrawIndexedCommand const& cmd) noexcept = 0;
+		//!	@brief	コンピュートシェーダの実行
+		virtual void dispatch(DispatchCommand const& cmd) noexcept = 0;
+		//!	@brief	パイプラインの設定
+		virtual void setPipeline(SetPipelineCommand const& cmd) noexcept = 0;
+		//!	@brief	頂点バッファの設定
+		virtual void bindVertexBuffer(BindVertexBufferCommand const& cmd) noexcept = 0;
+		//!	@brief	インデックスバッファの設定
+		virtual void bindIndexBuffer(BindIndexBufferCommand const& cmd) noexcept = 0;
+		//!	@brief	定数の設定
+		virtual void bindConstants(BindConstantsCommand const& cmd) noexcept = 0;
+		//!	@brief	リソースの設定
+		virtual void bindResource(BindResourceCommand const& cmd) noexcept = 0;
+		//!	@brief	リソースの状態遷移
+		virtual void barrier(BarrierCommand const& cmd) noexcept = 0;
+		//!	@brief	バッファのコピー
+		virtual void copy(CopyCommand const& cmd) noexcept = 0;
+	};
+
+	/**	@class	RenderCommandStream
+	 *	@brief	バックエンドに依存しない描画コマンド列
+	 *	@details	コマンドを種類と大きさの先頭に続けた小さなパケットとして LinearArena に積み、
+	 *				パケットごとに現在の並べ替えキーを添えて記録します。
+	 *				sort はキーで安定に基数ソートするため、同じキーの中では記録順が保たれます。
+	 *				並べ替えると描画の前後が入れ替わるので、描画ごとに必要な状態を同じキーで積み直し、
+	 *				重複した設定は再生時に RenderStateFilter で取り除いてください。
+	 *				スレッドセーフではないため、記録するスレッドごとに用意してください。
+	 */
+	class RenderCommandStream final :
+		public INonmovable<RenderCommandStream>
+	{
+	public	:
+		/**	@struct	Entry
+		 *	@brief	並べ替えの単位
+		 */
+		struct Entry final {
+			//!	@brief	並べ替えキー
+			unsigned long long key;
+			//!	@brief	パケット
+			RenderCommandHeader const* packet;
+		};
+
+		//!	@brief	デフォルトコンストラクタ
+		RenderCommandStream() noexcept;
+		//!	@brief	デストラクタ
+		~RenderCommandStream() noexcept;
+
+		/**	@brief	初期化関数
+		 *	@param[in] capacity パケットを積むアリーナの容量 (バイト数)
+		 *	@param[in] commands 予約しておくコマンド数
+		 */
+		bool const init(size_t const& capacity, size_t const& commands = 0U) noexcept;
+		//!	@brief	終了関数
+		void exit() noexcept;
+		//!	@brief	全削除関数 (容量は残します)
+		void reset() noexcept;
+
+		//!	@brief	以降のコマンドの並べ替えキー設定関数
+		void setKey(unsigned long long const& key) noexcept;
+		//!	@brief	以降のコマンドの並べ替えキー設定関数
+		void setKey(SortKey const& key) noexcept;
+		//!	@brief	現在の並べ替えキー取得関数
+		unsigned long long const getKey() const noexcept;
+
+		//!	@brief	コマンド追加関数 (T は TYPE を持つコマンド構造体)
+		template <typename T>
+		T* const push(T const& cmd) noexcept;
+
+		//!	@brief	描画
+		void draw(unsigned int const& vertexCount, unsigned int const& instanceCount = 1U, unsigned int const& firstVertex = 0U, unsigned int const& firstInstance = 0U) noexcept;
+		//!	@brief	インデックス付き描画
+		void drawIndexed(unsigned int const& indexCount, unsigned int const& instanceCount = 1U, unsigned int const& firstIndex = 0U, int const& baseVertex = 0, unsigned int const& firstInstance = 0U) noexcept;
+		//!	@brief	コンピュートシェーダの実行
+		void dispatch(unsigned int const& x, unsigned int const& y = 1U, unsigned int const& z = 1U) noexcept;
+		//!	@brief	パイプラインの設定
+		void setPipeline(RenderPipeline const& pipeline) noexcept;
+		//!	@brief	頂点バッファの設定
+		void bindVertexBuffer(unsigned int const& slot, RenderResource const& buffer, unsigned int const& stride, unsigned long long const& offset = 0U) noexcept;
+		//!	@brief	インデックスバッファの設定
+		void bindIndexBuffer(RenderResource const& buffer, IndexFormat const& format = IndexFormat::UInt32, unsigned long long const& offset = 0U) noexcept;
+		//!	@brief	定数の設定
+		void bindConstants(unsigned int const& root, unsigned long long const& address) noexcept;
+		//!	@brief	リソースの設定
+		void bindResource(unsigned int const& root, RenderResource const& resource) noexcept;
+		//!	@brief	リソースの状態遷移
+		void barrier(RenderResource const& resource, ResourceState const& before, ResourceState const& after, BarrierKind const& kind = BarrierKind::Transition, unsigned int const& subresource = SUBRESOURCE_ALL) noexcept;
+		//!	@brief	バッファのコピー
+		void copy(RenderResource const& dst, unsigned long long const& dstOffset, RenderResource const& src, unsigned long long const& srcOffset, unsigned long long const& size) noexcept;
+
+		//!	@brief	キーでの並べ替え関数 (同じキーの中では記録順を保ち、要素数が多ければ並列に処理します)
+		void sort() noexcept;
+		//!	@brief	再生関数 (記録順のまま再生します。キー順にするには先に sort を呼びます)
+		void submit(IRenderBackend& backend) const noexcept;
+
+		//!	@brief	コマンド数
+		size_t const size() const noexcept;
+		//!	@brief	空かどうか
+		bool const empty() const noexcept;
+		//!	@brief	パケットの使用バイト数
+		size_t const bytes() const noexcept;
+		//!	@brief	並べ替えの単位の先頭
+		Entry const* const begin() const noexcept;
+		//!	@brief	並べ替えの単位の末尾
+		Entry const* const end() const noexcept;
+
+		//!	@brief	パケット一つの再生関数
+		static void dispatchPacket(RenderCommandHeader const& packet, IRenderBackend& backend) noexcept;
+
+	private	:
+		//!	@brief	パケット
+		LinearArena m_arena;
+		//!	@brief	並べ替えの単位
+		std::vector<Entry> m_entries;
+		//!	@brief	並べ替えの作業領域
+		std::vector<Entry> m_scratch;
+		//!	@brief	現在の並べ替えキー
+		unsigned long long m_key;
+	};
+}
+
+#include "dlph_cmd_stream.inl"
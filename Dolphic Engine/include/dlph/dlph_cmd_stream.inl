@@ -0,0 +1,23 @@
+﻿/**	@file	dlph_cmd_stream.inl
+ *	@brief	バックエンドに依存しない描画コマンド列
+ */
+#pragma once
+#include "dlph_cmd_stream.hpp"
+#include <new>
+#include <type_traits>
+
+namespace dlph {
+	template<typename T>
+	inline T* const RenderCommandStream::push(T const& cmd) noexcept {
+		static_assert(std::is_trivially_copyable<T>::value, "Render command must be trivially copyable.");
+		static_assert(sizeof(RenderCommandPacket<T>) <= 0xFFFFU, "Render command is too large.");
+
+		void* const ptr = m_arena.allocate(sizeof(RenderCommandPacket<T>), alignof(RenderCommandPacket<T>));
+		RenderCommandPacket<T>* const packet = ::new (ptr) RenderCommandPacket<T>{
+			{ T::TYPE, static_cast<unsigned short>(sizeof(RenderCommandPacket<T>)) },
+			cmd
+		};
+		m_entries.push_back({ m_key, &packet->header });
+		return &packet->body;
+	}
+}
@@ -0,0 +1,221 @@
+﻿/**	@file	dlph_frame_graph.hpp
+ *	@brief	フレームグラフ
+ */
+#pragma once
+#include "ifs/nonmovable.hpp"
+#include "dlph_cmd_stream.hpp"
+#include <vector>
+
+namespace dlph {
+	//!	@brief	無効なパスとリソースの番号
+	static unsigned int constexpr FRAME_GRAPH_INVALID = ~0U;
+
+	/**	@struct	FrameGraphResourceDesc
+	 *	@brief	一時リソースの大きさ
+	 */
+	struct FrameGraphResourceDesc final {
+		//!	@brief	バイト数
+		unsigned long long size;
+		//!	@brief	配置の境界 (2 のべき乗)
+		unsigned long long alignment;
+	};
+
+	/**	@struct	FrameGraphBarrier
+	 *	@brief	コンパイルで求めたバリア
+	 */
+	struct FrameGraphBarrier final {
+		//!	@brief	リソース番号
+		unsigned int resource;
+		//!	@brief	遷移前の状態
+		ResourceState before;
+		//!	@brief	遷移後の状態
+		ResourceState after;
+		//!	@brief	バリアの種類
+		BarrierKind kind;
+	};
+
+	/**	@struct	FrameGraphStats
+	 *	@brief	コンパイルの集計
+	 */
+	struct FrameGraphStats final {
+		//!	@brief	実行するパスの数
+		unsigned int passes;
+		//!	@brief	取り除いたパスの数
+		unsigned int culled;
+		//!	@brief	分割しない状態遷移の数
+		unsigned int transitions;
+		//!	@brief	分割した状態遷移の数 (開始と終了の組で一つ)
+		unsigned int splits;
+		//!	@brief	順序無しアクセスのバリアの数
+		unsigned int uavs;
+		//!	@brief	メモリ共有のバリアの数
+		unsigned int aliasing;
+		//!	@brief	状態が変わらずバリアの要らなかった使用の数
+		unsigned int skipped;
+		//!	@brief	使用する一時リソースの大きさの合計
+		unsigned long long transientBytes;
+		//!	@brief	メモリを共有させた後の一時リソース用ヒープの大きさ
+		unsigned long long heapBytes;
+	};
+
+	/**	@class	FrameGraph
+	 *	@brief	フレームグラフ
+	 *	@details	パスごとに読み書きするリソースと状態を宣言し、compile で次のことを求めます。
+	 *				・外部リソースや副作用のあるパスに結果が届かないパスの除去
+	 *				・状態遷移のバリア (間にパスがあれば開始と終了に分割し、使用ごとの重複は省きます)
+	 *				・寿命の重ならない一時リソースを同じメモリに置く配置とメモリ共有のバリア
+	 *				書き込みだけの宣言は内容を全て上書きするものとして扱います。前の内容を使う場合は読み込みも宣言してください。
+	 *				一時リソースはフレームの終わりに最初の使用の状態へ戻すため、毎フレーム同じ状態から始まります。
+	 *				コンパイルは宣言の順だけで決まり、プラットフォームにも依存しません。スレッドセーフではありません。
+	 */
+	class FrameGraph final :
+		public INonmovable<FrameGraph>
+	{
+	public	:
+		//!	@brief	デフォルトコンストラクタ
+		FrameGraph() noexcept;
+		//!	@brief	デストラクタ
+		~FrameGraph() noexcept = default;
+
+		//!	@brief	全削除関数 (容量は残します)
+		void reset() noexcept;
+
+		//!	@brief	一時リソース作成関数
+		unsigned int const createResource(FrameGraphResourceDesc const& desc) noexcept;
+		/**	@brief	外部リソース登録関数
+		 *	@param[in] handle リソースハンドル
+		 *	@param[in] initial フレーム開始時の状態
+		 *	@param[in] final フレーム終了時に戻す状態
+		 */
+		unsigned int const importResource(RenderResource const& handle, ResourceState const& initial, ResourceState const& final) noexcept;
+		//!	@brief	パス追加関数 (sideEffect は結果が外部リソースに出なくても除去しない印)
+		unsigned int const addPass(bool const& sideEffect = false) noexcept;
+		//!	@brief	読み込みの宣言関数
+		bool const read(unsigned int const& pass, unsigned int const& resource, ResourceState const& state) noexcept;
+		//!	@brief	書き込みの宣言関数
+		bool const write(unsigned int const& pass, unsigned int const& resource, ResourceState const& state) noexcept;
+
+		//!	@brief	コンパイル関数
+		bool const compile() noexcept;
+		//!	@brief	リソースハンドル設定関数 (一時リソースを実体化したら設定します)
+		void setHandle(unsigned int const& resource, RenderResource const& handle) noexcept;
+		/**	@brief	記録関数
+		 *	@details	実行するパスの順に、そのパスの前のバリアを記録してから func(パス番号, stream) を呼び出します。
+		 *				パスの間の前後関係を保つため、記録したコマンド列は並べ替えずに再生してください。
+		 */
+		template <typename F>
+		void execute(RenderCommandStream& stream, F const& func) const noexcept;
+		//!	@brief	バリアの記録関数 (slot は実行順の位置、passes() の値はフレームの終わり)
+		void recordBarriers(size_t const& slot, RenderCommandStream& stream) const noexcept;
+
+		//!	@brief	パス数
+		size_t const passCount() const noexcept;
+		//!	@brief	リソース数
+		size_t const resourceCount() const noexcept;
+		//!	@brief	実行するパスの数
+		size_t const passes() const noexcept;
+		//!	@brief	実行順のパス番号
+		unsigned int const* const order() const noexcept;
+		//!	@brief	パスが除去されたかどうか
+		bool const culled(unsigned int const& pass) const noexcept;
+		//!	@brief	実行順の位置の前のバリアの先頭
+		FrameGraphBarrier const* const barrierBegin(size_t const& slot) const noexcept;
+		//!	@brief	実行順の位置の前のバリアの末尾
+		FrameGraphBarrier const* const barrierEnd(size_t const& slot) const noexcept;
+		//!	@brief	一時リソースかどうか
+		bool const transient(unsigned int const& resource) const noexcept;
+		//!	@brief	実行するパスで使われるかどうか
+		bool const used(unsigned int const& resource) const noexcept;
+		//!	@brief	一時リソースの大きさ
+		FrameGraphResourceDesc const& desc(unsigned int const& resource) const noexcept;
+		//!	@brief	一時リソース用ヒープ内の位置
+		unsigned long long const offset(unsigned int const& resource) const noexcept;
+		//!	@brief	最初の使用の状態 (一時リソースはこの状態で作ります)
+		ResourceState const firstState(unsigned int const& resource) const noexcept;
+		//!	@brief	リソースハンドル取得関数
+		RenderResource const getHandle(unsigned int const& resource) const noexcept;
+		//!	@brief	集計取得関数
+		FrameGraphStats const& stats() const noexcept;
+
+	private	:
+		/**	@struct	Use
+		 *	@brief	パスでのリソースの使用
+		 */
+		struct Use final {
+			//!	@brief	リソース番号
+			unsigned int resource;
+			//!	@brief	使用中の状態
+			ResourceState state;
+			//!	@brief	読み込むかどうか
+			bool read;
+			//!	@brief	書き込むかどうか
+			bool write;
+		};
+
+		/**	@struct	Pass
+		 *	@brief	パス
+		 */
+		struct Pass final {
+			//!	@brief	使用するリソース (宣言順)
+			std::vector<Use> uses;
+			//!	@brief	除去しない印
+			bool sideEffect;
+			//!	@brief	除去されたかどうか
+			bool culled;
+		};
+
+		/**	@struct	Resource
+		 *	@brief	リソース
+		 */
+		struct Resource final {
+			//!	@brief	大きさ
+			FrameGraphResourceDesc desc;
+			//!	@brief	ハンドル
+			RenderResource handle;
+			//!	@brief	ヒープ内の位置
+			unsigned long long offset;
+			//!	@brief	最初に使う実行順の位置
+			unsigned int first;
+			//!	@brief	最後に使う実行順の位置
+			unsigned int last;
+			//!	@brief	フレーム開始時の状態
+			ResourceState initial;
+			//!	@brief	フレーム終了時の状態
+			ResourceState final;
+			//!	@brief	最初の使用の状態
+			ResourceState firstState;
+			//!	@brief	外部リソースかどうか
+			bool imported;
+		};
+
+		//!	@brief	使用の宣言関数
+		bool const use(unsigned int const& pass, unsigned int const& resource, ResourceState const& state, bool const& write) noexcept;
+		//!	@brief	パスの除去関数
+		void cull() noexcept;
+		//!	@brief	一時リソースの配置関数
+		void place() noexcept;
+		//!	@brief	バリアの計算関数
+		void schedule() noexcept;
+		//!	@brief	状態遷移の追加関数
+		void transition(unsigned int const& resource, unsigned int const& from, unsigned int const& slot, ResourceState const& before, ResourceState const& after) noexcept;
+
+		//!	@brief	パス
+		std::vector<Pass> m_passes;
+		//!	@brief	リソース
+		std::vector<Resource> m_resources;
+		//!	@brief	実行順のパス番号
+		std::vector<unsigned int> m_order;
+		//!	@brief	バリア (実行順の位置でまとめたもの)
+		std::vector<FrameGraphBarrier> m_barriers;
+		//!	@brief	バリアの実行順の位置 (並べ替え前の作業用)
+		std::vector<unsigned int> m_barrierSlots;
+		//!	@brief	実行順の位置ごとのバリアの開始位置
+		std::vector<size_t> m_slots;
+		//!	@brief	集計
+		FrameGraphStats m_stats;
+		//!	@brief	コンパイル済みかどうか
+		bool m_compiled;
+	};
+}
+
+#include "dlph_frame_graph.inl"
@@ -0,0 +1,20 @@
+﻿/**	@file	dlph_frame_graph.inl
+ *	@brief	フレームグラフ
+ */
+#pragma once
+#include "dlph_frame_graph.hpp"
+
+namespace dlph {
+	template<typename F>
+	inline void FrameGraph::execute(RenderCommandStream& stream, F const& func) const noexcept {
+		if (!m_compiled) {
+			OutputDebugStringA("ERROR : FRAME GRAPH IS NOT COMPILED.\n");
+			return;
+		}
+		for (size_t slot = 0U; slot < m_order.size(); ++slot) {
+			recordBarriers(slot, stream);
+			func(m_order[slot], stream);
+		}
+		recordBarriers(m_order.size(), stream);
+	}
+}
@@ -0,0 +1,71 @@
+﻿/**	@file	dlph_frame_pacer.hpp
+ *	@brief	フレームペーサー
+ */
+#pragma once
+
+namespace dlph {
+	//!	@brief	同時に処理できるフレーム数の最大値
+	static unsigned int constexpr FRAME_LATENCY_MAX = 3U;
+	//!	@brief	同時に処理するフレーム数の既定値
+	static unsigned int constexpr FRAME_LATENCY_DEFAULT = 2U;
+
+	/**	@class	FramePacer
+	 *	@brief	フレームペーサー
+	 *	@details	CPU が記録するフレームと GPU が処理するフレームを最大 latency 枚まで重ねるための管理クラスです。
+	 *				フレームごとの資源 (アロケータなど) は slot 番号で使い分け、提出時にフェンス値を割り当てます。
+	 *				slot を再利用する前に、そのフェンス値 (pending) まで GPU が進んでいれば待つ必要はありません。
+	 *				フェンスそのものは扱わないため、GPU を模した数値だけで動作を確かめられます。
+	 */
+	class FramePacer final {
+	public	:
+		//!	@brief	ムーブコンストラクタ
+		FramePacer(FramePacer&&) noexcept = default;
+		//!	@brief	コピーコンストラクタ
+		FramePacer(FramePacer const&) noexcept = default;
+		//!	@brief	ムーブ代入演算子
+		FramePacer& operator=(FramePacer&&) & noexcept = default;
+		//!	@brief	コピー代入演算子
+		FramePacer& operator=(FramePacer const&) & noexcept = default;
+
+		//!	@brief	デフォルトコンストラクタ
+		FramePacer() noexcept;
+		//!	@brief	デストラクタ
+		~FramePacer() noexcept = default;
+
+		/**	@brief	初期化関数
+		 *	@param[in] latency 同時に処理するフレーム数 (1 ～ FRAME_LATENCY_MAX)
+		 */
+		bool const init(unsigned int const& latency = FRAME_LATENCY_DEFAULT) noexcept;
+		//!	@brief	終了関数
+		void exit() noexcept;
+
+		//!	@brief	現在のフレームの slot 番号
+		unsigned int const slot() const noexcept;
+		//!	@brief	現在の slot を再利用する前に GPU が到達すべきフェンス値 (0 は待つ必要無し)
+		unsigned long long const pending() const noexcept;
+		//!	@brief	GPU の到達値から、現在の slot がまだ使用中かどうか
+		bool const busy(unsigned long long const& completed) const noexcept;
+		/**	@brief	提出関数
+		 *	@details	現在の slot にフェンス値を割り当て、次のフレームへ進めます。
+		 *	@return キューへシグナルするフェンス値
+		 */
+		unsigned long long const submit() noexcept;
+		//!	@brief	最後に割り当てたフェンス値 (全フレームの完了を待つときに使います)
+		unsigned long long const last() const noexcept;
+
+		//!	@brief	同時に処理するフレーム数
+		unsigned int const latency() const noexcept;
+		//!	@brief	提出したフレーム数
+		unsigned long long const frame() const noexcept;
+
+	private	:
+		//!	@brief	slot ごとのフェンス値
+		unsigned long long m_values[FRAME_LATENCY_MAX];
+		//!	@brief	最後に割り当てたフェンス値
+		unsigned long long m_last;
+		//!	@brief	提出したフレーム数
+		unsigned long long m_frame;
+		//!	@brief	同時に処理するフレーム数
+		unsigned int m_latency;
+	};
+}
@@ -0,0 +1,101 @@
+﻿/**	@file	dlph_headless.hpp
+ *	@brief	GPU を使わない描画バックエンド
+ */
+#pragma once
+#include "dlph_cmd_stream.hpp"
+#include <unordered_map>
+
+namespace dlph {
+	//!	@brief	頂点バッファのスロット数
+	static unsigned int constexpr HEADLESS_VERTEX_SLOT_CNT = 32U;
+	//!	@brief	一方向あたりのコンピュートシェーダのグループ数の上限
+	static unsigned int constexpr HEADLESS_DISPATCH_MAX = 65535U;
+	//!	@brief	定数の GPU アドレスの境界
+	static unsigned long long constexpr HEADLESS_CONSTANT_ALIGNMENT = 256U;
+
+	/**	@struct	HeadlessStats
+	 *	@brief	GPU を使わない描画バックエンドの集計
+	 */
+	struct HeadlessStats final {
+		//!	@brief	種類ごとのコマンド数
+		unsigned long long commands[static_cast<unsigned int>(RenderCommandType::Count)];
+		//!	@brief	描画の回数 (インデックス付きを含みます)
+		unsigned long long draws;
+		//!	@brief	頂点数の合計 (インスタンス数を掛けたもの)
+		unsigned long long vertices;
+		//!	@brief	インデックス数の合計 (インスタンス数を掛けたもの)
+		unsigned long long indices;
+		//!	@brief	コンピュートシェーダのグループ数の合計
+		unsigned long long groups;
+		//!	@brief	コピーしたバイト数の合計
+		unsigned long long copied;
+		//!	@brief	検証で見つかった誤りの数
+		unsigned long long errors;
+	};
+
+	/**	@class	HeadlessBackend
+	 *	@brief	GPU を使わない描画バックエンド
+	 *	@details	コマンドを実行せず、描画状態を追って不正な使い方 (パイプライン未設定での描画、状態の食い違う遷移など) を検出し、
+	 *				種類ごとの数を数えます。GPU の無い環境で描画処理を動かしたり、記録の速さを測ったりするためのものです。
+	 */
+	class HeadlessBackend final : public IRenderBackend {
+	public	:
+		//!	@brief	デフォルトコンストラクタ
+		HeadlessBackend() noexcept;
+		//!	@brief	デストラクタ
+		~HeadlessBackend() noexcept = default;
+
+		//!	@brief	集計と描画状態の初期化関数
+		void reset() noexcept;
+		//!	@brief	集計取得関数
+		HeadlessStats const& stats() const noexcept;
+		//!	@brief	誤りが無いかどうか
+		bool const valid() const noexcept;
+
+		//!	@brief	描画
+		void draw(DrawCommand const& cmd) noexcept override;
+		//!	@brief	インデックス付き描画
+		void drawIndexed(DrawIndexedCommand const& cmd) noexcept override;
+		//!	@brief	コンピュートシェーダの実行
+		void dispatch(DispatchCommand const& cmd) noexcept override;
+		//!	@brief	パイプラインの設定
+		void setPipeline(SetPipelineCommand const& cmd) noexcept override;
+		//!	@brief	頂点バッファの設定
+		void bindVertexBuffer(BindVertexBufferCommand const& cmd) noexcept override;
+		//!	@brief	インデックスバッファの設定
+		void bindIndexBuffer(BindIndexBufferCommand const& cmd) noexcept override;
+		//!	@brief	定数の設定
+		void bindConstants(BindConstantsCommand const& cmd) noexcept override;
+		//!	@brief	リソースの設定
+		void bindResource(BindResourceCommand const& cmd) noexcept override;
+		//!	@brief	リソースの状態遷移
+		void barrier(BarrierCommand const& cmd) noexcept override;
+		//!	@brief	バッファのコピー
+		void copy(CopyCommand const& cmd) noexcept override;
+
+	private	:
+		//!	@brief	計数関数
+		void count(RenderCommandType const& type) noexcept;
+		//!	@brief	誤りの記録関数
+		void error(char const* message) noexcept;
+		//!	@brief	追跡している状態の取得関数 (サブリソースの状態が無ければ全体の状態、どちらも無ければ nullptr)
+		ResourceState const* const findState(unsigned int const& resource, unsigned int const& subresource) const noexcept;
+		//!	@brief	状態の更新関数 (全体を更新したらサブリソースごとの状態は捨てます)
+		void setState(unsigned int const& resource, unsigned int const& subresource, ResourceState const& state) noexcept;
+		//!	@brief	状態の削除関数
+		void eraseState(unsigned int const& resource) noexcept;
+
+		//!	@brief	集計
+		HeadlessStats m_stats;
+		//!	@brief	リソースごとの現在の状態
+		std::unordered_map<unsigned int, ResourceState> m_states;
+		//!	@brief	サブリソース単位で遷移したサブリソースの現在の状態 (リソースの値を上位 32 ビットに置いたキー)
+		std::unordered_map<unsigned long long, ResourceState> m_subStates;
+		//!	@brief	分割した状態遷移の途中のリソースと遷移後の状態
+		std::unordered_map<unsigned int, ResourceState> m_pending;
+		//!	@brief	設定中のパイプライン
+		RenderPipeline m_pipeline;
+		//!	@brief	インデックスバッファが設定済みかどうか
+		bool m_indexBuffer;
+	};
+}
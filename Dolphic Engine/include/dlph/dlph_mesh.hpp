@@ -1 +1,75 @@
+﻿/**	@file	dlph_mesh.hpp
+ *	@brief	Dolphic Engine 用のメッシュ構造体
+ */
 #pragma once
+#include "structs/t2.hpp"
+#include "structs/t3.hpp"
+#include "structs/t4.hpp"
+#include <vector>
+
+namespace dlph {
+	class FMatrix4x4;
+
+	/**	@struct	MeshVertex
+	 *	@brief	メッシュ頂点構造体
+	 */
+	struct MeshVertex final {
+		//!	@brief	座標
+		Float3 position;
+		//!	@brief	法線
+		Float3 normal;
+		//!	@brief	接ベクトル (w は従法線の向き)
+		Float4 tangent;
+		//!	@brief	テクスチャ座標
+		Float2 texcoord;
+	};
+
+	/**	@struct	MeshLod
+	 *	@brief	メッシュの詳細度 (LOD) 情報
+	 */
+	struct MeshLod final {
+		//!	@brief	インデックス配列内の開始位置
+		unsigned int indexOffset;
+		//!	@brief	インデックス数
+		unsigned int indexCount;
+		//!	@brief	元形状からの誤差 (物体空間の距離)
+		float error;
+	};
+
+	/**	@struct	Mesh
+	 *	@brief	LOD 連鎖を持つメッシュ構造体
+	 *	@details	全 LOD で一つの頂点配列を共有し、各 LOD のインデックスを連結して保持します。
+	 */
+	struct Mesh final {
+		//!	@brief	頂点配列
+		std::vector<MeshVertex> vertices;
+		//!	@brief	全 LOD のインデックス配列
+		std::vector<unsigned int> indices;
+		//!	@brief	LOD 一覧 (詳細な順)
+		std::vector<MeshLod> lods;
+		//!	@brief	境界球の中心
+		Float3 center;
+		//!	@brief	境界球の半径
+		float radius;
+	};
+
+	/**	@brief	画面上の誤差取得関数
+	 *	@param[in] error 物体空間の誤差
+	 *	@param[in] distance 視点からの距離
+	 *	@param[in] projection 射影行列
+	 *	@param[in] viewport_height ビューポートの高さ (ピクセル)
+	 *	@return	画面上の誤差 (ピクセル)
+	 */
+	float const projectedLodError(float const& error, float const& distance, FMatrix4x4 const& projection, float const& viewport_height) noexcept;
+
+	/**	@brief	LOD 選択関数
+	 *	@details	画面上の誤差が許容値以下となる最も粗い LOD を選びます。行列は行ベクトル規約 (v * M) とします。
+	 *	@param[in] mesh メッシュ
+	 *	@param[in] world_view ワールドビュー行列
+	 *	@param[in] projection 射影行列
+	 *	@param[in] viewport_height ビューポートの高さ (ピクセル)
+	 *	@param[in] pixel_error 許容する画面上の誤差 (ピクセル)
+	 *	@return	LOD 番号
+	 */
+	size_t const selectLod(Mesh const& mesh, FMatrix4x4 const& world_view, FMatrix4x4 const& projection, float const& viewport_height, float const& pixel_error) noexcept;
+}
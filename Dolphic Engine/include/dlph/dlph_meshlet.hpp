@@ -0,0 +1,96 @@
+﻿/**	@file	dlph_meshlet.hpp
+ *	@brief	Dolphic Engine 用のメッシュレット (三角形クラスタ) 関数群
+ */
+#pragma once
+#include "dlph/dlph_mesh.hpp"
+#include <vector>
+
+namespace dlph {
+	class FMatrix4x4;
+	class FVector3;
+
+	//!	@brief	メッシュレットあたりの最大頂点数
+	static unsigned int constexpr MESHLET_VERTEX_MAX = 64U;
+	//!	@brief	メッシュレットあたりの最大三角形数
+	static unsigned int constexpr MESHLET_TRIANGLE_MAX = 124U;
+
+	/**	@struct	Meshlet
+	 *	@brief	メッシュレット
+	 *	@details	GPU へそのまま転送できるよう 16 バイトに詰めています。
+	 */
+	struct Meshlet final {
+		//!	@brief	頂点番号配列内の開始位置
+		unsigned int vertexOffset;
+		//!	@brief	三角形配列内の開始位置
+		unsigned int triangleOffset;
+		//!	@brief	頂点数
+		unsigned int vertexCount;
+		//!	@brief	三角形数
+		unsigned int triangleCount;
+	};
+
+	/**	@struct	MeshletBounds
+	 *	@brief	メッシュレットの境界球と法線錐
+	 *	@details	GPU へそのまま転送できるよう 16 バイト単位で並べています。
+	 *				視点から境界球中心への単位ベクトル d が dot(d, coneAxis) >= coneCutoff を満たすとき、全三角形が裏向きです。
+	 */
+	struct MeshletBounds final {
+		//!	@brief	境界球の中心
+		Float3 center;
+		//!	@brief	境界球の半径
+		float radius;
+		//!	@brief	法線錐の頂点
+		Float3 coneApex;
+		//!	@brief	法線錐の判定値 (錐の半角の正弦、1 以上は判定不能)
+		float coneCutoff;
+		//!	@brief	法線錐の軸
+		Float3 coneAxis;
+		//!	@brief	詰め物
+		float padding;
+	};
+
+	/**	@struct	MeshletData
+	 *	@brief	メッシュレット化したメッシュ
+	 */
+	struct MeshletData final {
+		//!	@brief	メッシュレット一覧
+		std::vector<Meshlet> meshlets;
+		//!	@brief	メッシュレットごとの境界
+		std::vector<MeshletBounds> bounds;
+		//!	@brief	メッシュレット内の頂点番号から元の頂点番号への対応
+		std::vector<unsigned int> vertices;
+		//!	@brief	メッシュレット内の頂点番号三つを 8 ビットずつ詰めた三角形
+		std::vector<unsigned int> triangles;
+	};
+
+	/**	@brief	メッシュレット生成関数
+	 *	@details	頂点を共有する三角形を優先し、次いで空間的に近く法線の揃った三角形を貪欲に集めて分割します。
+	 *	@param[out] out メッシュレット
+	 *	@param[in] vertices 頂点配列
+	 *	@param[in] indices インデックス配列
+	 *	@param[in] cone_weight 法線の揃い具合を重視する度合い (0 ～ 1)
+	 *	@retval true 生成しました。
+	 *	@retval false インデックスが空です。
+	 */
+	bool const buildMeshlets(MeshletData& out, std::vector<MeshVertex> const& vertices, std::vector<unsigned int> const& indices, float const& cone_weight = 0.25f) noexcept;
+
+	/**	@brief	メッシュレット一括生成関数
+	 *	@details	各メッシュの最も詳細な LOD をメッシュ単位で並列に分割します。
+	 *	@param[out] out メッシュごとのメッシュレット
+	 *	@param[in] meshes メッシュ配列の先頭
+	 *	@param[in] count メッシュ数
+	 *	@param[in] cone_weight 法線の揃い具合を重視する度合い (0 ～ 1)
+	 */
+	void buildMeshlets(std::vector<MeshletData>& out, Mesh const* meshes, size_t const& count, float const& cone_weight = 0.25f) noexcept;
+
+	/**	@brief	メッシュレット選別関数
+	 *	@details	視錐台と法線錐で選別し、見えるメッシュレットの番号を詰めて出力します。行列は行ベクトル規約 (v * M) とします。
+	 *	@param[out] visible 見えるメッシュレットの番号
+	 *	@param[in] data メッシュレット
+	 *	@param[in] world ワールド行列
+	 *	@param[in] view_projection ビュー射影行列
+	 *	@param[in] camera ワールド空間の視点
+	 *	@return	見えるメッシュレット数
+	 */
+	size_t const cullMeshlets(std::vector<unsigned int>& visible, MeshletData const& data, FMatrix4x4 const& world, FMatrix4x4 const& view_projection, FVector3 const& camera) noexcept;
+}
@@ -0,0 +1,44 @@
+﻿/**	@file	dlph_meshopt.hpp
+ *	@brief	Dolphic Engine 用のメッシュ最適化関数群
+ */
+#pragma once
+#include "dlph/dlph_mesh.hpp"
+#include <vector>
+
+namespace dlph {
+	//!	@brief	頂点キャッシュ最適化で想定するキャッシュサイズ
+	static unsigned int constexpr VERTEX_CACHE_SIZE = 32U;
+
+	/**	@brief	頂点キャッシュ最適化関数
+	 *	@details	Forsyth 法で変換後頂点キャッシュの再利用率が高くなるよう三角形を並べ替えます。
+	 *	@param[in,out] indices インデックス配列
+	 *	@param[in] vertex_count 頂点数
+	 */
+	void optimizeVertexCache(std::vector<unsigned int>& indices, size_t const& vertex_count) noexcept;
+
+	/**	@brief	オーバードロー最適化関数
+	 *	@details	頂点キャッシュ最適化済みのインデックスをキャッシュ効率が保たれる範囲でクラスタに分け、
+	 *				外向きのクラスタから先に描画されるよう並べ替えます。
+	 *	@param[in,out] indices インデックス配列
+	 *	@param[in] vertices 頂点配列
+	 *	@param[in] threshold 許容する頂点キャッシュ効率の悪化率 (1.05 で 5% まで)
+	 */
+	void optimizeOverdraw(std::vector<unsigned int>& indices, std::vector<MeshVertex> const& vertices, float const& threshold = 1.05f) noexcept;
+
+	/**	@brief	頂点フェッチ最適化関数
+	 *	@details	頂点をインデックスで最初に参照される順に並べ替え、参照されない頂点を取り除きます。
+	 *	@param[in,out] vertices 頂点配列
+	 *	@param[in,out] indices インデックス配列
+	 *	@return	並べ替え後の頂点数
+	 */
+	size_t const optimizeVertexFetch(std::vector<MeshVertex>& vertices, std::vector<unsigned int>& indices) noexcept;
+
+	/**	@brief	平均キャッシュミス率取得関数
+	 *	@details	FIFO キャッシュを模擬し、三角形あたりの頂点処理数 (ACMR) を求めます。
+	 *	@param[in] indices インデックス配列
+	 *	@param[in] vertex_count 頂点数
+	 *	@param[in] cache_size キャッシュサイズ
+	 *	@return	三角形あたりのキャッシュミス数
+	 */
+	float const vertexCacheMissRatio(std::vector<unsigned int> const& indices, size_t const& vertex_count, unsigned int const& cache_size = 16U) noexcept;
+}
@@ -0,0 +1,40 @@
+﻿/**	@file	dlph_meshproc.hpp
+ *	@brief	Dolphic Engine 用のメッシュ加工関数群
+ */
+#pragma once
+#include "dlph/dlph_mesh.hpp"
+#include <vector>
+
+namespace dlph {
+	/**	@brief	頂点結合関数
+	 *	@details	全成分の差が許容値以下の頂点をハッシュで探索して一つにまとめ、インデックスを付け替えます。
+	 *				インデックスが空の場合は頂点配列を非インデックスの三角形リストとして扱います。
+	 *	@param[in,out] vertices 頂点配列
+	 *	@param[in,out] indices インデックス配列
+	 *	@param[in] epsilon 許容値 (0 の場合は完全一致)
+	 *	@return	結合後の頂点数
+	 */
+	size_t const weldVertices(std::vector<MeshVertex>& vertices, std::vector<unsigned int>& indices, float const& epsilon = 0.0f) noexcept;
+
+	/**	@brief	座標代表頂点取得関数
+	 *	@details	同じ座標を持つ頂点のうち、最初に現れた頂点の番号を各頂点について求めます。
+	 *	@param[in] vertices 頂点配列
+	 *	@param[out] remap 代表頂点の番号
+	 */
+	void generatePositionRemap(std::vector<MeshVertex> const& vertices, std::vector<unsigned int>& remap) noexcept;
+
+	/**	@brief	法線生成関数
+	 *	@details	同じ座標を持つ頂点同士で、面法線を頂点角で重み付けして平均します。
+	 *	@param[in,out] vertices 頂点配列
+	 *	@param[in] indices インデックス配列
+	 */
+	void generateNormals(std::vector<MeshVertex>& vertices, std::vector<unsigned int> const& indices) noexcept;
+
+	/**	@brief	接ベクトル生成関数
+	 *	@details	MikkTSpace と同じ規約 (法線平面への射影、頂点角による重み付け、w = 従法線の向き) で生成します。
+	 *				法線は生成済みである必要があります。
+	 *	@param[in,out] vertices 頂点配列
+	 *	@param[in] indices インデックス配列
+	 */
+	void generateTangents(std::vector<MeshVertex>& vertices, std::vector<unsigned int> const& indices) noexcept;
+}
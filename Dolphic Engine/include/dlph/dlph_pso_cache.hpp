@@ -0,0 +1,143 @@
+﻿/**	@file	dlph_pso_cache.hpp
+ *	@brief	パイプラインキャッシュ
+ */
+#pragma once
+#include "ifs/nonmovable.hpp"
+#include "job/job_system.hpp"
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace dlph {
+	//!	@brief	パイプラインキャッシュのファイルの識別子 ("DLPC")
+	static unsigned int constexpr PIPELINE_CACHE_MAGIC = 0x43504C44U;
+	//!	@brief	パイプラインキャッシュのファイルの版
+	static unsigned int constexpr PIPELINE_CACHE_VERSION = 1U;
+	//!	@brief	パイプラインキャッシュのファイルで一つのデータに許す最大のバイト数
+	static unsigned long long constexpr PIPELINE_CACHE_BLOB_MAX = 64ULL * 1024ULL * 1024ULL;
+
+	/**	@enum	PipelineStatus
+	 *	@brief	パイプラインの作成状況
+	 */
+	enum class PipelineStatus : unsigned char {
+		//!	@brief	作成を要求されていない
+		Missing,
+		//!	@brief	ワーカースレッドで作成中
+		Pending,
+		//!	@brief	作成済み
+		Ready,
+		//!	@brief	作成に失敗した (再要求しても作り直しません)
+		Failed,
+	};
+
+	/**	@struct	PipelineCacheStats
+	 *	@brief	パイプラインキャッシュの集計
+	 */
+	struct PipelineCacheStats final {
+		//!	@brief	作成済みのパイプラインを返した数
+		unsigned long long hits;
+		//!	@brief	作成済みでなかった数
+		unsigned long long misses;
+		//!	@brief	作成した数
+		unsigned long long created;
+		//!	@brief	保存したデータを使って作成した数
+		unsigned long long warm;
+		//!	@brief	作成に失敗した数
+		unsigned long long failed;
+		//!	@brief	ファイルから読み込んだデータの数
+		unsigned long long loaded;
+		//!	@brief	ファイルへ書き出したデータの数
+		unsigned long long saved;
+	};
+
+	/**	@class	PipelineCache
+	 *	@brief	パイプラインキャッシュ
+	 *	@details	シェーダのバイトコードとパイプラインの設定のハッシュ (hash_bytes) をキーに、作成したパイプラインと
+	 *				ドライバが返すキャッシュデータを持ちます。パイプラインの作成は JobSystem のワーカースレッドで行い、
+	 *				作成中は find が nullptr を返すため、描画スレッドが作成を待って止まることはありません。
+	 *				キャッシュデータはファイルに保存して次回の起動時に読み込み、作成関数に渡します。
+	 *				パイプラインは種類を問わない void* として扱い、作成と解放はバックエンドが行います。
+	 *
+	 *				ファイルはリトルエンディアンで、ヘッダ (識別子, 版, 数, 予約, 環境タグ) の後に
+	 *				(キー, バイト数, データのハッシュ, データ) が並びます。識別子、版、環境タグのどれかが異なれば全て捨てます。
+	 *				ハッシュの合わないデータはそれだけを捨て、ファイルが途中で切れていればそこで読み込みを止めます。
+	 */
+	class PipelineCache final :
+		public INonmovable<PipelineCache>
+	{
+	public	:
+		//!	@brief	デフォルトコンストラクタ
+		PipelineCache() noexcept;
+		//!	@brief	デストラクタ
+		~PipelineCache() noexcept;
+
+		/**	@brief	初期化関数
+		 *	@param[in] tag 環境タグ (ドライバの版など。異なる環境で保存したファイルは読み込みません)
+		 */
+		bool const init(unsigned long long const& tag = 0ULL) noexcept;
+		//!	@brief	終了関数 (作成中のパイプラインを待ちます。作成済みのものは先に release で解放してください)
+		void exit() noexcept;
+
+		//!	@brief	ファイル読み込み関数 (作成中のパイプラインを待ってから読み込みます。壊れたデータがあれば、他を読み込んでも false を返します)
+		bool const load(char const* const path) noexcept;
+		//!	@brief	ファイル書き出し関数 (一時ファイルに書いてから置き換えます)
+		bool const save(char const* const path) noexcept;
+
+		//!	@brief	作成済みのパイプラインの取得関数 (作成済みでなければ nullptr)
+		void* const find(unsigned long long const& key) noexcept;
+		//!	@brief	作成状況の取得関数
+		PipelineStatus const status(unsigned long long const& key) const noexcept;
+		/**	@brief	作成の要求関数
+		 *	@details	作成を要求されていなければ、ワーカースレッドで func を呼びます。
+		 *	@param[in] key キー
+		 *	@param[in] func 作成関数 void* (unsigned char const* data, size_t size, std::vector<unsigned char>& out)。
+		 *				data は保存したキャッシュデータ (無ければ nullptr)、out には次回用のキャッシュデータを書き込み、
+		 *				作成したパイプライン (失敗は nullptr) を返します。
+		 *	@return 要求後の作成状況
+		 */
+		template <typename F>
+		PipelineStatus const request(unsigned long long const& key, F&& func) noexcept;
+		//!	@brief	作成中のパイプラインを全て待つ関数
+		void wait() noexcept;
+		/**	@brief	作成済みのパイプラインの解放関数
+		 *	@details	キャッシュデータは残すため、解放した後も save できます。
+		 *	@param[in] func 解放関数 void (void* pipeline)
+		 */
+		template <typename F>
+		void release(F const& func) noexcept;
+
+		//!	@brief	キーの数
+		size_t const size() const noexcept;
+		//!	@brief	集計取得関数
+		PipelineCacheStats const stats() const noexcept;
+
+	private	:
+		/**	@struct	Entry
+		 *	@brief	キーごとのパイプライン
+		 */
+		struct Entry final {
+			//!	@brief	作成状況
+			PipelineStatus status;
+			//!	@brief	パイプライン
+			void* pipeline;
+			//!	@brief	キャッシュデータ
+			std::vector<unsigned char> blob;
+		};
+
+		//!	@brief	作成完了関数
+		void finish(Entry& entry, void* pipeline, std::vector<unsigned char>& blob, bool const& warm) noexcept;
+
+		//!	@brief	キーごとのパイプライン (要素の位置は変わらないため、作成中のジョブが参照を持ちます)
+		std::unordered_map<unsigned long long, Entry> m_entries;
+		//!	@brief	排他
+		mutable std::mutex m_mutex;
+		//!	@brief	作成中のジョブ
+		JobCounter m_counter;
+		//!	@brief	集計
+		PipelineCacheStats m_stats;
+		//!	@brief	環境タグ
+		unsigned long long m_tag;
+	};
+}
+
+#include "dlph_pso_cache.inl"
@@ -0,0 +1,52 @@
+﻿/**	@file	dlph_pso_cache.inl
+ *	@brief	パイプラインキャッシュ
+ */
+#pragma once
+#include "dlph_pso_cache.hpp"
+#include <utility>
+
+namespace dlph {
+	template<typename F>
+	inline PipelineStatus const PipelineCache::request(unsigned long long const& key, F&& func) noexcept {
+		Entry* entry = nullptr;
+		{
+			std::lock_guard<std::mutex> const lock(m_mutex);
+			Entry& target = m_entries[key];
+			if (target.status != PipelineStatus::Missing) {
+				return target.status;
+			}
+			target.status = PipelineStatus::Pending;
+			entry = &target;
+		}
+
+		JobSystem::getInstance().run([this, entry, create = std::forward<F>(func)]() mutable {
+			//	作成は時間がかかるため、キャッシュデータは写してから排他の外で渡す
+			std::vector<unsigned char> cached;
+			{
+				std::lock_guard<std::mutex> const lock(m_mutex);
+				cached = entry->blob;
+			}
+			std::vector<unsigned char> blob;
+			bool const warm = !cached.empty();
+			void* const pipeline = create(warm ? cached.data() : nullptr, cached.size(), blob);
+			finish(*entry, pipeline, blob, warm);
+		}, &m_counter);
+
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		return entry->status;
+	}
+
+	template<typename F>
+	inline void PipelineCache::release(F const& func) noexcept {
+		wait();
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		for (auto& pair : m_entries) {
+			Entry& entry = pair.second;
+			if (entry.pipeline) {
+				func(entry.pipeline);
+			}
+			entry.pipeline = nullptr;
+			entry.status = PipelineStatus::Missing;
+		}
+	}
+}
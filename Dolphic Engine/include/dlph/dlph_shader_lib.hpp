@@ -0,0 +1,219 @@
+﻿/**	@file	dlph_shader_lib.hpp
+ *	@brief	シェーダライブラリ
+ */
+#pragma once
+#include "util/mapped_file.hpp"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace dlph {
+	//!	@brief	シェーダライブラリの識別子 ("DLSL")
+	static unsigned int constexpr SHADER_LIBRARY_MAGIC = 0x4C534C44U;
+	//!	@brief	シェーダライブラリの版
+	static unsigned int constexpr SHADER_LIBRARY_VERSION = 1U;
+	//!	@brief	シェーダライブラリのバイトコードの配置境界
+	static size_t constexpr SHADER_LIBRARY_ALIGNMENT = 16U;
+
+	/**	@enum	ShaderStage
+	 *	@brief	シェーダの段階
+	 */
+	enum class ShaderStage : unsigned int {
+		//!	@brief	頂点シェーダ
+		Vertex,
+		//!	@brief	ピクセルシェーダ
+		Pixel,
+		//!	@brief	ドメインシェーダ
+		Domain,
+		//!	@brief	ハルシェーダ
+		Hull,
+		//!	@brief	ジオメトリシェーダ
+		Geometry,
+		//!	@brief	コンピュートシェーダ
+		Compute,
+		//!	@brief	増幅シェーダ
+		Amplification,
+		//!	@brief	メッシュシェーダ
+		Mesh,
+	};
+
+	/**	@enum	ShaderBindingType
+	 *	@brief	シェーダが使うリソースの種類
+	 */
+	enum class ShaderBindingType : unsigned int {
+		//!	@brief	定数バッファ
+		ConstantBuffer,
+		//!	@brief	シェーダリソース
+		ShaderResource,
+		//!	@brief	順序無しアクセス
+		UnorderedAccess,
+		//!	@brief	サンプラ
+		Sampler,
+	};
+
+	/**	@struct	ShaderBinding
+	 *	@brief	シェーダの反映情報 (ルートシグネチャの作成に使うリソースの割り当て)
+	 */
+	struct ShaderBinding final {
+		//!	@brief	種類
+		ShaderBindingType type;
+		//!	@brief	レジスタ番号
+		unsigned int reg;
+		//!	@brief	レジスタ空間
+		unsigned int space;
+		//!	@brief	配列の要素数 (0 は境界無し)
+		unsigned int count;
+	};
+	static_assert(sizeof(ShaderBinding) == 16U, "Shader binding must be packed.");
+
+	/**	@struct	ShaderView
+	 *	@brief	シェーダライブラリ内のシェーダの参照 (ライブラリを閉じるまで有効)
+	 */
+	struct ShaderView final {
+		//!	@brief	バイトコード (見つからなければ nullptr)
+		unsigned char const* data;
+		//!	@brief	バイトコードのバイト数
+		size_t size;
+		//!	@brief	バイトコードのハッシュ (hash_bytes)
+		unsigned long long hash;
+		//!	@brief	段階
+		ShaderStage stage;
+		//!	@brief	反映情報
+		ShaderBinding const* bindings;
+		//!	@brief	反映情報の数
+		unsigned int bindingCount;
+	};
+
+	/**	@class	ShaderLibrary
+	 *	@brief	シェーダライブラリ
+	 *	@details	内容のハッシュで重複を除いたバイトコードを一つのファイルにまとめたもので、メモリマップトファイルとして開きます。
+	 *				開く時に読むのはヘッダと索引だけで、バイトコードは find で参照したページだけが読み込まれます。
+	 *				名前の索引は名前のハッシュ順、バイトコードの表は内容のハッシュ順に並んでおり、二分探索で引きます。
+	 *
+	 *				ファイルはリトルエンディアンで、ヘッダ、名前の索引、バイトコードの表、反映情報、名前の文字列、バイトコードの順に並びます。
+	 *				ShaderLibraryBuilder で作成してください。
+	 */
+	class ShaderLibrary final :
+		public INoncopyable<ShaderLibrary>
+	{
+	public	:
+		//!	@brief	デフォルトコンストラクタ
+		ShaderLibrary() noexcept;
+		//!	@brief	デストラクタ
+		~ShaderLibrary() noexcept;
+
+		//!	@brief	ファイルを開く初期化関数
+		bool const init(char const* const path) noexcept;
+		//!	@brief	メモリ上のデータを参照する初期化関数 (データはライブラリを閉じるまで有効であること)
+		bool const init(unsigned char const* const data, size_t const& size) noexcept;
+		//!	@brief	終了関数
+		void exit() noexcept;
+
+		//!	@brief	名前での検索関数
+		ShaderView const find(char const* const name) const noexcept;
+		//!	@brief	バイトコードのハッシュでの検索関数
+		ShaderView const find(unsigned long long const& hash) const noexcept;
+		//!	@brief	全てのバイトコードのハッシュを確かめる関数 (全ページを読み込みます)
+		bool const validate() const noexcept;
+
+		//!	@brief	名前の数
+		unsigned int const entryCount() const noexcept;
+		//!	@brief	重複を除いたバイトコードの数
+		unsigned int const blobCount() const noexcept;
+
+	private	:
+		//!	@brief	ヘッダと索引の検証関数
+		bool const attach(unsigned char const* const data, size_t const& size) noexcept;
+		//!	@brief	バイトコードの表の要素から参照を作る関数
+		ShaderView const view(unsigned int const& blob) const noexcept;
+
+		//!	@brief	ファイル
+		MappedFile m_file;
+		//!	@brief	先頭
+		unsigned char const* m_data;
+		//!	@brief	バイト数
+		size_t m_size;
+	};
+
+	/**	@struct	ShaderLibraryStats
+	 *	@brief	シェーダライブラリの作成の集計
+	 */
+	struct ShaderLibraryStats final {
+		//!	@brief	名前の数
+		unsigned int entries;
+		//!	@brief	重複を除いたバイトコードの数
+		unsigned int blobs;
+		//!	@brief	追加されたバイトコードの合計バイト数
+		unsigned long long inputBytes;
+		//!	@brief	重複を除いたバイトコードの合計バイト数
+		unsigned long long uniqueBytes;
+	};
+
+	/**	@class	ShaderLibraryBuilder
+	 *	@brief	シェーダライブラリの作成器
+	 *	@details	同じ内容のバイトコードは一つにまとめ、複数の名前から参照させます。
+	 */
+	class ShaderLibraryBuilder final {
+	public	:
+		//!	@brief	デフォルトコンストラクタ
+		ShaderLibraryBuilder() noexcept;
+		//!	@brief	デストラクタ
+		~ShaderLibraryBuilder() noexcept = default;
+
+		/**	@brief	追加関数
+		 *	@param[in] name 名前 (重複は失敗)
+		 *	@param[in] stage 段階
+		 *	@param[in] data バイトコード
+		 *	@param[in] size バイトコードのバイト数
+		 *	@param[in] bindings 反映情報
+		 *	@param[in] bindingCount 反映情報の数
+		 */
+		bool const add(char const* const name, ShaderStage const& stage, void const* const data, size_t const& size, ShaderBinding const* const bindings = nullptr, unsigned int const& bindingCount = 0U) noexcept;
+		//!	@brief	全削除関数
+		void clear() noexcept;
+
+		//!	@brief	ファイルの内容の作成関数
+		void build(std::vector<unsigned char>& out) const noexcept;
+		//!	@brief	ファイル書き出し関数
+		bool const write(char const* const path) const noexcept;
+
+		//!	@brief	集計取得関数
+		ShaderLibraryStats const stats() const noexcept;
+
+	private	:
+		/**	@struct	Blob
+		 *	@brief	重複を除いたバイトコード
+		 */
+		struct Blob final {
+			//!	@brief	内容のハッシュ
+			unsigned long long hash;
+			//!	@brief	段階
+			ShaderStage stage;
+			//!	@brief	バイトコード
+			std::vector<unsigned char> code;
+			//!	@brief	反映情報
+			std::vector<ShaderBinding> bindings;
+		};
+
+		/**	@struct	Entry
+		 *	@brief	名前
+		 */
+		struct Entry final {
+			//!	@brief	名前のハッシュ
+			unsigned long long hash;
+			//!	@brief	名前
+			std::string name;
+			//!	@brief	バイトコードの番号
+			unsigned int blob;
+		};
+
+		//!	@brief	バイトコード
+		std::vector<Blob> m_blobs;
+		//!	@brief	名前
+		std::vector<Entry> m_entries;
+		//!	@brief	内容のハッシュからバイトコードの番号
+		std::unordered_map<unsigned long long, unsigned int> m_lookup;
+		//!	@brief	追加されたバイトコードの合計バイト数
+		unsigned long long m_inputBytes;
+	};
+}
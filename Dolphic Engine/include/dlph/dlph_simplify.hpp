@@ -0,0 +1,51 @@
+﻿/**	@file	dlph_simplify.hpp
+ *	@brief	Dolphic Engine 用のメッシュ簡略化関数群
+ */
+#pragma once
+#include "dlph/dlph_mesh.hpp"
+#include <cfloat>
+#include <vector>
+
+namespace dlph {
+	/**	@struct	SimplifyOption
+	 *	@brief	メッシュ簡略化設定
+	 */
+	struct SimplifyOption final {
+		//!	@brief	法線の誤差の重み
+		float normalWeight;
+		//!	@brief	テクスチャ座標の誤差の重み
+		float texcoordWeight;
+		//!	@brief	許容する最大誤差 (物体空間の距離)
+		float maxError;
+		//!	@brief	開いた境界の頂点を固定するかどうか
+		bool lockBorder;
+	};
+
+	//!	@brief	既定のメッシュ簡略化設定
+	static SimplifyOption constexpr SIMPLIFY_DEFAULT = { 0.5f, 1.0f, FLT_MAX, false };
+
+	/**	@brief	メッシュ簡略化関数
+	 *	@details	二次誤差計量 (QEM) による辺の片側縮約で三角形を減らします。
+	 *				頂点は既存の頂点へ移動するだけなので、結果のインデックスは元の頂点配列をそのまま参照できます。
+	 *				同じ座標で属性の異なる頂点 (継ぎ目) は両側を揃えて縮約します。
+	 *	@param[out] dst 簡略化後のインデックス配列
+	 *	@param[in] vertices 頂点配列
+	 *	@param[in] indices インデックス配列
+	 *	@param[in] target_index_count 目標インデックス数
+	 *	@param[in] option 簡略化設定
+	 *	@return	元形状からの誤差 (物体空間の距離)
+	 */
+	float const simplifyMesh(std::vector<unsigned int>& dst, std::vector<MeshVertex> const& vertices, std::vector<unsigned int> const& indices, size_t const& target_index_count, SimplifyOption const& option = SIMPLIFY_DEFAULT) noexcept;
+
+	/**	@brief	LOD 連鎖生成関数
+	 *	@details	mesh.indices を最も詳細な LOD とし、一段ごとに三角形数を ratio 倍へ減らした LOD を追加します。
+	 *				各 LOD は頂点キャッシュ最適化され、誤差は元形状からの累積値を記録します。
+	 *	@param[in,out] mesh メッシュ
+	 *	@param[in] max_lod_count 最大 LOD 数 (最も詳細な LOD を含む)
+	 *	@param[in] ratio 一段あたりの三角形数の比率
+	 *	@param[in] option 簡略化設定
+	 *	@retval true 生成しました。
+	 *	@retval false メッシュが空です。
+	 */
+	bool const generateLods(Mesh& mesh, unsigned int const& max_lod_count, float const& ratio = 0.5f, SimplifyOption const& option = SIMPLIFY_DEFAULT) noexcept;
+}
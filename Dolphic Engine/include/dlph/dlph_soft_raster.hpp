@@ -0,0 +1,277 @@
+﻿/**	@file	dlph_soft_raster.hpp
+ *	@brief	CPU で動くラスタライザ
+ */
+#pragma once
+#include "ifs/nonmovable.hpp"
+#include "math/fmtx4x4.hpp"
+#include "math/fvec4.hpp"
+#include <vector>
+
+namespace dlph {
+	//!	@brief	タイルの一辺のピクセル数
+	static unsigned int constexpr RASTER_TILE_SIZE = 8U;
+	//!	@brief	ビン (スレッドへ振り分ける単位) の一辺のピクセル数
+	static unsigned int constexpr RASTER_BIN_SIZE = 64U;
+	//!	@brief	描画先の一辺のピクセル数の上限
+	static unsigned int constexpr RASTER_SIZE_MAX = 8192U;
+	//!	@brief	頂点座標の小数部のビット数
+	static unsigned int constexpr RASTER_SUBPIXEL_BITS = 4U;
+	//!	@brief	クリッピングで一つの三角形から分かれる三角形の数の上限
+	static unsigned int constexpr RASTER_SPLIT_MAX = 8U;
+
+	/**	@enum	RasterMode
+	 *	@brief	ラスタライザの描画先
+	 */
+	enum class RasterMode : unsigned char {
+		//!	@brief	色と深度
+		Color,
+		//!	@brief	深度のみ (遮蔽判定用)
+		DepthOnly,
+	};
+
+	/**	@enum	RasterCull
+	 *	@brief	ラスタライザのカリング
+	 */
+	enum class RasterCull : unsigned char {
+		//!	@brief	カリングしない
+		None,
+		//!	@brief	裏面 (画面上で反時計回り) を捨てる
+		Back,
+		//!	@brief	表面 (画面上で時計回り) を捨てる
+		Front,
+	};
+
+	/**	@struct	RasterFragment
+	 *	@brief	シェーディングに渡すピクセルの情報
+	 */
+	struct RasterFragment final {
+		//!	@brief	ピクセルの横位置
+		unsigned int x;
+		//!	@brief	ピクセルの縦位置
+		unsigned int y;
+		//!	@brief	深度
+		float depth;
+		//!	@brief	頂点 1 の重み (透視補正済み、頂点 0 の重みは 1 - b1 - b2)
+		float b1;
+		//!	@brief	頂点 2 の重み (透視補正済み)
+		float b2;
+		//!	@brief	描画呼び出し内での三角形の番号
+		unsigned int primitive;
+	};
+
+	//!	@brief	シェーディング関数型 (RGBA8 の色を返します)
+	using RasterShadeFunc = unsigned int (*)(void const* context, RasterFragment const& fragment) noexcept;
+
+	/**	@struct	RasterShader
+	 *	@brief	シェーディング関数と文脈の組
+	 */
+	struct RasterShader final {
+		//!	@brief	シェーディング関数
+		RasterShadeFunc func;
+		//!	@brief	関数に渡す文脈
+		void const* context;
+	};
+
+	/**	@brief	関数オブジェクトからのシェーディング関数の作成関数
+	 *	@param[in] func unsigned int (RasterFragment const&) で呼べる関数オブジェクト (flush が終わるまで生かしておくこと)
+	 */
+	template <typename F>
+	RasterShader const make_raster_shader(F const& func) noexcept;
+
+	/**	@struct	RasterStats
+	 *	@brief	ラスタライザの集計
+	 */
+	struct RasterStats final {
+		//!	@brief	受け取った三角形の数
+		unsigned long long triangles;
+		//!	@brief	カリングや画面外で捨てた三角形の数
+		unsigned long long culled;
+		//!	@brief	クリッピングで分割した三角形の数
+		unsigned long long clipped;
+		//!	@brief	三角形とタイルの組の数
+		unsigned long long tiles;
+		//!	@brief	タイルの最大深度で丸ごと捨てた組の数
+		unsigned long long hiz;
+		//!	@brief	三角形がタイルを覆い切っていた組の数
+		unsigned long long full;
+		//!	@brief	深度テストを通ったピクセルの数
+		unsigned long long fragments;
+	};
+
+	/**	@class	SoftRasterizer
+	 *	@brief	CPU で動くラスタライザ
+	 *	@details	draw で頂点を変換してクリッピングし、三角形を 64x64 のビンに振り分けて積みます。
+	 *				flush でビンごとにスレッドへ配り、8x8 のタイル単位で辺関数を SIMD で評価して深度 (LESS) を書きます。
+	 *				タイルごとに最大深度を持ち、三角形の最小深度がそれより奥ならタイルを丸ごと飛ばします。
+	 *				ビンの中は積んだ順に処理するため、結果はスレッド数によらず同じになります。
+	 *				深度のみのモードを低い解像度で使い、遮蔽物を描いてから testBox で遮蔽判定をしてください。
+	 *				色は RGBA8 (下位バイトが R) で、writeTGA でファイルへ書き出せます。スレッドセーフではありません。
+	 */
+	class SoftRasterizer final :
+		public INonmovable<SoftRasterizer>
+	{
+	public	:
+		//!	@brief	デフォルトコンストラクタ
+		SoftRasterizer() noexcept;
+		//!	@brief	デストラクタ
+		~SoftRasterizer() noexcept;
+
+		/**	@brief	初期化関数
+		 *	@param[in] width 横幅 (RASTER_SIZE_MAX 以下)
+		 *	@param[in] height 縦幅 (RASTER_SIZE_MAX 以下)
+		 *	@param[in] mode 描画先
+		 */
+		bool const init(unsigned int const& width, unsigned int const& height, RasterMode const& mode = RasterMode::Color) noexcept;
+		//!	@brief	終了関数
+		void exit() noexcept;
+
+		/**	@brief	消去関数 (発行待ちの三角形は捨てます)
+		 *	@param[in] depth 深度
+		 *	@param[in] color 色 (RGBA8)
+		 */
+		void clear(float const& depth = 1.0f, unsigned int const& color = 0xFF000000U) noexcept;
+
+		/**	@brief	描画関数 (flush まで発行待ちに積みます)
+		 *	@param[in] positions 頂点座標の配列
+		 *	@param[in] vertexCount 頂点数
+		 *	@param[in] indices インデックスの配列 (nullptr なら頂点を順に三つずつ使います)
+		 *	@param[in] indexCount インデックス数
+		 *	@param[in] transform 頂点座標からクリップ空間への変換行列 (行ベクトルに右から掛けます)
+		 *	@param[in] cull カリング
+		 *	@param[in] shader シェーディング関数 (nullptr なら深度のみを書きます)
+		 */
+		bool const draw(FVector4 const* positions, size_t const& vertexCount, unsigned int const* indices, size_t const& indexCount,
+			FMatrix4x4 const& transform, RasterCull const& cull = RasterCull::Back, RasterShader const* shader = nullptr) noexcept;
+		//!	@brief	関数オブジェクトでシェーディングする描画関数 (func は flush が終わるまで生かしておくこと)
+		template <typename F>
+		bool const drawShaded(FVector4 const* positions, size_t const& vertexCount, unsigned int const* indices, size_t const& indexCount,
+			FMatrix4x4 const& transform, RasterCull const& cull, F const& func) noexcept;
+		//!	@brief	発行待ちの三角形のラスタライズ関数
+		void flush() noexcept;
+
+		/**	@brief	矩形の可視判定関数 (flush 後に呼ぶこと)
+		 *	@param[in] minX 左端 (ピクセル)
+		 *	@param[in] minY 上端 (ピクセル)
+		 *	@param[in] maxX 右端 (ピクセル)
+		 *	@param[in] maxY 下端 (ピクセル)
+		 *	@param[in] depth 矩形の最も手前の深度
+		 *	@retval true 見えている可能性がある
+		 *	@retval false 確実に遮蔽されている
+		 */
+		bool const testRect(float const& minX, float const& minY, float const& maxX, float const& maxY, float const& depth) const noexcept;
+		/**	@brief	境界箱の可視判定関数 (flush 後に呼ぶこと)
+		 *	@param[in] min 境界箱の最小点
+		 *	@param[in] max 境界箱の最大点
+		 *	@param[in] transform 境界箱の座標からクリップ空間への変換行列
+		 *	@retval true 見えている可能性がある (近平面をまたぐものを含みます)
+		 *	@retval false 確実に遮蔽されているか画面外
+		 */
+		bool const testBox(FVector4 const& min, FVector4 const& max, FMatrix4x4 const& transform) const noexcept;
+
+		//!	@brief	深度の取得関数
+		float const depth(unsigned int const& x, unsigned int const& y) const noexcept;
+		//!	@brief	色の配列 (横幅ごとに行が並びます、深度のみのモードでは nullptr)
+		unsigned int const* const color() const noexcept;
+		//!	@brief	横幅
+		unsigned int const width() const noexcept;
+		//!	@brief	縦幅
+		unsigned int const height() const noexcept;
+		//!	@brief	描画先
+		RasterMode const mode() const noexcept;
+
+		/**	@brief	色の書き出し関数 (32 ビット TGA)
+		 *	@param[in] path ファイルパス
+		 */
+		bool const writeTGA(char const* const path) const noexcept;
+
+		//!	@brief	集計の取得関数
+		RasterStats const stats() const noexcept;
+		//!	@brief	集計の消去関数
+		void resetStats() noexcept;
+
+	private	:
+		/**	@struct	Triangle
+		 *	@brief	セットアップ済みの三角形
+		 */
+		struct Triangle final {
+			//!	@brief	辺関数の x 係数 (1 ピクセルあたり)
+			int a[3];
+			//!	@brief	辺関数の y 係数 (1 ピクセルあたり)
+			int b[3];
+			//!	@brief	辺関数のピクセル (0, 0) での値
+			long long c[3];
+			//!	@brief	ピクセル単位の境界 (左、上、右、下、いずれも含む)
+			int bounds[4];
+			//!	@brief	深度、1/w、b1/w、b2/w の平面 (x 係数、y 係数、ピクセル (0, 0) での値)
+			float planes[4][3];
+			//!	@brief	最小深度
+			float zmin;
+			//!	@brief	描画呼び出し内での三角形の番号
+			unsigned int primitive;
+			//!	@brief	シェーディング関数の番号 (~0U は無し)
+			unsigned int shader;
+		};
+		/**	@struct	BinStats
+		 *	@brief	ビンごとの集計
+		 */
+		struct BinStats final {
+			//!	@brief	三角形とタイルの組の数
+			unsigned long long tiles;
+			//!	@brief	最大深度で捨てた組の数
+			unsigned long long hiz;
+			//!	@brief	覆い切っていた組の数
+			unsigned long long full;
+			//!	@brief	深度テストを通ったピクセルの数
+			unsigned long long fragments;
+		};
+
+		/**	@brief	三角形のセットアップ関数
+		 *	@param[in] clip クリップ空間の頂点
+		 *	@param[in] primitive 描画呼び出し内での三角形の番号
+		 *	@param[in] shader シェーディング関数の番号
+		 *	@param[in] cull カリング
+		 *	@param[out] out 出力先 (RASTER_SPLIT_MAX 個分)
+		 *	@param[out] clipped クリッピングしたかどうか
+		 *	@return 出力した三角形の数 (捨てた場合は 0)
+		 */
+		unsigned int const setup(FVector4 const (&clip)[3], unsigned int const& primitive, unsigned int const& shader, RasterCull const& cull,
+			Triangle* out, bool& clipped) const noexcept;
+		//!	@brief	ビンのラスタライズ関数
+		void rasterize(size_t const& bin) noexcept;
+
+		//!	@brief	横幅
+		unsigned int m_width;
+		//!	@brief	縦幅
+		unsigned int m_height;
+		//!	@brief	横のタイル数
+		unsigned int m_tilesX;
+		//!	@brief	縦のタイル数
+		unsigned int m_tilesY;
+		//!	@brief	横のビン数
+		unsigned int m_binsX;
+		//!	@brief	縦のビン数
+		unsigned int m_binsY;
+		//!	@brief	描画先
+		RasterMode m_mode;
+		//!	@brief	深度 (タイルごとに 64 ピクセルが並びます)
+		std::vector<float> m_depth;
+		//!	@brief	タイルごとの最大深度
+		std::vector<float> m_hiz;
+		//!	@brief	色
+		std::vector<unsigned int> m_color;
+		//!	@brief	変換済みの頂点
+		std::vector<FVector4> m_clip;
+		//!	@brief	発行待ちの三角形
+		std::vector<Triangle> m_triangles;
+		//!	@brief	ビンごとの三角形の番号
+		std::vector<std::vector<unsigned int>> m_bins;
+		//!	@brief	ビンごとの集計
+		std::vector<BinStats> m_binStats;
+		//!	@brief	発行待ちの三角形が使うシェーディング関数
+		std::vector<RasterShader> m_shaders;
+		//!	@brief	集計
+		RasterStats m_stats;
+	};
+}
+
+#include "dlph_soft_raster.inl"
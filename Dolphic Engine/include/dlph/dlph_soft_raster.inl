@@ -0,0 +1,25 @@
+﻿/**	@file	dlph_soft_raster.inl
+ *	@brief	CPU で動くラスタライザ
+ */
+#pragma once
+#include "dlph_soft_raster.hpp"
+
+namespace dlph {
+	template<typename F>
+	inline RasterShader const make_raster_shader(F const& func) noexcept {
+		RasterShader shader = {};
+		shader.func = [](void const* context, RasterFragment const& fragment) noexcept -> unsigned int {
+			return (*static_cast<F const*>(context))(fragment);
+		};
+		shader.context = &func;
+		return shader;
+	}
+
+	template<typename F>
+	inline bool const SoftRasterizer::drawShaded(FVector4 const* positions, size_t const& vertexCount, unsigned int const* indices, size_t const& indexCount,
+		FMatrix4x4 const& transform, RasterCull const& cull, F const& func) noexcept
+	{
+		RasterShader const shader = make_raster_shader(func);
+		return draw(positions, vertexCount, indices, indexCount, transform, cull, &shader);
+	}
+}
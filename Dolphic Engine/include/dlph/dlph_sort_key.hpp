@@ -0,0 +1,100 @@
+﻿/**	@file	dlph_sort_key.hpp
+ *	@brief	描画の並べ替えキー
+ */
+#pragma once
+
+namespace dlph {
+	//!	@brief	並べ替えキーのレイヤーのビット数
+	static unsigned int constexpr SORT_KEY_LAYER_BITS = 4U;
+	//!	@brief	並べ替えキーのパスのビット数
+	static unsigned int constexpr SORT_KEY_PASS_BITS = 8U;
+	//!	@brief	並べ替えキーのパイプラインのビット数
+	static unsigned int constexpr SORT_KEY_PIPELINE_BITS = 16U;
+	//!	@brief	並べ替えキーのマテリアルのビット数
+	static unsigned int constexpr SORT_KEY_MATERIAL_BITS = 16U;
+	//!	@brief	並べ替えキーの深度のビット数
+	static unsigned int constexpr SORT_KEY_DEPTH_BITS = 20U;
+
+	/**	@struct	SortKey
+	 *	@brief	描画の並べ替えキー
+	 *	@details	上位からレイヤー、パス、パイプライン、マテリアル、深度の順に詰めた 64 ビットの値です。
+	 *				キーの小さい順に並べると、同じパイプラインとマテリアルの描画が隣り合い、状態の切り替えが減ります。
+	 *				各値は桁数を超えた分を切り捨てます。パイプラインにはハンドルのスロット番号を渡してください。
+	 */
+	struct SortKey final {
+		//!	@brief	深度の桁のシフト量
+		static unsigned int constexpr DEPTH_SHIFT = 0U;
+		//!	@brief	マテリアルの桁のシフト量
+		static unsigned int constexpr MATERIAL_SHIFT = DEPTH_SHIFT + SORT_KEY_DEPTH_BITS;
+		//!	@brief	パイプラインの桁のシフト量
+		static unsigned int constexpr PIPELINE_SHIFT = MATERIAL_SHIFT + SORT_KEY_MATERIAL_BITS;
+		//!	@brief	パスの桁のシフト量
+		static unsigned int constexpr PASS_SHIFT = PIPELINE_SHIFT + SORT_KEY_PIPELINE_BITS;
+		//!	@brief	レイヤーの桁のシフト量
+		static unsigned int constexpr LAYER_SHIFT = PASS_SHIFT + SORT_KEY_PASS_BITS;
+		static_assert(LAYER_SHIFT + SORT_KEY_LAYER_BITS == 64U, "Sort key fields must fill 64 bits.");
+
+		//!	@brief	値
+		unsigned long long value;
+
+		//!	@brief	生成関数
+		static SortKey constexpr make(unsigned int const& layer, unsigned int const& pass, unsigned int const& pipeline, unsigned int const& material, unsigned int const& depth) noexcept {
+			return { field(layer, LAYER_SHIFT, SORT_KEY_LAYER_BITS)
+				| field(pass, PASS_SHIFT, SORT_KEY_PASS_BITS)
+				| field(pipeline, PIPELINE_SHIFT, SORT_KEY_PIPELINE_BITS)
+				| field(material, MATERIAL_SHIFT, SORT_KEY_MATERIAL_BITS)
+				| field(depth, DEPTH_SHIFT, SORT_KEY_DEPTH_BITS) };
+		}
+		/**	@brief	深度の量子化関数
+		 *	@param[in] depth 正規化した深度 (0 ～ 1 の外は切り詰めます)
+		 *	@param[in] backToFront 奥から手前の順にするかどうか (半透明用)
+		 */
+		static unsigned int constexpr quantize(float const& depth, bool const& backToFront = false) noexcept {
+			float const clamped = depth < 0.0f ? 0.0f : (depth > 1.0f ? 1.0f : depth);
+			unsigned int const bits = static_cast<unsigned int>(clamped * static_cast<float>(DEPTH_MAX));
+			return backToFront ? DEPTH_MAX - bits : bits;
+		}
+
+		//!	@brief	レイヤー取得関数
+		unsigned int constexpr layer() const noexcept {
+			return extract(LAYER_SHIFT, SORT_KEY_LAYER_BITS);
+		}
+		//!	@brief	パス取得関数
+		unsigned int constexpr pass() const noexcept {
+			return extract(PASS_SHIFT, SORT_KEY_PASS_BITS);
+		}
+		//!	@brief	パイプライン取得関数
+		unsigned int constexpr pipeline() const noexcept {
+			return extract(PIPELINE_SHIFT, SORT_KEY_PIPELINE_BITS);
+		}
+		//!	@brief	マテリアル取得関数
+		unsigned int constexpr material() const noexcept {
+			return extract(MATERIAL_SHIFT, SORT_KEY_MATERIAL_BITS);
+		}
+		//!	@brief	深度取得関数
+		unsigned int constexpr depth() const noexcept {
+			return extract(DEPTH_SHIFT, SORT_KEY_DEPTH_BITS);
+		}
+		//!	@brief	比較演算子
+		bool constexpr operator<(SortKey const& rhs) const noexcept {
+			return value < rhs.value;
+		}
+		//!	@brief	等価演算子
+		bool constexpr operator==(SortKey const& rhs) const noexcept {
+			return value == rhs.value;
+		}
+
+	private	:
+		//!	@brief	深度の最大値
+		static unsigned int constexpr DEPTH_MAX = (1U << SORT_KEY_DEPTH_BITS) - 1U;
+
+		//!	@brief	桁の生成関数
+		static unsigned long long constexpr field(unsigned int const& arg, unsigned int const& shift, unsigned int const& bits) noexcept {
+			return (static_cast<unsigned long long>(arg) & ((1ULL << bits) - 1ULL)) << shift;
+		}
+		//!	@brief	桁の取り出し関数
+		unsigned int constexpr extract(unsigned int const& shift, unsigned int const& bits) const noexcept {
+			return static_cast<unsigned int>((value >> shift) & ((1ULL << bits) - 1ULL));
+		}
+	};
+}
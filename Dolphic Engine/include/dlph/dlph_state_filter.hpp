@@ -0,0 +1,107 @@
+﻿/**	@file	dlph_state_filter.hpp
+ *	@brief	重複した状態設定を取り除く描画バックエンド
+ */
+#pragma once
+#include "dlph_cmd_stream.hpp"
+
+namespace dlph {
+	//!	@brief	状態を追う頂点バッファのスロット数
+	static unsigned int constexpr STATE_FILTER_VERTEX_SLOT_CNT = 32U;
+	//!	@brief	状態を追うルートパラメータの数
+	static unsigned int constexpr STATE_FILTER_ROOT_CNT = 64U;
+
+	/**	@struct	StateFilterStats
+	 *	@brief	重複した状態設定の集計
+	 */
+	struct StateFilterStats final {
+		//!	@brief	種類ごとの受け取ったコマンド数
+		unsigned long long received[static_cast<unsigned int>(RenderCommandType::Count)];
+		//!	@brief	種類ごとの取り除いたコマンド数
+		unsigned long long eliminated[static_cast<unsigned int>(RenderCommandType::Count)];
+	};
+
+	/**	@class	RenderStateFilter
+	 *	@brief	重複した状態設定を取り除く描画バックエンド
+	 *	@details	別のバックエンドの手前に挟み、直前と同じパイプライン、頂点バッファ、インデックスバッファ、
+	 *				定数、リソースの設定を転送せずに捨てます。並べ替え後のコマンド列では描画ごとに状態を積み直すため、
+	 *				隣り合う描画の間で変わらない設定がここで消えます。
+	 *				パイプラインが変わるとルートシグネチャも変わり得るため、ルートパラメータの記録は捨てます。
+	 *				記録先のコマンドリストごとに作るか、リストの先頭で reset を呼んでください。
+	 */
+	class RenderStateFilter final : public IRenderBackend {
+	public	:
+		/**	@brief	コンストラクタ
+		 *	@param[in] target 転送先のバックエンド
+		 */
+		explicit RenderStateFilter(IRenderBackend& target) noexcept;
+		//!	@brief	デストラクタ
+		~RenderStateFilter() noexcept = default;
+
+		//!	@brief	集計と追っている状態の初期化関数
+		void reset() noexcept;
+		//!	@brief	追っている状態の破棄関数 (集計は残します)
+		void invalidate() noexcept;
+		//!	@brief	集計取得関数
+		StateFilterStats const& stats() const noexcept;
+		//!	@brief	取り除いたコマンド数の合計
+		unsigned long long const eliminated() const noexcept;
+
+		//!	@brief	描画
+		void draw(DrawCommand const& cmd) noexcept override;
+		//!	@brief	インデックス付き描画
+		void drawIndexed(DrawIndexedCommand const& cmd) noexcept override;
+		//!	@brief	コンピュートシェーダの実行
+		void dispatch(DispatchCommand const& cmd) noexcept override;
+		//!	@brief	パイプラインの設定
+		void setPipeline(SetPipelineCommand const& cmd) noexcept override;
+		//!	@brief	頂点バッファの設定
+		void bindVertexBuffer(BindVertexBufferCommand const& cmd) noexcept override;
+		//!	@brief	インデックスバッファの設定
+		void bindIndexBuffer(BindIndexBufferCommand const& cmd) noexcept override;
+		//!	@brief	定数の設定
+		void bindConstants(BindConstantsCommand const& cmd) noexcept override;
+		//!	@brief	リソースの設定
+		void bindResource(BindResourceCommand const& cmd) noexcept override;
+		//!	@brief	リソースの状態遷移
+		void barrier(BarrierCommand const& cmd) noexcept override;
+		//!	@brief	バッファのコピー
+		void copy(CopyCommand const& cmd) noexcept override;
+
+	private	:
+		/**	@struct	RootBinding
+		 *	@brief	ルートパラメータに設定した値
+		 */
+		struct RootBinding final {
+			//!	@brief	設定したコマンドの種類 (Count は未設定)
+			RenderCommandType type;
+			//!	@brief	定数の GPU アドレスかリソースのハンドルの値
+			unsigned long long value;
+		};
+
+		//!	@brief	受け取りの計上関数
+		void receive(RenderCommandType const& type) noexcept;
+		//!	@brief	取り除きの計上関数
+		void eliminate(RenderCommandType const& type) noexcept;
+		//!	@brief	ルートパラメータの更新関数 (同じ値なら false)
+		bool const bindRoot(unsigned int const& root, RenderCommandType const& type, unsigned long long const& value) noexcept;
+
+		//!	@brief	転送先のバックエンド
+		IRenderBackend& m_target;
+		//!	@brief	集計
+		StateFilterStats m_stats;
+		//!	@brief	設定中のパイプライン
+		RenderPipeline m_pipeline;
+		//!	@brief	パイプラインを設定済みかどうか
+		bool m_hasPipeline;
+		//!	@brief	設定中の頂点バッファ
+		BindVertexBufferCommand m_vertices[STATE_FILTER_VERTEX_SLOT_CNT];
+		//!	@brief	頂点バッファを設定済みのスロット
+		unsigned int m_vertexMask;
+		//!	@brief	設定中のインデックスバッファ
+		BindIndexBufferCommand m_indices;
+		//!	@brief	インデックスバッファを設定済みかどうか
+		bool m_hasIndices;
+		//!	@brief	設定中のルートパラメータ
+		RootBinding m_roots[STATE_FILTER_ROOT_CNT];
+	};
+}
@@ -0,0 +1,155 @@
+﻿/**	@file	dlph_state_tracker.hpp
+ *	@brief	リソースの状態追跡器
+ */
+#pragma once
+#include "dlph_cmd_stream.hpp"
+#include <unordered_map>
+#include <vector>
+
+namespace dlph {
+	/**	@struct	StateTransition
+	 *	@brief	発行を待つバリア
+	 */
+	struct StateTransition final {
+		//!	@brief	リソースの識別子
+		unsigned long long resource;
+		//!	@brief	サブリソース番号 (SUBRESOURCE_ALL は全て)
+		unsigned int subresource;
+		//!	@brief	遷移前の状態
+		ResourceState before;
+		//!	@brief	遷移後の状態
+		ResourceState after;
+		//!	@brief	バリアの種類
+		BarrierKind kind;
+	};
+
+	/**	@struct	StateTrackerStats
+	 *	@brief	リソースの状態追跡器の集計
+	 */
+	struct StateTrackerStats final {
+		//!	@brief	要求された遷移の数
+		unsigned long long requested;
+		//!	@brief	状態が変わらないため捨てた遷移の数
+		unsigned long long skipped;
+		//!	@brief	発行待ちの遷移に統合した数
+		unsigned long long merged;
+		//!	@brief	統合で遷移前と遷移後が同じになり消えたバリアの数
+		unsigned long long cancelled;
+		//!	@brief	発行したバリアの数
+		unsigned long long emitted;
+		//!	@brief	発行の回数 (発行待ちが空の時は数えません)
+		unsigned long long flushes;
+	};
+
+	/**	@class	ResourceStateTracker
+	 *	@brief	リソースの状態追跡器
+	 *	@details	リソースとサブリソースごとに現在の状態を持ち、遷移の要求を発行待ちのバリアに積みます。
+	 *				状態の変わらない遷移は捨て、発行待ちの中の同じサブリソースへの直前の遷移とは一つにまとめます
+	 *				(A→B と B→C は A→C に、A→B と B→A は消えます)。
+	 *				発行待ちは描画、コンピュートシェーダの実行、コピーの直前に flush でまとめて取り出してください。
+	 *				リソースの識別子はバックエンドが決めます (Direct3D12 ではリソースのアドレス)。スレッドセーフではありません。
+	 */
+	class ResourceStateTracker final {
+	public	:
+		//!	@brief	デフォルトコンストラクタ
+		ResourceStateTracker() noexcept;
+		//!	@brief	デストラクタ
+		~ResourceStateTracker() noexcept = default;
+
+		/**	@brief	リソース登録関数 (登録済みなら状態を上書きします)
+		 *	@param[in] resource リソースの識別子
+		 *	@param[in] state 現在の状態
+		 *	@param[in] subresources サブリソース数
+		 */
+		void track(unsigned long long const& resource, ResourceState const& state, unsigned int const& subresources = 1U) noexcept;
+		//!	@brief	リソース登録解除関数 (発行待ちのバリアは残します)
+		void untrack(unsigned long long const& resource) noexcept;
+		//!	@brief	登録済みかどうか
+		bool const tracked(unsigned long long const& resource) const noexcept;
+		//!	@brief	状態取得関数 (サブリソースごとに状態が異なる時に SUBRESOURCE_ALL を渡すと先頭の状態)
+		ResourceState const state(unsigned long long const& resource, unsigned int const& subresource = SUBRESOURCE_ALL) const noexcept;
+		//!	@brief	全削除関数
+		void clear() noexcept;
+
+		/**	@brief	状態遷移の要求関数
+		 *	@param[in] resource リソースの識別子 (登録済みであること)
+		 *	@param[in] after 遷移後の状態
+		 *	@param[in] subresource サブリソース番号
+		 *	@retval true 受け付けました (状態が変わらず捨てた場合を含みます)。
+		 *	@retval false 登録されていないリソースかサブリソース番号です。
+		 */
+		bool const transition(unsigned long long const& resource, ResourceState const& after, unsigned int const& subresource = SUBRESOURCE_ALL) noexcept;
+		//!	@brief	順序無しアクセスのバリアの要求関数 (直前の発行待ちが同じなら捨てます)
+		void uav(unsigned long long const& resource) noexcept;
+		/**	@brief	まとめずに積むバリアの要求関数 (分割した遷移とメモリ共有)
+		 *	@details	分割した遷移の終了とメモリ共有では状態を更新します。後の遷移はこのバリアを越えてまとめません。
+		 */
+		void barrier(StateTransition const& barrier) noexcept;
+
+		//!	@brief	発行待ちがあるかどうか
+		bool const pending() const noexcept;
+		/**	@brief	発行待ちの取り出し関数
+		 *	@param[in] func 要求順に発行待ちのバリアを受け取る関数 (StateTransition const&)
+		 */
+		template <typename F>
+		void flush(F const& func) noexcept;
+
+		//!	@brief	集計取得関数
+		StateTrackerStats const& stats() const noexcept;
+		//!	@brief	集計の初期化関数
+		void resetStats() noexcept;
+
+	private	:
+		/**	@struct	Entry
+		 *	@brief	リソースの状態
+		 */
+		struct Entry final {
+			//!	@brief	全体の状態 (サブリソースごとに持っていない時)
+			ResourceState whole;
+			//!	@brief	サブリソース数
+			unsigned int count;
+			//!	@brief	サブリソースごとの状態 (空なら全て whole)
+			std::vector<ResourceState> subs;
+			//!	@brief	このリソースへの最後の発行待ちの位置
+			size_t last;
+			//!	@brief	last が有効な発行の世代
+			unsigned long long epoch;
+		};
+
+		/**	@struct	Pending
+		 *	@brief	発行待ちのバリアと同じリソースへの一つ前の発行待ち
+		 */
+		struct Pending final {
+			//!	@brief	バリア
+			StateTransition barrier;
+			//!	@brief	同じリソースへの一つ前の発行待ちの位置 (PENDING_NONE は無し)
+			size_t link;
+			//!	@brief	統合で消えていないかどうか
+			bool live;
+		};
+
+		//!	@brief	発行待ちが無いことを表す位置
+		static size_t constexpr PENDING_NONE = ~static_cast<size_t>(0U);
+
+		//!	@brief	リソースへの最後の発行待ちの位置
+		size_t const lastPending(unsigned long long const& resource) const noexcept;
+		//!	@brief	発行待ちの追加関数
+		void append(StateTransition const& barrier) noexcept;
+
+		//!	@brief	遷移の積み込み関数 (発行待ちとまとめます)
+		void push(unsigned long long const& resource, unsigned int const& subresource, ResourceState const& before, ResourceState const& after) noexcept;
+
+		//!	@brief	リソースの状態
+		std::unordered_map<unsigned long long, Entry> m_entries;
+		//!	@brief	発行待ちのバリア
+		std::vector<Pending> m_pending;
+		//!	@brief	統合で消えずに残っている発行待ちの数
+		size_t m_live;
+		//!	@brief	発行の世代
+		unsigned long long m_epoch;
+		//!	@brief	集計
+		StateTrackerStats m_stats;
+	};
+}
+
+#include "dlph_state_tracker.inl"
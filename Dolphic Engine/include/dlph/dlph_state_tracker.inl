@@ -0,0 +1,26 @@
+﻿/**	@file	dlph_state_tracker.inl
+ *	@brief	リソースの状態追跡器
+ */
+#pragma once
+#include "dlph_state_tracker.hpp"
+
+namespace dlph {
+	template<typename F>
+	inline void ResourceStateTracker::flush(F const& func) noexcept {
+		if (m_live == 0U) {
+			m_pending.clear();
+			return;
+		}
+		for (Pending const& pending : m_pending) {
+			if (pending.live) {
+				func(pending.barrier);
+			}
+		}
+		m_stats.emitted += m_live;
+		++m_stats.flushes;
+		m_pending.clear();
+		m_live = 0U;
+		//	世代を進め、各リソースの last をまとめて無効にする
+		++m_epoch;
+	}
+}
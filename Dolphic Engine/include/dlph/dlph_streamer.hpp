@@ -0,0 +1,322 @@
+﻿/**	@file	dlph_streamer.hpp
+ *	@brief	リソースの非同期転送
+ */
+#pragma once
+#include "ifs/nonmovable.hpp"
+#include "cont/slot_map.hpp"
+#include "mem/staging_ring.hpp"
+#include "dlph_cmd_stream.hpp"
+#include <mutex>
+#include <vector>
+
+namespace dlph {
+	//!	@brief	一度に転送する大きさの上限 (大きなリソースはこれ単位で複数回に分けます)
+	static unsigned long long constexpr STREAM_CHUNK_SIZE = 4ULL * 1024ULL * 1024ULL;
+	//!	@brief	一度の update で転送する大きさの既定値
+	static unsigned long long constexpr STREAM_BUDGET_DEFAULT = 16ULL * 1024ULL * 1024ULL;
+
+	/**	@enum	StreamTarget
+	 *	@brief	転送先の種類
+	 */
+	enum class StreamTarget : unsigned char {
+		//!	@brief	バッファ (バイト単位で分けます)
+		Buffer = 0U,
+		//!	@brief	テクスチャのサブリソース (行単位で分けます)
+		Texture,
+	};
+
+	/**	@enum	StreamStatus
+	 *	@brief	転送要求の状態
+	 */
+	enum class StreamStatus : unsigned char {
+		//!	@brief	無効な要求 (完了を通知した後を含みます)
+		Invalid = 0U,
+		//!	@brief	待機中
+		Queued,
+		//!	@brief	転送中
+		Transferring,
+		//!	@brief	転送完了
+		Completed,
+		//!	@brief	取り消し (転送中だったものは一部だけ書き込まれています)
+		Canceled,
+		//!	@brief	読み込みか転送の失敗
+		Failed,
+	};
+
+	/**	@brief	読み込み関数型
+	 *	@param[in] context 要求に渡した文脈
+	 *	@param[out] dst 書き込み先
+	 *	@param[in] offset 元データ内の位置 (テクスチャは行を詰めたときの位置)
+	 *	@param[in] size 大きさ
+	 *	@retval true 読み込みました。
+	 *	@retval false 読み込めませんでした (要求は失敗になります)。
+	 */
+	using StreamReadFunc = bool (*)(void* context, void* dst, unsigned long long const& offset, unsigned long long const& size) noexcept;
+
+	/**	@struct	StreamRequest
+	 *	@brief	転送要求
+	 */
+	struct StreamRequest final {
+		//!	@brief	転送先 (値の解釈は転送器が行います)
+		RenderResource target;
+		//!	@brief	転送先の種類
+		StreamTarget type;
+		//!	@brief	優先度 (大きいほど先に転送します)
+		unsigned int priority;
+		//!	@brief	バッファ内の位置 (バッファのみ)
+		unsigned long long offset;
+		//!	@brief	大きさ (バッファのみ)
+		unsigned long long size;
+		//!	@brief	サブリソースの番号 (テクスチャのみ)
+		unsigned int subresource;
+		//!	@brief	一行のバイト数 (テクスチャのみ、圧縮形式はブロック一行分)
+		unsigned int rowSize;
+		//!	@brief	行数 (テクスチャのみ)
+		unsigned int rowCount;
+		//!	@brief	読み込み関数 (update を呼んだスレッドで呼ばれます)
+		StreamReadFunc read;
+		//!	@brief	読み込み関数と完了通知に渡す文脈
+		void* context;
+	};
+
+	//!	@brief	転送要求のハンドル
+	using StreamTicket = Handle32<StreamRequest>;
+
+	/**	@struct	StreamCopy
+	 *	@brief	転送器へ渡すコピー一回分
+	 */
+	struct StreamCopy final {
+		//!	@brief	転送先
+		RenderResource target;
+		//!	@brief	転送先の種類
+		StreamTarget type;
+		//!	@brief	一時領域内の位置
+		unsigned long long staging;
+		//!	@brief	一時領域内の大きさ
+		unsigned long long size;
+		//!	@brief	バッファ内の位置 (バッファ)、最初の行 (テクスチャ)
+		unsigned long long offset;
+		//!	@brief	サブリソースの番号 (テクスチャのみ)
+		unsigned int subresource;
+		//!	@brief	一行のバイト数 (テクスチャのみ)
+		unsigned int rowSize;
+		//!	@brief	一時領域での行の間隔 (テクスチャのみ)
+		unsigned int rowPitch;
+		//!	@brief	行数 (テクスチャのみ)
+		unsigned int rows;
+	};
+
+	/**	@struct	StreamCompletion
+	 *	@brief	転送要求の完了通知
+	 */
+	struct StreamCompletion final {
+		//!	@brief	要求のハンドル (通知した時点で無効になります)
+		StreamTicket ticket;
+		//!	@brief	結果 (Completed / Canceled / Failed)
+		StreamStatus status;
+		//!	@brief	要求に渡した文脈
+		void* context;
+	};
+
+	/**	@struct	StreamStats
+	 *	@brief	非同期転送の集計
+	 */
+	struct StreamStats final {
+		//!	@brief	受け付けた要求の数
+		unsigned long long requests;
+		//!	@brief	完了した要求の数
+		unsigned long long completed;
+		//!	@brief	取り消した要求の数
+		unsigned long long canceled;
+		//!	@brief	失敗した要求の数
+		unsigned long long failed;
+		//!	@brief	転送器へ渡したコピーの数
+		unsigned long long copies;
+		//!	@brief	転送器へ渡したバイト数 (行の間隔を含みます)
+		unsigned long long bytes;
+		//!	@brief	提出の回数
+		unsigned long long submits;
+		//!	@brief	一時領域が足りず転送を次回へ回した回数
+		unsigned long long stalls;
+	};
+
+	/**	@class	ITransferEngine
+	 *	@brief	非同期転送の転送器
+	 *	@details	CPU から書き込める一時領域を持ち、そこから転送先へのコピーを積んで、提出ごとに増えるフェンス値で完了を知らせます。
+	 *				Direct3D12 のコピーキューを使うものと、GPU を使わずに別スレッドでコピーするものがあります。
+	 */
+	class ITransferEngine {
+	public	:
+		//!	@brief	デストラクタ
+		virtual ~ITransferEngine() noexcept = default;
+
+		//!	@brief	一時領域の先頭 (CPU から書き込みます)
+		virtual unsigned char* const staging() noexcept = 0;
+		//!	@brief	一時領域の大きさ
+		virtual unsigned long long const stagingSize() const noexcept = 0;
+		//!	@brief	コピー元の位置の境界
+		virtual unsigned long long const placementAlignment() const noexcept = 0;
+		//!	@brief	テクスチャの行の間隔の境界
+		virtual unsigned long long const pitchAlignment() const noexcept = 0;
+
+		//!	@brief	コピーを積む関数
+		virtual bool const copy(StreamCopy const& copy) noexcept = 0;
+		//!	@brief	積んだコピーの提出関数 (完了時に到達するフェンス値を返します、失敗したら 0)
+		virtual unsigned long long const submit() noexcept = 0;
+		//!	@brief	到達したフェンス値 (待ちません)
+		virtual unsigned long long const completed() noexcept = 0;
+		//!	@brief	フェンス値への到達を CPU で待つ関数
+		virtual void wait(unsigned long long const& value) noexcept = 0;
+	};
+
+	/**	@class	ResourceStreamer
+	 *	@brief	リソースの非同期転送
+	 *	@details	転送要求を優先度の順に取り出し、STREAM_CHUNK_SIZE ずつ読み込み関数で一時領域へ書いて転送器へ積みます。
+	 *				一時領域は StagingRing で切り出し、転送器のフェンス値が到達したところから再利用します。
+	 *				大きな要求の途中でも、より優先度の高い要求が来れば次の切れ目で追い越させます。
+	 *				update は一つのスレッド (読み込み用のスレッドやジョブ) から呼び、読み込みと GPU の完了を描画スレッドで待たないようにします。
+	 *				request / cancel / setPriority / status / poll はどのスレッドからも呼べ、排他は短い記帳の間だけです。
+	 *				完了は poll で取り出します。転送先を描画に使えるのは Completed を受け取ってからです。
+	 */
+	class ResourceStreamer final :
+		public INonmovable<ResourceStreamer>
+	{
+	public	:
+		//!	@brief	デフォルトコンストラクタ
+		ResourceStreamer() noexcept;
+		//!	@brief	デストラクタ
+		~ResourceStreamer() noexcept;
+
+		/**	@brief	初期化関数
+		 *	@param[in] engine 転送器 (終了するまで生かしておくこと)
+		 */
+		bool const init(ITransferEngine& engine) noexcept;
+		//!	@brief	終了関数 (転送中のコピーの完了を待ち、残りの要求は通知せずに捨てます)
+		void exit() noexcept;
+
+		/**	@brief	転送要求関数
+		 *	@return 要求のハンドル (内容が不正なら無効なハンドル)
+		 */
+		StreamTicket const request(StreamRequest const& desc) noexcept;
+		/**	@brief	取り消し関数
+		 *	@details	待機中の要求はすぐに、転送中の要求は積んだコピーが終わってから Canceled を通知します。
+		 *	@retval true 取り消しました。
+		 *	@retval false 無効なハンドルか、全てのコピーを積み終えています。
+		 */
+		bool const cancel(StreamTicket const& ticket) noexcept;
+		/**	@brief	優先度の変更関数
+		 *	@retval true 変更しました。
+		 *	@retval false 無効なハンドルか、全てのコピーを積み終えています。
+		 */
+		bool const setPriority(StreamTicket const& ticket, unsigned int const& priority) noexcept;
+		//!	@brief	状態取得関数
+		StreamStatus const status(StreamTicket const& ticket) noexcept;
+
+		/**	@brief	転送処理関数
+		 *	@details	完了したコピーの一時領域を返して完了通知を作り、budget に収まるだけ読み込んで転送器へ提出します。
+		 *	@param[in] budget 転送する大きさの上限
+		 *	@return 積んだコピーの数
+		 */
+		size_t const update(unsigned long long const& budget = STREAM_BUDGET_DEFAULT) noexcept;
+		//!	@brief	全ての要求が終わるまで update を繰り返す関数 (読み込み画面などで使います)
+		void flush() noexcept;
+		/**	@brief	完了通知の取り出し関数
+		 *	@param[out] out 書き込み先
+		 *	@param[in] capacity 書き込み先の要素数
+		 *	@return 取り出した数
+		 */
+		size_t const poll(StreamCompletion* out, size_t const& capacity) noexcept;
+
+		//!	@brief	終わっていない要求の数
+		size_t const pending() noexcept;
+		//!	@brief	集計取得関数
+		StreamStats const stats() noexcept;
+
+	private	:
+		/**	@struct	Entry
+		 *	@brief	要求一つ分の記帳
+		 */
+		struct Entry final {
+			//!	@brief	要求
+			StreamRequest desc;
+			//!	@brief	積み終えたバイト数 (バッファ) か行数 (テクスチャ)
+			unsigned long long cursor;
+			//!	@brief	受け付けた順番
+			unsigned long long order;
+			//!	@brief	最後に積んだコピーのフェンス値 (提出前は ~0)
+			unsigned long long value;
+			//!	@brief	優先度の変更や取り消しで進む版数
+			unsigned int version;
+			//!	@brief	状態
+			StreamStatus status;
+			//!	@brief	完了待ちの一覧に入っているかどうか
+			bool waiting;
+		};
+		/**	@struct	Node
+		 *	@brief	優先度付きキューの要素
+		 */
+		struct Node final {
+			//!	@brief	優先度
+			unsigned int priority;
+			//!	@brief	版数 (記帳と違えば捨てます)
+			unsigned int version;
+			//!	@brief	受け付けた順番
+			unsigned long long order;
+			//!	@brief	記帳のキー
+			SlotMap<Entry>::KeyType key;
+		};
+		/**	@struct	Chunk
+		 *	@brief	一回の update で積むコピー
+		 */
+		struct Chunk final {
+			//!	@brief	記帳のキー
+			SlotMap<Entry>::KeyType key;
+			//!	@brief	コピー
+			StreamCopy copy;
+			//!	@brief	読み込み関数
+			StreamReadFunc read;
+			//!	@brief	文脈
+			void* context;
+			//!	@brief	元データ内の位置
+			unsigned long long source;
+			//!	@brief	読み込む大きさ
+			unsigned long long bytes;
+			//!	@brief	読み込めたかどうか
+			bool valid;
+		};
+
+		//!	@brief	要求の全てを積み終えたかどうか
+		static bool const issued(Entry const& entry) noexcept;
+		//!	@brief	優先度付きキューへの追加関数
+		void push(SlotMap<Entry>::KeyType const& key, Entry const& entry) noexcept;
+		//!	@brief	完了通知の作成関数 (記帳を消します)
+		void finish(SlotMap<Entry>::KeyType const& key, StreamStatus const& status) noexcept;
+		//!	@brief	完了待ちの一覧への追加関数
+		void wait(SlotMap<Entry>::KeyType const& key, Entry& entry) noexcept;
+		//!	@brief	次のコピーの計画関数 (一時領域が足りなければ false)
+		bool const plan(SlotMap<Entry>::KeyType const& key, Entry& entry, unsigned long long const& budget, Chunk& chunk) noexcept;
+
+		//!	@brief	転送器
+		ITransferEngine* m_engine;
+		//!	@brief	一時領域の切り出し
+		StagingRing m_ring;
+		//!	@brief	要求の記帳
+		SlotMap<Entry> m_entries;
+		//!	@brief	優先度付きキュー (二分ヒープ)
+		std::vector<Node> m_queue;
+		//!	@brief	全て積み終えて完了を待つ要求
+		std::vector<SlotMap<Entry>::KeyType> m_waiting;
+		//!	@brief	取り出し待ちの完了通知
+		std::vector<StreamCompletion> m_completions;
+		//!	@brief	今回の update で積むコピー
+		std::vector<Chunk> m_chunks;
+		//!	@brief	次に受け付ける順番
+		unsigned long long m_order;
+		//!	@brief	最後に提出したフェンス値
+		unsigned long long m_value;
+		//!	@brief	集計
+		StreamStats m_stats;
+		//!	@brief	排他
+		std::mutex m_mutex;
+	};
+}
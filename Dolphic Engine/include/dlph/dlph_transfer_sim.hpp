@@ -0,0 +1,128 @@
+﻿/**	@file	dlph_transfer_sim.hpp
+ *	@brief	GPU を使わない転送器
+ */
+#pragma once
+#include "dlph_streamer.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <thread>
+
+namespace dlph {
+	/**	@struct	SimulatedTarget
+	 *	@brief	GPU を使わない転送器の転送先
+	 */
+	struct SimulatedTarget final {
+		//!	@brief	先頭
+		unsigned char* memory;
+		//!	@brief	大きさ
+		unsigned long long size;
+		//!	@brief	行の間隔 (テクスチャのみ)
+		unsigned long long rowPitch;
+		//!	@brief	サブリソースの間隔 (テクスチャのみ)
+		unsigned long long slicePitch;
+	};
+
+	/**	@class	SimulatedTransferEngine
+	 *	@brief	GPU を使わない転送器
+	 *	@details	提出したコピーを別スレッドで順に CPU のメモリへ書き込み、終わるたびにフェンス値を進めます。
+	 *				帯域と遅延を設定すると、その分だけ完了を遅らせます。GPU の無い環境で ResourceStreamer の
+	 *				優先度や取り消し、一時領域の使い回しを確かめたり、転送の量を測ったりするためのものです。
+	 */
+	class SimulatedTransferEngine final : public ITransferEngine {
+	public	:
+		//!	@brief	デフォルトコンストラクタ
+		SimulatedTransferEngine() noexcept;
+		//!	@brief	デストラクタ
+		~SimulatedTransferEngine() noexcept;
+
+		/**	@brief	初期化関数
+		 *	@param[in] staging 一時領域の大きさ
+		 *	@param[in] bandwidth 一秒あたりに転送するバイト数 (0 は制限しません)
+		 *	@param[in] latency 提出から転送開始までの遅延 (マイクロ秒)
+		 *	@param[in] pitch テクスチャの行の間隔の境界
+		 *	@param[in] placement コピー元の位置の境界
+		 */
+		bool const init(unsigned long long const& staging, unsigned long long const& bandwidth = 0U, unsigned int const& latency = 0U,
+			unsigned long long const& pitch = 1U, unsigned long long const& placement = 1U) noexcept;
+		//!	@brief	終了関数 (提出済みのコピーを終えてから止めます)
+		void exit() noexcept;
+
+		//!	@brief	転送先の登録関数
+		RenderResource const registerTarget(SimulatedTarget const& target) noexcept;
+		//!	@brief	転送先の登録解除関数
+		void unregisterTarget(RenderResource const& handle) noexcept;
+
+		//!	@brief	一時領域の先頭
+		unsigned char* const staging() noexcept override;
+		//!	@brief	一時領域の大きさ
+		unsigned long long const stagingSize() const noexcept override;
+		//!	@brief	コピー元の位置の境界
+		unsigned long long const placementAlignment() const noexcept override;
+		//!	@brief	テクスチャの行の間隔の境界
+		unsigned long long const pitchAlignment() const noexcept override;
+
+		//!	@brief	コピーを積む関数
+		bool const copy(StreamCopy const& copy) noexcept override;
+		//!	@brief	積んだコピーの提出関数
+		unsigned long long const submit() noexcept override;
+		//!	@brief	到達したフェンス値
+		unsigned long long const completed() noexcept override;
+		//!	@brief	フェンス値への到達を待つ関数
+		void wait(unsigned long long const& value) noexcept override;
+
+		//!	@brief	書き込んだバイト数
+		unsigned long long const transferred() const noexcept;
+
+	private	:
+		/**	@struct	Record
+		 *	@brief	積んだコピー
+		 */
+		struct Record final {
+			//!	@brief	コピー
+			StreamCopy copy;
+			//!	@brief	転送先
+			SimulatedTarget target;
+			//!	@brief	提出したときのフェンス値
+			unsigned long long value;
+		};
+
+		//!	@brief	転送スレッドの処理
+		void run() noexcept;
+
+		//!	@brief	一時領域
+		std::unique_ptr<unsigned char[]> m_staging;
+		//!	@brief	一時領域の大きさ
+		unsigned long long m_size;
+		//!	@brief	一秒あたりに転送するバイト数
+		unsigned long long m_bandwidth;
+		//!	@brief	遅延 (マイクロ秒)
+		unsigned int m_latency;
+		//!	@brief	行の間隔の境界
+		unsigned long long m_pitch;
+		//!	@brief	コピー元の位置の境界
+		unsigned long long m_placement;
+
+		//!	@brief	転送先
+		SlotMap<SimulatedTarget> m_targets;
+		//!	@brief	積んだまま提出していないコピー
+		std::vector<Record> m_recorded;
+		//!	@brief	提出済みのコピー
+		std::vector<Record> m_submitted;
+		//!	@brief	最後に割り当てたフェンス値
+		unsigned long long m_value;
+		//!	@brief	到達したフェンス値
+		std::atomic<unsigned long long> m_completed;
+		//!	@brief	書き込んだバイト数
+		std::atomic<unsigned long long> m_transferred;
+		//!	@brief	転送スレッド
+		std::thread m_worker;
+		//!	@brief	排他
+		std::mutex m_mutex;
+		//!	@brief	提出の通知
+		std::condition_variable m_submit;
+		//!	@brief	完了の通知
+		std::condition_variable m_finish;
+		//!	@brief	転送スレッドを止めるかどうか
+		bool m_quit;
+	};
+}
@@ -0,0 +1,102 @@
+﻿/**	@file	ecs_archetype.hpp
+ *	@brief	アーキタイプ
+ */
+#pragma once
+#include "ifs/nonmovable.hpp"
+#include "ecs/ecs_component.hpp"
+#include <vector>
+
+namespace dlph {
+	//!	@brief	チャンクのバイト数
+	static size_t constexpr CHUNK_SIZE = 16384U;
+	//!	@brief	チャンク内配列のアライメント
+	static size_t constexpr CHUNK_ALIGNMENT = 64U;
+	//!	@brief	行を追加できなかったことを表す行番号
+	static size_t constexpr ARCHETYPE_ROW_INVALID = ~static_cast<size_t>(0U);
+
+	/**	@struct	ChunkView
+	 *	@brief	チャンクの参照
+	 *	@details	チャンク内ではエンティティとコンポーネントが型ごとの配列 (SoA) で並んでいます。
+	 */
+	struct ChunkView final {
+		//!	@brief	チャンクの先頭
+		unsigned char* memory;
+		//!	@brief	各コンポーネント配列の開始位置 (持たない型は CHUNK_SIZE)
+		size_t const* offsets;
+		//!	@brief	要素数
+		size_t count;
+
+		//!	@brief	エンティティ配列
+		Entity const* const entities() const noexcept {
+			return reinterpret_cast<Entity const*>(memory);
+		}
+		//!	@brief	コンポーネント配列 (持たない型は nullptr)
+		template <typename T>
+		T* const array() const noexcept {
+			size_t const offset = offsets[componentType<T>()];
+			return offset < CHUNK_SIZE ? reinterpret_cast<T*>(memory + offset) : nullptr;
+		}
+	};
+
+	/**	@class	Archetype
+	 *	@brief	アーキタイプ
+	 *	@details	同じコンポーネント集合を持つエンティティを 16 KB のチャンクに詰めて保持します。
+	 *				行は全チャンクを通した通し番号で、削除時は末尾の行を移して隙間を作りません。
+	 */
+	class Archetype final :
+		public INonmovable<Archetype>
+	{
+	public	:
+		//!	@brief	デフォルトコンストラクタ
+		Archetype() noexcept;
+		//!	@brief	デストラクタ
+		~Archetype() noexcept;
+
+		/**	@brief	初期化関数
+		 *	@param[in] mask コンポーネント集合
+		 *	@retval true 初期化しました。
+		 *	@retval false コンポーネントが大きすぎて、一つのチャンクに一行も収まりません。
+		 */
+		bool const init(ComponentMask const& mask) noexcept;
+		//!	@brief	終了関数 (全ての行を破棄します)
+		void exit() noexcept;
+
+		/**	@brief	行の追加関数
+		 *	@details	コンポーネントは構築しないため、呼び出し側で全て構築してください。
+		 *	@return 追加した行 (チャンクを確保できなければ ARCHETYPE_ROW_INVALID)
+		 */
+		size_t const push(Entity const& entity) noexcept;
+		/**	@brief	行の削除関数
+		 *	@details	行のコンポーネントを破棄し、末尾の行をそこへ移します。
+		 *	@return 移動したエンティティ (移動が無ければ無効なエンティティ)
+		 */
+		Entity const remove(size_t const& row) noexcept;
+		//!	@brief	コンポーネント取得関数 (持たない型は nullptr)
+		void* const component(unsigned int const& type, size_t const& row) noexcept;
+
+		//!	@brief	コンポーネント集合
+		ComponentMask const mask() const noexcept;
+		//!	@brief	行数
+		size_t const size() const noexcept;
+		//!	@brief	チャンクあたりの行数
+		size_t const rows() const noexcept;
+		//!	@brief	チャンク数 (空のチャンクは含みません)
+		size_t const chunkCount() const noexcept;
+		//!	@brief	チャンク取得関数
+		ChunkView const chunk(size_t const& idx) noexcept;
+
+	private	:
+		//!	@brief	コンポーネント集合
+		ComponentMask m_mask;
+		//!	@brief	所持する型番号
+		std::vector<unsigned int> m_types;
+		//!	@brief	各コンポーネント配列の開始位置
+		size_t m_offsets[COMPONENT_MAX];
+		//!	@brief	チャンクあたりの行数
+		size_t m_rows;
+		//!	@brief	行数
+		size_t m_size;
+		//!	@brief	チャンク
+		std::vector<unsigned char*> m_chunks;
+	};
+}
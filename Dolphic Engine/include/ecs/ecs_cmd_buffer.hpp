@@ -0,0 +1,84 @@
+﻿/**	@file	ecs_cmd_buffer.hpp
+ *	@brief	ECS コマンドバッファ
+ */
+#pragma once
+#include "ifs/nonmovable.hpp"
+#include "ecs/ecs_world.hpp"
+#include "mem/arena.hpp"
+#include <mutex>
+#include <vector>
+
+namespace dlph {
+	/**	@class	EntityCommandBuffer
+	 *	@brief	ECS コマンドバッファ
+	 *	@details	走査中に行えないエンティティの生成・破棄とコンポーネントの追加・削除を記録し、flush でまとめて反映します。
+	 *				記録は排他されているため、並列走査の関数から同じバッファへ記録できます。
+	 *				コマンドは線形アリーナに置き、flush でまとめて解放します。
+	 */
+	class EntityCommandBuffer final :
+		public INonmovable<EntityCommandBuffer>
+	{
+	public	:
+		//!	@brief	デフォルトコンストラクタ
+		EntityCommandBuffer() noexcept;
+		//!	@brief	デストラクタ
+		~EntityCommandBuffer() noexcept;
+
+		/**	@brief	初期化関数
+		 *	@param[in] capacity コマンド用アリーナの容量 (バイト数、超えた分は new で確保します)
+		 */
+		bool const init(size_t const& capacity) noexcept;
+		//!	@brief	終了関数 (未反映のコマンドは捨てます)
+		void exit() noexcept;
+
+		//!	@brief	生成の記録関数
+		template <typename... Ts>
+		void create(Ts&&... components) noexcept;
+		//!	@brief	破棄の記録関数
+		void destroy(Entity const& entity) noexcept;
+		//!	@brief	コンポーネント追加の記録関数
+		template <typename T>
+		void add(Entity const& entity, T&& component) noexcept;
+		//!	@brief	コンポーネント削除の記録関数
+		template <typename T>
+		void remove(Entity const& entity) noexcept;
+
+		//!	@brief	反映関数 (記録順に反映し、記録を空にします)
+		void flush(World& world) noexcept;
+		//!	@brief	破棄関数 (反映せずに記録を空にします)
+		void clear() noexcept;
+		//!	@brief	記録数
+		size_t const size() const noexcept;
+
+	private	:
+		/**	@struct	Command
+		 *	@brief	コマンド
+		 */
+		struct Command {
+			//!	@brief	デストラクタ
+			virtual ~Command() noexcept {}
+			//!	@brief	反映関数
+			virtual void apply(World& world) noexcept = 0;
+		};
+		template <typename... Ts>
+		struct CreateCommand;
+		struct DestroyCommand;
+		template <typename T>
+		struct AddCommand;
+		template <typename T>
+		struct RemoveCommand;
+
+		//!	@brief	記録関数
+		template <typename C, typename... Args>
+		void record(Args&&... args) noexcept;
+
+		//!	@brief	コマンドの置き場
+		LinearArena m_arena;
+		//!	@brief	記録順のコマンド
+		std::vector<Command*> m_commands;
+		//!	@brief	記録の排他
+		std::mutex m_mutex;
+	};
+}
+
+#include "ecs_cmd_buffer.inl"
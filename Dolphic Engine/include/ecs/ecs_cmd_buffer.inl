@@ -0,0 +1,115 @@
+﻿/**	@file	ecs_cmd_buffer.inl
+ *	@brief	ECS コマンドバッファ
+ */
+#pragma once
+#include "ecs_cmd_buffer.hpp"
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace dlph {
+	/**	@struct	EntityCommandBuffer::CreateCommand<Ts...>
+	 *	@brief	生成コマンド
+	 */
+	template<typename... Ts>
+	struct EntityCommandBuffer::CreateCommand final : EntityCommandBuffer::Command {
+		//!	@brief	コンポーネント
+		std::tuple<Ts...> components;
+
+		//!	@brief	コンストラクタ
+		template <typename... Args>
+		explicit CreateCommand(Args&&... args) noexcept :
+			components(std::forward<Args>(args)...)
+		{}
+		//!	@brief	反映関数
+		void apply(World& world) noexcept override {
+			std::apply([&world](Ts&... args) {
+				world.create(std::move(args)...);
+			}, components);
+		}
+	};
+
+	/**	@struct	EntityCommandBuffer::DestroyCommand
+	 *	@brief	破棄コマンド
+	 */
+	struct EntityCommandBuffer::DestroyCommand final : EntityCommandBuffer::Command {
+		//!	@brief	対象
+		Entity entity;
+
+		//!	@brief	コンストラクタ
+		explicit DestroyCommand(Entity const& arg) noexcept :
+			entity(arg)
+		{}
+		//!	@brief	反映関数
+		void apply(World& world) noexcept override {
+			world.destroy(entity);
+		}
+	};
+
+	/**	@struct	EntityCommandBuffer::AddCommand<T>
+	 *	@brief	コンポーネント追加コマンド
+	 */
+	template<typename T>
+	struct EntityCommandBuffer::AddCommand final : EntityCommandBuffer::Command {
+		//!	@brief	対象
+		Entity entity;
+		//!	@brief	コンポーネント
+		T component;
+
+		//!	@brief	コンストラクタ
+		template <typename Arg>
+		AddCommand(Entity const& target, Arg&& arg) noexcept :
+			entity(target),
+			component(std::forward<Arg>(arg))
+		{}
+		//!	@brief	反映関数
+		void apply(World& world) noexcept override {
+			world.add<T>(entity, std::move(component));
+		}
+	};
+
+	/**	@struct	EntityCommandBuffer::RemoveCommand<T>
+	 *	@brief	コンポーネント削除コマンド
+	 */
+	template<typename T>
+	struct EntityCommandBuffer::RemoveCommand final : EntityCommandBuffer::Command {
+		//!	@brief	対象
+		Entity entity;
+
+		//!	@brief	コンストラクタ
+		explicit RemoveCommand(Entity const& arg) noexcept :
+			entity(arg)
+		{}
+		//!	@brief	反映関数
+		void apply(World& world) noexcept override {
+			world.remove<T>(entity);
+		}
+	};
+
+	template<typename... Ts>
+	inline void EntityCommandBuffer::create(Ts&&... components) noexcept {
+		record<CreateCommand<std::decay_t<Ts>...>>(std::forward<Ts>(components)...);
+	}
+
+	inline void EntityCommandBuffer::destroy(Entity const& entity) noexcept {
+		record<DestroyCommand>(entity);
+	}
+
+	template<typename T>
+	inline void EntityCommandBuffer::add(Entity const& entity, T&& component) noexcept {
+		record<AddCommand<std::decay_t<T>>>(entity, std::forward<T>(component));
+	}
+
+	template<typename T>
+	inline void EntityCommandBuffer::remove(Entity const& entity) noexcept {
+		record<RemoveCommand<T>>(entity);
+	}
+
+	template<typename C, typename... Args>
+	inline void EntityCommandBuffer::record(Args&&... args) noexcept {
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		void* const ptr = m_arena.allocate(sizeof(C), alignof(C));
+		m_commands.push_back(::new (ptr) C(std::forward<Args>(args)...));
+	}
+}
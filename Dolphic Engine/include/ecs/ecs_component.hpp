@@ -0,0 +1,76 @@
+﻿/**	@file	ecs_component.hpp
+ *	@brief	ECS の基本型
+ */
+#pragma once
+#include "mem/handle.hpp"
+#include "structs/t3.hpp"
+#include "structs/t4.hpp"
+
+namespace dlph {
+	class World;
+
+	//!	@brief	エンティティ (ワールド内の世代付きハンドル)
+	using Entity = Handle32<World>;
+	//!	@brief	コンポーネント集合 (型番号のビット集合)
+	using ComponentMask = unsigned long long;
+
+	//!	@brief	登録できるコンポーネント型の最大数
+	static unsigned int constexpr COMPONENT_MAX = 64U;
+
+	/**	@struct	ComponentInfo
+	 *	@brief	コンポーネント型の情報
+	 *	@details	チャンクは型を知らずに要素を並べるため、大きさと移動・破棄の手段をここに持たせます。
+	 */
+	struct ComponentInfo final {
+		//!	@brief	大きさ
+		size_t size;
+		//!	@brief	アライメント
+		size_t alignment;
+		//!	@brief	ムーブ構築関数 (dst へ構築し、src は破棄しません)
+		void (*move)(void* dst, void* src) noexcept;
+		//!	@brief	破棄関数
+		void (*destruct)(void* ptr) noexcept;
+	};
+
+	/**	@struct	Translation
+	 *	@brief	位置コンポーネント
+	 */
+	struct Translation final {
+		//!	@brief	位置
+		Float3 value;
+	};
+
+	/**	@struct	Rotation
+	 *	@brief	回転コンポーネント
+	 */
+	struct Rotation final {
+		//!	@brief	回転 (四元数)
+		Float4 value;
+	};
+
+	/**	@struct	Scale
+	 *	@brief	拡縮コンポーネント
+	 */
+	struct Scale final {
+		//!	@brief	拡縮率
+		Float3 value;
+	};
+
+	/**	@brief	コンポーネント型登録関数
+	 *	@param[in] info 型の情報
+	 *	@details	COMPONENT_MAX 個を超えて登録するとプログラムを止めます。
+	 *	@return 型番号
+	 */
+	unsigned int const registerComponent(ComponentInfo const& info) noexcept;
+	//!	@brief	コンポーネント型の情報取得関数
+	ComponentInfo const& componentInfo(unsigned int const& type) noexcept;
+
+	//!	@brief	コンポーネント型番号取得関数 (初回呼び出し時に登録します)
+	template <typename T>
+	unsigned int const componentType() noexcept;
+	//!	@brief	コンポーネント集合取得関数
+	template <typename... Ts>
+	ComponentMask const componentMask() noexcept;
+}
+
+#include "ecs_component.inl"
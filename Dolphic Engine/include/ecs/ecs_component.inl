@@ -0,0 +1,32 @@
+﻿/**	@file	ecs_component.inl
+ *	@brief	ECS の基本型
+ */
+#pragma once
+#include "ecs_component.hpp"
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace dlph {
+	template<typename T>
+	inline unsigned int const componentType() noexcept {
+		static_assert(std::is_nothrow_move_constructible<T>::value, "Component must be nothrow move constructible.");
+
+		static unsigned int const type = registerComponent({
+			sizeof(T),
+			alignof(T),
+			[](void* dst, void* src) noexcept {
+				::new (dst) T(std::move(*static_cast<T*>(src)));
+			},
+			[](void* ptr) noexcept {
+				static_cast<T*>(ptr)->~T();
+			}
+		});
+		return type;
+	}
+
+	template<typename... Ts>
+	inline ComponentMask const componentMask() noexcept {
+		return (static_cast<ComponentMask>(0U) | ... | (static_cast<ComponentMask>(1U) << componentType<Ts>()));
+	}
+}
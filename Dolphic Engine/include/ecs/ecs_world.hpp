@@ -0,0 +1,121 @@
+﻿/**	@file	ecs_world.hpp
+ *	@brief	ECS ワールド
+ */
+#pragma once
+#include "ifs/nonmovable.hpp"
+#include "ecs/ecs_archetype.hpp"
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace dlph {
+	/**	@class	World
+	 *	@brief	ECS ワールド
+	 *	@details	エンティティをコンポーネント集合ごとのアーキタイプへ振り分け、チャンク単位で線形に走査させます。
+	 *				走査中にコンポーネントの追加・削除やエンティティの生成・破棄を行うと行が移動するため、
+	 *				走査中の構造変更は EntityCommandBuffer に記録して走査後に反映してください。
+	 */
+	class World final :
+		public INonmovable<World>
+	{
+	public	:
+		//!	@brief	デフォルトコンストラクタ
+		World() noexcept;
+		//!	@brief	デストラクタ
+		~World() noexcept;
+
+		//!	@brief	初期化関数
+		bool const init() noexcept;
+		//!	@brief	終了関数 (全てのエンティティを破棄します)
+		void exit() noexcept;
+
+		//!	@brief	生成関数 (コンポーネントを持たないエンティティ)
+		Entity const create() noexcept;
+		//!	@brief	生成関数 (コンポーネントを全て持たせて一度で配置します)
+		template <typename... Ts>
+		Entity const create(Ts&&... components) noexcept;
+		/**	@brief	破棄関数
+		 *	@retval true 破棄しました。
+		 *	@retval false 既に破棄されています。
+		 */
+		bool const destroy(Entity const& entity) noexcept;
+		//!	@brief	生存判定関数
+		bool const alive(Entity const& entity) const noexcept;
+
+		//!	@brief	コンポーネント追加関数 (既に持っていれば置き換えます)
+		template <typename T, typename... Args>
+		T* const add(Entity const& entity, Args&&... args) noexcept;
+		//!	@brief	コンポーネント削除関数
+		template <typename T>
+		bool const remove(Entity const& entity) noexcept;
+		//!	@brief	コンポーネント取得関数 (持たなければ nullptr)
+		template <typename T>
+		T* const get(Entity const& entity) noexcept;
+		//!	@brief	コンポーネント所持判定関数
+		template <typename T>
+		bool const has(Entity const& entity) const noexcept;
+
+		/**	@brief	走査関数
+		 *	@param[in] func 関数 (Entity const&, Ts&...)
+		 */
+		template <typename... Ts, typename F>
+		void each(F const& func) noexcept;
+		/**	@brief	チャンク単位の走査関数
+		 *	@details	配列をそのまま一括演算へ渡せるよう、チャンク内の配列の先頭を渡します。
+		 *	@param[in] func 関数 (size_t count, Entity const*, Ts*...)
+		 */
+		template <typename... Ts, typename F>
+		void eachChunk(F const& func) noexcept;
+		/**	@brief	並列走査関数
+		 *	@details	チャンクを単位としてワーカースレッドへ振り分けます。関数は複数スレッドから同時に呼ばれます。
+		 *	@param[in] func 関数 (size_t count, Entity const*, Ts*...)
+		 */
+		template <typename... Ts, typename F>
+		void parallelEachChunk(F const& func) noexcept;
+
+		//!	@brief	エンティティ数
+		size_t const size() const noexcept;
+		//!	@brief	アーキタイプ数
+		size_t const archetypeCount() const noexcept;
+
+	private	:
+		/**	@struct	Record
+		 *	@brief	エンティティの所在
+		 */
+		struct Record final {
+			//!	@brief	所属するアーキタイプ (空きスロットは nullptr)
+			Archetype* archetype;
+			//!	@brief	行 (空きスロットは次の空きスロット番号)
+			size_t row;
+			//!	@brief	世代 (生存中は奇数)
+			unsigned int generation;
+		};
+
+		//!	@brief	空きスロットが無いことを表す番号
+		static size_t constexpr RECORD_END = Entity::INDEX_MASK;
+
+		//!	@brief	アーキタイプ取得関数 (無ければ作ります)
+		Archetype* const archetype(ComponentMask const& mask) noexcept;
+		//!	@brief	エンティティ確保関数 (コンポーネントは構築しません)
+		Entity const allocate(ComponentMask const& mask) noexcept;
+		//!	@brief	アーキタイプ移動関数 (共通するコンポーネントを移し、新しく増えた分は構築しません)
+		bool const migrate(Entity const& entity, ComponentMask const& mask) noexcept;
+		//!	@brief	コンポーネント取得関数
+		void* const component(Entity const& entity, unsigned int const& type) noexcept;
+		//!	@brief	条件に合うチャンクを集める関数
+		void gather(ComponentMask const& mask, std::vector<ChunkView>& chunks) noexcept;
+
+		//!	@brief	エンティティの所在
+		std::vector<Record> m_records;
+		//!	@brief	空きスロットの先頭
+		size_t m_free;
+		//!	@brief	エンティティ数
+		size_t m_size;
+		//!	@brief	アーキタイプ (コンポーネント集合で引きます)
+		std::unordered_map<ComponentMask, std::unique_ptr<Archetype>> m_archetypes;
+		//!	@brief	アーキタイプ (生成順、走査用)
+		std::vector<Archetype*> m_order;
+	};
+}
+
+#include "ecs_world.inl"
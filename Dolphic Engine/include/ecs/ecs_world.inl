@@ -0,0 +1,88 @@
+﻿/**	@file	ecs_world.inl
+ *	@brief	ECS ワールド
+ */
+#pragma once
+#include "ecs_world.hpp"
+#include "util/parallel.hpp"
+#include <new>
+#include <utility>
+
+namespace dlph {
+	template<typename... Ts>
+	inline Entity const World::create(Ts&&... components) noexcept {
+		Entity const entity = allocate(componentMask<std::decay_t<Ts>...>());
+		if (entity) {
+			(::new (component(entity, componentType<std::decay_t<Ts>>())) std::decay_t<Ts>(std::forward<Ts>(components)), ...);
+		}
+		return entity;
+	}
+
+	template<typename T, typename... Args>
+	inline T* const World::add(Entity const& entity, Args&&... args) noexcept {
+		if (!alive(entity)) {
+			return nullptr;
+		}
+
+		unsigned int const type = componentType<T>();
+		if (T* const ptr = static_cast<T*>(component(entity, type))) {
+			*ptr = T(std::forward<Args>(args)...);
+			return ptr;
+		}
+		migrate(entity, m_records[entity.index()].archetype->mask() | (static_cast<ComponentMask>(1U) << type));
+		void* const ptr = component(entity, type);
+		return ptr ? ::new (ptr) T(std::forward<Args>(args)...) : nullptr;
+	}
+
+	template<typename T>
+	inline bool const World::remove(Entity const& entity) noexcept {
+		if (!has<T>(entity)) {
+			return false;
+		}
+		return migrate(entity, m_records[entity.index()].archetype->mask() & ~(static_cast<ComponentMask>(1U) << componentType<T>()));
+	}
+
+	template<typename T>
+	inline T* const World::get(Entity const& entity) noexcept {
+		return alive(entity) ? static_cast<T*>(component(entity, componentType<T>())) : nullptr;
+	}
+
+	template<typename T>
+	inline bool const World::has(Entity const& entity) const noexcept {
+		return alive(entity) && (m_records[entity.index()].archetype->mask() & (static_cast<ComponentMask>(1U) << componentType<T>())) != 0U;
+	}
+
+	template<typename... Ts, typename F>
+	inline void World::each(F const& func) noexcept {
+		eachChunk<Ts...>([&func](size_t const& count, Entity const* entities, Ts*... arrays) {
+			for (size_t idx = 0U; idx < count; ++idx) {
+				func(entities[idx], arrays[idx]...);
+			}
+		});
+	}
+
+	template<typename... Ts, typename F>
+	inline void World::eachChunk(F const& func) noexcept {
+		ComponentMask const mask = componentMask<Ts...>();
+		for (Archetype* const& type : m_order) {
+			if ((type->mask() & mask) != mask) {
+				continue;
+			}
+			for (size_t idx = 0U, cnt = type->chunkCount(); idx < cnt; ++idx) {
+				ChunkView const chunk = type->chunk(idx);
+				func(chunk.count, chunk.entities(), chunk.array<Ts>()...);
+			}
+		}
+	}
+
+	template<typename... Ts, typename F>
+	inline void World::parallelEachChunk(F const& func) noexcept {
+		std::vector<ChunkView> chunks;
+		gather(componentMask<Ts...>(), chunks);
+		parallel_for(chunks.size(), 1U, [&chunks, &func](size_t const& begin, size_t const& end) {
+			for (size_t idx = begin; idx < end; ++idx) {
+				ChunkView const& chunk = chunks[idx];
+				func(chunk.count, chunk.entities(), chunk.array<Ts>()...);
+			}
+		});
+	}
+}
@@ -28,11 +28,11 @@ namespace dlph {
 		T const operator[](float const& rate) const noexcept;
 
 		//!	@brief	中心点設定関数
-		FRay<T>& center(T const& arg) const noexcept;
+		FRay<T>& center(T const& arg) noexcept;
 		//!	@brief	方向設定関数
-		FRay<T>& direction(T const& arg) const noexcept;
+		FRay<T>& direction(T const& arg) noexcept;
 		//!	@brief	半径設定関数
-		FRay<T>& radius(float const& arg) const noexcept;
+		FRay<T>& radius(float const& arg) noexcept;
 
 		//!	@brief	中心点取得関数
 		T const& center() const noexcept;
@@ -18,19 +18,19 @@ namespace dlph {
 	}
 
 	template<typename T>
-	inline FRay<T>& FRay<T>::center(T const& arg) const noexcept {
+	inline FRay<T>& FRay<T>::center(T const& arg) noexcept {
 		m_center = arg;
 		return *this;
 	}
 
 	template<typename T>
-	inline FRay<T>& FRay<T>::direction(T const& arg) const noexcept {
+	inline FRay<T>& FRay<T>::direction(T const& arg) noexcept {
 		m_direct = arg;
 		return *this;
 	}
 
 	template<typename T>
-	inline FRay<T>& FRay<T>::radius(float const& arg) const noexcept {
+	inline FRay<T>& FRay<T>::radius(float const& arg) noexcept {
 		m_radius = arg;
 		return *this;
 	}
@@ -0,0 +1,127 @@
+﻿/**	@file	fraypack.hpp
+ *	@brief	光線束クラス
+ */
+#pragma once
+#include "structs/t3.hpp"
+#include "math/fvec3.hpp"
+#include "gmtry/fray.hpp"
+#include <array>
+
+namespace dlph {
+	//!	@brief	交差していないことを表す図形番号
+	static unsigned int constexpr RAY_MISS = ~0U;
+
+	/**	@class	FRayPacket<N>
+	 *	@brief	光線束クラス
+	 *	@details	N 本の光線を成分ごとの配列 (SoA) で保持し、箱・三角形との交差を全レーン同時に判定します。
+	 *				判定関数は対象レーンをビットマスクで受け取り、交差したレーンのビットマスクを返します。
+	 */
+	template <unsigned int N>
+	class FRayPacket final {
+		static_assert(N == 4U || N == 8U, "Ray packet width must be 4 or 8.");
+	public	:
+		//!	@brief	レーン数
+		static unsigned int constexpr LANE_CNT = N;
+		//!	@brief	全レーンを表すビットマスク
+		static unsigned int constexpr LANE_ALL = (1U << N) - 1U;
+
+		//!	@brief	ムーブコンストラクタ
+		FRayPacket(FRayPacket<N>&&) noexcept = default;
+		//!	@brief	コピーコンストラクタ
+		FRayPacket(FRayPacket<N> const&) noexcept = default;
+		//!	@brief	ムーブ代入演算子
+		FRayPacket& operator=(FRayPacket<N>&&) & noexcept = default;
+		//!	@brief	コピー代入演算子
+		FRayPacket& operator=(FRayPacket<N> const&) & noexcept = default;
+
+		//!	@brief	デフォルトコンストラクタ (全レーン無効)
+		FRayPacket() noexcept;
+		//!	@brief	デストラクタ
+		~FRayPacket() noexcept = default;
+
+		//!	@brief	光線点一括取得演算子 (全レーン同じ比率)
+		std::array<Float3, N> const operator[](float const& rate) const noexcept;
+		//!	@brief	光線点一括取得演算子 (レーンごとの比率)
+		std::array<Float3, N> const operator[](std::array<float, N> const& rates) const noexcept;
+
+		/**	@brief	光線設定関数
+		 *	@param[in] lane 設定するレーン
+		 *	@param[in] ray 光線 (半径が正なら光線の長さとして扱います)
+		 */
+		FRayPacket<N>& set(unsigned int const& lane, FRay<FVector3> const& ray) noexcept;
+		//!	@brief	光線設定関数
+		FRayPacket<N>& set(unsigned int const& lane, FVector3 const& origin, FVector3 const& direction, float const& t_min, float const& t_max) noexcept;
+		//!	@brief	レーン無効化関数
+		FRayPacket<N>& disable(unsigned int const& lane) noexcept;
+
+		//!	@brief	有効なレーンのビットマスク取得関数
+		unsigned int const active() const noexcept;
+		//!	@brief	方向の符号が全有効レーンで一致するかどうか
+		bool const coherent() const noexcept;
+		//!	@brief	方向の符号取得関数 (対象レーンのうち最初のレーン)
+		bool const negative(unsigned int const& axis, unsigned int const& mask) const noexcept;
+
+		/**	@brief	箱交差判定関数 (スラブ法)
+		 *	@param[in] lower 箱の最小点
+		 *	@param[in] upper 箱の最大点
+		 *	@param[in] mask 判定するレーン
+		 *	@return 現在の最近交差より手前で箱に入るレーン
+		 */
+		unsigned int const intersect(Float3 const& lower, Float3 const& upper, unsigned int const& mask) const noexcept;
+
+		/**	@brief	三角形交差判定関数 (Möller-Trumbore 法)
+		 *	@details	交差したレーンの最近交差距離・重心座標・図形番号を更新します。
+		 *	@param[in] p0, p1, p2 三角形の頂点
+		 *	@param[in] primitive 図形番号
+		 *	@param[in] mask 判定するレーン
+		 *	@return 最近交差を更新したレーン
+		 */
+		unsigned int const intersect(Float3 const& p0, Float3 const& p1, Float3 const& p2, unsigned int const& primitive, unsigned int const& mask) noexcept;
+
+		/**	@brief	三角形交差判定関数 (水密法)
+		 *	@details	辺や頂点上で光線がすり抜けない Woop らの方法です。交差時の更新内容は intersect と同じです。
+		 */
+		unsigned int const intersectWatertight(Float3 const& p0, Float3 const& p1, Float3 const& p2, unsigned int const& primitive, unsigned int const& mask) noexcept;
+
+		//!	@brief	最近交差距離取得関数
+		float const distance(unsigned int const& lane) const noexcept;
+		//!	@brief	最近交差の重心座標取得関数
+		Float3 const barycentric(unsigned int const& lane) const noexcept;
+		//!	@brief	最近交差の図形番号取得関数 (交差なしは RAY_MISS)
+		unsigned int const primitive(unsigned int const& lane) const noexcept;
+
+	private	:
+		//!	@brief	最小値取得関数 (fminf と違い NaN を考慮しないため SIMD 命令に展開されます)
+		static float const minimum(float const& lhs, float const& rhs) noexcept;
+		//!	@brief	最大値取得関数 (fmaxf と違い NaN を考慮しないため SIMD 命令に展開されます)
+		static float const maximum(float const& lhs, float const& rhs) noexcept;
+
+		//!	@brief	始点
+		alignas(32) float m_origin[T3_CNT][N];
+		//!	@brief	方向
+		alignas(32) float m_direct[T3_CNT][N];
+		//!	@brief	方向の逆数
+		alignas(32) float m_inverse[T3_CNT][N];
+		//!	@brief	水密法の剪断係数
+		alignas(32) float m_shear[T3_CNT][N];
+		//!	@brief	水密法の軸の並び (主軸が最後)
+		unsigned char m_axis[T3_CNT][N];
+		//!	@brief	判定範囲の最小値
+		alignas(32) float m_near[N];
+		//!	@brief	判定範囲の最大値 (最近交差距離)
+		alignas(32) float m_far[N];
+		//!	@brief	最近交差の重心座標
+		alignas(32) float m_u[N];
+		//!	@brief	最近交差の重心座標
+		alignas(32) float m_v[N];
+		//!	@brief	最近交差の図形番号
+		unsigned int m_primitive[N];
+	};
+
+	//!	@brief	四本の光線束
+	using FRayPacket4 = FRayPacket<4U>;
+	//!	@brief	八本の光線束
+	using FRayPacket8 = FRayPacket<8U>;
+}
+
+#include "fraypack.inl"
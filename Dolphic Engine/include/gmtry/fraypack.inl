@@ -0,0 +1,294 @@
+﻿/**	@file	fraypack.inl
+ *	@brief	光線束クラス
+ */
+#pragma once
+#include "fraypack.hpp"
+#include <cfloat>
+#include <cmath>
+
+namespace dlph {
+	template<unsigned int N>
+	inline FRayPacket<N>::FRayPacket() noexcept :
+		m_origin(),
+		m_direct(),
+		m_inverse(),
+		m_shear(),
+		m_axis(),
+		m_near(),
+		m_far(),
+		m_u(),
+		m_v(),
+		m_primitive()
+	{
+		for (unsigned int lane = 0U; lane < N; ++lane) {
+			disable(lane);
+		}
+	}
+
+	template<unsigned int N>
+	inline std::array<Float3, N> const FRayPacket<N>::operator[](float const& rate) const noexcept {
+		std::array<Float3, N> result;
+		for (unsigned int axis = 0U; axis < T3_CNT; ++axis) {
+			for (unsigned int lane = 0U; lane < N; ++lane) {
+				result[lane].p[axis] = m_origin[axis][lane] + m_direct[axis][lane] * rate;
+			}
+		}
+		return result;
+	}
+
+	template<unsigned int N>
+	inline std::array<Float3, N> const FRayPacket<N>::operator[](std::array<float, N> const& rates) const noexcept {
+		std::array<Float3, N> result;
+		for (unsigned int axis = 0U; axis < T3_CNT; ++axis) {
+			for (unsigned int lane = 0U; lane < N; ++lane) {
+				result[lane].p[axis] = m_origin[axis][lane] + m_direct[axis][lane] * rates[lane];
+			}
+		}
+		return result;
+	}
+
+	template<unsigned int N>
+	inline FRayPacket<N>& FRayPacket<N>::set(unsigned int const& lane, FRay<FVector3> const& ray) noexcept {
+		float const length = ray.radius() > 0.0f ? ray.radius() : FLT_MAX;
+		return set(lane, ray.center(), ray.direction(), 0.0f, length);
+	}
+
+	template<unsigned int N>
+	inline FRayPacket<N>& FRayPacket<N>::set(unsigned int const& lane, FVector3 const& origin, FVector3 const& direction, float const& t_min, float const& t_max) noexcept {
+		if (lane >= N) {
+			return *this;
+		}
+
+		unsigned int kz = 0U;
+		for (unsigned int axis = 0U; axis < T3_CNT; ++axis) {
+			float const d = direction.p[axis];
+			m_origin[axis][lane] = origin.p[axis];
+			m_direct[axis][lane] = d;
+			//	0 除算で NaN が出ないよう、十分大きな値で代用する
+			m_inverse[axis][lane] = fabsf(d) > 1.0e-20f ? 1.0f / d : copysignf(1.0e20f, d);
+			if (fabsf(d) > fabsf(direction.p[kz])) {
+				kz = axis;
+			}
+		}
+
+		//	主軸を z とする座標系へ並べ替え、手前から見て三角形の向きが保たれるよう x と y を入れ替える
+		unsigned int kx = (kz + 1U) % T3_CNT;
+		unsigned int ky = (kx + 1U) % T3_CNT;
+		if (direction.p[kz] < 0.0f) {
+			unsigned int const temp = kx;
+			kx = ky;
+			ky = temp;
+		}
+		float const dz = direction.p[kz] != 0.0f ? direction.p[kz] : FLT_MIN;
+		m_axis[0U][lane] = static_cast<unsigned char>(kx);
+		m_axis[1U][lane] = static_cast<unsigned char>(ky);
+		m_axis[2U][lane] = static_cast<unsigned char>(kz);
+		m_shear[0U][lane] = direction.p[kx] / dz;
+		m_shear[1U][lane] = direction.p[ky] / dz;
+		m_shear[2U][lane] = 1.0f / dz;
+
+		m_near[lane] = t_min;
+		m_far[lane] = t_max;
+		m_u[lane] = 0.0f;
+		m_v[lane] = 0.0f;
+		m_primitive[lane] = RAY_MISS;
+		return *this;
+	}
+
+	template<unsigned int N>
+	inline FRayPacket<N>& FRayPacket<N>::disable(unsigned int const& lane) noexcept {
+		if (lane < N) {
+			m_near[lane] = 0.0f;
+			m_far[lane] = -1.0f;
+			m_primitive[lane] = RAY_MISS;
+		}
+		return *this;
+	}
+
+	template<unsigned int N>
+	inline unsigned int const FRayPacket<N>::active() const noexcept {
+		unsigned int result = 0U;
+		for (unsigned int lane = 0U; lane < N; ++lane) {
+			result |= (m_near[lane] <= m_far[lane] ? 1U : 0U) << lane;
+		}
+		return result;
+	}
+
+	template<unsigned int N>
+	inline bool const FRayPacket<N>::coherent() const noexcept {
+		unsigned int const mask = active();
+		for (unsigned int axis = 0U; axis < T3_CNT; ++axis) {
+			unsigned int signs = 0U;
+			for (unsigned int lane = 0U; lane < N; ++lane) {
+				signs |= (m_inverse[axis][lane] < 0.0f ? 1U : 0U) << lane;
+			}
+			signs &= mask;
+			if (signs != 0U && signs != mask) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	template<unsigned int N>
+	inline bool const FRayPacket<N>::negative(unsigned int const& axis, unsigned int const& mask) const noexcept {
+		for (unsigned int lane = 0U; lane < N; ++lane) {
+			if ((mask >> lane) & 1U) {
+				return m_inverse[axis][lane] < 0.0f;
+			}
+		}
+		return false;
+	}
+
+	template<unsigned int N>
+	inline unsigned int const FRayPacket<N>::intersect(Float3 const& lower, Float3 const& upper, unsigned int const& mask) const noexcept {
+		alignas(32) float enter[N];
+		alignas(32) float leave[N];
+		for (unsigned int lane = 0U; lane < N; ++lane) {
+			enter[lane] = m_near[lane];
+			leave[lane] = m_far[lane];
+		}
+		for (unsigned int axis = 0U; axis < T3_CNT; ++axis) {
+			for (unsigned int lane = 0U; lane < N; ++lane) {
+				float const t0 = (lower.p[axis] - m_origin[axis][lane]) * m_inverse[axis][lane];
+				float const t1 = (upper.p[axis] - m_origin[axis][lane]) * m_inverse[axis][lane];
+				enter[lane] = maximum(enter[lane], minimum(t0, t1));
+				leave[lane] = minimum(leave[lane], maximum(t0, t1));
+			}
+		}
+
+		unsigned int result = 0U;
+		for (unsigned int lane = 0U; lane < N; ++lane) {
+			result |= (enter[lane] <= leave[lane] ? 1U : 0U) << lane;
+		}
+		return result & mask;
+	}
+
+	template<unsigned int N>
+	inline unsigned int const FRayPacket<N>::intersect(Float3 const& p0, Float3 const& p1, Float3 const& p2, unsigned int const& primitive, unsigned int const& mask) noexcept {
+		float const e1x = p1.x - p0.x, e1y = p1.y - p0.y, e1z = p1.z - p0.z;
+		float const e2x = p2.x - p0.x, e2y = p2.y - p0.y, e2z = p2.z - p0.z;
+
+		alignas(32) float dist[N];
+		alignas(32) float bu[N];
+		alignas(32) float bv[N];
+		unsigned int hits = 0U;
+		for (unsigned int lane = 0U; lane < N; ++lane) {
+			float const dx = m_direct[0U][lane], dy = m_direct[1U][lane], dz = m_direct[2U][lane];
+			float const px = dy * e2z - dz * e2y;
+			float const py = dz * e2x - dx * e2z;
+			float const pz = dx * e2y - dy * e2x;
+			float const det = e1x * px + e1y * py + e1z * pz;
+			float const inv = det != 0.0f ? 1.0f / det : 0.0f;
+
+			float const tx = m_origin[0U][lane] - p0.x;
+			float const ty = m_origin[1U][lane] - p0.y;
+			float const tz = m_origin[2U][lane] - p0.z;
+			float const u = (tx * px + ty * py + tz * pz) * inv;
+
+			float const qx = ty * e1z - tz * e1y;
+			float const qy = tz * e1x - tx * e1z;
+			float const qz = tx * e1y - ty * e1x;
+			float const v = (dx * qx + dy * qy + dz * qz) * inv;
+			float const t = (e2x * qx + e2y * qy + e2z * qz) * inv;
+
+			bool const hit = det != 0.0f && u >= 0.0f && v >= 0.0f && u + v <= 1.0f && t >= m_near[lane] && t < m_far[lane];
+			hits |= (hit ? 1U : 0U) << lane;
+			dist[lane] = t;
+			bu[lane] = u;
+			bv[lane] = v;
+		}
+
+		hits &= mask;
+		for (unsigned int lane = 0U; lane < N; ++lane) {
+			if ((hits >> lane) & 1U) {
+				m_far[lane] = dist[lane];
+				m_u[lane] = bu[lane];
+				m_v[lane] = bv[lane];
+				m_primitive[lane] = primitive;
+			}
+		}
+		return hits;
+	}
+
+	template<unsigned int N>
+	inline unsigned int const FRayPacket<N>::intersectWatertight(Float3 const& p0, Float3 const& p1, Float3 const& p2, unsigned int const& primitive, unsigned int const& mask) noexcept {
+		unsigned int hits = 0U;
+		for (unsigned int lane = 0U; lane < N; ++lane) {
+			if (((mask >> lane) & 1U) == 0U) {
+				continue;
+			}
+			unsigned int const kx = m_axis[0U][lane], ky = m_axis[1U][lane], kz = m_axis[2U][lane];
+			float const sx = m_shear[0U][lane], sy = m_shear[1U][lane], sz = m_shear[2U][lane];
+
+			//	光線の始点を原点、方向を z 軸とする剪断座標系へ頂点を移す
+			float const az = p0.p[kz] - m_origin[kz][lane];
+			float const bz = p1.p[kz] - m_origin[kz][lane];
+			float const cz = p2.p[kz] - m_origin[kz][lane];
+			float const ax = p0.p[kx] - m_origin[kx][lane] - sx * az;
+			float const ay = p0.p[ky] - m_origin[ky][lane] - sy * az;
+			float const bx = p1.p[kx] - m_origin[kx][lane] - sx * bz;
+			float const by = p1.p[ky] - m_origin[ky][lane] - sy * bz;
+			float const cx = p2.p[kx] - m_origin[kx][lane] - sx * cz;
+			float const cy = p2.p[ky] - m_origin[ky][lane] - sy * cz;
+
+			float u = cx * by - cy * bx;
+			float v = ax * cy - ay * cx;
+			float w = bx * ay - by * ax;
+
+			//	辺上で符号が決まらない場合は倍精度で計算し直す
+			if (u == 0.0f || v == 0.0f || w == 0.0f) {
+				u = static_cast<float>(static_cast<double>(cx) * by - static_cast<double>(cy) * bx);
+				v = static_cast<float>(static_cast<double>(ax) * cy - static_cast<double>(ay) * cx);
+				w = static_cast<float>(static_cast<double>(bx) * ay - static_cast<double>(by) * ax);
+			}
+			if ((u < 0.0f || v < 0.0f || w < 0.0f) && (u > 0.0f || v > 0.0f || w > 0.0f)) {
+				continue;
+			}
+
+			float const det = u + v + w;
+			if (det == 0.0f) {
+				continue;
+			}
+
+			float const t = (u * az + v * bz + w * cz) * sz;
+			float const inv = 1.0f / det;
+			float const dist = t * inv;
+			if (dist < m_near[lane] || dist >= m_far[lane]) {
+				continue;
+			}
+
+			m_far[lane] = dist;
+			m_u[lane] = v * inv;
+			m_v[lane] = w * inv;
+			m_primitive[lane] = primitive;
+			hits |= 1U << lane;
+		}
+		return hits;
+	}
+
+	template<unsigned int N>
+	inline float const FRayPacket<N>::distance(unsigned int const& lane) const noexcept {
+		return m_far[lane];
+	}
+
+	template<unsigned int N>
+	inline Float3 const FRayPacket<N>::barycentric(unsigned int const& lane) const noexcept {
+		return Float3(1.0f - m_u[lane] - m_v[lane], m_u[lane], m_v[lane]);
+	}
+
+	template<unsigned int N>
+	inline unsigned int const FRayPacket<N>::primitive(unsigned int const& lane) const noexcept {
+		return m_primitive[lane];
+	}
+
+	template<unsigned int N>
+	inline float const FRayPacket<N>::minimum(float const& lhs, float const& rhs) noexcept {
+		return lhs < rhs ? lhs : rhs;
+	}
+
+	template<unsigned int N>
+	inline float const FRayPacket<N>::maximum(float const& lhs, float const& rhs) noexcept {
+		return lhs > rhs ? lhs : rhs;
+	}
+}
@@ -0,0 +1,124 @@
+﻿/**	@file	ftribvh.hpp
+ *	@brief	三角形の境界ボリューム階層クラス
+ */
+#pragma once
+#include "structs/t3.hpp"
+#include "math/fvec3.hpp"
+#include "gmtry/fray.hpp"
+#include "gmtry/fraypack.hpp"
+#include <vector>
+
+namespace dlph {
+	//!	@brief	葉に入れる三角形の目安
+	static unsigned int constexpr BVH_LEAF_MAX = 4U;
+	//!	@brief	面積ヒューリスティックの分割候補数
+	static unsigned int constexpr BVH_BIN_CNT = 12U;
+	//!	@brief	走査用スタックの大きさ
+	static unsigned int constexpr BVH_STACK_MAX = 96U;
+
+	/**	@struct	BvhNode
+	 *	@brief	境界ボリューム階層の節点
+	 *	@details	内部節点の左の子は直後の節点、右の子は offset 番目の節点です。
+	 *				葉では offset が先頭の三角形、count が三角形数を表します。
+	 */
+	struct BvhNode final {
+		//!	@brief	箱の最小点
+		Float3 lower;
+		//!	@brief	右の子または先頭の三角形
+		unsigned int offset;
+		//!	@brief	箱の最大点
+		Float3 upper;
+		//!	@brief	三角形数 (0 は内部節点)
+		unsigned short count;
+		//!	@brief	分割軸
+		unsigned short axis;
+	};
+
+	/**	@struct	RayHit
+	 *	@brief	光線の交差情報
+	 */
+	struct RayHit final {
+		//!	@brief	交差距離
+		float distance;
+		//!	@brief	二番目の頂点の重み
+		float u;
+		//!	@brief	三番目の頂点の重み
+		float v;
+		//!	@brief	図形番号 (交差なしは RAY_MISS)
+		unsigned int primitive;
+	};
+
+	/**	@class	FTriangleBvh
+	 *	@brief	三角形の境界ボリューム階層クラス
+	 *	@details	揃った光線束は束ごと、ばらばらな光線列は節点ごとに交差する光線だけを絞り込みながら走査します。
+	 */
+	class FTriangleBvh final {
+	public	:
+		//!	@brief	ムーブコンストラクタ
+		FTriangleBvh(FTriangleBvh&&) noexcept = default;
+		//!	@brief	コピーコンストラクタ
+		FTriangleBvh(FTriangleBvh const&) noexcept = default;
+		//!	@brief	ムーブ代入演算子
+		FTriangleBvh& operator=(FTriangleBvh&&) & noexcept = default;
+		//!	@brief	コピー代入演算子
+		FTriangleBvh& operator=(FTriangleBvh const&) & noexcept = default;
+
+		//!	@brief	デフォルトコンストラクタ
+		FTriangleBvh() noexcept;
+		//!	@brief	デストラクタ
+		~FTriangleBvh() noexcept = default;
+
+		/**	@brief	構築関数 (ビン分割による面積ヒューリスティック)
+		 *	@param[in] positions 頂点座標配列
+		 *	@param[in] indices インデックス配列
+		 *	@param[in] index_count インデックス数
+		 *	@retval true 構築しました。
+		 *	@retval false 三角形がありません。
+		 */
+		bool const init(Float3 const* positions, unsigned int const* indices, size_t const& index_count) noexcept;
+		//!	@brief	終了関数
+		void exit() noexcept;
+
+		/**	@brief	光線束の最近交差判定関数
+		 *	@return 交差したレーンのビットマスク
+		 */
+		template <unsigned int N>
+		unsigned int const intersect(FRayPacket<N>& packet) const noexcept;
+		/**	@brief	光線束の遮蔽判定関数
+		 *	@return 何かに遮られたレーンのビットマスク
+		 */
+		template <unsigned int N>
+		unsigned int const occluded(FRayPacket<N>& packet) const noexcept;
+
+		/**	@brief	光線列の最近交差判定関数
+		 *	@param[in] rays 光線配列 (半径が正なら光線の長さとして扱います)
+		 *	@param[in] count 光線数
+		 *	@param[out] hits 光線ごとの交差情報
+		 */
+		void intersect(FRay<FVector3> const* rays, size_t const& count, RayHit* hits) const noexcept;
+		/**	@brief	光線列の遮蔽判定関数
+		 *	@param[in] rays 光線配列 (半径が正なら光線の長さとして扱います)
+		 *	@param[in] count 光線数
+		 *	@param[out] results 光線ごとの遮蔽結果
+		 */
+		void occluded(FRay<FVector3> const* rays, size_t const& count, bool* results) const noexcept;
+
+		//!	@brief	節点配列取得関数
+		std::vector<BvhNode> const& nodes() const noexcept;
+		//!	@brief	三角形数取得関数
+		size_t const triangleCount() const noexcept;
+
+	private	:
+		//!	@brief	光線列の走査関数
+		void traverse(FRay<FVector3> const* rays, size_t const& count, RayHit* hits, bool* results) const noexcept;
+
+		//!	@brief	節点配列
+		std::vector<BvhNode> m_nodes;
+		//!	@brief	葉の順に並べた三角形の頂点
+		std::vector<Float3> m_triangles;
+		//!	@brief	葉の順に並べた三角形の元の番号
+		std::vector<unsigned int> m_primitives;
+	};
+}
+
+#include "ftribvh.inl"
@@ -0,0 +1,85 @@
+﻿/**	@file	ftribvh.inl
+ *	@brief	三角形の境界ボリューム階層クラス
+ */
+#pragma once
+#include "ftribvh.hpp"
+
+namespace dlph {
+	template<unsigned int N>
+	inline unsigned int const FTriangleBvh::intersect(FRayPacket<N>& packet) const noexcept {
+		unsigned int const mask = packet.active();
+		if (m_nodes.empty() || mask == 0U) {
+			return 0U;
+		}
+
+		unsigned int stack[BVH_STACK_MAX];
+		unsigned int size = 0U;
+		unsigned int hits = 0U;
+		stack[size++] = 0U;
+		while (size > 0U) {
+			unsigned int const index = stack[--size];
+			BvhNode const& node = m_nodes[index];
+			unsigned int const live = packet.intersect(node.lower, node.upper, mask);
+			if (live == 0U) {
+				continue;
+			}
+
+			if (node.count > 0U) {
+				for (unsigned int tri = node.offset; tri < node.offset + node.count; ++tri) {
+					hits |= packet.intersect(m_triangles[tri * T3_CNT + 0U], m_triangles[tri * T3_CNT + 1U], m_triangles[tri * T3_CNT + 2U], m_primitives[tri], live);
+				}
+				continue;
+			}
+
+			//	束の向きから手前になる子を後に積み、先に調べる
+			if (packet.negative(node.axis, live)) {
+				stack[size++] = index + 1U;
+				stack[size++] = node.offset;
+			}
+			else {
+				stack[size++] = node.offset;
+				stack[size++] = index + 1U;
+			}
+		}
+		return hits;
+	}
+
+	template<unsigned int N>
+	inline unsigned int const FTriangleBvh::occluded(FRayPacket<N>& packet) const noexcept {
+		unsigned int mask = packet.active();
+		if (m_nodes.empty() || mask == 0U) {
+			return 0U;
+		}
+
+		unsigned int stack[BVH_STACK_MAX];
+		unsigned int size = 0U;
+		unsigned int hits = 0U;
+		stack[size++] = 0U;
+		while (size > 0U) {
+			unsigned int const index = stack[--size];
+			BvhNode const& node = m_nodes[index];
+			unsigned int live = packet.intersect(node.lower, node.upper, mask);
+			if (live == 0U) {
+				continue;
+			}
+
+			if (node.count > 0U) {
+				//	遮られたレーンは以降の判定から外し、全レーンが遮られたら打ち切る
+				for (unsigned int tri = node.offset; tri < node.offset + node.count && live != 0U; ++tri) {
+					unsigned int const hit = packet.intersect(m_triangles[tri * T3_CNT + 0U], m_triangles[tri * T3_CNT + 1U], m_triangles[tri * T3_CNT + 2U], m_primitives[tri], live);
+					hits |= hit;
+					live &= ~hit;
+					mask &= ~hit;
+				}
+				if (mask == 0U) {
+					break;
+				}
+				continue;
+			}
+
+			stack[size++] = node.offset;
+			stack[size++] = index + 1U;
+		}
+		return hits;
+	}
+}
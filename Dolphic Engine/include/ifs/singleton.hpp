@@ -4,15 +4,17 @@
 #pragma once
 #include "nonmovable.hpp"
 
-namespace {
+namespace dlph {
 	/**	@interface ISingleton
 	 *	@brief シングルトンクラス
+	 *	@details	インスタンスは翻訳単位をまたいで一つにするため、無名名前空間には置きません。
+	 *				派生クラスのデストラクタで exit を呼んでください (基底のデストラクタからは純粋仮想関数を呼べません)。
 	 */
 	template <typename T>
 	class ISingleton : public INonmovable<ISingleton<T>> {
 	public:
 		//!	@brief	デストラクタ
-		virtual ~ISingleton() noexcept { exit(); }
+		virtual ~ISingleton() noexcept {}
 		//!	@brief	インスタンス取得関数
 		static T& getInstance() noexcept {
 			static T result = T();
@@ -0,0 +1,56 @@
+﻿/**	@file	job_deque.hpp
+ *	@brief	ワークスティーリング用の両端キュー
+ */
+#pragma once
+#include "ifs/nonmovable.hpp"
+#include <atomic>
+#include <memory>
+
+namespace dlph {
+	/**	@class	JobDeque<T>
+	 *	@brief	ワークスティーリング用の両端キュー (Chase-Lev 法)
+	 *	@details	所有スレッドだけが末尾へ push / pop し、他のスレッドは先頭から steal します。
+	 *				ロックを使わず、所有スレッドの push / pop は競合が無ければアトミックな読み書きだけで済みます。
+	 *				容量は init で固定し、満杯の push は失敗として扱います (呼び出し側で直接実行してください)。
+	 *				要素はアトミックに読み書きできる型 (ポインタなど) に限ります。
+	 */
+	template <typename T>
+	class JobDeque final :
+		public INonmovable<JobDeque<T>>
+	{
+	public	:
+		//!	@brief	デフォルトコンストラクタ
+		JobDeque() noexcept;
+		//!	@brief	デストラクタ
+		~JobDeque() noexcept;
+
+		/**	@brief	初期化関数
+		 *	@param[in] capacity 容量 (2 のべき乗に切り上げます)
+		 */
+		bool const init(size_t const& capacity) noexcept;
+		//!	@brief	終了関数
+		void exit() noexcept;
+
+		//!	@brief	末尾追加関数 (所有スレッド専用)
+		bool const push(T const& value) noexcept;
+		//!	@brief	末尾取り出し関数 (所有スレッド専用)
+		bool const pop(T& value) noexcept;
+		//!	@brief	先頭取り出し関数 (他のスレッド用)
+		bool const steal(T& value) noexcept;
+
+		//!	@brief	要素数の概算
+		size_t const size() const noexcept;
+
+	private	:
+		//!	@brief	要素
+		std::unique_ptr<std::atomic<T>[]> m_buffer;
+		//!	@brief	容量 - 1
+		long long m_mask;
+		//!	@brief	先頭位置 (盗む側が進めます)
+		alignas(64) std::atomic<long long> m_top;
+		//!	@brief	末尾位置 (所有スレッドだけが書き換えます)
+		alignas(64) std::atomic<long long> m_bottom;
+	};
+}
+
+#include "job_deque.inl"
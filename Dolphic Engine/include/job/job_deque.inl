@@ -0,0 +1,102 @@
+﻿/**	@file	job_deque.inl
+ *	@brief	ワークスティーリング用の両端キュー
+ */
+#pragma once
+#include "job_deque.hpp"
+#include <new>
+
+namespace dlph {
+	template<typename T>
+	inline JobDeque<T>::JobDeque() noexcept :
+		INonmovable<JobDeque<T>>(),
+		m_buffer(),
+		m_mask(0),
+		m_top(0),
+		m_bottom(0)
+	{}
+
+	template<typename T>
+	inline JobDeque<T>::~JobDeque() noexcept {
+		exit();
+	}
+
+	template<typename T>
+	inline bool const JobDeque<T>::init(size_t const& capacity) noexcept {
+		exit();
+
+		size_t size = 1U;
+		while (size < capacity) {
+			size <<= 1U;
+		}
+		m_buffer.reset(new (std::nothrow) std::atomic<T>[size]);
+		if (!m_buffer) {
+			OutputDebugStringA("ERROR : CREATE FAILED JOB DEQUE.\n");
+			return false;
+		}
+		m_mask = static_cast<long long>(size) - 1;
+		return true;
+	}
+
+	template<typename T>
+	inline void JobDeque<T>::exit() noexcept {
+		m_buffer.reset();
+		m_mask = 0;
+		m_top.store(0, std::memory_order_relaxed);
+		m_bottom.store(0, std::memory_order_relaxed);
+	}
+
+	template<typename T>
+	inline bool const JobDeque<T>::push(T const& value) noexcept {
+		long long const bottom = m_bottom.load(std::memory_order_relaxed);
+		long long const top = m_top.load(std::memory_order_acquire);
+		if (bottom - top > m_mask) {
+			return false;
+		}
+		m_buffer[bottom & m_mask].store(value, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		m_bottom.store(bottom + 1, std::memory_order_relaxed);
+		return true;
+	}
+
+	template<typename T>
+	inline bool const JobDeque<T>::pop(T& value) noexcept {
+		long long const bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+		m_bottom.store(bottom, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		long long top = m_top.load(std::memory_order_relaxed);
+
+		if (top > bottom) {
+			//	空だった
+			m_bottom.store(bottom + 1, std::memory_order_relaxed);
+			return false;
+		}
+		value = m_buffer[bottom & m_mask].load(std::memory_order_relaxed);
+		if (top < bottom) {
+			return true;
+		}
+
+		//	最後の一つは盗む側と取り合うため、先頭位置を進められた方が取る
+		bool const won = m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+		m_bottom.store(bottom + 1, std::memory_order_relaxed);
+		return won;
+	}
+
+	template<typename T>
+	inline bool const JobDeque<T>::steal(T& value) noexcept {
+		long long top = m_top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		long long const bottom = m_bottom.load(std::memory_order_acquire);
+		if (top >= bottom) {
+			return false;
+		}
+		value = m_buffer[top & m_mask].load(std::memory_order_relaxed);
+		return m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+	}
+
+	template<typename T>
+	inline size_t const JobDeque<T>::size() const noexcept {
+		long long const bottom = m_bottom.load(std::memory_order_relaxed);
+		long long const top = m_top.load(std::memory_order_relaxed);
+		return bottom > top ? static_cast<size_t>(bottom - top) : 0U;
+	}
+}
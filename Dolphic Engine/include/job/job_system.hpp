@@ -0,0 +1,153 @@
+﻿/**	@file	job_system.hpp
+ *	@brief	ジョブシステム
+ */
+#pragma once
+#include "ifs/singleton.hpp"
+#include "job/job_deque.hpp"
+#include "mem/atomic_pool.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dlph {
+	//!	@brief	ジョブが抱えられる関数オブジェクトのバイト数
+	static size_t constexpr JOB_DATA_SIZE = 96U;
+	//!	@brief	同時に存在できるジョブ数の既定値
+	static size_t constexpr JOB_CAPACITY = 4096U;
+	//!	@brief	スレッド一つあたりの両端キューの容量
+	static size_t constexpr JOB_DEQUE_CAPACITY = 1024U;
+	//!	@brief	自動区間分割でスレッド一つあたりに作る区間数
+	static size_t constexpr JOB_SPLIT_PER_THREAD = 4U;
+
+	/**	@class	JobCounter
+	 *	@brief	ジョブカウンタ
+	 *	@details	発行したジョブの数を数え、全て終わると 0 になります。依存関係の待ち合わせに使います。
+	 */
+	class JobCounter final :
+		public INonmovable<JobCounter>
+	{
+	public	:
+		//!	@brief	デフォルトコンストラクタ
+		JobCounter() noexcept;
+		//!	@brief	デストラクタ
+		~JobCounter() noexcept;
+
+		//!	@brief	加算関数
+		void increment(unsigned int const& count = 1U) noexcept;
+		//!	@brief	減算関数
+		void decrement() noexcept;
+		//!	@brief	残りのジョブ数
+		unsigned int const value() const noexcept;
+		//!	@brief	全て終わったかどうか
+		bool const done() const noexcept;
+
+	private	:
+		//!	@brief	残りのジョブ数
+		std::atomic<unsigned int> m_value;
+	};
+
+	/**	@struct	Job
+	 *	@brief	ジョブ
+	 */
+	struct Job final {
+		//!	@brief	実行関数 (data の関数オブジェクトを呼び出して破棄します)
+		void (*invoke)(void* data) noexcept;
+		//!	@brief	完了時に減らすカウンタ
+		JobCounter* counter;
+		//!	@brief	自身のハンドル
+		Handle32<Job> handle;
+		//!	@brief	関数オブジェクト
+		alignas(16) unsigned char data[JOB_DATA_SIZE];
+	};
+
+	/**	@class	JobSystem
+	 *	@brief	ジョブシステム
+	 *	@details	コア数分のワーカースレッドがそれぞれ両端キューを持ち、空になると他のキューから盗んで実行します。
+	 *				init を呼んだスレッドは 0 番のワーカーとして扱い、wait の間はジョブを実行します。
+	 *				wait は待っている間も他のジョブを実行するため、ジョブの中から別のジョブを待っても停止しません。
+	 */
+	class JobSystem final : public ISingleton<JobSystem> {
+	public	:
+		//!	@brief	デフォルトコンストラクタ
+		JobSystem() noexcept;
+		//!	@brief	デストラクタ
+		~JobSystem() noexcept;
+
+		/**	@brief	初期化関数
+		 *	@param[in] workers ワーカースレッド数 (0 はハードウェアスレッド数 - 1)
+		 *	@param[in] capacity 同時に存在できるジョブ数
+		 */
+		bool const init(size_t const& workers = 0U, size_t const& capacity = JOB_CAPACITY) noexcept;
+		//!	@brief	終了関数 (残っているジョブは呼び出したスレッドで実行します)
+		void exit() noexcept;
+
+		/**	@brief	ジョブ発行関数
+		 *	@details	ジョブを確保できなければ、その場で実行します。
+		 *	@param[in] func 関数オブジェクト
+		 *	@param[in] counter 完了時に減らすカウンタ (発行時に加算します)
+		 */
+		template <typename F>
+		void run(F&& func, JobCounter* const counter = nullptr) noexcept;
+		//!	@brief	待機関数 (カウンタが 0 になるまで他のジョブを実行します)
+		void wait(JobCounter const& counter) noexcept;
+
+		/**	@brief	並列繰り返し関数 (区間の大きさをスレッド数から決めます)
+		 *	@param[in] count 要素数
+		 *	@param[in] func 区間 [begin, end) を処理する関数
+		 */
+		template <typename F>
+		void parallelFor(size_t const& count, F const& func) noexcept;
+		/**	@brief	並列繰り返し関数
+		 *	@param[in] count 要素数
+		 *	@param[in] grain 一区間あたりの最小要素数
+		 *	@param[in] func 区間 [begin, end) を処理する関数
+		 */
+		template <typename F>
+		void parallelFor(size_t const& count, size_t const& grain, F const& func) noexcept;
+
+		//!	@brief	稼働中かどうか
+		bool const running() const noexcept;
+		//!	@brief	ワーカー数 (init を呼んだスレッドを含みます)
+		size_t const workerCount() const noexcept;
+		//!	@brief	現在のスレッドのワーカー番号 (ワーカーでなければ SIZE_MAX)
+		static size_t const workerIndex() noexcept;
+
+	private	:
+		//!	@brief	ジョブ確保関数
+		Job* const allocate(JobCounter* const counter) noexcept;
+		//!	@brief	ジョブ投入関数
+		void submit(Job* const job) noexcept;
+		//!	@brief	ジョブ取得関数 (自身のキュー、外部投入、他のキューの順に探します)
+		bool const take(Job*& job) noexcept;
+		//!	@brief	ジョブ実行関数
+		void execute(Job* const job) noexcept;
+		//!	@brief	ワーカースレッドの処理
+		void work(size_t const& index) noexcept;
+
+		//!	@brief	ジョブ
+		AtomicObjectPool<Job> m_jobs;
+		//!	@brief	ワーカーごとの両端キュー
+		std::vector<std::unique_ptr<JobDeque<Job*>>> m_deques;
+		//!	@brief	ワーカースレッド
+		std::vector<std::thread> m_threads;
+		//!	@brief	ワーカー以外のスレッドから投入されたジョブ
+		std::vector<Job*> m_injected;
+		//!	@brief	外部投入の排他
+		std::mutex m_injectMutex;
+		//!	@brief	待機の排他
+		std::mutex m_sleepMutex;
+		//!	@brief	待機の通知
+		std::condition_variable m_signal;
+		//!	@brief	未取得のジョブ数
+		std::atomic<size_t> m_queued;
+		//!	@brief	待機中のワーカー数
+		std::atomic<size_t> m_sleeping;
+		//!	@brief	稼働中かどうか
+		std::atomic<bool> m_running;
+	};
+}
+
+#include "job_system.inl"
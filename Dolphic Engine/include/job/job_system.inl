@@ -0,0 +1,62 @@
+﻿/**	@file	job_system.inl
+ *	@brief	ジョブシステム
+ */
+#pragma once
+#include "job_system.hpp"
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace dlph {
+	template<typename F>
+	inline void JobSystem::run(F&& func, JobCounter* const counter) noexcept {
+		using Func = std::decay_t<F>;
+		static_assert(sizeof(Func) <= JOB_DATA_SIZE, "Job function object is too large.");
+		static_assert(alignof(Func) <= 16U, "Job function object is over aligned.");
+
+		Job* const job = allocate(counter);
+		if (job == nullptr) {
+			func();
+			if (counter) {
+				counter->decrement();
+			}
+			return;
+		}
+
+		::new (static_cast<void*>(job->data)) Func(std::forward<F>(func));
+		job->invoke = [](void* data) noexcept {
+			Func& target = *static_cast<Func*>(data);
+			target();
+			target.~Func();
+		};
+		submit(job);
+	}
+
+	template<typename F>
+	inline void JobSystem::parallelFor(size_t const& count, F const& func) noexcept {
+		size_t const chunks = workerCount() * JOB_SPLIT_PER_THREAD;
+		parallelFor(count, chunks > 0U ? (count + chunks - 1U) / chunks : count, func);
+	}
+
+	template<typename F>
+	inline void JobSystem::parallelFor(size_t const& count, size_t const& grain, F const& func) noexcept {
+		size_t const step = grain > 0U ? grain : 1U;
+		if (count <= step || !running()) {
+			if (count > 0U) {
+				func(static_cast<size_t>(0U), count);
+			}
+			return;
+		}
+
+		//	最初の区間は呼び出したスレッドで処理し、残りをジョブにする
+		JobCounter counter;
+		for (size_t begin = step; begin < count; begin += step) {
+			size_t const end = begin + step < count ? begin + step : count;
+			run([&func, begin, end]() {
+				func(begin, end);
+			}, &counter);
+		}
+		func(static_cast<size_t>(0U), step);
+		wait(counter);
+	}
+}
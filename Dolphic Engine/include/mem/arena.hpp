@@ -0,0 +1,116 @@
+﻿/**	@file	arena.hpp
+ *	@brief	線形アリーナ
+ */
+#pragma once
+#include "ifs/nonmovable.hpp"
+#include <memory_resource>
+#include <vector>
+
+namespace dlph {
+	/**	@struct	ArenaMark
+	 *	@brief	線形アリーナの巻き戻し位置
+	 */
+	struct ArenaMark final {
+		//!	@brief	確保済みバイト数
+		size_t offset;
+		//!	@brief	上位リソースから確保したブロック数
+		size_t overflow;
+	};
+
+	/**	@class	LinearArena
+	 *	@brief	線形アリーナ
+	 *	@details	先頭から順に切り出すだけの確保器で、個別の解放は行わず reset でまとめて破棄します。
+	 *				std::pmr::memory_resource を継承しているため、std::pmr のコンテナへそのまま渡せます。
+	 *				容量を超えた分は上位リソースから確保し、次の reset で解放します。
+	 *				スレッドセーフではないため、スレッドごとに用意してください。
+	 */
+	class LinearArena final :
+		public std::pmr::memory_resource,
+		public INonmovable<LinearArena>
+	{
+	public	:
+		//!	@brief	デフォルトコンストラクタ
+		LinearArena() noexcept;
+		//!	@brief	デストラクタ
+		~LinearArena() noexcept;
+
+		/**	@brief	初期化関数
+		 *	@param[in] capacity 容量 (バイト数)
+		 *	@param[in] upstream 容量超過時の確保先 (nullptr は new / delete)
+		 */
+		bool const init(size_t const& capacity, std::pmr::memory_resource* upstream = nullptr) noexcept;
+		//!	@brief	終了関数
+		void exit() noexcept;
+
+		//!	@brief	全解放関数
+		void reset() noexcept;
+		//!	@brief	現在位置取得関数
+		ArenaMark const mark() const noexcept;
+		//!	@brief	巻き戻し関数 (位置より後に確保したメモリを全て解放します)
+		void rewind(ArenaMark const& mark) noexcept;
+
+		//!	@brief	使用量取得関数
+		size_t const used() const noexcept;
+		//!	@brief	容量取得関数
+		size_t const capacity() const noexcept;
+		//!	@brief	最大使用量取得関数
+		size_t const peak() const noexcept;
+		//!	@brief	容量超過で上位リソースから確保した累計バイト数取得関数
+		size_t const overflow() const noexcept;
+
+	private	:
+		/**	@struct	Overflow
+		 *	@brief	容量超過時に上位リソースから確保したブロック
+		 */
+		struct Overflow final {
+			//!	@brief	先頭アドレス
+			void* ptr;
+			//!	@brief	バイト数
+			size_t bytes;
+			//!	@brief	アライメント
+			size_t alignment;
+		};
+
+		//!	@brief	確保関数
+		void* do_allocate(size_t bytes, size_t alignment) override;
+		//!	@brief	解放関数 (最後に確保したメモリのみ再利用します)
+		void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+		//!	@brief	同一判定関数
+		bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override;
+
+		//!	@brief	容量超過時の確保先
+		std::pmr::memory_resource* m_upstream;
+		//!	@brief	バッファ
+		unsigned char* m_buffer;
+		//!	@brief	容量
+		size_t m_capacity;
+		//!	@brief	確保済みバイト数
+		size_t m_offset;
+		//!	@brief	最大使用量
+		size_t m_peak;
+		//!	@brief	容量超過の累計バイト数
+		size_t m_overflowBytes;
+		//!	@brief	容量超過時に確保したブロック
+		std::vector<Overflow> m_overflows;
+	};
+
+	/**	@class	ArenaScope
+	 *	@brief	線形アリーナの範囲マーカー
+	 *	@details	生成時の位置を記録し、破棄時にそこまで巻き戻します。関数内の一時領域に使います。
+	 */
+	class ArenaScope final :
+		public INonmovable<ArenaScope>
+	{
+	public	:
+		//!	@brief	コンストラクタ
+		explicit ArenaScope(LinearArena& arena) noexcept;
+		//!	@brief	デストラクタ
+		~ArenaScope() noexcept;
+
+	private	:
+		//!	@brief	対象のアリーナ
+		LinearArena& m_arena;
+		//!	@brief	巻き戻し位置
+		ArenaMark m_mark;
+	};
+}
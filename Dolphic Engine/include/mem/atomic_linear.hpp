@@ -0,0 +1,65 @@
+﻿/**	@file	atomic_linear.hpp
+ *	@brief	スレッドセーフな線形区間確保器
+ */
+#pragma once
+#include "ifs/nonmovable.hpp"
+#include <atomic>
+
+namespace dlph {
+	//!	@brief	確保失敗を表す位置
+	static unsigned long long constexpr LINEAR_INVALID = ~0ULL;
+
+	/**	@class	AtomicLinearAllocator
+	 *	@brief	スレッドセーフな線形区間確保器
+	 *	@details	[0, capacity) の位置を先頭から順に切り出すだけの確保器です。実際のメモリは持ちません。
+	 *				大きさを境界の倍数に切り上げてから一度の fetch_add で進めるため、
+	 *				返す位置は常に境界に揃い、複数のスレッドから同時に呼び出しても止まりません。
+	 *				個別の解放は無く、reset でまとめて空にします。
+	 */
+	class AtomicLinearAllocator final :
+		public INonmovable<AtomicLinearAllocator>
+	{
+	public	:
+		//!	@brief	デフォルトコンストラクタ
+		AtomicLinearAllocator() noexcept;
+		//!	@brief	デストラクタ
+		~AtomicLinearAllocator() noexcept = default;
+
+		/**	@brief	初期化関数
+		 *	@param[in] capacity 容量
+		 *	@param[in] alignment 境界 (2 のべき乗)
+		 */
+		bool const init(unsigned long long const& capacity, unsigned long long const& alignment) noexcept;
+		//!	@brief	終了関数
+		void exit() noexcept;
+
+		/**	@brief	確保関数
+		 *	@param[in] size 大きさ (境界の倍数に切り上げます)
+		 *	@return 先頭位置 (収まらなければ LINEAR_INVALID)
+		 */
+		unsigned long long const allocate(unsigned long long const& size) noexcept;
+		//!	@brief	全解放関数 (他のスレッドが確保していない間に呼び出してください)
+		void reset() noexcept;
+
+		//!	@brief	切り上げた大きさ
+		unsigned long long const align(unsigned long long const& size) const noexcept;
+		//!	@brief	容量
+		unsigned long long const capacity() const noexcept;
+		//!	@brief	境界
+		unsigned long long const alignment() const noexcept;
+		//!	@brief	使用中の大きさ
+		unsigned long long const used() const noexcept;
+		//!	@brief	前回の reset までの最大使用量
+		unsigned long long const peak() const noexcept;
+
+	private	:
+		//!	@brief	次に確保する位置 (容量を超えることがあります)
+		std::atomic<unsigned long long> m_offset;
+		//!	@brief	容量
+		unsigned long long m_capacity;
+		//!	@brief	境界
+		unsigned long long m_alignment;
+		//!	@brief	最大使用量
+		unsigned long long m_peak;
+	};
+}
@@ -0,0 +1,86 @@
+﻿/**	@file	atomic_pool.hpp
+ *	@brief	ロックフリーオブジェクトプール
+ */
+#pragma once
+#include "ifs/nonmovable.hpp"
+#include "mem/handle.hpp"
+#include <atomic>
+#include <memory>
+
+namespace dlph {
+	/**	@class	AtomicObjectPool<T, U>
+	 *	@brief	ロックフリーオブジェクトプール
+	 *	@details	ObjectPool と同じ構成で、空きスロットの連結リストを世代タグ付きの CAS で操作するため複数スレッドから生成・破棄できます。
+	 *				get で得たポインタは、他のスレッドが同じハンドルを破棄するまでの間だけ有効です。
+	 *				init と exit はスレッドセーフではありません。
+	 */
+	template <typename T, typename U = unsigned int>
+	class AtomicObjectPool final :
+		public INonmovable<AtomicObjectPool<T, U>>
+	{
+	public	:
+		//!	@brief	ハンドル
+		using HandleType = Handle<T, U>;
+
+		//!	@brief	デフォルトコンストラクタ
+		AtomicObjectPool() noexcept;
+		//!	@brief	デストラクタ
+		~AtomicObjectPool() noexcept;
+
+		/**	@brief	初期化関数
+		 *	@param[in] capacity スロット数
+		 *	@retval true 初期化しました。
+		 *	@retval false スロット数がハンドルで表せる範囲を超えています。
+		 */
+		bool const init(size_t const& capacity) noexcept;
+		//!	@brief	終了関数 (生存中の対象は全て破棄します)
+		void exit() noexcept;
+
+		/**	@brief	生成関数
+		 *	@return 生成した対象のハンドル (満杯なら無効なハンドル)
+		 */
+		template <typename... Args>
+		HandleType const create(Args&&... args) noexcept;
+		/**	@brief	破棄関数
+		 *	@retval true 破棄しました。
+		 *	@retval false 既に破棄されています。
+		 */
+		bool const destroy(HandleType const& handle) noexcept;
+
+		//!	@brief	対象取得関数 (破棄済みなら nullptr)
+		T* get(HandleType const& handle) const noexcept;
+		//!	@brief	生存判定関数
+		bool const valid(HandleType const& handle) const noexcept;
+
+		//!	@brief	生存数取得関数
+		size_t const size() const noexcept;
+		//!	@brief	スロット数取得関数
+		size_t const capacity() const noexcept;
+
+	private	:
+		//!	@brief	スロット
+		using Storage = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+		//!	@brief	空きスロットの終端
+		static unsigned long long constexpr SLOT_NONE = 0xFFFFFFFFULL;
+
+		//!	@brief	空きスロットの取り出し関数
+		unsigned long long const pop() noexcept;
+		//!	@brief	空きスロットの返却関数
+		void push(unsigned long long const& index) noexcept;
+
+		//!	@brief	対象の領域
+		std::unique_ptr<Storage[]> m_storage;
+		//!	@brief	スロットごとの世代 (奇数が生存中)
+		std::unique_ptr<std::atomic<U>[]> m_generations;
+		//!	@brief	次の空きスロット
+		std::unique_ptr<std::atomic<unsigned int>[]> m_next;
+		//!	@brief	先頭の空きスロット (上位 32 ビットは ABA 対策のタグ)
+		std::atomic<unsigned long long> m_free;
+		//!	@brief	生存数
+		std::atomic<size_t> m_size;
+		//!	@brief	スロット数
+		size_t m_capacity;
+	};
+}
+
+#include "atomic_pool.inl"
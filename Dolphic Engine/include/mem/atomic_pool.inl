@@ -0,0 +1,152 @@
+﻿/**	@file	atomic_pool.inl
+ *	@brief	ロックフリーオブジェクトプール
+ */
+#pragma once
+#include "atomic_pool.hpp"
+#include <new>
+#include <utility>
+
+namespace dlph {
+	template<typename T, typename U>
+	inline AtomicObjectPool<T, U>::AtomicObjectPool() noexcept :
+		INonmovable<AtomicObjectPool<T, U>>(),
+		m_storage(),
+		m_generations(),
+		m_next(),
+		m_free(SLOT_NONE),
+		m_size(0U),
+		m_capacity(0U)
+	{}
+
+	template<typename T, typename U>
+	inline AtomicObjectPool<T, U>::~AtomicObjectPool() noexcept {
+		exit();
+	}
+
+	template<typename T, typename U>
+	inline bool const AtomicObjectPool<T, U>::init(size_t const& capacity) noexcept {
+		exit();
+		if (capacity > static_cast<size_t>(HandleType::INDEX_MASK) || capacity >= SLOT_NONE) {
+			OutputDebugStringA("ERROR : OBJECT POOL CAPACITY EXCEED HANDLE INDEX RANGE.\n");
+			return false;
+		}
+
+		m_storage.reset(new (std::nothrow) Storage[capacity]);
+		m_generations.reset(new (std::nothrow) std::atomic<U>[capacity]);
+		m_next.reset(new (std::nothrow) std::atomic<unsigned int>[capacity]);
+		if (!m_storage || !m_generations || !m_next) {
+			OutputDebugStringA("ERROR : CREATE FAILED OBJECT POOL.\n");
+			exit();
+			return false;
+		}
+
+		for (size_t idx = 0U; idx < capacity; ++idx) {
+			m_generations[idx].store(0U, std::memory_order_relaxed);
+			m_next[idx].store(idx + 1U < capacity ? static_cast<unsigned int>(idx + 1U) : static_cast<unsigned int>(SLOT_NONE), std::memory_order_relaxed);
+		}
+		m_capacity = capacity;
+		m_free.store(capacity > 0U ? 0ULL : SLOT_NONE, std::memory_order_release);
+		return true;
+	}
+
+	template<typename T, typename U>
+	inline void AtomicObjectPool<T, U>::exit() noexcept {
+		for (size_t idx = 0U; idx < m_capacity; ++idx) {
+			if (m_generations[idx].load(std::memory_order_acquire) & 1U) {
+				reinterpret_cast<T*>(&m_storage[idx])->~T();
+			}
+		}
+		m_storage.reset();
+		m_generations.reset();
+		m_next.reset();
+		m_free.store(SLOT_NONE, std::memory_order_relaxed);
+		m_size.store(0U, std::memory_order_relaxed);
+		m_capacity = 0U;
+	}
+
+	template<typename T, typename U>
+	template<typename... Args>
+	inline typename AtomicObjectPool<T, U>::HandleType const AtomicObjectPool<T, U>::create(Args&&... args) noexcept {
+		unsigned long long const index = pop();
+		if (index == SLOT_NONE) {
+			return HandleType();
+		}
+
+		::new (static_cast<void*>(&m_storage[index])) T(std::forward<Args>(args)...);
+
+		//	構築を終えてから世代を奇数へ進め、他のスレッドから見えるようにする
+		U const generation = (m_generations[index].load(std::memory_order_relaxed) + 1U) & HandleType::GENERATION_MASK;
+		m_generations[index].store(generation, std::memory_order_release);
+		m_size.fetch_add(1U, std::memory_order_relaxed);
+		return HandleType::make(static_cast<U>(index), generation);
+	}
+
+	template<typename T, typename U>
+	inline bool const AtomicObjectPool<T, U>::destroy(HandleType const& handle) noexcept {
+		U const index = handle.index();
+		if (index >= m_capacity || (handle.generation() & 1U) == 0U) {
+			return false;
+		}
+
+		//	世代を偶数へ進められたスレッドだけが破棄する
+		U expected = handle.generation();
+		U const next = (expected + 1U) & HandleType::GENERATION_MASK;
+		if (!m_generations[index].compare_exchange_strong(expected, next, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+			return false;
+		}
+
+		reinterpret_cast<T*>(&m_storage[index])->~T();
+		m_size.fetch_sub(1U, std::memory_order_relaxed);
+		push(index);
+		return true;
+	}
+
+	template<typename T, typename U>
+	inline T* AtomicObjectPool<T, U>::get(HandleType const& handle) const noexcept {
+		return valid(handle) ? reinterpret_cast<T*>(&m_storage[handle.index()]) : nullptr;
+	}
+
+	template<typename T, typename U>
+	inline bool const AtomicObjectPool<T, U>::valid(HandleType const& handle) const noexcept {
+		U const index = handle.index();
+		return index < m_capacity && (handle.generation() & 1U) && m_generations[index].load(std::memory_order_acquire) == handle.generation();
+	}
+
+	template<typename T, typename U>
+	inline size_t const AtomicObjectPool<T, U>::size() const noexcept {
+		return m_size.load(std::memory_order_relaxed);
+	}
+
+	template<typename T, typename U>
+	inline size_t const AtomicObjectPool<T, U>::capacity() const noexcept {
+		return m_capacity;
+	}
+
+	template<typename T, typename U>
+	inline unsigned long long const AtomicObjectPool<T, U>::pop() noexcept {
+		unsigned long long head = m_free.load(std::memory_order_acquire);
+		while (true) {
+			unsigned long long const index = head & SLOT_NONE;
+			if (index == SLOT_NONE) {
+				return SLOT_NONE;
+			}
+			unsigned long long const next = m_next[index].load(std::memory_order_relaxed);
+			unsigned long long const desired = (((head >> 32U) + 1U) << 32U) | next;
+			if (m_free.compare_exchange_weak(head, desired, std::memory_order_acq_rel, std::memory_order_acquire)) {
+				return index;
+			}
+		}
+	}
+
+	template<typename T, typename U>
+	inline void AtomicObjectPool<T, U>::push(unsigned long long const& index) noexcept {
+		unsigned long long head = m_free.load(std::memory_order_relaxed);
+		while (true) {
+			m_next[index].store(static_cast<unsigned int>(head & SLOT_NONE), std::memory_order_relaxed);
+			unsigned long long const desired = (((head >> 32U) + 1U) << 32U) | index;
+			if (m_free.compare_exchange_weak(head, desired, std::memory_order_release, std::memory_order_relaxed)) {
+				return;
+			}
+		}
+	}
+}
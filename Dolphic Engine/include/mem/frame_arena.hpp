@@ -0,0 +1,50 @@
+﻿/**	@file	frame_arena.hpp
+ *	@brief	フレームアリーナ
+ */
+#pragma once
+#include "mem/arena.hpp"
+
+namespace dlph {
+	//!	@brief	フレームアリーナのバッファ数
+	static unsigned int constexpr FRAME_ARENA_CNT = 2U;
+
+	/**	@class	FrameArena
+	 *	@brief	フレームアリーナ
+	 *	@details	線形アリーナを二面持ち、フレームごとに切り替えます。
+	 *				切り替え時には二フレーム前に使った面を空にするため、GPU が読み終えるまで残す必要のあるデータを置けます。
+	 *				next は前のフレームの GPU 処理完了 (フェンス待機) 後に呼び出してください。
+	 */
+	class FrameArena final :
+		public INonmovable<FrameArena>
+	{
+	public	:
+		//!	@brief	デフォルトコンストラクタ
+		FrameArena() noexcept;
+		//!	@brief	デストラクタ
+		~FrameArena() noexcept;
+
+		/**	@brief	初期化関数
+		 *	@param[in] capacity 一面あたりの容量 (バイト数)
+		 *	@param[in] upstream 容量超過時の確保先 (nullptr は new / delete)
+		 */
+		bool const init(size_t const& capacity, std::pmr::memory_resource* upstream = nullptr) noexcept;
+		//!	@brief	終了関数
+		void exit() noexcept;
+
+		//!	@brief	フレーム切り替え関数
+		void next() noexcept;
+
+		//!	@brief	現在のフレームのアリーナ取得関数
+		LinearArena& current() noexcept;
+		//!	@brief	前のフレームのアリーナ取得関数
+		LinearArena& previous() noexcept;
+		//!	@brief	フレーム番号取得関数
+		unsigned long long const frame() const noexcept;
+
+	private	:
+		//!	@brief	アリーナ
+		LinearArena m_arenas[FRAME_ARENA_CNT];
+		//!	@brief	フレーム番号
+		unsigned long long m_frame;
+	};
+}
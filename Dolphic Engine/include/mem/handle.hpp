@@ -0,0 +1,62 @@
+﻿/**	@file	handle.hpp
+ *	@brief	世代付きハンドル
+ */
+#pragma once
+#include <type_traits>
+
+namespace dlph {
+	/**	@struct	Handle<T, U>
+	 *	@brief	世代付きハンドル
+	 *	@details	下位ビットにスロット番号、上位ビットに世代を詰めた値です。
+	 *				スロットを再利用すると世代が進むため、破棄済みの対象を指すハンドルを検出できます。
+	 *				世代は生存中が奇数、値 0 は無効なハンドルを表します。型 T は別のプールのハンドルとの取り違えを防ぐ印です。
+	 */
+	template <typename T, typename U = unsigned int>
+	struct Handle final {
+		static_assert(std::is_same<U, unsigned int>::value || std::is_same<U, unsigned long long>::value, "Handle must be 32 or 64 bit.");
+
+		//!	@brief	スロット番号のビット数 (32 ビットは 20 ビット、64 ビットは 32 ビット)
+		static unsigned int constexpr INDEX_BITS = sizeof(U) == 4U ? 20U : 32U;
+		//!	@brief	世代のビット数
+		static unsigned int constexpr GENERATION_BITS = sizeof(U) * 8U - INDEX_BITS;
+		//!	@brief	スロット番号の最大値
+		static U constexpr INDEX_MASK = (static_cast<U>(1U) << INDEX_BITS) - 1U;
+		//!	@brief	世代の最大値
+		static U constexpr GENERATION_MASK = (static_cast<U>(1U) << GENERATION_BITS) - 1U;
+
+		//!	@brief	値
+		U value;
+
+		//!	@brief	生成関数
+		static Handle<T, U> constexpr make(U const& index, U const& generation) noexcept {
+			return { (index & INDEX_MASK) | ((generation & GENERATION_MASK) << INDEX_BITS) };
+		}
+		//!	@brief	スロット番号取得関数
+		U constexpr index() const noexcept {
+			return value & INDEX_MASK;
+		}
+		//!	@brief	世代取得関数
+		U constexpr generation() const noexcept {
+			return (value >> INDEX_BITS) & GENERATION_MASK;
+		}
+		//!	@brief	有効値かどうか (対象が生存しているかは各プールで判定します)
+		explicit constexpr operator bool() const noexcept {
+			return value != 0U;
+		}
+		//!	@brief	等価演算子
+		bool constexpr operator==(Handle<T, U> const& rhs) const noexcept {
+			return value == rhs.value;
+		}
+		//!	@brief	非等価演算子
+		bool constexpr operator!=(Handle<T, U> const& rhs) const noexcept {
+			return value != rhs.value;
+		}
+	};
+
+	//!	@brief	32 ビットのハンドル
+	template <typename T>
+	using Handle32 = Handle<T, unsigned int>;
+	//!	@brief	64 ビットのハンドル
+	template <typename T>
+	using Handle64 = Handle<T, unsigned long long>;
+}
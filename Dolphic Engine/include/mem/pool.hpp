@@ -0,0 +1,86 @@
+﻿/**	@file	pool.hpp
+ *	@brief	オブジェクトプール
+ */
+#pragma once
+#include "ifs/nonmovable.hpp"
+#include "mem/handle.hpp"
+#include <vector>
+
+namespace dlph {
+	/**	@class	ObjectPool<T, U>
+	 *	@brief	オブジェクトプール
+	 *	@details	固定数のスロットを連続した領域に確保し、空きスロットの連結リストで生成・破棄を O(1) で行います。
+	 *				対象はハンドルで参照し、破棄済みのハンドルは get が nullptr を返します。
+	 *				スレッドセーフではありません。複数スレッドから生成・破棄する場合は AtomicObjectPool を使ってください。
+	 */
+	template <typename T, typename U = unsigned int>
+	class ObjectPool final :
+		public INonmovable<ObjectPool<T, U>>
+	{
+	public	:
+		//!	@brief	ハンドル
+		using HandleType = Handle<T, U>;
+
+		//!	@brief	デフォルトコンストラクタ
+		ObjectPool() noexcept;
+		//!	@brief	デストラクタ
+		~ObjectPool() noexcept;
+
+		/**	@brief	初期化関数
+		 *	@param[in] capacity スロット数
+		 *	@retval true 初期化しました。
+		 *	@retval false スロット数がハンドルで表せる範囲を超えています。
+		 */
+		bool const init(size_t const& capacity) noexcept;
+		//!	@brief	終了関数 (生存中の対象は全て破棄します)
+		void exit() noexcept;
+
+		/**	@brief	生成関数
+		 *	@return 生成した対象のハンドル (満杯なら無効なハンドル)
+		 */
+		template <typename... Args>
+		HandleType const create(Args&&... args) noexcept;
+		/**	@brief	破棄関数
+		 *	@retval true 破棄しました。
+		 *	@retval false 既に破棄されています。
+		 */
+		bool const destroy(HandleType const& handle) noexcept;
+
+		//!	@brief	対象取得関数 (破棄済みなら nullptr)
+		T* get(HandleType const& handle) noexcept;
+		//!	@brief	対象取得関数 (破棄済みなら nullptr)
+		T const* get(HandleType const& handle) const noexcept;
+		//!	@brief	生存判定関数
+		bool const valid(HandleType const& handle) const noexcept;
+
+		/**	@brief	全走査関数
+		 *	@param[in] func 生存中の対象ごとに (HandleType, T&) で呼び出す関数
+		 */
+		template <typename F>
+		void forEach(F const& func) noexcept;
+
+		//!	@brief	生存数取得関数
+		size_t const size() const noexcept;
+		//!	@brief	スロット数取得関数
+		size_t const capacity() const noexcept;
+
+	private	:
+		//!	@brief	スロット
+		using Storage = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+		//!	@brief	空きスロットの終端
+		static U constexpr SLOT_NONE = ~static_cast<U>(0U);
+
+		//!	@brief	対象の領域
+		std::vector<Storage> m_storage;
+		//!	@brief	スロットごとの世代 (奇数が生存中)
+		std::vector<U> m_generations;
+		//!	@brief	次の空きスロット
+		std::vector<U> m_next;
+		//!	@brief	先頭の空きスロット
+		U m_free;
+		//!	@brief	生存数
+		size_t m_size;
+	};
+}
+
+#include "pool.inl"
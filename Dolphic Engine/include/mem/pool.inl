@@ -0,0 +1,126 @@
+﻿/**	@file	pool.inl
+ *	@brief	オブジェクトプール
+ */
+#pragma once
+#include "pool.hpp"
+#include <new>
+#include <utility>
+
+namespace dlph {
+	template<typename T, typename U>
+	inline ObjectPool<T, U>::ObjectPool() noexcept :
+		INonmovable<ObjectPool<T, U>>(),
+		m_storage(),
+		m_generations(),
+		m_next(),
+		m_free(SLOT_NONE),
+		m_size(0U)
+	{}
+
+	template<typename T, typename U>
+	inline ObjectPool<T, U>::~ObjectPool() noexcept {
+		exit();
+	}
+
+	template<typename T, typename U>
+	inline bool const ObjectPool<T, U>::init(size_t const& capacity) noexcept {
+		exit();
+		if (capacity > static_cast<size_t>(HandleType::INDEX_MASK)) {
+			OutputDebugStringA("ERROR : OBJECT POOL CAPACITY EXCEED HANDLE INDEX RANGE.\n");
+			return false;
+		}
+
+		m_storage.resize(capacity);
+		m_generations.assign(capacity, 0U);
+		m_next.resize(capacity);
+		for (size_t idx = 0U; idx < capacity; ++idx) {
+			m_next[idx] = idx + 1U < capacity ? static_cast<U>(idx + 1U) : SLOT_NONE;
+		}
+		m_free = capacity > 0U ? 0U : SLOT_NONE;
+		return true;
+	}
+
+	template<typename T, typename U>
+	inline void ObjectPool<T, U>::exit() noexcept {
+		for (size_t idx = 0U; idx < m_generations.size(); ++idx) {
+			if (m_generations[idx] & 1U) {
+				reinterpret_cast<T*>(&m_storage[idx])->~T();
+			}
+		}
+		m_storage.clear();
+		m_generations.clear();
+		m_next.clear();
+		m_free = SLOT_NONE;
+		m_size = 0U;
+	}
+
+	template<typename T, typename U>
+	template<typename... Args>
+	inline typename ObjectPool<T, U>::HandleType const ObjectPool<T, U>::create(Args&&... args) noexcept {
+		if (m_free == SLOT_NONE) {
+			return HandleType();
+		}
+
+		U const index = m_free;
+		m_free = m_next[index];
+		::new (static_cast<void*>(&m_storage[index])) T(std::forward<Args>(args)...);
+
+		//	世代は奇数を生存中とし、ハンドルの世代ビットで折り返しても 0 にならないようにする
+		U& generation = m_generations[index];
+		generation = (generation + 1U) & HandleType::GENERATION_MASK;
+		++m_size;
+		return HandleType::make(index, generation);
+	}
+
+	template<typename T, typename U>
+	inline bool const ObjectPool<T, U>::destroy(HandleType const& handle) noexcept {
+		if (!valid(handle)) {
+			return false;
+		}
+
+		U const index = handle.index();
+		reinterpret_cast<T*>(&m_storage[index])->~T();
+		m_generations[index] = (m_generations[index] + 1U) & HandleType::GENERATION_MASK;
+		m_next[index] = m_free;
+		m_free = index;
+		--m_size;
+		return true;
+	}
+
+	template<typename T, typename U>
+	inline T* ObjectPool<T, U>::get(HandleType const& handle) noexcept {
+		return valid(handle) ? reinterpret_cast<T*>(&m_storage[handle.index()]) : nullptr;
+	}
+
+	template<typename T, typename U>
+	inline T const* ObjectPool<T, U>::get(HandleType const& handle) const noexcept {
+		return valid(handle) ? reinterpret_cast<T const*>(&m_storage[handle.index()]) : nullptr;
+	}
+
+	template<typename T, typename U>
+	inline bool const ObjectPool<T, U>::valid(HandleType const& handle) const noexcept {
+		U const index = handle.index();
+		return index < m_generations.size() && (handle.generation() & 1U) && m_generations[index] == handle.generation();
+	}
+
+	template<typename T, typename U>
+	template<typename F>
+	inline void ObjectPool<T, U>::forEach(F const& func) noexcept {
+		for (size_t idx = 0U; idx < m_generations.size(); ++idx) {
+			U const generation = m_generations[idx];
+			if (generation & 1U) {
+				func(HandleType::make(static_cast<U>(idx), generation), *reinterpret_cast<T*>(&m_storage[idx]));
+			}
+		}
+	}
+
+	template<typename T, typename U>
+	inline size_t const ObjectPool<T, U>::size() const noexcept {
+		return m_size;
+	}
+
+	template<typename T, typename U>
+	inline size_t const ObjectPool<T, U>::capacity() const noexcept {
+		return m_storage.size();
+	}
+}
@@ -0,0 +1,77 @@
+﻿/**	@file	range_alloc.hpp
+ *	@brief	区間確保器
+ */
+#pragma once
+#include <map>
+#include <set>
+#include <utility>
+
+namespace dlph {
+	//!	@brief	確保失敗を表す位置
+	static unsigned int constexpr RANGE_INVALID = ~0U;
+
+	/**	@class	RangeAllocator
+	 *	@brief	区間確保器
+	 *	@details	[0, capacity) の番号から連続した区間を切り出します。実際のメモリは持たず、位置だけを管理します。
+	 *				空き区間は位置順と大きさ順の二つの表で持ち、確保は最も小さく収まる区間から行います (best-fit)。
+	 *				解放した区間は前後の空き区間と結合します。
+	 */
+	class RangeAllocator final {
+	public	:
+		//!	@brief	ムーブコンストラクタ
+		RangeAllocator(RangeAllocator&&) noexcept = default;
+		//!	@brief	コピーコンストラクタ
+		RangeAllocator(RangeAllocator const&) noexcept = default;
+		//!	@brief	ムーブ代入演算子
+		RangeAllocator& operator=(RangeAllocator&&) & noexcept = default;
+		//!	@brief	コピー代入演算子
+		RangeAllocator& operator=(RangeAllocator const&) & noexcept = default;
+
+		//!	@brief	デフォルトコンストラクタ
+		RangeAllocator() noexcept;
+		//!	@brief	デストラクタ
+		~RangeAllocator() noexcept = default;
+
+		//!	@brief	初期化関数
+		bool const init(unsigned int const& capacity) noexcept;
+		//!	@brief	終了関数
+		void exit() noexcept;
+
+		/**	@brief	確保関数
+		 *	@param[in] count 個数
+		 *	@return 先頭位置 (確保できなければ RANGE_INVALID)
+		 */
+		unsigned int const allocate(unsigned int const& count) noexcept;
+		/**	@brief	解放関数
+		 *	@param[in] offset 先頭位置
+		 *	@param[in] count 個数 (確保時と同じ値)
+		 */
+		void release(unsigned int const& offset, unsigned int const& count) noexcept;
+		//!	@brief	全解放関数
+		void reset() noexcept;
+
+		//!	@brief	容量
+		unsigned int const capacity() const noexcept;
+		//!	@brief	使用中の個数
+		unsigned int const used() const noexcept;
+		//!	@brief	最大の空き区間の大きさ
+		unsigned int const largest() const noexcept;
+		//!	@brief	空き区間の数 (断片化の目安)
+		size_t const fragments() const noexcept;
+
+	private	:
+		//!	@brief	空き区間の追加関数
+		void insert(unsigned int const& offset, unsigned int const& count) noexcept;
+		//!	@brief	空き区間の削除関数
+		void erase(std::map<unsigned int, unsigned int>::iterator const& it) noexcept;
+
+		//!	@brief	空き区間 (位置 → 個数)
+		std::map<unsigned int, unsigned int> m_offsets;
+		//!	@brief	空き区間 (個数と位置の組)
+		std::set<std::pair<unsigned int, unsigned int>> m_sizes;
+		//!	@brief	容量
+		unsigned int m_capacity;
+		//!	@brief	使用中の個数
+		unsigned int m_used;
+	};
+}
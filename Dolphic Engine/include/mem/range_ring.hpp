@@ -0,0 +1,63 @@
+﻿/**	@file	range_ring.hpp
+ *	@brief	フレーム単位の環状区間確保器
+ */
+#pragma once
+#include "mem/range_alloc.hpp"
+#include "dlph/dlph_frame_pacer.hpp"
+
+namespace dlph {
+	/**	@class	RangeRing
+	 *	@brief	フレーム単位の環状区間確保器
+	 *	@details	[0, capacity) を環状に使い、フレーム内の一時的な確保を末尾へ積むだけで行います。
+	 *				フレームの終わりに末尾位置を slot ごとに記録し、同じ slot が再び始まったとき (GPU がそのフレームを
+	 *				使い終えたとき) にそこまでをまとめて解放します。区間は途中で折り返さず、収まらなければ先頭から取ります。
+	 */
+	class RangeRing final {
+	public	:
+		//!	@brief	ムーブコンストラクタ
+		RangeRing(RangeRing&&) noexcept = default;
+		//!	@brief	コピーコンストラクタ
+		RangeRing(RangeRing const&) noexcept = default;
+		//!	@brief	ムーブ代入演算子
+		RangeRing& operator=(RangeRing&&) & noexcept = default;
+		//!	@brief	コピー代入演算子
+		RangeRing& operator=(RangeRing const&) & noexcept = default;
+
+		//!	@brief	デフォルトコンストラクタ
+		RangeRing() noexcept;
+		//!	@brief	デストラクタ
+		~RangeRing() noexcept = default;
+
+		//!	@brief	初期化関数
+		bool const init(unsigned int const& capacity) noexcept;
+		//!	@brief	終了関数
+		void exit() noexcept;
+
+		//!	@brief	フレーム開始関数 (前回この slot で確保した区間までを解放します)
+		void begin(unsigned int const& slot) noexcept;
+		//!	@brief	フレーム終了関数 (この slot で確保した末尾を記録します)
+		void end(unsigned int const& slot) noexcept;
+		//!	@brief	全区間の解放関数 (確保した区間を GPU が全て使い終えたと分かっているときだけ呼び出してください)
+		void release() noexcept;
+		/**	@brief	確保関数
+		 *	@param[in] count 個数
+		 *	@return 先頭位置 (空きが無ければ RANGE_INVALID)
+		 */
+		unsigned int const allocate(unsigned int const& count) noexcept;
+
+		//!	@brief	容量
+		unsigned int const capacity() const noexcept;
+		//!	@brief	使用中の個数 (折り返しで捨てた分を含みます)
+		unsigned int const used() const noexcept;
+
+	private	:
+		//!	@brief	slot ごとの末尾位置
+		unsigned long long m_marks[FRAME_LATENCY_MAX];
+		//!	@brief	最も古い使用中の位置 (折り返さない通し番号)
+		unsigned long long m_head;
+		//!	@brief	次に確保する位置 (折り返さない通し番号)
+		unsigned long long m_tail;
+		//!	@brief	容量
+		unsigned int m_capacity;
+	};
+}
@@ -0,0 +1,83 @@
+﻿/**	@file	staging_ring.hpp
+ *	@brief	フェンス値単位の環状区間確保器
+ */
+#pragma once
+#include "cont/ring_buffer.hpp"
+
+namespace dlph {
+	//!	@brief	確保失敗を表す位置
+	static unsigned long long constexpr STAGING_INVALID = ~0ULL;
+	//!	@brief	完了待ちにできる提出の数の既定値
+	static unsigned int constexpr STAGING_MARK_DEFAULT = 64U;
+
+	/**	@class	StagingRing
+	 *	@brief	フェンス値単位の環状区間確保器
+	 *	@details	[0, capacity) を環状に使い、転送元の一時領域を末尾へ積むだけで確保します。
+	 *				提出ごとに close でそこまでの末尾をフェンス値と組にして記録し、retire で到達したフェンス値の分をまとめて解放します。
+	 *				RangeRing がフレームの slot で解放するのに対し、こちらはフレームと無関係に進む転送のためのものです。
+	 *				区間は途中で折り返さず、収まらなければ先頭から取ります。スレッドセーフではありません。
+	 */
+	class StagingRing final {
+	public	:
+		//!	@brief	ムーブコンストラクタ
+		StagingRing(StagingRing&&) noexcept = default;
+		//!	@brief	ムーブ代入演算子
+		StagingRing& operator=(StagingRing&&) & noexcept = default;
+
+		//!	@brief	デフォルトコンストラクタ
+		StagingRing() noexcept;
+		//!	@brief	デストラクタ
+		~StagingRing() noexcept = default;
+
+		/**	@brief	初期化関数
+		 *	@param[in] capacity 容量 (バイト)
+		 *	@param[in] marks 完了待ちにできる提出の数
+		 */
+		bool const init(unsigned long long const& capacity, unsigned int const& marks = STAGING_MARK_DEFAULT) noexcept;
+		//!	@brief	終了関数
+		void exit() noexcept;
+
+		/**	@brief	確保関数
+		 *	@param[in] size 大きさ
+		 *	@param[in] alignment 先頭位置の境界 (2 のべき乗)
+		 *	@return 先頭位置 (空きが無ければ STAGING_INVALID)
+		 */
+		unsigned long long const allocate(unsigned long long const& size, unsigned long long const& alignment = 1U) noexcept;
+		/**	@brief	提出関数 (前回から確保した区間を value に到達したら解放するものとして記録します)
+		 *	@retval true 記録しました (確保が無ければ何もしません)。
+		 *	@retval false 完了待ちの提出が多すぎます。
+		 */
+		bool const close(unsigned long long const& value) noexcept;
+		//!	@brief	解放関数 (completed 以下のフェンス値で記録した区間を解放します)
+		void retire(unsigned long long const& completed) noexcept;
+
+		//!	@brief	容量
+		unsigned long long const capacity() const noexcept;
+		//!	@brief	使用中の大きさ (折り返しで捨てた分を含みます)
+		unsigned long long const used() const noexcept;
+		//!	@brief	完了待ちの提出を記録できるかどうか
+		bool const closable() const noexcept;
+
+	private	:
+		/**	@struct	Mark
+		 *	@brief	提出の記録
+		 */
+		struct Mark final {
+			//!	@brief	提出時の末尾位置
+			unsigned long long tail;
+			//!	@brief	フェンス値
+			unsigned long long value;
+		};
+
+		//!	@brief	完了待ちの提出
+		RingBuffer<Mark> m_marks;
+		//!	@brief	最も古い使用中の位置 (折り返さない通し番号)
+		unsigned long long m_head;
+		//!	@brief	次に確保する位置 (折り返さない通し番号)
+		unsigned long long m_tail;
+		//!	@brief	最後に記録した末尾位置
+		unsigned long long m_closed;
+		//!	@brief	容量
+		unsigned long long m_capacity;
+	};
+}
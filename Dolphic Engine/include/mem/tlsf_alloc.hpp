@@ -0,0 +1,123 @@
+﻿/**	@file	tlsf_alloc.hpp
+ *	@brief	TLSF 区間確保器
+ */
+#pragma once
+#include <vector>
+
+namespace dlph {
+	//!	@brief	確保失敗を表すブロック番号
+	static unsigned int constexpr TLSF_INVALID = ~0U;
+	//!	@brief	第二階層の分割数の対数
+	static unsigned int constexpr TLSF_SL_SHIFT = 5U;
+	//!	@brief	第二階層の分割数
+	static unsigned int constexpr TLSF_SL_COUNT = 1U << TLSF_SL_SHIFT;
+	//!	@brief	第一階層の数 (64 bit の大きさを全て表せる数)
+	static unsigned int constexpr TLSF_FL_COUNT = 64U - TLSF_SL_SHIFT + 1U;
+
+	/**	@class	TlsfAllocator
+	 *	@brief	TLSF (Two-Level Segregated Fit) 区間確保器
+	 *	@details	[0, capacity) のバイト位置から連続した区間を切り出します。実際のメモリは持たないため、
+	 *				GPU のヒープのように CPU から触れない領域の管理に使えます。
+	 *				空きブロックを大きさの二段階の区分ごとのリストに置き、ビットマップの検索だけで確保も解放も定数時間で行います。
+	 *				確保はブロック番号を返し、解放はその番号で行います。
+	 */
+	class TlsfAllocator final {
+	public	:
+		//!	@brief	ムーブコンストラクタ
+		TlsfAllocator(TlsfAllocator&&) noexcept = default;
+		//!	@brief	コピーコンストラクタ
+		TlsfAllocator(TlsfAllocator const&) noexcept = default;
+		//!	@brief	ムーブ代入演算子
+		TlsfAllocator& operator=(TlsfAllocator&&) & noexcept = default;
+		//!	@brief	コピー代入演算子
+		TlsfAllocator& operator=(TlsfAllocator const&) & noexcept = default;
+
+		//!	@brief	デフォルトコンストラクタ
+		TlsfAllocator() noexcept;
+		//!	@brief	デストラクタ
+		~TlsfAllocator() noexcept = default;
+
+		//!	@brief	初期化関数
+		bool const init(unsigned long long const& capacity) noexcept;
+		//!	@brief	終了関数
+		void exit() noexcept;
+
+		/**	@brief	確保関数
+		 *	@param[in] size 大きさ
+		 *	@param[in] alignment 先頭位置の境界 (2 のべき乗)
+		 *	@return ブロック番号 (確保できなければ TLSF_INVALID)
+		 */
+		unsigned int const allocate(unsigned long long const& size, unsigned long long const& alignment = 1U) noexcept;
+		//!	@brief	解放関数
+		void release(unsigned int const& block) noexcept;
+		//!	@brief	全解放関数
+		void reset() noexcept;
+
+		//!	@brief	ブロックの先頭位置
+		unsigned long long const offset(unsigned int const& block) const noexcept;
+		//!	@brief	ブロックの大きさ
+		unsigned long long const size(unsigned int const& block) const noexcept;
+
+		//!	@brief	容量
+		unsigned long long const capacity() const noexcept;
+		//!	@brief	使用中の大きさ
+		unsigned long long const used() const noexcept;
+		//!	@brief	最大の空きブロックの大きさ
+		unsigned long long const largest() const noexcept;
+		//!	@brief	空きブロックの数 (断片化の目安)
+		unsigned int const fragments() const noexcept;
+
+	private	:
+		/**	@struct	Block
+		 *	@brief	ブロック
+		 */
+		struct Block final {
+			//!	@brief	先頭位置
+			unsigned long long offset;
+			//!	@brief	大きさ
+			unsigned long long size;
+			//!	@brief	位置が前のブロック
+			unsigned int prevPhys;
+			//!	@brief	位置が次のブロック
+			unsigned int nextPhys;
+			//!	@brief	空きリストの前 (未使用のブロック番号の連結にも使います)
+			unsigned int prevFree;
+			//!	@brief	空きリストの次
+			unsigned int nextFree;
+			//!	@brief	空きかどうか
+			bool free;
+		};
+
+		//!	@brief	大きさから区分を求める関数
+		static void mapping(unsigned long long const& size, unsigned int& fl, unsigned int& sl) noexcept;
+		//!	@brief	ブロック番号の取得関数
+		unsigned int const acquire() noexcept;
+		//!	@brief	ブロック番号の返却関数
+		void discard(unsigned int const& block) noexcept;
+		//!	@brief	空きリストへの追加関数
+		void insert(unsigned int const& block) noexcept;
+		//!	@brief	空きリストからの削除関数
+		void remove(unsigned int const& block) noexcept;
+		//!	@brief	要求を満たす空きブロックの検索関数
+		unsigned int const find(unsigned long long const& size) const noexcept;
+		//!	@brief	ブロックの分割関数 (先頭から size を残し、残りを空きブロックにします)
+		void split(unsigned int const& block, unsigned long long const& size) noexcept;
+
+		//!	@brief	ブロック
+		std::vector<Block> m_blocks;
+		//!	@brief	空きリストの先頭
+		unsigned int m_heads[TLSF_FL_COUNT][TLSF_SL_COUNT];
+		//!	@brief	第二階層のビットマップ
+		unsigned int m_slBitmaps[TLSF_FL_COUNT];
+		//!	@brief	第一階層のビットマップ
+		unsigned long long m_flBitmap;
+		//!	@brief	未使用のブロック番号の先頭
+		unsigned int m_unused;
+		//!	@brief	空きブロックの数
+		unsigned int m_freeCount;
+		//!	@brief	容量
+		unsigned long long m_capacity;
+		//!	@brief	使用中の大きさ
+		unsigned long long m_used;
+	};
+}
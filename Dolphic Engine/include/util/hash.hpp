@@ -0,0 +1,22 @@
+﻿/**	@file	hash.hpp
+ *	@brief	ハッシュ関数
+ */
+#pragma once
+
+namespace dlph {
+	/**	@brief	バイト列のハッシュ関数 (XXH64 と同じ値を返します)
+	 *	@details	ファイルに保存する識別子に使うため、実行環境によらず同じ値になります (リトルエンディアンを前提とします)。
+	 *	@param[in] data 先頭
+	 *	@param[in] size バイト数
+	 *	@param[in] seed 種
+	 */
+	unsigned long long const hash_bytes(void const* data, size_t const& size, unsigned long long const& seed = 0ULL) noexcept;
+
+	/**	@brief	ハッシュ値の結合関数
+	 *	@param[in] seed 結合先のハッシュ値
+	 *	@param[in] value 結合する値
+	 */
+	unsigned long long const hash_combine(unsigned long long const& seed, unsigned long long const& value) noexcept;
+}
+
+#include "hash.inl"
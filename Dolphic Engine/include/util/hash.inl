@@ -0,0 +1,96 @@
+﻿/**	@file	hash.inl
+ *	@brief	ハッシュ関数
+ */
+#pragma once
+#include "hash.hpp"
+#include <cstring>
+
+namespace dlph {
+	//!	@brief	XXH64 の素数
+	static unsigned long long constexpr HASH_PRIME1 = 0x9E3779B185EBCA87ULL;
+	//!	@brief	XXH64 の素数
+	static unsigned long long constexpr HASH_PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+	//!	@brief	XXH64 の素数
+	static unsigned long long constexpr HASH_PRIME3 = 0x165667B19E3779F9ULL;
+	//!	@brief	XXH64 の素数
+	static unsigned long long constexpr HASH_PRIME4 = 0x85EBCA77C2B2AE63ULL;
+	//!	@brief	XXH64 の素数
+	static unsigned long long constexpr HASH_PRIME5 = 0x27D4EB2F165667C5ULL;
+
+	inline unsigned long long const hash_bytes(void const* data, size_t const& size, unsigned long long const& seed) noexcept {
+		auto const rotl = [](unsigned long long const& value, unsigned int const& bits) noexcept {
+			return (value << bits) | (value >> (64U - bits));
+		};
+		auto const round = [&rotl](unsigned long long acc, unsigned long long const& input) noexcept {
+			acc += input * HASH_PRIME2;
+			acc = rotl(acc, 31U);
+			return acc * HASH_PRIME1;
+		};
+		auto const merge = [&round](unsigned long long acc, unsigned long long const& value) noexcept {
+			acc ^= round(0ULL, value);
+			return acc * HASH_PRIME1 + HASH_PRIME4;
+		};
+		auto const read64 = [](unsigned char const* ptr) noexcept {
+			unsigned long long value;
+			std::memcpy(&value, ptr, sizeof(value));
+			return value;
+		};
+		auto const read32 = [](unsigned char const* ptr) noexcept {
+			unsigned int value;
+			std::memcpy(&value, ptr, sizeof(value));
+			return static_cast<unsigned long long>(value);
+		};
+
+		unsigned char const* ptr = static_cast<unsigned char const*>(data);
+		unsigned char const* const end = ptr + size;
+		unsigned long long hash;
+
+		if (size >= 32U) {
+			//	32 バイトずつ四本の列で混ぜる
+			unsigned long long v1 = seed + HASH_PRIME1 + HASH_PRIME2;
+			unsigned long long v2 = seed + HASH_PRIME2;
+			unsigned long long v3 = seed;
+			unsigned long long v4 = seed - HASH_PRIME1;
+			for (; ptr + 32 <= end; ptr += 32) {
+				v1 = round(v1, read64(ptr));
+				v2 = round(v2, read64(ptr + 8));
+				v3 = round(v3, read64(ptr + 16));
+				v4 = round(v4, read64(ptr + 24));
+			}
+			hash = rotl(v1, 1U) + rotl(v2, 7U) + rotl(v3, 12U) + rotl(v4, 18U);
+			hash = merge(hash, v1);
+			hash = merge(hash, v2);
+			hash = merge(hash, v3);
+			hash = merge(hash, v4);
+		}
+		else {
+			hash = seed + HASH_PRIME5;
+		}
+		hash += static_cast<unsigned long long>(size);
+
+		for (; ptr + 8 <= end; ptr += 8) {
+			hash ^= round(0ULL, read64(ptr));
+			hash = rotl(hash, 27U) * HASH_PRIME1 + HASH_PRIME4;
+		}
+		if (ptr + 4 <= end) {
+			hash ^= read32(ptr) * HASH_PRIME1;
+			hash = rotl(hash, 23U) * HASH_PRIME2 + HASH_PRIME3;
+			ptr += 4;
+		}
+		for (; ptr < end; ++ptr) {
+			hash ^= (*ptr) * HASH_PRIME5;
+			hash = rotl(hash, 11U) * HASH_PRIME1;
+		}
+
+		hash ^= hash >> 33U;
+		hash *= HASH_PRIME2;
+		hash ^= hash >> 29U;
+		hash *= HASH_PRIME3;
+		hash ^= hash >> 32U;
+		return hash;
+	}
+
+	inline unsigned long long const hash_combine(unsigned long long const& seed, unsigned long long const& value) noexcept {
+		return hash_bytes(&value, sizeof(value), seed);
+	}
+}
@@ -0,0 +1,49 @@
+﻿/**	@file	mapped_file.hpp
+ *	@brief	読み込み専用のメモリマップトファイル
+ */
+#pragma once
+#include "ifs/noncopyable.hpp"
+
+namespace dlph {
+	/**	@class	MappedFile
+	 *	@brief	読み込み専用のメモリマップトファイル
+	 *	@details	ファイル全体をアドレス空間に割り当てるだけで読み込みは行わず、触れたページだけを OS が読み込みます。
+	 *				Windows では CreateFileMapping、それ以外では mmap を使います。
+	 */
+	class MappedFile final :
+		public INoncopyable<MappedFile>
+	{
+	public	:
+		//!	@brief	ムーブコンストラクタ
+		MappedFile(MappedFile&& arg) noexcept;
+		//!	@brief	ムーブ代入演算子
+		MappedFile& operator=(MappedFile&& rhs) & noexcept;
+
+		//!	@brief	デフォルトコンストラクタ
+		MappedFile() noexcept;
+		//!	@brief	デストラクタ
+		~MappedFile() noexcept;
+
+		//!	@brief	初期化関数 (空のファイルは失敗として扱います)
+		bool const init(char const* const path) noexcept;
+		//!	@brief	終了関数
+		void exit() noexcept;
+
+		//!	@brief	先頭
+		unsigned char const* const data() const noexcept;
+		//!	@brief	バイト数
+		size_t const size() const noexcept;
+
+	private	:
+		//!	@brief	先頭
+		unsigned char const* m_data;
+		//!	@brief	バイト数
+		size_t m_size;
+#if	defined(_WIN32)
+		//!	@brief	ファイルハンドル
+		HANDLE m_file;
+		//!	@brief	マッピングハンドル
+		HANDLE m_mapping;
+#endif
+	};
+}
@@ -0,0 +1,19 @@
+﻿/**	@file	parallel.hpp
+ *	@brief	並列処理関数群
+ */
+#pragma once
+#include <cstddef>
+
+namespace dlph {
+	/**	@brief	並列繰り返し関数
+	 *	@details	[0, count) を grain 個ずつの区間に分け、ハードウェアスレッド数まで並列に処理します。
+	 *				JobSystem が稼働中ならそのワーカーで処理し、そうでなければその場でスレッドを作ります。
+	 *	@param[in] count 要素数
+	 *	@param[in] grain 一区間あたりの最小要素数
+	 *	@param[in] func 区間 [begin, end) を処理する関数
+	 */
+	template<typename F>
+	void parallel_for(size_t const& count, size_t const& grain, F const& func) noexcept;
+}
+
+#include "parallel.inl"
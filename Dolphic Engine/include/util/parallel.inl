@@ -0,0 +1,51 @@
+﻿/**	@file	parallel.inl
+ *	@brief	並列処理関数群
+ */
+#pragma once
+#include "parallel.hpp"
+#include "job/job_system.hpp"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace dlph {
+	template<typename F>
+	inline void parallel_for(size_t const& count, size_t const& grain, F const& func) noexcept {
+		//	ジョブシステムが動いていれば、スレッドを作らずにワーカーへ振り分ける
+		JobSystem& jobs = JobSystem::getInstance();
+		if (jobs.running()) {
+			jobs.parallelFor(count, grain, func);
+			return;
+		}
+
+		size_t const step = std::max<size_t>(grain, 1U);
+		size_t const chunks = (count + step - 1U) / step;
+		size_t const workers = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1U), chunks);
+
+		if (workers <= 1U) {
+			if (count > 0U) {
+				func(static_cast<size_t>(0U), count);
+			}
+			return;
+		}
+
+		std::atomic<size_t> next(0U);
+		auto const work = [&]() {
+			for (size_t chunk = next.fetch_add(1U); chunk < chunks; chunk = next.fetch_add(1U)) {
+				size_t const begin = chunk * step;
+				func(begin, std::min(begin + step, count));
+			}
+		};
+
+		std::vector<std::thread> threads;
+		threads.reserve(workers - 1U);
+		for (size_t idx = 1U; idx < workers; ++idx) {
+			threads.emplace_back(work);
+		}
+		work();
+		for (std::thread& thread : threads) {
+			thread.join();
+		}
+	}
+}
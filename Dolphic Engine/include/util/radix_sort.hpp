@@ -0,0 +1,29 @@
+﻿/**	@file	radix_sort.hpp
+ *	@brief	基数ソート
+ */
+#pragma once
+#include <cstddef>
+
+namespace dlph {
+	//!	@brief	基数ソートの一桁のビット数
+	static unsigned int constexpr RADIX_SORT_BITS = 8U;
+	//!	@brief	基数ソートの一桁の取り得る値の数
+	static size_t constexpr RADIX_SORT_BUCKETS = static_cast<size_t>(1U) << RADIX_SORT_BITS;
+	//!	@brief	並列に処理する区間一つあたりの最小要素数
+	static size_t constexpr RADIX_SORT_GRAIN = 16384U;
+	//!	@brief	これより少なければ挿入ソートで並べ替える要素数
+	static size_t constexpr RADIX_SORT_SMALL = 64U;
+
+	/**	@brief	基数ソート関数 (安定)
+	 *	@details	下位の桁から RADIX_SORT_BITS ビットずつ並べ替えます。要素数が多ければ区間に分けて
+	 *				度数の集計と振り分けを parallel_for で並列に行います。全要素で値が同じ桁は飛ばします。
+	 *	@param[in] data 並べ替える配列 (結果もここに入ります)
+	 *	@param[in] temp 作業用の配列 (data と同じ要素数)
+	 *	@param[in] count 要素数
+	 *	@param[in] key 要素から符号なし整数のキーを取り出す関数
+	 */
+	template <typename T, typename K>
+	void radix_sort(T* const data, T* const temp, size_t const& count, K const& key) noexcept;
+}
+
+#include "radix_sort.inl"
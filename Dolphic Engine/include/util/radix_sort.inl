@@ -0,0 +1,100 @@
+﻿/**	@file	radix_sort.inl
+ *	@brief	基数ソート
+ */
+#pragma once
+#include "radix_sort.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace dlph {
+	template<typename T, typename K>
+	inline void radix_sort(T* const data, T* const temp, size_t const& count, K const& key) noexcept {
+		using Key = std::decay_t<decltype(key(*data))>;
+		static_assert(std::is_unsigned<Key>::value, "Radix sort key must be unsigned integer.");
+		static unsigned int constexpr PASSES = static_cast<unsigned int>(sizeof(Key) * 8U / RADIX_SORT_BITS);
+		static Key constexpr MASK = static_cast<Key>(RADIX_SORT_BUCKETS - 1U);
+
+		if (count < 2U) {
+			return;
+		}
+		if (count < RADIX_SORT_SMALL) {
+			for (size_t idx = 1U; idx < count; ++idx) {
+				T value = std::move(data[idx]);
+				Key const target = key(value);
+				size_t pos = idx;
+				for (; pos > 0U && target < key(data[pos - 1U]); --pos) {
+					data[pos] = std::move(data[pos - 1U]);
+				}
+				data[pos] = std::move(value);
+			}
+			return;
+		}
+
+		//	区間の数を先に決め、parallel_for が begin / grain 番目の区間として呼ぶことを利用する
+		size_t const workers = std::max(std::thread::hardware_concurrency(), 1U);
+		size_t const grain = std::max(RADIX_SORT_GRAIN, (count + workers - 1U) / workers);
+		size_t const chunks = (count + grain - 1U) / grain;
+
+		//	全要素で値が同じ桁を調べるため、先頭のキーとの差のビットを集める
+		Key const first = key(data[0U]);
+		std::vector<Key> diffs(chunks, static_cast<Key>(0U));
+		parallel_for(count, grain, [&](size_t const& begin, size_t const& end) {
+			Key diff = 0U;
+			for (size_t idx = begin; idx < end; ++idx) {
+				diff |= key(data[idx]) ^ first;
+			}
+			diffs[begin / grain] = diff;
+		});
+		Key diff = 0U;
+		for (Key const& value : diffs) {
+			diff |= value;
+		}
+
+		std::vector<size_t> offsets(chunks * RADIX_SORT_BUCKETS);
+		T* src = data;
+		T* dst = temp;
+		for (unsigned int pass = 0U; pass < PASSES; ++pass) {
+			unsigned int const shift = pass * RADIX_SORT_BITS;
+			if (((diff >> shift) & MASK) == 0U) {
+				continue;
+			}
+
+			parallel_for(count, grain, [&](size_t const& begin, size_t const& end) {
+				size_t* const hist = offsets.data() + begin / grain * RADIX_SORT_BUCKETS;
+				std::fill(hist, hist + RADIX_SORT_BUCKETS, static_cast<size_t>(0U));
+				for (size_t idx = begin; idx < end; ++idx) {
+					++hist[static_cast<size_t>((key(src[idx]) >> shift) & MASK)];
+				}
+			});
+
+			//	桁の値ごとに区間の順で並べ、各区間の書き込み開始位置にする
+			size_t sum = 0U;
+			for (size_t bucket = 0U; bucket < RADIX_SORT_BUCKETS; ++bucket) {
+				for (size_t chunk = 0U; chunk < chunks; ++chunk) {
+					size_t& slot = offsets[chunk * RADIX_SORT_BUCKETS + bucket];
+					size_t const num = slot;
+					slot = sum;
+					sum += num;
+				}
+			}
+
+			parallel_for(count, grain, [&](size_t const& begin, size_t const& end) {
+				size_t* const offset = offsets.data() + begin / grain * RADIX_SORT_BUCKETS;
+				for (size_t idx = begin; idx < end; ++idx) {
+					dst[offset[static_cast<size_t>((key(src[idx]) >> shift) & MASK)]++] = std::move(src[idx]);
+				}
+			});
+			std::swap(src, dst);
+		}
+
+		if (src != data) {
+			parallel_for(count, grain, [&](size_t const& begin, size_t const& end) {
+				std::move(src + begin, src + end, data + begin);
+			});
+		}
+	}
+}
@@ -0,0 +1,188 @@
+﻿/**	@file	vk_cmd_backend.hpp
+ *	@brief	描画コマンド列を Vulkan のコマンドバッファへ変換するバックエンド
+ */
+#pragma once
+#include "ifs/nonmovable.hpp"
+#include "cont/slot_map.hpp"
+#include "dlph/dlph_cmd_stream.hpp"
+#include "dlph/dlph_state_tracker.hpp"
+#include "vk_cmd_list.hpp"
+#include <vector>
+#include <vulkan/vulkan.h>
+
+namespace dlph {
+	/**	@struct	VKStateAccess
+	 *	@brief	リソースの状態に対応する Vulkan の同期の情報
+	 */
+	struct VKStateAccess final {
+		//!	@brief	画像のレイアウト (バッファでは使いません)
+		VkImageLayout layout;
+		//!	@brief	アクセスの種類
+		VkAccessFlags access;
+		//!	@brief	パイプラインステージ
+		VkPipelineStageFlags stages;
+	};
+
+	//!	@brief	描画コマンド列のリソースの状態から Vulkan の同期の情報への変換関数
+	VKStateAccess const to_vk_state(ResourceState const& state) noexcept;
+
+	/**	@struct	VKResourceEntry
+	 *	@brief	リソースハンドルが指す Vulkan のオブジェクト
+	 *	@details	バッファと画像のどちらか一方を設定します。サブリソース番号は Direct3D12 と同じくミップ + 配列番号 x ミップ数です。
+	 */
+	struct VKResourceEntry final {
+		//!	@brief	バッファ (画像なら VK_NULL_HANDLE)
+		VkBuffer buffer;
+		//!	@brief	画像 (バッファなら VK_NULL_HANDLE)
+		VkImage image;
+		//!	@brief	画像のアスペクト
+		VkImageAspectFlags aspect;
+		//!	@brief	画像のミップ数
+		unsigned int mips;
+		//!	@brief	画像の配列数
+		unsigned int layers;
+		//!	@brief	bindResource で結び付ける記述子セット (使わなければ VK_NULL_HANDLE)
+		VkDescriptorSet set;
+	};
+
+	/**	@struct	VKPipelineEntry
+	 *	@brief	パイプラインハンドルが指す Vulkan のオブジェクト
+	 */
+	struct VKPipelineEntry final {
+		//!	@brief	パイプライン
+		VkPipeline pipeline;
+		//!	@brief	パイプラインレイアウト
+		VkPipelineLayout layout;
+		//!	@brief	コンピュート用かどうか
+		bool compute;
+	};
+
+	/**	@class	VKResourceTable
+	 *	@brief	描画コマンド列のハンドルと Vulkan のオブジェクトの対応表
+	 *	@details	登録したオブジェクトの寿命は管理しません。破棄する前に登録を外してください。
+	 *				登録と解除はスレッドセーフではないため、読み込み時など記録していない間に行ってください。
+	 */
+	class VKResourceTable final :
+		public INonmovable<VKResourceTable>
+	{
+	public	:
+		//!	@brief	デフォルトコンストラクタ
+		VKResourceTable() noexcept;
+		//!	@brief	デストラクタ
+		~VKResourceTable() noexcept = default;
+
+		//!	@brief	リソース登録関数
+		RenderResource const registerResource(VKResourceEntry const& entry) noexcept;
+		//!	@brief	リソース登録解除関数
+		void unregisterResource(RenderResource const& handle) noexcept;
+		//!	@brief	リソース取得関数 (無効なハンドルなら nullptr)
+		VKResourceEntry const* const getResource(RenderResource const& handle) const noexcept;
+
+		//!	@brief	パイプライン登録関数
+		RenderPipeline const registerPipeline(VKPipelineEntry const& entry) noexcept;
+		//!	@brief	パイプライン登録解除関数
+		void unregisterPipeline(RenderPipeline const& handle) noexcept;
+		//!	@brief	パイプライン取得関数 (無効なハンドルなら nullptr)
+		VKPipelineEntry const* const getPipeline(RenderPipeline const& handle) const noexcept;
+
+		/**	@brief	定数の記述子セット設定関数
+		 *	@details	binding 0 に VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC の定数バッファを一つ持つセットを渡します。
+		 *				bindConstants のアドレスはこのバッファ内の位置として動的オフセットに使います。
+		 */
+		void setConstants(VkDescriptorSet const& set) noexcept;
+		//!	@brief	定数の記述子セット取得関数
+		VkDescriptorSet getConstants() const noexcept;
+
+		//!	@brief	全登録解除関数
+		void clear() noexcept;
+
+	private	:
+		//!	@brief	リソース
+		SlotMap<VKResourceEntry> m_resources;
+		//!	@brief	パイプライン
+		SlotMap<VKPipelineEntry> m_pipelines;
+		//!	@brief	定数の記述子セット
+		VkDescriptorSet m_constants;
+	};
+
+	/**	@class	VKCommandBackend
+	 *	@brief	描画コマンド列を Vulkan のコマンドバッファへ変換するバックエンド
+	 *	@details	再生一回分の軽いオブジェクトで、記録先のリストごとに作ります。D3D12CommandBackend と同じ対応で、
+	 *				ルート引数の番号は記述子セットの番号として、定数は動的オフセット付きの定数バッファのセットとして、
+	 *				リソースは登録した記述子セットとして結び付けます。頂点の大きさはパイプラインで決まるため使いません。
+	 *				バリアは ResourceStateTracker に溜め、描画、コンピュートシェーダの実行、コピーの直前に一度の vkCmdPipelineBarrier で記録します。
+	 *				分割した遷移は開始を記録せず、終了で遷移前から遷移後への一つのバリアにします。
+	 *				Vulkan ではレンダーパスの中でバリア、コンピュートシェーダの実行、コピーを記録できないため、その前にパスを閉じ、
+	 *				次の描画で渡されたパスを開き直します。再生の後に flush を呼び、末尾に残ったバリアを記録してください。
+	 */
+	class VKCommandBackend final : public IRenderBackend {
+	public	:
+		/**	@brief	コンストラクタ
+		 *	@param[in] table ハンドルの対応表
+		 *	@param[in] list 記録先のコマンドリスト (記録中であること)
+		 *	@param[in] pass 描画の前に開くレンダーパス (内容を残すパスであること、nullptr は開きません)
+		 */
+		VKCommandBackend(VKResourceTable const& table, VKCommandList& list, VkRenderPassBeginInfo const* pass = nullptr) noexcept;
+		//!	@brief	デストラクタ
+		~VKCommandBackend() noexcept = default;
+
+		//!	@brief	描画
+		void draw(DrawCommand const& cmd) noexcept override;
+		//!	@brief	インデックス付き描画
+		void drawIndexed(DrawIndexedCommand const& cmd) noexcept override;
+		//!	@brief	コンピュートシェーダの実行
+		void dispatch(DispatchCommand const& cmd) noexcept override;
+		//!	@brief	パイプラインの設定
+		void setPipeline(SetPipelineCommand const& cmd) noexcept override;
+		//!	@brief	頂点バッファの設定
+		void bindVertexBuffer(BindVertexBufferCommand const& cmd) noexcept override;
+		//!	@brief	インデックスバッファの設定
+		void bindIndexBuffer(BindIndexBufferCommand const& cmd) noexcept override;
+		//!	@brief	定数の設定
+		void bindConstants(BindConstantsCommand const& cmd) noexcept override;
+		//!	@brief	リソースの設定
+		void bindResource(BindResourceCommand const& cmd) noexcept override;
+		//!	@brief	リソースの状態遷移
+		void barrier(BarrierCommand const& cmd) noexcept override;
+		//!	@brief	バッファのコピー
+		void copy(CopyCommand const& cmd) noexcept override;
+
+		//!	@brief	溜めたバリアの記録関数 (バリアがあればレンダーパスを閉じます)
+		void flush() noexcept;
+		//!	@brief	バリアの集計取得関数
+		StateTrackerStats const& barrierStats() const noexcept;
+
+	private	:
+		//!	@brief	描画の準備関数 (溜めたバリアを記録し、レンダーパスを開きます)
+		bool const prepareDraw() noexcept;
+		//!	@brief	レンダーパスの外での処理の準備関数 (パスを閉じ、溜めたバリアを記録します)
+		void prepareOutside() noexcept;
+		//!	@brief	溜めたバリアの記録関数 (レンダーパスの外で呼ぶこと)
+		void record() noexcept;
+		//!	@brief	設定中のパイプラインのバインドポイント
+		VkPipelineBindPoint const bindPoint() const noexcept;
+		//!	@brief	設定中のパイプラインレイアウト
+		VkPipelineLayout const layout() const noexcept;
+
+		//!	@brief	ハンドルの対応表
+		VKResourceTable const& m_table;
+		//!	@brief	記録先のコマンドリスト
+		VKCommandList& m_list;
+		//!	@brief	描画の前に開くレンダーパス
+		VkRenderPassBeginInfo m_pass;
+		//!	@brief	描画の前にレンダーパスを開くかどうか
+		bool m_hasPass;
+		//!	@brief	設定中のグラフィックス用パイプラインレイアウト
+		VkPipelineLayout m_graphicsLayout;
+		//!	@brief	設定中のコンピュート用パイプラインレイアウト
+		VkPipelineLayout m_computeLayout;
+		//!	@brief	設定中のパイプラインがコンピュート用かどうか
+		bool m_compute;
+		//!	@brief	状態追跡器 (リソースハンドルの値で識別します)
+		ResourceStateTracker m_tracker;
+		//!	@brief	記録用の画像のバリア (再確保を避けるため使い回します)
+		std::vector<VkImageMemoryBarrier> m_images;
+		//!	@brief	記録用のバッファのバリア (再確保を避けるため使い回します)
+		std::vector<VkBufferMemoryBarrier> m_buffers;
+	};
+}
@@ -0,0 +1,57 @@
+﻿/**	@file	vk_cmd_list.hpp
+ *	@brief	Vulkan 用のコマンドリスト
+ */
+#pragma once
+#include "ifs/noncopyable.hpp"
+#include "vk_tcmd.hpp"
+#include <vulkan/vulkan.h>
+
+namespace dlph {
+	/**	@class	VKCommandList
+	 *	@brief	Vulkan 用のコマンドリスト
+	 *	@details	コマンドプールを一つずつ持ち、記録の開始ごとにプールごとリセットします (D3D12 のアロケータと同じ扱いです)。
+	 *				CommandListPool に入れるとフレームとスレッドごとにプールが分かれるため、記録中の排他は要りません。
+	 */
+	class VKCommandList final :
+		public INoncopyable<VKCommandList>
+	{
+	public	:
+		//!	@brief	ムーブコンストラクタ
+		VKCommandList(VKCommandList&&) noexcept;
+		//!	@brief	ムーブ代入演算子
+		VKCommandList& operator=(VKCommandList&&) & noexcept;
+
+		//!	@brief	デフォルトコンストラクタ
+		VKCommandList() noexcept;
+		//!	@brief	デストラクタ
+		~VKCommandList() noexcept;
+
+		//!	@brief	初期化関数
+		bool const init(VKCommandType const&) noexcept;
+		//!	@brief	終了関数
+		void exit() noexcept;
+
+		//!	@brief	コマンド記録開始
+		bool const recording() noexcept;
+		//!	@brief	コマンド記録終了 (開いているレンダーパスは閉じます)
+		bool const closing() noexcept;
+
+		//!	@brief	レンダーパス開始関数 (開いているレンダーパスは閉じます)
+		void beginPass(VkRenderPassBeginInfo const& info) noexcept;
+		//!	@brief	レンダーパス終了関数
+		void endPass() noexcept;
+		//!	@brief	レンダーパスの中かどうか
+		bool const inPass() const noexcept;
+
+		//!	@brief	コマンドバッファ取得
+		VkCommandBuffer get() const noexcept;
+
+	private	:
+		//!	@brief	コマンドプール
+		VkCommandPool m_pool;
+		//!	@brief	コマンドバッファ
+		VkCommandBuffer m_list;
+		//!	@brief	レンダーパスの中かどうか
+		bool m_inPass;
+	};
+}
@@ -0,0 +1,75 @@
+﻿/**	@file	vk_cmd_queue.hpp
+ *	@brief	Vulkan 用のコマンドキュー
+ */
+#pragma once
+#include "ifs/noncopyable.hpp"
+#include "vk_tcmd.hpp"
+#include <vulkan/vulkan.h>
+
+namespace dlph {
+	class VKFence;
+
+	/**	@class	VKCommandQueue
+	 *	@brief	Vulkan 用のコマンドキュー
+	 *	@details	VKDevice が作ったキューを種類ごとに使います。提出はタイムラインセマフォの値で同期し、
+	 *				別の種類と同じキューを共有していても VKDevice の排他で守られます。
+	 */
+	class VKCommandQueue final :
+		public INoncopyable<VKCommandQueue>
+	{
+	public	:
+		//!	@brief	ムーブコンストラクタ
+		VKCommandQueue(VKCommandQueue&&) noexcept;
+		//!	@brief	ムーブ代入演算子
+		VKCommandQueue& operator=(VKCommandQueue&&) & noexcept;
+
+		//!	@brief	デフォルトコンストラクタ
+		VKCommandQueue() noexcept;
+		//!	@brief	デストラクタ
+		~VKCommandQueue() noexcept;
+
+		//!	@brief	初期化関数
+		bool const init(VKCommandType const&) noexcept;
+		//!	@brief	終了関数
+		void exit() noexcept;
+
+		/**	@brief	提出関数
+		 *	@param[in] cmds コマンドバッファの配列
+		 *	@param[in] count コマンドバッファ数
+		 *	@param[in] fence 完了時にシグナルするタイムラインセマフォ
+		 *	@param[in] value シグナルする値
+		 *	@param[in] wait 実行前に待つタイムラインセマフォ (nullptr は待ちません)
+		 *	@param[in] waitValue 待つ値
+		 *	@param[in] waitStage 待ちを挟むパイプラインステージ
+		 */
+		bool const submit(VkCommandBuffer const* cmds, unsigned int const& count, VKFence const& fence, uint64_t const& value,
+			VKFence const* wait = nullptr, uint64_t const& waitValue = 0U, VkPipelineStageFlags const& waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT) const noexcept;
+		/**	@brief	表示用の提出関数
+		 *	@details	スワップチェインの画像の獲得を待ち、タイムラインセマフォに加えて表示が待つバイナリセマフォをシグナルします。
+		 *	@param[in] cmds コマンドバッファの配列
+		 *	@param[in] count コマンドバッファ数
+		 *	@param[in] fence 完了時にシグナルするタイムラインセマフォ
+		 *	@param[in] value シグナルする値
+		 *	@param[in] wait 実行前に待つバイナリセマフォ
+		 *	@param[in] waitStage 待ちを挟むパイプラインステージ
+		 *	@param[in] signal 完了時にシグナルするバイナリセマフォ
+		 */
+		bool const submit(VkCommandBuffer const* cmds, unsigned int const& count, VKFence const& fence, uint64_t const& value,
+			VkSemaphore const& wait, VkPipelineStageFlags const& waitStage, VkSemaphore const& signal) const noexcept;
+		//!	@brief	待機関数 (キューの処理が終わるまで待ちます)
+		void waitIdle() const noexcept;
+
+		//!	@brief	キュー取得関数
+		VkQueue get() const noexcept;
+		//!	@brief	種類取得関数
+		VKCommandType const type() const noexcept;
+		//!	@brief	キューファミリー番号取得関数
+		unsigned int const family() const noexcept;
+
+	private	:
+		//!	@brief	コマンドキュー
+		VkQueue m_queue;
+		//!	@brief	種類
+		VKCommandType m_type;
+	};
+}
@@ -0,0 +1,80 @@
+﻿/**	@file	vk_device.hpp
+ *	@brief	Vulkan 用のデバイスクラス
+ */
+#pragma once
+#include "ifs/singleton.hpp"
+#include "vk_tcmd.hpp"
+#include <mutex>
+#include <vulkan/vulkan.h>
+
+namespace dlph {
+	//!	@brief	キューの種類の数
+	static unsigned int constexpr VK_QUEUE_TYPE_CNT = static_cast<unsigned int>(VKCommandType::Count);
+
+	/**	@class	VKDevice
+	 *	@brief	Vulkan 用のデバイスクラス
+	 *	@details	Vulkan 1.2 とタイムラインセマフォに対応した物理デバイスのうち、外付け、内蔵、仮想、CPU の順に選びます。
+	 *				コンピュートとコピーには、専用のキューファミリーがあればそれを、無ければ同じファミリーの別のキューを、
+	 *				それも無ければグラフィックスのキューを共有して割り当てます。
+	 *				共有したキューへの提出は queueMutex で排他してください (VKCommandQueue は内部で排他します)。
+	 *				インスタンスでサーフェスの拡張を有効にしていて、デバイスが VK_KHR_swapchain に対応していれば有効にします。
+	 */
+	class VKDevice final : public ISingleton<VKDevice> {
+	public	:
+		//!	@brief	デフォルトコンストラクタ
+		VKDevice() noexcept;
+		//!	@brief	デストラクタ
+		~VKDevice() noexcept;
+
+		/**	@brief	初期化関数 (VKInstance を初期化してから呼ぶこと)
+		 *	@param[in] name 優先するデバイス名の一部 (nullptr は自動で選びます)
+		 */
+		bool const init(char const* name = nullptr) noexcept;
+		//!	@brief	終了関数
+		void exit() noexcept;
+
+		//!	@brief	論理デバイス取得関数
+		VkDevice get() const noexcept;
+		//!	@brief	物理デバイス取得関数
+		VkPhysicalDevice physical() const noexcept;
+		//!	@brief	キュー取得関数
+		VkQueue queue(VKCommandType const& type) const noexcept;
+		//!	@brief	キューファミリー番号取得関数
+		unsigned int const family(VKCommandType const& type) const noexcept;
+		//!	@brief	キューの排他取得関数 (同じキューを共有する種類同士は同じものを返します)
+		std::mutex& queueMutex(VKCommandType const& type) noexcept;
+		//!	@brief	物理デバイスの情報取得関数
+		VkPhysicalDeviceProperties const& properties() const noexcept;
+		//!	@brief	メモリの情報取得関数
+		VkPhysicalDeviceMemoryProperties const& memoryProperties() const noexcept;
+		//!	@brief	待機関数 (全てのキューの処理が終わるまで待ちます)
+		void waitIdle() const noexcept;
+		//!	@brief	スワップチェインの拡張を有効にしたかどうか
+		bool const presentable() const noexcept;
+
+	private	:
+		//!	@brief	物理デバイスの選択関数
+		bool const select(char const* name) noexcept;
+
+		//!	@brief	物理デバイス
+		VkPhysicalDevice m_physical;
+		//!	@brief	論理デバイス
+		VkDevice m_device;
+		//!	@brief	種類ごとのキュー
+		VkQueue m_queues[VK_QUEUE_TYPE_CNT];
+		//!	@brief	種類ごとのキューファミリー番号
+		unsigned int m_families[VK_QUEUE_TYPE_CNT];
+		//!	@brief	種類ごとのファミリー内のキュー番号
+		unsigned int m_indices[VK_QUEUE_TYPE_CNT];
+		//!	@brief	種類ごとの排他の番号
+		unsigned int m_locks[VK_QUEUE_TYPE_CNT];
+		//!	@brief	キューごとの排他
+		std::mutex m_mutexes[VK_QUEUE_TYPE_CNT];
+		//!	@brief	物理デバイスの情報
+		VkPhysicalDeviceProperties m_properties;
+		//!	@brief	メモリの情報
+		VkPhysicalDeviceMemoryProperties m_memory;
+		//!	@brief	スワップチェインの拡張を有効にしたかどうか
+		bool m_presentable;
+	};
+}
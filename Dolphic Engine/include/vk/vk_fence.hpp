@@ -0,0 +1,55 @@
+﻿/**	@file	vk_fence.hpp
+ *	@brief	Vulkan 用のフェンス (タイムラインセマフォ)
+ */
+#pragma once
+#include "ifs/noncopyable.hpp"
+#include "vk_cmd_queue.hpp"
+#include <vulkan/vulkan.h>
+
+namespace dlph {
+	/**	@class	VKFence
+	 *	@brief	Vulkan 用のフェンス (タイムラインセマフォ)
+	 *	@details	D3D12Fence と同じく単調増加する値で GPU の進み具合を表します。
+	 *				フレームごとの値は FramePacer で割り当て、キューへの提出時にシグナルしてください。
+	 */
+	class VKFence final :
+		public INoncopyable<VKFence>
+	{
+	public	:
+		//!	@brief	ムーブコンストラクタ
+		VKFence(VKFence&&) noexcept;
+		//!	@brief	ムーブ代入演算子
+		VKFence& operator=(VKFence&&) & noexcept;
+
+		//!	@brief	デフォルトコンストラクタ
+		VKFence() noexcept;
+		//!	@brief	デストラクタ
+		~VKFence() noexcept;
+
+		/**	@brief	初期化関数
+		 *	@param[in] initial 初期値
+		 */
+		bool const init(uint64_t const& initial = 0U) noexcept;
+		//!	@brief	終了関数
+		void exit() noexcept;
+
+		//!	@brief	シグナル発行関数 (キューの処理が全て終わった時点で値を設定します、待機しません)
+		bool const signal(VKCommandQueue const& queue, uint64_t const& value) noexcept;
+		//!	@brief	シグナル発行関数 (CPU から値を設定します)
+		bool const signal(uint64_t const& value) noexcept;
+		/**	@brief	到達待機関数 (GPU が値に到達していなければ待ちます)
+		 *	@param[in] value 待つ値
+		 *	@param[in] timeout 待つ時間の上限 (ナノ秒)
+		 */
+		bool const waitFor(uint64_t const& value, uint64_t const& timeout = ~0ULL) noexcept;
+		//!	@brief	GPU の到達値取得関数
+		uint64_t const completed() const noexcept;
+
+		//!	@brief	取得関数
+		VkSemaphore get() const noexcept;
+
+	private	:
+		//!	@brief	タイムラインセマフォ
+		VkSemaphore m_semaphore;
+	};
+}
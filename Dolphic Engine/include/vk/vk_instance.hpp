@@ -4,11 +4,18 @@
 #pragma once
 #include "ifs/singleton.hpp"
 #include <string>
+#include <vector>
 #include <vulkan/vulkan.h>
 
 namespace dlph {
+	//!	@brief	要求する Vulkan のバージョン (タイムラインセマフォのため 1.2 以上)
+	static unsigned int constexpr VK_INSTANCE_API_VERSION = VK_API_VERSION_1_2;
+
 	/**	@class	VKInstance
 	 *	@brief	Vulkan のインスタンスクラス
+	 *	@details	サーフェスの拡張 (VK_KHR_surface と、Windows のウィンドウ用またはヘッドレスのサーフェス) はあれば有効にし、
+	 *				無くても失敗しないため、ウィンドウの無い環境 (ソフトウェア ICD を含みます) でも作れます。
+	 *				デバッグビルドでは検証レイヤーがあれば有効にします。
 	 */
 	class VKInstance final : public ISingleton<VKInstance> {
 	public	:
@@ -19,9 +26,18 @@ namespace dlph {
 
 		//!	@brief	初期化関数
 		bool const init(std::string const& name) noexcept;
+		//!	@brief	終了関数
+		void exit() noexcept;
+
+		//!	@brief	インスタンス取得関数
+		VkInstance get() const noexcept;
+		//!	@brief	拡張を有効にしたかどうか
+		bool const enabled(char const* name) const noexcept;
 
 	private	:
 		//!	@brief	Vulkan インスタンス
 		VkInstance m_instance;
+		//!	@brief	有効にした拡張
+		std::vector<char const*> m_extensions;
 	};
 }
@@ -0,0 +1,130 @@
+﻿/**	@file	vk_mem_alloc.hpp
+ *	@brief	Vulkan 用の GPU メモリ確保器
+ */
+#pragma once
+#include "ifs/singleton.hpp"
+#include "mem/tlsf_alloc.hpp"
+#include <mutex>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+namespace dlph {
+	//!	@brief	一つのページの大きさ (これを超える要求には専用のページを作ります)
+	static uint64_t constexpr VK_MEMORY_PAGE_SIZE = 64ULL * 1024ULL * 1024ULL;
+
+	/**	@enum	VKMemoryUsage
+	 *	@brief	メモリの用途
+	 */
+	enum class VKMemoryUsage : unsigned char {
+		//!	@brief	GPU のみ (DEVICE_LOCAL)
+		Device = 0U,
+		//!	@brief	CPU から書き込む (HOST_VISIBLE | HOST_COHERENT、常にマップ済み)
+		Upload,
+		//!	@brief	CPU へ読み戻す (HOST_VISIBLE | HOST_COHERENT、HOST_CACHED を優先、常にマップ済み)
+		Readback,
+	};
+
+	/**	@struct	VKAllocation
+	 *	@brief	ページから切り出した GPU メモリ
+	 */
+	struct VKAllocation final {
+		//!	@brief	メモリ (失敗したら VK_NULL_HANDLE)
+		VkDeviceMemory memory;
+		//!	@brief	メモリ内の位置
+		uint64_t offset;
+		//!	@brief	大きさ
+		uint64_t size;
+		//!	@brief	CPU から見た先頭 (マップしていなければ nullptr)
+		void* mapped;
+		//!	@brief	ページの番号
+		unsigned int page;
+		//!	@brief	ページ内のブロック番号
+		unsigned int block;
+	};
+
+	/**	@class	VKMemoryAllocator
+	 *	@brief	Vulkan 用の GPU メモリ確保器
+	 *	@details	VkDeviceMemory を VK_MEMORY_PAGE_SIZE ずつまとめて確保し、TlsfAllocator で切り出して結び付けます。
+	 *				vkAllocateMemory の回数には maxMemoryAllocationCount の上限があるため、それを避けるためのものです。
+	 *				ページはメモリ型と線形かどうか (バッファと線形画像 / 最適タイリング画像) で分けるため、
+	 *				bufferImageGranularity を気にせずに隣り合わせて置けます。CPU から見えるページは確保時にマップしたままにします。
+	 */
+	class VKMemoryAllocator final : public ISingleton<VKMemoryAllocator> {
+	public	:
+		//!	@brief	デフォルトコンストラクタ
+		VKMemoryAllocator() noexcept;
+		//!	@brief	デストラクタ
+		~VKMemoryAllocator() noexcept;
+
+		//!	@brief	初期化関数 (VKDevice を初期化してから呼ぶこと)
+		bool const init() noexcept;
+		//!	@brief	終了関数
+		void exit() noexcept;
+
+		/**	@brief	確保関数
+		 *	@param[in] requirements vkGet*MemoryRequirements で得た要求
+		 *	@param[in] usage 用途
+		 *	@param[in] linear バッファか線形画像かどうか
+		 *	@return 切り出したメモリ (失敗したら memory が VK_NULL_HANDLE)
+		 */
+		VKAllocation const allocate(VkMemoryRequirements const& requirements, VKMemoryUsage const& usage, bool const& linear) noexcept;
+		//!	@brief	解放関数
+		void release(VKAllocation& allocation) noexcept;
+
+		/**	@brief	バッファ生成関数
+		 *	@param[in] bytes 大きさ
+		 *	@param[in] flags 使い道
+		 *	@param[in] usage 用途
+		 *	@param[out] allocation 切り出したメモリ
+		 *	@param[out] buffer 生成したバッファ
+		 *	@retval true 生成に成功しました。
+		 *	@retval false 生成に失敗しました。
+		 */
+		bool const createBuffer(uint64_t const& bytes, VkBufferUsageFlags const& flags, VKMemoryUsage const& usage,
+			VKAllocation& allocation, VkBuffer& buffer) noexcept;
+		/**	@brief	画像生成関数 (DEVICE_LOCAL に置きます)
+		 *	@param[in] info 画像の設定
+		 *	@param[out] allocation 切り出したメモリ
+		 *	@param[out] image 生成した画像
+		 *	@retval true 生成に成功しました。
+		 *	@retval false 生成に失敗しました。
+		 */
+		bool const createImage(VkImageCreateInfo const& info, VKAllocation& allocation, VkImage& image) noexcept;
+		//!	@brief	バッファ破棄関数 (GPU が使い終わってから呼ぶこと)
+		void destroyBuffer(VKAllocation& allocation, VkBuffer& buffer) noexcept;
+		//!	@brief	画像破棄関数 (GPU が使い終わってから呼ぶこと)
+		void destroyImage(VKAllocation& allocation, VkImage& image) noexcept;
+
+		//!	@brief	使用中の大きさ
+		uint64_t const used() noexcept;
+		//!	@brief	確保済みのページの大きさの合計
+		uint64_t const reserved() noexcept;
+
+	private	:
+		/**	@struct	Page
+		 *	@brief	ページ一つ分
+		 */
+		struct Page final {
+			//!	@brief	メモリ
+			VkDeviceMemory memory;
+			//!	@brief	CPU から見た先頭
+			void* mapped;
+			//!	@brief	メモリ型の番号
+			unsigned int type;
+			//!	@brief	線形かどうか
+			bool linear;
+			//!	@brief	切り出し
+			TlsfAllocator blocks;
+		};
+
+		//!	@brief	メモリ型の選択関数 (無ければ ~0U)
+		unsigned int const findType(unsigned int const& bits, VKMemoryUsage const& usage) const noexcept;
+		//!	@brief	ページ生成関数
+		unsigned int const createPage(uint64_t const& size, unsigned int const& type, bool const& linear) noexcept;
+
+		//!	@brief	ページ
+		std::vector<Page> m_pages;
+		//!	@brief	排他
+		std::mutex m_mutex;
+	};
+}
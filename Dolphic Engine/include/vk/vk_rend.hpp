@@ -0,0 +1,184 @@
+﻿/**	@file	vk_rend.hpp
+ *	@brief	Vulkan を利用したレンダラ
+ */
+#pragma once
+#include "ifs/noncopyable.hpp"
+#include "structs/t4.hpp"
+#include "vk_cmd_queue.hpp"
+#include "vk_cmd_list.hpp"
+#include "vk_fence.hpp"
+#include "vk_mem_alloc.hpp"
+#include "vk_swapchain.hpp"
+#include "vk_cmd_backend.hpp"
+#include "dlph/dlph_cmd_pool.hpp"
+#include "dlph/dlph_frame_pacer.hpp"
+
+namespace dlph {
+	//!	@brief	フレームあたりのコマンドリスト数 (記録スレッド数 + 前後処理の 2 本)
+	static unsigned int constexpr VK_CMD_LIST_CNT = 16U;
+	//!	@brief	フレーム末尾のリスト用に予約するコマンドリスト数
+	static unsigned int constexpr VK_CMD_LIST_RESERVED = 1U;
+	//!	@brief	フレーム先頭のコマンドリストの提出順序
+	static unsigned int constexpr VK_ORDER_FIRST = 0U;
+	//!	@brief	フレーム末尾のコマンドリストの提出順序
+	static unsigned int constexpr VK_ORDER_LAST = ~0U;
+	//!	@brief	描画先の色の形式
+	static VkFormat constexpr VK_COLOR_FORMAT = VK_FORMAT_R8G8B8A8_UNORM;
+
+	/**	@struct	VKRendererDesc
+	 *	@brief	Vulkan レンダラ初期化用データ
+	 */
+	struct VKRendererDesc final {
+		//!	@brief	アプリケーション名
+		char const* application;
+		//!	@brief	優先するデバイス名の一部 (nullptr は自動で選びます)
+		char const* device;
+		//!	@brief	描画先の横幅
+		unsigned int width;
+		//!	@brief	描画先の縦幅
+		unsigned int height;
+		//!	@brief	背景色
+		Float4 color;
+		//!	@brief	同時に処理するフレーム数 (1 ～ FRAME_LATENCY_MAX、0 は既定値)
+		unsigned int latency;
+		//!	@brief	スワップチェインへ表示するかどうか
+		bool present;
+		//!	@brief	表示先のウィンドウ (Windows では HWND、nullptr はヘッドレスのサーフェス)
+		void* window;
+		//!	@brief	垂直同期を待つかどうか
+		bool vsync;
+	};
+
+	/**	@class	VKRenderer
+	 *	@brief	Vulkan を利用したレンダラ
+	 *	@details	RGBA8 の色と深度の画像へ描画して、フレームごとに CPU から読める領域へコピーします。
+	 *				フレームの流れは D3D12Renderer と同じで、before_rendering で消去するパスを開き、
+	 *				acquireCmdList で取得したリストは内容を残すパスを開いた状態で渡します。
+	 *				after_rendering でコピーを記録し、提出順序で並べたリストを一度で提出してタイムラインセマフォに値を設定します。
+	 *				表示する場合は after_rendering でスワップチェインの画像を獲得して色を転送し、presenting で表示します。
+	 */
+	class VKRenderer final :
+		public INoncopyable<VKRenderer>
+	{
+	public	:
+		//!	@brief	デフォルトコンストラクタ
+		VKRenderer() noexcept;
+		//!	@brief	デストラクタ
+		~VKRenderer() noexcept;
+
+		//!	@brief	初期化関数
+		bool const init(VKRendererDesc const&) noexcept;
+		//!	@brief	終了関数
+		void exit() noexcept;
+
+		//!	@brief	前レンダリング処理関数
+		bool const before_rendering() noexcept;
+		//!	@brief	後レンダリング処理関数
+		bool const after_rendering() noexcept;
+		//!	@brief	描画処理関数 (表示しない場合は何もしません)
+		bool const presenting() noexcept;
+		/**	@brief	読み戻し関数
+		 *	@details	最後に提出したフレームの完了を待ち、色を行ごとに詰めて書き込みます (横幅 x 縦幅 x 4 バイト)。
+		 *	@param[out] dst 書き込み先
+		 *	@param[in] size 書き込み先の大きさ
+		 */
+		bool const readback(void* dst, size_t const& size) noexcept;
+
+		//!	@brief	コマンドリスト取得関数 (フレーム先頭のリスト)
+		VKCommandList& getCmdList() noexcept;
+		/**	@brief	記録用コマンドリスト取得関数 (スレッドセーフ)
+		 *	@details	内容を残すレンダーパスを開き、ビューポートとシザー矩形を設定済みのリストを返します。
+		 *				リストは after_rendering で順序の小さい順に一度で提出されます。
+		 *	@param[in] order 提出順序 (VK_ORDER_FIRST より大きく VK_ORDER_LAST より小さい、フレーム内で一意の値)
+		 *	@return コマンドリスト (使い切ったら nullptr)
+		 */
+		VKCommandList* const acquireCmdList(unsigned int const& order) noexcept;
+		/**	@brief	描画コマンド列の実行関数 (スレッドセーフ)
+		 *	@details	記録用コマンドリストを取得し、重複した状態設定を取り除きながらコマンド列を再生します。
+		 *				並べ替えは呼び出し側で済ませてください。
+		 *	@param[in] stream 描画コマンド列
+		 *	@param[in] order 提出順序 (acquireCmdList と同じ)
+		 *	@retval true 記録しました。
+		 *	@retval false コマンドリストを使い切りました。
+		 */
+		bool const execute(RenderCommandStream const& stream, unsigned int const& order) noexcept;
+
+		//!	@brief	レンダーパス取得関数 (パイプライン作成用、消去するパスとも互換です)
+		VkRenderPass getRenderPass() const noexcept;
+		//!	@brief	深度の形式取得関数
+		VkFormat const getDepthFormat() const noexcept;
+		//!	@brief	横幅取得関数
+		float const getWidth() const noexcept;
+		//!	@brief	縦幅取得関数
+		float const getHeight() const noexcept;
+		//!	@brief	アスペクト比取得関数
+		float const getAspectRate() const noexcept;
+		//!	@brief	リソースの対応表取得関数 (描画コマンド列のハンドルを登録します)
+		VKResourceTable& getResourceTable() noexcept;
+
+	private	:
+		//!	@brief	描画先の生成関数
+		bool const createTargets() noexcept;
+		//!	@brief	レンダーパスの生成関数
+		bool const createPass(VkAttachmentLoadOp const& load, VkRenderPass& pass) const noexcept;
+		//!	@brief	レンダーパス開始関数
+		void beginPass(VKCommandList& list, VkRenderPass const& pass) noexcept;
+		//!	@brief	レンダーパス開始情報取得関数 (消去する値は設定しません)
+		VkRenderPassBeginInfo const getPassInfo(VkRenderPass const& pass) const noexcept;
+		//!	@brief	スワップチェインへの転送の記録関数 (色は転送元の状態であること)
+		void blitToSwapChain(VKCommandList& list) noexcept;
+		//!	@brief	GPU の全フレーム完了待機関数
+		void flush() noexcept;
+
+		//!	@brief	横幅
+		unsigned int m_width;
+		//!	@brief	縦幅
+		unsigned int m_height;
+		//!	@brief	背景色
+		Float4 m_color;
+		//!	@brief	深度の形式
+		VkFormat m_depthFormat;
+
+		//!	@brief	コマンドキュー
+		VKCommandQueue m_queue;
+		//!	@brief	フレームペーサー
+		FramePacer m_pacer;
+		//!	@brief	フレームごとのコマンドリスト
+		CommandListPool<VKCommandList> m_lists;
+		//!	@brief	フレーム先頭のコマンドリスト
+		VKCommandList* m_list;
+		//!	@brief	フェンス (フレームごとの値は m_pacer が割り当てます)
+		VKFence m_fence;
+
+		//!	@brief	色の画像
+		VkImage m_colorImage;
+		//!	@brief	色の画像のメモリ
+		VKAllocation m_colorMemory;
+		//!	@brief	色の画像のビュー
+		VkImageView m_colorView;
+		//!	@brief	深度の画像
+		VkImage m_depthImage;
+		//!	@brief	深度の画像のメモリ
+		VKAllocation m_depthMemory;
+		//!	@brief	深度の画像のビュー
+		VkImageView m_depthView;
+		//!	@brief	消去するレンダーパス
+		VkRenderPass m_clearPass;
+		//!	@brief	内容を残すレンダーパス
+		VkRenderPass m_loadPass;
+		//!	@brief	フレームバッファ (両方のパスで共用します)
+		VkFramebuffer m_framebuffer;
+		//!	@brief	slot ごとの読み戻し先
+		VkBuffer m_readbacks[FRAME_LATENCY_MAX];
+		//!	@brief	slot ごとの読み戻し先のメモリ
+		VKAllocation m_readbackMemory[FRAME_LATENCY_MAX];
+		//!	@brief	最後に提出したフレームの slot
+		unsigned int m_readSlot;
+		//!	@brief	スワップチェイン
+		VKSwapChain m_chain;
+		//!	@brief	スワップチェインへ表示するかどうか
+		bool m_present;
+		//!	@brief	描画コマンド列のハンドルの対応表
+		VKResourceTable m_resources;
+	};
+}
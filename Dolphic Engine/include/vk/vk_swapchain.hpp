@@ -0,0 +1,107 @@
+﻿/**	@file	vk_swapchain.hpp
+ *	@brief	Vulkan 用のスワップチェイン
+ */
+#pragma once
+#include "ifs/noncopyable.hpp"
+#include "dlph/dlph_frame_pacer.hpp"
+#include "vk_cmd_queue.hpp"
+#include <vector>
+#include <vulkan/vulkan.h>
+
+namespace dlph {
+	/**	@struct	VKSwapChainDesc
+	 *	@brief	Vulkan 用のスワップチェイン生成用データ一式
+	 */
+	struct VKSwapChainDesc final {
+		//!	@brief	表示先のウィンドウ (Windows では HWND、nullptr はヘッドレスのサーフェス)
+		void* window;
+		//!	@brief	横幅 (サーフェスが大きさを決めない場合に使います)
+		unsigned int width;
+		//!	@brief	縦幅 (サーフェスが大きさを決めない場合に使います)
+		unsigned int height;
+		//!	@brief	バッファ数 (サーフェスの範囲に収めます)
+		unsigned int bSize;
+		//!	@brief	垂直同期を待つかどうか
+		bool vsync;
+	};
+
+	/**	@class	VKSwapChain
+	 *	@brief	Vulkan 用のスワップチェイン
+	 *	@details	ウィンドウ (Windows) かヘッドレスのサーフェスを作り、その上にスワップチェインを作ります。
+	 *				画像は転送先として使うため、描画先からコピーして表示します。
+	 *				獲得の完了を知らせるセマフォは slot ごとに、描画の完了を知らせるセマフォは画像ごとに持ちます
+	 *				(表示が終わるまで画像のセマフォは再利用できないため)。
+	 *				獲得や表示でスワップチェインが古くなったと分かれば、次の獲得の前に同じ大きさで作り直します。
+	 */
+	class VKSwapChain final :
+		public INoncopyable<VKSwapChain>
+	{
+	public	:
+		//!	@brief	デフォルトコンストラクタ
+		VKSwapChain() noexcept;
+		//!	@brief	デストラクタ
+		~VKSwapChain() noexcept;
+
+		//!	@brief	初期化関数 (VKDevice を初期化してから呼ぶこと)
+		bool const init(VKSwapChainDesc const&) noexcept;
+		//!	@brief	終了関数
+		void exit() noexcept;
+		//!	@brief	作り直し関数 (GPU の処理が終わるまで待ちます)
+		bool const resize(unsigned int const& width, unsigned int const& height) noexcept;
+
+		/**	@brief	画像の獲得関数
+		 *	@param[in] slot 同時に処理するフレームの番号 (獲得の完了を知らせるセマフォを選びます)
+		 */
+		bool const acquire(unsigned int const& slot) noexcept;
+		/**	@brief	表示関数 (獲得した画像の描画の完了を待って表示します)
+		 *	@param[in] queue 表示に使うキュー (描画を提出したキュー)
+		 */
+		bool const present(VKCommandQueue const& queue) noexcept;
+
+		//!	@brief	獲得の完了を知らせるセマフォ取得関数
+		VkSemaphore acquired(unsigned int const& slot) const noexcept;
+		//!	@brief	獲得した画像の描画の完了を知らせるセマフォ取得関数
+		VkSemaphore rendered() const noexcept;
+		//!	@brief	獲得した画像取得関数
+		VkImage current() const noexcept;
+		//!	@brief	獲得した画像の番号取得関数
+		unsigned int const index() const noexcept;
+		//!	@brief	画像の数取得関数
+		unsigned int const count() const noexcept;
+		//!	@brief	画像の形式取得関数
+		VkFormat const format() const noexcept;
+		//!	@brief	画像の大きさ取得関数
+		VkExtent2D const extent() const noexcept;
+
+	private	:
+		//!	@brief	サーフェスの生成関数
+		bool const createSurface(void* window) noexcept;
+		//!	@brief	スワップチェインの生成関数 (前のものがあれば引き継いで破棄します)
+		bool const create(unsigned int const& width, unsigned int const& height) noexcept;
+		//!	@brief	画像ごとのセマフォの破棄関数
+		void destroySemaphores() noexcept;
+
+		//!	@brief	サーフェス
+		VkSurfaceKHR m_surface;
+		//!	@brief	スワップチェイン
+		VkSwapchainKHR m_chain;
+		//!	@brief	画像
+		std::vector<VkImage> m_images;
+		//!	@brief	画像ごとの描画の完了を知らせるセマフォ
+		std::vector<VkSemaphore> m_rendered;
+		//!	@brief	slot ごとの獲得の完了を知らせるセマフォ
+		VkSemaphore m_acquired[FRAME_LATENCY_MAX];
+		//!	@brief	画像の形式
+		VkFormat m_format;
+		//!	@brief	画像の大きさ
+		VkExtent2D m_extent;
+		//!	@brief	要求したバッファ数
+		unsigned int m_bufferCount;
+		//!	@brief	獲得した画像の番号
+		unsigned int m_index;
+		//!	@brief	垂直同期を待つかどうか
+		bool m_vsync;
+		//!	@brief	作り直しが必要かどうか
+		bool m_stale;
+	};
+}
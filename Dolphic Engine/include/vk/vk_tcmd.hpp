@@ -0,0 +1,20 @@
+﻿/**	@file	vk_tcmd.hpp
+ *	@brief	Vulkan 用のコマンドの種類
+ */
+#pragma once
+
+namespace dlph {
+	/**	@enum	VKCommandType
+	 *	@brief	Vulkan 用のコマンドの種類 (キューの種類)
+	 */
+	enum class VKCommandType : unsigned char {
+		//!	@brief	レンダリング用コマンド
+		Graphics = 0U,
+		//!	@brief	コンピュートシェーダ用コマンド
+		Compute,
+		//!	@brief	リソースコピー用コマンド
+		Transfer,
+		//!	@brief	種類の数
+		Count
+	};
+}
@@ -0,0 +1,656 @@
+﻿/**	@file	clsn_gjk.cpp
+ *	@brief	GJK/EPA 法による凸形状同士の衝突判定
+ */
+#include "clsn/clsn_gjk.hpp"
+#include "clsn/clsn_shape.hpp"
+#include "cont/static_vector.hpp"
+#include <cfloat>
+#include <cmath>
+#include <utility>
+
+namespace {
+	using namespace dlph;
+
+	//!	@brief	GJK 法の最大反復回数
+	static unsigned int constexpr GJK_MAX_ITERATION = 64U;
+	//!	@brief	EPA 法の最大反復回数
+	static unsigned int constexpr EPA_MAX_ITERATION = 64U;
+	//!	@brief	EPA 法の多面体の頂点数の上限 (初期四面体と反復ごとに一点)
+	static size_t constexpr EPA_VERTEX_CAPACITY = EPA_MAX_ITERATION + 4U;
+	//!	@brief	EPA 法の多面体の面数の上限 (凸多面体の面数 2V - 4 に余裕を持たせた数)
+	static size_t constexpr EPA_FACE_CAPACITY = EPA_VERTEX_CAPACITY * 2U;
+	//!	@brief	EPA 法の地平線の辺数の上限
+	static size_t constexpr EPA_EDGE_CAPACITY = EPA_FACE_CAPACITY * 3U;
+	//!	@brief	GJK 法の相対収束判定値
+	static float constexpr GJK_TOLERANCE = 1.0e-6f;
+	//!	@brief	EPA 法の収束判定値
+	static float constexpr EPA_TOLERANCE = 1.0e-4f;
+	//!	@brief	原点一致判定値
+	static float constexpr GJK_ZERO = 1.0e-12f;
+
+	/**	@struct	SimplexVertex
+	 *	@brief	ミンコフスキー差上の頂点
+	 */
+	struct SimplexVertex final {
+		//!	@brief	差分点 (a - b)
+		FVector3 w;
+		//!	@brief	形状 A の支持点
+		FVector3 a;
+		//!	@brief	形状 B の支持点
+		FVector3 b;
+	};
+
+	/**	@struct	Simplex
+	 *	@brief	単体
+	 */
+	struct Simplex final {
+		//!	@brief	頂点
+		SimplexVertex v[4U];
+		//!	@brief	重心座標
+		float lambda[4U];
+		//!	@brief	頂点数
+		unsigned int count;
+	};
+
+	//!	@brief	ミンコフスキー差の支持点取得関数
+	SimplexVertex const support(CollisionShape const& a, CollisionShape const& b, FVector3 const& dir, bool const& core) noexcept {
+		SimplexVertex result;
+		if (core) {
+			result.a = a.supportCore(dir);
+			result.b = b.supportCore(-dir);
+		}
+		else {
+			result.a = a.support(dir);
+			result.b = b.support(-dir);
+		}
+		result.w = result.a - result.b;
+		return result;
+	}
+
+	/**	@brief	三角形上の原点への最近点計算関数
+	 *	@param[in] a, b, c 頂点
+	 *	@param[out] weight 各頂点の重心座標
+	 *	@return	最近点
+	 */
+	FVector3 const closestTriangle(FVector3 const& a, FVector3 const& b, FVector3 const& c, float (&weight)[3U]) noexcept {
+		FVector3 const ab = b - a, ac = c - a;
+		float const d1 = -dot(ab, a), d2 = -dot(ac, a);
+		weight[0U] = weight[1U] = weight[2U] = 0.0f;
+
+		if (d1 <= 0.0f && d2 <= 0.0f) {
+			weight[0U] = 1.0f;
+			return a;
+		}
+
+		float const d3 = -dot(ab, b), d4 = -dot(ac, b);
+		if (d3 >= 0.0f && d4 <= d3) {
+			weight[1U] = 1.0f;
+			return b;
+		}
+
+		float const vc = d1 * d4 - d3 * d2;
+		if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) {
+			float const t = d1 / (d1 - d3);
+			weight[0U] = 1.0f - t;
+			weight[1U] = t;
+			return a + ab * t;
+		}
+
+		float const d5 = -dot(ab, c), d6 = -dot(ac, c);
+		if (d6 >= 0.0f && d5 <= d6) {
+			weight[2U] = 1.0f;
+			return c;
+		}
+
+		float const vb = d5 * d2 - d1 * d6;
+		if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) {
+			float const t = d2 / (d2 - d6);
+			weight[0U] = 1.0f - t;
+			weight[2U] = t;
+			return a + ac * t;
+		}
+
+		float const va = d3 * d6 - d5 * d4;
+		if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+			float const t = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+			weight[1U] = 1.0f - t;
+			weight[2U] = t;
+			return b + (c - b) * t;
+		}
+
+		float const denom = 1.0f / (va + vb + vc);
+		weight[1U] = vb * denom;
+		weight[2U] = vc * denom;
+		weight[0U] = 1.0f - weight[1U] - weight[2U];
+		return a + ab * weight[1U] + ac * weight[2U];
+	}
+
+	//!	@brief	重心座標が正の頂点だけを残す縮退関数
+	void reduce(Simplex& simplex, SimplexVertex const* const* src, float const* weight, unsigned int const& count) noexcept {
+		SimplexVertex temp[4U];
+		float lambda[4U];
+		unsigned int used = 0U;
+		for (unsigned int idx = 0U; idx < count; ++idx) {
+			if (weight[idx] > 0.0f) {
+				temp[used] = *src[idx];
+				lambda[used] = weight[idx];
+				++used;
+			}
+		}
+		for (unsigned int idx = 0U; idx < used; ++idx) {
+			simplex.v[idx] = temp[idx];
+			simplex.lambda[idx] = lambda[idx];
+		}
+		simplex.count = used;
+	}
+
+	/**	@brief	単体上の原点への最近点計算関数
+	 *	@details	最近点を含む最小の部分単体へ縮退させます。
+	 *	@param[in,out] simplex 単体
+	 *	@param[out] inside 原点が四面体の内部にあるかどうか
+	 *	@return	最近点
+	 */
+	FVector3 const solve(Simplex& simplex, bool& inside) noexcept {
+		inside = false;
+		switch (simplex.count) {
+		case 1U:
+			simplex.lambda[0U] = 1.0f;
+			return simplex.v[0U].w;
+		case 2U:
+		{
+			FVector3 const& a = simplex.v[0U].w;
+			FVector3 const ab = simplex.v[1U].w - a;
+			float const len = sqr_magnitude(ab);
+			float const t = len > 0.0f ? -dot(a, ab) / len : 0.0f;
+			if (t <= 0.0f) {
+				simplex.count = 1U;
+				simplex.lambda[0U] = 1.0f;
+				return a;
+			}
+			if (t >= 1.0f) {
+				simplex.v[0U] = simplex.v[1U];
+				simplex.count = 1U;
+				simplex.lambda[0U] = 1.0f;
+				return simplex.v[0U].w;
+			}
+			simplex.lambda[0U] = 1.0f - t;
+			simplex.lambda[1U] = t;
+			return a + ab * t;
+		}
+		case 3U:
+		{
+			float weight[3U];
+			FVector3 const result = closestTriangle(simplex.v[0U].w, simplex.v[1U].w, simplex.v[2U].w, weight);
+			SimplexVertex const* src[3U] = { &simplex.v[0U], &simplex.v[1U], &simplex.v[2U] };
+			reduce(simplex, src, weight, 3U);
+			return result;
+		}
+		case 4U:
+		{
+			//	原点が外側にある面のうち、最も近い面の最近点を採用する
+			static unsigned int constexpr FACE[4U][4U] = {
+				{ 0U, 1U, 2U, 3U },
+				{ 0U, 2U, 3U, 1U },
+				{ 0U, 3U, 1U, 2U },
+				{ 1U, 3U, 2U, 0U }
+			};
+			float best = FLT_MAX;
+			FVector3 result = FVT3_ZERO;
+			float bestWeight[3U] = {};
+			unsigned int bestFace = 4U;
+
+			for (unsigned int f = 0U; f < 4U; ++f) {
+				FVector3 const& a = simplex.v[FACE[f][0U]].w;
+				FVector3 const& b = simplex.v[FACE[f][1U]].w;
+				FVector3 const& c = simplex.v[FACE[f][2U]].w;
+				FVector3 const& d = simplex.v[FACE[f][3U]].w;
+				FVector3 const n = cross(b - a, c - a);
+				float const signOrigin = -dot(n, a);
+				float const signOpposite = dot(n, d - a);
+				if (signOrigin * signOpposite > 0.0f) {
+					continue;
+				}
+				float weight[3U];
+				FVector3 const point = closestTriangle(a, b, c, weight);
+				float const len = sqr_magnitude(point);
+				if (len < best) {
+					best = len;
+					result = point;
+					bestFace = f;
+					bestWeight[0U] = weight[0U];
+					bestWeight[1U] = weight[1U];
+					bestWeight[2U] = weight[2U];
+				}
+			}
+
+			if (bestFace == 4U) {
+				inside = true;
+				return FVT3_ZERO;
+			}
+
+			SimplexVertex const* src[3U] = {
+				&simplex.v[FACE[bestFace][0U]],
+				&simplex.v[FACE[bestFace][1U]],
+				&simplex.v[FACE[bestFace][2U]]
+			};
+			reduce(simplex, src, bestWeight, 3U);
+			return result;
+		}
+		default:
+			return FVT3_ZERO;
+		}
+	}
+
+	/**	@brief	GJK 法本体
+	 *	@param[in] a, b 形状
+	 *	@param[in] core 芯形状で計算するかどうか
+	 *	@param[in] axis 初期探索方向 (A から B へ向かう分離軸)
+	 *	@param[in] separation true の場合は分離が確定した時点で打ち切る
+	 *	@param[out] simplex 終了時の単体
+	 *	@param[out] closest ミンコフスキー差上の原点への最近点
+	 *	@param[out] iteration 反復回数
+	 *	@retval true 重なっています。
+	 *	@retval false 離れています。
+	 */
+	bool const run(
+		CollisionShape const& a, CollisionShape const& b, bool const& core,
+		FVector3 const& axis, bool const& separation,
+		Simplex& simplex, FVector3& closest, unsigned int& iteration
+	) noexcept {
+		FVector3 v = -axis;
+		if (sqr_magnitude(v) <= GJK_ZERO) {
+			v = FVector3(1.0f, 0.0f, 0.0f);
+		}
+		simplex.count = 0U;
+		iteration = 0U;
+
+		while (iteration < GJK_MAX_ITERATION) {
+			++iteration;
+			SimplexVertex const p = support(a, b, -v, core);
+			float const vv = sqr_magnitude(v);
+			float const vw = dot(v, p.w);
+
+			if (separation && vw > 0.0f) {
+				closest = v;
+				return false;
+			}
+			if (simplex.count > 0U && vv - vw <= GJK_TOLERANCE * vv) {
+				break;
+			}
+
+			bool duplicate = false;
+			for (unsigned int idx = 0U; idx < simplex.count; ++idx) {
+				if (sqr_magnitude(simplex.v[idx].w - p.w) <= GJK_ZERO) {
+					duplicate = true;
+					break;
+				}
+			}
+			if (duplicate) {
+				break;
+			}
+
+			simplex.v[simplex.count] = p;
+			++simplex.count;
+
+			bool inside = false;
+			v = solve(simplex, inside);
+			if (inside || sqr_magnitude(v) <= GJK_ZERO) {
+				closest = FVT3_ZERO;
+				return true;
+			}
+		}
+
+		closest = v;
+		return false;
+	}
+
+	//!	@brief	単体上の最近点を形状ごとに復元する関数
+	void witness(Simplex const& simplex, FVector3& pa, FVector3& pb) noexcept {
+		pa = FVT3_ZERO;
+		pb = FVT3_ZERO;
+		for (unsigned int idx = 0U; idx < simplex.count; ++idx) {
+			pa += simplex.v[idx].a * simplex.lambda[idx];
+			pb += simplex.v[idx].b * simplex.lambda[idx];
+		}
+	}
+
+	/**	@struct	EpaFace
+	 *	@brief	EPA 法の多面体の面
+	 */
+	struct EpaFace final {
+		//!	@brief	頂点インデックス
+		unsigned int index[3U];
+		//!	@brief	外向きの単位法線
+		FVector3 normal;
+		//!	@brief	原点からの距離
+		float distance;
+		//!	@brief	有効かどうか
+		bool alive;
+	};
+
+	//!	@brief	EPA 法の面生成関数
+	EpaFace const makeFace(SimplexVertex const* vertices, unsigned int const& a, unsigned int const& b, unsigned int const& c) noexcept {
+		EpaFace result;
+		FVector3 const n = cross(vertices[b].w - vertices[a].w, vertices[c].w - vertices[a].w);
+		float const len = sqrtf(sqr_magnitude(n));
+		result.index[0U] = a;
+		result.index[1U] = b;
+		result.index[2U] = c;
+		result.alive = true;
+		if (len > 0.0f) {
+			result.normal = n / len;
+			result.distance = dot(result.normal, vertices[a].w);
+		}
+		else {
+			result.normal = FVT3_ZERO;
+			result.distance = FLT_MAX;
+		}
+		return result;
+	}
+
+	/**	@brief	EPA 法本体
+	 *	@param[in] a, b 形状
+	 *	@param[in] simplex GJK 法で得た原点を含む単体
+	 *	@param[out] result 計算結果
+	 */
+	void expand(CollisionShape const& a, CollisionShape const& b, Simplex const& simplex, GjkResult& result) noexcept {
+		//	衝突する組ごとに呼ばれるため、作業領域はヒープを使わずスタックに置く
+		StaticVector<SimplexVertex, EPA_VERTEX_CAPACITY> vertices;
+		for (unsigned int idx = 0U; idx < simplex.count; ++idx) {
+			vertices.push_back(simplex.v[idx]);
+		}
+
+		//	単体を四面体まで膨らませる
+		static FVector3 const AXES[6U] = {
+			FVector3( 1.0f,  0.0f,  0.0f), FVector3(-1.0f,  0.0f,  0.0f),
+			FVector3( 0.0f,  1.0f,  0.0f), FVector3( 0.0f, -1.0f,  0.0f),
+			FVector3( 0.0f,  0.0f,  1.0f), FVector3( 0.0f,  0.0f, -1.0f)
+		};
+		if (vertices.size() == 1U) {
+			for (FVector3 const& dir : AXES) {
+				SimplexVertex const p = support(a, b, dir, false);
+				if (sqr_magnitude(p.w - vertices[0U].w) > EPA_TOLERANCE) {
+					vertices.push_back(p);
+					break;
+				}
+			}
+		}
+		if (vertices.size() == 2U) {
+			FVector3 const line = vertices[1U].w - vertices[0U].w;
+			for (FVector3 const& axis : AXES) {
+				FVector3 const dir = cross(line, axis);
+				if (sqr_magnitude(dir) <= GJK_ZERO) {
+					continue;
+				}
+				SimplexVertex const p = support(a, b, dir, false);
+				if (sqr_magnitude(cross(p.w - vertices[0U].w, line)) > EPA_TOLERANCE * sqr_magnitude(line)) {
+					vertices.push_back(p);
+					break;
+				}
+			}
+		}
+		if (vertices.size() == 3U) {
+			FVector3 const n = cross(vertices[1U].w - vertices[0U].w, vertices[2U].w - vertices[0U].w);
+			for (float const& sign : { 1.0f, -1.0f }) {
+				SimplexVertex const p = support(a, b, n * sign, false);
+				if (fabsf(dot(p.w - vertices[0U].w, n)) > EPA_TOLERANCE * sqrtf(sqr_magnitude(n))) {
+					vertices.push_back(p);
+					break;
+				}
+			}
+		}
+
+		result.intersect = true;
+		if (vertices.size() < 4U) {
+			//	退化している場合は表面で接しているものとみなす
+			FVector3 pa, pb;
+			witness(simplex, pa, pb);
+			result.pointA = pa;
+			result.pointB = pb;
+			result.normal = FVT3_ZERO;
+			result.distance = 0.0f;
+			return;
+		}
+
+		StaticVector<EpaFace, EPA_FACE_CAPACITY> faces;
+		static unsigned int constexpr TETRA[4U][4U] = {
+			{ 0U, 1U, 2U, 3U },
+			{ 0U, 3U, 1U, 2U },
+			{ 0U, 2U, 3U, 1U },
+			{ 1U, 3U, 2U, 0U }
+		};
+		for (auto const& tri : TETRA) {
+			EpaFace face = makeFace(vertices.data(), tri[0U], tri[1U], tri[2U]);
+			if (dot(face.normal, vertices[tri[3U]].w - vertices[tri[0U]].w) > 0.0f) {
+				face = makeFace(vertices.data(), tri[0U], tri[2U], tri[1U]);
+			}
+			faces.push_back(face);
+		}
+
+		StaticVector<std::pair<unsigned int, unsigned int>, EPA_EDGE_CAPACITY> edges;
+		size_t closest = 0U;
+		for (unsigned int iteration = 0U; iteration < EPA_MAX_ITERATION; ++iteration) {
+			//	取り除いた面を詰めて、面数を凸多面体の上限に収める
+			size_t alive = 0U;
+			for (size_t idx = 0U; idx < faces.size(); ++idx) {
+				if (faces[idx].alive) {
+					faces[alive++] = faces[idx];
+				}
+			}
+			faces.resize(alive);
+
+			float best = FLT_MAX;
+			for (size_t idx = 0U; idx < faces.size(); ++idx) {
+				if (faces[idx].alive && faces[idx].distance < best) {
+					best = faces[idx].distance;
+					closest = idx;
+				}
+			}
+
+			EpaFace const face = faces[closest];
+			SimplexVertex const p = support(a, b, face.normal, false);
+			if (dot(p.w, face.normal) - face.distance <= EPA_TOLERANCE || vertices.full()) {
+				break;
+			}
+
+			//	新しい頂点から見える面を取り除き、地平線の辺から面を張り直す
+			unsigned int const eye = static_cast<unsigned int>(vertices.size());
+			vertices.push_back(p);
+			edges.clear();
+			bool overflow = false;
+			for (EpaFace& target : faces) {
+				if (!target.alive || dot(target.normal, p.w - vertices[target.index[0U]].w) <= 0.0f) {
+					continue;
+				}
+				target.alive = false;
+				for (unsigned int e = 0U; e < 3U; ++e) {
+					std::pair<unsigned int, unsigned int> const edge(target.index[e], target.index[(e + 1U) % 3U]);
+					bool shared = false;
+					for (size_t idx = 0U; idx < edges.size(); ++idx) {
+						if (edges[idx].first == edge.second && edges[idx].second == edge.first) {
+							edges[idx] = edges.back();
+							edges.pop_back();
+							shared = true;
+							break;
+						}
+					}
+					if (!shared && !edges.push_back(edge)) {
+						overflow = true;
+					}
+				}
+			}
+			for (auto const& edge : edges) {
+				if (!faces.push_back(makeFace(vertices.data(), edge.first, edge.second, eye))) {
+					overflow = true;
+				}
+			}
+			if (overflow) {
+				//	作業領域に収まらないほど細かい多面体は、直前の最近面で打ち切る
+				faces[closest].alive = true;
+				break;
+			}
+		}
+
+		//	原点を最近面へ投影し、重心座標から各形状上の点を復元する
+		EpaFace const& face = faces[closest];
+		FVector3 const& w0 = vertices[face.index[0U]].w;
+		FVector3 const v0 = vertices[face.index[1U]].w - w0;
+		FVector3 const v1 = vertices[face.index[2U]].w - w0;
+		FVector3 const v2 = face.normal * face.distance - w0;
+		float const d00 = dot(v0, v0), d01 = dot(v0, v1), d11 = dot(v1, v1);
+		float const d20 = dot(v2, v0), d21 = dot(v2, v1);
+		float const denom = d00 * d11 - d01 * d01;
+		float u = 1.0f, v = 0.0f, w = 0.0f;
+		if (fabsf(denom) > GJK_ZERO) {
+			v = (d11 * d20 - d01 * d21) / denom;
+			w = (d00 * d21 - d01 * d20) / denom;
+			u = 1.0f - v - w;
+		}
+
+		SimplexVertex const& s0 = vertices[face.index[0U]];
+		SimplexVertex const& s1 = vertices[face.index[1U]];
+		SimplexVertex const& s2 = vertices[face.index[2U]];
+		result.pointA = s0.a * u + s1.a * v + s2.a * w;
+		result.pointB = s0.b * u + s1.b * v + s2.b * w;
+		result.normal = face.normal;
+		result.distance = -face.distance;
+	}
+
+	//!	@brief	キャッシュから初期探索方向を取得する関数
+	FVector3 const initialAxis(CollisionShape const& a, CollisionShape const& b, GjkCache const* cache) noexcept {
+		FVector3 axis;
+		if (cache != nullptr && cache->find(a, b, axis)) {
+			return axis;
+		}
+		return b.position() - a.position();
+	}
+}
+
+namespace dlph {
+	GjkCache::GjkCache() noexcept :
+		m_axes()
+	{}
+
+	bool const GjkCache::find(CollisionShape const& a, CollisionShape const& b, FVector3& axis) const noexcept {
+		auto const it = m_axes.find(key(a, b));
+		if (it == m_axes.end()) {
+			return false;
+		}
+		axis = it->second;
+		if (a.id() > b.id()) {
+			axis = -axis;
+		}
+		return true;
+	}
+
+	void GjkCache::store(CollisionShape const& a, CollisionShape const& b, FVector3 const& axis) noexcept {
+		m_axes[key(a, b)] = a.id() > b.id() ? -axis : axis;
+	}
+
+	void GjkCache::erase(CollisionShape const& a, CollisionShape const& b) noexcept {
+		m_axes.erase(key(a, b));
+	}
+
+	void GjkCache::clear() noexcept {
+		m_axes.clear();
+	}
+
+	size_t const GjkCache::size() const noexcept {
+		return m_axes.size();
+	}
+
+	unsigned long long const GjkCache::key(CollisionShape const& a, CollisionShape const& b) noexcept {
+		unsigned long long const lo = a.id() < b.id() ? a.id() : b.id();
+		unsigned long long const hi = a.id() < b.id() ? b.id() : a.id();
+		return (hi << 32U) | lo;
+	}
+
+	float const distance(CollisionShape const& a, CollisionShape const& b, GjkCache* cache, GjkResult& result) noexcept {
+		Simplex simplex;
+		FVector3 closest, pa, pb;
+		unsigned int iteration = 0U;
+
+		bool const overlap = run(a, b, true, initialAxis(a, b, cache), false, simplex, closest, iteration);
+		witness(simplex, pa, pb);
+
+		float const margin = a.margin() + b.margin();
+		float const core = overlap ? 0.0f : sqrtf(sqr_magnitude(closest));
+		FVector3 const normal = core > 0.0f ? (pb - pa) / core : FVT3_ZERO;
+
+		result.pointA = pa + normal * a.margin();
+		result.pointB = pb - normal * b.margin();
+		result.normal = normal;
+		result.distance = core - margin > 0.0f ? core - margin : 0.0f;
+		result.iteration = iteration;
+		result.intersect = result.distance <= 0.0f;
+
+		if (cache != nullptr && core > 0.0f) {
+			cache->store(a, b, normal);
+		}
+		return result.distance;
+	}
+
+	bool const intersect(CollisionShape const& a, CollisionShape const& b, GjkCache* cache) noexcept {
+		Simplex simplex;
+		FVector3 closest;
+		unsigned int iteration = 0U;
+
+		bool const overlap = run(a, b, false, initialAxis(a, b, cache), true, simplex, closest, iteration);
+		if (cache != nullptr && !overlap) {
+			//	closest は B から A へ向かうため符号を反転して保存する
+			cache->store(a, b, -closest);
+		}
+		return overlap;
+	}
+
+	bool const collide(CollisionShape const& a, CollisionShape const& b, GjkCache* cache, GjkResult& result) noexcept {
+		Simplex simplex;
+		FVector3 closest, pa, pb;
+		unsigned int iteration = 0U;
+		FVector3 const axis = initialAxis(a, b, cache);
+
+		bool overlap = run(a, b, true, axis, false, simplex, closest, iteration);
+		float const margin = a.margin() + b.margin();
+		float const core = overlap ? 0.0f : sqrtf(sqr_magnitude(closest));
+
+		if (core > EPA_TOLERANCE) {
+			//	芯形状が離れている場合はマージンのみで接触を判定する
+			witness(simplex, pa, pb);
+			FVector3 const normal = (pb - pa) / core;
+			result.pointA = pa + normal * a.margin();
+			result.pointB = pb - normal * b.margin();
+			result.normal = normal;
+			result.distance = core - margin;
+			result.iteration = iteration;
+			result.intersect = result.distance <= 0.0f;
+			if (cache != nullptr) {
+				cache->store(a, b, normal);
+			}
+			return result.intersect;
+		}
+
+		//	芯形状が重なっている場合はマージン込みの形状で単体を作り直して EPA 法を適用する
+		unsigned int extra = 0U;
+		overlap = run(a, b, false, axis, false, simplex, closest, extra);
+		result.iteration = iteration + extra;
+		if (!overlap) {
+			witness(simplex, pa, pb);
+			float const len = sqrtf(sqr_magnitude(closest));
+			result.pointA = pa;
+			result.pointB = pb;
+			result.normal = len > 0.0f ? (pb - pa) / len : FVector3(axis);
+			result.distance = len;
+			result.intersect = false;
+			return false;
+		}
+
+		expand(a, b, simplex, result);
+		if (sqr_magnitude(FVector3(result.normal)) <= GJK_ZERO) {
+			result.normal = axis;
+		}
+		if (cache != nullptr) {
+			cache->store(a, b, FVector3(result.normal));
+		}
+		return true;
+	}
+}
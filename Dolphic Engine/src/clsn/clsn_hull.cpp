@@ -0,0 +1,430 @@
+﻿/**	@file	clsn_hull.cpp
+ *	@brief	凸包クラス
+ */
+#include "clsn/clsn_hull.hpp"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <utility>
+
+namespace {
+	/**	@struct	BuildFace
+	 *	@brief	構築中の凸包の面
+	 */
+	struct BuildFace final {
+		//!	@brief	頂点インデックス
+		unsigned int index[dlph::T3_CNT];
+		//!	@brief	外向きの単位法線
+		dlph::Float3 normal;
+		//!	@brief	原点からの距離
+		float distance;
+		//!	@brief	面より外側にある点
+		std::vector<unsigned int> outside;
+		//!	@brief	有効かどうか
+		bool alive;
+	};
+
+	//!	@brief	面生成関数
+	BuildFace const makeFace(dlph::Float3 const* points, unsigned int const& a, unsigned int const& b, unsigned int const& c) noexcept {
+		using namespace dlph;
+		BuildFace result = {};
+		FVector3 const pa(points[a]), pb(points[b]), pc(points[c]);
+		FVector3 const n = cross(pb - pa, pc - pa);
+		float const length = sqrtf(sqr_magnitude(n));
+		FVector3 const normal = length > 0.0f ? n / length : FVT3_ZERO;
+
+		result.index[0U] = a;
+		result.index[1U] = b;
+		result.index[2U] = c;
+		result.normal = normal;
+		result.distance = dot(normal, pa);
+		result.alive = true;
+		return result;
+	}
+
+	//!	@brief	点と面の符号付き距離取得関数
+	float const height(BuildFace const& face, dlph::Float3 const& point) noexcept {
+		return dlph::dot(dlph::FVector3(face.normal), dlph::FVector3(point)) - face.distance;
+	}
+
+	//!	@brief	有向辺のキー
+	inline unsigned long long const edgeKey(unsigned int const& a, unsigned int const& b) noexcept {
+		return (static_cast<unsigned long long>(a) << 32U) | b;
+	}
+
+	//!	@brief	多角形から一直線上に並ぶ頂点を取り除く関数
+	void removeCollinear(std::vector<unsigned int>& loop, std::vector<dlph::Float3> const& vertices) noexcept {
+		using namespace dlph;
+		size_t idx = 0U;
+		while (loop.size() > T3_CNT && idx < loop.size()) {
+			FVector3 const prev(vertices[loop[(idx + loop.size() - 1U) % loop.size()]]);
+			FVector3 const curr(vertices[loop[idx]]);
+			FVector3 const next(vertices[loop[(idx + 1U) % loop.size()]]);
+			FVector3 const e0 = curr - prev, e1 = next - curr;
+			if (sqr_magnitude(cross(e0, e1)) <= 1.0e-10f * sqr_magnitude(e0) * sqr_magnitude(e1)) {
+				loop.erase(loop.begin() + idx);
+				continue;
+			}
+			++idx;
+		}
+	}
+
+	//!	@brief	面の追加関数
+	void appendFace(unsigned int const* index, size_t const& count, dlph::FVector3 const& normal,
+		std::vector<dlph::Float3> const& vertices, std::vector<dlph::HullFace>& faces, std::vector<unsigned int>& indices) noexcept
+	{
+		using namespace dlph;
+		HullFace face = {};
+		face.first = static_cast<unsigned int>(indices.size());
+		face.count = static_cast<unsigned int>(count);
+		face.normal = normal;
+		face.distance = -FLT_MAX;
+		for (size_t idx = 0U; idx < count; ++idx) {
+			indices.push_back(index[idx]);
+			face.distance = fmaxf(face.distance, dot(normal, FVector3(vertices[index[idx]])));
+		}
+		faces.push_back(face);
+	}
+
+	/**	@brief	同一平面上の三角形をまとめる関数
+	 *	@param[in] triangles 凸包の三角形 (頂点インデックスは vertices の中)
+	 *	@param[in] vertices 凸包の頂点
+	 *	@param[out] faces 面
+	 *	@param[out] indices 面の頂点インデックス
+	 */
+	void mergeFaces(std::vector<BuildFace> const& triangles, std::vector<dlph::Float3> const& vertices,
+		std::vector<dlph::HullFace>& faces, std::vector<unsigned int>& indices) noexcept
+	{
+		using namespace dlph;
+
+		//	有向辺 (始点, 終点) から三角形を引けるよう並べる
+		std::vector<std::pair<unsigned long long, unsigned int>> edges;
+		edges.reserve(triangles.size() * T3_CNT);
+		for (unsigned int idx = 0U; idx < triangles.size(); ++idx) {
+			for (unsigned int e = 0U; e < T3_CNT; ++e) {
+				edges.emplace_back(edgeKey(triangles[idx].index[e], triangles[idx].index[(e + 1U) % T3_CNT]), idx);
+			}
+		}
+		std::sort(edges.begin(), edges.end());
+		auto const twin = [&edges](unsigned int const& a, unsigned int const& b) noexcept -> unsigned int {
+			unsigned long long const key = edgeKey(b, a);
+			auto const it = std::lower_bound(edges.begin(), edges.end(), std::make_pair(key, 0U));
+			return it != edges.end() && it->first == key ? it->second : ~0U;
+		};
+
+		//	最初の三角形と法線がほぼ等しい隣の三角形を辿って一つの面にまとめる
+		std::vector<unsigned int> group(triangles.size(), ~0U);
+		std::vector<unsigned int> members, stack, loop;
+		std::vector<std::pair<unsigned int, unsigned int>> boundary;
+		for (unsigned int seed = 0U; seed < triangles.size(); ++seed) {
+			if (group[seed] != ~0U) {
+				continue;
+			}
+			FVector3 const seedNormal(triangles[seed].normal);
+			members.clear();
+			stack.assign(1U, seed);
+			group[seed] = seed;
+			while (!stack.empty()) {
+				unsigned int const tri = stack.back();
+				stack.pop_back();
+				members.push_back(tri);
+				for (unsigned int e = 0U; e < T3_CNT; ++e) {
+					unsigned int const next = twin(triangles[tri].index[e], triangles[tri].index[(e + 1U) % T3_CNT]);
+					if (next != ~0U && group[next] == ~0U && dot(seedNormal, FVector3(triangles[next].normal)) >= HULL_COPLANAR_COS) {
+						group[next] = seed;
+						stack.push_back(next);
+					}
+				}
+			}
+
+			//	まとめた三角形の外周の辺を繋いで反時計回りの多角形にする
+			boundary.clear();
+			FVector3 area = FVT3_ZERO;
+			for (unsigned int const& tri : members) {
+				BuildFace const& face = triangles[tri];
+				FVector3 const p0(vertices[face.index[0U]]);
+				area += cross(FVector3(vertices[face.index[1U]]) - p0, FVector3(vertices[face.index[2U]]) - p0);
+				for (unsigned int e = 0U; e < T3_CNT; ++e) {
+					unsigned int const a = face.index[e], b = face.index[(e + 1U) % T3_CNT];
+					unsigned int const other = twin(a, b);
+					if (other == ~0U || group[other] != seed) {
+						boundary.emplace_back(a, b);
+					}
+				}
+			}
+			loop.clear();
+			unsigned int current = boundary.front().first;
+			do {
+				loop.push_back(current);
+				auto const it = std::find_if(boundary.begin(), boundary.end(), [current](std::pair<unsigned int, unsigned int> const& edge) noexcept {
+					return edge.first == current;
+				});
+				current = it != boundary.end() ? it->second : ~0U;
+			} while (current != ~0U && current != loop.front() && loop.size() < boundary.size());
+
+			float const length = sqrtf(sqr_magnitude(area));
+			if (members.size() == 1U || current != loop.front() || loop.size() != boundary.size() || length <= 0.0f) {
+				//	外周が一周にならない場合はまとめずに三角形のまま出力する
+				for (unsigned int const& tri : members) {
+					appendFace(triangles[tri].index, T3_CNT, FVector3(triangles[tri].normal), vertices, faces, indices);
+				}
+				continue;
+			}
+			removeCollinear(loop, vertices);
+			appendFace(loop.data(), loop.size(), area / length, vertices, faces, indices);
+		}
+	}
+}
+
+namespace dlph {
+	ConvexHull3::ConvexHull3() noexcept :
+		m_vertices(),
+		m_faces(),
+		m_indices()
+	{}
+
+	bool const ConvexHull3::init(Float3 const* points, size_t const& count) noexcept {
+		exit();
+		if (points == nullptr || count < 4U) {
+			return false;
+		}
+
+		//	点群の大きさから許容誤差を決める
+		float scale = 0.0f;
+		for (size_t idx = 0U; idx < count; ++idx) {
+			scale = fmaxf(scale, fmaxf(fabsf(points[idx].x), fmaxf(fabsf(points[idx].y), fabsf(points[idx].z))));
+		}
+		float const eps = fmaxf(3.0f * FLT_EPSILON * 3.0f * scale, FLT_MIN);
+
+		//	各軸の極点から最も離れた二点を選ぶ
+		unsigned int extreme[T3_CNT * 2U] = {};
+		for (unsigned int idx = 0U; idx < count; ++idx) {
+			for (unsigned int axis = 0U; axis < T3_CNT; ++axis) {
+				if (points[idx].p[axis] < points[extreme[axis * 2U]].p[axis]) {
+					extreme[axis * 2U] = idx;
+				}
+				if (points[idx].p[axis] > points[extreme[axis * 2U + 1U]].p[axis]) {
+					extreme[axis * 2U + 1U] = idx;
+				}
+			}
+		}
+
+		unsigned int i0 = 0U, i1 = 0U, i2 = 0U, i3 = 0U;
+		float best = -1.0f;
+		for (unsigned int axis = 0U; axis < T3_CNT; ++axis) {
+			unsigned int const lo = extreme[axis * 2U], hi = extreme[axis * 2U + 1U];
+			float const len = sqr_magnitude(FVector3(points[hi]) - FVector3(points[lo]));
+			if (len > best) {
+				best = len;
+				i0 = lo;
+				i1 = hi;
+			}
+		}
+		if (best <= eps * eps) {
+			return false;
+		}
+
+		//	二点を通る直線から最も離れた点
+		FVector3 const p0(points[i0]);
+		FVector3 const line = FVector3(points[i1]) - p0;
+		best = -1.0f;
+		for (unsigned int idx = 0U; idx < count; ++idx) {
+			float const len = sqr_magnitude(cross(FVector3(points[idx]) - p0, line));
+			if (len > best) {
+				best = len;
+				i2 = idx;
+			}
+		}
+		if (best <= eps * eps * sqr_magnitude(line)) {
+			return false;
+		}
+
+		//	三点を通る平面から最も離れた点
+		BuildFace const base = makeFace(points, i0, i1, i2);
+		best = -1.0f;
+		for (unsigned int idx = 0U; idx < count; ++idx) {
+			float const len = fabsf(height(base, points[idx]));
+			if (len > best) {
+				best = len;
+				i3 = idx;
+			}
+		}
+		if (best <= eps) {
+			return false;
+		}
+
+		//	初期四面体を外向きに構築する
+		std::vector<BuildFace> faces;
+		unsigned int const tetra[4U][4U] = {
+			{ i0, i1, i2, i3 },
+			{ i0, i1, i3, i2 },
+			{ i0, i2, i3, i1 },
+			{ i1, i2, i3, i0 }
+		};
+		for (auto const& tri : tetra) {
+			BuildFace face = makeFace(points, tri[0U], tri[1U], tri[2U]);
+			if (height(face, points[tri[3U]]) > 0.0f) {
+				face = makeFace(points, tri[0U], tri[2U], tri[1U]);
+			}
+			faces.push_back(std::move(face));
+		}
+
+		//	各点を最も高い位置にある面の外側集合へ振り分ける
+		auto const assign = [&](unsigned int const& point, size_t const& first) {
+			size_t target = faces.size();
+			float top = eps;
+			for (size_t idx = first; idx < faces.size(); ++idx) {
+				if (!faces[idx].alive) {
+					continue;
+				}
+				float const h = height(faces[idx], points[point]);
+				if (h > top) {
+					top = h;
+					target = idx;
+				}
+			}
+			if (target < faces.size()) {
+				faces[target].outside.push_back(point);
+			}
+		};
+		for (unsigned int idx = 0U; idx < count; ++idx) {
+			if (idx != i0 && idx != i1 && idx != i2 && idx != i3) {
+				assign(idx, 0U);
+			}
+		}
+
+		std::vector<size_t> visible;
+		std::vector<std::pair<unsigned int, unsigned int>> edges;
+		std::vector<std::pair<unsigned int, unsigned int>> horizon;
+		std::vector<unsigned int> orphans;
+
+		size_t cursor = 0U;
+		while (cursor < faces.size()) {
+			if (!faces[cursor].alive || faces[cursor].outside.empty()) {
+				++cursor;
+				continue;
+			}
+
+			//	外側集合の中で最も遠い点を新しい頂点とする
+			unsigned int eye = faces[cursor].outside.front();
+			float top = -FLT_MAX;
+			for (unsigned int const& point : faces[cursor].outside) {
+				float const h = height(faces[cursor], points[point]);
+				if (h > top) {
+					top = h;
+					eye = point;
+				}
+			}
+
+			//	新しい頂点から見える面と、その境界 (地平線) を求める
+			visible.clear();
+			edges.clear();
+			for (size_t idx = 0U; idx < faces.size(); ++idx) {
+				if (faces[idx].alive && (idx == cursor || height(faces[idx], points[eye]) > eps)) {
+					visible.push_back(idx);
+					for (unsigned int e = 0U; e < T3_CNT; ++e) {
+						edges.emplace_back(faces[idx].index[e], faces[idx].index[(e + 1U) % T3_CNT]);
+					}
+				}
+			}
+			horizon.clear();
+			for (auto const& edge : edges) {
+				bool shared = false;
+				for (auto const& other : edges) {
+					if (other.first == edge.second && other.second == edge.first) {
+						shared = true;
+						break;
+					}
+				}
+				if (!shared) {
+					horizon.push_back(edge);
+				}
+			}
+
+			orphans.clear();
+			for (size_t const& idx : visible) {
+				for (unsigned int const& point : faces[idx].outside) {
+					if (point != eye) {
+						orphans.push_back(point);
+					}
+				}
+				faces[idx].outside.clear();
+				faces[idx].outside.shrink_to_fit();
+				faces[idx].alive = false;
+			}
+
+			size_t const first = faces.size();
+			for (auto const& edge : horizon) {
+				faces.push_back(makeFace(points, edge.first, edge.second, eye));
+			}
+			for (unsigned int const& point : orphans) {
+				assign(point, first);
+			}
+		}
+
+		//	有効な面と使用頂点を詰める
+		std::vector<unsigned int> remap(count, ~0U);
+		std::vector<BuildFace> triangles;
+		for (BuildFace& face : faces) {
+			if (!face.alive) {
+				continue;
+			}
+			for (unsigned int e = 0U; e < T3_CNT; ++e) {
+				unsigned int const src = face.index[e];
+				if (remap[src] == ~0U) {
+					remap[src] = static_cast<unsigned int>(m_vertices.size());
+					m_vertices.push_back(points[src]);
+				}
+				face.index[e] = remap[src];
+			}
+			triangles.push_back(std::move(face));
+		}
+		mergeFaces(triangles, m_vertices, m_faces, m_indices);
+		return true;
+	}
+
+	void ConvexHull3::exit() noexcept {
+		m_vertices.clear();
+		m_faces.clear();
+		m_indices.clear();
+	}
+
+	FVector3 const ConvexHull3::support(FVector3 const& dir) const noexcept {
+		FVector3 result = FVT3_ZERO;
+		float top = -FLT_MAX;
+		for (Float3 const& vertex : m_vertices) {
+			float const h = vertex.x * dir.x + vertex.y * dir.y + vertex.z * dir.z;
+			if (h > top) {
+				top = h;
+				result = vertex;
+			}
+		}
+		return result;
+	}
+
+	size_t const ConvexHull3::face(FVector3 const& dir) const noexcept {
+		size_t result = 0U;
+		float top = -FLT_MAX;
+		for (size_t idx = 0U; idx < m_faces.size(); ++idx) {
+			Float3 const& n = m_faces[idx].normal;
+			float const h = n.x * dir.x + n.y * dir.y + n.z * dir.z;
+			if (h > top) {
+				top = h;
+				result = idx;
+			}
+		}
+		return result;
+	}
+
+	std::vector<Float3> const& ConvexHull3::vertices() const noexcept {
+		return m_vertices;
+	}
+
+	std::vector<HullFace> const& ConvexHull3::faces() const noexcept {
+		return m_faces;
+	}
+
+	std::vector<unsigned int> const& ConvexHull3::indices() const noexcept {
+		return m_indices;
+	}
+}
@@ -0,0 +1,203 @@
+﻿/**	@file	clsn_manifold.cpp
+ *	@brief	接触多様体生成
+ */
+#include "clsn/clsn_manifold.hpp"
+#include "clsn/clsn_shape.hpp"
+#include "clsn/clsn_gjk.hpp"
+#include <cfloat>
+#include <cmath>
+#include <vector>
+
+namespace {
+	using namespace dlph;
+
+	//!	@brief	接触点を残す貫通深度の許容値
+	static float constexpr MANIFOLD_SLOP = 1.0e-3f;
+
+	/**	@brief	多角形クリッピング関数 (Sutherland-Hodgman 法)
+	 *	@param[in] src クリッピング対象
+	 *	@param[in] normal 平面の内向き法線
+	 *	@param[in] offset 平面の距離
+	 *	@param[out] dst クリッピング結果
+	 */
+	void clip(std::vector<FVector3> const& src, FVector3 const& normal, float const& offset, std::vector<FVector3>& dst) noexcept {
+		dst.clear();
+		if (src.empty()) {
+			return;
+		}
+		FVector3 prev = src.back();
+		float prevDist = dot(normal, prev) - offset;
+		for (FVector3 const& cur : src) {
+			float const curDist = dot(normal, cur) - offset;
+			if (curDist >= 0.0f) {
+				if (prevDist < 0.0f) {
+					dst.push_back(prev + (cur - prev) * (prevDist / (prevDist - curDist)));
+				}
+				dst.push_back(cur);
+			}
+			else if (prevDist >= 0.0f) {
+				dst.push_back(prev + (cur - prev) * (prevDist / (prevDist - curDist)));
+			}
+			prev = cur;
+			prevDist = curDist;
+		}
+	}
+
+	/**	@brief	接触点削減関数
+	 *	@details	最深点、そこから最も遠い点、面積を最大化する二点の順に選び四点以下へ削減します。
+	 *	@param[in] points 接触点の候補
+	 *	@param[in] normal 参照面の法線
+	 *	@param[out] manifold 選んだ接触点の書き込み先
+	 */
+	void reducePoints(std::vector<ContactPoint> const& points, FVector3 const& normal, ContactManifold& manifold) noexcept {
+		manifold.count = 0U;
+		if (points.size() <= MANIFOLD_POINT_CNT) {
+			for (ContactPoint const& point : points) {
+				manifold.points[manifold.count++] = point;
+			}
+			return;
+		}
+
+		size_t pick[MANIFOLD_POINT_CNT] = {};
+		float best = -FLT_MAX;
+		for (size_t idx = 0U; idx < points.size(); ++idx) {
+			if (points[idx].depth > best) {
+				best = points[idx].depth;
+				pick[0U] = idx;
+			}
+		}
+
+		FVector3 const p0(points[pick[0U]].pointB);
+		best = -FLT_MAX;
+		for (size_t idx = 0U; idx < points.size(); ++idx) {
+			float const len = sqr_magnitude(FVector3(points[idx].pointB) - p0);
+			if (len > best) {
+				best = len;
+				pick[1U] = idx;
+			}
+		}
+
+		FVector3 const p1(points[pick[1U]].pointB);
+		best = -FLT_MAX;
+		for (size_t idx = 0U; idx < points.size(); ++idx) {
+			float const area = dot(cross(p0 - FVector3(points[idx].pointB), p1 - FVector3(points[idx].pointB)), normal);
+			if (fabsf(area) > best) {
+				best = fabsf(area);
+				pick[2U] = idx;
+			}
+		}
+
+		//	三角形の外側で、最も面積を広げる点を四点目とする
+		FVector3 const p2(points[pick[2U]].pointB);
+		FVector3 const tri[3U] = { p0, p1, p2 };
+		float const winding = dot(cross(p1 - p0, p2 - p0), normal) < 0.0f ? -1.0f : 1.0f;
+		best = -FLT_MAX;
+		for (size_t idx = 0U; idx < points.size(); ++idx) {
+			FVector3 const q(points[idx].pointB);
+			for (unsigned int e = 0U; e < 3U; ++e) {
+				float const area = -winding * dot(cross(tri[e] - q, tri[(e + 1U) % 3U] - q), normal);
+				if (area > best) {
+					best = area;
+					pick[3U] = idx;
+				}
+			}
+		}
+
+		for (unsigned int idx = 0U; idx < MANIFOLD_POINT_CNT; ++idx) {
+			bool duplicate = false;
+			for (unsigned int prev = 0U; prev < idx; ++prev) {
+				if (pick[prev] == pick[idx]) {
+					duplicate = true;
+					break;
+				}
+			}
+			if (!duplicate) {
+				manifold.points[manifold.count++] = points[pick[idx]];
+			}
+		}
+	}
+}
+
+namespace dlph {
+	bool const createManifold(CollisionShape const& a, CollisionShape const& b, GjkCache* cache, ContactManifold& manifold) noexcept {
+		GjkResult result = {};
+		manifold.count = 0U;
+
+		if (!collide(a, b, cache, result)) {
+			return false;
+		}
+
+		FVector3 const normal(result.normal);
+		manifold.normal = normal;
+
+		//	参照面 (多角形) を持つ側を選び、相手側の特徴をクリッピングする
+		//	作業領域はスレッドごとに使い回し、容量が足りた後はヒープを確保しない
+		thread_local std::vector<FVector3> featureA, featureB, work, temp;
+		thread_local std::vector<ContactPoint> points;
+		a.feature(normal, featureA);
+		b.feature(-normal, featureB);
+
+		bool const flip = featureA.size() < 3U && featureB.size() >= 3U;
+		std::vector<FVector3> const& reference = flip ? featureB : featureA;
+		std::vector<FVector3> const& incident = flip ? featureA : featureB;
+		CollisionShape const& refShape = flip ? b : a;
+		CollisionShape const& incShape = flip ? a : b;
+
+		if (reference.size() < 3U) {
+			//	曲面同士 (球・カプセル) は GJK/EPA 法の最近点をそのまま使う
+			manifold.points[0U].pointA = result.pointA;
+			manifold.points[0U].pointB = result.pointB;
+			manifold.points[0U].depth = -result.distance;
+			manifold.count = 1U;
+			return true;
+		}
+
+		FVector3 refNormal = cross(reference[1U] - reference[0U], reference[2U] - reference[0U]);
+		float const len = sqrtf(sqr_magnitude(refNormal));
+		if (len <= 0.0f) {
+			manifold.points[0U].pointA = result.pointA;
+			manifold.points[0U].pointB = result.pointB;
+			manifold.points[0U].depth = -result.distance;
+			manifold.count = 1U;
+			return true;
+		}
+		refNormal /= len;
+
+		work = incident;
+		for (size_t idx = 0U; idx < reference.size(); ++idx) {
+			FVector3 const& v0 = reference[idx];
+			FVector3 const& v1 = reference[(idx + 1U) % reference.size()];
+			FVector3 const inward = cross(refNormal, v1 - v0);
+			clip(work, inward, dot(inward, v0), temp);
+			work.swap(temp);
+		}
+
+		float const refOffset = dot(refNormal, reference[0U]);
+		float const margin = refShape.margin() + incShape.margin();
+		points.clear();
+		for (FVector3 const& p : work) {
+			float const depth = refOffset - dot(refNormal, p) + margin;
+			if (depth < -MANIFOLD_SLOP) {
+				continue;
+			}
+			FVector3 const onInc = p - refNormal * incShape.margin();
+			FVector3 const onRef = p + refNormal * (refOffset - dot(refNormal, p) + refShape.margin());
+			ContactPoint cp;
+			cp.pointA = flip ? onInc : onRef;
+			cp.pointB = flip ? onRef : onInc;
+			cp.depth = depth;
+			points.push_back(cp);
+		}
+
+		if (points.empty()) {
+			manifold.points[0U].pointA = result.pointA;
+			manifold.points[0U].pointB = result.pointB;
+			manifold.points[0U].depth = -result.distance;
+			manifold.count = 1U;
+			return true;
+		}
+
+		reducePoints(points, refNormal, manifold);
+		return true;
+	}
+}
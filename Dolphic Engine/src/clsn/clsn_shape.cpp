@@ -0,0 +1,223 @@
+﻿/**	@file	clsn_shape.cpp
+ *	@brief	衝突判定用の凸形状クラス
+ */
+#include "clsn/clsn_shape.hpp"
+#include "clsn/clsn_hull.hpp"
+#include "math/math.hpp"
+#include <cmath>
+
+namespace dlph {
+	CollisionShape::CollisionShape() noexcept :
+		m_position(FVT3_ZERO),
+		m_posture(FQTR_UNIT),
+		m_axis{ Float3(1.0f, 0.0f, 0.0f), Float3(0.0f, 1.0f, 0.0f), Float3(0.0f, 0.0f, 1.0f) },
+		m_extent(),
+		m_radius(0.0f),
+		m_halfHeight(0.0f),
+		m_hull(nullptr),
+		m_id(0U),
+		m_type(ShapeType::Sphere)
+	{}
+
+	CollisionShape& CollisionShape::initSphere(float const& radius) noexcept {
+		m_type = ShapeType::Sphere;
+		m_radius = fabsf(radius);
+		m_halfHeight = 0.0f;
+		m_extent = Float3();
+		m_hull = nullptr;
+		return *this;
+	}
+
+	CollisionShape& CollisionShape::initBox(FVector3 const& half_extent) noexcept {
+		m_type = ShapeType::Box;
+		m_radius = 0.0f;
+		m_halfHeight = 0.0f;
+		m_extent = Float3(fabsf(half_extent.x), fabsf(half_extent.y), fabsf(half_extent.z));
+		m_hull = nullptr;
+		return *this;
+	}
+
+	CollisionShape& CollisionShape::initCapsule(float const& radius, float const& half_height) noexcept {
+		m_type = ShapeType::Capsule;
+		m_radius = fabsf(radius);
+		m_halfHeight = fabsf(half_height);
+		m_extent = Float3();
+		m_hull = nullptr;
+		return *this;
+	}
+
+	CollisionShape& CollisionShape::initHull(ConvexHull3 const* hull) noexcept {
+		m_type = ShapeType::Hull;
+		m_radius = 0.0f;
+		m_halfHeight = 0.0f;
+		m_extent = Float3();
+		m_hull = hull;
+		return *this;
+	}
+
+	void CollisionShape::exit() noexcept {
+		*this = CollisionShape();
+	}
+
+	CollisionShape& CollisionShape::id(unsigned int const& arg) noexcept {
+		m_id = arg;
+		return *this;
+	}
+
+	CollisionShape& CollisionShape::position(FVector3 const& arg) noexcept {
+		m_position = arg;
+		return *this;
+	}
+
+	CollisionShape& CollisionShape::posture(FQuaternion const& arg) noexcept {
+		FQuaternion qt = arg;
+		if (qt == FQTR_ZERO) {
+			qt = FQTR_UNIT;
+		}
+		qt = normalize(qt);
+		m_posture = qt;
+
+		float const xx = qt.x * qt.x, yy = qt.y * qt.y, zz = qt.z * qt.z;
+		float const xy = qt.x * qt.y, xz = qt.x * qt.z, yz = qt.y * qt.z;
+		float const wx = qt.w * qt.x, wy = qt.w * qt.y, wz = qt.w * qt.z;
+
+		m_axis[0U] = Float3(1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz), 2.0f * (xz - wy));
+		m_axis[1U] = Float3(2.0f * (xy - wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz + wx));
+		m_axis[2U] = Float3(2.0f * (xz + wy), 2.0f * (yz - wx), 1.0f - 2.0f * (xx + yy));
+		return *this;
+	}
+
+	unsigned int const CollisionShape::id() const noexcept {
+		return m_id;
+	}
+
+	ShapeType const CollisionShape::type() const noexcept {
+		return m_type;
+	}
+
+	FVector3 const CollisionShape::position() const noexcept {
+		return FVector3(m_position);
+	}
+
+	FQuaternion const CollisionShape::posture() const noexcept {
+		return FQuaternion(m_posture);
+	}
+
+	float const CollisionShape::margin() const noexcept {
+		return m_radius;
+	}
+
+	FVector3 const CollisionShape::support(FVector3 const& dir) const noexcept {
+		FVector3 result = supportCore(dir);
+		if (m_radius > 0.0f) {
+			float const length = sqrtf(sqr_magnitude(dir));
+			if (length > 0.0f) {
+				result += dir * (m_radius / length);
+			}
+		}
+		return result;
+	}
+
+	FVector3 const CollisionShape::supportCore(FVector3 const& dir) const noexcept {
+		FVector3 local = toLocal(dir);
+		FVector3 result = FVT3_ZERO;
+
+		switch (m_type) {
+		case ShapeType::Sphere:
+			break;
+		case ShapeType::Box:
+			result = FVector3(
+				local.x < 0.0f ? -m_extent.x : m_extent.x,
+				local.y < 0.0f ? -m_extent.y : m_extent.y,
+				local.z < 0.0f ? -m_extent.z : m_extent.z
+			);
+			break;
+		case ShapeType::Capsule:
+			result = FVector3(0.0f, local.y < 0.0f ? -m_halfHeight : m_halfHeight, 0.0f);
+			break;
+		case ShapeType::Hull:
+			if (m_hull != nullptr) {
+				result = m_hull->support(local);
+			}
+			break;
+		}
+
+		return toWorld(result);
+	}
+
+	void CollisionShape::feature(FVector3 const& dir, std::vector<FVector3>& out) const noexcept {
+		FVector3 local = toLocal(dir);
+		out.clear();
+
+		switch (m_type) {
+		case ShapeType::Sphere:
+			out.push_back(toWorld(FVT3_ZERO));
+			break;
+		case ShapeType::Box:
+		{
+			//	最も方向に近い軸の面を選び、外側から見て反時計回りに四隅を並べる
+			unsigned int axis = 0U;
+			for (unsigned int idx = 1U; idx < T3_CNT; ++idx) {
+				if (fabsf(local.p[idx]) > fabsf(local.p[axis])) {
+					axis = idx;
+				}
+			}
+			unsigned int const j = (axis + 1U) % T3_CNT;
+			unsigned int const k = (axis + 2U) % T3_CNT;
+			float const sign = local.p[axis] < 0.0f ? -1.0f : 1.0f;
+			float const corner[4U][2U] = {
+				{  1.0f,  1.0f },
+				{ -1.0f,  1.0f },
+				{ -1.0f, -1.0f },
+				{  1.0f, -1.0f }
+			};
+			for (unsigned int idx = 0U; idx < 4U; ++idx) {
+				unsigned int const c = sign > 0.0f ? idx : 3U - idx;
+				FVector3 pos;
+				pos.p[axis] = sign * m_extent.p[axis];
+				pos.p[j] = corner[c][0U] * m_extent.p[j];
+				pos.p[k] = corner[c][1U] * m_extent.p[k];
+				out.push_back(toWorld(pos));
+			}
+		}
+			break;
+		case ShapeType::Capsule:
+		{
+			//	線分が方向とほぼ直交していれば両端点を、そうでなければ片端点を特徴とする
+			float const length = sqrtf(sqr_magnitude(local));
+			if (length > 0.0f && fabsf(local.y) < 0.25f * length) {
+				out.push_back(toWorld(FVector3(0.0f, m_halfHeight, 0.0f)));
+				out.push_back(toWorld(FVector3(0.0f, -m_halfHeight, 0.0f)));
+			}
+			else {
+				out.push_back(toWorld(FVector3(0.0f, local.y < 0.0f ? -m_halfHeight : m_halfHeight, 0.0f)));
+			}
+		}
+			break;
+		case ShapeType::Hull:
+			if (m_hull != nullptr && !m_hull->faces().empty()) {
+				//	同一平面上の三角形はまとめてあるので、面全体の多角形を特徴とする
+				HullFace const& face = m_hull->faces()[m_hull->face(local)];
+				for (unsigned int idx = 0U; idx < face.count; ++idx) {
+					out.push_back(toWorld(FVector3(m_hull->vertices()[m_hull->indices()[face.first + idx]])));
+				}
+			}
+			break;
+		}
+	}
+
+	FVector3 const CollisionShape::toLocal(FVector3 const& dir) const noexcept {
+		return FVector3(
+			dot(dir, FVector3(m_axis[0U])),
+			dot(dir, FVector3(m_axis[1U])),
+			dot(dir, FVector3(m_axis[2U]))
+		);
+	}
+
+	FVector3 const CollisionShape::toWorld(FVector3 const& pos) const noexcept {
+		return FVector3(m_position)
+			+ FVector3(m_axis[0U]) * pos.x
+			+ FVector3(m_axis[1U]) * pos.y
+			+ FVector3(m_axis[2U]) * pos.z;
+	}
+}
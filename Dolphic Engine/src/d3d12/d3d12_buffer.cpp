@@ -3,6 +3,8 @@
  */
 #include "d3d12/d3d12_buffer.hpp"
 #include "d3d12/d3d12_device.hpp"
+#include "d3d12/d3d12_upload.hpp"
+#include "d3d12/d3d12_release_queue.hpp"
 #include "util/utility.hpp"
 #include <DirectXTex.h>
 #include <string>
@@ -11,8 +13,12 @@ namespace dlph {
 	D3D12Buffer::D3D12Buffer(D3D12Buffer&& arg) noexcept :
 		D3D12Buffer()
 	{
-		m_heap = arg.m_heap;
-		arg.m_heap = nullptr;
+		m_range = arg.m_range;
+		m_type = arg.m_type;
+		m_init = arg.m_init;
+		arg.m_range = {};
+		arg.m_type = D3D12ViewType::Unknown;
+		arg.m_init = false;
 
 		m_rsrces.resize(arg.m_rsrces.size());
 		for (unsigned int idx = 0U; idx < m_rsrces.size(); ++idx) {
@@ -20,11 +26,22 @@ namespace dlph {
 			arg.m_rsrces[idx] = nullptr;
 		}
 		arg.m_rsrces.clear();
+		m_allocs = std::move(arg.m_allocs);
+		arg.m_allocs.clear();
 	}
 
 	D3D12Buffer& D3D12Buffer::operator=(D3D12Buffer&& rhs) & noexcept {
-		m_heap = rhs.m_heap;
-		rhs.m_heap = nullptr;
+		if (this == &rhs) {
+			return *this;
+		}
+		exit();
+
+		m_range = rhs.m_range;
+		m_type = rhs.m_type;
+		m_init = rhs.m_init;
+		rhs.m_range = {};
+		rhs.m_type = D3D12ViewType::Unknown;
+		rhs.m_init = false;
 
 		m_rsrces.resize(rhs.m_rsrces.size());
 		for (unsigned int idx = 0U; idx < m_rsrces.size(); ++idx) {
@@ -32,14 +49,17 @@ namespace dlph {
 			rhs.m_rsrces[idx] = nullptr;
 		}
 		rhs.m_rsrces.clear();
+		m_allocs = std::move(rhs.m_allocs);
+		rhs.m_allocs.clear();
 
 		return *this;
 	}
 
 	D3D12Buffer::D3D12Buffer() noexcept :
 		INoncopyable(),
-		m_heap(nullptr),
+		m_range(),
 		m_rsrces(),
+		m_allocs(),
 		m_type(D3D12ViewType::Unknown),
 		m_init(false)
 	{}
@@ -53,48 +73,22 @@ namespace dlph {
 			return true;
 		}
 		if (count != 0U) {
-			if (type != D3D12ViewType::Unknown) {
-				HRESULT hResult = S_OK;
-				D3D12_DESCRIPTOR_HEAP_DESC heap = {};
-
-				heap.NodeMask = 0U;
-				heap.NumDescriptors = count;
-
-				switch (type) {
-				case D3D12ViewType::RTV:
-					heap.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
-					heap.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
-					break;
-				case D3D12ViewType::DSV:
-					heap.Type = D3D12_DESCRIPTOR_HEAP_TYPE_DSV;
-					heap.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
-					break;
-				case D3D12ViewType::CBV:
-				case D3D12ViewType::SRV:
-				case D3D12ViewType::UAV:
-					heap.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
-					heap.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
-					break;
-				case D3D12ViewType::Sampler:
-					heap.Type = D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER;
-					heap.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
-					break;
-				default:
-					OutputDebugStringA("ERROR : SELECT DESCRIPTOR TYPE CORRUPTED.\n");
-					return false;
-				}
-
-				hResult = D3D12Device::getInstance()->CreateDescriptorHeap(
-					&heap,
-					__uuidof(m_heap),
-					reinterpret_cast<void**>(&m_heap)
-				);
-				if (FAILED(hResult)) {
-					OutputDebugStringA("ERROR : CREATE FAILED DIREDT3D12 DESCRIPTOR HEAP.\n");
+			switch (type) {
+			case D3D12ViewType::Unknown:
+			case D3D12ViewType::VBV:
+			case D3D12ViewType::IBV:
+				//	記述子を使わないビュー
+				break;
+			default:
+				m_range = D3D12DescriptorAllocator::getInstance().allocate(type, count);
+				if (m_range.count == 0U) {
+					OutputDebugStringA("ERROR : ALLOCATE FAILED DIREDT3D12 DESCRIPTOR.\n");
 					return false;
 				}
+				break;
 			}
 			m_rsrces.resize(count);
+			m_allocs.resize(count);
 			m_type = type;
 			m_init = true;
 			return true;
@@ -106,45 +100,33 @@ namespace dlph {
 	}
 
 	void D3D12Buffer::exit() noexcept {
-		safe_release(m_heap);
+		//	処理中のフレームが参照しているかもしれないため、GPU が記録中のフレームを終えてから返す
+		D3D12ReleaseQueue& queue = D3D12ReleaseQueue::getInstance();
+		queue.retire(m_range);
 		for (auto& rsrc : m_rsrces) {
-			safe_release(rsrc);
+			queue.retire(rsrc);
 		}
 		m_rsrces.clear();
+		//	配置リソースを解放してからメモリを返す
+		for (auto& alloc : m_allocs) {
+			queue.retire(alloc);
+		}
+		m_allocs.clear();
 		m_init = false;
 	}
 
 	D3D12DescriptorHandle const D3D12Buffer::getDescriptorHandle(unsigned int const& idx) const noexcept {
 		D3D12DescriptorHandle result = {};
-		if (m_init) {
-			D3D12_DESCRIPTOR_HEAP_TYPE type = D3D12_DESCRIPTOR_HEAP_TYPE::D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
-			size_t incsize = 0U;
-
-			switch (m_type) {
-			case D3D12ViewType::RTV:
-				type = D3D12_DESCRIPTOR_HEAP_TYPE::D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
-				break;
-			case D3D12ViewType::DSV:
-				type = D3D12_DESCRIPTOR_HEAP_TYPE::D3D12_DESCRIPTOR_HEAP_TYPE_DSV;
-				break;
-			case D3D12ViewType::Sampler:
-				type = D3D12_DESCRIPTOR_HEAP_TYPE::D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER;
-				break;
-			default:
-				break;
-			}
-
-			incsize = D3D12Device::getInstance()->GetDescriptorHandleIncrementSize(type);
-
-			if (m_heap != nullptr) {
-				result.cpu = m_heap->GetCPUDescriptorHandleForHeapStart();
-				result.gpu = m_heap->GetGPUDescriptorHandleForHeapStart();
-				if (idx < m_rsrces.size()) {
-					result.cpu.ptr += incsize * static_cast<UINT64>(idx);
-					result.gpu.ptr += incsize * static_cast<UINT64>(idx);
-					result.usable = true;
-				}
+		if (m_init && idx < m_range.count) {
+			UINT64 const incsize = D3D12DescriptorAllocator::getInstance().getIncrementSize(m_type);
+
+			result.cpu = m_range.cpu;
+			result.gpu = m_range.gpu;
+			result.cpu.ptr += static_cast<SIZE_T>(incsize * idx);
+			if (result.gpu.ptr != 0U) {
+				result.gpu.ptr += incsize * idx;
 			}
+			result.usable = true;
 		}
 		return result;
 	}
@@ -165,6 +147,10 @@ namespace dlph {
 		return m_rsrces[idx];
 	}
 
+	D3D12Allocation& D3D12Buffer::getAllocation(unsigned int const& idx)& noexcept {
+		return m_allocs[idx];
+	}
+
 	/* View 生成関数 */
 
 	bool const createDepthStencilView(D3D12Buffer& buffer, HWND const& hWnd) noexcept {
@@ -260,57 +246,30 @@ namespace dlph {
 		return true;
 	}
 
-	bool const createIndexBufferView(D3D12Buffer& buffer, unsigned int* indecies, unsigned int const& size) noexcept {
-		HRESULT hResult = S_OK;
-
-		buffer.init(D3D12ViewType::Unknown, 1U);
+	bool const createGeometryBuffer(D3D12Buffer& buffer, void const* data, UINT64 const& bytes) noexcept {
+		if (!D3D12MemoryAllocator::getInstance().createBuffer(bytes, buffer.getAllocation(0), buffer[0])) {
+			return false;
+		}
 
-		D3D12_HEAP_PROPERTIES prop = {};
-		prop.Type = D3D12_HEAP_TYPE_UPLOAD;
-		prop.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
-		prop.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
-		prop.CreationNodeMask = 1;
-		prop.VisibleNodeMask = 1;
+		//	UPLOAD ヒープに置いたままでは描画のたびに PCIe 越しに読まれるため、DEFAULT ヒープへ転送する
+		if (!D3D12UploadQueue::getInstance().upload(buffer[0], 0U, data, bytes)) {
+			OutputDebugStringA("ERROR : UPLOADING FAILED GEOMETRY BUFFER RESOURCE.\n");
+			return false;
+		}
 
-		D3D12_RESOURCE_DESC desc = {};
-		desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-		desc.Alignment = 0;
-		desc.Width = static_cast<UINT64>(sizeof(unsigned int)) * size;
-		desc.Height = 1;
-		desc.DepthOrArraySize = 1;
-		desc.MipLevels = 1;
-		desc.Format = DXGI_FORMAT_UNKNOWN;
-		desc.SampleDesc.Count = 1;
-		desc.SampleDesc.Quality = 0;
-		desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-		desc.Flags = D3D12_RESOURCE_FLAG_NONE;
+		return true;
+	}
 
-		hResult = D3D12Device::getInstance()->CreateCommittedResource(
-			&prop,
-			D3D12_HEAP_FLAG_NONE,
-			&desc,
-			D3D12_RESOURCE_STATE_GENERIC_READ,
-			nullptr,
-			__uuidof(buffer[0]),
-			reinterpret_cast<void**>(&buffer[0])
-		);
-		if (FAILED(hResult)) {
-			OutputDebugStringA("ERROR : COMMITING FAILED INDEX BUFFER RESOURCE.\n");
+	bool const createIndexBufferView(D3D12Buffer& buffer, unsigned int* indecies, unsigned int const& size) noexcept {
+		if (!buffer.init(D3D12ViewType::IBV, 1U)) {
 			return false;
 		}
 
-		void* ptr = nullptr;
-		hResult = buffer[0]->Map(0U, nullptr, &ptr);
-		if (FAILED(hResult)) {
-			OutputDebugStringA("ERROR : MAPPING FAILED INDEX BUFFER RESOURCE.\n");
+		if (!createGeometryBuffer(buffer, indecies, static_cast<UINT64>(sizeof(unsigned int)) * size)) {
+			OutputDebugStringA("ERROR : COMMITING FAILED INDEX BUFFER RESOURCE.\n");
 			return false;
 		}
 
-		memcpy(ptr, indecies, static_cast<UINT64>(sizeof(unsigned int)) * size);
-
-		buffer[0]->Unmap(0U, nullptr);
-		ptr = nullptr;
-
 		D3D12_INDEX_BUFFER_VIEW view = {};
 		view.BufferLocation = buffer.getGPUVirtualAddress(0);
 		view.SizeInBytes = sizeof(unsigned int) * size;
@@ -0,0 +1,244 @@
+﻿/**	@file	d3d12_cmd_backend.cpp
+ *	@brief	描画コマンド列を Direct3D12 のコマンドリストへ変換するバックエンド
+ */
+#include "d3d12/d3d12_cmd_backend.hpp"
+
+namespace {
+	using namespace dlph;
+
+	//!	@brief	描画コマンド列のハンドルからスロットマップのキーへの変換
+	template <typename T, typename H>
+	inline typename SlotMap<T>::KeyType const toKey(H const& handle) noexcept {
+		return SlotMap<T>::KeyType::make(handle.index(), handle.generation());
+	}
+
+	//!	@brief	リソースのサブリソース数 (平面の数は数えません)
+	inline UINT const subresourceCount(ID3D12Resource* resource) noexcept {
+		D3D12_RESOURCE_DESC const desc = resource->GetDesc();
+		if (desc.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER) {
+			return 1U;
+		}
+		UINT const arraySize = desc.Dimension == D3D12_RESOURCE_DIMENSION_TEXTURE3D ? 1U : desc.DepthOrArraySize;
+		return static_cast<UINT>(desc.MipLevels) * arraySize;
+	}
+}
+
+namespace dlph {
+	D3D12_RESOURCE_STATES const to_d3d12_state(ResourceState const& state) noexcept {
+		switch (state) {
+		case ResourceState::VertexAndConstant:
+			return D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER;
+		case ResourceState::Index:
+			return D3D12_RESOURCE_STATE_INDEX_BUFFER;
+		case ResourceState::ShaderResource:
+			return D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE | D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
+		case ResourceState::UnorderedAccess:
+			return D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+		case ResourceState::RenderTarget:
+			return D3D12_RESOURCE_STATE_RENDER_TARGET;
+		case ResourceState::DepthWrite:
+			return D3D12_RESOURCE_STATE_DEPTH_WRITE;
+		case ResourceState::DepthRead:
+			return D3D12_RESOURCE_STATE_DEPTH_READ;
+		case ResourceState::CopySource:
+			return D3D12_RESOURCE_STATE_COPY_SOURCE;
+		case ResourceState::CopyDest:
+			return D3D12_RESOURCE_STATE_COPY_DEST;
+		case ResourceState::Present:
+			return D3D12_RESOURCE_STATE_PRESENT;
+		default:
+			return D3D12_RESOURCE_STATE_COMMON;
+		}
+	}
+
+	D3D12ResourceTable::D3D12ResourceTable() noexcept :
+		INonmovable(),
+		m_resources(),
+		m_pipelines()
+	{}
+
+	RenderResource const D3D12ResourceTable::registerResource(ID3D12Resource* resource) noexcept {
+		if (resource == nullptr) {
+			return {};
+		}
+		auto const key = m_resources.insert(resource);
+		return RenderResource::make(key.index(), key.generation());
+	}
+
+	void D3D12ResourceTable::unregisterResource(RenderResource const& handle) noexcept {
+		m_resources.erase(toKey<ID3D12Resource*>(handle));
+	}
+
+	ID3D12Resource* const D3D12ResourceTable::getResource(RenderResource const& handle) const noexcept {
+		ID3D12Resource* const* const ptr = m_resources.get(toKey<ID3D12Resource*>(handle));
+		return ptr ? *ptr : nullptr;
+	}
+
+	RenderPipeline const D3D12ResourceTable::registerPipeline(D3D12PipelineEntry const& entry) noexcept {
+		if (entry.state == nullptr || entry.root == nullptr) {
+			return {};
+		}
+		auto const key = m_pipelines.insert(entry);
+		return RenderPipeline::make(key.index(), key.generation());
+	}
+
+	void D3D12ResourceTable::unregisterPipeline(RenderPipeline const& handle) noexcept {
+		m_pipelines.erase(toKey<D3D12PipelineEntry>(handle));
+	}
+
+	D3D12PipelineEntry const* const D3D12ResourceTable::getPipeline(RenderPipeline const& handle) const noexcept {
+		return m_pipelines.get(toKey<D3D12PipelineEntry>(handle));
+	}
+
+	void D3D12ResourceTable::clear() noexcept {
+		m_resources.clear();
+		m_pipelines.clear();
+	}
+
+	D3D12CommandBackend::D3D12CommandBackend(D3D12ResourceTable const& table, D3D12CommandList& list) noexcept :
+		IRenderBackend(),
+		m_table(table),
+		m_list(list),
+		m_graphicsRoot(nullptr),
+		m_computeRoot(nullptr),
+		m_compute(false),
+		m_barriers()
+	{}
+
+	void D3D12CommandBackend::draw(DrawCommand const& cmd) noexcept {
+		m_barriers.flush(m_list);
+		m_list->DrawInstanced(cmd.vertexCount, cmd.instanceCount, cmd.firstVertex, cmd.firstInstance);
+	}
+
+	void D3D12CommandBackend::drawIndexed(DrawIndexedCommand const& cmd) noexcept {
+		m_barriers.flush(m_list);
+		m_list->DrawIndexedInstanced(cmd.indexCount, cmd.instanceCount, cmd.firstIndex, cmd.baseVertex, cmd.firstInstance);
+	}
+
+	void D3D12CommandBackend::dispatch(DispatchCommand const& cmd) noexcept {
+		m_barriers.flush(m_list);
+		m_list->Dispatch(cmd.x, cmd.y, cmd.z);
+	}
+
+	void D3D12CommandBackend::setPipeline(SetPipelineCommand const& cmd) noexcept {
+		D3D12PipelineEntry const* const entry = m_table.getPipeline(cmd.pipeline);
+		if (entry == nullptr) {
+			OutputDebugStringA("ERROR : PIPELINE HANDLE IS INVALID.\n");
+			return;
+		}
+		m_compute = entry->compute;
+		m_list->SetPipelineState(entry->state);
+		//	ルートシグネチャの再設定は無駄な呼び出しになるため、変わる時だけ設定する
+		if (m_compute) {
+			if (m_computeRoot != entry->root) {
+				m_list->SetComputeRootSignature(entry->root);
+				m_computeRoot = entry->root;
+			}
+		}
+		else {
+			if (m_graphicsRoot == nullptr) {
+				m_list->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+			}
+			if (m_graphicsRoot != entry->root) {
+				m_list->SetGraphicsRootSignature(entry->root);
+				m_graphicsRoot = entry->root;
+			}
+		}
+	}
+
+	void D3D12CommandBackend::bindVertexBuffer(BindVertexBufferCommand const& cmd) noexcept {
+		ID3D12Resource* const resource = m_table.getResource(cmd.buffer);
+		if (resource == nullptr) {
+			OutputDebugStringA("ERROR : VERTEX BUFFER HANDLE IS INVALID.\n");
+			return;
+		}
+		D3D12_VERTEX_BUFFER_VIEW view = {};
+		view.BufferLocation = resource->GetGPUVirtualAddress() + cmd.offset;
+		view.SizeInBytes = static_cast<UINT>(resource->GetDesc().Width - cmd.offset);
+		view.StrideInBytes = cmd.stride;
+		m_list->IASetVertexBuffers(cmd.slot, 1U, &view);
+	}
+
+	void D3D12CommandBackend::bindIndexBuffer(BindIndexBufferCommand const& cmd) noexcept {
+		ID3D12Resource* const resource = m_table.getResource(cmd.buffer);
+		if (resource == nullptr) {
+			OutputDebugStringA("ERROR : INDEX BUFFER HANDLE IS INVALID.\n");
+			return;
+		}
+		D3D12_INDEX_BUFFER_VIEW view = {};
+		view.BufferLocation = resource->GetGPUVirtualAddress() + cmd.offset;
+		view.SizeInBytes = static_cast<UINT>(resource->GetDesc().Width - cmd.offset);
+		view.Format = cmd.format == IndexFormat::UInt16 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+		m_list->IASetIndexBuffer(&view);
+	}
+
+	void D3D12CommandBackend::bindConstants(BindConstantsCommand const& cmd) noexcept {
+		if (m_compute) {
+			m_list->SetComputeRootConstantBufferView(cmd.root, cmd.address);
+		}
+		else {
+			m_list->SetGraphicsRootConstantBufferView(cmd.root, cmd.address);
+		}
+	}
+
+	void D3D12CommandBackend::bindResource(BindResourceCommand const& cmd) noexcept {
+		ID3D12Resource* const resource = m_table.getResource(cmd.resource);
+		if (resource == nullptr) {
+			OutputDebugStringA("ERROR : RESOURCE HANDLE IS INVALID.\n");
+			return;
+		}
+		if (m_compute) {
+			m_list->SetComputeRootShaderResourceView(cmd.root, resource->GetGPUVirtualAddress());
+		}
+		else {
+			m_list->SetGraphicsRootShaderResourceView(cmd.root, resource->GetGPUVirtualAddress());
+		}
+	}
+
+	void D3D12CommandBackend::barrier(BarrierCommand const& cmd) noexcept {
+		ID3D12Resource* const resource = m_table.getResource(cmd.resource);
+		if (resource == nullptr) {
+			OutputDebugStringA("ERROR : BARRIER RESOURCE HANDLE IS INVALID.\n");
+			return;
+		}
+		switch (cmd.kind) {
+		case BarrierKind::UnorderedAccess:
+			m_barriers.uav(resource);
+			break;
+		case BarrierKind::Transition:
+			//	この再生で初めて見るリソースはコマンドの遷移前の状態から追跡する (サブリソース単位の遷移に備えて数を合わせる)
+			if (!m_barriers.tracked(resource)) {
+				m_barriers.track(resource, cmd.before, subresourceCount(resource));
+			}
+			if (!m_barriers.transition(resource, cmd.after, cmd.subresource)) {
+				OutputDebugStringA("ERROR : BARRIER SUBRESOURCE IS OUT OF RANGE.\n");
+			}
+			break;
+		default:
+			if (cmd.kind == BarrierKind::Begin && !m_barriers.tracked(resource)) {
+				m_barriers.track(resource, cmd.before, subresourceCount(resource));
+			}
+			m_barriers.push(resource, cmd.before, cmd.after, cmd.kind, cmd.subresource);
+			break;
+		}
+	}
+
+	void D3D12CommandBackend::copy(CopyCommand const& cmd) noexcept {
+		ID3D12Resource* const dst = m_table.getResource(cmd.dst);
+		ID3D12Resource* const src = m_table.getResource(cmd.src);
+		if (dst == nullptr || src == nullptr) {
+			OutputDebugStringA("ERROR : COPY RESOURCE HANDLE IS INVALID.\n");
+			return;
+		}
+		m_barriers.flush(m_list);
+		m_list->CopyBufferRegion(dst, cmd.dstOffset, src, cmd.srcOffset, cmd.size);
+	}
+
+	void D3D12CommandBackend::flush() noexcept {
+		m_barriers.flush(m_list);
+	}
+
+	StateTrackerStats const& D3D12CommandBackend::barrierStats() const noexcept {
+		return m_barriers.stats();
+	}
+}
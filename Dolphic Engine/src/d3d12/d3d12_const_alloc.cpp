@@ -0,0 +1,145 @@
+﻿/**	@file	d3d12_const_alloc.cpp
+ *	@brief	Direct3D12 用の定数データ確保器
+ */
+#include "d3d12/d3d12_const_alloc.hpp"
+#include "d3d12/d3d12_device.hpp"
+#include "util/utility.hpp"
+#include <crtdbg.h>
+
+namespace dlph {
+	D3D12ConstantAllocator::D3D12ConstantAllocator() noexcept :
+		ISingleton(),
+		m_buffer(nullptr),
+		m_mapped(nullptr),
+		m_address(0U),
+		m_frameSize(0U),
+		m_frames(),
+		m_slot(0U)
+	{}
+
+	D3D12ConstantAllocator::~D3D12ConstantAllocator() noexcept {
+		exit();
+	}
+
+	bool const D3D12ConstantAllocator::init(UINT64 const& size) noexcept {
+		if (m_buffer) {
+			return true;
+		}
+		HRESULT hResult = S_OK;
+
+		//	区画の境目も 256 バイトに揃える
+		UINT64 const alignment = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT;
+		m_frameSize = (size + alignment - 1U) & ~(alignment - 1U);
+		if (m_frameSize == 0U) {
+			OutputDebugStringA("ERROR : CONSTANT BUFFER SIZE IS ZERO.\n");
+			return false;
+		}
+
+		D3D12_HEAP_PROPERTIES prop = {};
+		prop.Type = D3D12_HEAP_TYPE_UPLOAD;
+		prop.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
+		prop.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
+		prop.CreationNodeMask = 1U;
+		prop.VisibleNodeMask = 1U;
+
+		D3D12_RESOURCE_DESC desc = {};
+		desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+		desc.Alignment = 0U;
+		desc.Width = m_frameSize * FRAME_LATENCY_MAX;
+		desc.Height = 1U;
+		desc.DepthOrArraySize = 1U;
+		desc.MipLevels = 1U;
+		desc.Format = DXGI_FORMAT_UNKNOWN;
+		desc.SampleDesc.Count = 1U;
+		desc.SampleDesc.Quality = 0U;
+		desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+		desc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+		hResult = D3D12Device::getInstance()->CreateCommittedResource(
+			&prop,
+			D3D12_HEAP_FLAG_NONE,
+			&desc,
+			D3D12_RESOURCE_STATE_GENERIC_READ,
+			nullptr,
+			__uuidof(m_buffer),
+			reinterpret_cast<void**>(&m_buffer)
+		);
+		if (FAILED(hResult)) {
+			OutputDebugStringA("ERROR : COMMITING FAILED CONSTANT BUFFER RESOURCE.\n");
+			return false;
+		}
+
+		//	CPU から読むことは無いので読み取り範囲は空にし、終了まで Map したままにする
+		D3D12_RANGE const none = { 0U, 0U };
+		hResult = m_buffer->Map(0U, &none, reinterpret_cast<void**>(&m_mapped));
+		if (FAILED(hResult)) {
+			exit();
+			OutputDebugStringA("ERROR : MAPPING FAILED CONSTANT BUFFER RESOURCE.\n");
+			return false;
+		}
+		m_address = m_buffer->GetGPUVirtualAddress();
+
+		for (AtomicLinearAllocator& frame : m_frames) {
+			if (!frame.init(m_frameSize, alignment)) {
+				exit();
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	void D3D12ConstantAllocator::exit() noexcept {
+		for (AtomicLinearAllocator& frame : m_frames) {
+			frame.exit();
+		}
+		if (m_buffer && m_mapped) {
+			m_buffer->Unmap(0U, nullptr);
+		}
+		m_mapped = nullptr;
+		m_address = 0U;
+		safe_release(m_buffer);
+		m_frameSize = 0U;
+		m_slot = 0U;
+	}
+
+	void D3D12ConstantAllocator::beginFrame(unsigned int const& slot) noexcept {
+#if	defined(_DEBUG) || defined(DEBUG)
+		_ASSERT_EXPR(slot < FRAME_LATENCY_MAX, L"ERROR : FRAME SLOT OUT OF RANGE.");
+#endif
+		m_slot = slot;
+		m_frames[m_slot].reset();
+	}
+
+	D3D12ConstantRange const D3D12ConstantAllocator::allocate(UINT64 const& size) noexcept {
+		D3D12ConstantRange result = {};
+		if (m_mapped == nullptr) {
+			return result;
+		}
+
+		AtomicLinearAllocator& frame = m_frames[m_slot];
+		unsigned long long const offset = frame.allocate(size);
+		if (offset == LINEAR_INVALID) {
+			OutputDebugStringA("ERROR : CONSTANT BUFFER OF THIS FRAME IS EXHAUSTED.\n");
+			return result;
+		}
+
+		UINT64 const position = m_frameSize * m_slot + offset;
+		result.cpu = m_mapped + position;
+		result.gpu = m_address + position;
+		result.size = frame.align(size);
+		return result;
+	}
+
+	UINT64 const D3D12ConstantAllocator::used() const noexcept {
+		return m_frames[m_slot].used();
+	}
+
+	ID3D12Resource* const D3D12ConstantAllocator::getBuffer() const noexcept {
+		return m_buffer;
+	}
+
+	UINT64 const D3D12ConstantAllocator::getOffset(D3D12ConstantRange const& range) const noexcept {
+		return range.gpu - m_address;
+	}
+}
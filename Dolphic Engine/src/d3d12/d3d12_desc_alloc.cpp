@@ -0,0 +1,234 @@
+﻿/**	@file	d3d12_desc_alloc.cpp
+ *	@brief	Direct3D12 用の記述子確保器
+ */
+#include "d3d12/d3d12_desc_alloc.hpp"
+#include "d3d12/d3d12_device.hpp"
+#include "util/utility.hpp"
+
+namespace dlph {
+	D3D12DescriptorAllocator::D3D12DescriptorAllocator() noexcept :
+		ISingleton(),
+		m_heaps(),
+		m_ranges(),
+		m_transient(),
+		m_dstStarts(),
+		m_srcStarts(),
+		m_copySizes(),
+		m_mutex()
+	{}
+
+	D3D12DescriptorAllocator::~D3D12DescriptorAllocator() noexcept {
+		exit();
+	}
+
+	bool const D3D12DescriptorAllocator::init() noexcept {
+		if (m_heaps[toIndex(HeapKind::Resource)].heap != nullptr) {
+			return true;
+		}
+
+		bool result = true;
+		result = result && createHeap(HeapKind::Resource, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, D3D12_DESCRIPTOR_PERSISTENT_CNT + D3D12_DESCRIPTOR_TRANSIENT_CNT, true);
+		result = result && createHeap(HeapKind::Sampler, D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER, D3D12_DESCRIPTOR_SAMPLER_CNT, true);
+		result = result && createHeap(HeapKind::RenderTarget, D3D12_DESCRIPTOR_HEAP_TYPE_RTV, D3D12_DESCRIPTOR_RTV_CNT, false);
+		result = result && createHeap(HeapKind::DepthStencil, D3D12_DESCRIPTOR_HEAP_TYPE_DSV, D3D12_DESCRIPTOR_DSV_CNT, false);
+		result = result && createHeap(HeapKind::Staging, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, D3D12_DESCRIPTOR_STAGING_CNT, false);
+		if (!result) {
+			exit();
+			return false;
+		}
+
+		//	シェーダから見えるヒープは前半を長期確保、後半を一時確保に分ける
+		m_ranges[toIndex(HeapKind::Resource)].init(D3D12_DESCRIPTOR_PERSISTENT_CNT);
+		m_ranges[toIndex(HeapKind::Sampler)].init(D3D12_DESCRIPTOR_SAMPLER_CNT);
+		m_ranges[toIndex(HeapKind::RenderTarget)].init(D3D12_DESCRIPTOR_RTV_CNT);
+		m_ranges[toIndex(HeapKind::DepthStencil)].init(D3D12_DESCRIPTOR_DSV_CNT);
+		m_ranges[toIndex(HeapKind::Staging)].init(D3D12_DESCRIPTOR_STAGING_CNT);
+		m_transient.init(D3D12_DESCRIPTOR_TRANSIENT_CNT);
+
+		return true;
+	}
+
+	void D3D12DescriptorAllocator::exit() noexcept {
+		for (Heap& heap : m_heaps) {
+			safe_release(heap.heap);
+			heap = {};
+		}
+		for (RangeAllocator& range : m_ranges) {
+			range.exit();
+		}
+		m_transient.exit();
+		m_dstStarts.clear();
+		m_srcStarts.clear();
+		m_copySizes.clear();
+	}
+
+	D3D12DescriptorRange const D3D12DescriptorAllocator::allocate(D3D12ViewType const& type, unsigned int const& count) noexcept {
+		HeapKind const kind = selectHeap(type);
+		if (kind == HeapKind::Unknown) {
+			OutputDebugStringA("ERROR : SELECT DESCRIPTOR TYPE CORRUPTED.\n");
+			return {};
+		}
+
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		unsigned int const offset = m_ranges[toIndex(kind)].allocate(count);
+		if (offset == RANGE_INVALID) {
+			OutputDebugStringA("ERROR : DESCRIPTOR HEAP IS EXHAUSTED.\n");
+			return {};
+		}
+		return makeRange(kind, type, offset, count);
+	}
+
+	void D3D12DescriptorAllocator::release(D3D12DescriptorRange& range) noexcept {
+		if (range.count == 0U) {
+			return;
+		}
+#if	defined(_DEBUG) || defined(DEBUG)
+		_ASSERT_EXPR(range.kind != HeapKind::Transient, L"ERROR : TRANSIENT DESCRIPTOR RANGE CANNOT BE RELEASED.");
+#endif
+		if (range.kind == HeapKind::Transient || range.kind == HeapKind::Unknown) {
+			OutputDebugStringA("ERROR : RELEASE DESCRIPTOR RANGE IS NOT PERSISTENT.\n");
+			return;
+		}
+
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		m_ranges[toIndex(range.kind)].release(range.offset, range.count);
+		range = {};
+	}
+
+	D3D12DescriptorRange const D3D12DescriptorAllocator::allocateTransient(unsigned int const& count) noexcept {
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		unsigned int const offset = m_transient.allocate(count);
+		if (offset == RANGE_INVALID) {
+			OutputDebugStringA("ERROR : TRANSIENT DESCRIPTOR RING IS EXHAUSTED.\n");
+			return {};
+		}
+		return makeRange(HeapKind::Transient, D3D12ViewType::SRV, D3D12_DESCRIPTOR_PERSISTENT_CNT + offset, count);
+	}
+
+	D3D12DescriptorRange const D3D12DescriptorAllocator::allocateStaging(unsigned int const& count) noexcept {
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		unsigned int const offset = m_ranges[toIndex(HeapKind::Staging)].allocate(count);
+		if (offset == RANGE_INVALID) {
+			OutputDebugStringA("ERROR : STAGING DESCRIPTOR HEAP IS EXHAUSTED.\n");
+			return {};
+		}
+		return makeRange(HeapKind::Staging, D3D12ViewType::SRV, offset, count);
+	}
+
+	void D3D12DescriptorAllocator::copy(D3D12DescriptorRange const& dst, D3D12_CPU_DESCRIPTOR_HANDLE const& src, unsigned int const& count) noexcept {
+		if (count == 0U || count > dst.count) {
+			return;
+		}
+
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		m_dstStarts.push_back(dst.cpu);
+		m_srcStarts.push_back(src);
+		m_copySizes.push_back(count);
+	}
+
+	void D3D12DescriptorAllocator::flush() noexcept {
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		if (m_copySizes.empty()) {
+			return;
+		}
+
+		UINT const count = static_cast<UINT>(m_copySizes.size());
+		D3D12Device::getInstance()->CopyDescriptors(
+			count,
+			m_dstStarts.data(),
+			m_copySizes.data(),
+			count,
+			m_srcStarts.data(),
+			m_copySizes.data(),
+			D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV
+		);
+
+		m_dstStarts.clear();
+		m_srcStarts.clear();
+		m_copySizes.clear();
+	}
+
+	void D3D12DescriptorAllocator::beginFrame(unsigned int const& slot) noexcept {
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		m_transient.begin(slot);
+	}
+
+	void D3D12DescriptorAllocator::endFrame(unsigned int const& slot) noexcept {
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		m_transient.end(slot);
+	}
+
+	ID3D12DescriptorHeap* const D3D12DescriptorAllocator::getResourceHeap() const noexcept {
+		return m_heaps[toIndex(HeapKind::Resource)].heap;
+	}
+
+	ID3D12DescriptorHeap* const D3D12DescriptorAllocator::getSamplerHeap() const noexcept {
+		return m_heaps[toIndex(HeapKind::Sampler)].heap;
+	}
+
+	unsigned int const D3D12DescriptorAllocator::getIncrementSize(D3D12ViewType const& type) const noexcept {
+		HeapKind const kind = selectHeap(type);
+		return kind != HeapKind::Unknown ? m_heaps[toIndex(kind)].increment : 0U;
+	}
+
+	bool const D3D12DescriptorAllocator::createHeap(HeapKind const& kind, D3D12_DESCRIPTOR_HEAP_TYPE const& type, unsigned int const& count, bool const& visible) noexcept {
+		HRESULT hResult = S_OK;
+		D3D12_DESCRIPTOR_HEAP_DESC desc = {};
+		Heap& heap = m_heaps[toIndex(kind)];
+
+		desc.NodeMask = 0U;
+		desc.NumDescriptors = count;
+		desc.Type = type;
+		desc.Flags = visible ? D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE : D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+
+		hResult = D3D12Device::getInstance()->CreateDescriptorHeap(
+			&desc,
+			__uuidof(heap.heap),
+			reinterpret_cast<void**>(&heap.heap)
+		);
+		if (FAILED(hResult)) {
+			OutputDebugStringA("ERROR : CREATE FAILED DIREDT3D12 DESCRIPTOR HEAP.\n");
+			return false;
+		}
+
+		heap.cpu = heap.heap->GetCPUDescriptorHandleForHeapStart();
+		heap.gpu = visible ? heap.heap->GetGPUDescriptorHandleForHeapStart() : D3D12_GPU_DESCRIPTOR_HANDLE{};
+		heap.increment = D3D12Device::getInstance()->GetDescriptorHandleIncrementSize(type);
+		return true;
+	}
+
+	D3D12DescriptorAllocator::HeapKind const D3D12DescriptorAllocator::selectHeap(D3D12ViewType const& type) noexcept {
+		switch (type) {
+		case D3D12ViewType::CBV:
+		case D3D12ViewType::SRV:
+		case D3D12ViewType::UAV:
+		case D3D12ViewType::ASV:
+			return HeapKind::Resource;
+		case D3D12ViewType::Sampler:
+			return HeapKind::Sampler;
+		case D3D12ViewType::RTV:
+			return HeapKind::RenderTarget;
+		case D3D12ViewType::DSV:
+			return HeapKind::DepthStencil;
+		default:
+			return HeapKind::Unknown;
+		}
+	}
+
+	unsigned int const D3D12DescriptorAllocator::toIndex(HeapKind const& kind) noexcept {
+		//	一時確保はシェーダから見える CBV / SRV / UAV ヒープの後半にある
+		return kind == HeapKind::Transient ? static_cast<unsigned int>(HeapKind::Resource) : static_cast<unsigned int>(kind);
+	}
+
+	D3D12DescriptorRange const D3D12DescriptorAllocator::makeRange(HeapKind const& kind, D3D12ViewType const& type, unsigned int const& offset, unsigned int const& count) const noexcept {
+		Heap const& heap = m_heaps[toIndex(kind)];
+		D3D12DescriptorRange range = {};
+		range.cpu.ptr = heap.cpu.ptr + static_cast<SIZE_T>(heap.increment) * offset;
+		range.gpu.ptr = heap.gpu.ptr ? heap.gpu.ptr + static_cast<UINT64>(heap.increment) * offset : 0U;
+		range.offset = offset;
+		range.count = count;
+		range.type = type;
+		range.kind = kind;
+		return range;
+	}
+}
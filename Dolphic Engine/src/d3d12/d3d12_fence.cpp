@@ -123,6 +123,40 @@ namespace dlph {
 		return true;
 	}
 
+	bool const D3D12Fence::signal(D3D12CommandQueue const& queue, UINT64 const& value) noexcept {
+		HRESULT hResult = S_OK;
+
+		hResult = queue->Signal(m_fence, value);
+		if (FAILED(hResult)) {
+			OutputDebugStringA("ERROR : SIGNAL PROCESS FAILED.\n");
+			return false;
+		}
+
+		return true;
+	}
+
+	bool const D3D12Fence::waitFor(UINT64 const& value) noexcept {
+		HRESULT hResult = S_OK;
+
+		if (m_fence->GetCompletedValue() >= value) {
+			return true;
+		}
+
+		hResult = m_fence->SetEventOnCompletion(value, m_event);
+		if (FAILED(hResult)) {
+			OutputDebugStringA("ERROR : EVENT SETTING PROCESS FAILED.\n");
+			return false;
+		}
+
+		WaitForSingleObjectEx(m_event, INFINITE, FALSE);
+
+		return true;
+	}
+
+	UINT64 const D3D12Fence::completed() const noexcept {
+		return m_fence->GetCompletedValue();
+	}
+
 	ID3D12Fence1*& D3D12Fence::get() const noexcept {
 		return *const_cast<ID3D12Fence1**>(&m_fence);
 	}
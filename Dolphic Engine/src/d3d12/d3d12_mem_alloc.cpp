@@ -0,0 +1,194 @@
+﻿/**	@file	d3d12_mem_alloc.cpp
+ *	@brief	Direct3D12 用の GPU メモリ確保器
+ */
+#include "d3d12/d3d12_mem_alloc.hpp"
+#include "d3d12/d3d12_device.hpp"
+#include "util/utility.hpp"
+
+namespace dlph {
+	D3D12MemoryAllocator::D3D12MemoryAllocator() noexcept :
+		ISingleton(),
+		m_pages(),
+		m_mutex()
+	{}
+
+	D3D12MemoryAllocator::~D3D12MemoryAllocator() noexcept {
+		exit();
+	}
+
+	bool const D3D12MemoryAllocator::init() noexcept {
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		if (!m_pages.empty()) {
+			return true;
+		}
+		//	最初のヒープだけは先に作っておき、読み込み中の確保で止まらないようにする
+		return createPage(D3D12_MEMORY_PAGE_SIZE) != TLSF_INVALID;
+	}
+
+	void D3D12MemoryAllocator::exit() noexcept {
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		for (Page& page : m_pages) {
+			safe_release(page.heap);
+			page.blocks.exit();
+		}
+		m_pages.clear();
+	}
+
+	D3D12Allocation const D3D12MemoryAllocator::allocate(D3D12_RESOURCE_ALLOCATION_INFO const& info) noexcept {
+		D3D12Allocation result = {};
+		if (info.SizeInBytes == 0U || info.SizeInBytes == UINT64_MAX) {
+			OutputDebugStringA("ERROR : RESOURCE ALLOCATION SIZE IS INVALID.\n");
+			return result;
+		}
+		UINT64 const alignment = info.Alignment > 0U ? info.Alignment : D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		unsigned int page = 0U;
+		unsigned int block = TLSF_INVALID;
+		if (info.SizeInBytes <= D3D12_MEMORY_PAGE_SIZE) {
+			for (; page < m_pages.size(); ++page) {
+				if (m_pages[page].heap == nullptr || m_pages[page].blocks.capacity() != D3D12_MEMORY_PAGE_SIZE) {
+					continue;
+				}
+				block = m_pages[page].blocks.allocate(info.SizeInBytes, alignment);
+				if (block != TLSF_INVALID) {
+					break;
+				}
+			}
+		}
+		if (block == TLSF_INVALID) {
+			//	収まるヒープが無ければ増やす (大きすぎる要求は専用のヒープにする)
+			UINT64 const size = info.SizeInBytes > D3D12_MEMORY_PAGE_SIZE
+				? (info.SizeInBytes + alignment - 1U) & ~(alignment - 1U)
+				: D3D12_MEMORY_PAGE_SIZE;
+			page = createPage(size);
+			if (page == TLSF_INVALID) {
+				return result;
+			}
+			block = m_pages[page].blocks.allocate(info.SizeInBytes, alignment);
+			if (block == TLSF_INVALID) {
+				OutputDebugStringA("ERROR : GPU MEMORY PAGE CAN NOT HOLD THE RESOURCE.\n");
+				return result;
+			}
+		}
+
+		result.heap = m_pages[page].heap;
+		result.offset = m_pages[page].blocks.offset(block);
+		result.size = m_pages[page].blocks.size(block);
+		result.page = page;
+		result.block = block;
+		return result;
+	}
+
+	void D3D12MemoryAllocator::release(D3D12Allocation& allocation) noexcept {
+		if (allocation.heap == nullptr) {
+			return;
+		}
+
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		Page& page = m_pages[allocation.page];
+		page.blocks.release(allocation.block);
+		//	専用のヒープは空になった時点で返す
+		if (page.blocks.used() == 0U && page.blocks.capacity() != D3D12_MEMORY_PAGE_SIZE) {
+			safe_release(page.heap);
+			page.blocks.exit();
+		}
+		allocation = {};
+	}
+
+	bool const D3D12MemoryAllocator::createBuffer(UINT64 const& bytes, D3D12Allocation& allocation, ID3D12Resource2*& resource) noexcept {
+		HRESULT hResult = S_OK;
+
+		D3D12_RESOURCE_DESC desc = {};
+		desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+		desc.Alignment = 0U;
+		desc.Width = bytes;
+		desc.Height = 1U;
+		desc.DepthOrArraySize = 1U;
+		desc.MipLevels = 1U;
+		desc.Format = DXGI_FORMAT_UNKNOWN;
+		desc.SampleDesc.Count = 1U;
+		desc.SampleDesc.Quality = 0U;
+		desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+		desc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+		D3D12_RESOURCE_ALLOCATION_INFO const info = D3D12Device::getInstance()->GetResourceAllocationInfo(0U, 1U, &desc);
+		allocation = allocate(info);
+		if (allocation.heap == nullptr) {
+			return false;
+		}
+
+		//	バッファは COMMON から暗黙に昇格するため、コピー先にも頂点入力にもバリア無しで使える
+		hResult = D3D12Device::getInstance()->CreatePlacedResource(
+			allocation.heap,
+			allocation.offset,
+			&desc,
+			D3D12_RESOURCE_STATE_COMMON,
+			nullptr,
+			__uuidof(resource),
+			reinterpret_cast<void**>(&resource)
+		);
+		if (FAILED(hResult)) {
+			release(allocation);
+			OutputDebugStringA("ERROR : CREATE FAILED PLACED BUFFER RESOURCE.\n");
+			return false;
+		}
+
+		return true;
+	}
+
+	UINT64 const D3D12MemoryAllocator::used() noexcept {
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		UINT64 result = 0U;
+		for (Page const& page : m_pages) {
+			result += page.blocks.used();
+		}
+		return result;
+	}
+
+	UINT64 const D3D12MemoryAllocator::reserved() noexcept {
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		UINT64 result = 0U;
+		for (Page const& page : m_pages) {
+			result += page.blocks.capacity();
+		}
+		return result;
+	}
+
+	unsigned int const D3D12MemoryAllocator::createPage(UINT64 const& size) noexcept {
+		HRESULT hResult = S_OK;
+		D3D12_HEAP_DESC desc = {};
+
+		desc.SizeInBytes = size;
+		desc.Properties.Type = D3D12_HEAP_TYPE_DEFAULT;
+		desc.Properties.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
+		desc.Properties.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
+		desc.Properties.CreationNodeMask = 1U;
+		desc.Properties.VisibleNodeMask = 1U;
+		desc.Alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+		desc.Flags = D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS;
+
+		ID3D12Heap* heap = nullptr;
+		hResult = D3D12Device::getInstance()->CreateHeap(
+			&desc,
+			__uuidof(heap),
+			reinterpret_cast<void**>(&heap)
+		);
+		if (FAILED(hResult)) {
+			OutputDebugStringA("ERROR : CREATE FAILED DIRECT3D12 HEAP.\n");
+			return TLSF_INVALID;
+		}
+
+		//	専用ヒープを返した跡があれば使い回す
+		unsigned int page = 0U;
+		while (page < m_pages.size() && m_pages[page].heap != nullptr) {
+			++page;
+		}
+		if (page == m_pages.size()) {
+			m_pages.emplace_back();
+		}
+		m_pages[page].heap = heap;
+		m_pages[page].blocks.init(size);
+		return page;
+	}
+}
@@ -0,0 +1,363 @@
+﻿/**	@file	d3d12_pso_cache.cpp
+ *	@brief	Direct3D12 用のパイプラインキャッシュ
+ */
+#include "d3d12/d3d12_pso_cache.hpp"
+#include "d3d12/d3d12_device.hpp"
+#include "util/hash.hpp"
+#include "util/utility.hpp"
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace {
+	using namespace dlph;
+
+	/**	@struct	KeyWriter
+	 *	@brief	パイプラインの設定をポインタを含まないバイト列に並べる補助
+	 */
+	struct KeyWriter final {
+		//!	@brief	バイト列
+		std::vector<unsigned char> bytes;
+
+		//!	@brief	値の追加 (構造体は詰め物を含むため、メンバごとに追加すること)
+		template <typename T>
+		void add(T const& value) noexcept {
+			size_t const pos = bytes.size();
+			bytes.resize(pos + sizeof(T));
+			std::memcpy(bytes.data() + pos, &value, sizeof(T));
+		}
+		//!	@brief	文字列の追加
+		void addString(char const* str) noexcept {
+			size_t const length = str ? std::strlen(str) : 0U;
+			add(static_cast<unsigned long long>(length));
+			bytes.insert(bytes.end(), str, str + length);
+		}
+		//!	@brief	シェーダのバイトコードの追加 (内容のハッシュ)
+		void addShader(D3D12_SHADER_BYTECODE const& shader) noexcept {
+			add(static_cast<unsigned long long>(shader.BytecodeLength));
+			add(shader.BytecodeLength > 0U ? hash_bytes(shader.pShaderBytecode, shader.BytecodeLength) : 0ULL);
+		}
+		//!	@brief	ステンシル操作の追加
+		void addStencil(D3D12_DEPTH_STENCILOP_DESC const& op) noexcept {
+			add(op.StencilFailOp);
+			add(op.StencilDepthFailOp);
+			add(op.StencilPassOp);
+			add(op.StencilFunc);
+		}
+		//!	@brief	ハッシュ
+		unsigned long long const hash() const noexcept {
+			return hash_bytes(bytes.data(), bytes.size());
+		}
+	};
+
+	//!	@brief	シェーダのバイトコードの複製
+	D3D12_SHADER_BYTECODE const copyShader(D3D12_SHADER_BYTECODE const& shader, std::vector<unsigned char>& storage) noexcept {
+		unsigned char const* const ptr = static_cast<unsigned char const*>(shader.pShaderBytecode);
+		storage.assign(ptr, ptr + (ptr ? shader.BytecodeLength : 0U));
+		return { storage.empty() ? nullptr : storage.data(), storage.size() };
+	}
+
+	/**	@struct	GraphicsRequest
+	 *	@brief	ワーカースレッドへ渡すグラフィックス用パイプラインの設定の複製
+	 */
+	struct GraphicsRequest final {
+		//!	@brief	設定 (ポインタは以下の複製を指します)
+		D3D12_GRAPHICS_PIPELINE_STATE_DESC desc;
+		//!	@brief	シェーダのバイトコード (VS, PS, DS, HS, GS)
+		std::vector<unsigned char> shaders[5];
+		//!	@brief	頂点入力の要素
+		std::vector<D3D12_INPUT_ELEMENT_DESC> elements;
+		//!	@brief	ストリーム出力の要素
+		std::vector<D3D12_SO_DECLARATION_ENTRY> entries;
+		//!	@brief	ストリーム出力のストライド
+		std::vector<UINT> strides;
+		//!	@brief	セマンティクス名
+		std::vector<std::string> names;
+
+		//!	@brief	コンストラクタ
+		explicit GraphicsRequest(D3D12_GRAPHICS_PIPELINE_STATE_DESC const& src) noexcept :
+			desc(src),
+			shaders(),
+			elements(src.InputLayout.pInputElementDescs, src.InputLayout.pInputElementDescs + src.InputLayout.NumElements),
+			entries(src.StreamOutput.pSODeclaration, src.StreamOutput.pSODeclaration + src.StreamOutput.NumEntries),
+			strides(src.StreamOutput.pBufferStrides, src.StreamOutput.pBufferStrides + src.StreamOutput.NumStrides),
+			names()
+		{
+			desc.VS = copyShader(src.VS, shaders[0]);
+			desc.PS = copyShader(src.PS, shaders[1]);
+			desc.DS = copyShader(src.DS, shaders[2]);
+			desc.HS = copyShader(src.HS, shaders[3]);
+			desc.GS = copyShader(src.GS, shaders[4]);
+
+			//	文字列の位置が動かないよう、先に全て複製してから指し直す
+			names.reserve(elements.size() + entries.size());
+			for (D3D12_INPUT_ELEMENT_DESC const& element : elements) {
+				names.emplace_back(element.SemanticName ? element.SemanticName : "");
+			}
+			for (D3D12_SO_DECLARATION_ENTRY const& entry : entries) {
+				names.emplace_back(entry.SemanticName ? entry.SemanticName : "");
+			}
+			size_t name = 0U;
+			for (D3D12_INPUT_ELEMENT_DESC& element : elements) {
+				element.SemanticName = names[name++].c_str();
+			}
+			for (D3D12_SO_DECLARATION_ENTRY& entry : entries) {
+				entry.SemanticName = entry.SemanticName ? names[name].c_str() : nullptr;
+				++name;
+			}
+			desc.InputLayout.pInputElementDescs = elements.empty() ? nullptr : elements.data();
+			desc.StreamOutput.pSODeclaration = entries.empty() ? nullptr : entries.data();
+			desc.StreamOutput.pBufferStrides = strides.empty() ? nullptr : strides.data();
+			if (desc.pRootSignature) {
+				desc.pRootSignature->AddRef();
+			}
+		}
+		//!	@brief	デストラクタ
+		~GraphicsRequest() noexcept {
+			safe_release(desc.pRootSignature);
+		}
+	};
+
+	/**	@struct	ComputeRequest
+	 *	@brief	ワーカースレッドへ渡すコンピュート用パイプラインの設定の複製
+	 */
+	struct ComputeRequest final {
+		//!	@brief	設定 (ポインタは以下の複製を指します)
+		D3D12_COMPUTE_PIPELINE_STATE_DESC desc;
+		//!	@brief	シェーダのバイトコード
+		std::vector<unsigned char> shader;
+
+		//!	@brief	コンストラクタ
+		explicit ComputeRequest(D3D12_COMPUTE_PIPELINE_STATE_DESC const& src) noexcept :
+			desc(src),
+			shader()
+		{
+			desc.CS = copyShader(src.CS, shader);
+			if (desc.pRootSignature) {
+				desc.pRootSignature->AddRef();
+			}
+		}
+		//!	@brief	デストラクタ
+		~ComputeRequest() noexcept {
+			safe_release(desc.pRootSignature);
+		}
+	};
+
+	/**	@brief	パイプラインの作成
+	 *	@param[in] desc 設定
+	 *	@param[in] data 保存したキャッシュデータ (無ければ nullptr)
+	 *	@param[in] size キャッシュデータのバイト数
+	 *	@param[out] out 次回用のキャッシュデータ
+	 *	@param[in] func 作成関数 HRESULT (Desc&, ID3D12PipelineState*&)
+	 */
+	template <typename Desc, typename F>
+	void* const createPipeline(Desc& desc, unsigned char const* data, size_t const& size, std::vector<unsigned char>& out, F const& func) noexcept {
+		ID3D12PipelineState* pipeline = nullptr;
+		desc.CachedPSO.pCachedBlob = data;
+		desc.CachedPSO.CachedBlobSizeInBytes = data ? size : 0U;
+		HRESULT hResult = func(desc, pipeline);
+		if (FAILED(hResult) && data) {
+			//	ドライバや GPU が変わるとキャッシュデータは受け付けられないため、無しで作り直す
+			desc.CachedPSO = {};
+			hResult = func(desc, pipeline);
+		}
+		if (FAILED(hResult)) {
+			OutputDebugStringA("ERROR : CREATING FAILED DIRECT3D12 PIPELINE STATE.\n");
+			return nullptr;
+		}
+
+		ID3DBlob* blob = nullptr;
+		if (SUCCEEDED(pipeline->GetCachedBlob(&blob))) {
+			unsigned char const* const ptr = static_cast<unsigned char const*>(blob->GetBufferPointer());
+			out.assign(ptr, ptr + blob->GetBufferSize());
+		}
+		safe_release(blob);
+		return pipeline;
+	}
+}
+
+namespace dlph {
+	D3D12PipelineCache::D3D12PipelineCache() noexcept :
+		ISingleton(),
+		m_cache(),
+		m_path()
+	{}
+
+	D3D12PipelineCache::~D3D12PipelineCache() noexcept {
+		exit();
+	}
+
+	bool const D3D12PipelineCache::init(char const* const path, unsigned long long const& tag) noexcept {
+		exit();
+		if (!m_cache.init(tag)) {
+			return false;
+		}
+		if (path) {
+			m_path = path;
+			m_cache.load(path);
+		}
+		return true;
+	}
+
+	void D3D12PipelineCache::exit() noexcept {
+		m_cache.wait();
+		if (!m_path.empty()) {
+			save();
+		}
+		m_cache.release([](void* pipeline) {
+			ID3D12PipelineState* state = static_cast<ID3D12PipelineState*>(pipeline);
+			safe_release(state);
+		});
+		m_cache.exit();
+		m_path.clear();
+	}
+
+	unsigned long long const D3D12PipelineCache::makeKey(D3D12_GRAPHICS_PIPELINE_STATE_DESC const& desc, unsigned long long const& rootKey) noexcept {
+		KeyWriter writer;
+		writer.add(rootKey);
+		writer.addShader(desc.VS);
+		writer.addShader(desc.PS);
+		writer.addShader(desc.DS);
+		writer.addShader(desc.HS);
+		writer.addShader(desc.GS);
+
+		writer.add(desc.StreamOutput.NumEntries);
+		for (UINT idx = 0U; idx < desc.StreamOutput.NumEntries; ++idx) {
+			D3D12_SO_DECLARATION_ENTRY const& entry = desc.StreamOutput.pSODeclaration[idx];
+			writer.add(entry.Stream);
+			writer.addString(entry.SemanticName);
+			writer.add(entry.SemanticIndex);
+			writer.add(entry.StartComponent);
+			writer.add(entry.ComponentCount);
+			writer.add(entry.OutputSlot);
+		}
+		writer.add(desc.StreamOutput.NumStrides);
+		for (UINT idx = 0U; idx < desc.StreamOutput.NumStrides; ++idx) {
+			writer.add(desc.StreamOutput.pBufferStrides[idx]);
+		}
+		writer.add(desc.StreamOutput.RasterizedStream);
+
+		writer.add(desc.BlendState.AlphaToCoverageEnable);
+		writer.add(desc.BlendState.IndependentBlendEnable);
+		for (D3D12_RENDER_TARGET_BLEND_DESC const& target : desc.BlendState.RenderTarget) {
+			writer.add(target.BlendEnable);
+			writer.add(target.LogicOpEnable);
+			writer.add(target.SrcBlend);
+			writer.add(target.DestBlend);
+			writer.add(target.BlendOp);
+			writer.add(target.SrcBlendAlpha);
+			writer.add(target.DestBlendAlpha);
+			writer.add(target.BlendOpAlpha);
+			writer.add(target.LogicOp);
+			writer.add(target.RenderTargetWriteMask);
+		}
+		writer.add(desc.SampleMask);
+
+		writer.add(desc.RasterizerState.FillMode);
+		writer.add(desc.RasterizerState.CullMode);
+		writer.add(desc.RasterizerState.FrontCounterClockwise);
+		writer.add(desc.RasterizerState.DepthBias);
+		writer.add(desc.RasterizerState.DepthBiasClamp);
+		writer.add(desc.RasterizerState.SlopeScaledDepthBias);
+		writer.add(desc.RasterizerState.DepthClipEnable);
+		writer.add(desc.RasterizerState.MultisampleEnable);
+		writer.add(desc.RasterizerState.AntialiasedLineEnable);
+		writer.add(desc.RasterizerState.ForcedSampleCount);
+		writer.add(desc.RasterizerState.ConservativeRaster);
+
+		writer.add(desc.DepthStencilState.DepthEnable);
+		writer.add(desc.DepthStencilState.DepthWriteMask);
+		writer.add(desc.DepthStencilState.DepthFunc);
+		writer.add(desc.DepthStencilState.StencilEnable);
+		writer.add(desc.DepthStencilState.StencilReadMask);
+		writer.add(desc.DepthStencilState.StencilWriteMask);
+		writer.addStencil(desc.DepthStencilState.FrontFace);
+		writer.addStencil(desc.DepthStencilState.BackFace);
+
+		writer.add(desc.InputLayout.NumElements);
+		for (UINT idx = 0U; idx < desc.InputLayout.NumElements; ++idx) {
+			D3D12_INPUT_ELEMENT_DESC const& element = desc.InputLayout.pInputElementDescs[idx];
+			writer.addString(element.SemanticName);
+			writer.add(element.SemanticIndex);
+			writer.add(element.Format);
+			writer.add(element.InputSlot);
+			writer.add(element.AlignedByteOffset);
+			writer.add(element.InputSlotClass);
+			writer.add(element.InstanceDataStepRate);
+		}
+
+		writer.add(desc.IBStripCutValue);
+		writer.add(desc.PrimitiveTopologyType);
+		writer.add(desc.NumRenderTargets);
+		for (DXGI_FORMAT const& format : desc.RTVFormats) {
+			writer.add(format);
+		}
+		writer.add(desc.DSVFormat);
+		writer.add(desc.SampleDesc.Count);
+		writer.add(desc.SampleDesc.Quality);
+		writer.add(desc.NodeMask);
+		writer.add(desc.Flags);
+		return writer.hash();
+	}
+
+	unsigned long long const D3D12PipelineCache::makeKey(D3D12_COMPUTE_PIPELINE_STATE_DESC const& desc, unsigned long long const& rootKey) noexcept {
+		KeyWriter writer;
+		writer.add(rootKey);
+		writer.addShader(desc.CS);
+		writer.add(desc.NodeMask);
+		writer.add(desc.Flags);
+		return writer.hash();
+	}
+
+	ID3D12PipelineState* const D3D12PipelineCache::find(unsigned long long const& key) noexcept {
+		return static_cast<ID3D12PipelineState*>(m_cache.find(key));
+	}
+
+	ID3D12PipelineState* const D3D12PipelineCache::acquire(unsigned long long const& key, D3D12_GRAPHICS_PIPELINE_STATE_DESC const& desc) noexcept {
+		if (ID3D12PipelineState* const state = find(key)) {
+			return state;
+		}
+		if (m_cache.status(key) != PipelineStatus::Missing) {
+			return nullptr;
+		}
+		//	ジョブより呼び出し元の設定が先に消えるため、指す先まで複製して渡す
+		std::unique_ptr<GraphicsRequest> request(new GraphicsRequest(desc));
+		m_cache.request(key, [request = std::move(request)](unsigned char const* data, size_t const& size, std::vector<unsigned char>& out) {
+			return createPipeline(request->desc, data, size, out, [](D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, ID3D12PipelineState*& pipeline) {
+				return D3D12Device::getInstance()->CreateGraphicsPipelineState(&desc, __uuidof(pipeline), reinterpret_cast<void**>(&pipeline));
+			});
+		});
+		return find(key);
+	}
+
+	ID3D12PipelineState* const D3D12PipelineCache::acquire(unsigned long long const& key, D3D12_COMPUTE_PIPELINE_STATE_DESC const& desc) noexcept {
+		if (ID3D12PipelineState* const state = find(key)) {
+			return state;
+		}
+		if (m_cache.status(key) != PipelineStatus::Missing) {
+			return nullptr;
+		}
+		std::unique_ptr<ComputeRequest> request(new ComputeRequest(desc));
+		m_cache.request(key, [request = std::move(request)](unsigned char const* data, size_t const& size, std::vector<unsigned char>& out) {
+			return createPipeline(request->desc, data, size, out, [](D3D12_COMPUTE_PIPELINE_STATE_DESC& desc, ID3D12PipelineState*& pipeline) {
+				return D3D12Device::getInstance()->CreateComputePipelineState(&desc, __uuidof(pipeline), reinterpret_cast<void**>(&pipeline));
+			});
+		});
+		return find(key);
+	}
+
+	void D3D12PipelineCache::wait() noexcept {
+		m_cache.wait();
+	}
+
+	bool const D3D12PipelineCache::save() noexcept {
+		if (m_path.empty()) {
+			return false;
+		}
+		return m_cache.save(m_path.c_str());
+	}
+
+	PipelineCacheStats const D3D12PipelineCache::stats() const noexcept {
+		return m_cache.stats();
+	}
+}
@@ -0,0 +1,88 @@
+﻿/**	@file	d3d12_release_queue.cpp
+ *	@brief	Direct3D12 用の遅延解放キュー
+ */
+#include "d3d12/d3d12_release_queue.hpp"
+#include "util/utility.hpp"
+
+namespace dlph {
+	D3D12ReleaseQueue::D3D12ReleaseQueue() noexcept :
+		ISingleton(),
+		m_entries(),
+		m_value(1U),
+		m_mutex()
+	{}
+
+	D3D12ReleaseQueue::~D3D12ReleaseQueue() noexcept {
+		exit();
+	}
+
+	bool const D3D12ReleaseQueue::init() noexcept {
+		flush();
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		m_value = 1U;
+		return true;
+	}
+
+	void D3D12ReleaseQueue::exit() noexcept {
+		flush();
+	}
+
+	void D3D12ReleaseQueue::retire(ID3D12Resource2*& resource) noexcept {
+		if (resource == nullptr) {
+			return;
+		}
+
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		m_entries.push_back({ m_value, resource, {}, {} });
+		resource = nullptr;
+	}
+
+	void D3D12ReleaseQueue::retire(D3D12Allocation& allocation) noexcept {
+		if (allocation.heap == nullptr) {
+			return;
+		}
+
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		m_entries.push_back({ m_value, nullptr, allocation, {} });
+		allocation = {};
+	}
+
+	void D3D12ReleaseQueue::retire(D3D12DescriptorRange& range) noexcept {
+		if (range.count == 0U) {
+			return;
+		}
+
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		m_entries.push_back({ m_value, nullptr, {}, range });
+		range = {};
+	}
+
+	void D3D12ReleaseQueue::beginFrame(UINT64 const& completed, UINT64 const& value) noexcept {
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		size_t count = 0U;
+		while (count < m_entries.size() && m_entries[count].value <= completed) {
+			++count;
+		}
+		release(count);
+		m_value = value;
+	}
+
+	void D3D12ReleaseQueue::flush() noexcept {
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		release(m_entries.size());
+	}
+
+	void D3D12ReleaseQueue::release(size_t const& count) noexcept {
+		if (count == 0U) {
+			return;
+		}
+
+		for (size_t idx = 0U; idx < count; ++idx) {
+			Entry& entry = m_entries[idx];
+			safe_release(entry.resource);
+			D3D12MemoryAllocator::getInstance().release(entry.allocation);
+			D3D12DescriptorAllocator::getInstance().release(entry.range);
+		}
+		m_entries.erase(m_entries.begin(), m_entries.begin() + static_cast<std::ptrdiff_t>(count));
+	}
+}
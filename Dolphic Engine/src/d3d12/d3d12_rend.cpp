@@ -3,6 +3,12 @@
  */
 #include "d3d12/d3d12_rend.hpp"
 #include "d3d12/d3d12_device.hpp"
+#include "d3d12/d3d12_desc_alloc.hpp"
+#include "d3d12/d3d12_mem_alloc.hpp"
+#include "d3d12/d3d12_upload.hpp"
+#include "d3d12/d3d12_release_queue.hpp"
+#include "d3d12/d3d12_const_alloc.hpp"
+#include "d3d12/d3d12_pso_cache.hpp"
 #include "util/utility.hpp"
 
 namespace dlph {
@@ -13,7 +19,12 @@ namespace dlph {
 		m_dsv(),
 		m_chain(),
 		m_queue(),
-		m_list(),
+		m_pacer(),
+		m_lists(),
+		m_list(nullptr),
+		m_resources(),
+		m_constants(),
+		m_transients(),
 		m_fence(),
 		m_rect(),
 		m_viewport(),
@@ -55,6 +66,31 @@ namespace dlph {
 			return false;
 		}
 
+		if (!D3D12DescriptorAllocator::getInstance().init()) {
+			return false;
+		}
+
+		if (!D3D12MemoryAllocator::getInstance().init()) {
+			return false;
+		}
+
+		if (!D3D12UploadQueue::getInstance().init()) {
+			return false;
+		}
+
+		if (!D3D12ReleaseQueue::getInstance().init()) {
+			return false;
+		}
+
+		if (!D3D12ConstantAllocator::getInstance().init()) {
+			return false;
+		}
+		m_constants = m_resources.registerResource(D3D12ConstantAllocator::getInstance().getBuffer());
+
+		if (!D3D12PipelineCache::getInstance().init(desc.pipelineCache)) {
+			return false;
+		}
+
 		if (!m_queue.init(D3D12CommandType::Direct)) {
 			return false;
 		}
@@ -69,7 +105,16 @@ namespace dlph {
 			return false;
 		}
 
-		if (!m_list.init(D3D12CommandType::Direct)) {
+		if (!m_pacer.init(desc.latency > 0U ? desc.latency : FRAME_LATENCY_DEFAULT)) {
+			return false;
+		}
+
+		//	アロケータはバックバッファではなく、同時に処理するフレームの数だけ用意する
+		if (!m_lists.init(m_pacer.latency(), D3D12_CMD_LIST_CNT, D3D12_CMD_LIST_RESERVED, D3D12CommandType::Direct)) {
+			return false;
+		}
+
+		if (!m_fence.init()) {
 			return false;
 		}
 
@@ -112,8 +157,13 @@ namespace dlph {
 		unsigned int height = static_cast<unsigned int>(labs(rect.bottom - rect.top));
 
 		if (width > 0U && height > 0U) {
+			flush();
+
+			m_barrier.clear();
 			m_rtv.exit();
 			m_dsv.exit();
+			//	バックバッファの参照が残っていると ResizeBuffers が失敗するため、GPU が止まっている今すぐ返す
+			D3D12ReleaseQueue::getInstance().flush();
 
 			HRESULT hResult = m_chain->ResizeBuffers(
 				m_bufferCount,
@@ -152,14 +202,29 @@ namespace dlph {
 	}
 
 	void D3D12Renderer::exit() noexcept {
+		flush();
+
+		m_transients.exit(m_resources);
+		m_resources.clear();
+		m_constants = {};
+		m_barrier.clear();
 		m_rtv.exit();
 		m_dsv.exit();
 
 		m_chain.exit();
 
+		m_fence.exit();
 		m_queue.exit();
-		m_list.exit();
-
+		m_lists.exit();
+		m_list = nullptr;
+		m_pacer.exit();
+
+		D3D12PipelineCache::getInstance().exit();
+		D3D12ConstantAllocator::getInstance().exit();
+		D3D12ReleaseQueue::getInstance().exit();
+		D3D12UploadQueue::getInstance().exit();
+		D3D12MemoryAllocator::getInstance().exit();
+		D3D12DescriptorAllocator::getInstance().exit();
 		D3D12Device::getInstance().exit();
 
 		return;
@@ -170,37 +235,73 @@ namespace dlph {
 
 		m_currentIndex = m_chain->GetCurrentBackBufferIndex();
 
-		if (!m_list.recording()) {
+		//	この slot を前回使ったフレームが GPU で終わっていなければ、そこまでだけ待つ
+		if (!m_fence.waitFor(m_pacer.pending())) {
 			return false;
 		}
 
-		rtv = m_rtv.getDescriptorHandle(m_currentIndex).cpu;
-		dsv = m_dsv.getDescriptorHandle(0).cpu;
+		//	GPU が終えたフレームで手放されたリソースを返し、以降の解放はこのフレームの値で預ける
+		D3D12ReleaseQueue::getInstance().beginFrame(m_fence.completed(), m_pacer.last() + 1U);
+		//	GPU が読み終えた一時記述子の領域を返す
+		D3D12DescriptorAllocator::getInstance().beginFrame(m_pacer.slot());
+		D3D12UploadQueue::getInstance().beginFrame(m_pacer.slot());
+		D3D12ConstantAllocator::getInstance().beginFrame(m_pacer.slot());
 
-		m_barrier.toRenderTargetMode(m_list, m_rtv[m_currentIndex]);
+		if (!m_lists.begin(m_pacer.slot())) {
+			return false;
+		}
 
-		m_list->OMSetRenderTargets(1U, &rtv, false, &dsv);
+		m_list = m_lists.acquire(D3D12_ORDER_FIRST);
+		if (!m_list) {
+			return false;
+		}
 
-		m_list->ClearDepthStencilView(dsv, D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0U, 0U, nullptr);
+		rtv = m_rtv.getDescriptorHandle(m_currentIndex).cpu;
+		dsv = m_dsv.getDescriptorHandle(0).cpu;
+
+		m_barrier.toRenderTargetMode(*m_list, m_rtv[m_currentIndex]);
 
-		m_list->ClearRenderTargetView(rtv, static_cast<float*>(m_color.p), 0, nullptr);
+		bindTargets(*m_list);
 
-		m_list->RSSetViewports(1, &m_viewport);
+		(*m_list)->ClearDepthStencilView(dsv, D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0U, 0U, nullptr);
 
-		m_list->RSSetScissorRects(1, &m_rect);
+		(*m_list)->ClearRenderTargetView(rtv, static_cast<float*>(m_color.p), 0, nullptr);
 
 		return true;
 	}
 
 	bool const D3D12Renderer::after_rendering() noexcept {
-		m_barrier.toPresentMode(m_list, m_rtv[m_currentIndex]);
+		//	記録スレッドが使い切っても末尾のリストは予約分から取れる
+		D3D12CommandList* const last = m_lists.acquireReserved(D3D12_ORDER_LAST);
+		if (!last) {
+			//	開いたままのリストを次にこの slot でリセットしないよう、提出せずに閉じておく
+			m_lists.finish([](D3D12CommandList&) {});
+			return false;
+		}
 
-		m_list.closing();
+		m_barrier.toPresentMode(*last, m_rtv[m_currentIndex]);
 
-		ID3D12CommandList* pCmdLists[] = { m_list.get() };
-		m_queue->ExecuteCommandLists(1U, pCmdLists);
+		//	予約された記述子のコピーは提出前にまとめて行う
+		D3D12DescriptorAllocator::getInstance().flush();
+		D3D12DescriptorAllocator::getInstance().endFrame(m_pacer.slot());
 
-		return true;
+		//	このフレームで積んだ転送を先に提出し、描画キューには GPU 側で完了を待たせる
+		if (!D3D12UploadQueue::getInstance().submit(m_queue)) {
+			m_lists.finish([](D3D12CommandList&) {});
+			return false;
+		}
+		D3D12UploadQueue::getInstance().endFrame(m_pacer.slot());
+
+		//	記録したスレッドに関係なく提出順序で並べ、一度の呼び出しで提出する
+		ID3D12CommandList* pCmdLists[D3D12_CMD_LIST_CNT];
+		UINT count = 0U;
+		m_lists.finish([&pCmdLists, &count](D3D12CommandList& list) {
+			pCmdLists[count++] = list.get();
+		});
+		m_queue->ExecuteCommandLists(count, pCmdLists);
+
+		//	完了は待たず、次にこの slot を使うときに before_rendering で確かめる
+		return m_fence.signal(m_queue, m_pacer.submit());
 	}
 
 	bool const D3D12Renderer::presenting() noexcept {
@@ -216,7 +317,53 @@ namespace dlph {
 	}
 
 	D3D12CommandList& D3D12Renderer::getCmdList() noexcept {
-		return m_list;
+		return *m_list;
+	}
+
+	D3D12CommandList* const D3D12Renderer::acquireCmdList(unsigned int const& order) noexcept {
+		D3D12CommandList* const list = m_lists.acquire(order);
+		if (list) {
+			bindTargets(*list);
+		}
+		return list;
+	}
+
+	bool const D3D12Renderer::execute(RenderCommandStream const& stream, unsigned int const& order) noexcept {
+		D3D12CommandList* const list = acquireCmdList(order);
+		if (list == nullptr) {
+			OutputDebugStringA("ERROR : COMMAND LIST POOL IS EXHAUSTED.\n");
+			return false;
+		}
+		D3D12CommandBackend backend(m_resources, *list);
+		RenderStateFilter filter(backend);
+		stream.submit(filter);
+		backend.flush();
+		return true;
+	}
+
+	bool const D3D12Renderer::recordBatches(DrawBatcher& batcher, RenderCommandStream& stream, RenderPipeline const& pipeline, unsigned int const& layer, unsigned int const& pass) noexcept {
+		if (batcher.instanceCount() == 0U) {
+			return true;
+		}
+		D3D12ConstantAllocator& constants = D3D12ConstantAllocator::getInstance();
+		D3D12ConstantRange const range = constants.allocate(batcher.bytes());
+		if (range.cpu == nullptr) {
+			OutputDebugStringA("ERROR : NOT ENOUGH SPACE FOR INSTANCE DATA.\n");
+			return false;
+		}
+		if (!batcher.build(range.cpu, static_cast<size_t>(range.size))) {
+			return false;
+		}
+		batcher.record(stream, pipeline, m_constants, constants.getOffset(range), layer, pass);
+		return true;
+	}
+
+	bool const D3D12Renderer::realize(FrameGraph& graph, D3D12_RESOURCE_DESC const* descs) noexcept {
+		return m_transients.realize(m_pacer.slot(), graph, descs, m_resources);
+	}
+
+	D3D12ResourceTable& D3D12Renderer::getResourceTable() noexcept {
+		return m_resources;
 	}
 
 	D3D12_RECT const D3D12Renderer::getTrimRect() const noexcept {
@@ -246,4 +393,30 @@ namespace dlph {
 	unsigned int const D3D12Renderer::getCurrentBufferIndex() const noexcept {
 		return m_chain->GetCurrentBackBufferIndex();
 	}
+
+	void D3D12Renderer::flush() noexcept {
+		if (m_fence.get() && m_pacer.last() > 0U) {
+			m_fence.waitFor(m_pacer.last());
+		}
+	}
+
+	void D3D12Renderer::bindTargets(D3D12CommandList& list) noexcept {
+		D3D12_CPU_DESCRIPTOR_HANDLE rtv, dsv;
+
+		rtv = m_rtv.getDescriptorHandle(m_currentIndex).cpu;
+		dsv = m_dsv.getDescriptorHandle(0).cpu;
+
+		//	シェーダから見えるヒープは全体で一組だけなので、記録の最初に一度設定すれば切り替えは不要
+		ID3D12DescriptorHeap* const heaps[] = {
+			D3D12DescriptorAllocator::getInstance().getResourceHeap(),
+			D3D12DescriptorAllocator::getInstance().getSamplerHeap(),
+		};
+		list->SetDescriptorHeaps(2U, heaps);
+
+		list->OMSetRenderTargets(1U, &rtv, false, &dsv);
+
+		list->RSSetViewports(1, &m_viewport);
+
+		list->RSSetScissorRects(1, &m_rect);
+	}
 }
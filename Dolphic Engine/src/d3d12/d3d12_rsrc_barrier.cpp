@@ -1,32 +1,114 @@
-/**	@file	d3d12_rsrc_barrier.cpp
+﻿/**	@file	d3d12_rsrc_barrier.cpp
  *	@brief	Direct3D12 用のリソースバリアクラス定義ファイル
  */
 #include "d3d12/d3d12_rsrc_barrier.hpp"
+#include "d3d12/d3d12_cmd_backend.hpp"
+
+namespace {
+	using namespace dlph;
+
+	//!	@brief	リソースから状態追跡器の識別子への変換
+	inline unsigned long long const toKey(ID3D12Resource* rsrc) noexcept {
+		return static_cast<unsigned long long>(reinterpret_cast<uintptr_t>(rsrc));
+	}
+
+	//!	@brief	状態追跡器の識別子からリソースへの変換
+	inline ID3D12Resource* const toResource(unsigned long long const& key) noexcept {
+		return reinterpret_cast<ID3D12Resource*>(static_cast<uintptr_t>(key));
+	}
+}
 
 namespace dlph {
 	D3D12ResourceBarrier::D3D12ResourceBarrier() noexcept :
-		m_barrier()
+		INoncopyable(),
+		m_tracker(),
+		m_descs()
 	{}
 
+	void D3D12ResourceBarrier::track(ID3D12Resource* rsrc, ResourceState const& state, UINT const& subresources) noexcept {
+		m_tracker.track(toKey(rsrc), state, subresources);
+	}
+
+	void D3D12ResourceBarrier::untrack(ID3D12Resource* rsrc) noexcept {
+		m_tracker.untrack(toKey(rsrc));
+	}
+
+	bool const D3D12ResourceBarrier::tracked(ID3D12Resource* rsrc) const noexcept {
+		return m_tracker.tracked(toKey(rsrc));
+	}
+
+	void D3D12ResourceBarrier::clear() noexcept {
+		m_tracker.clear();
+	}
+
+	bool const D3D12ResourceBarrier::transition(ID3D12Resource* rsrc, ResourceState const& after, UINT const& subresource) noexcept {
+		return m_tracker.transition(toKey(rsrc), after, subresource);
+	}
+
+	void D3D12ResourceBarrier::uav(ID3D12Resource* rsrc) noexcept {
+		m_tracker.uav(toKey(rsrc));
+	}
+
+	void D3D12ResourceBarrier::push(ID3D12Resource* rsrc, ResourceState const& before, ResourceState const& after, BarrierKind const& kind, UINT const& subresource) noexcept {
+		m_tracker.barrier({ toKey(rsrc), subresource, before, after, kind });
+	}
+
+	bool const D3D12ResourceBarrier::pending() const noexcept {
+		return m_tracker.pending();
+	}
+
+	void D3D12ResourceBarrier::flush(D3D12CommandList& list) noexcept {
+		if (!m_tracker.pending()) {
+			return;
+		}
+		m_descs.clear();
+		m_tracker.flush([this](StateTransition const& barrier) {
+			D3D12_RESOURCE_BARRIER desc = {};
+			switch (barrier.kind) {
+			case BarrierKind::UnorderedAccess:
+				desc.Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
+				desc.UAV.pResource = toResource(barrier.resource);
+				break;
+			case BarrierKind::Aliasing:
+				//	直前にメモリを使っていたリソースは問わない (nullptr)
+				desc.Type = D3D12_RESOURCE_BARRIER_TYPE_ALIASING;
+				desc.Aliasing.pResourceBefore = nullptr;
+				desc.Aliasing.pResourceAfter = toResource(barrier.resource);
+				break;
+			default:
+				desc.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+				desc.Transition.pResource = toResource(barrier.resource);
+				desc.Transition.Subresource = barrier.subresource;
+				desc.Transition.StateBefore = to_d3d12_state(barrier.before);
+				desc.Transition.StateAfter = to_d3d12_state(barrier.after);
+				break;
+			}
+			desc.Flags = barrier.kind == BarrierKind::Begin ? D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY
+				: (barrier.kind == BarrierKind::End ? D3D12_RESOURCE_BARRIER_FLAG_END_ONLY : D3D12_RESOURCE_BARRIER_FLAG_NONE);
+			m_descs.push_back(desc);
+		});
+		list->ResourceBarrier(static_cast<UINT>(m_descs.size()), m_descs.data());
+	}
+
+	StateTrackerStats const& D3D12ResourceBarrier::stats() const noexcept {
+		return m_tracker.stats();
+	}
+
 	D3D12ResourceBarrier& D3D12ResourceBarrier::toRenderTargetMode(D3D12CommandList& list, ID3D12Resource2*& rsrc) noexcept {
-		m_barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-		m_barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
-		m_barrier.Transition.pResource = rsrc;
-		m_barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_PRESENT;
-		m_barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_RENDER_TARGET;
-		m_barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-		list->ResourceBarrier(1, &m_barrier);
+		if (!tracked(rsrc)) {
+			track(rsrc, ResourceState::Present);
+		}
+		transition(rsrc, ResourceState::RenderTarget);
+		flush(list);
 		return *this;
 	}
 
 	D3D12ResourceBarrier& D3D12ResourceBarrier::toPresentMode(D3D12CommandList& list, ID3D12Resource2*& rsrc) noexcept {
-		m_barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-		m_barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
-		m_barrier.Transition.pResource = rsrc;
-		m_barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
-		m_barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_PRESENT;
-		m_barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-		list->ResourceBarrier(1, &m_barrier);
+		if (!tracked(rsrc)) {
+			track(rsrc, ResourceState::RenderTarget);
+		}
+		transition(rsrc, ResourceState::Present);
+		flush(list);
 		return *this;
 	}
 }
@@ -11,21 +11,26 @@ namespace dlph {
 		D3D12Shader()
 	{
 		m_shader = arg.m_shader;
+		m_view = arg.m_view;
 		arg.m_shader = nullptr;
+		arg.m_view = {};
 	}
 
 	D3D12Shader& D3D12Shader::operator=(D3D12Shader&& rhs) & noexcept {
 		uninit();
 
 		m_shader = rhs.m_shader;
+		m_view = rhs.m_view;
 		rhs.m_shader = nullptr;
+		rhs.m_view = {};
 
 		return *this;
 	}
 
 	D3D12Shader::D3D12Shader() noexcept :
 		INoncopyable(),
-		m_shader(nullptr)
+		m_shader(nullptr),
+		m_view()
 	{}
 
 	D3D12Shader::~D3D12Shader() noexcept {
@@ -33,6 +38,7 @@ namespace dlph {
 	}
 
 	bool const D3D12Shader::init(wchar_t const* const& path) noexcept {
+		uninit();
 		std::wstring name = path;
 		HRESULT hResult = D3DReadFileToBlob(name.c_str(), &m_shader);
 		if (FAILED(hResult)) {
@@ -42,12 +48,28 @@ namespace dlph {
 		return true;
 	}
 
+	bool const D3D12Shader::init(ShaderLibrary const& library, char const* const name) noexcept {
+		uninit();
+		m_view = library.find(name);
+		if (m_view.data == nullptr) {
+			OutputDebugStringA("ERROR : SHADER IS NOT FOUND IN SHADER LIBRARY.\n");
+			return false;
+		}
+		return true;
+	}
+
 	void D3D12Shader::uninit() noexcept {
 		safe_release(m_shader);
+		m_view = {};
 	}
 
 	D3D12_SHADER_BYTECODE const D3D12Shader::get() const noexcept {
 		D3D12_SHADER_BYTECODE result;
+		if (m_shader == nullptr) {
+			result.pShaderBytecode = m_view.data;
+			result.BytecodeLength = m_view.size;
+			return result;
+		}
 		result.pShaderBytecode = m_shader->GetBufferPointer();
 		result.BytecodeLength = m_shader->GetBufferSize();
 		return result;
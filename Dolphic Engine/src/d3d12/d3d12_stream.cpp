@@ -0,0 +1,240 @@
+﻿/**	@file	d3d12_stream.cpp
+ *	@brief	Direct3D12 用の非同期転送器
+ */
+#include "d3d12/d3d12_stream.hpp"
+#include "d3d12/d3d12_device.hpp"
+#include "util/utility.hpp"
+
+namespace dlph {
+	D3D12TransferEngine::D3D12TransferEngine() noexcept :
+		ITransferEngine(),
+		INonmovable(),
+		m_table(nullptr),
+		m_buffer(nullptr),
+		m_mapped(nullptr),
+		m_size(0U),
+		m_queue(),
+		m_lists(),
+		m_values(),
+		m_current(0U),
+		m_recording(false),
+		m_fence(),
+		m_value(0U)
+	{}
+
+	D3D12TransferEngine::~D3D12TransferEngine() noexcept {
+		exit();
+	}
+
+	bool const D3D12TransferEngine::init(D3D12ResourceTable const& table, UINT64 const& size) noexcept {
+		if (m_buffer) {
+			return true;
+		}
+		HRESULT hResult = S_OK;
+
+		if (size == 0U) {
+			OutputDebugStringA("ERROR : STREAM STAGING SIZE IS INVALID.\n");
+			return false;
+		}
+
+		D3D12_HEAP_PROPERTIES prop = {};
+		prop.Type = D3D12_HEAP_TYPE_UPLOAD;
+		prop.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
+		prop.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
+		prop.CreationNodeMask = 1U;
+		prop.VisibleNodeMask = 1U;
+
+		D3D12_RESOURCE_DESC desc = {};
+		desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+		desc.Alignment = 0U;
+		desc.Width = size;
+		desc.Height = 1U;
+		desc.DepthOrArraySize = 1U;
+		desc.MipLevels = 1U;
+		desc.Format = DXGI_FORMAT_UNKNOWN;
+		desc.SampleDesc.Count = 1U;
+		desc.SampleDesc.Quality = 0U;
+		desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+		desc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+		hResult = D3D12Device::getInstance()->CreateCommittedResource(
+			&prop,
+			D3D12_HEAP_FLAG_NONE,
+			&desc,
+			D3D12_RESOURCE_STATE_GENERIC_READ,
+			nullptr,
+			__uuidof(m_buffer),
+			reinterpret_cast<void**>(&m_buffer)
+		);
+		if (FAILED(hResult)) {
+			OutputDebugStringA("ERROR : COMMITING FAILED STREAM STAGING RESOURCE.\n");
+			return false;
+		}
+
+		D3D12_RANGE const none = { 0U, 0U };
+		hResult = m_buffer->Map(0U, &none, reinterpret_cast<void**>(&m_mapped));
+		if (FAILED(hResult)) {
+			exit();
+			OutputDebugStringA("ERROR : MAPPING FAILED STREAM STAGING RESOURCE.\n");
+			return false;
+		}
+		m_size = size;
+
+		if (!m_queue.init(D3D12CommandType::Copy) || !m_fence.init()) {
+			exit();
+			return false;
+		}
+		for (D3D12CommandList& list : m_lists) {
+			if (!list.init(D3D12CommandType::Copy)) {
+				exit();
+				return false;
+			}
+		}
+
+		m_table = &table;
+		return true;
+	}
+
+	void D3D12TransferEngine::exit() noexcept {
+		if (m_fence.get()) {
+			m_fence.waitFor(m_value);
+		}
+		if (m_recording) {
+			m_lists[m_current].closing();
+			m_recording = false;
+		}
+		m_fence.exit();
+		for (D3D12CommandList& list : m_lists) {
+			list.exit();
+		}
+		for (UINT64& value : m_values) {
+			value = 0U;
+		}
+		m_queue.exit();
+		if (m_buffer && m_mapped) {
+			m_buffer->Unmap(0U, nullptr);
+		}
+		m_mapped = nullptr;
+		safe_release(m_buffer);
+		m_size = 0U;
+		m_current = 0U;
+		m_value = 0U;
+		m_table = nullptr;
+	}
+
+	unsigned char* const D3D12TransferEngine::staging() noexcept {
+		return m_mapped;
+	}
+
+	unsigned long long const D3D12TransferEngine::stagingSize() const noexcept {
+		return m_size;
+	}
+
+	unsigned long long const D3D12TransferEngine::placementAlignment() const noexcept {
+		return D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT;
+	}
+
+	unsigned long long const D3D12TransferEngine::pitchAlignment() const noexcept {
+		return D3D12_TEXTURE_DATA_PITCH_ALIGNMENT;
+	}
+
+	bool const D3D12TransferEngine::copy(StreamCopy const& copy) noexcept {
+		if (m_table == nullptr) {
+			return false;
+		}
+		ID3D12Resource* const dst = m_table->getResource(copy.target);
+		if (dst == nullptr) {
+			OutputDebugStringA("ERROR : STREAM DESTINATION IS NOT REGISTERED.\n");
+			return false;
+		}
+
+		if (!m_recording) {
+			//	リストが一周したときだけ、そのリストのコピーの完了を待つ
+			if (!m_fence.waitFor(m_values[m_current]) || !m_lists[m_current].recording()) {
+				return false;
+			}
+			m_recording = true;
+		}
+
+		if (copy.type == StreamTarget::Texture) {
+			return copyTexture(dst, copy);
+		}
+		m_lists[m_current]->CopyBufferRegion(dst, copy.offset, m_buffer, copy.staging, copy.size);
+		return true;
+	}
+
+	unsigned long long const D3D12TransferEngine::submit() noexcept {
+		if (m_recording) {
+			m_recording = false;
+			if (!m_lists[m_current].closing()) {
+				return 0U;
+			}
+			ID3D12CommandList* const lists[] = { m_lists[m_current].get() };
+			m_queue->ExecuteCommandLists(1U, lists);
+			m_values[m_current] = m_value + 1U;
+			m_current = (m_current + 1U) % D3D12_STREAM_LIST_COUNT;
+		}
+		if (!m_fence.signal(m_queue, m_value + 1U)) {
+			return 0U;
+		}
+		return ++m_value;
+	}
+
+	unsigned long long const D3D12TransferEngine::completed() noexcept {
+		return m_fence.completed();
+	}
+
+	void D3D12TransferEngine::wait(unsigned long long const& value) noexcept {
+		m_fence.waitFor(value);
+	}
+
+	bool const D3D12TransferEngine::queueWait(D3D12CommandQueue const& waiter, UINT64 const& value) const noexcept {
+		HRESULT hResult = S_OK;
+
+		hResult = waiter->Wait(m_fence.get(), value);
+		if (FAILED(hResult)) {
+			OutputDebugStringA("ERROR : QUEUE WAIT SETTING FAILED.\n");
+			return false;
+		}
+
+		return true;
+	}
+
+	D3D12CommandQueue const& D3D12TransferEngine::queue() const noexcept {
+		return m_queue;
+	}
+
+	bool const D3D12TransferEngine::copyTexture(ID3D12Resource* dst, StreamCopy const& copy) noexcept {
+		D3D12_RESOURCE_DESC const desc = dst->GetDesc();
+		D3D12_PLACED_SUBRESOURCE_FOOTPRINT layout = {};
+		UINT rowCount = 0U;
+		UINT64 rowSize = 0U;
+		D3D12Device::getInstance()->GetCopyableFootprints(&desc, copy.subresource, 1U, 0U, &layout, &rowCount, &rowSize, nullptr);
+
+		//	ボリュームテクスチャの奥行きは分けられないので一枚のものだけを扱う
+		if (layout.Footprint.Depth != 1U || rowCount == 0U || rowSize != copy.rowSize || copy.offset + copy.rows > rowCount) {
+			OutputDebugStringA("ERROR : STREAM TEXTURE COPY DOES NOT MATCH FOOTPRINT.\n");
+			return false;
+		}
+		//	圧縮形式では一行がブロックの高さ分のピクセルになる (端数のある小さな mip も含めて切り上げる)
+		UINT const blockHeight = (layout.Footprint.Height + rowCount - 1U) / rowCount;
+
+		D3D12_TEXTURE_COPY_LOCATION dstLoc = {};
+		dstLoc.pResource = dst;
+		dstLoc.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+		dstLoc.SubresourceIndex = copy.subresource;
+
+		D3D12_TEXTURE_COPY_LOCATION srcLoc = {};
+		srcLoc.pResource = m_buffer;
+		srcLoc.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+		srcLoc.PlacedFootprint.Offset = copy.staging;
+		srcLoc.PlacedFootprint.Footprint.Format = layout.Footprint.Format;
+		srcLoc.PlacedFootprint.Footprint.Width = layout.Footprint.Width;
+		srcLoc.PlacedFootprint.Footprint.Height = copy.rows * blockHeight;
+		srcLoc.PlacedFootprint.Footprint.Depth = 1U;
+		srcLoc.PlacedFootprint.Footprint.RowPitch = copy.rowPitch;
+
+		m_lists[m_current]->CopyTextureRegion(&dstLoc, 0U, static_cast<UINT>(copy.offset) * blockHeight, 0U, &srcLoc, nullptr);
+		return true;
+	}
+}
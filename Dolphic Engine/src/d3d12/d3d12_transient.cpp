@@ -0,0 +1,141 @@
+﻿/**	@file	d3d12_transient.cpp
+ *	@brief	フレームグラフの一時リソース用ヒープ
+ */
+#include "d3d12/d3d12_transient.hpp"
+#include "d3d12/d3d12_device.hpp"
+#include "util/utility.hpp"
+#include <crtdbg.h>
+#include <cstring>
+
+namespace dlph {
+	D3D12TransientHeap::D3D12TransientHeap() noexcept :
+		INonmovable(),
+		m_frames()
+	{
+		for (Frame& frame : m_frames) {
+			frame.heap = nullptr;
+			frame.size = 0U;
+		}
+	}
+
+	D3D12TransientHeap::~D3D12TransientHeap() noexcept {
+#if	defined(_DEBUG) || defined(DEBUG)
+		for (Frame const& frame : m_frames) {
+			_ASSERT_EXPR(frame.heap == nullptr, L"ERROR : TRANSIENT HEAP IS NOT RELEASED.");
+		}
+#endif
+	}
+
+	void D3D12TransientHeap::exit(D3D12ResourceTable& table) noexcept {
+		for (Frame& frame : m_frames) {
+			release(frame, table);
+		}
+	}
+
+	FrameGraphResourceDesc const D3D12TransientHeap::describe(D3D12_RESOURCE_DESC const& desc) noexcept {
+		D3D12_RESOURCE_ALLOCATION_INFO const info = D3D12Device::getInstance()->GetResourceAllocationInfo(0U, 1U, &desc);
+		return { info.SizeInBytes, info.Alignment };
+	}
+
+	bool const D3D12TransientHeap::realize(unsigned int const& slot, FrameGraph& graph, D3D12_RESOURCE_DESC const* descs, D3D12ResourceTable& table) noexcept {
+		if (slot >= FRAME_LATENCY_MAX || descs == nullptr) {
+			OutputDebugStringA("ERROR : TRANSIENT HEAP ARGUMENT IS INVALID.\n");
+			return false;
+		}
+		Frame& frame = m_frames[slot];
+
+		//	足りなければ作り直す。置いていたリソースは全て新しいヒープに作り直す
+		UINT64 const required = graph.stats().heapBytes;
+		if (required > frame.size) {
+			release(frame, table);
+
+			D3D12_HEAP_DESC desc = {};
+			desc.SizeInBytes = (required + D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT - 1U) & ~static_cast<UINT64>(D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT - 1U);
+			desc.Properties.Type = D3D12_HEAP_TYPE_DEFAULT;
+			desc.Properties.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
+			desc.Properties.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
+			desc.Properties.CreationNodeMask = 1U;
+			desc.Properties.VisibleNodeMask = 1U;
+			desc.Alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+			desc.Flags = D3D12_HEAP_FLAG_ALLOW_ALL_BUFFERS_AND_TEXTURES;
+
+			HRESULT hResult = D3D12Device::getInstance()->CreateHeap(
+				&desc,
+				__uuidof(frame.heap),
+				reinterpret_cast<void**>(&frame.heap)
+			);
+			if (FAILED(hResult)) {
+				frame.heap = nullptr;
+				OutputDebugStringA("ERROR : CREATE FAILED TRANSIENT HEAP.\n");
+				return false;
+			}
+			frame.size = desc.SizeInBytes;
+		}
+
+		size_t const count = graph.resourceCount();
+		for (size_t idx = count; idx < frame.placed.size(); ++idx) {
+			release(frame.placed[idx], table);
+		}
+		frame.placed.resize(count, Placed{ {}, 0U, ResourceState::Common, nullptr, {} });
+
+		for (unsigned int idx = 0U; idx < count; ++idx) {
+			Placed& placed = frame.placed[idx];
+			if (!graph.transient(idx) || !graph.used(idx)) {
+				release(placed, table);
+				continue;
+			}
+
+			D3D12_RESOURCE_DESC const& desc = descs[idx];
+			UINT64 const offset = graph.offset(idx);
+			ResourceState const state = graph.firstState(idx);
+			if (placed.resource && placed.offset == offset && placed.state == state && std::memcmp(&placed.desc, &desc, sizeof(desc)) == 0) {
+				graph.setHandle(idx, placed.handle);
+				continue;
+			}
+			release(placed, table);
+
+			HRESULT hResult = D3D12Device::getInstance()->CreatePlacedResource(
+				frame.heap,
+				offset,
+				&desc,
+				to_d3d12_state(state),
+				nullptr,
+				__uuidof(placed.resource),
+				reinterpret_cast<void**>(&placed.resource)
+			);
+			if (FAILED(hResult)) {
+				placed.resource = nullptr;
+				OutputDebugStringA("ERROR : CREATE FAILED TRANSIENT RESOURCE.\n");
+				return false;
+			}
+			placed.desc = desc;
+			placed.offset = offset;
+			placed.state = state;
+			placed.handle = table.registerResource(placed.resource);
+			graph.setHandle(idx, placed.handle);
+		}
+		return true;
+	}
+
+	UINT64 const D3D12TransientHeap::size(unsigned int const& slot) const noexcept {
+		return slot < FRAME_LATENCY_MAX ? m_frames[slot].size : 0U;
+	}
+
+	void D3D12TransientHeap::release(Placed& placed, D3D12ResourceTable& table) noexcept {
+		if (placed.resource == nullptr) {
+			return;
+		}
+		table.unregisterResource(placed.handle);
+		safe_release(placed.resource);
+		placed.handle = {};
+	}
+
+	void D3D12TransientHeap::release(Frame& frame, D3D12ResourceTable& table) noexcept {
+		for (Placed& placed : frame.placed) {
+			release(placed, table);
+		}
+		frame.placed.clear();
+		safe_release(frame.heap);
+		frame.size = 0U;
+	}
+}
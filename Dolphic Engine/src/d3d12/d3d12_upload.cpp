@@ -0,0 +1,226 @@
+﻿/**	@file	d3d12_upload.cpp
+ *	@brief	Direct3D12 用のアップロードキュー
+ */
+#include "d3d12/d3d12_upload.hpp"
+#include "d3d12/d3d12_device.hpp"
+#include "util/utility.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace dlph {
+	D3D12UploadQueue::D3D12UploadQueue() noexcept :
+		ISingleton(),
+		m_buffer(nullptr),
+		m_mapped(nullptr),
+		m_ring(),
+		m_queue(),
+		m_list(),
+		m_fence(),
+		m_value(0U),
+		m_waited(0U),
+		m_recording(false),
+		m_mutex()
+	{}
+
+	D3D12UploadQueue::~D3D12UploadQueue() noexcept {
+		exit();
+	}
+
+	bool const D3D12UploadQueue::init(UINT64 const& size) noexcept {
+		if (m_buffer) {
+			return true;
+		}
+		HRESULT hResult = S_OK;
+
+		UINT64 const count = size / D3D12_UPLOAD_ALIGNMENT;
+		if (count == 0U || count >= RANGE_INVALID) {
+			OutputDebugStringA("ERROR : UPLOAD RING SIZE IS INVALID.\n");
+			return false;
+		}
+
+		D3D12_HEAP_PROPERTIES prop = {};
+		prop.Type = D3D12_HEAP_TYPE_UPLOAD;
+		prop.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
+		prop.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
+		prop.CreationNodeMask = 1U;
+		prop.VisibleNodeMask = 1U;
+
+		D3D12_RESOURCE_DESC desc = {};
+		desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+		desc.Alignment = 0U;
+		desc.Width = count * D3D12_UPLOAD_ALIGNMENT;
+		desc.Height = 1U;
+		desc.DepthOrArraySize = 1U;
+		desc.MipLevels = 1U;
+		desc.Format = DXGI_FORMAT_UNKNOWN;
+		desc.SampleDesc.Count = 1U;
+		desc.SampleDesc.Quality = 0U;
+		desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+		desc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+		hResult = D3D12Device::getInstance()->CreateCommittedResource(
+			&prop,
+			D3D12_HEAP_FLAG_NONE,
+			&desc,
+			D3D12_RESOURCE_STATE_GENERIC_READ,
+			nullptr,
+			__uuidof(m_buffer),
+			reinterpret_cast<void**>(&m_buffer)
+		);
+		if (FAILED(hResult)) {
+			OutputDebugStringA("ERROR : COMMITING FAILED UPLOAD RING RESOURCE.\n");
+			return false;
+		}
+
+		//	UPLOAD ヒープは Map したままでよいので、終了まで閉じない
+		D3D12_RANGE const none = { 0U, 0U };
+		hResult = m_buffer->Map(0U, &none, reinterpret_cast<void**>(&m_mapped));
+		if (FAILED(hResult)) {
+			exit();
+			OutputDebugStringA("ERROR : MAPPING FAILED UPLOAD RING RESOURCE.\n");
+			return false;
+		}
+
+		if (!m_ring.init(static_cast<unsigned int>(count))
+			|| !m_queue.init(D3D12CommandType::Copy)
+			|| !m_list.init(D3D12CommandType::Copy)
+			|| !m_fence.init()) {
+			exit();
+			return false;
+		}
+
+		return true;
+	}
+
+	void D3D12UploadQueue::exit() noexcept {
+		if (m_fence.get()) {
+			wait();
+		}
+		if (m_recording) {
+			m_list.closing();
+			m_recording = false;
+		}
+		m_fence.exit();
+		m_list.exit();
+		m_queue.exit();
+		m_ring.exit();
+		if (m_buffer && m_mapped) {
+			m_buffer->Unmap(0U, nullptr);
+		}
+		m_mapped = nullptr;
+		safe_release(m_buffer);
+		m_value = 0U;
+		m_waited = 0U;
+	}
+
+	bool const D3D12UploadQueue::upload(ID3D12Resource* dst, UINT64 const& offset, void const* data, UINT64 const& size) noexcept {
+		if (dst == nullptr || data == nullptr || size == 0U) {
+			return false;
+		}
+
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		//	リングの半分までなら、空いたリングのどこからでも折り返さずに切り出せる
+		UINT64 const limit = static_cast<UINT64>(std::max(m_ring.capacity() / 2U, 1U)) * D3D12_UPLOAD_ALIGNMENT;
+		unsigned char const* const src = static_cast<unsigned char const*>(data);
+		for (UINT64 done = 0U; done < size;) {
+			UINT64 const bytes = std::min(size - done, limit);
+			D3D12UploadRange const staging = allocate(bytes);
+			if (staging.cpu == nullptr) {
+				return false;
+			}
+			memcpy(staging.cpu, src + done, static_cast<size_t>(bytes));
+
+			if (!m_recording) {
+				//	前回提出したコピーが終わるまでアロケータは使い回せない
+				if (!m_fence.waitFor(m_value) || !m_list.recording()) {
+					return false;
+				}
+				m_recording = true;
+			}
+			m_list->CopyBufferRegion(dst, offset + done, staging.resource, staging.offset, bytes);
+			done += bytes;
+		}
+		return true;
+	}
+
+	bool const D3D12UploadQueue::submit(D3D12CommandQueue const& waiter) noexcept {
+		HRESULT hResult = S_OK;
+
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		if (!execute()) {
+			return false;
+		}
+		//	リングが埋まって途中で提出した分も含め、まだ待たせていないコピーがあれば待たせる
+		if (m_waited == m_value) {
+			return true;
+		}
+		m_waited = m_value;
+
+		//	CPU は待たず、描画キューにだけコピーの完了を待たせる
+		hResult = waiter->Wait(m_fence.get(), m_value);
+		if (FAILED(hResult)) {
+			OutputDebugStringA("ERROR : QUEUE WAIT SETTING FAILED.\n");
+			return false;
+		}
+
+		return true;
+	}
+
+	void D3D12UploadQueue::wait() noexcept {
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		m_fence.waitFor(m_value);
+	}
+
+	void D3D12UploadQueue::beginFrame(unsigned int const& slot) noexcept {
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		m_ring.begin(slot);
+	}
+
+	void D3D12UploadQueue::endFrame(unsigned int const& slot) noexcept {
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		m_ring.end(slot);
+	}
+
+	D3D12UploadRange const D3D12UploadQueue::allocate(UINT64 const& size) noexcept {
+		D3D12UploadRange result = {};
+		UINT64 const count = (size + D3D12_UPLOAD_ALIGNMENT - 1U) / D3D12_UPLOAD_ALIGNMENT;
+		if (m_mapped == nullptr || count == 0U || count > std::max(m_ring.capacity() / 2U, 1U)) {
+			OutputDebugStringA("ERROR : UPLOAD SIZE EXCEEDS RING CAPACITY.\n");
+			return result;
+		}
+
+		unsigned int position = m_ring.allocate(static_cast<unsigned int>(count));
+		if (position == RANGE_INVALID) {
+			//	リングを読むのはコピーキューだけなので、フレームの終わりを待たずとも積んだコピーが終われば全て返せる
+			if (!execute() || !m_fence.waitFor(m_value)) {
+				return result;
+			}
+			m_ring.release();
+			position = m_ring.allocate(static_cast<unsigned int>(count));
+			if (position == RANGE_INVALID) {
+				OutputDebugStringA("ERROR : UPLOAD RING IS EXHAUSTED.\n");
+				return result;
+			}
+		}
+
+		result.offset = static_cast<UINT64>(position) * D3D12_UPLOAD_ALIGNMENT;
+		result.cpu = m_mapped + result.offset;
+		result.gpu = m_buffer->GetGPUVirtualAddress() + result.offset;
+		result.resource = m_buffer;
+		return result;
+	}
+
+	bool const D3D12UploadQueue::execute() noexcept {
+		if (!m_recording) {
+			return true;
+		}
+		m_recording = false;
+		if (!m_list.closing()) {
+			return false;
+		}
+
+		ID3D12CommandList* const lists[] = { m_list.get() };
+		m_queue->ExecuteCommandLists(1U, lists);
+		return m_fence.signal(m_queue, ++m_value);
+	}
+}
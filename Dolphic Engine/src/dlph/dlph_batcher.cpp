@@ -0,0 +1,155 @@
+﻿/**	@file	dlph_batcher.cpp
+ *	@brief	同じメッシュの描画をまとめるインスタンス描画器
+ */
+#include "dlph/dlph_batcher.hpp"
+#include "util/parallel.hpp"
+#include "util/radix_sort.hpp"
+
+namespace {
+	//!	@brief	インスタンスデータの書き出しを並列に行う一区間あたりの数
+	static size_t constexpr BATCH_WRITE_GRAIN = 8192U;
+}
+
+namespace dlph {
+	DrawBatcher::DrawBatcher() noexcept :
+		INonmovable(),
+		m_meshes(),
+		m_instances(),
+		m_items(),
+		m_scratch(),
+		m_batches()
+	{}
+
+	DrawBatcher::~DrawBatcher() noexcept {
+		exit();
+	}
+
+	bool const DrawBatcher::init(size_t const& instances) noexcept {
+		exit();
+		m_instances.reserve(instances);
+		m_items.reserve(instances);
+		m_scratch.reserve(instances);
+		return true;
+	}
+
+	void DrawBatcher::exit() noexcept {
+		m_meshes.clear();
+		m_meshes.shrink_to_fit();
+		m_instances.clear();
+		m_instances.shrink_to_fit();
+		m_items.clear();
+		m_items.shrink_to_fit();
+		m_scratch.clear();
+		m_scratch.shrink_to_fit();
+		m_batches.clear();
+		m_batches.shrink_to_fit();
+	}
+
+	void DrawBatcher::reset() noexcept {
+		m_instances.clear();
+		m_items.clear();
+		m_batches.clear();
+	}
+
+	unsigned int const DrawBatcher::addMesh(BatchMesh const& mesh) noexcept {
+		if (m_meshes.size() >= BATCH_INVALID || mesh.indexCount == 0U) {
+			OutputDebugStringA("ERROR : BATCH MESH IS INVALID.\n");
+			return BATCH_INVALID;
+		}
+		m_meshes.push_back(mesh);
+		return static_cast<unsigned int>(m_meshes.size() - 1U);
+	}
+
+	void DrawBatcher::clearMeshes() noexcept {
+		m_meshes.clear();
+	}
+
+	bool const DrawBatcher::submit(unsigned int const& mesh, unsigned int const& material, Float4x4 const& world) noexcept {
+		if (mesh >= m_meshes.size()) {
+			OutputDebugStringA("ERROR : BATCH MESH NUMBER IS OUT OF RANGE.\n");
+			return false;
+		}
+		BatchInstance instance;
+		for (unsigned int col = 0U; col < 3U; ++col) {
+			for (unsigned int row = 0U; row < 4U; ++row) {
+				instance.rows[col][row] = world.m[row][col];
+			}
+		}
+		instance.material = material;
+
+		m_items.push_back({ (static_cast<unsigned long long>(mesh) << 32U) | material, static_cast<unsigned int>(m_instances.size()) });
+		m_instances.push_back(instance);
+		return true;
+	}
+
+	bool const DrawBatcher::build(void* const dst, size_t const& capacity) noexcept {
+		m_batches.clear();
+		if (m_items.empty()) {
+			return true;
+		}
+		if (dst == nullptr || capacity < bytes()) {
+			OutputDebugStringA("ERROR : BATCH INSTANCE BUFFER IS TOO SMALL.\n");
+			return false;
+		}
+
+		m_scratch.resize(m_items.size());
+		radix_sort(m_items.data(), m_scratch.data(), m_items.size(), [](Item const& item) {
+			return item.key;
+		});
+
+		//	書き込み先は UPLOAD ヒープのことが多いため、先頭から順に書く
+		BatchInstance* const out = static_cast<BatchInstance*>(dst);
+		parallel_for(m_items.size(), BATCH_WRITE_GRAIN, [this, out](size_t const& begin, size_t const& end) {
+			for (size_t idx = begin; idx < end; ++idx) {
+				out[idx] = m_instances[m_items[idx].index];
+			}
+		});
+
+		unsigned long long key = m_items[0U].key;
+		size_t first = 0U;
+		for (size_t idx = 1U; idx <= m_items.size(); ++idx) {
+			if (idx < m_items.size() && m_items[idx].key == key) {
+				continue;
+			}
+			m_batches.push_back({
+				static_cast<unsigned int>(key >> 32U),
+				static_cast<unsigned int>(key),
+				static_cast<unsigned int>(first),
+				static_cast<unsigned int>(idx - first)
+			});
+			if (idx < m_items.size()) {
+				key = m_items[idx].key;
+				first = idx;
+			}
+		}
+		return true;
+	}
+
+	void DrawBatcher::record(RenderCommandStream& stream, RenderPipeline const& pipeline, RenderResource const& instances, unsigned long long const& offset, unsigned int const& layer, unsigned int const& pass) const noexcept {
+		for (DrawBatch const& batch : m_batches) {
+			BatchMesh const& mesh = m_meshes[batch.mesh];
+			stream.setKey(SortKey::make(layer, pass, pipeline.index(), batch.material, 0U));
+			stream.setPipeline(pipeline);
+			stream.bindVertexBuffer(0U, mesh.vertices, mesh.stride);
+			stream.bindVertexBuffer(BATCH_INSTANCE_SLOT, instances, static_cast<unsigned int>(sizeof(BatchInstance)), offset);
+			stream.bindIndexBuffer(mesh.indices, mesh.indexFormat);
+			stream.drawIndexed(mesh.indexCount, batch.instanceCount, mesh.firstIndex, mesh.baseVertex, batch.firstInstance);
+		}
+	}
+
+	size_t const DrawBatcher::instanceCount() const noexcept {
+		return m_instances.size();
+	}
+
+	size_t const DrawBatcher::bytes() const noexcept {
+		return m_instances.size() * sizeof(BatchInstance);
+	}
+
+	size_t const DrawBatcher::batchCount() const noexcept {
+		return m_batches.size();
+	}
+
+	DrawBatch const* const DrawBatcher::batches() const noexcept {
+		return m_batches.data();
+	}
+}
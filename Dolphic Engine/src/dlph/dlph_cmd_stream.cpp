@@ -0,0 +1,178 @@
+﻿/**	@file	dlph_cmd_stream.cpp
+ *	@brief	バックエンドに依存しない描画コマンド列
+ */
+#include "dlph/dlph_cmd_stream.hpp"
+#include "util/radix_sort.hpp"
+
+namespace {
+	using namespace dlph;
+
+	//!	@brief	パケットの本体取得関数
+	template <typename T>
+	inline T const& body(RenderCommandHeader const& packet) noexcept {
+		return reinterpret_cast<RenderCommandPacket<T> const*>(&packet)->body;
+	}
+}
+
+namespace dlph {
+	RenderCommandStream::RenderCommandStream() noexcept :
+		INonmovable(),
+		m_arena(),
+		m_entries(),
+		m_scratch(),
+		m_key(0U)
+	{}
+
+	RenderCommandStream::~RenderCommandStream() noexcept {
+		exit();
+	}
+
+	bool const RenderCommandStream::init(size_t const& capacity, size_t const& commands) noexcept {
+		exit();
+		if (!m_arena.init(capacity)) {
+			return false;
+		}
+		m_entries.reserve(commands);
+		return true;
+	}
+
+	void RenderCommandStream::exit() noexcept {
+		m_entries.clear();
+		m_entries.shrink_to_fit();
+		m_scratch.clear();
+		m_scratch.shrink_to_fit();
+		m_arena.exit();
+		m_key = 0U;
+	}
+
+	void RenderCommandStream::reset() noexcept {
+		m_entries.clear();
+		m_arena.reset();
+		m_key = 0U;
+	}
+
+	void RenderCommandStream::setKey(unsigned long long const& key) noexcept {
+		m_key = key;
+	}
+
+	void RenderCommandStream::setKey(SortKey const& key) noexcept {
+		m_key = key.value;
+	}
+
+	unsigned long long const RenderCommandStream::getKey() const noexcept {
+		return m_key;
+	}
+
+	void RenderCommandStream::draw(unsigned int const& vertexCount, unsigned int const& instanceCount, unsigned int const& firstVertex, unsigned int const& firstInstance) noexcept {
+		push(DrawCommand{ vertexCount, instanceCount, firstVertex, firstInstance });
+	}
+
+	void RenderCommandStream::drawIndexed(unsigned int const& indexCount, unsigned int const& instanceCount, unsigned int const& firstIndex, int const& baseVertex, unsigned int const& firstInstance) noexcept {
+		push(DrawIndexedCommand{ indexCount, instanceCount, firstIndex, baseVertex, firstInstance });
+	}
+
+	void RenderCommandStream::dispatch(unsigned int const& x, unsigned int const& y, unsigned int const& z) noexcept {
+		push(DispatchCommand{ x, y, z });
+	}
+
+	void RenderCommandStream::setPipeline(RenderPipeline const& pipeline) noexcept {
+		push(SetPipelineCommand{ pipeline });
+	}
+
+	void RenderCommandStream::bindVertexBuffer(unsigned int const& slot, RenderResource const& buffer, unsigned int const& stride, unsigned long long const& offset) noexcept {
+		push(BindVertexBufferCommand{ buffer, slot, stride, offset });
+	}
+
+	void RenderCommandStream::bindIndexBuffer(RenderResource const& buffer, IndexFormat const& format, unsigned long long const& offset) noexcept {
+		push(BindIndexBufferCommand{ buffer, offset, format });
+	}
+
+	void RenderCommandStream::bindConstants(unsigned int const& root, unsigned long long const& address) noexcept {
+		push(BindConstantsCommand{ root, address });
+	}
+
+	void RenderCommandStream::bindResource(unsigned int const& root, RenderResource const& resource) noexcept {
+		push(BindResourceCommand{ root, resource });
+	}
+
+	void RenderCommandStream::barrier(RenderResource const& resource, ResourceState const& before, ResourceState const& after, BarrierKind const& kind, unsigned int const& subresource) noexcept {
+		push(BarrierCommand{ resource, before, after, kind, subresource });
+	}
+
+	void RenderCommandStream::copy(RenderResource const& dst, unsigned long long const& dstOffset, RenderResource const& src, unsigned long long const& srcOffset, unsigned long long const& size) noexcept {
+		push(CopyCommand{ dst, src, dstOffset, srcOffset, size });
+	}
+
+	void RenderCommandStream::sort() noexcept {
+		if (m_scratch.size() < m_entries.size()) {
+			m_scratch.resize(m_entries.size());
+		}
+		radix_sort(m_entries.data(), m_scratch.data(), m_entries.size(), [](Entry const& entry) {
+			return entry.key;
+		});
+	}
+
+	void RenderCommandStream::submit(IRenderBackend& backend) const noexcept {
+		for (Entry const& entry : m_entries) {
+			dispatchPacket(*entry.packet, backend);
+		}
+	}
+
+	size_t const RenderCommandStream::size() const noexcept {
+		return m_entries.size();
+	}
+
+	bool const RenderCommandStream::empty() const noexcept {
+		return m_entries.empty();
+	}
+
+	size_t const RenderCommandStream::bytes() const noexcept {
+		return m_arena.used();
+	}
+
+	RenderCommandStream::Entry const* const RenderCommandStream::begin() const noexcept {
+		return m_entries.data();
+	}
+
+	RenderCommandStream::Entry const* const RenderCommandStream::end() const noexcept {
+		return m_entries.data() + m_entries.size();
+	}
+
+	void RenderCommandStream::dispatchPacket(RenderCommandHeader const& packet, IRenderBackend& backend) noexcept {
+		switch (packet.type) {
+		case RenderCommandType::Draw:
+			backend.draw(body<DrawCommand>(packet));
+			break;
+		case RenderCommandType::DrawIndexed:
+			backend.drawIndexed(body<DrawIndexedCommand>(packet));
+			break;
+		case RenderCommandType::Dispatch:
+			backend.dispatch(body<DispatchCommand>(packet));
+			break;
+		case RenderCommandType::SetPipeline:
+			backend.setPipeline(body<SetPipelineCommand>(packet));
+			break;
+		case RenderCommandType::BindVertexBuffer:
+			backend.bindVertexBuffer(body<BindVertexBufferCommand>(packet));
+			break;
+		case RenderCommandType::BindIndexBuffer:
+			backend.bindIndexBuffer(body<BindIndexBufferCommand>(packet));
+			break;
+		case RenderCommandType::BindConstants:
+			backend.bindConstants(body<BindConstantsCommand>(packet));
+			break;
+		case RenderCommandType::BindResource:
+			backend.bindResource(body<BindResourceCommand>(packet));
+			break;
+		case RenderCommandType::Barrier:
+			backend.barrier(body<BarrierCommand>(packet));
+			break;
+		case RenderCommandType::Copy:
+			backend.copy(body<CopyCommand>(packet));
+			break;
+		default:
+			OutputDebugStringA("ERROR : RENDER COMMAND TYPE CORRUPTED.\n");
+			break;
+		}
+	}
+}
@@ -0,0 +1,387 @@
+﻿/**	@file	dlph_frame_graph.cpp
+ *	@brief	フレームグラフ
+ */
+#include "dlph/dlph_frame_graph.hpp"
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+namespace {
+	using namespace dlph;
+
+	//!	@brief	使われていないことを表す実行順の位置
+	static unsigned int constexpr SLOT_NONE = ~0U;
+	//!	@brief	同じ位置のバリアの並び (寿命の終わった一時リソースを戻す遷移)
+	static unsigned int constexpr PHASE_RELEASE = 0U;
+	//!	@brief	同じ位置のバリアの並び (メモリ共有)
+	static unsigned int constexpr PHASE_ALIASING = 1U;
+	//!	@brief	同じ位置のバリアの並び (その他)
+	static unsigned int constexpr PHASE_USE = 2U;
+	//!	@brief	同じ位置のバリアの並びの数
+	static unsigned int constexpr PHASE_CNT = 3U;
+
+	//!	@brief	境界への切り上げ関数
+	inline unsigned long long const align_up(unsigned long long const& value, unsigned long long const& alignment) noexcept {
+		return (value + alignment - 1U) & ~(alignment - 1U);
+	}
+}
+
+namespace dlph {
+	FrameGraph::FrameGraph() noexcept :
+		INonmovable(),
+		m_passes(),
+		m_resources(),
+		m_order(),
+		m_barriers(),
+		m_barrierSlots(),
+		m_slots(),
+		m_stats(),
+		m_compiled(false)
+	{}
+
+	void FrameGraph::reset() noexcept {
+		m_passes.clear();
+		m_resources.clear();
+		m_order.clear();
+		m_barriers.clear();
+		m_barrierSlots.clear();
+		m_slots.clear();
+		m_stats = {};
+		m_compiled = false;
+	}
+
+	unsigned int const FrameGraph::createResource(FrameGraphResourceDesc const& desc) noexcept {
+		if (desc.size == 0U || desc.alignment == 0U || (desc.alignment & (desc.alignment - 1U)) != 0U) {
+			OutputDebugStringA("ERROR : FRAME GRAPH RESOURCE DESC IS INVALID.\n");
+			return FRAME_GRAPH_INVALID;
+		}
+		m_resources.push_back({ desc, {}, 0U, SLOT_NONE, SLOT_NONE, ResourceState::Common, ResourceState::Common, ResourceState::Common, false });
+		m_compiled = false;
+		return static_cast<unsigned int>(m_resources.size() - 1U);
+	}
+
+	unsigned int const FrameGraph::importResource(RenderResource const& handle, ResourceState const& initial, ResourceState const& final) noexcept {
+		m_resources.push_back({ { 0U, 1U }, handle, 0U, SLOT_NONE, SLOT_NONE, initial, final, initial, true });
+		m_compiled = false;
+		return static_cast<unsigned int>(m_resources.size() - 1U);
+	}
+
+	unsigned int const FrameGraph::addPass(bool const& sideEffect) noexcept {
+		m_passes.push_back({ {}, sideEffect, false });
+		m_compiled = false;
+		return static_cast<unsigned int>(m_passes.size() - 1U);
+	}
+
+	bool const FrameGraph::read(unsigned int const& pass, unsigned int const& resource, ResourceState const& state) noexcept {
+		return use(pass, resource, state, false);
+	}
+
+	bool const FrameGraph::write(unsigned int const& pass, unsigned int const& resource, ResourceState const& state) noexcept {
+		return use(pass, resource, state, true);
+	}
+
+	bool const FrameGraph::compile() noexcept {
+		m_order.clear();
+		m_barriers.clear();
+		m_barrierSlots.clear();
+		m_slots.clear();
+		m_stats = {};
+
+		cull();
+		for (unsigned int pass = 0U; pass < m_passes.size(); ++pass) {
+			if (!m_passes[pass].culled) {
+				m_order.push_back(pass);
+			}
+		}
+
+		for (Resource& resource : m_resources) {
+			resource.first = SLOT_NONE;
+			resource.last = SLOT_NONE;
+			resource.offset = 0U;
+			resource.firstState = resource.initial;
+		}
+		for (unsigned int slot = 0U; slot < m_order.size(); ++slot) {
+			for (Use const& use : m_passes[m_order[slot]].uses) {
+				Resource& resource = m_resources[use.resource];
+				if (resource.first == SLOT_NONE) {
+					resource.first = slot;
+					if (!resource.imported) {
+						resource.firstState = use.state;
+					}
+				}
+				resource.last = slot;
+			}
+		}
+
+		place();
+		schedule();
+
+		m_stats.passes = static_cast<unsigned int>(m_order.size());
+		m_stats.culled = static_cast<unsigned int>(m_passes.size() - m_order.size());
+		m_compiled = true;
+		return true;
+	}
+
+	void FrameGraph::setHandle(unsigned int const& resource, RenderResource const& handle) noexcept {
+		if (resource < m_resources.size()) {
+			m_resources[resource].handle = handle;
+		}
+	}
+
+	void FrameGraph::recordBarriers(size_t const& slot, RenderCommandStream& stream) const noexcept {
+		for (FrameGraphBarrier const* it = barrierBegin(slot); it != barrierEnd(slot); ++it) {
+			stream.barrier(m_resources[it->resource].handle, it->before, it->after, it->kind);
+		}
+	}
+
+	size_t const FrameGraph::passCount() const noexcept {
+		return m_passes.size();
+	}
+
+	size_t const FrameGraph::resourceCount() const noexcept {
+		return m_resources.size();
+	}
+
+	size_t const FrameGraph::passes() const noexcept {
+		return m_order.size();
+	}
+
+	unsigned int const* const FrameGraph::order() const noexcept {
+		return m_order.data();
+	}
+
+	bool const FrameGraph::culled(unsigned int const& pass) const noexcept {
+		return pass < m_passes.size() ? m_passes[pass].culled : true;
+	}
+
+	FrameGraphBarrier const* const FrameGraph::barrierBegin(size_t const& slot) const noexcept {
+		return slot + 1U < m_slots.size() ? m_barriers.data() + m_slots[slot] : m_barriers.data() + m_barriers.size();
+	}
+
+	FrameGraphBarrier const* const FrameGraph::barrierEnd(size_t const& slot) const noexcept {
+		return slot + 1U < m_slots.size() ? m_barriers.data() + m_slots[slot + 1U] : m_barriers.data() + m_barriers.size();
+	}
+
+	bool const FrameGraph::transient(unsigned int const& resource) const noexcept {
+		return resource < m_resources.size() && !m_resources[resource].imported;
+	}
+
+	bool const FrameGraph::used(unsigned int const& resource) const noexcept {
+		return resource < m_resources.size() && m_resources[resource].first != SLOT_NONE;
+	}
+
+	FrameGraphResourceDesc const& FrameGraph::desc(unsigned int const& resource) const noexcept {
+		return m_resources[resource].desc;
+	}
+
+	unsigned long long const FrameGraph::offset(unsigned int const& resource) const noexcept {
+		return m_resources[resource].offset;
+	}
+
+	ResourceState const FrameGraph::firstState(unsigned int const& resource) const noexcept {
+		return m_resources[resource].firstState;
+	}
+
+	RenderResource const FrameGraph::getHandle(unsigned int const& resource) const noexcept {
+		return m_resources[resource].handle;
+	}
+
+	FrameGraphStats const& FrameGraph::stats() const noexcept {
+		return m_stats;
+	}
+
+	bool const FrameGraph::use(unsigned int const& pass, unsigned int const& resource, ResourceState const& state, bool const& write) noexcept {
+		if (pass >= m_passes.size() || resource >= m_resources.size()) {
+			OutputDebugStringA("ERROR : FRAME GRAPH PASS OR RESOURCE NUMBER IS OUT OF RANGE.\n");
+			return false;
+		}
+		m_compiled = false;
+		for (Use& use : m_passes[pass].uses) {
+			if (use.resource != resource) {
+				continue;
+			}
+			if (use.state != state) {
+				OutputDebugStringA("ERROR : FRAME GRAPH RESOURCE IS USED IN TWO STATES IN ONE PASS.\n");
+				return false;
+			}
+			use.read = use.read || !write;
+			use.write = use.write || write;
+			return true;
+		}
+		m_passes[pass].uses.push_back({ resource, state, !write, write });
+		return true;
+	}
+
+	void FrameGraph::cull() noexcept {
+		//	後ろのパスから、外部リソースか副作用に届く書き込みを持つパスだけを残す
+		std::vector<bool> needed(m_resources.size());
+		for (size_t idx = 0U; idx < m_resources.size(); ++idx) {
+			needed[idx] = m_resources[idx].imported;
+		}
+		for (size_t idx = m_passes.size(); idx > 0U; --idx) {
+			Pass& pass = m_passes[idx - 1U];
+			bool live = pass.sideEffect;
+			for (Use const& use : pass.uses) {
+				live = live || (use.write && needed[use.resource]);
+			}
+			pass.culled = !live;
+			if (!live) {
+				continue;
+			}
+			//	全て上書きする書き込みより前の内容は要らない
+			for (Use const& use : pass.uses) {
+				if (use.write && !use.read) {
+					needed[use.resource] = false;
+				}
+			}
+			for (Use const& use : pass.uses) {
+				if (use.read) {
+					needed[use.resource] = true;
+				}
+			}
+		}
+	}
+
+	void FrameGraph::place() noexcept {
+		std::vector<unsigned int> targets;
+		for (unsigned int idx = 0U; idx < m_resources.size(); ++idx) {
+			if (!m_resources[idx].imported && m_resources[idx].first != SLOT_NONE) {
+				targets.push_back(idx);
+			}
+		}
+		//	大きいものから置くと隙間が小さくなる。同じ大きさは寿命と番号の順にして結果を一意にする
+		std::sort(targets.begin(), targets.end(), [this](unsigned int const& lhs, unsigned int const& rhs) {
+			Resource const& l = m_resources[lhs];
+			Resource const& r = m_resources[rhs];
+			if (l.desc.size != r.desc.size) {
+				return l.desc.size > r.desc.size;
+			}
+			if (l.first != r.first) {
+				return l.first < r.first;
+			}
+			return lhs < rhs;
+		});
+
+		std::vector<std::pair<unsigned long long, unsigned long long>> ranges;
+		for (size_t count = 0U; count < targets.size(); ++count) {
+			Resource& target = m_resources[targets[count]];
+			ranges.clear();
+			for (size_t idx = 0U; idx < count; ++idx) {
+				Resource const& other = m_resources[targets[idx]];
+				if (other.first <= target.last && target.first <= other.last) {
+					ranges.push_back({ other.offset, other.offset + other.desc.size });
+				}
+			}
+			std::sort(ranges.begin(), ranges.end());
+
+			//	寿命の重なるリソースの間で、最も手前の入る隙間を探す
+			unsigned long long offset = 0U;
+			for (auto const& range : ranges) {
+				if (align_up(offset, target.desc.alignment) + target.desc.size <= range.first) {
+					break;
+				}
+				offset = std::max(offset, range.second);
+			}
+			target.offset = align_up(offset, target.desc.alignment);
+			m_stats.transientBytes += target.desc.size;
+			m_stats.heapBytes = std::max(m_stats.heapBytes, target.offset + target.desc.size);
+		}
+	}
+
+	void FrameGraph::schedule() noexcept {
+		size_t const count = m_resources.size();
+		std::vector<ResourceState> states(count);
+		std::vector<unsigned int> lasts(count, SLOT_NONE);
+		std::vector<bool> writes(count, false);
+		for (size_t idx = 0U; idx < count; ++idx) {
+			states[idx] = m_resources[idx].imported ? m_resources[idx].initial : m_resources[idx].firstState;
+		}
+
+		auto const push = [this](unsigned int const& slot, unsigned int const& phase, FrameGraphBarrier const& barrier) {
+			m_barriers.push_back(barrier);
+			m_barrierSlots.push_back(slot * PHASE_CNT + phase);
+		};
+
+		unsigned int const tail = static_cast<unsigned int>(m_order.size());
+		for (unsigned int slot = 0U; slot < tail; ++slot) {
+			for (Use const& use : m_passes[m_order[slot]].uses) {
+				unsigned int const idx = use.resource;
+				Resource const& resource = m_resources[idx];
+				bool const begin = !resource.imported && resource.first == slot;
+
+				if (begin) {
+					//	寿命の終わった一時リソースとメモリが重なるなら、使い始めにメモリ共有のバリアを置く
+					for (Resource const& other : m_resources) {
+						if (&other != &resource && !other.imported && other.first != SLOT_NONE && other.last < slot
+							&& other.offset < resource.offset + resource.desc.size && resource.offset < other.offset + other.desc.size) {
+							push(slot, PHASE_ALIASING, { idx, states[idx], states[idx], BarrierKind::Aliasing });
+							++m_stats.aliasing;
+							break;
+						}
+					}
+				}
+
+				if (states[idx] != use.state) {
+					transition(idx, lasts[idx] == SLOT_NONE ? 0U : lasts[idx] + 1U, slot, states[idx], use.state);
+				}
+				else if (use.state == ResourceState::UnorderedAccess && writes[idx]) {
+					push(slot, PHASE_USE, { idx, use.state, use.state, BarrierKind::UnorderedAccess });
+					++m_stats.uavs;
+				}
+				else if (!begin) {
+					++m_stats.skipped;
+				}
+				states[idx] = use.state;
+				lasts[idx] = slot;
+				writes[idx] = use.write;
+			}
+		}
+
+		for (unsigned int idx = 0U; idx < count; ++idx) {
+			Resource const& resource = m_resources[idx];
+			if (resource.imported) {
+				if (states[idx] != resource.final) {
+					transition(idx, lasts[idx] == SLOT_NONE ? 0U : lasts[idx] + 1U, tail, states[idx], resource.final);
+				}
+			}
+			else if (resource.first != SLOT_NONE && states[idx] != resource.firstState) {
+				//	次のフレームも同じ状態から始められるよう、メモリを明け渡す前に最初の状態へ戻す
+				push(resource.last + 1U, PHASE_RELEASE, { idx, states[idx], resource.firstState, BarrierKind::Transition });
+				++m_stats.transitions;
+			}
+		}
+
+		//	位置ごとにまとめる (同じ位置の中では追加順を保つ)
+		std::vector<size_t> indices(m_barriers.size());
+		std::iota(indices.begin(), indices.end(), static_cast<size_t>(0U));
+		std::stable_sort(indices.begin(), indices.end(), [this](size_t const& lhs, size_t const& rhs) {
+			return m_barrierSlots[lhs] < m_barrierSlots[rhs];
+		});
+		std::vector<FrameGraphBarrier> sorted;
+		sorted.reserve(m_barriers.size());
+		m_slots.assign(static_cast<size_t>(tail) + 2U, 0U);
+		for (size_t const& index : indices) {
+			sorted.push_back(m_barriers[index]);
+			++m_slots[m_barrierSlots[index] / PHASE_CNT + 1U];
+		}
+		for (size_t slot = 1U; slot < m_slots.size(); ++slot) {
+			m_slots[slot] += m_slots[slot - 1U];
+		}
+		m_barriers.swap(sorted);
+	}
+
+	void FrameGraph::transition(unsigned int const& resource, unsigned int const& from, unsigned int const& slot, ResourceState const& before, ResourceState const& after) noexcept {
+		//	前の使用との間にパスがあれば、その間に遷移させるよう開始と終了に分ける
+		if (from < slot) {
+			m_barriers.push_back({ resource, before, after, BarrierKind::Begin });
+			m_barrierSlots.push_back(from * PHASE_CNT + PHASE_USE);
+			m_barriers.push_back({ resource, before, after, BarrierKind::End });
+			m_barrierSlots.push_back(slot * PHASE_CNT + PHASE_USE);
+			++m_stats.splits;
+			return;
+		}
+		m_barriers.push_back({ resource, before, after, BarrierKind::Transition });
+		m_barrierSlots.push_back(slot * PHASE_CNT + PHASE_USE);
+		++m_stats.transitions;
+	}
+}
@@ -0,0 +1,62 @@
+﻿/**	@file	dlph_frame_pacer.cpp
+ *	@brief	フレームペーサー
+ */
+#include "dlph/dlph_frame_pacer.hpp"
+
+namespace dlph {
+	FramePacer::FramePacer() noexcept :
+		m_values(),
+		m_last(0U),
+		m_frame(0U),
+		m_latency(0U)
+	{}
+
+	bool const FramePacer::init(unsigned int const& latency) noexcept {
+		exit();
+		if (latency == 0U || latency > FRAME_LATENCY_MAX) {
+			OutputDebugStringA("ERROR : FRAME LATENCY IS OUT OF RANGE.\n");
+			return false;
+		}
+		m_latency = latency;
+		return true;
+	}
+
+	void FramePacer::exit() noexcept {
+		for (unsigned long long& value : m_values) {
+			value = 0U;
+		}
+		m_last = 0U;
+		m_frame = 0U;
+		m_latency = 0U;
+	}
+
+	unsigned int const FramePacer::slot() const noexcept {
+		return m_latency > 0U ? static_cast<unsigned int>(m_frame % m_latency) : 0U;
+	}
+
+	unsigned long long const FramePacer::pending() const noexcept {
+		return m_values[slot()];
+	}
+
+	bool const FramePacer::busy(unsigned long long const& completed) const noexcept {
+		return pending() > completed;
+	}
+
+	unsigned long long const FramePacer::submit() noexcept {
+		m_values[slot()] = ++m_last;
+		++m_frame;
+		return m_last;
+	}
+
+	unsigned long long const FramePacer::last() const noexcept {
+		return m_last;
+	}
+
+	unsigned int const FramePacer::latency() const noexcept {
+		return m_latency;
+	}
+
+	unsigned long long const FramePacer::frame() const noexcept {
+		return m_frame;
+	}
+}
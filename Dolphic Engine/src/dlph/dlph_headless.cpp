@@ -0,0 +1,224 @@
+﻿/**	@file	dlph_headless.cpp
+ *	@brief	GPU を使わない描画バックエンド
+ */
+#include "dlph/dlph_headless.hpp"
+#include <iterator>
+
+namespace dlph {
+	HeadlessBackend::HeadlessBackend() noexcept :
+		IRenderBackend(),
+		m_stats(),
+		m_states(),
+		m_subStates(),
+		m_pending(),
+		m_pipeline(),
+		m_indexBuffer(false)
+	{}
+
+	void HeadlessBackend::reset() noexcept {
+		m_stats = {};
+		m_states.clear();
+		m_subStates.clear();
+		m_pending.clear();
+		m_pipeline = {};
+		m_indexBuffer = false;
+	}
+
+	HeadlessStats const& HeadlessBackend::stats() const noexcept {
+		return m_stats;
+	}
+
+	bool const HeadlessBackend::valid() const noexcept {
+		return m_stats.errors == 0U;
+	}
+
+	void HeadlessBackend::draw(DrawCommand const& cmd) noexcept {
+		count(DrawCommand::TYPE);
+		if (!m_pipeline) {
+			error("ERROR : DRAW WITHOUT PIPELINE.\n");
+		}
+		if (cmd.vertexCount == 0U || cmd.instanceCount == 0U) {
+			error("ERROR : DRAW WITH NO VERTEX.\n");
+		}
+		++m_stats.draws;
+		m_stats.vertices += static_cast<unsigned long long>(cmd.vertexCount) * cmd.instanceCount;
+	}
+
+	void HeadlessBackend::drawIndexed(DrawIndexedCommand const& cmd) noexcept {
+		count(DrawIndexedCommand::TYPE);
+		if (!m_pipeline) {
+			error("ERROR : DRAW WITHOUT PIPELINE.\n");
+		}
+		if (!m_indexBuffer) {
+			error("ERROR : INDEXED DRAW WITHOUT INDEX BUFFER.\n");
+		}
+		if (cmd.indexCount == 0U || cmd.instanceCount == 0U) {
+			error("ERROR : DRAW WITH NO VERTEX.\n");
+		}
+		++m_stats.draws;
+		m_stats.indices += static_cast<unsigned long long>(cmd.indexCount) * cmd.instanceCount;
+	}
+
+	void HeadlessBackend::dispatch(DispatchCommand const& cmd) noexcept {
+		count(DispatchCommand::TYPE);
+		if (!m_pipeline) {
+			error("ERROR : DISPATCH WITHOUT PIPELINE.\n");
+		}
+		if (cmd.x == 0U || cmd.y == 0U || cmd.z == 0U) {
+			error("ERROR : DISPATCH WITH NO GROUP.\n");
+		}
+		if (cmd.x > HEADLESS_DISPATCH_MAX || cmd.y > HEADLESS_DISPATCH_MAX || cmd.z > HEADLESS_DISPATCH_MAX) {
+			error("ERROR : DISPATCH GROUP COUNT EXCEEDS LIMIT.\n");
+		}
+		m_stats.groups += static_cast<unsigned long long>(cmd.x) * cmd.y * cmd.z;
+	}
+
+	void HeadlessBackend::setPipeline(SetPipelineCommand const& cmd) noexcept {
+		count(SetPipelineCommand::TYPE);
+		if (!cmd.pipeline) {
+			error("ERROR : PIPELINE HANDLE IS INVALID.\n");
+		}
+		m_pipeline = cmd.pipeline;
+	}
+
+	void HeadlessBackend::bindVertexBuffer(BindVertexBufferCommand const& cmd) noexcept {
+		count(BindVertexBufferCommand::TYPE);
+		if (!cmd.buffer) {
+			error("ERROR : VERTEX BUFFER HANDLE IS INVALID.\n");
+		}
+		if (cmd.slot >= HEADLESS_VERTEX_SLOT_CNT || cmd.stride == 0U) {
+			error("ERROR : VERTEX BUFFER SETTING IS INVALID.\n");
+		}
+	}
+
+	void HeadlessBackend::bindIndexBuffer(BindIndexBufferCommand const& cmd) noexcept {
+		count(BindIndexBufferCommand::TYPE);
+		if (!cmd.buffer) {
+			error("ERROR : INDEX BUFFER HANDLE IS INVALID.\n");
+		}
+		m_indexBuffer = static_cast<bool>(cmd.buffer);
+	}
+
+	void HeadlessBackend::bindConstants(BindConstantsCommand const& cmd) noexcept {
+		count(BindConstantsCommand::TYPE);
+		if (cmd.address == 0U || cmd.address % HEADLESS_CONSTANT_ALIGNMENT != 0U) {
+			error("ERROR : CONSTANT ADDRESS IS NOT ALIGNED.\n");
+		}
+	}
+
+	void HeadlessBackend::bindResource(BindResourceCommand const& cmd) noexcept {
+		count(BindResourceCommand::TYPE);
+		if (!cmd.resource) {
+			error("ERROR : RESOURCE HANDLE IS INVALID.\n");
+		}
+	}
+
+	void HeadlessBackend::barrier(BarrierCommand const& cmd) noexcept {
+		count(BarrierCommand::TYPE);
+		if (!cmd.resource) {
+			error("ERROR : BARRIER RESOURCE HANDLE IS INVALID.\n");
+			return;
+		}
+		unsigned int const key = cmd.resource.value;
+		switch (cmd.kind) {
+		case BarrierKind::UnorderedAccess:
+		{
+			ResourceState const* const state = findState(key, SUBRESOURCE_ALL);
+			if (state != nullptr && *state != ResourceState::UnorderedAccess) {
+				error("ERROR : UAV BARRIER ON RESOURCE NOT IN UNORDERED ACCESS STATE.\n");
+			}
+			return;
+		}
+		case BarrierKind::Aliasing:
+			//	メモリを引き継いだリソースの状態は不定のため、次の遷移の遷移前の状態を信じる
+			if (m_pending.count(key) != 0U) {
+				error("ERROR : ALIASING BARRIER DURING SPLIT BARRIER.\n");
+			}
+			eraseState(key);
+			return;
+		case BarrierKind::End:
+		{
+			auto const it = m_pending.find(key);
+			if (it == m_pending.end() || it->second != cmd.after) {
+				error("ERROR : SPLIT BARRIER END WITHOUT MATCHING BEGIN.\n");
+			}
+			else {
+				m_pending.erase(it);
+			}
+			setState(key, cmd.subresource, cmd.after);
+			return;
+		}
+		default:
+			break;
+		}
+
+		if (cmd.before == cmd.after) {
+			error("ERROR : BARRIER DOES NOT CHANGE STATE.\n");
+		}
+		if (m_pending.count(key) != 0U) {
+			error("ERROR : BARRIER DURING SPLIT BARRIER.\n");
+		}
+		//	初めて見るリソースは遷移前の状態を信じ、以降は追跡した状態と照合する
+		ResourceState const* const state = findState(key, cmd.subresource);
+		if (state != nullptr && *state != cmd.before) {
+			error("ERROR : BARRIER BEFORE STATE MISMATCH.\n");
+		}
+		if (cmd.kind == BarrierKind::Begin) {
+			m_pending[key] = cmd.after;
+			setState(key, cmd.subresource, cmd.before);
+			return;
+		}
+		setState(key, cmd.subresource, cmd.after);
+	}
+
+	void HeadlessBackend::copy(CopyCommand const& cmd) noexcept {
+		count(CopyCommand::TYPE);
+		if (!cmd.dst || !cmd.src) {
+			error("ERROR : COPY RESOURCE HANDLE IS INVALID.\n");
+		}
+		if (cmd.size == 0U) {
+			error("ERROR : COPY SIZE IS ZERO.\n");
+		}
+		if (cmd.dst == cmd.src && cmd.dstOffset < cmd.srcOffset + cmd.size && cmd.srcOffset < cmd.dstOffset + cmd.size) {
+			error("ERROR : COPY REGIONS OVERLAP.\n");
+		}
+		m_stats.copied += cmd.size;
+	}
+
+	void HeadlessBackend::count(RenderCommandType const& type) noexcept {
+		++m_stats.commands[static_cast<unsigned int>(type)];
+	}
+
+	void HeadlessBackend::error(char const* message) noexcept {
+		OutputDebugStringA(message);
+		++m_stats.errors;
+	}
+
+	ResourceState const* const HeadlessBackend::findState(unsigned int const& resource, unsigned int const& subresource) const noexcept {
+		if (subresource != SUBRESOURCE_ALL) {
+			auto const it = m_subStates.find((static_cast<unsigned long long>(resource) << 32U) | subresource);
+			if (it != m_subStates.end()) {
+				return &it->second;
+			}
+		}
+		auto const it = m_states.find(resource);
+		return it != m_states.end() ? &it->second : nullptr;
+	}
+
+	void HeadlessBackend::setState(unsigned int const& resource, unsigned int const& subresource, ResourceState const& state) noexcept {
+		if (subresource != SUBRESOURCE_ALL) {
+			m_subStates[(static_cast<unsigned long long>(resource) << 32U) | subresource] = state;
+			return;
+		}
+		eraseState(resource);
+		m_states[resource] = state;
+	}
+
+	void HeadlessBackend::eraseState(unsigned int const& resource) noexcept {
+		m_states.erase(resource);
+		//	サブリソース単位の遷移は稀なので、ある時だけ探す
+		for (auto it = m_subStates.begin(); it != m_subStates.end();) {
+			it = (it->first >> 32U) == resource ? m_subStates.erase(it) : std::next(it);
+		}
+	}
+}
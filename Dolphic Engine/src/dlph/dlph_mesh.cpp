@@ -0,0 +1,46 @@
+﻿/**	@file	dlph_mesh.cpp
+ *	@brief	Dolphic Engine 用のメッシュ構造体
+ */
+#include "dlph/dlph_mesh.hpp"
+#include "math/fmtx4x4.hpp"
+#include "math/fvec4.hpp"
+#include <cfloat>
+#include <cmath>
+
+namespace dlph {
+	float const projectedLodError(float const& error, float const& distance, FMatrix4x4 const& projection, float const& viewport_height) noexcept {
+		if (distance <= 0.0f) {
+			return FLT_MAX;
+		}
+		//	射影行列の縦方向の拡大率 (cot(fov / 2)) でピクセル単位に変換する
+		return error * fabsf(projection.m[1U][1U]) * viewport_height * 0.5f / distance;
+	}
+
+	size_t const selectLod(Mesh const& mesh, FMatrix4x4 const& world_view, FMatrix4x4 const& projection, float const& viewport_height, float const& pixel_error) noexcept {
+		if (mesh.lods.size() <= 1U) {
+			return 0U;
+		}
+
+		FVector4 const view = FVector4(mesh.center.x, mesh.center.y, mesh.center.z, 1.0f) * world_view;
+
+		//	ワールドビュー行列の最大拡大率で誤差と半径を変換する
+		float scale = 0.0f;
+		for (unsigned int row = 0U; row < 3U; ++row) {
+			float const* m = world_view.m[row];
+			scale = fmaxf(scale, m[0U] * m[0U] + m[1U] * m[1U] + m[2U] * m[2U]);
+		}
+		scale = sqrtf(scale);
+
+		float const distance = sqrtf(view.x * view.x + view.y * view.y + view.z * view.z) - mesh.radius * scale;
+		if (distance <= 0.0f) {
+			return 0U;
+		}
+
+		for (size_t idx = mesh.lods.size() - 1U; idx > 0U; --idx) {
+			if (projectedLodError(mesh.lods[idx].error * scale, distance, projection, viewport_height) <= pixel_error) {
+				return idx;
+			}
+		}
+		return 0U;
+	}
+}
@@ -0,0 +1,456 @@
+﻿/**	@file	dlph_meshlet.cpp
+ *	@brief	Dolphic Engine 用のメッシュレット (三角形クラスタ) 関数群
+ */
+#include "dlph/dlph_meshlet.hpp"
+#include "math/fmtx4x4.hpp"
+#include "math/fvec3.hpp"
+#include "util/parallel.hpp"
+#include <cfloat>
+#include <cmath>
+
+namespace {
+	using namespace dlph;
+
+	//!	@brief	メッシュレットに属していない頂点を表す値
+	static unsigned char constexpr LOCAL_NONE = 0xFFU;
+	//!	@brief	視錐台の平面数
+	static unsigned int constexpr FRUSTUM_PLANE_CNT = 6U;
+
+	static_assert(sizeof(Meshlet) % 16U == 0U, "Meshlet must be 16 byte aligned for upload.");
+	static_assert(sizeof(MeshletBounds) % 16U == 0U, "MeshletBounds must be 16 byte aligned for upload.");
+	static_assert(MESHLET_VERTEX_MAX <= LOCAL_NONE, "Local vertex index must fit in 8 bits.");
+
+	//!	@brief	内積取得関数
+	inline float const dot3(Float3 const& lhs, Float3 const& rhs) noexcept {
+		return lhs.x * rhs.x + lhs.y * rhs.y + lhs.z * rhs.z;
+	}
+
+	//!	@brief	二点間の距離の二乗取得関数
+	inline float const distance3(Float3 const& lhs, Float3 const& rhs) noexcept {
+		float const dx = lhs.x - rhs.x, dy = lhs.y - rhs.y, dz = lhs.z - rhs.z;
+		return dx * dx + dy * dy + dz * dz;
+	}
+
+	/**	@class	MeshletBuilder
+	 *	@brief	メッシュレット生成処理クラス
+	 */
+	class MeshletBuilder final {
+	public	:
+		//!	@brief	コンストラクタ
+		MeshletBuilder(MeshletData& out, std::vector<MeshVertex> const& vertices, unsigned int const* indices, size_t const& index_count, float const& cone_weight) noexcept;
+
+		//!	@brief	生成関数
+		void run() noexcept;
+
+	private	:
+		//!	@brief	三角形追加関数
+		void append(unsigned int const& tri) noexcept;
+		//!	@brief	メッシュレット確定関数
+		void flush() noexcept;
+		//!	@brief	追加する三角形の選択関数
+		unsigned int const choose() noexcept;
+		//!	@brief	次のメッシュレットの起点選択関数
+		unsigned int const seed() noexcept;
+
+		//!	@brief	出力先
+		MeshletData& m_out;
+		//!	@brief	頂点配列
+		std::vector<MeshVertex> const& m_vertices;
+		//!	@brief	インデックス配列
+		unsigned int const* m_indices;
+		//!	@brief	三角形数
+		size_t m_triangles;
+		//!	@brief	法線の重み
+		float m_coneWeight;
+		//!	@brief	三角形の重心
+		std::vector<Float3> m_centroids;
+		//!	@brief	三角形の単位法線
+		std::vector<Float3> m_normals;
+		//!	@brief	頂点ごとの隣接三角形の開始位置
+		std::vector<unsigned int> m_offsets;
+		//!	@brief	頂点ごとの隣接三角形
+		std::vector<unsigned int> m_adjacency;
+		//!	@brief	出力済みかどうか
+		std::vector<bool> m_emitted;
+		//!	@brief	候補に登録したメッシュレットの番号
+		std::vector<unsigned int> m_stamps;
+		//!	@brief	頂点ごとの未出力三角形数
+		std::vector<unsigned int> m_live;
+		//!	@brief	作成中のメッシュレットに隣接する三角形
+		std::vector<unsigned int> m_candidates;
+		//!	@brief	頂点ごとのメッシュレット内番号
+		std::vector<unsigned char> m_local;
+		//!	@brief	作成中のメッシュレット
+		Meshlet m_current;
+		//!	@brief	作成中のメッシュレットの重心の和
+		Float3 m_centerSum;
+		//!	@brief	作成中のメッシュレットの法線の和
+		Float3 m_normalSum;
+		//!	@brief	作成中のメッシュレットの広がり (重心からの距離の二乗の最大値)
+		float m_spread;
+	};
+
+	MeshletBuilder::MeshletBuilder(MeshletData& out, std::vector<MeshVertex> const& vertices, unsigned int const* indices, size_t const& index_count, float const& cone_weight) noexcept :
+		m_out(out),
+		m_vertices(vertices),
+		m_indices(indices),
+		m_triangles(index_count / T3_CNT),
+		m_coneWeight(fmaxf(0.0f, fminf(1.0f, cone_weight))),
+		m_centroids(m_triangles),
+		m_normals(m_triangles),
+		m_offsets(vertices.size() + 1U, 0U),
+		m_adjacency(m_triangles * T3_CNT),
+		m_emitted(m_triangles, false),
+		m_stamps(m_triangles, ~0U),
+		m_live(vertices.size(), 0U),
+		m_candidates(),
+		m_local(vertices.size(), LOCAL_NONE),
+		m_current(),
+		m_centerSum(),
+		m_normalSum(),
+		m_spread(0.0f)
+	{
+		for (size_t tri = 0U; tri < m_triangles; ++tri) {
+			FVector3 const p0(vertices[indices[tri * T3_CNT + 0U]].position);
+			FVector3 const p1(vertices[indices[tri * T3_CNT + 1U]].position);
+			FVector3 const p2(vertices[indices[tri * T3_CNT + 2U]].position);
+			FVector3 const n = cross(p1 - p0, p2 - p0);
+			float const length = sqrtf(sqr_magnitude(n));
+			m_centroids[tri] = (p0 + p1 + p2) / 3.0f;
+			m_normals[tri] = length > 0.0f ? n / length : FVT3_ZERO;
+		}
+
+		for (size_t idx = 0U; idx < m_triangles * T3_CNT; ++idx) {
+			++m_offsets[indices[idx] + 1U];
+			++m_live[indices[idx]];
+		}
+		for (size_t idx = 0U; idx < vertices.size(); ++idx) {
+			m_offsets[idx + 1U] += m_offsets[idx];
+		}
+		std::vector<unsigned int> cursor(m_offsets.begin(), m_offsets.end() - 1);
+		for (size_t idx = 0U; idx < m_triangles * T3_CNT; ++idx) {
+			m_adjacency[cursor[indices[idx]]++] = static_cast<unsigned int>(idx / T3_CNT);
+		}
+	}
+
+	void MeshletBuilder::append(unsigned int const& tri) noexcept {
+		unsigned int packed = 0U;
+		for (unsigned int k = 0U; k < T3_CNT; ++k) {
+			unsigned int const v = m_indices[tri * T3_CNT + k];
+			if (m_local[v] == LOCAL_NONE) {
+				m_local[v] = static_cast<unsigned char>(m_current.vertexCount++);
+				m_out.vertices.push_back(v);
+			}
+			packed |= static_cast<unsigned int>(m_local[v]) << (k * 8U);
+		}
+		m_out.triangles.push_back(packed);
+		++m_current.triangleCount;
+		m_emitted[tri] = true;
+		for (unsigned int e = 0U; e < T3_CNT; ++e) {
+			m_centerSum.p[e] += m_centroids[tri].p[e];
+			m_normalSum.p[e] += m_normals[tri].p[e];
+		}
+
+		//	頂点を共有する未出力の三角形を候補に加える
+		unsigned int const stamp = static_cast<unsigned int>(m_out.meshlets.size());
+		for (unsigned int k = 0U; k < T3_CNT; ++k) {
+			unsigned int const v = m_indices[tri * T3_CNT + k];
+			--m_live[v];
+			m_spread = fmaxf(m_spread, distance3(m_vertices[v].position, m_centroids[tri]));
+			for (unsigned int a = m_offsets[v]; a < m_offsets[v + 1U]; ++a) {
+				unsigned int const other = m_adjacency[a];
+				if (!m_emitted[other] && m_stamps[other] != stamp) {
+					m_stamps[other] = stamp;
+					m_candidates.push_back(other);
+				}
+			}
+		}
+	}
+
+	void MeshletBuilder::flush() noexcept {
+		if (m_current.triangleCount == 0U) {
+			return;
+		}
+		for (unsigned int idx = 0U; idx < m_current.vertexCount; ++idx) {
+			m_local[m_out.vertices[m_current.vertexOffset + idx]] = LOCAL_NONE;
+		}
+		m_out.meshlets.push_back(m_current);
+		m_current.vertexOffset = static_cast<unsigned int>(m_out.vertices.size());
+		m_current.triangleOffset = static_cast<unsigned int>(m_out.triangles.size());
+		m_current.vertexCount = 0U;
+		m_current.triangleCount = 0U;
+		m_centerSum = Float3();
+		m_normalSum = Float3();
+		m_spread = 0.0f;
+	}
+
+	unsigned int const MeshletBuilder::choose() noexcept {
+		float const inv = 1.0f / static_cast<float>(m_current.triangleCount);
+		Float3 const center(m_centerSum.x * inv, m_centerSum.y * inv, m_centerSum.z * inv);
+		float const length = sqrtf(dot3(m_normalSum, m_normalSum));
+		Float3 const axis = length > 0.0f ? Float3(m_normalSum.x / length, m_normalSum.y / length, m_normalSum.z / length) : Float3();
+		float const spread = m_spread > 0.0f ? m_spread : 1.0f;
+
+		unsigned int result = ~0U;
+		float top = FLT_MAX;
+		for (size_t idx = 0U; idx < m_candidates.size();) {
+			unsigned int const tri = m_candidates[idx];
+			if (m_emitted[tri]) {
+				m_candidates[idx] = m_candidates.back();
+				m_candidates.pop_back();
+				continue;
+			}
+			++idx;
+
+			unsigned int extra = 0U;
+			for (unsigned int k = 0U; k < T3_CNT; ++k) {
+				extra += m_local[m_indices[tri * T3_CNT + k]] == LOCAL_NONE ? 1U : 0U;
+			}
+			if (m_current.vertexCount + extra > MESHLET_VERTEX_MAX) {
+				continue;
+			}
+
+			//	新しい頂点の少なさを優先し、近さと法線の揃い具合で順位を付ける
+			float const distance = distance3(m_centroids[tri], center) / spread;
+			float const facing = 1.0f - dot3(m_normals[tri], axis);
+			float const score = static_cast<float>(extra) + (1.0f - m_coneWeight) * fminf(distance, 1.0f) + m_coneWeight * facing;
+			if (score < top) {
+				top = score;
+				result = tri;
+			}
+		}
+		return result;
+	}
+
+	unsigned int const MeshletBuilder::seed() noexcept {
+		//	直前のメッシュレットに接する三角形のうち、取り残されやすい (未出力の隣接が少ない) ものから始める
+		unsigned int result = ~0U;
+		unsigned int top = ~0U;
+		for (unsigned int const& tri : m_candidates) {
+			if (m_emitted[tri]) {
+				continue;
+			}
+			unsigned int live = 0U;
+			for (unsigned int k = 0U; k < T3_CNT; ++k) {
+				live += m_live[m_indices[tri * T3_CNT + k]];
+			}
+			if (live < top) {
+				top = live;
+				result = tri;
+			}
+		}
+		m_candidates.clear();
+		return result;
+	}
+
+	void MeshletBuilder::run() noexcept {
+		m_current.vertexOffset = static_cast<unsigned int>(m_out.vertices.size());
+		m_current.triangleOffset = static_cast<unsigned int>(m_out.triangles.size());
+
+		size_t cursor = 0U;
+		while (true) {
+			if (m_current.triangleCount == 0U) {
+				unsigned int first = seed();
+				if (first == ~0U) {
+					while (cursor < m_triangles && m_emitted[cursor]) {
+						++cursor;
+					}
+					if (cursor == m_triangles) {
+						break;
+					}
+					first = static_cast<unsigned int>(cursor);
+				}
+				append(first);
+			}
+
+			unsigned int const next = m_current.triangleCount < MESHLET_TRIANGLE_MAX ? choose() : ~0U;
+			if (next == ~0U) {
+				flush();
+			}
+			else {
+				append(next);
+			}
+		}
+		flush();
+	}
+
+	/**	@brief	境界計算関数
+	 *	@details	境界球は軸並行境界箱の中心から求め、法線錐は三角形法線の平均を軸とします。
+	 */
+	MeshletBounds const computeBounds(MeshletData const& data, Meshlet const& meshlet, std::vector<MeshVertex> const& vertices) noexcept {
+		MeshletBounds result = {};
+		unsigned int const* local = &data.vertices[meshlet.vertexOffset];
+
+		Float3 lower(FLT_MAX, FLT_MAX, FLT_MAX), upper(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+		for (unsigned int idx = 0U; idx < meshlet.vertexCount; ++idx) {
+			Float3 const& p = vertices[local[idx]].position;
+			for (unsigned int e = 0U; e < T3_CNT; ++e) {
+				lower.p[e] = fminf(lower.p[e], p.p[e]);
+				upper.p[e] = fmaxf(upper.p[e], p.p[e]);
+			}
+		}
+		FVector3 const center = (FVector3(lower) + FVector3(upper)) * 0.5f;
+		float radius = 0.0f;
+		for (unsigned int idx = 0U; idx < meshlet.vertexCount; ++idx) {
+			radius = fmaxf(radius, sqr_magnitude(FVector3(vertices[local[idx]].position) - center));
+		}
+		result.center = center;
+		result.radius = sqrtf(radius);
+
+		FVector3 normals[MESHLET_TRIANGLE_MAX];
+		FVector3 corners[MESHLET_TRIANGLE_MAX];
+		FVector3 sum = FVT3_ZERO;
+		unsigned int count = 0U;
+		for (unsigned int tri = 0U; tri < meshlet.triangleCount; ++tri) {
+			unsigned int const packed = data.triangles[meshlet.triangleOffset + tri];
+			FVector3 const p0(vertices[local[packed & 0xFFU]].position);
+			FVector3 const p1(vertices[local[(packed >> 8U) & 0xFFU]].position);
+			FVector3 const p2(vertices[local[(packed >> 16U) & 0xFFU]].position);
+			FVector3 const n = cross(p1 - p0, p2 - p0);
+			float const length = sqrtf(sqr_magnitude(n));
+			if (length <= 0.0f) {
+				continue;
+			}
+			normals[count] = n / length;
+			corners[count] = p0;
+			sum += normals[count];
+			++count;
+		}
+
+		//	判定不能な場合は必ず表向きと判定されるようにする
+		result.coneApex = center;
+		result.coneAxis = Float3(0.0f, 0.0f, 1.0f);
+		result.coneCutoff = 1.0f;
+		float const length = sqrtf(sqr_magnitude(sum));
+		if (count == 0U || length <= 0.0f) {
+			return result;
+		}
+
+		FVector3 const axis = sum / length;
+		float lowest = 1.0f;
+		for (unsigned int idx = 0U; idx < count; ++idx) {
+			lowest = fminf(lowest, dot(normals[idx], axis));
+		}
+		if (lowest <= 0.1f) {
+			return result;
+		}
+
+		//	全三角形の平面の裏側に来る位置まで軸に沿って下がった点を頂点とする
+		float back = 0.0f;
+		for (unsigned int idx = 0U; idx < count; ++idx) {
+			float const dc = dot(corners[idx] - center, normals[idx]);
+			float const dn = dot(axis, normals[idx]);
+			back = fmaxf(back, dc / dn);
+		}
+		result.coneApex = center - axis * back;
+		result.coneAxis = axis;
+		result.coneCutoff = sqrtf(1.0f - lowest * lowest);
+		return result;
+	}
+
+	//!	@brief	視錐台平面抽出関数 (内側が正、xyz は単位法線)
+	void extractFrustum(FMatrix4x4 const& m, Float4 (&planes)[FRUSTUM_PLANE_CNT]) noexcept {
+		for (unsigned int idx = 0U; idx < FRUSTUM_PLANE_CNT; ++idx) {
+			unsigned int const axis = idx / 2U;
+			float const sign = idx % 2U == 0U ? 1.0f : -1.0f;
+			Float4& plane = planes[idx];
+			for (unsigned int e = 0U; e < T4_CNT; ++e) {
+				//	Direct3D の深度は 0 ～ w なので、近平面だけ w を足さない
+				float const w = axis == 2U && sign > 0.0f ? 0.0f : m.m[e][3U];
+				plane.p[e] = w + sign * m.m[e][axis];
+			}
+			float const length = sqrtf(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+			if (length > 0.0f) {
+				for (unsigned int e = 0U; e < T4_CNT; ++e) {
+					plane.p[e] /= length;
+				}
+			}
+		}
+	}
+}
+
+namespace dlph {
+	bool const buildMeshlets(MeshletData& out, std::vector<MeshVertex> const& vertices, std::vector<unsigned int> const& indices, float const& cone_weight) noexcept {
+		out.meshlets.clear();
+		out.bounds.clear();
+		out.vertices.clear();
+		out.triangles.clear();
+		if (indices.size() < T3_CNT || vertices.empty()) {
+			return false;
+		}
+
+		MeshletBuilder builder(out, vertices, indices.data(), indices.size(), cone_weight);
+		builder.run();
+
+		out.bounds.resize(out.meshlets.size());
+		for (size_t idx = 0U; idx < out.meshlets.size(); ++idx) {
+			out.bounds[idx] = computeBounds(out, out.meshlets[idx], vertices);
+		}
+		return true;
+	}
+
+	void buildMeshlets(std::vector<MeshletData>& out, Mesh const* meshes, size_t const& count, float const& cone_weight) noexcept {
+		out.resize(count);
+		parallel_for(count, 1U, [&](size_t const& begin, size_t const& end) {
+			for (size_t idx = begin; idx < end; ++idx) {
+				Mesh const& mesh = meshes[idx];
+				if (mesh.lods.empty()) {
+					buildMeshlets(out[idx], mesh.vertices, mesh.indices, cone_weight);
+				}
+				else {
+					auto const first = mesh.indices.begin() + mesh.lods[0U].indexOffset;
+					std::vector<unsigned int> const lod(first, first + mesh.lods[0U].indexCount);
+					buildMeshlets(out[idx], mesh.vertices, lod, cone_weight);
+				}
+			}
+		});
+	}
+
+	size_t const cullMeshlets(std::vector<unsigned int>& visible, MeshletData const& data, FMatrix4x4 const& world, FMatrix4x4 const& view_projection, FVector3 const& camera) noexcept {
+		visible.clear();
+
+		Float4 planes[FRUSTUM_PLANE_CNT];
+		extractFrustum(world * view_projection, planes);
+
+		//	半径はワールド行列の最大拡大率で広げる (法線錐は均等拡大を仮定)
+		float scale = 0.0f;
+		for (unsigned int row = 0U; row < 3U; ++row) {
+			float const* m = world.m[row];
+			scale = fmaxf(scale, m[0U] * m[0U] + m[1U] * m[1U] + m[2U] * m[2U]);
+		}
+		scale = sqrtf(scale);
+
+		auto const transform = [&](Float3 const& v, float const& w) {
+			return FVector3(
+				v.x * world.m[0U][0U] + v.y * world.m[1U][0U] + v.z * world.m[2U][0U] + w * world.m[3U][0U],
+				v.x * world.m[0U][1U] + v.y * world.m[1U][1U] + v.z * world.m[2U][1U] + w * world.m[3U][1U],
+				v.x * world.m[0U][2U] + v.y * world.m[1U][2U] + v.z * world.m[2U][2U] + w * world.m[3U][2U]
+			);
+		};
+
+		for (size_t idx = 0U; idx < data.bounds.size(); ++idx) {
+			MeshletBounds const& bounds = data.bounds[idx];
+
+			//	視錐台の判定は物体空間で正規化した平面で行う
+			bool inside = true;
+			for (unsigned int p = 0U; p < FRUSTUM_PLANE_CNT && inside; ++p) {
+				Float4 const& plane = planes[p];
+				inside = plane.x * bounds.center.x + plane.y * bounds.center.y + plane.z * bounds.center.z + plane.w >= -bounds.radius;
+			}
+			if (!inside) {
+				continue;
+			}
+
+			if (bounds.coneCutoff < 1.0f) {
+				FVector3 const center = transform(bounds.center, 1.0f);
+				FVector3 const axis = normalize(transform(bounds.coneAxis, 0.0f));
+				FVector3 const view = center - camera;
+				if (dot(view, axis) >= bounds.coneCutoff * sqrtf(sqr_magnitude(view)) + bounds.radius * scale) {
+					continue;
+				}
+			}
+			visible.push_back(static_cast<unsigned int>(idx));
+		}
+		return visible.size();
+	}
+}
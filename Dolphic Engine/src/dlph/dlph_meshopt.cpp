@@ -0,0 +1,328 @@
+﻿/**	@file	dlph_meshopt.cpp
+ *	@brief	Dolphic Engine 用のメッシュ最適化関数群
+ */
+#include "dlph/dlph_meshopt.hpp"
+#include "math/fvec3.hpp"
+#include "util/parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace {
+	using namespace dlph;
+
+	//!	@brief	並列処理の区間長
+	static size_t constexpr MESH_GRAIN = 1024U;
+	//!	@brief	オーバードロー最適化で模擬するキャッシュサイズ
+	static unsigned int constexpr OVERDRAW_CACHE_SIZE = 16U;
+	//!	@brief	スコア表を持つ最大の残り三角形数
+	static unsigned int constexpr VALENCE_MAX = 32U;
+
+	/**	@class	FifoCache
+	 *	@brief	FIFO 頂点キャッシュの模擬クラス
+	 */
+	class FifoCache final {
+	public	:
+		//!	@brief	コンストラクタ
+		FifoCache(size_t const& vertex_count, unsigned int const& cache_size) noexcept :
+			m_stamps(vertex_count, 0U),
+			m_time(cache_size + 1U),
+			m_size(cache_size)
+		{}
+
+		//!	@brief	キャッシュ破棄関数
+		void reset() noexcept {
+			m_time += m_size + 1U;
+		}
+
+		//!	@brief	三角形処理関数 (ミス数を返す)
+		unsigned int const feed(unsigned int const* tri) noexcept {
+			unsigned int misses = 0U;
+			for (unsigned int k = 0U; k < T3_CNT; ++k) {
+				if (m_time - m_stamps[tri[k]] > m_size) {
+					m_stamps[tri[k]] = m_time++;
+					++misses;
+				}
+			}
+			return misses;
+		}
+
+	private	:
+		//!	@brief	頂点ごとの格納時刻
+		std::vector<unsigned int> m_stamps;
+		//!	@brief	現在時刻
+		unsigned int m_time;
+		//!	@brief	キャッシュサイズ
+		unsigned int m_size;
+	};
+
+	/**	@struct	ForsythTable
+	 *	@brief	Forsyth 法のスコア表
+	 */
+	struct ForsythTable final {
+		//!	@brief	キャッシュ位置ごとのスコア
+		float cache[VERTEX_CACHE_SIZE];
+		//!	@brief	残り三角形数ごとのスコア
+		float valence[VALENCE_MAX + 1U];
+
+		//!	@brief	コンストラクタ
+		ForsythTable() noexcept :
+			cache(),
+			valence()
+		{
+			for (unsigned int idx = 0U; idx < VERTEX_CACHE_SIZE; ++idx) {
+				//	直前の三角形の頂点は、同じ三角形を続けて選ばないよう一定値とする
+				cache[idx] = idx < T3_CNT ? 0.75f : powf(1.0f - static_cast<float>(idx - T3_CNT) / static_cast<float>(VERTEX_CACHE_SIZE - T3_CNT), 1.5f);
+			}
+			for (unsigned int idx = 1U; idx <= VALENCE_MAX; ++idx) {
+				valence[idx] = 2.0f / sqrtf(static_cast<float>(idx));
+			}
+		}
+
+		//!	@brief	頂点スコア取得関数
+		float const score(int const& position, unsigned int const& live) const noexcept {
+			if (live == 0U) {
+				return -1.0f;
+			}
+			float const base = position < 0 ? 0.0f : cache[position];
+			return base + valence[std::min(live, VALENCE_MAX)];
+		}
+	};
+}
+
+namespace dlph {
+	void optimizeVertexCache(std::vector<unsigned int>& indices, size_t const& vertex_count) noexcept {
+		size_t const triangles = indices.size() / T3_CNT;
+		if (triangles == 0U || vertex_count == 0U) {
+			return;
+		}
+		static ForsythTable const table;
+
+		//	頂点ごとの未出力三角形一覧
+		std::vector<unsigned int> offsets(vertex_count + 1U, 0U);
+		for (size_t idx = 0U; idx < triangles * T3_CNT; ++idx) {
+			++offsets[indices[idx] + 1U];
+		}
+		std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+		std::vector<unsigned int> live(vertex_count, 0U);
+		std::vector<unsigned int> adjacency(triangles * T3_CNT);
+		for (size_t tri = 0U; tri < triangles; ++tri) {
+			for (unsigned int k = 0U; k < T3_CNT; ++k) {
+				unsigned int const v = indices[tri * T3_CNT + k];
+				adjacency[offsets[v] + live[v]++] = static_cast<unsigned int>(tri);
+			}
+		}
+
+		std::vector<int> position(vertex_count, -1);
+		std::vector<float> vertexScore(vertex_count);
+		parallel_for(vertex_count, MESH_GRAIN * 16U, [&](size_t const& begin, size_t const& end) {
+			for (size_t v = begin; v < end; ++v) {
+				vertexScore[v] = table.score(-1, live[v]);
+			}
+		});
+
+		std::vector<float> triangleScore(triangles);
+		std::vector<bool> emitted(triangles, false);
+		size_t best = 0U;
+		for (size_t tri = 0U; tri < triangles; ++tri) {
+			unsigned int const* t = &indices[tri * T3_CNT];
+			triangleScore[tri] = vertexScore[t[0U]] + vertexScore[t[1U]] + vertexScore[t[2U]];
+			if (triangleScore[tri] > triangleScore[best]) {
+				best = tri;
+			}
+		}
+
+		std::vector<unsigned int> result;
+		result.reserve(triangles * T3_CNT);
+		unsigned int cache[VERTEX_CACHE_SIZE + T3_CNT] = {};
+		unsigned int cacheCount = 0U;
+		size_t cursor = 0U;
+
+		while (result.size() < triangles * T3_CNT) {
+			unsigned int const tri[T3_CNT] = { indices[best * T3_CNT + 0U], indices[best * T3_CNT + 1U], indices[best * T3_CNT + 2U] };
+			emitted[best] = true;
+			result.insert(result.end(), tri, tri + T3_CNT);
+
+			//	出力した三角形を各頂点の一覧から取り除く
+			for (unsigned int const& v : tri) {
+				unsigned int* first = &adjacency[offsets[v]];
+				unsigned int* last = first + live[v];
+				unsigned int* it = std::find(first, last, static_cast<unsigned int>(best));
+				if (it != last) {
+					*it = *(last - 1);
+					--live[v];
+				}
+			}
+
+			//	出力した頂点をキャッシュの先頭へ移動する
+			unsigned int next[VERTEX_CACHE_SIZE + T3_CNT] = { tri[0U], tri[1U], tri[2U] };
+			unsigned int nextCount = T3_CNT;
+			for (unsigned int idx = 0U; idx < cacheCount; ++idx) {
+				unsigned int const v = cache[idx];
+				if (v != tri[0U] && v != tri[1U] && v != tri[2U]) {
+					next[nextCount++] = v;
+				}
+			}
+			for (unsigned int idx = 0U; idx < nextCount; ++idx) {
+				unsigned int const v = next[idx];
+				position[v] = idx < VERTEX_CACHE_SIZE ? static_cast<int>(idx) : -1;
+				vertexScore[v] = table.score(position[v], live[v]);
+			}
+
+			//	キャッシュ内の頂点に接する三角形から次を選ぶ
+			float top = -1.0f;
+			size_t candidate = triangles;
+			for (unsigned int idx = 0U; idx < nextCount; ++idx) {
+				unsigned int const v = next[idx];
+				for (unsigned int a = offsets[v]; a < offsets[v] + live[v]; ++a) {
+					unsigned int const t = adjacency[a];
+					unsigned int const* ti = &indices[t * T3_CNT];
+					triangleScore[t] = vertexScore[ti[0U]] + vertexScore[ti[1U]] + vertexScore[ti[2U]];
+					if (triangleScore[t] > top) {
+						top = triangleScore[t];
+						candidate = t;
+					}
+				}
+			}
+
+			cacheCount = std::min(nextCount, VERTEX_CACHE_SIZE);
+			std::copy(next, next + cacheCount, cache);
+
+			if (candidate == triangles) {
+				//	行き詰まった場合は未出力の三角形を先頭から探す
+				while (cursor < triangles && emitted[cursor]) {
+					++cursor;
+				}
+				candidate = cursor;
+			}
+			best = candidate;
+			if (best == triangles) {
+				break;
+			}
+		}
+
+		indices.swap(result);
+	}
+
+	void optimizeOverdraw(std::vector<unsigned int>& indices, std::vector<MeshVertex> const& vertices, float const& threshold) noexcept {
+		size_t const triangles = indices.size() / T3_CNT;
+		if (triangles == 0U || vertices.empty()) {
+			return;
+		}
+
+		//	三頂点すべてがキャッシュミスする位置で硬い境界を作る
+		std::vector<size_t> hard;
+		{
+			FifoCache cache(vertices.size(), OVERDRAW_CACHE_SIZE);
+			for (size_t tri = 0U; tri < triangles; ++tri) {
+				if (cache.feed(&indices[tri * T3_CNT]) == T3_CNT) {
+					hard.push_back(tri);
+				}
+			}
+			hard.push_back(triangles);
+		}
+
+		//	硬い境界内の平均ミス率を許容値倍まで下回る位置で柔らかい境界を作る
+		std::vector<size_t> clusters;
+		{
+			FifoCache cache(vertices.size(), OVERDRAW_CACHE_SIZE);
+			for (size_t h = 0U; h + 1U < hard.size(); ++h) {
+				size_t const first = hard[h], last = hard[h + 1U];
+				cache.reset();
+				unsigned int misses = 0U;
+				for (size_t tri = first; tri < last; ++tri) {
+					misses += cache.feed(&indices[tri * T3_CNT]);
+				}
+				float const limit = threshold * static_cast<float>(misses) / static_cast<float>(last - first);
+
+				cache.reset();
+				clusters.push_back(first);
+				size_t start = first;
+				misses = 0U;
+				for (size_t tri = first; tri < last; ++tri) {
+					misses += cache.feed(&indices[tri * T3_CNT]);
+					if (tri + 1U < last && static_cast<float>(misses) <= limit * static_cast<float>(tri + 1U - start)) {
+						clusters.push_back(tri + 1U);
+						start = tri + 1U;
+						misses = 0U;
+						cache.reset();
+					}
+				}
+			}
+			clusters.push_back(triangles);
+		}
+
+		//	メッシュ中心から見たクラスタの向きを求める
+		FVector3 center = FVT3_ZERO;
+		for (MeshVertex const& vertex : vertices) {
+			center += FVector3(vertex.position);
+		}
+		center /= static_cast<float>(vertices.size());
+
+		size_t const clusterCount = clusters.size() - 1U;
+		std::vector<float> keys(clusterCount);
+		parallel_for(clusterCount, MESH_GRAIN, [&](size_t const& begin, size_t const& end) {
+			for (size_t c = begin; c < end; ++c) {
+				FVector3 centroid = FVT3_ZERO, normal = FVT3_ZERO;
+				float area = 0.0f;
+				for (size_t tri = clusters[c]; tri < clusters[c + 1U]; ++tri) {
+					FVector3 const p0(vertices[indices[tri * T3_CNT + 0U]].position);
+					FVector3 const p1(vertices[indices[tri * T3_CNT + 1U]].position);
+					FVector3 const p2(vertices[indices[tri * T3_CNT + 2U]].position);
+					FVector3 const n = cross(p1 - p0, p2 - p0);
+					float const a = sqrtf(sqr_magnitude(n));
+					centroid += (p0 + p1 + p2) * (a / 3.0f);
+					normal += n;
+					area += a;
+				}
+				float const length = sqrtf(sqr_magnitude(normal));
+				keys[c] = area > 0.0f && length > 0.0f ? dot(centroid / area - center, normal / length) : 0.0f;
+			}
+		});
+
+		//	外向きのクラスタほど先に描画する
+		std::vector<size_t> order(clusterCount);
+		std::iota(order.begin(), order.end(), static_cast<size_t>(0U));
+		std::stable_sort(order.begin(), order.end(), [&](size_t const& lhs, size_t const& rhs) {
+			return keys[lhs] > keys[rhs];
+		});
+
+		std::vector<unsigned int> result;
+		result.reserve(triangles * T3_CNT);
+		for (size_t const& c : order) {
+			result.insert(result.end(), indices.begin() + clusters[c] * T3_CNT, indices.begin() + clusters[c + 1U] * T3_CNT);
+		}
+		indices.swap(result);
+	}
+
+	size_t const optimizeVertexFetch(std::vector<MeshVertex>& vertices, std::vector<unsigned int>& indices) noexcept {
+		std::vector<unsigned int> remap(vertices.size(), ~0U);
+		std::vector<MeshVertex> result;
+		result.reserve(vertices.size());
+
+		for (unsigned int& index : indices) {
+			if (remap[index] == ~0U) {
+				remap[index] = static_cast<unsigned int>(result.size());
+				result.push_back(vertices[index]);
+			}
+			index = remap[index];
+		}
+
+		vertices.swap(result);
+		return vertices.size();
+	}
+
+	float const vertexCacheMissRatio(std::vector<unsigned int> const& indices, size_t const& vertex_count, unsigned int const& cache_size) noexcept {
+		size_t const triangles = indices.size() / T3_CNT;
+		if (triangles == 0U) {
+			return 0.0f;
+		}
+
+		FifoCache cache(vertex_count, cache_size);
+		size_t misses = 0U;
+		for (size_t tri = 0U; tri < triangles; ++tri) {
+			misses += cache.feed(&indices[tri * T3_CNT]);
+		}
+		return static_cast<float>(misses) / static_cast<float>(triangles);
+	}
+}
@@ -0,0 +1,340 @@
+﻿/**	@file	dlph_meshproc.cpp
+ *	@brief	Dolphic Engine 用のメッシュ加工関数群
+ */
+#include "dlph/dlph_meshproc.hpp"
+#include "math/fvec3.hpp"
+#include "util/parallel.hpp"
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+namespace {
+	using namespace dlph;
+
+	//!	@brief	並列処理の区間長
+	static size_t constexpr MESH_GRAIN = 4096U;
+	//!	@brief	頂点の成分数
+	static unsigned int constexpr VERTEX_ELEMENT_CNT = 12U;
+	//!	@brief	ハッシュ連結リストの終端
+	static unsigned int constexpr CHAIN_END = ~0U;
+
+	//!	@brief	ハッシュ値合成関数
+	unsigned long long const mix(unsigned long long const& seed, unsigned int const& value) noexcept {
+		return seed ^ (value + 0x9E3779B97F4A7C15ULL + (seed << 6U) + (seed >> 2U));
+	}
+
+	//!	@brief	ビット列取得関数 (-0 と +0 を同一視)
+	unsigned int const bits(float const& value) noexcept {
+		float const positive = value + 0.0f;
+		unsigned int result = 0U;
+		memcpy(&result, &positive, sizeof(result));
+		return result;
+	}
+
+	//!	@brief	頂点成分展開関数
+	void flatten(MeshVertex const& vertex, float (&out)[VERTEX_ELEMENT_CNT]) noexcept {
+		memcpy(&out[0U], vertex.position.p, sizeof(float) * T3_CNT);
+		memcpy(&out[3U], vertex.normal.p, sizeof(float) * T3_CNT);
+		memcpy(&out[6U], vertex.tangent.p, sizeof(float) * T4_CNT);
+		memcpy(&out[10U], vertex.texcoord.p, sizeof(float) * T2_CNT);
+	}
+
+	//!	@brief	頂点比較関数
+	bool const similar(MeshVertex const& lhs, MeshVertex const& rhs, float const& epsilon) noexcept {
+		float l[VERTEX_ELEMENT_CNT], r[VERTEX_ELEMENT_CNT];
+		flatten(lhs, l);
+		flatten(rhs, r);
+		for (unsigned int idx = 0U; idx < VERTEX_ELEMENT_CNT; ++idx) {
+			if (!(fabsf(l[idx] - r[idx]) <= epsilon)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	//!	@brief	座標一致比較関数
+	bool const samePosition(Float3 const& lhs, Float3 const& rhs) noexcept {
+		return lhs.x == rhs.x && lhs.y == rhs.y && lhs.z == rhs.z;
+	}
+
+	//!	@brief	座標のハッシュ値取得関数
+	unsigned long long const hashPosition(Float3 const& position) noexcept {
+		return mix(mix(mix(0U, bits(position.x)), bits(position.y)), bits(position.z));
+	}
+
+	/**	@brief	頂点隣接構造構築関数
+	 *	@details	頂点ごとに参照している三角形の角 (三角形番号 * 3 + 角番号) を連続領域に並べます。
+	 *	@param[in] indices インデックス配列
+	 *	@param[in] vertex_count 頂点数
+	 *	@param[out] offsets 頂点ごとの開始位置 (頂点数 + 1 個)
+	 *	@param[out] corners 角の一覧
+	 */
+	void buildAdjacency(std::vector<unsigned int> const& indices, size_t const& vertex_count, std::vector<unsigned int>& offsets, std::vector<unsigned int>& corners) noexcept {
+		size_t const count = indices.size() / T3_CNT * T3_CNT;
+		offsets.assign(vertex_count + 1U, 0U);
+		for (size_t idx = 0U; idx < count; ++idx) {
+			++offsets[indices[idx] + 1U];
+		}
+		for (size_t idx = 0U; idx < vertex_count; ++idx) {
+			offsets[idx + 1U] += offsets[idx];
+		}
+		std::vector<unsigned int> cursor(offsets.begin(), offsets.end() - 1);
+		corners.resize(count);
+		for (size_t idx = 0U; idx < count; ++idx) {
+			corners[cursor[indices[idx]]++] = static_cast<unsigned int>(idx);
+		}
+	}
+
+	//!	@brief	頂点角取得関数
+	float const cornerAngle(FVector3 const& e1, FVector3 const& e2) noexcept {
+		float const l1 = sqr_magnitude(e1), l2 = sqr_magnitude(e2);
+		if (l1 <= 0.0f || l2 <= 0.0f) {
+			return 0.0f;
+		}
+		float const c = dot(e1, e2) / sqrtf(l1 * l2);
+		return acosf(fmaxf(-1.0f, fminf(1.0f, c)));
+	}
+
+	//!	@brief	平面射影関数
+	FVector3 const project(FVector3 const& v, FVector3 const& n) noexcept {
+		return v - n * dot(n, v);
+	}
+
+	//!	@brief	安全な正規化関数
+	FVector3 const safeNormalize(FVector3 const& v) noexcept {
+		float const length = sqrtf(sqr_magnitude(v));
+		return length > 0.0f ? v / length : FVT3_ZERO;
+	}
+
+	/**	@struct	TangentCorner
+	 *	@brief	三角形の角ごとの接ベクトル寄与
+	 */
+	struct TangentCorner final {
+		//!	@brief	頂点角で重み付けした接ベクトル
+		Float3 tangent;
+		//!	@brief	重み
+		float weight;
+		//!	@brief	テクスチャ座標の向きが保たれているかどうか
+		bool preserving;
+	};
+}
+
+namespace dlph {
+	size_t const weldVertices(std::vector<MeshVertex>& vertices, std::vector<unsigned int>& indices, float const& epsilon) noexcept {
+		float const eps = fmaxf(epsilon, 0.0f);
+		float const inv = eps > 0.0f ? 1.0f / eps : 0.0f;
+
+		//	許容値付きの場合は座標を格子に量子化し、近傍 27 格子を探索する
+		auto const cell = [&](Float3 const& position, int const& dx, int const& dy, int const& dz) {
+			if (eps <= 0.0f) {
+				return hashPosition(position);
+			}
+			int const cx = static_cast<int>(floorf(position.x * inv)) + dx;
+			int const cy = static_cast<int>(floorf(position.y * inv)) + dy;
+			int const cz = static_cast<int>(floorf(position.z * inv)) + dz;
+			return mix(mix(mix(0U, static_cast<unsigned int>(cx)), static_cast<unsigned int>(cy)), static_cast<unsigned int>(cz));
+		};
+		int const reach = eps > 0.0f ? 1 : 0;
+
+		std::unordered_map<unsigned long long, unsigned int> heads;
+		std::vector<unsigned int> chain;
+		std::vector<MeshVertex> unique;
+		std::vector<unsigned int> remap(vertices.size(), 0U);
+		heads.reserve(vertices.size());
+		unique.reserve(vertices.size());
+		chain.reserve(vertices.size());
+
+		for (size_t idx = 0U; idx < vertices.size(); ++idx) {
+			MeshVertex const& vertex = vertices[idx];
+			unsigned int found = CHAIN_END;
+			for (int dx = -reach; dx <= reach && found == CHAIN_END; ++dx) {
+				for (int dy = -reach; dy <= reach && found == CHAIN_END; ++dy) {
+					for (int dz = -reach; dz <= reach && found == CHAIN_END; ++dz) {
+						auto const it = heads.find(cell(vertex.position, dx, dy, dz));
+						if (it == heads.end()) {
+							continue;
+						}
+						for (unsigned int other = it->second; other != CHAIN_END; other = chain[other]) {
+							if (similar(unique[other], vertex, eps)) {
+								found = other;
+								break;
+							}
+						}
+					}
+				}
+			}
+
+			if (found == CHAIN_END) {
+				found = static_cast<unsigned int>(unique.size());
+				unique.push_back(vertex);
+				auto const result = heads.emplace(cell(vertex.position, 0, 0, 0), found);
+				chain.push_back(result.second ? CHAIN_END : result.first->second);
+				result.first->second = found;
+			}
+			remap[idx] = found;
+		}
+
+		if (indices.empty()) {
+			indices.swap(remap);
+		}
+		else {
+			parallel_for(indices.size(), MESH_GRAIN, [&](size_t const& begin, size_t const& end) {
+				for (size_t idx = begin; idx < end; ++idx) {
+					indices[idx] = remap[indices[idx]];
+				}
+			});
+		}
+		vertices.swap(unique);
+		return vertices.size();
+	}
+
+	void generatePositionRemap(std::vector<MeshVertex> const& vertices, std::vector<unsigned int>& remap) noexcept {
+		std::unordered_map<unsigned long long, unsigned int> heads;
+		std::vector<unsigned int> chain(vertices.size(), CHAIN_END);
+		heads.reserve(vertices.size());
+		remap.resize(vertices.size());
+
+		for (unsigned int idx = 0U; idx < vertices.size(); ++idx) {
+			auto const result = heads.emplace(hashPosition(vertices[idx].position), idx);
+			remap[idx] = idx;
+			if (result.second) {
+				continue;
+			}
+			unsigned int other = result.first->second;
+			for (; other != CHAIN_END; other = chain[other]) {
+				if (samePosition(vertices[other].position, vertices[idx].position)) {
+					break;
+				}
+			}
+			if (other != CHAIN_END) {
+				remap[idx] = other;
+			}
+			else {
+				chain[idx] = result.first->second;
+				result.first->second = idx;
+			}
+		}
+	}
+
+	void generateNormals(std::vector<MeshVertex>& vertices, std::vector<unsigned int> const& indices) noexcept {
+		size_t const triangles = indices.size() / T3_CNT;
+		std::vector<unsigned int> remap;
+		generatePositionRemap(vertices, remap);
+
+		//	角ごとに頂点角で重み付けした面法線を求める
+		std::vector<Float3> weighted(triangles * T3_CNT);
+		parallel_for(triangles, MESH_GRAIN, [&](size_t const& begin, size_t const& end) {
+			for (size_t tri = begin; tri < end; ++tri) {
+				FVector3 const p[T3_CNT] = {
+					vertices[indices[tri * T3_CNT + 0U]].position,
+					vertices[indices[tri * T3_CNT + 1U]].position,
+					vertices[indices[tri * T3_CNT + 2U]].position
+				};
+				FVector3 const normal = safeNormalize(cross(p[1U] - p[0U], p[2U] - p[0U]));
+				for (unsigned int k = 0U; k < T3_CNT; ++k) {
+					FVector3 const& o = p[k];
+					float const angle = cornerAngle(p[(k + 1U) % T3_CNT] - o, p[(k + 2U) % T3_CNT] - o);
+					weighted[tri * T3_CNT + k] = normal * angle;
+				}
+			}
+		});
+
+		//	同じ座標の頂点で共有するため、代表頂点の番号で隣接構造を作る
+		std::vector<unsigned int> shared(triangles * T3_CNT);
+		for (size_t idx = 0U; idx < shared.size(); ++idx) {
+			shared[idx] = remap[indices[idx]];
+		}
+		std::vector<unsigned int> offsets, corners;
+		buildAdjacency(shared, vertices.size(), offsets, corners);
+
+		std::vector<Float3> normals(vertices.size());
+		parallel_for(vertices.size(), MESH_GRAIN, [&](size_t const& begin, size_t const& end) {
+			for (size_t idx = begin; idx < end; ++idx) {
+				if (remap[idx] != idx) {
+					continue;
+				}
+				FVector3 sum = FVT3_ZERO;
+				for (unsigned int c = offsets[idx]; c < offsets[idx + 1U]; ++c) {
+					sum += FVector3(weighted[corners[c]]);
+				}
+				normals[idx] = safeNormalize(sum);
+			}
+		});
+		parallel_for(vertices.size(), MESH_GRAIN, [&](size_t const& begin, size_t const& end) {
+			for (size_t idx = begin; idx < end; ++idx) {
+				FVector3 const normal(normals[remap[idx]]);
+				if (normal != FVT3_ZERO) {
+					vertices[idx].normal = normal;
+				}
+			}
+		});
+	}
+
+	void generateTangents(std::vector<MeshVertex>& vertices, std::vector<unsigned int> const& indices) noexcept {
+		size_t const triangles = indices.size() / T3_CNT;
+
+		//	三角形ごとにテクスチャ座標の偏微分を求め、各角の法線平面へ射影して頂点角で重み付けする
+		std::vector<TangentCorner> contributions(triangles * T3_CNT);
+		parallel_for(triangles, MESH_GRAIN, [&](size_t const& begin, size_t const& end) {
+			for (size_t tri = begin; tri < end; ++tri) {
+				MeshVertex const* v[T3_CNT] = {
+					&vertices[indices[tri * T3_CNT + 0U]],
+					&vertices[indices[tri * T3_CNT + 1U]],
+					&vertices[indices[tri * T3_CNT + 2U]]
+				};
+				FVector3 const d1 = FVector3(v[1U]->position) - FVector3(v[0U]->position);
+				FVector3 const d2 = FVector3(v[2U]->position) - FVector3(v[0U]->position);
+				float const s1x = v[1U]->texcoord.x - v[0U]->texcoord.x, s1y = v[1U]->texcoord.y - v[0U]->texcoord.y;
+				float const s2x = v[2U]->texcoord.x - v[0U]->texcoord.x, s2y = v[2U]->texcoord.y - v[0U]->texcoord.y;
+				float const area = s1x * s2y - s1y * s2x;
+				bool const preserving = area > 0.0f;
+				FVector3 const os = safeNormalize(d1 * s2y - d2 * s1y) * (preserving ? 1.0f : -1.0f);
+
+				for (unsigned int k = 0U; k < T3_CNT; ++k) {
+					TangentCorner& out = contributions[tri * T3_CNT + k];
+					out.tangent = FVT3_ZERO;
+					out.weight = 0.0f;
+					out.preserving = preserving;
+					if (area == 0.0f) {
+						continue;
+					}
+
+					FVector3 const n(v[k]->normal);
+					FVector3 const o(v[k]->position);
+					FVector3 const e1 = project(FVector3(v[(k + 1U) % T3_CNT]->position) - o, n);
+					FVector3 const e2 = project(FVector3(v[(k + 2U) % T3_CNT]->position) - o, n);
+					float const angle = cornerAngle(e1, e2);
+					out.tangent = safeNormalize(project(os, n)) * angle;
+					out.weight = angle;
+				}
+			}
+		});
+
+		std::vector<unsigned int> offsets, corners;
+		buildAdjacency(indices, vertices.size(), offsets, corners);
+
+		parallel_for(vertices.size(), MESH_GRAIN, [&](size_t const& begin, size_t const& end) {
+			for (size_t idx = begin; idx < end; ++idx) {
+				//	テクスチャ座標の向きごとに集計し、重みの大きい側を採用する
+				FVector3 sum[2U] = { FVT3_ZERO, FVT3_ZERO };
+				float weight[2U] = { 0.0f, 0.0f };
+				for (unsigned int c = offsets[idx]; c < offsets[idx + 1U]; ++c) {
+					TangentCorner const& corner = contributions[corners[c]];
+					unsigned int const side = corner.preserving ? 0U : 1U;
+					sum[side] += FVector3(corner.tangent);
+					weight[side] += corner.weight;
+				}
+				unsigned int const side = weight[0U] >= weight[1U] ? 0U : 1U;
+
+				FVector3 const n(vertices[idx].normal);
+				FVector3 tangent = safeNormalize(project(sum[side], n));
+				if (tangent == FVT3_ZERO) {
+					//	テクスチャ座標が縮退している場合は法線に直交する任意の向きとする
+					FVector3 const axis = fabsf(n.x) < 0.9f ? FVector3(1.0f, 0.0f, 0.0f) : FVector3(0.0f, 1.0f, 0.0f);
+					tangent = safeNormalize(project(axis, n));
+				}
+				vertices[idx].tangent = Float4(tangent.x, tangent.y, tangent.z, side == 0U ? 1.0f : -1.0f);
+			}
+		});
+	}
+}
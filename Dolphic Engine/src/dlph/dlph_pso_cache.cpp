@@ -0,0 +1,224 @@
+﻿/**	@file	dlph_pso_cache.cpp
+ *	@brief	パイプラインキャッシュ
+ */
+#include "dlph/dlph_pso_cache.hpp"
+#include "util/hash.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+namespace {
+	using namespace dlph;
+
+	/**	@struct	FileHeader
+	 *	@brief	パイプラインキャッシュのファイルのヘッダ
+	 */
+	struct FileHeader final {
+		//!	@brief	識別子
+		unsigned int magic;
+		//!	@brief	版
+		unsigned int version;
+		//!	@brief	データの数
+		unsigned int count;
+		//!	@brief	予約
+		unsigned int reserved;
+		//!	@brief	環境タグ
+		unsigned long long tag;
+	};
+	static_assert(sizeof(FileHeader) == 24U, "Pipeline cache header must be packed.");
+
+	/**	@struct	FileEntry
+	 *	@brief	パイプラインキャッシュのファイルのデータの見出し
+	 */
+	struct FileEntry final {
+		//!	@brief	キー
+		unsigned long long key;
+		//!	@brief	データのバイト数
+		unsigned long long size;
+		//!	@brief	データのハッシュ
+		unsigned long long hash;
+	};
+	static_assert(sizeof(FileEntry) == 24U, "Pipeline cache entry must be packed.");
+}
+
+namespace dlph {
+	PipelineCache::PipelineCache() noexcept :
+		INonmovable(),
+		m_entries(),
+		m_mutex(),
+		m_counter(),
+		m_stats(),
+		m_tag(0ULL)
+	{}
+
+	PipelineCache::~PipelineCache() noexcept {
+		exit();
+	}
+
+	bool const PipelineCache::init(unsigned long long const& tag) noexcept {
+		exit();
+		m_tag = tag;
+		return true;
+	}
+
+	void PipelineCache::exit() noexcept {
+		wait();
+		std::lock_guard<std::mutex> const lock(m_mutex);
+#if	defined(_DEBUG) || defined(DEBUG)
+		for (auto const& pair : m_entries) {
+			_ASSERT_EXPR(pair.second.pipeline == nullptr, L"ERROR : PIPELINE IS NOT RELEASED BEFORE EXIT.");
+		}
+#endif
+		m_entries.clear();
+		m_stats = {};
+		m_tag = 0ULL;
+	}
+
+	bool const PipelineCache::load(char const* const path) noexcept {
+		wait();
+
+		std::ifstream file(path, std::ios::binary);
+		if (!file) {
+			//	初回の起動ではファイルが無いため、エラーにはしない
+			return false;
+		}
+
+		FileHeader header = {};
+		if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+			OutputDebugStringA("ERROR : PIPELINE CACHE FILE IS TRUNCATED.\n");
+			return false;
+		}
+		if (header.magic != PIPELINE_CACHE_MAGIC || header.version != PIPELINE_CACHE_VERSION) {
+			OutputDebugStringA("ERROR : PIPELINE CACHE FILE FORMAT IS NOT SUPPORTED.\n");
+			return false;
+		}
+		if (header.tag != m_tag) {
+			//	ドライバなどが変わったため、保存したデータは使えない
+			return false;
+		}
+
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		std::vector<unsigned char> blob;
+		bool result = true;
+		for (unsigned int idx = 0U; idx < header.count; ++idx) {
+			//	途中で切れている、または大きさが壊れていれば次の見出しの位置が分からないため、そこで止める
+			FileEntry entry = {};
+			if (!file.read(reinterpret_cast<char*>(&entry), sizeof(entry)) || entry.size > PIPELINE_CACHE_BLOB_MAX) {
+				OutputDebugStringA("ERROR : PIPELINE CACHE FILE IS BROKEN.\n");
+				return false;
+			}
+			blob.resize(static_cast<size_t>(entry.size));
+			if (!file.read(reinterpret_cast<char*>(blob.data()), static_cast<std::streamsize>(blob.size()))) {
+				OutputDebugStringA("ERROR : PIPELINE CACHE FILE IS TRUNCATED.\n");
+				return false;
+			}
+			if (hash_bytes(blob.data(), blob.size()) != entry.hash) {
+				//	中身だけが壊れていれば、そのデータを捨てて次へ進む
+				OutputDebugStringA("ERROR : PIPELINE CACHE DATA IS BROKEN.\n");
+				result = false;
+				continue;
+			}
+			Entry& target = m_entries[entry.key];
+			if (target.blob.empty()) {
+				target.blob.swap(blob);
+				++m_stats.loaded;
+			}
+		}
+		return result;
+	}
+
+	bool const PipelineCache::save(char const* const path) noexcept {
+		wait();
+
+		std::string const temp = std::string(path) + ".tmp";
+		{
+			std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+			if (!file) {
+				OutputDebugStringA("ERROR : PIPELINE CACHE FILE CANNOT BE CREATED.\n");
+				return false;
+			}
+
+			std::lock_guard<std::mutex> const lock(m_mutex);
+			FileHeader header = {};
+			header.magic = PIPELINE_CACHE_MAGIC;
+			header.version = PIPELINE_CACHE_VERSION;
+			header.tag = m_tag;
+			for (auto const& pair : m_entries) {
+				header.count += pair.second.blob.empty() ? 0U : 1U;
+			}
+			file.write(reinterpret_cast<char const*>(&header), sizeof(header));
+
+			for (auto const& pair : m_entries) {
+				std::vector<unsigned char> const& blob = pair.second.blob;
+				if (blob.empty()) {
+					continue;
+				}
+				FileEntry const entry = { pair.first, static_cast<unsigned long long>(blob.size()), hash_bytes(blob.data(), blob.size()) };
+				file.write(reinterpret_cast<char const*>(&entry), sizeof(entry));
+				file.write(reinterpret_cast<char const*>(blob.data()), static_cast<std::streamsize>(blob.size()));
+			}
+			if (!file.flush()) {
+				OutputDebugStringA("ERROR : PIPELINE CACHE FILE WRITING FAILED.\n");
+				return false;
+			}
+			m_stats.saved = header.count;
+		}
+
+		//	書き込み途中で落ちても前回のファイルが残るよう、書き終えてから置き換える
+		std::remove(path);
+		if (std::rename(temp.c_str(), path) != 0) {
+			OutputDebugStringA("ERROR : PIPELINE CACHE FILE CANNOT BE REPLACED.\n");
+			return false;
+		}
+		return true;
+	}
+
+	void* const PipelineCache::find(unsigned long long const& key) noexcept {
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		auto const it = m_entries.find(key);
+		if (it == m_entries.end() || it->second.status != PipelineStatus::Ready) {
+			++m_stats.misses;
+			return nullptr;
+		}
+		++m_stats.hits;
+		return it->second.pipeline;
+	}
+
+	PipelineStatus const PipelineCache::status(unsigned long long const& key) const noexcept {
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		auto const it = m_entries.find(key);
+		return it == m_entries.end() ? PipelineStatus::Missing : it->second.status;
+	}
+
+	void PipelineCache::wait() noexcept {
+		JobSystem::getInstance().wait(m_counter);
+	}
+
+	size_t const PipelineCache::size() const noexcept {
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		return m_entries.size();
+	}
+
+	PipelineCacheStats const PipelineCache::stats() const noexcept {
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		return m_stats;
+	}
+
+	void PipelineCache::finish(Entry& entry, void* pipeline, std::vector<unsigned char>& blob, bool const& warm) noexcept {
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		if (pipeline == nullptr) {
+			entry.status = PipelineStatus::Failed;
+			++m_stats.failed;
+			return;
+		}
+		entry.pipeline = pipeline;
+		entry.status = PipelineStatus::Ready;
+		//	ドライバがデータを返さなければ、読み込んだものを残す
+		if (!blob.empty()) {
+			entry.blob.swap(blob);
+		}
+		++m_stats.created;
+		m_stats.warm += warm ? 1ULL : 0ULL;
+	}
+}
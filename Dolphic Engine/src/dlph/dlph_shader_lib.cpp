@@ -0,0 +1,386 @@
+﻿/**	@file	dlph_shader_lib.cpp
+ *	@brief	シェーダライブラリ
+ */
+#include "dlph/dlph_shader_lib.hpp"
+#include "util/hash.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace {
+	using namespace dlph;
+
+	/**	@struct	LibraryHeader
+	 *	@brief	シェーダライブラリのヘッダ
+	 */
+	struct LibraryHeader final {
+		//!	@brief	識別子
+		unsigned int magic;
+		//!	@brief	版
+		unsigned int version;
+		//!	@brief	名前の数
+		unsigned int entryCount;
+		//!	@brief	バイトコードの数
+		unsigned int blobCount;
+		//!	@brief	反映情報の数
+		unsigned int bindingCount;
+		//!	@brief	予約
+		unsigned int reserved;
+		//!	@brief	名前の索引の位置
+		unsigned long long entryOffset;
+		//!	@brief	バイトコードの表の位置
+		unsigned long long blobOffset;
+		//!	@brief	反映情報の位置
+		unsigned long long bindingOffset;
+		//!	@brief	名前の文字列の位置
+		unsigned long long nameOffset;
+		//!	@brief	名前の文字列のバイト数
+		unsigned long long nameSize;
+		//!	@brief	バイトコードの位置
+		unsigned long long dataOffset;
+		//!	@brief	バイトコードのバイト数
+		unsigned long long dataSize;
+	};
+	static_assert(sizeof(LibraryHeader) == 80U, "Shader library header must be packed.");
+
+	/**	@struct	LibraryEntry
+	 *	@brief	シェーダライブラリの名前の索引
+	 */
+	struct LibraryEntry final {
+		//!	@brief	名前のハッシュ
+		unsigned long long hash;
+		//!	@brief	名前の文字列内の位置
+		unsigned int nameOffset;
+		//!	@brief	名前の長さ
+		unsigned int nameLength;
+		//!	@brief	バイトコードの番号
+		unsigned int blob;
+		//!	@brief	予約
+		unsigned int reserved;
+	};
+	static_assert(sizeof(LibraryEntry) == 24U, "Shader library entry must be packed.");
+
+	/**	@struct	LibraryBlob
+	 *	@brief	シェーダライブラリのバイトコードの表
+	 */
+	struct LibraryBlob final {
+		//!	@brief	内容のハッシュ
+		unsigned long long hash;
+		//!	@brief	バイトコード内の位置
+		unsigned long long offset;
+		//!	@brief	バイト数
+		unsigned long long size;
+		//!	@brief	反映情報の先頭
+		unsigned int bindingFirst;
+		//!	@brief	反映情報の数
+		unsigned int bindingCount;
+		//!	@brief	段階
+		ShaderStage stage;
+		//!	@brief	予約
+		unsigned int reserved;
+	};
+	static_assert(sizeof(LibraryBlob) == 40U, "Shader library blob must be packed.");
+
+	//!	@brief	配置境界への切り上げ
+	inline unsigned long long const alignUp(unsigned long long const& value, unsigned long long const& alignment) noexcept {
+		return (value + alignment - 1ULL) & ~(alignment - 1ULL);
+	}
+
+	//!	@brief	ファイル内の範囲の検証
+	inline bool const inRange(unsigned long long const& offset, unsigned long long const& bytes, size_t const& size) noexcept {
+		return offset <= size && bytes <= size - offset;
+	}
+
+	//!	@brief	名前のハッシュ
+	inline unsigned long long const hashName(char const* const name, size_t const& length) noexcept {
+		return hash_bytes(name, length);
+	}
+}
+
+namespace dlph {
+	ShaderLibrary::ShaderLibrary() noexcept :
+		INoncopyable(),
+		m_file(),
+		m_data(nullptr),
+		m_size(0U)
+	{}
+
+	ShaderLibrary::~ShaderLibrary() noexcept {
+		exit();
+	}
+
+	bool const ShaderLibrary::init(char const* const path) noexcept {
+		exit();
+		if (!m_file.init(path)) {
+			return false;
+		}
+		if (!attach(m_file.data(), m_file.size())) {
+			exit();
+			return false;
+		}
+		return true;
+	}
+
+	bool const ShaderLibrary::init(unsigned char const* const data, size_t const& size) noexcept {
+		exit();
+		return attach(data, size);
+	}
+
+	void ShaderLibrary::exit() noexcept {
+		m_file.exit();
+		m_data = nullptr;
+		m_size = 0U;
+	}
+
+	ShaderView const ShaderLibrary::find(char const* const name) const noexcept {
+		if (m_data == nullptr || name == nullptr) {
+			return {};
+		}
+		LibraryHeader const& header = *reinterpret_cast<LibraryHeader const*>(m_data);
+		LibraryEntry const* const entries = reinterpret_cast<LibraryEntry const*>(m_data + header.entryOffset);
+		char const* const names = reinterpret_cast<char const*>(m_data + header.nameOffset);
+
+		size_t const length = std::strlen(name);
+		unsigned long long const hash = hashName(name, length);
+		LibraryEntry const* it = std::lower_bound(entries, entries + header.entryCount, hash, [](LibraryEntry const& entry, unsigned long long const& value) {
+			return entry.hash < value;
+		});
+		//	ハッシュが衝突した名前は隣に並ぶため、文字列を比べて選ぶ
+		for (; it != entries + header.entryCount && it->hash == hash; ++it) {
+			if (it->nameLength == length && std::memcmp(names + it->nameOffset, name, length) == 0) {
+				return view(it->blob);
+			}
+		}
+		return {};
+	}
+
+	ShaderView const ShaderLibrary::find(unsigned long long const& hash) const noexcept {
+		if (m_data == nullptr) {
+			return {};
+		}
+		LibraryHeader const& header = *reinterpret_cast<LibraryHeader const*>(m_data);
+		LibraryBlob const* const blobs = reinterpret_cast<LibraryBlob const*>(m_data + header.blobOffset);
+		LibraryBlob const* const it = std::lower_bound(blobs, blobs + header.blobCount, hash, [](LibraryBlob const& blob, unsigned long long const& value) {
+			return blob.hash < value;
+		});
+		if (it == blobs + header.blobCount || it->hash != hash) {
+			return {};
+		}
+		return view(static_cast<unsigned int>(it - blobs));
+	}
+
+	bool const ShaderLibrary::validate() const noexcept {
+		for (unsigned int idx = 0U; idx < blobCount(); ++idx) {
+			ShaderView const shader = view(idx);
+			if (hash_bytes(shader.data, shader.size) != shader.hash) {
+				OutputDebugStringA("ERROR : SHADER LIBRARY BYTECODE IS BROKEN.\n");
+				return false;
+			}
+		}
+		return true;
+	}
+
+	unsigned int const ShaderLibrary::entryCount() const noexcept {
+		return m_data ? reinterpret_cast<LibraryHeader const*>(m_data)->entryCount : 0U;
+	}
+
+	unsigned int const ShaderLibrary::blobCount() const noexcept {
+		return m_data ? reinterpret_cast<LibraryHeader const*>(m_data)->blobCount : 0U;
+	}
+
+	bool const ShaderLibrary::attach(unsigned char const* const data, size_t const& size) noexcept {
+		if (data == nullptr || size < sizeof(LibraryHeader)) {
+			OutputDebugStringA("ERROR : SHADER LIBRARY IS TRUNCATED.\n");
+			return false;
+		}
+		LibraryHeader const& header = *reinterpret_cast<LibraryHeader const*>(data);
+		if (header.magic != SHADER_LIBRARY_MAGIC || header.version != SHADER_LIBRARY_VERSION) {
+			OutputDebugStringA("ERROR : SHADER LIBRARY FORMAT IS NOT SUPPORTED.\n");
+			return false;
+		}
+		//	索引はここで全て検証し、find では範囲を確かめずに引けるようにする
+		bool valid = inRange(header.entryOffset, header.entryCount * static_cast<unsigned long long>(sizeof(LibraryEntry)), size)
+			&& inRange(header.blobOffset, header.blobCount * static_cast<unsigned long long>(sizeof(LibraryBlob)), size)
+			&& inRange(header.bindingOffset, header.bindingCount * static_cast<unsigned long long>(sizeof(ShaderBinding)), size)
+			&& inRange(header.nameOffset, header.nameSize, size)
+			&& inRange(header.dataOffset, header.dataSize, size)
+			&& header.entryOffset % alignof(LibraryEntry) == 0U
+			&& header.blobOffset % alignof(LibraryBlob) == 0U
+			&& header.bindingOffset % alignof(ShaderBinding) == 0U;
+		if (valid) {
+			LibraryEntry const* const entries = reinterpret_cast<LibraryEntry const*>(data + header.entryOffset);
+			for (unsigned int idx = 0U; valid && idx < header.entryCount; ++idx) {
+				LibraryEntry const& entry = entries[idx];
+				valid = entry.blob < header.blobCount
+					&& inRange(entry.nameOffset, entry.nameLength, static_cast<size_t>(header.nameSize))
+					&& (idx == 0U || entries[idx - 1U].hash <= entry.hash);
+			}
+			LibraryBlob const* const blobs = reinterpret_cast<LibraryBlob const*>(data + header.blobOffset);
+			for (unsigned int idx = 0U; valid && idx < header.blobCount; ++idx) {
+				LibraryBlob const& blob = blobs[idx];
+				valid = inRange(blob.offset, blob.size, static_cast<size_t>(header.dataSize))
+					&& inRange(blob.bindingFirst, blob.bindingCount, header.bindingCount)
+					&& (idx == 0U || blobs[idx - 1U].hash < blob.hash);
+			}
+		}
+		if (!valid) {
+			OutputDebugStringA("ERROR : SHADER LIBRARY INDEX IS BROKEN.\n");
+			return false;
+		}
+		m_data = data;
+		m_size = size;
+		return true;
+	}
+
+	ShaderView const ShaderLibrary::view(unsigned int const& blob) const noexcept {
+		LibraryHeader const& header = *reinterpret_cast<LibraryHeader const*>(m_data);
+		LibraryBlob const& entry = reinterpret_cast<LibraryBlob const*>(m_data + header.blobOffset)[blob];
+		ShaderView result = {};
+		result.data = m_data + header.dataOffset + entry.offset;
+		result.size = static_cast<size_t>(entry.size);
+		result.hash = entry.hash;
+		result.stage = entry.stage;
+		result.bindings = reinterpret_cast<ShaderBinding const*>(m_data + header.bindingOffset) + entry.bindingFirst;
+		result.bindingCount = entry.bindingCount;
+		return result;
+	}
+
+	ShaderLibraryBuilder::ShaderLibraryBuilder() noexcept :
+		m_blobs(),
+		m_entries(),
+		m_lookup(),
+		m_inputBytes(0ULL)
+	{}
+
+	bool const ShaderLibraryBuilder::add(char const* const name, ShaderStage const& stage, void const* const data, size_t const& size, ShaderBinding const* const bindings, unsigned int const& bindingCount) noexcept {
+		if (name == nullptr || data == nullptr || size == 0U) {
+			OutputDebugStringA("ERROR : SHADER LIBRARY INPUT IS EMPTY.\n");
+			return false;
+		}
+		size_t const length = std::strlen(name);
+		unsigned long long const nameHash = hashName(name, length);
+		for (Entry const& entry : m_entries) {
+			if (entry.hash == nameHash && entry.name == name) {
+				OutputDebugStringA("ERROR : SHADER LIBRARY NAME IS DUPLICATED.\n");
+				return false;
+			}
+		}
+
+		unsigned char const* const code = static_cast<unsigned char const*>(data);
+		unsigned long long const hash = hash_bytes(code, size);
+		auto const it = m_lookup.find(hash);
+		unsigned int blob = 0U;
+		if (it != m_lookup.end()) {
+			Blob const& found = m_blobs[it->second];
+			if (found.code.size() != size || std::memcmp(found.code.data(), code, size) != 0) {
+				OutputDebugStringA("ERROR : SHADER LIBRARY HASH COLLISION.\n");
+				return false;
+			}
+			blob = it->second;
+		}
+		else {
+			blob = static_cast<unsigned int>(m_blobs.size());
+			m_blobs.push_back({ hash, stage, std::vector<unsigned char>(code, code + size), std::vector<ShaderBinding>(bindings, bindings + (bindings ? bindingCount : 0U)) });
+			m_lookup.emplace(hash, blob);
+		}
+		m_entries.push_back({ nameHash, name, blob });
+		m_inputBytes += size;
+		return true;
+	}
+
+	void ShaderLibraryBuilder::clear() noexcept {
+		m_blobs.clear();
+		m_entries.clear();
+		m_lookup.clear();
+		m_inputBytes = 0ULL;
+	}
+
+	void ShaderLibraryBuilder::build(std::vector<unsigned char>& out) const noexcept {
+		//	バイトコードの表は内容のハッシュ順に並べ替え、名前の索引の番号を付け替える
+		std::vector<unsigned int> order(m_blobs.size());
+		for (unsigned int idx = 0U; idx < order.size(); ++idx) {
+			order[idx] = idx;
+		}
+		std::sort(order.begin(), order.end(), [this](unsigned int const& lhs, unsigned int const& rhs) {
+			return m_blobs[lhs].hash < m_blobs[rhs].hash;
+		});
+		std::vector<unsigned int> remap(m_blobs.size());
+		for (unsigned int idx = 0U; idx < order.size(); ++idx) {
+			remap[order[idx]] = idx;
+		}
+		std::vector<Entry const*> entries(m_entries.size());
+		for (size_t idx = 0U; idx < entries.size(); ++idx) {
+			entries[idx] = &m_entries[idx];
+		}
+		std::sort(entries.begin(), entries.end(), [](Entry const* lhs, Entry const* rhs) {
+			return lhs->hash != rhs->hash ? lhs->hash < rhs->hash : lhs->name < rhs->name;
+		});
+
+		LibraryHeader header = {};
+		header.magic = SHADER_LIBRARY_MAGIC;
+		header.version = SHADER_LIBRARY_VERSION;
+		header.entryCount = static_cast<unsigned int>(entries.size());
+		header.blobCount = static_cast<unsigned int>(order.size());
+		for (Blob const& blob : m_blobs) {
+			header.bindingCount += static_cast<unsigned int>(blob.bindings.size());
+			header.dataSize = alignUp(header.dataSize, SHADER_LIBRARY_ALIGNMENT) + blob.code.size();
+		}
+		for (Entry const* entry : entries) {
+			header.nameSize += entry->name.size();
+		}
+		header.entryOffset = sizeof(LibraryHeader);
+		header.blobOffset = header.entryOffset + sizeof(LibraryEntry) * header.entryCount;
+		header.bindingOffset = header.blobOffset + sizeof(LibraryBlob) * header.blobCount;
+		header.nameOffset = header.bindingOffset + sizeof(ShaderBinding) * header.bindingCount;
+		header.dataOffset = alignUp(header.nameOffset + header.nameSize, SHADER_LIBRARY_ALIGNMENT);
+
+		out.assign(static_cast<size_t>(header.dataOffset + header.dataSize), 0U);
+		std::memcpy(out.data(), &header, sizeof(header));
+
+		unsigned int nameOffset = 0U;
+		for (unsigned int idx = 0U; idx < header.entryCount; ++idx) {
+			Entry const& src = *entries[idx];
+			LibraryEntry const entry = { src.hash, nameOffset, static_cast<unsigned int>(src.name.size()), remap[src.blob], 0U };
+			std::memcpy(out.data() + header.entryOffset + sizeof(LibraryEntry) * idx, &entry, sizeof(entry));
+			std::memcpy(out.data() + header.nameOffset + nameOffset, src.name.data(), src.name.size());
+			nameOffset += entry.nameLength;
+		}
+
+		unsigned long long dataOffset = 0ULL;
+		unsigned int bindingFirst = 0U;
+		for (unsigned int idx = 0U; idx < header.blobCount; ++idx) {
+			Blob const& src = m_blobs[order[idx]];
+			dataOffset = alignUp(dataOffset, SHADER_LIBRARY_ALIGNMENT);
+			LibraryBlob const blob = { src.hash, dataOffset, src.code.size(), bindingFirst, static_cast<unsigned int>(src.bindings.size()), src.stage, 0U };
+			std::memcpy(out.data() + header.blobOffset + sizeof(LibraryBlob) * idx, &blob, sizeof(blob));
+			if (!src.bindings.empty()) {
+				std::memcpy(out.data() + header.bindingOffset + sizeof(ShaderBinding) * bindingFirst, src.bindings.data(), sizeof(ShaderBinding) * src.bindings.size());
+			}
+			std::memcpy(out.data() + header.dataOffset + dataOffset, src.code.data(), src.code.size());
+			dataOffset += src.code.size();
+			bindingFirst += blob.bindingCount;
+		}
+	}
+
+	bool const ShaderLibraryBuilder::write(char const* const path) const noexcept {
+		std::vector<unsigned char> bytes;
+		build(bytes);
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (!file || !file.write(reinterpret_cast<char const*>(bytes.data()), static_cast<std::streamsize>(bytes.size()))) {
+			OutputDebugStringA("ERROR : SHADER LIBRARY WRITING FAILED.\n");
+			return false;
+		}
+		return true;
+	}
+
+	ShaderLibraryStats const ShaderLibraryBuilder::stats() const noexcept {
+		ShaderLibraryStats result = {};
+		result.entries = static_cast<unsigned int>(m_entries.size());
+		result.blobs = static_cast<unsigned int>(m_blobs.size());
+		result.inputBytes = m_inputBytes;
+		for (Blob const& blob : m_blobs) {
+			result.uniqueBytes += blob.code.size();
+		}
+		return result;
+	}
+}
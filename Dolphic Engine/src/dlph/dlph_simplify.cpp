@@ -0,0 +1,644 @@
+﻿/**	@file	dlph_simplify.cpp
+ *	@brief	Dolphic Engine 用のメッシュ簡略化関数群
+ */
+#include "dlph/dlph_simplify.hpp"
+#include "dlph/dlph_meshproc.hpp"
+#include "dlph/dlph_meshopt.hpp"
+#include "math/fvec3.hpp"
+#include <algorithm>
+#include <cmath>
+#include <unordered_set>
+
+namespace {
+	using namespace dlph;
+
+	//!	@brief	属性の成分数 (法線三成分とテクスチャ座標二成分)
+	static unsigned int constexpr ATTRIBUTE_CNT = 5U;
+	//!	@brief	開いた境界に沿った辺を保つ重み
+	static float constexpr BORDER_WEIGHT = 10.0f;
+	//!	@brief	継ぎ目に沿った辺を保つ重み
+	static float constexpr SEAM_WEIGHT = 1.0f;
+	//!	@brief	境界辺が存在しないことを表す値
+	static unsigned int constexpr EDGE_NONE = ~0U;
+	//!	@brief	境界辺が複数存在することを表す値
+	static unsigned int constexpr EDGE_MULTI = ~0U - 1U;
+
+	/**	@enum	VertexKind
+	 *	@brief	頂点の位相的な種類
+	 */
+	enum class VertexKind : unsigned char {
+		//!	@brief	内部の頂点
+		Manifold,
+		//!	@brief	開いた境界上の頂点
+		Border,
+		//!	@brief	属性の継ぎ目上の頂点
+		Seam,
+		//!	@brief	縮約できない頂点
+		Locked
+	};
+
+	/**	@struct	Quadric
+	 *	@brief	二次誤差計量 (対称行列 A、ベクトル b、定数 c、重み w)
+	 */
+	struct Quadric final {
+		float a00, a11, a22, a10, a20, a21;
+		float b0, b1, b2;
+		float c;
+		float w;
+	};
+
+	/**	@struct	AttributeQuadric
+	 *	@brief	属性付き二次誤差計量
+	 *	@details	属性値を三角形上の一次関数 g・p + d とみなし、各成分の勾配の和を保持します。
+	 */
+	struct AttributeQuadric final {
+		//!	@brief	勾配の外積などを畳み込んだ二次誤差
+		Quadric quadric;
+		//!	@brief	重み付き勾配の和
+		float gradient[ATTRIBUTE_CNT][T3_CNT];
+		//!	@brief	重み付き定数項の和
+		float offset[ATTRIBUTE_CNT];
+	};
+
+	/**	@struct	Collapse
+	 *	@brief	辺の縮約候補
+	 */
+	struct Collapse final {
+		//!	@brief	移動元の頂点
+		unsigned int from;
+		//!	@brief	移動先の頂点
+		unsigned int to;
+		//!	@brief	属性を含む誤差
+		float error;
+		//!	@brief	位置の誤差 (正規化した距離の二乗)
+		float distance;
+	};
+
+	//!	@brief	二次誤差加算関数
+	void accumulate(Quadric& dst, Quadric const& src) noexcept {
+		dst.a00 += src.a00; dst.a11 += src.a11; dst.a22 += src.a22;
+		dst.a10 += src.a10; dst.a20 += src.a20; dst.a21 += src.a21;
+		dst.b0 += src.b0; dst.b1 += src.b1; dst.b2 += src.b2;
+		dst.c += src.c;
+		dst.w += src.w;
+	}
+
+	//!	@brief	属性付き二次誤差加算関数
+	void accumulate(AttributeQuadric& dst, AttributeQuadric const& src) noexcept {
+		accumulate(dst.quadric, src.quadric);
+		for (unsigned int k = 0U; k < ATTRIBUTE_CNT; ++k) {
+			for (unsigned int e = 0U; e < T3_CNT; ++e) {
+				dst.gradient[k][e] += src.gradient[k][e];
+			}
+			dst.offset[k] += src.offset[k];
+		}
+	}
+
+	//!	@brief	平面 n・p + d = 0 からの二次誤差生成関数
+	Quadric const planeQuadric(FVector3 const& n, float const& d, float const& w) noexcept {
+		Quadric result = {};
+		result.a00 = w * n.x * n.x; result.a11 = w * n.y * n.y; result.a22 = w * n.z * n.z;
+		result.a10 = w * n.y * n.x; result.a20 = w * n.z * n.x; result.a21 = w * n.z * n.y;
+		result.b0 = w * n.x * d; result.b1 = w * n.y * d; result.b2 = w * n.z * d;
+		result.c = w * d * d;
+		result.w = w;
+		return result;
+	}
+
+	//!	@brief	正規化前の二次誤差評価関数
+	float const evaluate(Quadric const& q, Float3 const& p) noexcept {
+		float const rx = q.b0 + q.a00 * p.x + q.a10 * p.y + q.a20 * p.z;
+		float const ry = q.b1 + q.a10 * p.x + q.a11 * p.y + q.a21 * p.z;
+		float const rz = q.b2 + q.a20 * p.x + q.a21 * p.y + q.a22 * p.z;
+		return rx * p.x + ry * p.y + rz * p.z + q.b0 * p.x + q.b1 * p.y + q.b2 * p.z + q.c;
+	}
+
+	//!	@brief	位置の二次誤差取得関数
+	float const positionError(Quadric const& q, Float3 const& p) noexcept {
+		return q.w > 0.0f ? fmaxf(evaluate(q, p) / q.w, 0.0f) : 0.0f;
+	}
+
+	//!	@brief	属性の二次誤差取得関数
+	float const attributeError(AttributeQuadric const& q, Float3 const& p, float const (&value)[ATTRIBUTE_CNT]) noexcept {
+		if (q.quadric.w <= 0.0f) {
+			return 0.0f;
+		}
+		float result = evaluate(q.quadric, p);
+		for (unsigned int k = 0U; k < ATTRIBUTE_CNT; ++k) {
+			float const g = q.gradient[k][0U] * p.x + q.gradient[k][1U] * p.y + q.gradient[k][2U] * p.z + q.offset[k];
+			result += value[k] * (value[k] * q.quadric.w - 2.0f * g);
+		}
+		return fmaxf(result / q.quadric.w, 0.0f);
+	}
+
+	//!	@brief	有向辺のキー取得関数
+	unsigned long long const edgeKey(unsigned int const& from, unsigned int const& to) noexcept {
+		return (static_cast<unsigned long long>(from) << 32U) | to;
+	}
+
+	//!	@brief	境界辺登録関数
+	void link(std::vector<unsigned int>& table, unsigned int const& from, unsigned int const& to) noexcept {
+		table[from] = table[from] == EDGE_NONE ? to : EDGE_MULTI;
+	}
+
+	/**	@class	Simplifier
+	 *	@brief	二次誤差計量による簡略化処理クラス
+	 */
+	class Simplifier final {
+	public	:
+		//!	@brief	コンストラクタ
+		Simplifier(std::vector<MeshVertex> const& vertices, std::vector<unsigned int> const& indices, SimplifyOption const& option) noexcept;
+
+		/**	@brief	簡略化関数
+		 *	@param[out] dst 簡略化後のインデックス配列
+		 *	@param[in] target_index_count 目標インデックス数
+		 *	@return	誤差 (物体空間の距離)
+		 */
+		float const run(std::vector<unsigned int>& dst, size_t const& target_index_count) noexcept;
+
+	private	:
+		//!	@brief	頂点分類関数
+		void classify() noexcept;
+		//!	@brief	二次誤差構築関数
+		void buildQuadrics() noexcept;
+		//!	@brief	縮約先の継ぎ目の対となる頂点取得関数
+		unsigned int const sibling(unsigned int const& from, unsigned int const& to) const noexcept;
+		//!	@brief	縮約可否判定関数
+		bool const collapsible(unsigned int const& from, unsigned int const& to) const noexcept;
+		//!	@brief	縮約誤差取得関数
+		float const cost(unsigned int const& from, unsigned int const& to) const noexcept;
+		//!	@brief	面の反転判定関数
+		bool const flips(unsigned int const& from, unsigned int const& to) const noexcept;
+
+		//!	@brief	頂点配列
+		std::vector<MeshVertex> const& m_vertices;
+		//!	@brief	作業用インデックス配列
+		std::vector<unsigned int> m_indices;
+		//!	@brief	簡略化設定
+		SimplifyOption m_option;
+		//!	@brief	正規化した座標
+		std::vector<Float3> m_positions;
+		//!	@brief	重み付けした属性値
+		std::vector<float> m_attributes;
+		//!	@brief	座標代表頂点
+		std::vector<unsigned int> m_remap;
+		//!	@brief	同じ座標の次の頂点 (環状)
+		std::vector<unsigned int> m_wedge;
+		//!	@brief	出て行く境界辺の先
+		std::vector<unsigned int> m_loop;
+		//!	@brief	入って来る境界辺の元
+		std::vector<unsigned int> m_loopback;
+		//!	@brief	出て行く境界辺が座標でも開いているかどうか
+		std::vector<bool> m_border;
+		//!	@brief	座標ごとの頂点の種類
+		std::vector<VertexKind> m_kinds;
+		//!	@brief	座標ごとの二次誤差
+		std::vector<Quadric> m_quadrics;
+		//!	@brief	頂点ごとの属性付き二次誤差
+		std::vector<AttributeQuadric> m_attributeQuadrics;
+		//!	@brief	座標ごとの隣接三角形の開始位置
+		std::vector<unsigned int> m_offsets;
+		//!	@brief	座標ごとの隣接三角形
+		std::vector<unsigned int> m_adjacency;
+		//!	@brief	座標の正規化に用いた拡大率
+		float m_scale;
+		//!	@brief	属性を評価するかどうか
+		bool m_useAttributes;
+	};
+
+	Simplifier::Simplifier(std::vector<MeshVertex> const& vertices, std::vector<unsigned int> const& indices, SimplifyOption const& option) noexcept :
+		m_vertices(vertices),
+		m_indices(indices.begin(), indices.begin() + indices.size() / T3_CNT * T3_CNT),
+		m_option(option),
+		m_positions(vertices.size()),
+		m_attributes(vertices.size() * ATTRIBUTE_CNT),
+		m_remap(),
+		m_wedge(vertices.size()),
+		m_loop(vertices.size(), EDGE_NONE),
+		m_loopback(vertices.size(), EDGE_NONE),
+		m_border(vertices.size(), false),
+		m_kinds(vertices.size(), VertexKind::Locked),
+		m_quadrics(vertices.size(), Quadric()),
+		m_attributeQuadrics(vertices.size(), AttributeQuadric()),
+		m_offsets(),
+		m_adjacency(),
+		m_scale(1.0f),
+		m_useAttributes(option.normalWeight > 0.0f || option.texcoordWeight > 0.0f)
+	{
+		//	誤差が形状の大きさに依存しないよう、座標を単位立方体へ正規化する
+		Float3 lower(FLT_MAX, FLT_MAX, FLT_MAX), upper(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+		for (MeshVertex const& vertex : vertices) {
+			for (unsigned int e = 0U; e < T3_CNT; ++e) {
+				lower.p[e] = fminf(lower.p[e], vertex.position.p[e]);
+				upper.p[e] = fmaxf(upper.p[e], vertex.position.p[e]);
+			}
+		}
+		float extent = 0.0f;
+		for (unsigned int e = 0U; e < T3_CNT; ++e) {
+			extent = fmaxf(extent, upper.p[e] - lower.p[e]);
+		}
+		m_scale = extent > 0.0f ? extent : 1.0f;
+
+		for (size_t idx = 0U; idx < vertices.size(); ++idx) {
+			MeshVertex const& vertex = vertices[idx];
+			for (unsigned int e = 0U; e < T3_CNT; ++e) {
+				m_positions[idx].p[e] = (vertex.position.p[e] - lower.p[e]) / m_scale;
+			}
+			float* attribute = &m_attributes[idx * ATTRIBUTE_CNT];
+			attribute[0U] = vertex.normal.x * m_option.normalWeight;
+			attribute[1U] = vertex.normal.y * m_option.normalWeight;
+			attribute[2U] = vertex.normal.z * m_option.normalWeight;
+			attribute[3U] = vertex.texcoord.x * m_option.texcoordWeight;
+			attribute[4U] = vertex.texcoord.y * m_option.texcoordWeight;
+		}
+
+		generatePositionRemap(vertices, m_remap);
+		std::vector<unsigned int> last(vertices.size(), EDGE_NONE);
+		for (unsigned int idx = 0U; idx < vertices.size(); ++idx) {
+			unsigned int const root = m_remap[idx];
+			if (root == idx) {
+				m_wedge[idx] = idx;
+				last[idx] = idx;
+			}
+			else {
+				m_wedge[idx] = m_wedge[last[root]];
+				m_wedge[last[root]] = idx;
+				last[root] = idx;
+			}
+		}
+
+		classify();
+		buildQuadrics();
+	}
+
+	void Simplifier::classify() noexcept {
+		std::unordered_set<unsigned long long> edges, positionEdges;
+		edges.reserve(m_indices.size());
+		positionEdges.reserve(m_indices.size());
+		for (size_t idx = 0U; idx < m_indices.size(); idx += T3_CNT) {
+			for (unsigned int k = 0U; k < T3_CNT; ++k) {
+				unsigned int const a = m_indices[idx + k], b = m_indices[idx + (k + 1U) % T3_CNT];
+				edges.insert(edgeKey(a, b));
+				positionEdges.insert(edgeKey(m_remap[a], m_remap[b]));
+			}
+		}
+
+		//	逆向きの辺を持たない辺を境界辺として記録する
+		std::vector<bool> open(m_vertices.size(), false);
+		for (size_t idx = 0U; idx < m_indices.size(); idx += T3_CNT) {
+			for (unsigned int k = 0U; k < T3_CNT; ++k) {
+				unsigned int const a = m_indices[idx + k], b = m_indices[idx + (k + 1U) % T3_CNT];
+				if (edges.count(edgeKey(b, a)) == 0U) {
+					link(m_loop, a, b);
+					link(m_loopback, b, a);
+					if (positionEdges.count(edgeKey(m_remap[b], m_remap[a])) == 0U) {
+						m_border[a] = true;
+						open[a] = true;
+						open[b] = true;
+					}
+				}
+			}
+		}
+
+		auto const single = [](unsigned int const& edge) {
+			return edge != EDGE_NONE && edge != EDGE_MULTI;
+		};
+		for (unsigned int idx = 0U; idx < m_vertices.size(); ++idx) {
+			if (m_remap[idx] != idx) {
+				continue;
+			}
+			unsigned int const other = m_wedge[idx];
+			VertexKind kind = VertexKind::Locked;
+			if (other == idx) {
+				//	属性の継ぎ目に接するだけの頂点は、同じ三角形内の頂点へ縮約する限り内部と同様に扱える
+				if (!open[idx]) {
+					kind = VertexKind::Manifold;
+				}
+				else if (single(m_loop[idx]) && single(m_loopback[idx])) {
+					kind = m_option.lockBorder ? VertexKind::Locked : VertexKind::Border;
+				}
+			}
+			else if (m_wedge[other] == idx) {
+				bool const seam = single(m_loop[idx]) && single(m_loopback[idx]) && single(m_loop[other]) && single(m_loopback[other]);
+				if (seam && !open[idx] && !open[other]) {
+					kind = VertexKind::Seam;
+				}
+			}
+			m_kinds[idx] = kind;
+		}
+	}
+
+	void Simplifier::buildQuadrics() noexcept {
+		for (size_t idx = 0U; idx < m_indices.size(); idx += T3_CNT) {
+			unsigned int const v[T3_CNT] = { m_indices[idx], m_indices[idx + 1U], m_indices[idx + 2U] };
+			FVector3 const p[T3_CNT] = { m_positions[v[0U]], m_positions[v[1U]], m_positions[v[2U]] };
+			FVector3 const e1 = p[1U] - p[0U], e2 = p[2U] - p[0U];
+			FVector3 const n = cross(e1, e2);
+			float const length = sqrtf(sqr_magnitude(n));
+			if (length <= 0.0f) {
+				continue;
+			}
+			FVector3 const unit = n / length;
+			float const area = length * 0.5f;
+
+			Quadric const plane = planeQuadric(unit, -dot(unit, p[0U]), area);
+			for (unsigned int k = 0U; k < T3_CNT; ++k) {
+				accumulate(m_quadrics[m_remap[v[k]]], plane);
+			}
+
+			//	境界と継ぎ目の辺は、面に垂直な平面の誤差を加えて形を保つ
+			for (unsigned int k = 0U; k < T3_CNT; ++k) {
+				unsigned int const a = v[k], b = v[(k + 1U) % T3_CNT];
+				if (m_loop[a] != b) {
+					continue;
+				}
+				FVector3 const edge = p[(k + 1U) % T3_CNT] - p[k];
+				float const edgeLength = sqrtf(sqr_magnitude(edge));
+				if (edgeLength <= 0.0f) {
+					continue;
+				}
+				FVector3 const side = normalize(cross(edge, unit));
+				Quadric const guard = planeQuadric(side, -dot(side, p[k]), edgeLength * (m_border[a] ? BORDER_WEIGHT : SEAM_WEIGHT));
+				accumulate(m_quadrics[m_remap[a]], guard);
+				accumulate(m_quadrics[m_remap[b]], guard);
+			}
+
+			if (!m_useAttributes) {
+				continue;
+			}
+
+			//	属性値を面上の一次関数とみなした勾配 g = ((a1 - a0)(e2 × n) + (a2 - a0)(n × e1)) / |n|^2
+			FVector3 const u1 = cross(e2, n) / (length * length);
+			FVector3 const u2 = cross(n, e1) / (length * length);
+			AttributeQuadric q = {};
+			for (unsigned int k = 0U; k < ATTRIBUTE_CNT; ++k) {
+				float const a0 = m_attributes[v[0U] * ATTRIBUTE_CNT + k];
+				float const a1 = m_attributes[v[1U] * ATTRIBUTE_CNT + k];
+				float const a2 = m_attributes[v[2U] * ATTRIBUTE_CNT + k];
+				FVector3 const g = u1 * (a1 - a0) + u2 * (a2 - a0);
+				float const d = a0 - dot(g, p[0U]);
+
+				q.quadric.a00 += area * g.x * g.x; q.quadric.a11 += area * g.y * g.y; q.quadric.a22 += area * g.z * g.z;
+				q.quadric.a10 += area * g.y * g.x; q.quadric.a20 += area * g.z * g.x; q.quadric.a21 += area * g.z * g.y;
+				q.quadric.b0 += area * g.x * d; q.quadric.b1 += area * g.y * d; q.quadric.b2 += area * g.z * d;
+				q.quadric.c += area * d * d;
+				q.gradient[k][0U] = area * g.x;
+				q.gradient[k][1U] = area * g.y;
+				q.gradient[k][2U] = area * g.z;
+				q.offset[k] = area * d;
+			}
+			q.quadric.w = area;
+			for (unsigned int k = 0U; k < T3_CNT; ++k) {
+				accumulate(m_attributeQuadrics[v[k]], q);
+			}
+		}
+	}
+
+	unsigned int const Simplifier::sibling(unsigned int const& from, unsigned int const& to) const noexcept {
+		unsigned int const other = m_wedge[from];
+		unsigned int const candidates[2U] = { m_loop[other], m_loopback[other] };
+		for (unsigned int const& candidate : candidates) {
+			if (candidate < m_vertices.size() && m_remap[candidate] == m_remap[to]) {
+				return candidate;
+			}
+		}
+		return EDGE_NONE;
+	}
+
+	bool const Simplifier::collapsible(unsigned int const& from, unsigned int const& to) const noexcept {
+		unsigned int const root = m_remap[from];
+		if (root == m_remap[to]) {
+			return false;
+		}
+		VertexKind const target = m_kinds[m_remap[to]];
+		switch (m_kinds[root]) {
+		case VertexKind::Manifold:
+			return true;
+		case VertexKind::Border:
+			return (target == VertexKind::Border || target == VertexKind::Locked) && (m_loop[from] == to || m_loopback[from] == to);
+		case VertexKind::Seam:
+			return (target == VertexKind::Seam || target == VertexKind::Locked) && (m_loop[from] == to || m_loopback[from] == to) && sibling(from, to) != EDGE_NONE;
+		default:
+			return false;
+		}
+	}
+
+	float const Simplifier::cost(unsigned int const& from, unsigned int const& to) const noexcept {
+		Float3 const& target = m_positions[to];
+		float result = positionError(m_quadrics[m_remap[from]], target);
+		if (!m_useAttributes) {
+			return result;
+		}
+
+		auto const attribute = [&](unsigned int const& src, unsigned int const& dst) {
+			float value[ATTRIBUTE_CNT];
+			for (unsigned int k = 0U; k < ATTRIBUTE_CNT; ++k) {
+				value[k] = m_attributes[dst * ATTRIBUTE_CNT + k];
+			}
+			return attributeError(m_attributeQuadrics[src], target, value);
+		};
+		result += attribute(from, to);
+		if (m_kinds[m_remap[from]] == VertexKind::Seam) {
+			result += attribute(m_wedge[from], sibling(from, to));
+		}
+		return result;
+	}
+
+	bool const Simplifier::flips(unsigned int const& from, unsigned int const& to) const noexcept {
+		unsigned int const root = m_remap[from], goal = m_remap[to];
+		FVector3 const moved(m_positions[goal]);
+		for (unsigned int a = m_offsets[root]; a < m_offsets[root + 1U]; ++a) {
+			unsigned int const* tri = &m_indices[m_adjacency[a] * T3_CNT];
+			unsigned int const r[T3_CNT] = { m_remap[tri[0U]], m_remap[tri[1U]], m_remap[tri[2U]] };
+			if (r[0U] == goal || r[1U] == goal || r[2U] == goal) {
+				continue;
+			}
+			FVector3 before[T3_CNT], after[T3_CNT];
+			for (unsigned int k = 0U; k < T3_CNT; ++k) {
+				before[k] = m_positions[r[k]];
+				after[k] = r[k] == root ? moved : before[k];
+			}
+			FVector3 const nb = cross(before[1U] - before[0U], before[2U] - before[0U]);
+			FVector3 const na = cross(after[1U] - after[0U], after[2U] - after[0U]);
+			if (dot(nb, na) <= 0.0f) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	float const Simplifier::run(std::vector<unsigned int>& dst, size_t const& target_index_count) noexcept {
+		float const limit = m_option.maxError < FLT_MAX ? (m_option.maxError / m_scale) * (m_option.maxError / m_scale) : FLT_MAX;
+		float worst = 0.0f;
+
+		std::vector<unsigned int> redirect(m_vertices.size());
+		std::vector<bool> locked(m_vertices.size());
+		std::vector<Collapse> best(m_vertices.size());
+		std::vector<Collapse> candidates;
+
+		while (m_indices.size() > target_index_count) {
+			size_t const triangles = m_indices.size() / T3_CNT;
+
+			//	座標ごとの隣接三角形
+			m_offsets.assign(m_vertices.size() + 1U, 0U);
+			for (unsigned int const& index : m_indices) {
+				++m_offsets[m_remap[index] + 1U];
+			}
+			for (size_t idx = 0U; idx < m_vertices.size(); ++idx) {
+				m_offsets[idx + 1U] += m_offsets[idx];
+			}
+			m_adjacency.resize(m_indices.size());
+			std::vector<unsigned int> cursor(m_offsets.begin(), m_offsets.end() - 1);
+			for (size_t idx = 0U; idx < m_indices.size(); ++idx) {
+				m_adjacency[cursor[m_remap[m_indices[idx]]]++] = static_cast<unsigned int>(idx / T3_CNT);
+			}
+
+			//	座標ごとに最も誤差の小さい縮約を候補とする
+			std::fill(best.begin(), best.end(), Collapse{ EDGE_NONE, EDGE_NONE, FLT_MAX, FLT_MAX });
+			for (size_t idx = 0U; idx < m_indices.size(); idx += T3_CNT) {
+				for (unsigned int k = 0U; k < T3_CNT; ++k) {
+					unsigned int const a = m_indices[idx + k], b = m_indices[idx + (k + 1U) % T3_CNT];
+					unsigned int const pair[2U][2U] = { { a, b }, { b, a } };
+					for (auto const& edge : pair) {
+						if (!collapsible(edge[0U], edge[1U])) {
+							continue;
+						}
+						float const error = cost(edge[0U], edge[1U]);
+						Collapse& slot = best[m_remap[edge[0U]]];
+						if (error < slot.error) {
+							slot = Collapse{ edge[0U], edge[1U], error, positionError(m_quadrics[m_remap[edge[0U]]], m_positions[edge[1U]]) };
+						}
+					}
+				}
+			}
+			candidates.clear();
+			for (Collapse const& collapse : best) {
+				if (collapse.from != EDGE_NONE && collapse.distance <= limit) {
+					candidates.push_back(collapse);
+				}
+			}
+			if (candidates.empty()) {
+				break;
+			}
+			std::sort(candidates.begin(), candidates.end(), [](Collapse const& lhs, Collapse const& rhs) {
+				return lhs.error < rhs.error;
+			});
+
+			//	誤差の小さい順に、一回の走査で互いに干渉しない縮約を適用する
+			for (unsigned int idx = 0U; idx < redirect.size(); ++idx) {
+				redirect[idx] = idx;
+			}
+			std::fill(locked.begin(), locked.end(), false);
+			size_t const goal = (triangles - target_index_count / T3_CNT);
+			size_t removed = 0U;
+			size_t applied = 0U;
+			for (Collapse const& collapse : candidates) {
+				unsigned int const root = m_remap[collapse.from], goalRoot = m_remap[collapse.to];
+				if (locked[root] || locked[goalRoot] || flips(collapse.from, collapse.to)) {
+					continue;
+				}
+
+				//	一周近傍を固定し、同じ走査で古い隣接情報を参照しないようにする
+				for (unsigned int a = m_offsets[root]; a < m_offsets[root + 1U]; ++a) {
+					unsigned int const* tri = &m_indices[m_adjacency[a] * T3_CNT];
+					for (unsigned int k = 0U; k < T3_CNT; ++k) {
+						locked[m_remap[tri[k]]] = true;
+					}
+				}
+				locked[root] = true;
+				locked[goalRoot] = true;
+
+				redirect[collapse.from] = collapse.to;
+				accumulate(m_quadrics[goalRoot], m_quadrics[root]);
+				accumulate(m_attributeQuadrics[collapse.to], m_attributeQuadrics[collapse.from]);
+				if (m_kinds[root] == VertexKind::Seam) {
+					unsigned int const from = m_wedge[collapse.from], to = sibling(collapse.from, collapse.to);
+					redirect[from] = to;
+					accumulate(m_attributeQuadrics[to], m_attributeQuadrics[from]);
+				}
+
+				worst = fmaxf(worst, collapse.distance);
+				removed += m_kinds[root] == VertexKind::Manifold ? 2U : 1U;
+				++applied;
+				if (removed >= goal) {
+					break;
+				}
+			}
+			if (applied == 0U) {
+				break;
+			}
+
+			//	インデックスを付け替え、縮退した三角形を取り除く
+			size_t write = 0U;
+			for (size_t idx = 0U; idx < m_indices.size(); idx += T3_CNT) {
+				unsigned int const a = redirect[m_indices[idx]], b = redirect[m_indices[idx + 1U]], c = redirect[m_indices[idx + 2U]];
+				if (m_remap[a] == m_remap[b] || m_remap[b] == m_remap[c] || m_remap[c] == m_remap[a]) {
+					continue;
+				}
+				m_indices[write++] = a;
+				m_indices[write++] = b;
+				m_indices[write++] = c;
+			}
+			m_indices.resize(write);
+		}
+
+		dst = m_indices;
+		return sqrtf(worst) * m_scale;
+	}
+}
+
+namespace dlph {
+	float const simplifyMesh(std::vector<unsigned int>& dst, std::vector<MeshVertex> const& vertices, std::vector<unsigned int> const& indices, size_t const& target_index_count, SimplifyOption const& option) noexcept {
+		if (vertices.empty() || indices.size() < T3_CNT) {
+			dst = indices;
+			return 0.0f;
+		}
+		Simplifier simplifier(vertices, indices, option);
+		return simplifier.run(dst, target_index_count);
+	}
+
+	bool const generateLods(Mesh& mesh, unsigned int const& max_lod_count, float const& ratio, SimplifyOption const& option) noexcept {
+		if (mesh.vertices.empty() || mesh.indices.size() < T3_CNT) {
+			return false;
+		}
+
+		//	境界球 (軸並行境界箱の中心と最遠点)
+		Float3 lower(FLT_MAX, FLT_MAX, FLT_MAX), upper(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+		for (MeshVertex const& vertex : mesh.vertices) {
+			for (unsigned int e = 0U; e < T3_CNT; ++e) {
+				lower.p[e] = fminf(lower.p[e], vertex.position.p[e]);
+				upper.p[e] = fmaxf(upper.p[e], vertex.position.p[e]);
+			}
+		}
+		FVector3 const center = (FVector3(lower) + FVector3(upper)) * 0.5f;
+		float radius = 0.0f;
+		for (MeshVertex const& vertex : mesh.vertices) {
+			radius = fmaxf(radius, sqr_magnitude(FVector3(vertex.position) - center));
+		}
+		mesh.center = center;
+		mesh.radius = sqrtf(radius);
+
+		std::vector<unsigned int> current(mesh.indices.begin(), mesh.indices.begin() + mesh.indices.size() / T3_CNT * T3_CNT);
+		optimizeVertexCache(current, mesh.vertices.size());
+		mesh.indices = current;
+		mesh.lods.clear();
+		mesh.lods.push_back(MeshLod{ 0U, static_cast<unsigned int>(current.size()), 0.0f });
+
+		float error = 0.0f;
+		std::vector<unsigned int> next;
+		while (mesh.lods.size() < max_lod_count) {
+			size_t const target = static_cast<size_t>(static_cast<float>(current.size() / T3_CNT) * ratio) * T3_CNT;
+			error += simplifyMesh(next, mesh.vertices, current, target, option);
+
+			//	ほとんど減らなくなったら打ち切る
+			if (next.empty() || next.size() * 20U > current.size() * 19U || error > option.maxError) {
+				break;
+			}
+			optimizeVertexCache(next, mesh.vertices.size());
+			mesh.lods.push_back(MeshLod{ static_cast<unsigned int>(mesh.indices.size()), static_cast<unsigned int>(next.size()), error });
+			mesh.indices.insert(mesh.indices.end(), next.begin(), next.end());
+			current.swap(next);
+		}
+		return true;
+	}
+}
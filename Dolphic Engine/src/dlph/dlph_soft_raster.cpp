@@ -0,0 +1,784 @@
+﻿/**	@file	dlph_soft_raster.cpp
+ *	@brief	CPU で動くラスタライザ
+ */
+#include "dlph/dlph_soft_raster.hpp"
+#include "util/parallel.hpp"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <fstream>
+
+#if defined(_M_IX86) || defined(_M_X64)
+#	include <emmintrin.h>
+#	define	DLPH_RASTER_SSE
+#endif
+
+namespace {
+	using namespace dlph;
+
+	//!	@brief	タイルのピクセル数
+	static unsigned int constexpr TILE_PIXELS = RASTER_TILE_SIZE * RASTER_TILE_SIZE;
+	//!	@brief	ビンの一辺のタイル数
+	static unsigned int constexpr BIN_TILES = RASTER_BIN_SIZE / RASTER_TILE_SIZE;
+	//!	@brief	1 ピクセルあたりの固定小数点の値
+	static long long constexpr SUBPIXEL = 1LL << RASTER_SUBPIXEL_BITS;
+	//!	@brief	ガードバンド (NDC で画面の何倍まで固定小数点で扱うか)
+	static float constexpr GUARD_BAND = 4.0f;
+	//!	@brief	w の下限
+	static float constexpr W_EPSILON = 1.0e-6f;
+	//!	@brief	クリッピング平面の数 (近、遠、左右上下のガードバンド、w)
+	static unsigned int constexpr CLIP_PLANE_CNT = 7U;
+	//!	@brief	クリッピング後の頂点数の上限
+	static unsigned int constexpr CLIP_VERTEX_MAX = 3U + CLIP_PLANE_CNT;
+	//!	@brief	一つのジョブでセットアップする三角形の数
+	static size_t constexpr SETUP_GRAIN = 1024U;
+	//!	@brief	一つのジョブで変換する頂点の数
+	static size_t constexpr TRANSFORM_GRAIN = 4096U;
+	//!	@brief	シェーディング関数が無いことを表す番号
+	static unsigned int constexpr SHADER_NONE = ~0U;
+
+	static_assert(RASTER_BIN_SIZE % RASTER_TILE_SIZE == 0U, "Bin size must be a multiple of the tile size.");
+	static_assert(RASTER_SPLIT_MAX + 2U >= CLIP_VERTEX_MAX, "Split limit is too small for the clipping planes.");
+
+	/**	@struct	ClipVertex
+	 *	@brief	クリッピング中の頂点
+	 */
+	struct ClipVertex final {
+		//!	@brief	クリップ空間の座標
+		float p[4];
+		//!	@brief	元の三角形での頂点 1 の重み
+		float b1;
+		//!	@brief	元の三角形での頂点 2 の重み
+		float b2;
+	};
+
+	//!	@brief	クリッピング平面までの距離 (負なら外側)
+	float const plane_distance(ClipVertex const& vertex, unsigned int const& plane) noexcept {
+		float const x = vertex.p[0];
+		float const y = vertex.p[1];
+		float const z = vertex.p[2];
+		float const w = vertex.p[3];
+		switch (plane) {
+		case 0U:
+			return z;
+		case 1U:
+			return w - z;
+		case 2U:
+			return GUARD_BAND * w + x;
+		case 3U:
+			return GUARD_BAND * w - x;
+		case 4U:
+			return GUARD_BAND * w + y;
+		case 5U:
+			return GUARD_BAND * w - y;
+		default:
+			return w - W_EPSILON;
+		}
+	}
+
+	//!	@brief	外側にある平面のビット
+	unsigned int const outcode(ClipVertex const& vertex) noexcept {
+		unsigned int code = 0U;
+		for (unsigned int plane = 0U; plane < CLIP_PLANE_CNT; ++plane) {
+			code |= plane_distance(vertex, plane) < 0.0f ? 1U << plane : 0U;
+		}
+		return code;
+	}
+
+	/**	@brief	多角形のクリッピング関数 (Sutherland-Hodgman)
+	 *	@param[in,out] poly 多角形
+	 *	@param[in] count 頂点数
+	 *	@param[in] planes 外側に出る頂点のある平面のビット
+	 *	@return クリッピング後の頂点数
+	 */
+	unsigned int const clip_polygon(ClipVertex (&poly)[CLIP_VERTEX_MAX], unsigned int count, unsigned int const& planes) noexcept {
+		ClipVertex temp[CLIP_VERTEX_MAX];
+		for (unsigned int plane = 0U; plane < CLIP_PLANE_CNT && count >= 3U; ++plane) {
+			if ((planes & (1U << plane)) == 0U) {
+				continue;
+			}
+
+			unsigned int out = 0U;
+			for (unsigned int idx = 0U; idx < count; ++idx) {
+				ClipVertex const& cur = poly[idx];
+				ClipVertex const& next = poly[(idx + 1U) % count];
+				float const dc = plane_distance(cur, plane);
+				float const dn = plane_distance(next, plane);
+				if (dc >= 0.0f) {
+					temp[out++] = cur;
+				}
+				if ((dc >= 0.0f) != (dn >= 0.0f)) {
+					float const t = dc / (dc - dn);
+					ClipVertex& mid = temp[out++];
+					for (unsigned int elem = 0U; elem < 4U; ++elem) {
+						mid.p[elem] = cur.p[elem] + (next.p[elem] - cur.p[elem]) * t;
+					}
+					mid.b1 = cur.b1 + (next.b1 - cur.b1) * t;
+					mid.b2 = cur.b2 + (next.b2 - cur.b2) * t;
+				}
+			}
+			std::copy(temp, temp + out, poly);
+			count = out;
+		}
+		return count;
+	}
+
+	/**	@brief	頂点の変換関数 (行ベクトルに右から行列を掛けます)
+	 *	@details	FVector4 と FMatrix4x4 の積は誤差補正付きの総和で一頂点ずつ求めるため、行を直接足し合わせます。
+	 */
+	void transform_points(FVector4 const* src, FVector4* dst, size_t const& count, FMatrix4x4 const& mtx) noexcept {
+#if defined(DLPH_RASTER_SSE)
+		__m128 const row0 = _mm_loadu_ps(mtx.p);
+		__m128 const row1 = _mm_loadu_ps(mtx.p + 4);
+		__m128 const row2 = _mm_loadu_ps(mtx.p + 8);
+		__m128 const row3 = _mm_loadu_ps(mtx.p + 12);
+		for (size_t idx = 0U; idx < count; ++idx) {
+			__m128 result = _mm_mul_ps(_mm_set1_ps(src[idx].x), row0);
+			result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(src[idx].y), row1));
+			result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(src[idx].z), row2));
+			result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(src[idx].w), row3));
+			_mm_storeu_ps(dst[idx].p, result);
+		}
+#else
+		for (size_t idx = 0U; idx < count; ++idx) {
+			for (unsigned int elem = 0U; elem < 4U; ++elem) {
+				dst[idx].p[elem] = src[idx].x * mtx.p[elem] + src[idx].y * mtx.p[4U + elem] + src[idx].z * mtx.p[8U + elem] + src[idx].w * mtx.p[12U + elem];
+			}
+		}
+#endif
+	}
+
+	//!	@brief	タイルの最大深度
+	float const tile_max(float const* depth) noexcept {
+#if defined(DLPH_RASTER_SSE)
+		__m128 result = _mm_loadu_ps(depth);
+		for (unsigned int idx = 4U; idx < TILE_PIXELS; idx += 4U) {
+			result = _mm_max_ps(result, _mm_loadu_ps(depth + idx));
+		}
+		result = _mm_max_ps(result, _mm_shuffle_ps(result, result, _MM_SHUFFLE(1, 0, 3, 2)));
+		result = _mm_max_ps(result, _mm_shuffle_ps(result, result, _MM_SHUFFLE(2, 3, 0, 1)));
+		return _mm_cvtss_f32(result);
+#else
+		return *std::max_element(depth, depth + TILE_PIXELS);
+#endif
+	}
+
+	/**	@brief	タイルの一行の被覆と深度テスト (通ったピクセルの深度を書きます)
+	 *	@param[in] edge 辺関数の行の左端での値
+	 *	@param[in] step 辺関数の 1 ピクセルあたりの増分
+	 *	@param[in] z 深度の行の左端での値
+	 *	@param[in] dz 深度の 1 ピクセルあたりの増分
+	 *	@param[in,out] depth 行の深度
+	 *	@param[in] valid 画面内のピクセルのビット
+	 *	@return 深度テストを通ったピクセルのビット
+	 */
+	unsigned int const raster_row(int const (&edge)[3], int const (&step)[3], float const& z, float const& dz, float* depth, unsigned int const& valid) noexcept {
+#if defined(DLPH_RASTER_SSE)
+		//	符号ビットの論理和が立っていなければ三辺とも内側
+		__m128i signLo = _mm_setzero_si128();
+		__m128i signHi = _mm_setzero_si128();
+		for (unsigned int idx = 0U; idx < 3U; ++idx) {
+			int const a = step[idx];
+			__m128i const lo = _mm_add_epi32(_mm_set1_epi32(edge[idx]), _mm_setr_epi32(0, a, a * 2, a * 3));
+			signLo = _mm_or_si128(signLo, lo);
+			signHi = _mm_or_si128(signHi, _mm_add_epi32(lo, _mm_set1_epi32(a * 4)));
+		}
+		__m128i const bitsLo = _mm_setr_epi32(1, 2, 4, 8);
+		__m128i const bitsHi = _mm_setr_epi32(16, 32, 64, 128);
+		__m128i const mask = _mm_set1_epi32(static_cast<int>(valid));
+		__m128i const none = _mm_set1_epi32(-1);
+		__m128 const insideLo = _mm_castsi128_ps(_mm_and_si128(_mm_cmpgt_epi32(signLo, none), _mm_cmpeq_epi32(_mm_and_si128(mask, bitsLo), bitsLo)));
+		__m128 const insideHi = _mm_castsi128_ps(_mm_and_si128(_mm_cmpgt_epi32(signHi, none), _mm_cmpeq_epi32(_mm_and_si128(mask, bitsHi), bitsHi)));
+
+		__m128 const base = _mm_set1_ps(z);
+		__m128 const zLo = _mm_add_ps(base, _mm_setr_ps(0.0f, dz, dz * 2.0f, dz * 3.0f));
+		__m128 const zHi = _mm_add_ps(base, _mm_setr_ps(dz * 4.0f, dz * 5.0f, dz * 6.0f, dz * 7.0f));
+		__m128 const dLo = _mm_loadu_ps(depth);
+		__m128 const dHi = _mm_loadu_ps(depth + 4);
+		__m128 const passLo = _mm_and_ps(insideLo, _mm_cmplt_ps(zLo, dLo));
+		__m128 const passHi = _mm_and_ps(insideHi, _mm_cmplt_ps(zHi, dHi));
+		_mm_storeu_ps(depth, _mm_or_ps(_mm_and_ps(passLo, zLo), _mm_andnot_ps(passLo, dLo)));
+		_mm_storeu_ps(depth + 4, _mm_or_ps(_mm_and_ps(passHi, zHi), _mm_andnot_ps(passHi, dHi)));
+		return static_cast<unsigned int>(_mm_movemask_ps(passLo) | (_mm_movemask_ps(passHi) << 4));
+#else
+		unsigned int bits = 0U;
+		for (unsigned int idx = 0U; idx < RASTER_TILE_SIZE; ++idx) {
+			int const i = static_cast<int>(idx);
+			int const sign = (edge[0] + step[0] * i) | (edge[1] + step[1] * i) | (edge[2] + step[2] * i);
+			float const value = z + dz * static_cast<float>(idx);
+			if ((valid & (1U << idx)) != 0U && sign >= 0 && value < depth[idx]) {
+				depth[idx] = value;
+				bits |= 1U << idx;
+			}
+		}
+		return bits;
+#endif
+	}
+
+	//!	@brief	立っているビットの数
+	unsigned int const count_bits(unsigned int bits) noexcept {
+		unsigned int count = 0U;
+		for (; bits != 0U; bits &= bits - 1U) {
+			++count;
+		}
+		return count;
+	}
+
+	//!	@brief	ビットが立っている最下位の位置
+	unsigned int const lowest_bit(unsigned int const& bits) noexcept {
+		unsigned int idx = 0U;
+		while ((bits & (1U << idx)) == 0U) {
+			++idx;
+		}
+		return idx;
+	}
+}
+
+namespace dlph {
+	SoftRasterizer::SoftRasterizer() noexcept :
+		INonmovable(),
+		m_width(0U),
+		m_height(0U),
+		m_tilesX(0U),
+		m_tilesY(0U),
+		m_binsX(0U),
+		m_binsY(0U),
+		m_mode(RasterMode::Color),
+		m_depth(),
+		m_hiz(),
+		m_color(),
+		m_clip(),
+		m_triangles(),
+		m_bins(),
+		m_binStats(),
+		m_shaders(),
+		m_stats()
+	{}
+
+	SoftRasterizer::~SoftRasterizer() noexcept {
+		exit();
+	}
+
+	bool const SoftRasterizer::init(unsigned int const& width, unsigned int const& height, RasterMode const& mode) noexcept {
+		exit();
+		if (width == 0U || height == 0U || width > RASTER_SIZE_MAX || height > RASTER_SIZE_MAX) {
+			OutputDebugStringA("ERROR : SOFTWARE RASTERIZER SIZE IS OUT OF RANGE.\n");
+			return false;
+		}
+
+		m_width = width;
+		m_height = height;
+		m_tilesX = (width + RASTER_TILE_SIZE - 1U) / RASTER_TILE_SIZE;
+		m_tilesY = (height + RASTER_TILE_SIZE - 1U) / RASTER_TILE_SIZE;
+		m_binsX = (width + RASTER_BIN_SIZE - 1U) / RASTER_BIN_SIZE;
+		m_binsY = (height + RASTER_BIN_SIZE - 1U) / RASTER_BIN_SIZE;
+		m_mode = mode;
+
+		size_t const tiles = static_cast<size_t>(m_tilesX) * m_tilesY;
+		m_depth.resize(tiles * TILE_PIXELS);
+		m_hiz.resize(tiles);
+		if (mode == RasterMode::Color) {
+			m_color.resize(static_cast<size_t>(width) * height);
+		}
+		m_bins.resize(static_cast<size_t>(m_binsX) * m_binsY);
+		m_binStats.resize(m_bins.size());
+		clear();
+		resetStats();
+		return true;
+	}
+
+	void SoftRasterizer::exit() noexcept {
+		m_width = 0U;
+		m_height = 0U;
+		m_tilesX = 0U;
+		m_tilesY = 0U;
+		m_binsX = 0U;
+		m_binsY = 0U;
+		std::vector<float>().swap(m_depth);
+		std::vector<float>().swap(m_hiz);
+		std::vector<unsigned int>().swap(m_color);
+		std::vector<FVector4>().swap(m_clip);
+		std::vector<Triangle>().swap(m_triangles);
+		std::vector<std::vector<unsigned int>>().swap(m_bins);
+		std::vector<BinStats>().swap(m_binStats);
+		std::vector<RasterShader>().swap(m_shaders);
+	}
+
+	void SoftRasterizer::clear(float const& depth, unsigned int const& color) noexcept {
+		std::fill(m_depth.begin(), m_depth.end(), depth);
+		std::fill(m_hiz.begin(), m_hiz.end(), depth);
+		std::fill(m_color.begin(), m_color.end(), color);
+		m_triangles.clear();
+		m_shaders.clear();
+		for (std::vector<unsigned int>& bin : m_bins) {
+			bin.clear();
+		}
+	}
+
+	bool const SoftRasterizer::draw(FVector4 const* positions, size_t const& vertexCount, unsigned int const* indices, size_t const& indexCount,
+		FMatrix4x4 const& transform, RasterCull const& cull, RasterShader const* shader) noexcept
+	{
+		if (m_width == 0U) {
+			OutputDebugStringA("ERROR : SOFTWARE RASTERIZER IS NOT INITIALIZED.\n");
+			return false;
+		}
+		if (positions == nullptr || vertexCount == 0U || vertexCount > ~0U) {
+			OutputDebugStringA("ERROR : SOFTWARE RASTERIZER VERTICES ARE INVALID.\n");
+			return false;
+		}
+		if (indices) {
+			for (size_t idx = 0U; idx < indexCount; ++idx) {
+				if (indices[idx] >= vertexCount) {
+					OutputDebugStringA("ERROR : SOFTWARE RASTERIZER INDEX EXCEEDS VERTEX COUNT.\n");
+					return false;
+				}
+			}
+		}
+		size_t const count = (indices ? indexCount : vertexCount) / 3U;
+		if (count == 0U) {
+			return true;
+		}
+
+		m_clip.resize(vertexCount);
+		parallel_for(vertexCount, TRANSFORM_GRAIN, [this, positions, &transform](size_t const& begin, size_t const& end) {
+			transform_points(positions + begin, m_clip.data() + begin, end - begin, transform);
+		});
+
+		unsigned int shaderIdx = SHADER_NONE;
+		if (shader && shader->func && m_mode == RasterMode::Color) {
+			shaderIdx = static_cast<unsigned int>(m_shaders.size());
+			m_shaders.push_back(*shader);
+		}
+
+		//	セットアップはジョブごとの出力に分け、結合と振り分けは順に行って描画順を保つ
+		struct Chunk final {
+			std::vector<Triangle> triangles;
+			unsigned long long culled;
+			unsigned long long clipped;
+		};
+		std::vector<Chunk> chunks((count + SETUP_GRAIN - 1U) / SETUP_GRAIN);
+		parallel_for(chunks.size(), 1U, [this, &chunks, count, indices, cull, shaderIdx](size_t const& begin, size_t const& end) {
+			Triangle split[RASTER_SPLIT_MAX];
+			for (size_t chunkIdx = begin; chunkIdx < end; ++chunkIdx) {
+				Chunk& chunk = chunks[chunkIdx];
+				chunk.culled = 0U;
+				chunk.clipped = 0U;
+				size_t const last = std::min(count, (chunkIdx + 1U) * SETUP_GRAIN);
+				for (size_t prim = chunkIdx * SETUP_GRAIN; prim < last; ++prim) {
+					size_t const base = prim * 3U;
+					FVector4 const clip[3] = {
+						m_clip[indices ? indices[base] : base],
+						m_clip[indices ? indices[base + 1U] : base + 1U],
+						m_clip[indices ? indices[base + 2U] : base + 2U],
+					};
+					bool clipped = false;
+					unsigned int const made = setup(clip, static_cast<unsigned int>(prim), shaderIdx, cull, split, clipped);
+					chunk.culled += made == 0U ? 1U : 0U;
+					chunk.clipped += clipped ? 1U : 0U;
+					chunk.triangles.insert(chunk.triangles.end(), split, split + made);
+				}
+			}
+		});
+
+		m_stats.triangles += count;
+		for (Chunk const& chunk : chunks) {
+			m_stats.culled += chunk.culled;
+			m_stats.clipped += chunk.clipped;
+			for (Triangle const& tri : chunk.triangles) {
+				unsigned int const idx = static_cast<unsigned int>(m_triangles.size());
+				m_triangles.push_back(tri);
+				unsigned int const bx0 = static_cast<unsigned int>(tri.bounds[0]) / RASTER_BIN_SIZE;
+				unsigned int const by0 = static_cast<unsigned int>(tri.bounds[1]) / RASTER_BIN_SIZE;
+				unsigned int const bx1 = static_cast<unsigned int>(tri.bounds[2]) / RASTER_BIN_SIZE;
+				unsigned int const by1 = static_cast<unsigned int>(tri.bounds[3]) / RASTER_BIN_SIZE;
+				for (unsigned int by = by0; by <= by1; ++by) {
+					for (unsigned int bx = bx0; bx <= bx1; ++bx) {
+						m_bins[static_cast<size_t>(by) * m_binsX + bx].push_back(idx);
+					}
+				}
+			}
+		}
+		return true;
+	}
+
+	void SoftRasterizer::flush() noexcept {
+		if (m_triangles.empty()) {
+			return;
+		}
+
+		std::fill(m_binStats.begin(), m_binStats.end(), BinStats());
+		parallel_for(m_bins.size(), 1U, [this](size_t const& begin, size_t const& end) {
+			for (size_t bin = begin; bin < end; ++bin) {
+				rasterize(bin);
+			}
+		});
+
+		for (BinStats const& stats : m_binStats) {
+			m_stats.tiles += stats.tiles;
+			m_stats.hiz += stats.hiz;
+			m_stats.full += stats.full;
+			m_stats.fragments += stats.fragments;
+		}
+		m_triangles.clear();
+		m_shaders.clear();
+		for (std::vector<unsigned int>& bin : m_bins) {
+			bin.clear();
+		}
+	}
+
+	bool const SoftRasterizer::testRect(float const& minX, float const& minY, float const& maxX, float const& maxY, float const& depth) const noexcept {
+		if (m_width == 0U || !(minX <= maxX) || !(minY <= maxY)) {
+			return false;
+		}
+		if (maxX < 0.0f || maxY < 0.0f || minX >= static_cast<float>(m_width) || minY >= static_cast<float>(m_height)) {
+			return false;
+		}
+
+		//	触れているピクセルを全て調べて保守的に判定する
+		unsigned int const px0 = static_cast<unsigned int>(std::max(minX, 0.0f));
+		unsigned int const py0 = static_cast<unsigned int>(std::max(minY, 0.0f));
+		unsigned int const px1 = static_cast<unsigned int>(std::min(maxX, static_cast<float>(m_width - 1U)));
+		unsigned int const py1 = static_cast<unsigned int>(std::min(maxY, static_cast<float>(m_height - 1U)));
+		for (unsigned int ty = py0 / RASTER_TILE_SIZE; ty <= py1 / RASTER_TILE_SIZE; ++ty) {
+			for (unsigned int tx = px0 / RASTER_TILE_SIZE; tx <= px1 / RASTER_TILE_SIZE; ++tx) {
+				size_t const tile = static_cast<size_t>(ty) * m_tilesX + tx;
+				if (depth >= m_hiz[tile]) {
+					continue;
+				}
+				unsigned int const x0 = std::max(px0, tx * RASTER_TILE_SIZE);
+				unsigned int const y0 = std::max(py0, ty * RASTER_TILE_SIZE);
+				unsigned int const x1 = std::min(px1, tx * RASTER_TILE_SIZE + RASTER_TILE_SIZE - 1U);
+				unsigned int const y1 = std::min(py1, ty * RASTER_TILE_SIZE + RASTER_TILE_SIZE - 1U);
+				float const* const pixels = m_depth.data() + tile * TILE_PIXELS;
+				for (unsigned int y = y0; y <= y1; ++y) {
+					for (unsigned int x = x0; x <= x1; ++x) {
+						if (depth < pixels[(y % RASTER_TILE_SIZE) * RASTER_TILE_SIZE + x % RASTER_TILE_SIZE]) {
+							return true;
+						}
+					}
+				}
+			}
+		}
+		return false;
+	}
+
+	bool const SoftRasterizer::testBox(FVector4 const& min, FVector4 const& max, FMatrix4x4 const& transform) const noexcept {
+		if (m_width == 0U) {
+			return true;
+		}
+
+		float lo[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+		float hi[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+		for (unsigned int corner = 0U; corner < 8U; ++corner) {
+			FVector4 const point(
+				(corner & 1U) ? max.x : min.x,
+				(corner & 2U) ? max.y : min.y,
+				(corner & 4U) ? max.z : min.z,
+				1.0f);
+			FVector4 clip;
+			transform_points(&point, &clip, 1U, transform);
+			if (clip.w <= W_EPSILON) {
+				return true;
+			}
+			float const inv = 1.0f / clip.w;
+			for (unsigned int axis = 0U; axis < 3U; ++axis) {
+				lo[axis] = std::min(lo[axis], clip.p[axis] * inv);
+				hi[axis] = std::max(hi[axis], clip.p[axis] * inv);
+			}
+		}
+		if (lo[2] < 0.0f) {
+			return true;
+		}
+		if (lo[2] > 1.0f) {
+			return false;
+		}
+
+		float const width = static_cast<float>(m_width);
+		float const height = static_cast<float>(m_height);
+		return testRect(
+			(lo[0] * 0.5f + 0.5f) * width, (0.5f - hi[1] * 0.5f) * height,
+			(hi[0] * 0.5f + 0.5f) * width, (0.5f - lo[1] * 0.5f) * height,
+			lo[2]);
+	}
+
+	float const SoftRasterizer::depth(unsigned int const& x, unsigned int const& y) const noexcept {
+#if	defined(_DEBUG) || defined(DEBUG)
+		_ASSERT_EXPR(x < m_width && y < m_height, L"ERROR : PIXEL POSITION IS OUT OF RANGE.");
+#endif
+		size_t const tile = static_cast<size_t>(y / RASTER_TILE_SIZE) * m_tilesX + x / RASTER_TILE_SIZE;
+		return m_depth[tile * TILE_PIXELS + (y % RASTER_TILE_SIZE) * RASTER_TILE_SIZE + x % RASTER_TILE_SIZE];
+	}
+
+	unsigned int const* const SoftRasterizer::color() const noexcept {
+		return m_color.empty() ? nullptr : m_color.data();
+	}
+
+	unsigned int const SoftRasterizer::width() const noexcept {
+		return m_width;
+	}
+
+	unsigned int const SoftRasterizer::height() const noexcept {
+		return m_height;
+	}
+
+	RasterMode const SoftRasterizer::mode() const noexcept {
+		return m_mode;
+	}
+
+	bool const SoftRasterizer::writeTGA(char const* const path) const noexcept {
+		if (m_color.empty()) {
+			OutputDebugStringA("ERROR : SOFTWARE RASTERIZER HAS NO COLOR BUFFER.\n");
+			return false;
+		}
+
+		//	無圧縮の 32 ビットで、左上を原点とする
+		unsigned char header[18] = {};
+		header[2] = 2U;
+		header[12] = static_cast<unsigned char>(m_width & 0xFFU);
+		header[13] = static_cast<unsigned char>(m_width >> 8U);
+		header[14] = static_cast<unsigned char>(m_height & 0xFFU);
+		header[15] = static_cast<unsigned char>(m_height >> 8U);
+		header[16] = 32U;
+		header[17] = 0x28U;
+
+		std::vector<unsigned int> pixels(m_color.size());
+		std::transform(m_color.begin(), m_color.end(), pixels.begin(), [](unsigned int const& rgba) {
+			return (rgba & 0xFF00FF00U) | ((rgba & 0xFFU) << 16U) | ((rgba >> 16U) & 0xFFU);
+		});
+
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (!file) {
+			OutputDebugStringA("ERROR : TGA FILE CANNOT BE CREATED.\n");
+			return false;
+		}
+		file.write(reinterpret_cast<char const*>(header), sizeof(header));
+		file.write(reinterpret_cast<char const*>(pixels.data()), static_cast<std::streamsize>(pixels.size() * sizeof(unsigned int)));
+		if (!file.flush()) {
+			OutputDebugStringA("ERROR : TGA FILE WRITING FAILED.\n");
+			return false;
+		}
+		return true;
+	}
+
+	RasterStats const SoftRasterizer::stats() const noexcept {
+		return m_stats;
+	}
+
+	void SoftRasterizer::resetStats() noexcept {
+		m_stats = RasterStats();
+	}
+
+	unsigned int const SoftRasterizer::setup(FVector4 const (&clip)[3], unsigned int const& primitive, unsigned int const& shader, RasterCull const& cull,
+		Triangle* out, bool& clipped) const noexcept
+	{
+		ClipVertex poly[CLIP_VERTEX_MAX];
+		unsigned int codes[3];
+		for (unsigned int idx = 0U; idx < 3U; ++idx) {
+			std::copy(clip[idx].p, clip[idx].p + 4, poly[idx].p);
+			poly[idx].b1 = idx == 1U ? 1.0f : 0.0f;
+			poly[idx].b2 = idx == 2U ? 1.0f : 0.0f;
+			codes[idx] = outcode(poly[idx]);
+		}
+		clipped = false;
+		if ((codes[0] & codes[1] & codes[2]) != 0U) {
+			return 0U;
+		}
+
+		unsigned int count = 3U;
+		unsigned int const planes = codes[0] | codes[1] | codes[2];
+		if (planes != 0U) {
+			clipped = true;
+			count = clip_polygon(poly, count, planes);
+		}
+
+		float const width = static_cast<float>(m_width);
+		float const height = static_cast<float>(m_height);
+		unsigned int made = 0U;
+		for (unsigned int fan = 1U; fan + 1U < count; ++fan) {
+			ClipVertex const* const verts[3] = { &poly[0], &poly[fan], &poly[fan + 1U] };
+			long long sx[3];
+			long long sy[3];
+			double attr[3][4];
+			for (unsigned int idx = 0U; idx < 3U; ++idx) {
+				float const inv = 1.0f / verts[idx]->p[3];
+				float const x = (verts[idx]->p[0] * inv * 0.5f + 0.5f) * width;
+				float const y = (0.5f - verts[idx]->p[1] * inv * 0.5f) * height;
+				sx[idx] = std::llround(static_cast<double>(x) * SUBPIXEL);
+				sy[idx] = std::llround(static_cast<double>(y) * SUBPIXEL);
+				attr[idx][0] = std::max(verts[idx]->p[2] * inv, 0.0f);
+				attr[idx][1] = inv;
+				attr[idx][2] = verts[idx]->b1 * inv;
+				attr[idx][3] = verts[idx]->b2 * inv;
+			}
+
+			//	画面は y が下向きなので、面積が正なら時計回り (表面)
+			long long const area = (sx[1] - sx[0]) * (sy[2] - sy[0]) - (sx[2] - sx[0]) * (sy[1] - sy[0]);
+			if (area == 0 || (cull == RasterCull::Back && area < 0) || (cull == RasterCull::Front && area > 0)) {
+				continue;
+			}
+			if (area < 0) {
+				std::swap(sx[1], sx[2]);
+				std::swap(sy[1], sy[2]);
+				std::swap(attr[1], attr[2]);
+			}
+
+			//	ピクセル中心 (16p + 8) が範囲に入るピクセル
+			long long const half = SUBPIXEL / 2;
+			int const left = static_cast<int>(std::max<long long>((std::min({ sx[0], sx[1], sx[2] }) - half + SUBPIXEL - 1) >> RASTER_SUBPIXEL_BITS, 0));
+			int const top = static_cast<int>(std::max<long long>((std::min({ sy[0], sy[1], sy[2] }) - half + SUBPIXEL - 1) >> RASTER_SUBPIXEL_BITS, 0));
+			int const right = static_cast<int>(std::min<long long>((std::max({ sx[0], sx[1], sx[2] }) - half) >> RASTER_SUBPIXEL_BITS, m_width - 1U));
+			int const bottom = static_cast<int>(std::min<long long>((std::max({ sy[0], sy[1], sy[2] }) - half) >> RASTER_SUBPIXEL_BITS, m_height - 1U));
+			if (left > right || top > bottom) {
+				continue;
+			}
+
+			Triangle& tri = out[made];
+			tri.bounds[0] = left;
+			tri.bounds[1] = top;
+			tri.bounds[2] = right;
+			tri.bounds[3] = bottom;
+
+			//	辺 k は頂点 k の向かい側で、内側が正になる。上辺と左辺以外は境界上を含めない
+			for (unsigned int edge = 0U; edge < 3U; ++edge) {
+				unsigned int const from = (edge + 1U) % 3U;
+				unsigned int const to = (edge + 2U) % 3U;
+				long long const a = sy[from] - sy[to];
+				long long const b = sx[to] - sx[from];
+				long long c = -(a * sx[from] + b * sy[from]);
+				if (!(a > 0 || (a == 0 && b > 0))) {
+					c -= 1;
+				}
+				tri.a[edge] = static_cast<int>(a * SUBPIXEL);
+				tri.b[edge] = static_cast<int>(b * SUBPIXEL);
+				tri.c[edge] = c + (a + b) * half;
+			}
+
+			//	属性はピクセル (0, 0) の中心を原点とする平面で補間する
+			double const x0 = static_cast<double>(sx[0]) / SUBPIXEL;
+			double const y0 = static_cast<double>(sy[0]) / SUBPIXEL;
+			double const x1 = static_cast<double>(sx[1]) / SUBPIXEL - x0;
+			double const y1 = static_cast<double>(sy[1]) / SUBPIXEL - y0;
+			double const x2 = static_cast<double>(sx[2]) / SUBPIXEL - x0;
+			double const y2 = static_cast<double>(sy[2]) / SUBPIXEL - y0;
+			double const det = x1 * y2 - x2 * y1;
+			for (unsigned int plane = 0U; plane < 4U; ++plane) {
+				double const d1 = attr[1][plane] - attr[0][plane];
+				double const d2 = attr[2][plane] - attr[0][plane];
+				double const dx = (d1 * y2 - d2 * y1) / det;
+				double const dy = (d2 * x1 - d1 * x2) / det;
+				tri.planes[plane][0] = static_cast<float>(dx);
+				tri.planes[plane][1] = static_cast<float>(dy);
+				tri.planes[plane][2] = static_cast<float>(attr[0][plane] + dx * (0.5 - x0) + dy * (0.5 - y0));
+			}
+			tri.zmin = static_cast<float>(std::min({ attr[0][0], attr[1][0], attr[2][0] }));
+			tri.primitive = primitive;
+			tri.shader = shader;
+			++made;
+		}
+		return made;
+	}
+
+	void SoftRasterizer::rasterize(size_t const& bin) noexcept {
+		BinStats& stats = m_binStats[bin];
+		unsigned int const binX = static_cast<unsigned int>(bin % m_binsX) * BIN_TILES;
+		unsigned int const binY = static_cast<unsigned int>(bin / m_binsX) * BIN_TILES;
+		unsigned int const lastX = std::min(binX + BIN_TILES, m_tilesX) - 1U;
+		unsigned int const lastY = std::min(binY + BIN_TILES, m_tilesY) - 1U;
+
+		for (unsigned int const triIdx : m_bins[bin]) {
+			Triangle const& tri = m_triangles[triIdx];
+			RasterShader const* const shader = tri.shader == SHADER_NONE ? nullptr : &m_shaders[tri.shader];
+			unsigned int const tx0 = std::max(static_cast<unsigned int>(tri.bounds[0]) / RASTER_TILE_SIZE, binX);
+			unsigned int const ty0 = std::max(static_cast<unsigned int>(tri.bounds[1]) / RASTER_TILE_SIZE, binY);
+			unsigned int const tx1 = std::min(static_cast<unsigned int>(tri.bounds[2]) / RASTER_TILE_SIZE, lastX);
+			unsigned int const ty1 = std::min(static_cast<unsigned int>(tri.bounds[3]) / RASTER_TILE_SIZE, lastY);
+
+			for (unsigned int ty = ty0; ty <= ty1; ++ty) {
+				for (unsigned int tx = tx0; tx <= tx1; ++tx) {
+					++stats.tiles;
+					size_t const tile = static_cast<size_t>(ty) * m_tilesX + tx;
+					if (tri.zmin >= m_hiz[tile]) {
+						++stats.hiz;
+						continue;
+					}
+
+					//	タイルの四隅で辺関数を調べ、外なら捨て、内なら以降の評価を省く
+					int const x0 = static_cast<int>(tx * RASTER_TILE_SIZE);
+					int const y0 = static_cast<int>(ty * RASTER_TILE_SIZE);
+					long long const span = RASTER_TILE_SIZE - 1U;
+					int edge[3];
+					int stepX[3];
+					int stepY[3];
+					bool reject = false;
+					bool full = true;
+					for (unsigned int idx = 0U; idx < 3U && !reject; ++idx) {
+						long long const a = tri.a[idx];
+						long long const b = tri.b[idx];
+						long long const e = a * x0 + b * y0 + tri.c[idx];
+						long long const lo = e + std::min(a, 0LL) * span + std::min(b, 0LL) * span;
+						long long const hi = e + std::max(a, 0LL) * span + std::max(b, 0LL) * span;
+						reject = hi < 0;
+						if (lo >= 0) {
+							edge[idx] = 0;
+							stepX[idx] = 0;
+							stepY[idx] = 0;
+						}
+						else {
+							full = false;
+							edge[idx] = static_cast<int>(e);
+							stepX[idx] = tri.a[idx];
+							stepY[idx] = tri.b[idx];
+						}
+					}
+					if (reject) {
+						continue;
+					}
+					stats.full += full ? 1U : 0U;
+
+					unsigned int const cols = std::min(RASTER_TILE_SIZE, m_width - tx * RASTER_TILE_SIZE);
+					unsigned int const rows = std::min(RASTER_TILE_SIZE, m_height - ty * RASTER_TILE_SIZE);
+					unsigned int const valid = (1U << cols) - 1U;
+					float const* const zp = tri.planes[0];
+					float* const pixels = m_depth.data() + tile * TILE_PIXELS;
+					bool wrote = false;
+					for (unsigned int row = 0U; row < rows; ++row) {
+						int const y = y0 + static_cast<int>(row);
+						float const z = zp[2] + zp[0] * static_cast<float>(x0) + zp[1] * static_cast<float>(y);
+						unsigned int bits = raster_row(edge, stepX, z, zp[0], pixels + row * RASTER_TILE_SIZE, valid);
+						for (unsigned int idx = 0U; idx < 3U; ++idx) {
+							edge[idx] += stepY[idx];
+						}
+						if (bits == 0U) {
+							continue;
+						}
+						wrote = true;
+						stats.fragments += count_bits(bits);
+						if (shader == nullptr) {
+							continue;
+						}
+
+						//	透視補正した重みを求めてシェーディングする
+						unsigned int* const colors = m_color.data() + static_cast<size_t>(y) * m_width;
+						for (; bits != 0U; bits &= bits - 1U) {
+							unsigned int const col = lowest_bit(bits);
+							float const x = static_cast<float>(x0 + static_cast<int>(col));
+							float const fy = static_cast<float>(y);
+							float const w = 1.0f / (tri.planes[1][2] + tri.planes[1][0] * x + tri.planes[1][1] * fy);
+							RasterFragment fragment = {};
+							fragment.x = static_cast<unsigned int>(x0) + col;
+							fragment.y = static_cast<unsigned int>(y);
+							fragment.depth = pixels[row * RASTER_TILE_SIZE + col];
+							fragment.b1 = (tri.planes[2][2] + tri.planes[2][0] * x + tri.planes[2][1] * fy) * w;
+							fragment.b2 = (tri.planes[3][2] + tri.planes[3][0] * x + tri.planes[3][1] * fy) * w;
+							fragment.primitive = tri.primitive;
+							colors[fragment.x] = shader->func(shader->context, fragment);
+						}
+					}
+					if (wrote) {
+						m_hiz[tile] = tile_max(pixels);
+					}
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,154 @@
+﻿/**	@file	dlph_state_filter.cpp
+ *	@brief	重複した状態設定を取り除く描画バックエンド
+ */
+#include "dlph/dlph_state_filter.hpp"
+
+namespace dlph {
+	RenderStateFilter::RenderStateFilter(IRenderBackend& target) noexcept :
+		IRenderBackend(),
+		m_target(target),
+		m_stats(),
+		m_pipeline(),
+		m_hasPipeline(false),
+		m_vertices(),
+		m_vertexMask(0U),
+		m_indices(),
+		m_hasIndices(false),
+		m_roots()
+	{
+		invalidate();
+	}
+
+	void RenderStateFilter::reset() noexcept {
+		m_stats = {};
+		invalidate();
+	}
+
+	void RenderStateFilter::invalidate() noexcept {
+		m_pipeline = {};
+		m_hasPipeline = false;
+		m_vertexMask = 0U;
+		m_indices = {};
+		m_hasIndices = false;
+		for (RootBinding& binding : m_roots) {
+			binding = { RenderCommandType::Count, 0U };
+		}
+	}
+
+	StateFilterStats const& RenderStateFilter::stats() const noexcept {
+		return m_stats;
+	}
+
+	unsigned long long const RenderStateFilter::eliminated() const noexcept {
+		unsigned long long sum = 0U;
+		for (unsigned long long const& count : m_stats.eliminated) {
+			sum += count;
+		}
+		return sum;
+	}
+
+	void RenderStateFilter::draw(DrawCommand const& cmd) noexcept {
+		receive(DrawCommand::TYPE);
+		m_target.draw(cmd);
+	}
+
+	void RenderStateFilter::drawIndexed(DrawIndexedCommand const& cmd) noexcept {
+		receive(DrawIndexedCommand::TYPE);
+		m_target.drawIndexed(cmd);
+	}
+
+	void RenderStateFilter::dispatch(DispatchCommand const& cmd) noexcept {
+		receive(DispatchCommand::TYPE);
+		m_target.dispatch(cmd);
+	}
+
+	void RenderStateFilter::setPipeline(SetPipelineCommand const& cmd) noexcept {
+		receive(SetPipelineCommand::TYPE);
+		if (m_hasPipeline && m_pipeline == cmd.pipeline) {
+			eliminate(SetPipelineCommand::TYPE);
+			return;
+		}
+		m_pipeline = cmd.pipeline;
+		m_hasPipeline = true;
+		for (RootBinding& binding : m_roots) {
+			binding = { RenderCommandType::Count, 0U };
+		}
+		m_target.setPipeline(cmd);
+	}
+
+	void RenderStateFilter::bindVertexBuffer(BindVertexBufferCommand const& cmd) noexcept {
+		receive(BindVertexBufferCommand::TYPE);
+		if (cmd.slot >= STATE_FILTER_VERTEX_SLOT_CNT) {
+			m_target.bindVertexBuffer(cmd);
+			return;
+		}
+		unsigned int const bit = 1U << cmd.slot;
+		BindVertexBufferCommand& current = m_vertices[cmd.slot];
+		if ((m_vertexMask & bit) != 0U && current.buffer == cmd.buffer && current.stride == cmd.stride && current.offset == cmd.offset) {
+			eliminate(BindVertexBufferCommand::TYPE);
+			return;
+		}
+		current = cmd;
+		m_vertexMask |= bit;
+		m_target.bindVertexBuffer(cmd);
+	}
+
+	void RenderStateFilter::bindIndexBuffer(BindIndexBufferCommand const& cmd) noexcept {
+		receive(BindIndexBufferCommand::TYPE);
+		if (m_hasIndices && m_indices.buffer == cmd.buffer && m_indices.offset == cmd.offset && m_indices.format == cmd.format) {
+			eliminate(BindIndexBufferCommand::TYPE);
+			return;
+		}
+		m_indices = cmd;
+		m_hasIndices = true;
+		m_target.bindIndexBuffer(cmd);
+	}
+
+	void RenderStateFilter::bindConstants(BindConstantsCommand const& cmd) noexcept {
+		receive(BindConstantsCommand::TYPE);
+		if (!bindRoot(cmd.root, BindConstantsCommand::TYPE, cmd.address)) {
+			eliminate(BindConstantsCommand::TYPE);
+			return;
+		}
+		m_target.bindConstants(cmd);
+	}
+
+	void RenderStateFilter::bindResource(BindResourceCommand const& cmd) noexcept {
+		receive(BindResourceCommand::TYPE);
+		if (!bindRoot(cmd.root, BindResourceCommand::TYPE, cmd.resource.value)) {
+			eliminate(BindResourceCommand::TYPE);
+			return;
+		}
+		m_target.bindResource(cmd);
+	}
+
+	void RenderStateFilter::barrier(BarrierCommand const& cmd) noexcept {
+		receive(BarrierCommand::TYPE);
+		m_target.barrier(cmd);
+	}
+
+	void RenderStateFilter::copy(CopyCommand const& cmd) noexcept {
+		receive(CopyCommand::TYPE);
+		m_target.copy(cmd);
+	}
+
+	void RenderStateFilter::receive(RenderCommandType const& type) noexcept {
+		++m_stats.received[static_cast<unsigned int>(type)];
+	}
+
+	void RenderStateFilter::eliminate(RenderCommandType const& type) noexcept {
+		++m_stats.eliminated[static_cast<unsigned int>(type)];
+	}
+
+	bool const RenderStateFilter::bindRoot(unsigned int const& root, RenderCommandType const& type, unsigned long long const& value) noexcept {
+		if (root >= STATE_FILTER_ROOT_CNT) {
+			return true;
+		}
+		RootBinding& binding = m_roots[root];
+		if (binding.type == type && binding.value == value) {
+			return false;
+		}
+		binding = { type, value };
+		return true;
+	}
+}
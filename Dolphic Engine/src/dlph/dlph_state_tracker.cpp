@@ -0,0 +1,196 @@
+﻿/**	@file	dlph_state_tracker.cpp
+ *	@brief	リソースの状態追跡器
+ */
+#include "dlph/dlph_state_tracker.hpp"
+#include <algorithm>
+
+namespace dlph {
+	ResourceStateTracker::ResourceStateTracker() noexcept :
+		m_entries(),
+		m_pending(),
+		m_live(0U),
+		m_epoch(1U),
+		m_stats()
+	{}
+
+	void ResourceStateTracker::track(unsigned long long const& resource, ResourceState const& state, unsigned int const& subresources) noexcept {
+		auto const result = m_entries.try_emplace(resource);
+		Entry& entry = result.first->second;
+		if (result.second) {
+			entry.last = PENDING_NONE;
+			entry.epoch = m_epoch;
+		}
+		entry.whole = state;
+		entry.count = subresources > 0U ? subresources : 1U;
+		entry.subs.clear();
+	}
+
+	void ResourceStateTracker::untrack(unsigned long long const& resource) noexcept {
+		m_entries.erase(resource);
+	}
+
+	bool const ResourceStateTracker::tracked(unsigned long long const& resource) const noexcept {
+		return m_entries.count(resource) != 0U;
+	}
+
+	ResourceState const ResourceStateTracker::state(unsigned long long const& resource, unsigned int const& subresource) const noexcept {
+		auto const it = m_entries.find(resource);
+		if (it == m_entries.end()) {
+			return ResourceState::Common;
+		}
+		Entry const& entry = it->second;
+		if (entry.subs.empty()) {
+			return entry.whole;
+		}
+		return subresource < entry.count ? entry.subs[subresource] : entry.subs[0U];
+	}
+
+	void ResourceStateTracker::clear() noexcept {
+		m_entries.clear();
+		m_pending.clear();
+		m_live = 0U;
+		++m_epoch;
+	}
+
+	bool const ResourceStateTracker::transition(unsigned long long const& resource, ResourceState const& after, unsigned int const& subresource) noexcept {
+		auto const it = m_entries.find(resource);
+		if (it == m_entries.end() || (subresource != SUBRESOURCE_ALL && subresource >= it->second.count)) {
+			OutputDebugStringA("ERROR : TRANSITION OF UNTRACKED RESOURCE.\n");
+			return false;
+		}
+		Entry& entry = it->second;
+		++m_stats.requested;
+
+		if (subresource == SUBRESOURCE_ALL) {
+			if (entry.subs.empty()) {
+				if (entry.whole == after) {
+					++m_stats.skipped;
+					return true;
+				}
+				push(resource, SUBRESOURCE_ALL, entry.whole, after);
+			}
+			else {
+				//	サブリソースごとに状態が異なるため、異なるものだけを個別に遷移させる
+				for (unsigned int idx = 0U; idx < entry.count; ++idx) {
+					if (entry.subs[idx] != after) {
+						push(resource, idx, entry.subs[idx], after);
+					}
+				}
+				entry.subs.clear();
+			}
+			entry.whole = after;
+			return true;
+		}
+
+		if (entry.subs.empty()) {
+			if (entry.whole == after) {
+				++m_stats.skipped;
+				return true;
+			}
+			entry.subs.assign(entry.count, entry.whole);
+		}
+		if (entry.subs[subresource] == after) {
+			++m_stats.skipped;
+			return true;
+		}
+		push(resource, subresource, entry.subs[subresource], after);
+		entry.subs[subresource] = after;
+
+		//	全て揃ったら全体の状態に戻す
+		if (std::all_of(entry.subs.begin(), entry.subs.end(), [&after](ResourceState const& state) { return state == after; })) {
+			entry.subs.clear();
+			entry.whole = after;
+		}
+		return true;
+	}
+
+	void ResourceStateTracker::uav(unsigned long long const& resource) noexcept {
+		++m_stats.requested;
+		size_t const last = lastPending(resource);
+		if (last != PENDING_NONE && m_pending[last].barrier.kind == BarrierKind::UnorderedAccess) {
+			++m_stats.skipped;
+			return;
+		}
+		append({ resource, SUBRESOURCE_ALL, ResourceState::UnorderedAccess, ResourceState::UnorderedAccess, BarrierKind::UnorderedAccess });
+	}
+
+	void ResourceStateTracker::barrier(StateTransition const& barrier) noexcept {
+		++m_stats.requested;
+		append(barrier);
+		if (barrier.kind == BarrierKind::Aliasing) {
+			untrack(barrier.resource);
+		}
+		else if (barrier.kind == BarrierKind::End || barrier.kind == BarrierKind::Transition) {
+			auto const it = m_entries.find(barrier.resource);
+			if (it == m_entries.end() || barrier.subresource == SUBRESOURCE_ALL) {
+				track(barrier.resource, barrier.after, it == m_entries.end() ? 1U : it->second.count);
+			}
+			else if (barrier.subresource < it->second.count) {
+				Entry& entry = it->second;
+				if (entry.subs.empty()) {
+					entry.subs.assign(entry.count, entry.whole);
+				}
+				entry.subs[barrier.subresource] = barrier.after;
+			}
+		}
+	}
+
+	bool const ResourceStateTracker::pending() const noexcept {
+		return m_live != 0U;
+	}
+
+	StateTrackerStats const& ResourceStateTracker::stats() const noexcept {
+		return m_stats;
+	}
+
+	void ResourceStateTracker::resetStats() noexcept {
+		m_stats = {};
+	}
+
+	void ResourceStateTracker::push(unsigned long long const& resource, unsigned int const& subresource, ResourceState const& before, ResourceState const& after) noexcept {
+		//	同じリソースへの発行待ちを新しい順にたどり、最初に重なったものが同じサブリソースの遷移なら一つにまとめる。
+		//	それ以外と重なったら順序を保って積む
+		for (size_t idx = lastPending(resource); idx != PENDING_NONE; idx = m_pending[idx].link) {
+			Pending& prev = m_pending[idx];
+			if (!prev.live) {
+				continue;
+			}
+			if (prev.barrier.subresource != subresource && prev.barrier.subresource != SUBRESOURCE_ALL && subresource != SUBRESOURCE_ALL) {
+				continue;
+			}
+			if (prev.barrier.kind != BarrierKind::Transition || prev.barrier.subresource != subresource) {
+				break;
+			}
+			++m_stats.merged;
+			prev.barrier.after = after;
+			if (prev.barrier.before == prev.barrier.after) {
+				prev.live = false;
+				--m_live;
+				++m_stats.cancelled;
+			}
+			return;
+		}
+		append({ resource, subresource, before, after, BarrierKind::Transition });
+	}
+
+	size_t const ResourceStateTracker::lastPending(unsigned long long const& resource) const noexcept {
+		auto const it = m_entries.find(resource);
+		if (it == m_entries.end() || it->second.epoch != m_epoch) {
+			return PENDING_NONE;
+		}
+		return it->second.last;
+	}
+
+	void ResourceStateTracker::append(StateTransition const& barrier) noexcept {
+		size_t link = PENDING_NONE;
+		auto const it = m_entries.find(barrier.resource);
+		if (it != m_entries.end()) {
+			Entry& entry = it->second;
+			link = entry.epoch == m_epoch ? entry.last : PENDING_NONE;
+			entry.last = m_pending.size();
+			entry.epoch = m_epoch;
+		}
+		m_pending.push_back({ barrier, link, true });
+		++m_live;
+	}
+}
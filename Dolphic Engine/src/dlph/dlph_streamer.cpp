@@ -0,0 +1,414 @@
+﻿/**	@file	dlph_streamer.cpp
+ *	@brief	リソースの非同期転送
+ */
+#include "dlph/dlph_streamer.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+	using namespace dlph;
+
+	//!	@brief	提出前を表すフェンス値
+	static unsigned long long constexpr STREAM_UNSUBMITTED = ~0ULL;
+
+	//!	@brief	境界への切り上げ
+	inline unsigned long long const align_up(unsigned long long const& value, unsigned long long const& alignment) noexcept {
+		return alignment > 1U ? (value + alignment - 1U) & ~(alignment - 1U) : value;
+	}
+}
+
+namespace dlph {
+	ResourceStreamer::ResourceStreamer() noexcept :
+		INonmovable(),
+		m_engine(nullptr),
+		m_ring(),
+		m_entries(),
+		m_queue(),
+		m_waiting(),
+		m_completions(),
+		m_chunks(),
+		m_order(0U),
+		m_value(0U),
+		m_stats(),
+		m_mutex()
+	{}
+
+	ResourceStreamer::~ResourceStreamer() noexcept {
+		exit();
+	}
+
+	bool const ResourceStreamer::init(ITransferEngine& engine) noexcept {
+		exit();
+		if (engine.staging() == nullptr || engine.stagingSize() == 0U) {
+			OutputDebugStringA("ERROR : TRANSFER ENGINE HAS NO STAGING MEMORY.\n");
+			return false;
+		}
+
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		if (!m_ring.init(engine.stagingSize())) {
+			return false;
+		}
+		m_engine = &engine;
+		m_value = engine.completed();
+		return true;
+	}
+
+	void ResourceStreamer::exit() noexcept {
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		if (m_engine && m_value > 0U) {
+			//	一時領域は転送器のものなので、積んだコピーが読み終えるまで返せない
+			m_engine->wait(m_value);
+		}
+		m_engine = nullptr;
+		m_ring.exit();
+		m_entries.clear();
+		m_queue.clear();
+		m_waiting.clear();
+		m_completions.clear();
+		m_chunks.clear();
+		m_order = 0U;
+		m_value = 0U;
+		m_stats = {};
+	}
+
+	StreamTicket const ResourceStreamer::request(StreamRequest const& desc) noexcept {
+		bool const texture = desc.type == StreamTarget::Texture;
+		if (!desc.target || desc.read == nullptr ||
+			(texture ? desc.rowSize == 0U || desc.rowCount == 0U : desc.size == 0U))
+		{
+			OutputDebugStringA("ERROR : STREAM REQUEST IS INVALID.\n");
+			return {};
+		}
+
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		if (m_engine == nullptr) {
+			OutputDebugStringA("ERROR : RESOURCE STREAMER IS NOT INITIALIZED.\n");
+			return {};
+		}
+
+		Entry entry = {};
+		entry.desc = desc;
+		entry.order = m_order++;
+		entry.status = StreamStatus::Queued;
+		auto const key = m_entries.insert(entry);
+		if (!key) {
+			return {};
+		}
+		push(key, entry);
+		++m_stats.requests;
+		return StreamTicket::make(key.index(), key.generation());
+	}
+
+	bool const ResourceStreamer::cancel(StreamTicket const& ticket) noexcept {
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		auto const key = SlotMap<Entry>::KeyType::make(ticket.index(), ticket.generation());
+		Entry* const entry = m_entries.get(key);
+		if (entry == nullptr || (entry->status != StreamStatus::Queued && entry->status != StreamStatus::Transferring) || issued(*entry)) {
+			return false;
+		}
+
+		if (entry->status == StreamStatus::Queued) {
+			//	まだ一時領域を使っていないので、すぐに通知できる
+			finish(key, StreamStatus::Canceled);
+			return true;
+		}
+
+		//	積んだコピーは止められないため、その完了を待ってから通知する
+		++entry->version;
+		entry->status = StreamStatus::Canceled;
+		wait(key, *entry);
+		return true;
+	}
+
+	bool const ResourceStreamer::setPriority(StreamTicket const& ticket, unsigned int const& priority) noexcept {
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		auto const key = SlotMap<Entry>::KeyType::make(ticket.index(), ticket.generation());
+		Entry* const entry = m_entries.get(key);
+		if (entry == nullptr || (entry->status != StreamStatus::Queued && entry->status != StreamStatus::Transferring) || issued(*entry)) {
+			return false;
+		}
+
+		//	古い要素はキューに残したまま版数で無効にする
+		++entry->version;
+		entry->desc.priority = priority;
+		push(key, *entry);
+		return true;
+	}
+
+	StreamStatus const ResourceStreamer::status(StreamTicket const& ticket) noexcept {
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		Entry const* const entry = m_entries.get(SlotMap<Entry>::KeyType::make(ticket.index(), ticket.generation()));
+		return entry ? entry->status : StreamStatus::Invalid;
+	}
+
+	size_t const ResourceStreamer::update(unsigned long long const& budget) noexcept {
+		if (m_engine == nullptr) {
+			return 0U;
+		}
+		unsigned long long const completed = m_engine->completed();
+
+		{
+			std::lock_guard<std::mutex> const lock(m_mutex);
+			m_ring.retire(completed);
+
+			//	フェンス値が到達した要求を通知へ回す
+			size_t idx = 0U;
+			while (idx < m_waiting.size()) {
+				Entry* const entry = m_entries.get(m_waiting[idx]);
+				if (entry && (entry->value == STREAM_UNSUBMITTED || entry->value > completed)) {
+					++idx;
+					continue;
+				}
+				if (entry) {
+					finish(m_waiting[idx], entry->status == StreamStatus::Transferring ? StreamStatus::Completed : entry->status);
+				}
+				m_waiting[idx] = m_waiting.back();
+				m_waiting.pop_back();
+			}
+
+			//	優先度の高い順に、予算と一時領域に収まるだけ切り出す
+			m_chunks.clear();
+			unsigned long long remain = budget;
+			while (remain > 0U && !m_queue.empty() && m_ring.closable()) {
+				Node const top = m_queue.front();
+				Entry* const entry = m_entries.get(top.key);
+				if (entry == nullptr || entry->version != top.version || issued(*entry) ||
+					(entry->status != StreamStatus::Queued && entry->status != StreamStatus::Transferring))
+				{
+					std::pop_heap(m_queue.begin(), m_queue.end(), [](Node const& lhs, Node const& rhs) noexcept {
+						return lhs.priority != rhs.priority ? lhs.priority < rhs.priority : lhs.order > rhs.order;
+					});
+					m_queue.pop_back();
+					continue;
+				}
+
+				Chunk chunk = {};
+				if (!plan(top.key, *entry, remain, chunk)) {
+					++m_stats.stalls;
+					break;
+				}
+				if (chunk.copy.size > 0U) {
+					remain -= std::min(chunk.copy.size, remain);
+					m_chunks.push_back(chunk);
+				}
+			}
+		}
+
+		//	読み込みは排他の外で行い、要求の受け付けや完了の取り出しを止めない
+		unsigned char* const staging = m_engine->staging();
+		for (Chunk& chunk : m_chunks) {
+			unsigned char* const dst = staging + chunk.copy.staging;
+			chunk.valid = chunk.read(chunk.context, dst, chunk.source, chunk.bytes);
+			if (chunk.valid && chunk.copy.type == StreamTarget::Texture && chunk.copy.rowPitch != chunk.copy.rowSize) {
+				//	詰めて読んだ行を後ろから行の間隔へ広げる
+				for (unsigned int row = chunk.copy.rows; row-- > 1U;) {
+					std::memmove(dst + static_cast<size_t>(row) * chunk.copy.rowPitch, dst + static_cast<size_t>(row) * chunk.copy.rowSize, chunk.copy.rowSize);
+				}
+			}
+		}
+
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		size_t copies = 0U;
+		for (Chunk& chunk : m_chunks) {
+			Entry* const entry = m_entries.get(chunk.key);
+			if (entry == nullptr) {
+				continue;
+			}
+			if (!chunk.valid && entry->status == StreamStatus::Transferring) {
+				++entry->version;
+				entry->status = StreamStatus::Failed;
+			}
+			chunk.valid = entry->status == StreamStatus::Transferring && m_engine->copy(chunk.copy);
+			if (chunk.valid) {
+				++copies;
+				m_stats.bytes += chunk.copy.size;
+			}
+			else if (entry->status == StreamStatus::Transferring) {
+				++entry->version;
+				entry->status = StreamStatus::Failed;
+			}
+		}
+
+		unsigned long long value = m_value;
+		if (copies > 0U) {
+			value = m_engine->submit();
+			if (value == 0U) {
+				OutputDebugStringA("ERROR : TRANSFER ENGINE SUBMISSION FAILED.\n");
+				value = m_value;
+				for (Chunk const& chunk : m_chunks) {
+					Entry* const entry = m_entries.get(chunk.key);
+					if (entry && entry->status == StreamStatus::Transferring) {
+						++entry->version;
+						entry->status = StreamStatus::Failed;
+					}
+				}
+				copies = 0U;
+			}
+			else {
+				m_value = value;
+				m_stats.copies += copies;
+				++m_stats.submits;
+			}
+		}
+		//	コピーを積まなかった分も、前回の提出が終われば返してよい
+		m_ring.close(value);
+
+		for (Chunk const& chunk : m_chunks) {
+			Entry* const entry = m_entries.get(chunk.key);
+			if (entry == nullptr) {
+				continue;
+			}
+			if (entry->value == STREAM_UNSUBMITTED || entry->value < value) {
+				entry->value = value;
+			}
+			if (issued(*entry) || entry->status != StreamStatus::Transferring) {
+				wait(chunk.key, *entry);
+			}
+		}
+		m_chunks.clear();
+		return copies;
+	}
+
+	void ResourceStreamer::flush() noexcept {
+		while (m_engine) {
+			size_t const before = pending();
+			if (before == 0U) {
+				break;
+			}
+			if (update(~0ULL) > 0U) {
+				continue;
+			}
+
+			unsigned long long value = 0U;
+			{
+				std::lock_guard<std::mutex> const lock(m_mutex);
+				value = m_value;
+			}
+			if (m_engine->completed() < value) {
+				m_engine->wait(value);
+				continue;
+			}
+			//	提出済みのものが全て終わったので、もう一度で通知まで進む
+			update(~0ULL);
+			if (pending() >= before) {
+				//	積めるものも待つものも無いのに残っている
+				OutputDebugStringA("ERROR : RESOURCE STREAMER CAN NOT MAKE PROGRESS.\n");
+				break;
+			}
+		}
+	}
+
+	size_t const ResourceStreamer::poll(StreamCompletion* out, size_t const& capacity) noexcept {
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		size_t const count = std::min(capacity, m_completions.size());
+		if (count == 0U || out == nullptr) {
+			return 0U;
+		}
+		std::copy(m_completions.begin(), m_completions.begin() + count, out);
+		m_completions.erase(m_completions.begin(), m_completions.begin() + count);
+		return count;
+	}
+
+	size_t const ResourceStreamer::pending() noexcept {
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		return m_entries.size();
+	}
+
+	StreamStats const ResourceStreamer::stats() noexcept {
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		return m_stats;
+	}
+
+	bool const ResourceStreamer::issued(Entry const& entry) noexcept {
+		return entry.desc.type == StreamTarget::Texture
+			? entry.cursor >= entry.desc.rowCount
+			: entry.cursor >= entry.desc.size;
+	}
+
+	void ResourceStreamer::push(SlotMap<Entry>::KeyType const& key, Entry const& entry) noexcept {
+		m_queue.push_back({ entry.desc.priority, entry.version, entry.order, key });
+		std::push_heap(m_queue.begin(), m_queue.end(), [](Node const& lhs, Node const& rhs) noexcept {
+			return lhs.priority != rhs.priority ? lhs.priority < rhs.priority : lhs.order > rhs.order;
+		});
+	}
+
+	void ResourceStreamer::finish(SlotMap<Entry>::KeyType const& key, StreamStatus const& status) noexcept {
+		Entry const* const entry = m_entries.get(key);
+		if (entry == nullptr) {
+			return;
+		}
+		switch (status) {
+		case StreamStatus::Completed:
+			++m_stats.completed;
+			break;
+		case StreamStatus::Canceled:
+			++m_stats.canceled;
+			break;
+		default:
+			++m_stats.failed;
+			break;
+		}
+		m_completions.push_back({ StreamTicket::make(key.index(), key.generation()), status, entry->desc.context });
+		m_entries.erase(key);
+	}
+
+	void ResourceStreamer::wait(SlotMap<Entry>::KeyType const& key, Entry& entry) noexcept {
+		if (!entry.waiting) {
+			entry.waiting = true;
+			m_waiting.push_back(key);
+		}
+	}
+
+	bool const ResourceStreamer::plan(SlotMap<Entry>::KeyType const& key, Entry& entry, unsigned long long const& budget, Chunk& chunk) noexcept {
+		StreamRequest const& desc = entry.desc;
+		//	一時領域が小さくても読み込みと転送が重なるよう、一回分は半分までにする
+		unsigned long long const limit = std::min({ budget, STREAM_CHUNK_SIZE, std::max(m_ring.capacity() / 2U, 1ULL) });
+
+		chunk.key = key;
+		chunk.read = desc.read;
+		chunk.context = desc.context;
+		chunk.copy.target = desc.target;
+		chunk.copy.type = desc.type;
+		if (desc.type == StreamTarget::Texture) {
+			//	行は分けずに、少なくとも一行は送る
+			unsigned long long const pitch = align_up(desc.rowSize, m_engine->pitchAlignment());
+			unsigned long long const left = desc.rowCount - entry.cursor;
+			unsigned long long const rows = std::max(1ULL, std::min(left, limit / pitch));
+			chunk.copy.subresource = desc.subresource;
+			chunk.copy.rowSize = desc.rowSize;
+			chunk.copy.rowPitch = static_cast<unsigned int>(pitch);
+			chunk.copy.rows = static_cast<unsigned int>(rows);
+			chunk.copy.offset = entry.cursor;
+			chunk.copy.size = rows * pitch;
+			chunk.source = entry.cursor * desc.rowSize;
+			chunk.bytes = rows * desc.rowSize;
+		}
+		else {
+			unsigned long long const left = desc.size - entry.cursor;
+			chunk.copy.offset = desc.offset + entry.cursor;
+			chunk.copy.size = std::min(left, limit);
+			chunk.source = entry.cursor;
+			chunk.bytes = chunk.copy.size;
+		}
+
+		if (chunk.copy.size > m_ring.capacity()) {
+			//	待っても空かない大きさなので失敗にする
+			OutputDebugStringA("ERROR : STREAM CHUNK EXCEEDS STAGING CAPACITY.\n");
+			++entry.version;
+			entry.status = StreamStatus::Failed;
+			entry.value = entry.value == STREAM_UNSUBMITTED ? m_value : entry.value;
+			wait(key, entry);
+			chunk.copy.size = 0U;
+			return true;
+		}
+		chunk.copy.staging = m_ring.allocate(chunk.copy.size, m_engine->placementAlignment());
+		if (chunk.copy.staging == STAGING_INVALID) {
+			return false;
+		}
+
+		entry.cursor += desc.type == StreamTarget::Texture ? chunk.copy.rows : chunk.copy.size;
+		entry.status = StreamStatus::Transferring;
+		entry.value = STREAM_UNSUBMITTED;
+		return true;
+	}
+}
@@ -0,0 +1,235 @@
+﻿/**	@file	dlph_transfer_sim.cpp
+ *	@brief	GPU を使わない転送器
+ */
+#include "dlph/dlph_transfer_sim.hpp"
+#include <chrono>
+#include <cstring>
+
+namespace {
+	using namespace dlph;
+
+	//!	@brief	リソースのハンドルからスロットマップのキーへの変換
+	inline SlotMap<SimulatedTarget>::KeyType const toKey(RenderResource const& handle) noexcept {
+		return SlotMap<SimulatedTarget>::KeyType::make(handle.index(), handle.generation());
+	}
+
+	//!	@brief	コピーが転送先に収まるかどうか
+	bool const fits(StreamCopy const& copy, SimulatedTarget const& target) noexcept {
+		if (copy.type == StreamTarget::Buffer) {
+			return copy.offset <= target.size && copy.size <= target.size - copy.offset;
+		}
+		if (copy.rows == 0U || copy.rowSize > target.rowPitch) {
+			return false;
+		}
+		unsigned long long const last = copy.subresource * target.slicePitch + (copy.offset + copy.rows - 1U) * target.rowPitch + copy.rowSize;
+		return last <= target.size;
+	}
+}
+
+namespace dlph {
+	SimulatedTransferEngine::SimulatedTransferEngine() noexcept :
+		ITransferEngine(),
+		m_staging(),
+		m_size(0U),
+		m_bandwidth(0U),
+		m_latency(0U),
+		m_pitch(1U),
+		m_placement(1U),
+		m_targets(),
+		m_recorded(),
+		m_submitted(),
+		m_value(0U),
+		m_completed(0U),
+		m_transferred(0U),
+		m_worker(),
+		m_mutex(),
+		m_submit(),
+		m_finish(),
+		m_quit(false)
+	{}
+
+	SimulatedTransferEngine::~SimulatedTransferEngine() noexcept {
+		exit();
+	}
+
+	bool const SimulatedTransferEngine::init(unsigned long long const& staging, unsigned long long const& bandwidth, unsigned int const& latency,
+		unsigned long long const& pitch, unsigned long long const& placement) noexcept
+	{
+		exit();
+		if (staging == 0U || pitch == 0U || placement == 0U || (pitch & (pitch - 1U)) != 0U || (placement & (placement - 1U)) != 0U) {
+			OutputDebugStringA("ERROR : SIMULATED TRANSFER ENGINE SETTING IS INVALID.\n");
+			return false;
+		}
+
+		m_staging.reset(new (std::nothrow) unsigned char[static_cast<size_t>(staging)]);
+		if (!m_staging) {
+			OutputDebugStringA("ERROR : ALLOCATE FAILED STAGING MEMORY.\n");
+			return false;
+		}
+		m_size = staging;
+		m_bandwidth = bandwidth;
+		m_latency = latency;
+		m_pitch = pitch;
+		m_placement = placement;
+		m_quit = false;
+		m_worker = std::thread(&SimulatedTransferEngine::run, this);
+		return true;
+	}
+
+	void SimulatedTransferEngine::exit() noexcept {
+		if (m_worker.joinable()) {
+			{
+				std::lock_guard<std::mutex> const lock(m_mutex);
+				m_quit = true;
+			}
+			m_submit.notify_all();
+			m_worker.join();
+		}
+		m_staging.reset();
+		m_size = 0U;
+		m_targets.clear();
+		m_recorded.clear();
+		m_submitted.clear();
+		m_value = 0U;
+		m_completed.store(0U);
+		m_transferred.store(0U);
+	}
+
+	RenderResource const SimulatedTransferEngine::registerTarget(SimulatedTarget const& target) noexcept {
+		if (target.memory == nullptr || target.size == 0U) {
+			return {};
+		}
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		auto const key = m_targets.insert(target);
+		return RenderResource::make(key.index(), key.generation());
+	}
+
+	void SimulatedTransferEngine::unregisterTarget(RenderResource const& handle) noexcept {
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		m_targets.erase(toKey(handle));
+	}
+
+	unsigned char* const SimulatedTransferEngine::staging() noexcept {
+		return m_staging.get();
+	}
+
+	unsigned long long const SimulatedTransferEngine::stagingSize() const noexcept {
+		return m_size;
+	}
+
+	unsigned long long const SimulatedTransferEngine::placementAlignment() const noexcept {
+		return m_placement;
+	}
+
+	unsigned long long const SimulatedTransferEngine::pitchAlignment() const noexcept {
+		return m_pitch;
+	}
+
+	bool const SimulatedTransferEngine::copy(StreamCopy const& copy) noexcept {
+		if (copy.staging > m_size || copy.size > m_size - copy.staging) {
+			OutputDebugStringA("ERROR : COPY SOURCE EXCEEDS STAGING MEMORY.\n");
+			return false;
+		}
+
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		SimulatedTarget const* const target = m_targets.get(toKey(copy.target));
+		if (target == nullptr || !fits(copy, *target)) {
+			OutputDebugStringA("ERROR : COPY DESTINATION IS INVALID.\n");
+			return false;
+		}
+		//	登録を外されても転送が終わるまで書けるよう、転送先は積んだ時点の内容を持っておく
+		m_recorded.push_back({ copy, *target, 0U });
+		return true;
+	}
+
+	unsigned long long const SimulatedTransferEngine::submit() noexcept {
+		unsigned long long value = 0U;
+		{
+			std::lock_guard<std::mutex> const lock(m_mutex);
+			if (!m_worker.joinable()) {
+				return 0U;
+			}
+			value = ++m_value;
+			for (Record& record : m_recorded) {
+				record.value = value;
+				m_submitted.push_back(record);
+			}
+			m_recorded.clear();
+		}
+		m_submit.notify_one();
+		return value;
+	}
+
+	unsigned long long const SimulatedTransferEngine::completed() noexcept {
+		return m_completed.load(std::memory_order_acquire);
+	}
+
+	void SimulatedTransferEngine::wait(unsigned long long const& value) noexcept {
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_finish.wait(lock, [this, &value]() noexcept {
+			return m_completed.load(std::memory_order_acquire) >= value || value > m_value;
+		});
+	}
+
+	unsigned long long const SimulatedTransferEngine::transferred() const noexcept {
+		return m_transferred.load();
+	}
+
+	void SimulatedTransferEngine::run() noexcept {
+		std::vector<Record> batch;
+		std::unique_lock<std::mutex> lock(m_mutex);
+		for (;;) {
+			m_submit.wait(lock, [this]() noexcept {
+				return m_quit || !m_submitted.empty() || m_completed.load() < m_value;
+			});
+			if (m_submitted.empty()) {
+				if (m_completed.load() < m_value) {
+					//	コピーの無い提出はすぐに到達させる
+					m_completed.store(m_value, std::memory_order_release);
+					m_finish.notify_all();
+					continue;
+				}
+				break;
+			}
+
+			//	同じフェンス値で提出したものを一度に取り出す
+			unsigned long long const value = m_submitted.front().value;
+			size_t count = 0U;
+			while (count < m_submitted.size() && m_submitted[count].value == value) {
+				++count;
+			}
+			batch.assign(m_submitted.begin(), m_submitted.begin() + count);
+			m_submitted.erase(m_submitted.begin(), m_submitted.begin() + count);
+			lock.unlock();
+
+			auto const start = std::chrono::steady_clock::now();
+			unsigned long long bytes = 0U;
+			for (Record const& record : batch) {
+				StreamCopy const& copy = record.copy;
+				unsigned char const* const src = m_staging.get() + copy.staging;
+				if (copy.type == StreamTarget::Buffer) {
+					std::memcpy(record.target.memory + copy.offset, src, static_cast<size_t>(copy.size));
+					bytes += copy.size;
+					continue;
+				}
+				unsigned char* const dst = record.target.memory + copy.subresource * record.target.slicePitch + copy.offset * record.target.rowPitch;
+				for (unsigned int row = 0U; row < copy.rows; ++row) {
+					std::memcpy(dst + row * record.target.rowPitch, src + static_cast<size_t>(row) * copy.rowPitch, copy.rowSize);
+				}
+				bytes += static_cast<unsigned long long>(copy.rows) * copy.rowSize;
+			}
+			m_transferred.fetch_add(bytes);
+
+			//	遅延と帯域の分だけ完了を遅らせる
+			unsigned long long duration = m_latency;
+			if (m_bandwidth > 0U) {
+				duration += bytes * 1000000ULL / m_bandwidth;
+			}
+			std::this_thread::sleep_until(start + std::chrono::microseconds(duration));
+
+			lock.lock();
+			m_completed.store(value, std::memory_order_release);
+			m_finish.notify_all();
+		}
+	}
+}
@@ -0,0 +1,157 @@
+﻿/**	@file	ecs_archetype.cpp
+ *	@brief	アーキタイプ
+ */
+#include "ecs/ecs_archetype.hpp"
+#include <crtdbg.h>
+#include <new>
+
+namespace {
+	using namespace dlph;
+
+	/**	@brief	切り上げ関数
+	 *	@param[in] value 値
+	 *	@param[in] alignment アライメント (2 のべき乗)
+	 */
+	size_t const alignUp(size_t const& value, size_t const& alignment) noexcept {
+		return (value + alignment - 1U) & ~(alignment - 1U);
+	}
+}
+
+namespace dlph {
+	Archetype::Archetype() noexcept :
+		INonmovable(),
+		m_mask(0U),
+		m_types(),
+		m_offsets(),
+		m_rows(0U),
+		m_size(0U),
+		m_chunks()
+	{}
+
+	Archetype::~Archetype() noexcept {
+		exit();
+	}
+
+	bool const Archetype::init(ComponentMask const& mask) noexcept {
+		exit();
+
+		size_t stride = sizeof(Entity);
+		for (unsigned int type = 0U; type < COMPONENT_MAX; ++type) {
+			m_offsets[type] = CHUNK_SIZE;
+			if (mask & (static_cast<ComponentMask>(1U) << type)) {
+				m_types.push_back(type);
+				stride += componentInfo(type).size;
+			}
+		}
+
+		//	各配列の先頭をキャッシュライン境界へ揃えた分だけ行数を減らす
+		for (m_rows = CHUNK_SIZE / stride; m_rows > 0U; --m_rows) {
+			size_t offset = sizeof(Entity) * m_rows;
+			for (unsigned int const& type : m_types) {
+				ComponentInfo const& info = componentInfo(type);
+				offset = alignUp(offset, info.alignment > CHUNK_ALIGNMENT ? info.alignment : CHUNK_ALIGNMENT);
+				m_offsets[type] = offset;
+				offset += info.size * m_rows;
+			}
+			if (offset <= CHUNK_SIZE) {
+				break;
+			}
+		}
+		if (m_rows == 0U) {
+			OutputDebugStringA("ERROR : COMPONENTS DO NOT FIT IN A CHUNK.\n");
+			m_types.clear();
+			return false;
+		}
+
+		m_mask = mask;
+		return true;
+	}
+
+	void Archetype::exit() noexcept {
+		while (m_size > 0U) {
+			remove(m_size - 1U);
+		}
+		for (unsigned char* const& chunk : m_chunks) {
+			::operator delete(chunk, std::align_val_t(CHUNK_ALIGNMENT), std::nothrow);
+		}
+		m_chunks.clear();
+		m_types.clear();
+		m_mask = 0U;
+		m_rows = 0U;
+	}
+
+	size_t const Archetype::push(Entity const& entity) noexcept {
+		size_t const row = m_size;
+		size_t const idx = row / m_rows;
+		if (idx == m_chunks.size()) {
+			unsigned char* const chunk = static_cast<unsigned char*>(::operator new(CHUNK_SIZE, std::align_val_t(CHUNK_ALIGNMENT), std::nothrow));
+			if (chunk == nullptr) {
+				OutputDebugStringA("ERROR : ARCHETYPE CHUNK ALLOCATION FAILED.\n");
+				return ARCHETYPE_ROW_INVALID;
+			}
+			m_chunks.push_back(chunk);
+		}
+		reinterpret_cast<Entity*>(m_chunks[idx])[row % m_rows] = entity;
+		++m_size;
+		return row;
+	}
+
+	Entity const Archetype::remove(size_t const& row) noexcept {
+#if	defined(_DEBUG) || defined(DEBUG)
+		_ASSERT_EXPR(row < m_size, L"ERROR : ARCHETYPE ROW OUT OF RANGE.");
+#endif
+		size_t const last = m_size - 1U;
+		unsigned char* const dst = m_chunks[row / m_rows];
+		unsigned char* const src = m_chunks[last / m_rows];
+		size_t const dstRow = row % m_rows;
+		size_t const srcRow = last % m_rows;
+
+		for (unsigned int const& type : m_types) {
+			ComponentInfo const& info = componentInfo(type);
+			void* const ptr = dst + m_offsets[type] + info.size * dstRow;
+			info.destruct(ptr);
+			if (row != last) {
+				void* const from = src + m_offsets[type] + info.size * srcRow;
+				info.move(ptr, from);
+				info.destruct(from);
+			}
+		}
+
+		--m_size;
+		if (row == last) {
+			return {};
+		}
+		Entity const moved = reinterpret_cast<Entity*>(src)[srcRow];
+		reinterpret_cast<Entity*>(dst)[dstRow] = moved;
+		return moved;
+	}
+
+	void* const Archetype::component(unsigned int const& type, size_t const& row) noexcept {
+		if (m_offsets[type] >= CHUNK_SIZE) {
+			return nullptr;
+		}
+		return m_chunks[row / m_rows] + m_offsets[type] + componentInfo(type).size * (row % m_rows);
+	}
+
+	ComponentMask const Archetype::mask() const noexcept {
+		return m_mask;
+	}
+
+	size_t const Archetype::size() const noexcept {
+		return m_size;
+	}
+
+	size_t const Archetype::rows() const noexcept {
+		return m_rows;
+	}
+
+	size_t const Archetype::chunkCount() const noexcept {
+		return (m_size + m_rows - 1U) / m_rows;
+	}
+
+	ChunkView const Archetype::chunk(size_t const& idx) noexcept {
+		size_t const begin = idx * m_rows;
+		size_t const count = m_size - begin < m_rows ? m_size - begin : m_rows;
+		return { m_chunks[idx], m_offsets, count };
+	}
+}
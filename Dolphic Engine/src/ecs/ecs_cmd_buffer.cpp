@@ -0,0 +1,50 @@
+﻿/**	@file	ecs_cmd_buffer.cpp
+ *	@brief	ECS コマンドバッファ
+ */
+#include "ecs/ecs_cmd_buffer.hpp"
+
+namespace dlph {
+	EntityCommandBuffer::EntityCommandBuffer() noexcept :
+		INonmovable(),
+		m_arena(),
+		m_commands(),
+		m_mutex()
+	{}
+
+	EntityCommandBuffer::~EntityCommandBuffer() noexcept {
+		exit();
+	}
+
+	bool const EntityCommandBuffer::init(size_t const& capacity) noexcept {
+		exit();
+		return m_arena.init(capacity);
+	}
+
+	void EntityCommandBuffer::exit() noexcept {
+		clear();
+		m_arena.exit();
+	}
+
+	void EntityCommandBuffer::flush(World& world) noexcept {
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		for (Command* const& command : m_commands) {
+			command->apply(world);
+			command->~Command();
+		}
+		m_commands.clear();
+		m_arena.reset();
+	}
+
+	void EntityCommandBuffer::clear() noexcept {
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		for (Command* const& command : m_commands) {
+			command->~Command();
+		}
+		m_commands.clear();
+		m_arena.reset();
+	}
+
+	size_t const EntityCommandBuffer::size() const noexcept {
+		return m_commands.size();
+	}
+}
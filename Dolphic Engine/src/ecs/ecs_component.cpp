@@ -0,0 +1,39 @@
+﻿/**	@file	ecs_component.cpp
+ *	@brief	ECS の基本型
+ */
+#include "ecs/ecs_component.hpp"
+#include <crtdbg.h>
+#include <cstdlib>
+#include <mutex>
+
+namespace {
+	//!	@brief	登録済みの型の情報
+	dlph::ComponentInfo g_infos[dlph::COMPONENT_MAX] = {};
+	//!	@brief	登録済みの型の数
+	unsigned int g_count = 0U;
+	//!	@brief	登録の排他
+	std::mutex g_mutex;
+}
+
+namespace dlph {
+	unsigned int const registerComponent(ComponentInfo const& info) noexcept {
+		std::lock_guard<std::mutex> const lock(g_mutex);
+		//	COMPONENT_MAX 個目以降の型はマスクのビットもオフセットの枠も無いため、続行させない
+		if (g_count >= COMPONENT_MAX) {
+			OutputDebugStringA("ERROR : COMPONENT TYPE COUNT EXCEEDED.\n");
+#if	defined(_DEBUG) || defined(DEBUG)
+			_ASSERT_EXPR(false, L"ERROR : COMPONENT TYPE COUNT EXCEEDED.");
+#endif
+			std::abort();
+		}
+		g_infos[g_count] = info;
+		return g_count++;
+	}
+
+	ComponentInfo const& componentInfo(unsigned int const& type) noexcept {
+#if	defined(_DEBUG) || defined(DEBUG)
+		_ASSERT_EXPR(type < g_count, L"ERROR : UNREGISTERED COMPONENT TYPE.");
+#endif
+		return g_infos[type];
+	}
+}
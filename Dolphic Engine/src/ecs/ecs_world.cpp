@@ -0,0 +1,166 @@
+﻿/**	@file	ecs_world.cpp
+ *	@brief	ECS ワールド
+ */
+#include "ecs/ecs_world.hpp"
+
+namespace dlph {
+	World::World() noexcept :
+		INonmovable(),
+		m_records(),
+		m_free(RECORD_END),
+		m_size(0U),
+		m_archetypes(),
+		m_order()
+	{}
+
+	World::~World() noexcept {
+		exit();
+	}
+
+	bool const World::init() noexcept {
+		exit();
+		return archetype(0U) != nullptr;
+	}
+
+	void World::exit() noexcept {
+		m_order.clear();
+		m_archetypes.clear();
+		m_records.clear();
+		m_free = RECORD_END;
+		m_size = 0U;
+	}
+
+	Entity const World::create() noexcept {
+		return allocate(0U);
+	}
+
+	bool const World::destroy(Entity const& entity) noexcept {
+		if (!alive(entity)) {
+			return false;
+		}
+
+		size_t const slot = entity.index();
+		Record& record = m_records[slot];
+		Entity const moved = record.archetype->remove(record.row);
+		if (moved) {
+			m_records[moved.index()].row = record.row;
+		}
+
+		record.archetype = nullptr;
+		record.row = m_free;
+		record.generation = (record.generation + 1U) & Entity::GENERATION_MASK;
+		m_free = slot;
+		--m_size;
+		return true;
+	}
+
+	bool const World::alive(Entity const& entity) const noexcept {
+		size_t const slot = entity.index();
+		return entity && slot < m_records.size() && m_records[slot].generation == entity.generation();
+	}
+
+	size_t const World::size() const noexcept {
+		return m_size;
+	}
+
+	size_t const World::archetypeCount() const noexcept {
+		return m_order.size();
+	}
+
+	Archetype* const World::archetype(ComponentMask const& mask) noexcept {
+		auto const it = m_archetypes.find(mask);
+		if (it != m_archetypes.end()) {
+			return it->second.get();
+		}
+
+		std::unique_ptr<Archetype> type(new Archetype());
+		if (!type->init(mask)) {
+			return nullptr;
+		}
+		m_order.push_back(type.get());
+		return m_archetypes.emplace(mask, std::move(type)).first->second.get();
+	}
+
+	Entity const World::allocate(ComponentMask const& mask) noexcept {
+		Archetype* const type = archetype(mask);
+		if (type == nullptr) {
+			return {};
+		}
+
+		size_t slot = m_free;
+		if (slot != RECORD_END) {
+			m_free = m_records[slot].row;
+		}
+		else if (m_records.size() < RECORD_END) {
+			slot = m_records.size();
+			m_records.push_back({ nullptr, 0U, 0U });
+		}
+		else {
+			OutputDebugStringA("ERROR : ENTITY COUNT EXCEEDED HANDLE INDEX RANGE.\n");
+			return {};
+		}
+
+		Record& record = m_records[slot];
+		record.generation = (record.generation + 1U) & Entity::GENERATION_MASK;
+		Entity const entity = Entity::make(static_cast<unsigned int>(slot), record.generation);
+		size_t const row = type->push(entity);
+		if (row == ARCHETYPE_ROW_INVALID) {
+			record.archetype = nullptr;
+			record.row = m_free;
+			m_free = slot;
+			return {};
+		}
+		record.archetype = type;
+		record.row = row;
+		++m_size;
+		return entity;
+	}
+
+	bool const World::migrate(Entity const& entity, ComponentMask const& mask) noexcept {
+		Record& record = m_records[entity.index()];
+		Archetype* const source = record.archetype;
+		Archetype* const target = archetype(mask);
+		if (target == nullptr) {
+			return false;
+		}
+		if (target == source) {
+			return true;
+		}
+
+		size_t const row = target->push(entity);
+		if (row == ARCHETYPE_ROW_INVALID) {
+			return false;
+		}
+		ComponentMask const common = source->mask() & mask;
+		for (unsigned int type = 0U; type < COMPONENT_MAX; ++type) {
+			if (common & (static_cast<ComponentMask>(1U) << type)) {
+				componentInfo(type).move(target->component(type, row), source->component(type, record.row));
+			}
+		}
+
+		//	移し終えた元の行は破棄され、末尾の行で埋められる
+		Entity const moved = source->remove(record.row);
+		if (moved) {
+			m_records[moved.index()].row = record.row;
+		}
+		record.archetype = target;
+		record.row = row;
+		return true;
+	}
+
+	void* const World::component(Entity const& entity, unsigned int const& type) noexcept {
+		Record const& record = m_records[entity.index()];
+		return record.archetype->component(type, record.row);
+	}
+
+	void World::gather(ComponentMask const& mask, std::vector<ChunkView>& chunks) noexcept {
+		for (Archetype* const& type : m_order) {
+			if ((type->mask() & mask) != mask) {
+				continue;
+			}
+			for (size_t idx = 0U, cnt = type->chunkCount(); idx < cnt; ++idx) {
+				chunks.push_back(type->chunk(idx));
+			}
+		}
+	}
+}
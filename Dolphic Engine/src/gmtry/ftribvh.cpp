@@ -0,0 +1,409 @@
+﻿/**	@file	ftribvh.cpp
+ *	@brief	三角形の境界ボリューム階層クラス
+ */
+#include "gmtry/ftribvh.hpp"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace {
+	using namespace dlph;
+
+	//!	@brief	面積ヒューリスティックを諦めて中央で分割する深さ
+	static unsigned int constexpr BVH_MEDIAN_DEPTH = 48U;
+	//!	@brief	面積ヒューリスティックで葉にできる最大三角形数
+	static unsigned int constexpr BVH_SAH_LEAF_MAX = 8U;
+
+	/**	@struct	Bounds
+	 *	@brief	構築用の軸平行境界箱
+	 */
+	struct Bounds final {
+		//!	@brief	最小点
+		Float3 lower;
+		//!	@brief	最大点
+		Float3 upper;
+
+		//!	@brief	コンストラクタ (空の箱)
+		Bounds() noexcept :
+			lower(FLT_MAX, FLT_MAX, FLT_MAX),
+			upper(-FLT_MAX, -FLT_MAX, -FLT_MAX)
+		{}
+
+		//!	@brief	点の追加関数
+		void grow(Float3 const& point) noexcept {
+			for (unsigned int axis = 0U; axis < T3_CNT; ++axis) {
+				lower.p[axis] = fminf(lower.p[axis], point.p[axis]);
+				upper.p[axis] = fmaxf(upper.p[axis], point.p[axis]);
+			}
+		}
+
+		//!	@brief	箱の追加関数
+		void grow(Bounds const& other) noexcept {
+			grow(other.lower);
+			grow(other.upper);
+		}
+
+		//!	@brief	表面積の半分取得関数
+		float const area() const noexcept {
+			float const dx = upper.x - lower.x, dy = upper.y - lower.y, dz = upper.z - lower.z;
+			return dx < 0.0f ? 0.0f : dx * dy + dy * dz + dz * dx;
+		}
+	};
+
+	/**	@class	BvhBuilder
+	 *	@brief	境界ボリューム階層構築処理クラス
+	 */
+	class BvhBuilder final {
+	public	:
+		//!	@brief	コンストラクタ
+		BvhBuilder(std::vector<BvhNode>& nodes, std::vector<Bounds> const& bounds, std::vector<Float3> const& centroids, std::vector<unsigned int>& order) noexcept :
+			m_nodes(nodes),
+			m_bounds(bounds),
+			m_centroids(centroids),
+			m_order(order)
+		{}
+
+		//!	@brief	節点生成関数
+		void build(unsigned int const& begin, unsigned int const& end, unsigned int const& depth) noexcept;
+
+	private	:
+		//!	@brief	節点配列
+		std::vector<BvhNode>& m_nodes;
+		//!	@brief	三角形ごとの境界箱
+		std::vector<Bounds> const& m_bounds;
+		//!	@brief	三角形ごとの重心
+		std::vector<Float3> const& m_centroids;
+		//!	@brief	三角形の並び
+		std::vector<unsigned int>& m_order;
+	};
+
+	void BvhBuilder::build(unsigned int const& begin, unsigned int const& end, unsigned int const& depth) noexcept {
+		unsigned int const index = static_cast<unsigned int>(m_nodes.size());
+		m_nodes.push_back(BvhNode());
+
+		Bounds box, centers;
+		for (unsigned int idx = begin; idx < end; ++idx) {
+			box.grow(m_bounds[m_order[idx]]);
+			centers.grow(m_centroids[m_order[idx]]);
+		}
+		m_nodes[index].lower = box.lower;
+		m_nodes[index].upper = box.upper;
+
+		unsigned int const count = end - begin;
+		auto const leaf = [&]() {
+			m_nodes[index].offset = begin;
+			m_nodes[index].count = static_cast<unsigned short>(count);
+			m_nodes[index].axis = 0U;
+		};
+		if (count <= BVH_LEAF_MAX) {
+			leaf();
+			return;
+		}
+
+		//	重心の広がりが最も大きい軸
+		unsigned int axis = 0U;
+		for (unsigned int a = 1U; a < T3_CNT; ++a) {
+			if (centers.upper.p[a] - centers.lower.p[a] > centers.upper.p[axis] - centers.lower.p[axis]) {
+				axis = a;
+			}
+		}
+
+		unsigned int mid = begin + count / 2U;
+		float const extent = centers.upper.p[axis] - centers.lower.p[axis];
+		bool split = false;
+		if (depth < BVH_MEDIAN_DEPTH && extent > 0.0f) {
+			//	重心を等間隔のビンへ振り分け、境界ごとの費用を比べる
+			Bounds bins[BVH_BIN_CNT];
+			unsigned int counts[BVH_BIN_CNT] = {};
+			float const scale = static_cast<float>(BVH_BIN_CNT) / extent;
+			auto const binOf = [&](unsigned int const& tri) {
+				unsigned int const bin = static_cast<unsigned int>((m_centroids[tri].p[axis] - centers.lower.p[axis]) * scale);
+				return bin < BVH_BIN_CNT ? bin : BVH_BIN_CNT - 1U;
+			};
+			for (unsigned int idx = begin; idx < end; ++idx) {
+				unsigned int const bin = binOf(m_order[idx]);
+				bins[bin].grow(m_bounds[m_order[idx]]);
+				++counts[bin];
+			}
+
+			float rightArea[BVH_BIN_CNT] = {};
+			unsigned int rightCount[BVH_BIN_CNT] = {};
+			Bounds acc;
+			unsigned int sum = 0U;
+			for (unsigned int bin = BVH_BIN_CNT - 1U; bin > 0U; --bin) {
+				acc.grow(bins[bin]);
+				sum += counts[bin];
+				rightArea[bin] = acc.area();
+				rightCount[bin] = sum;
+			}
+
+			float best = FLT_MAX;
+			unsigned int bestBin = 0U;
+			acc = Bounds();
+			sum = 0U;
+			for (unsigned int bin = 1U; bin < BVH_BIN_CNT; ++bin) {
+				acc.grow(bins[bin - 1U]);
+				sum += counts[bin - 1U];
+				if (sum == 0U || rightCount[bin] == 0U) {
+					continue;
+				}
+				float const cost = acc.area() * static_cast<float>(sum) + rightArea[bin] * static_cast<float>(rightCount[bin]);
+				if (cost < best) {
+					best = cost;
+					bestBin = bin;
+				}
+			}
+
+			//	分割しても交差判定が減らないなら葉にする (走査の費用を三角形一つ分とみなす)
+			float const leafCost = box.area() * static_cast<float>(count);
+			if (bestBin > 0U && (best + box.area() < leafCost || count > BVH_SAH_LEAF_MAX)) {
+				mid = static_cast<unsigned int>(std::partition(m_order.begin() + begin, m_order.begin() + end, [&](unsigned int const& tri) {
+					return binOf(tri) < bestBin;
+				}) - m_order.begin());
+				split = true;
+			}
+			else if (count <= BVH_SAH_LEAF_MAX) {
+				leaf();
+				return;
+			}
+		}
+
+		if (!split) {
+			std::nth_element(m_order.begin() + begin, m_order.begin() + mid, m_order.begin() + end, [&](unsigned int const& lhs, unsigned int const& rhs) {
+				return m_centroids[lhs].p[axis] < m_centroids[rhs].p[axis];
+			});
+		}
+
+		m_nodes[index].count = 0U;
+		m_nodes[index].axis = static_cast<unsigned short>(axis);
+		build(begin, mid, depth + 1U);
+		m_nodes[index].offset = static_cast<unsigned int>(m_nodes.size());
+		build(mid, end, depth + 1U);
+	}
+
+	/**	@struct	StreamRay
+	 *	@brief	光線列の走査用に前計算した光線
+	 */
+	struct StreamRay final {
+		//!	@brief	始点
+		Float3 origin;
+		//!	@brief	方向
+		Float3 direct;
+		//!	@brief	方向の逆数
+		Float3 inverse;
+		//!	@brief	最近交差距離
+		float limit;
+		//!	@brief	判定を終えたかどうか
+		bool done;
+	};
+
+	//!	@brief	箱交差判定関数
+	inline bool const hitBox(StreamRay const& ray, BvhNode const& node) noexcept {
+		float enter = 0.0f, leave = ray.limit;
+		for (unsigned int axis = 0U; axis < T3_CNT; ++axis) {
+			float const t0 = (node.lower.p[axis] - ray.origin.p[axis]) * ray.inverse.p[axis];
+			float const t1 = (node.upper.p[axis] - ray.origin.p[axis]) * ray.inverse.p[axis];
+			float const lo = t0 < t1 ? t0 : t1;
+			float const hi = t0 < t1 ? t1 : t0;
+			enter = enter > lo ? enter : lo;
+			leave = leave < hi ? leave : hi;
+		}
+		return enter <= leave;
+	}
+
+	//!	@brief	三角形交差判定関数 (Möller-Trumbore 法)
+	inline bool const hitTriangle(StreamRay const& ray, Float3 const* tri, float& t, float& u, float& v) noexcept {
+		float const e1x = tri[1U].x - tri[0U].x, e1y = tri[1U].y - tri[0U].y, e1z = tri[1U].z - tri[0U].z;
+		float const e2x = tri[2U].x - tri[0U].x, e2y = tri[2U].y - tri[0U].y, e2z = tri[2U].z - tri[0U].z;
+		float const px = ray.direct.y * e2z - ray.direct.z * e2y;
+		float const py = ray.direct.z * e2x - ray.direct.x * e2z;
+		float const pz = ray.direct.x * e2y - ray.direct.y * e2x;
+		float const det = e1x * px + e1y * py + e1z * pz;
+		if (det == 0.0f) {
+			return false;
+		}
+		float const inv = 1.0f / det;
+		float const tx = ray.origin.x - tri[0U].x, ty = ray.origin.y - tri[0U].y, tz = ray.origin.z - tri[0U].z;
+		u = (tx * px + ty * py + tz * pz) * inv;
+		if (u < 0.0f || u > 1.0f) {
+			return false;
+		}
+		float const qx = ty * e1z - tz * e1y, qy = tz * e1x - tx * e1z, qz = tx * e1y - ty * e1x;
+		v = (ray.direct.x * qx + ray.direct.y * qy + ray.direct.z * qz) * inv;
+		if (v < 0.0f || u + v > 1.0f) {
+			return false;
+		}
+		t = (e2x * qx + e2y * qy + e2z * qz) * inv;
+		return t >= 0.0f && t < ray.limit;
+	}
+
+	/**	@struct	StreamEntry
+	 *	@brief	光線列の走査スタックの要素
+	 */
+	struct StreamEntry final {
+		//!	@brief	節点番号
+		unsigned int node;
+		//!	@brief	光線番号列の開始位置
+		size_t begin;
+		//!	@brief	光線番号列の終了位置
+		size_t end;
+	};
+}
+
+namespace dlph {
+	FTriangleBvh::FTriangleBvh() noexcept :
+		m_nodes(),
+		m_triangles(),
+		m_primitives()
+	{}
+
+	bool const FTriangleBvh::init(Float3 const* positions, unsigned int const* indices, size_t const& index_count) noexcept {
+		exit();
+		size_t const count = index_count / T3_CNT;
+		if (positions == nullptr || indices == nullptr || count == 0U) {
+			return false;
+		}
+
+		std::vector<Bounds> bounds(count);
+		std::vector<Float3> centroids(count);
+		std::vector<unsigned int> order(count);
+		for (size_t tri = 0U; tri < count; ++tri) {
+			for (unsigned int k = 0U; k < T3_CNT; ++k) {
+				bounds[tri].grow(positions[indices[tri * T3_CNT + k]]);
+			}
+			for (unsigned int axis = 0U; axis < T3_CNT; ++axis) {
+				centroids[tri].p[axis] = (bounds[tri].lower.p[axis] + bounds[tri].upper.p[axis]) * 0.5f;
+			}
+			order[tri] = static_cast<unsigned int>(tri);
+		}
+
+		m_nodes.reserve(count * 2U);
+		BvhBuilder(m_nodes, bounds, centroids, order).build(0U, static_cast<unsigned int>(count), 0U);
+
+		//	葉から連続して読めるよう三角形を並べ替えて持つ
+		m_triangles.resize(count * T3_CNT);
+		m_primitives.resize(count);
+		for (size_t idx = 0U; idx < count; ++idx) {
+			unsigned int const tri = order[idx];
+			for (unsigned int k = 0U; k < T3_CNT; ++k) {
+				m_triangles[idx * T3_CNT + k] = positions[indices[tri * T3_CNT + k]];
+			}
+			m_primitives[idx] = tri;
+		}
+		return true;
+	}
+
+	void FTriangleBvh::exit() noexcept {
+		m_nodes.clear();
+		m_triangles.clear();
+		m_primitives.clear();
+	}
+
+	void FTriangleBvh::intersect(FRay<FVector3> const* rays, size_t const& count, RayHit* hits) const noexcept {
+		traverse(rays, count, hits, nullptr);
+	}
+
+	void FTriangleBvh::occluded(FRay<FVector3> const* rays, size_t const& count, bool* results) const noexcept {
+		traverse(rays, count, nullptr, results);
+	}
+
+	std::vector<BvhNode> const& FTriangleBvh::nodes() const noexcept {
+		return m_nodes;
+	}
+
+	size_t const FTriangleBvh::triangleCount() const noexcept {
+		return m_primitives.size();
+	}
+
+	void FTriangleBvh::traverse(FRay<FVector3> const* rays, size_t const& count, RayHit* hits, bool* results) const noexcept {
+		if (rays == nullptr || count == 0U) {
+			return;
+		}
+
+		thread_local std::vector<StreamRay> stream;
+		thread_local std::vector<unsigned int> ids;
+		thread_local std::vector<StreamEntry> stack;
+		stream.resize(count);
+		ids.clear();
+		stack.clear();
+
+		for (size_t idx = 0U; idx < count; ++idx) {
+			StreamRay& ray = stream[idx];
+			ray.origin = rays[idx].center();
+			ray.direct = rays[idx].direction();
+			for (unsigned int axis = 0U; axis < T3_CNT; ++axis) {
+				float const d = ray.direct.p[axis];
+				ray.inverse.p[axis] = fabsf(d) > 1.0e-20f ? 1.0f / d : copysignf(1.0e20f, d);
+			}
+			ray.limit = rays[idx].radius() > 0.0f ? rays[idx].radius() : FLT_MAX;
+			ray.done = false;
+			if (hits != nullptr) {
+				hits[idx].distance = ray.limit;
+				hits[idx].u = 0.0f;
+				hits[idx].v = 0.0f;
+				hits[idx].primitive = RAY_MISS;
+			}
+			if (results != nullptr) {
+				results[idx] = false;
+			}
+			ids.push_back(static_cast<unsigned int>(idx));
+		}
+		if (m_nodes.empty()) {
+			return;
+		}
+
+		//	節点ごとに箱と交差する光線だけを番号列の末尾へ詰め、子へはその範囲を渡す
+		stack.push_back({ 0U, 0U, count });
+		while (!stack.empty()) {
+			StreamEntry const entry = stack.back();
+			stack.pop_back();
+			ids.resize(entry.end);
+
+			BvhNode const& node = m_nodes[entry.node];
+			size_t const begin = ids.size();
+			float heading = 0.0f;
+			for (size_t idx = entry.begin; idx < entry.end; ++idx) {
+				StreamRay const& ray = stream[ids[idx]];
+				if (!ray.done && hitBox(ray, node)) {
+					ids.push_back(ids[idx]);
+					heading += ray.direct.p[node.axis];
+				}
+			}
+			size_t const end = ids.size();
+			if (begin == end) {
+				continue;
+			}
+
+			if (node.count == 0U) {
+				//	光線の多数が向かう側の子を後に積み、先に調べる
+				StreamEntry const left = { entry.node + 1U, begin, end };
+				StreamEntry const right = { node.offset, begin, end };
+				stack.push_back(heading < 0.0f ? left : right);
+				stack.push_back(heading < 0.0f ? right : left);
+				continue;
+			}
+
+			for (unsigned int tri = node.offset; tri < node.offset + node.count; ++tri) {
+				Float3 const* vertices = &m_triangles[tri * T3_CNT];
+				for (size_t idx = begin; idx < end; ++idx) {
+					unsigned int const id = ids[idx];
+					StreamRay& ray = stream[id];
+					float t = 0.0f, u = 0.0f, v = 0.0f;
+					if (ray.done || !hitTriangle(ray, vertices, t, u, v)) {
+						continue;
+					}
+					if (results != nullptr) {
+						results[id] = true;
+						ray.done = true;
+						continue;
+					}
+					ray.limit = t;
+					hits[id].distance = t;
+					hits[id].u = u;
+					hits[id].v = v;
+					hits[id].primitive = m_primitives[tri];
+				}
+			}
+		}
+	}
+}
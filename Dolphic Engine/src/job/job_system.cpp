@@ -0,0 +1,239 @@
+﻿/**	@file	job_system.cpp
+ *	@brief	ジョブシステム
+ */
+#include "job/job_system.hpp"
+#include <cstdint>
+
+namespace {
+	//!	@brief	眠る前に他のキューを探し直す回数
+	static unsigned int constexpr JOB_SPIN_COUNT = 64U;
+
+	//!	@brief	現在のスレッドのワーカー番号
+	thread_local size_t t_worker = SIZE_MAX;
+}
+
+namespace dlph {
+	JobCounter::JobCounter() noexcept :
+		INonmovable(),
+		m_value(0U)
+	{}
+
+	JobCounter::~JobCounter() noexcept {}
+
+	void JobCounter::increment(unsigned int const& count) noexcept {
+		m_value.fetch_add(count, std::memory_order_relaxed);
+	}
+
+	void JobCounter::decrement() noexcept {
+		m_value.fetch_sub(1U, std::memory_order_acq_rel);
+	}
+
+	unsigned int const JobCounter::value() const noexcept {
+		return m_value.load(std::memory_order_acquire);
+	}
+
+	bool const JobCounter::done() const noexcept {
+		return value() == 0U;
+	}
+
+	JobSystem::JobSystem() noexcept :
+		ISingleton(),
+		m_jobs(),
+		m_deques(),
+		m_threads(),
+		m_injected(),
+		m_injectMutex(),
+		m_sleepMutex(),
+		m_signal(),
+		m_queued(0U),
+		m_sleeping(0U),
+		m_running(false)
+	{}
+
+	JobSystem::~JobSystem() noexcept {
+		exit();
+	}
+
+	bool const JobSystem::init(size_t const& workers, size_t const& capacity) noexcept {
+		exit();
+
+		size_t count = workers;
+		if (count == 0U) {
+			unsigned int const hardware = std::thread::hardware_concurrency();
+			count = hardware > 1U ? hardware - 1U : 1U;
+		}
+		if (!m_jobs.init(capacity)) {
+			OutputDebugStringA("ERROR : CREATE FAILED JOB POOL.\n");
+			return false;
+		}
+		for (size_t idx = 0U; idx <= count; ++idx) {
+			m_deques.emplace_back(new JobDeque<Job*>());
+			if (!m_deques.back()->init(JOB_DEQUE_CAPACITY)) {
+				exit();
+				return false;
+			}
+		}
+
+		t_worker = 0U;
+		m_running.store(true);
+		for (size_t idx = 1U; idx <= count; ++idx) {
+			m_threads.emplace_back(&JobSystem::work, this, idx);
+		}
+		return true;
+	}
+
+	void JobSystem::exit() noexcept {
+		if (m_running.exchange(false)) {
+			{
+				std::lock_guard<std::mutex> const lock(m_sleepMutex);
+				m_signal.notify_all();
+			}
+			for (std::thread& thread : m_threads) {
+				thread.join();
+			}
+			t_worker = 0U;
+			for (Job* job = nullptr; take(job);) {
+				execute(job);
+			}
+			t_worker = SIZE_MAX;
+		}
+		m_threads.clear();
+		m_deques.clear();
+		m_injected.clear();
+		m_jobs.exit();
+		m_queued.store(0U);
+	}
+
+	void JobSystem::wait(JobCounter const& counter) noexcept {
+		while (!counter.done()) {
+			Job* job = nullptr;
+			if (take(job)) {
+				execute(job);
+			}
+			else {
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	bool const JobSystem::running() const noexcept {
+		return m_running.load(std::memory_order_relaxed);
+	}
+
+	size_t const JobSystem::workerCount() const noexcept {
+		return m_deques.size();
+	}
+
+	size_t const JobSystem::workerIndex() noexcept {
+		return t_worker;
+	}
+
+	Job* const JobSystem::allocate(JobCounter* const counter) noexcept {
+		if (counter) {
+			counter->increment();
+		}
+		if (!running()) {
+			return nullptr;
+		}
+
+		Handle32<Job> const handle = m_jobs.create();
+		if (!handle) {
+			return nullptr;
+		}
+		Job* const job = m_jobs.get(handle);
+		job->counter = counter;
+		job->handle = handle;
+		return job;
+	}
+
+	void JobSystem::submit(Job* const job) noexcept {
+		//	盗まれて先に減らされないよう、積む前に数える
+		m_queued.fetch_add(1U);
+		size_t const index = t_worker;
+		if (index < m_deques.size()) {
+			if (!m_deques[index]->push(job)) {
+				//	キューが満杯なら、その場で実行する
+				m_queued.fetch_sub(1U);
+				execute(job);
+				return;
+			}
+		}
+		else {
+			std::lock_guard<std::mutex> const lock(m_injectMutex);
+			m_injected.push_back(job);
+		}
+
+		if (m_sleeping.load() > 0U) {
+			std::lock_guard<std::mutex> const lock(m_sleepMutex);
+			m_signal.notify_one();
+		}
+	}
+
+	bool const JobSystem::take(Job*& job) noexcept {
+		size_t const count = m_deques.size();
+		size_t const index = t_worker;
+		if (index < count && m_deques[index]->pop(job)) {
+			m_queued.fetch_sub(1U);
+			return true;
+		}
+		if (m_queued.load(std::memory_order_relaxed) == 0U) {
+			return false;
+		}
+
+		{
+			std::lock_guard<std::mutex> const lock(m_injectMutex);
+			if (!m_injected.empty()) {
+				job = m_injected.back();
+				m_injected.pop_back();
+				m_queued.fetch_sub(1U);
+				return true;
+			}
+		}
+
+		//	自身の次のワーカーから順に盗む
+		size_t const start = index < count ? index + 1U : 0U;
+		for (size_t idx = 0U; idx < count; ++idx) {
+			size_t const victim = (start + idx) % count;
+			if (victim != index && m_deques[victim]->steal(job)) {
+				m_queued.fetch_sub(1U);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void JobSystem::execute(Job* const job) noexcept {
+		JobCounter* const counter = job->counter;
+		job->invoke(job->data);
+		m_jobs.destroy(job->handle);
+		if (counter) {
+			counter->decrement();
+		}
+	}
+
+	void JobSystem::work(size_t const& index) noexcept {
+		t_worker = index;
+		unsigned int idle = 0U;
+		while (m_running.load(std::memory_order_relaxed)) {
+			Job* job = nullptr;
+			if (take(job)) {
+				execute(job);
+				idle = 0U;
+				continue;
+			}
+			if (++idle < JOB_SPIN_COUNT) {
+				std::this_thread::yield();
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(m_sleepMutex);
+			m_sleeping.fetch_add(1U);
+			m_signal.wait(lock, [this]() {
+				return m_queued.load() > 0U || !m_running.load();
+			});
+			m_sleeping.fetch_sub(1U);
+			idle = 0U;
+		}
+		t_worker = SIZE_MAX;
+	}
+}
@@ -227,7 +227,7 @@ namespace dlph {
 	FMatrix2x2 const operator*(FMatrix2x2 const& lhs, FMatrix2x2 const& rhs) noexcept {
 		FMatrix2x2 result;
 		for (unsigned int idx = 0U; idx < 4U; ++idx) {
-			result.p[idx] = dot(lhs.row(idx % 2U), rhs.column(idx / 2U));
+			result.p[idx] = dot(lhs.row(idx / 2U), rhs.column(idx % 2U));
 		}
 		return result;
 	}
@@ -241,7 +241,7 @@ namespace dlph {
 	FMatrix3x3 const operator*(FMatrix3x3 const& lhs, FMatrix3x3 const& rhs) noexcept {
 		FMatrix3x3 result;
 		for (unsigned int idx = 0U; idx < 9U; ++idx) {
-			result.p[idx] = dot(lhs.row(idx % 3U), rhs.column(idx / 3U));
+			result.p[idx] = dot(lhs.row(idx / 3U), rhs.column(idx % 3U));
 		}
 		return result;
 	}
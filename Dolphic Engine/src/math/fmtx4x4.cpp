@@ -262,7 +262,7 @@ namespace dlph {
 	FMatrix4x4 const operator*(FMatrix4x4 const& lhs, FMatrix4x4 const& rhs) noexcept {
 		FMatrix4x4 result;
 		for (unsigned int idx = 0U; idx < 16U; ++idx) {
-			result.p[idx] = dot(lhs.row(idx % 4U), rhs.column(idx / 4U));
+			result.p[idx] = dot(lhs.row(idx / 4U), rhs.column(idx % 4U));
 		}
 		return result;
 	}
@@ -65,7 +65,7 @@ namespace dlph {
 	float const dot(FVector3 const& lhs, FVector3 const& rhs) noexcept {
 		float temps[4U];
 		store(temps, mul(load(lhs.p), load(rhs.p)));
-		return Math<float>::sum(temps, 4U);
+		return Math<float>::sum(temps, T3_CNT);
 	}
 
 	FVector3 const normalize(FVector3 const& arg) noexcept {
@@ -0,0 +1,143 @@
+﻿/**	@file	arena.cpp
+ *	@brief	線形アリーナ
+ */
+#include "mem/arena.hpp"
+#include <cstdint>
+#include <new>
+
+namespace dlph {
+	LinearArena::LinearArena() noexcept :
+		memory_resource(),
+		INonmovable(),
+		m_upstream(nullptr),
+		m_buffer(nullptr),
+		m_capacity(0U),
+		m_offset(0U),
+		m_peak(0U),
+		m_overflowBytes(0U),
+		m_overflows()
+	{}
+
+	LinearArena::~LinearArena() noexcept {
+		exit();
+	}
+
+	bool const LinearArena::init(size_t const& capacity, std::pmr::memory_resource* upstream) noexcept {
+		exit();
+
+		m_upstream = upstream ? upstream : std::pmr::new_delete_resource();
+		m_buffer = static_cast<unsigned char*>(::operator new(capacity, std::align_val_t(alignof(std::max_align_t)), std::nothrow));
+		if (m_buffer == nullptr && capacity > 0U) {
+			OutputDebugStringA("ERROR : CREATE FAILED LINEAR ARENA.\n");
+			return false;
+		}
+		m_capacity = capacity;
+		return true;
+	}
+
+	void LinearArena::exit() noexcept {
+		reset();
+		if (m_buffer) {
+			::operator delete(m_buffer, std::align_val_t(alignof(std::max_align_t)), std::nothrow);
+			m_buffer = nullptr;
+		}
+		m_upstream = nullptr;
+		m_capacity = 0U;
+		m_peak = 0U;
+		m_overflowBytes = 0U;
+	}
+
+	void LinearArena::reset() noexcept {
+		rewind({ 0U, 0U });
+	}
+
+	ArenaMark const LinearArena::mark() const noexcept {
+		return { m_offset, m_overflows.size() };
+	}
+
+	void LinearArena::rewind(ArenaMark const& mark) noexcept {
+		while (m_overflows.size() > mark.overflow) {
+			Overflow const& block = m_overflows.back();
+			if (block.ptr) {
+				m_upstream->deallocate(block.ptr, block.bytes, block.alignment);
+			}
+			m_overflows.pop_back();
+		}
+		if (mark.offset < m_offset) {
+			m_offset = mark.offset;
+		}
+	}
+
+	size_t const LinearArena::used() const noexcept {
+		return m_offset;
+	}
+
+	size_t const LinearArena::capacity() const noexcept {
+		return m_capacity;
+	}
+
+	size_t const LinearArena::peak() const noexcept {
+		return m_peak;
+	}
+
+	size_t const LinearArena::overflow() const noexcept {
+		return m_overflowBytes;
+	}
+
+	void* LinearArena::do_allocate(size_t bytes, size_t alignment) {
+		uintptr_t const base = reinterpret_cast<uintptr_t>(m_buffer);
+		uintptr_t const head = (base + m_offset + alignment - 1U) & ~static_cast<uintptr_t>(alignment - 1U);
+		size_t const end = static_cast<size_t>(head - base) + bytes;
+		if (m_buffer && end <= m_capacity) {
+			m_offset = end;
+			if (m_offset > m_peak) {
+				m_peak = m_offset;
+			}
+			return reinterpret_cast<void*>(head);
+		}
+
+		//	容量を超えた分は上位リソースから確保し、巻き戻し時にまとめて返す
+		if (m_upstream == nullptr) {
+			m_upstream = std::pmr::new_delete_resource();
+		}
+		void* const ptr = m_upstream->allocate(bytes, alignment);
+		m_overflows.push_back({ ptr, bytes, alignment });
+		m_overflowBytes += bytes;
+		return ptr;
+	}
+
+	void LinearArena::do_deallocate(void* ptr, size_t bytes, size_t) {
+		unsigned char* const head = static_cast<unsigned char*>(ptr);
+		if (m_buffer && head >= m_buffer && head < m_buffer + m_capacity) {
+			//	最後に確保したメモリなら位置を戻す (std::pmr::vector の伸長で効きます)
+			if (head + bytes == m_buffer + m_offset) {
+				m_offset = static_cast<size_t>(head - m_buffer);
+			}
+			return;
+		}
+
+		//	巻き戻し位置の番号がずれないよう、要素は残して解放済みの印を付ける
+		for (size_t idx = m_overflows.size(); idx > 0U; --idx) {
+			Overflow& block = m_overflows[idx - 1U];
+			if (block.ptr == ptr) {
+				m_upstream->deallocate(block.ptr, block.bytes, block.alignment);
+				block.ptr = nullptr;
+				return;
+			}
+		}
+	}
+
+	bool LinearArena::do_is_equal(std::pmr::memory_resource const& other) const noexcept {
+		return this == &other;
+	}
+
+	ArenaScope::ArenaScope(LinearArena& arena) noexcept :
+		INonmovable(),
+		m_arena(arena),
+		m_mark(arena.mark())
+	{}
+
+	ArenaScope::~ArenaScope() noexcept {
+		m_arena.rewind(m_mark);
+	}
+}
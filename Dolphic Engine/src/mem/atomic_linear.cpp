@@ -0,0 +1,75 @@
+﻿/**	@file	atomic_linear.cpp
+ *	@brief	スレッドセーフな線形区間確保器
+ */
+#include "mem/atomic_linear.hpp"
+
+namespace dlph {
+	AtomicLinearAllocator::AtomicLinearAllocator() noexcept :
+		INonmovable(),
+		m_offset(0U),
+		m_capacity(0U),
+		m_alignment(1U),
+		m_peak(0U)
+	{}
+
+	bool const AtomicLinearAllocator::init(unsigned long long const& capacity, unsigned long long const& alignment) noexcept {
+		exit();
+		if (capacity == 0U || alignment == 0U || (alignment & (alignment - 1U)) != 0U) {
+			OutputDebugStringA("ERROR : LINEAR ALLOCATOR SETTING IS INVALID.\n");
+			return false;
+		}
+		m_capacity = capacity;
+		m_alignment = alignment;
+		return true;
+	}
+
+	void AtomicLinearAllocator::exit() noexcept {
+		m_offset.store(0U, std::memory_order_relaxed);
+		m_capacity = 0U;
+		m_alignment = 1U;
+		m_peak = 0U;
+	}
+
+	unsigned long long const AtomicLinearAllocator::allocate(unsigned long long const& size) noexcept {
+		unsigned long long const bytes = align(size);
+		if (bytes == 0U || bytes > m_capacity) {
+			return LINEAR_INVALID;
+		}
+		//	溢れた場合も位置は進めたままにし、以降の確保も失敗させる (reset まで戻さない)
+		unsigned long long const offset = m_offset.fetch_add(bytes, std::memory_order_relaxed);
+		if (offset > m_capacity - bytes) {
+			return LINEAR_INVALID;
+		}
+		return offset;
+	}
+
+	void AtomicLinearAllocator::reset() noexcept {
+		unsigned long long const current = used();
+		if (current > m_peak) {
+			m_peak = current;
+		}
+		m_offset.store(0U, std::memory_order_relaxed);
+	}
+
+	unsigned long long const AtomicLinearAllocator::align(unsigned long long const& size) const noexcept {
+		return (size + m_alignment - 1U) & ~(m_alignment - 1U);
+	}
+
+	unsigned long long const AtomicLinearAllocator::capacity() const noexcept {
+		return m_capacity;
+	}
+
+	unsigned long long const AtomicLinearAllocator::alignment() const noexcept {
+		return m_alignment;
+	}
+
+	unsigned long long const AtomicLinearAllocator::used() const noexcept {
+		unsigned long long const offset = m_offset.load(std::memory_order_relaxed);
+		return offset < m_capacity ? offset : m_capacity;
+	}
+
+	unsigned long long const AtomicLinearAllocator::peak() const noexcept {
+		unsigned long long const current = used();
+		return current > m_peak ? current : m_peak;
+	}
+}
@@ -0,0 +1,51 @@
+﻿/**	@file	frame_arena.cpp
+ *	@brief	フレームアリーナ
+ */
+#include "mem/frame_arena.hpp"
+
+namespace dlph {
+	FrameArena::FrameArena() noexcept :
+		INonmovable(),
+		m_arenas(),
+		m_frame(0U)
+	{}
+
+	FrameArena::~FrameArena() noexcept {
+		exit();
+	}
+
+	bool const FrameArena::init(size_t const& capacity, std::pmr::memory_resource* upstream) noexcept {
+		exit();
+		for (LinearArena& arena : m_arenas) {
+			if (!arena.init(capacity, upstream)) {
+				exit();
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void FrameArena::exit() noexcept {
+		for (LinearArena& arena : m_arenas) {
+			arena.exit();
+		}
+		m_frame = 0U;
+	}
+
+	void FrameArena::next() noexcept {
+		++m_frame;
+		current().reset();
+	}
+
+	LinearArena& FrameArena::current() noexcept {
+		return m_arenas[m_frame % FRAME_ARENA_CNT];
+	}
+
+	LinearArena& FrameArena::previous() noexcept {
+		return m_arenas[(m_frame + FRAME_ARENA_CNT - 1U) % FRAME_ARENA_CNT];
+	}
+
+	unsigned long long const FrameArena::frame() const noexcept {
+		return m_frame;
+	}
+}
@@ -0,0 +1,117 @@
+﻿/**	@file	range_alloc.cpp
+ *	@brief	区間確保器
+ */
+#include "mem/range_alloc.hpp"
+#include <crtdbg.h>
+#include <iterator>
+
+namespace dlph {
+	RangeAllocator::RangeAllocator() noexcept :
+		m_offsets(),
+		m_sizes(),
+		m_capacity(0U),
+		m_used(0U)
+	{}
+
+	bool const RangeAllocator::init(unsigned int const& capacity) noexcept {
+		exit();
+		if (capacity == 0U || capacity == RANGE_INVALID) {
+			OutputDebugStringA("ERROR : RANGE ALLOCATOR CAPACITY IS INVALID.\n");
+			return false;
+		}
+		m_capacity = capacity;
+		reset();
+		return true;
+	}
+
+	void RangeAllocator::exit() noexcept {
+		m_offsets.clear();
+		m_sizes.clear();
+		m_capacity = 0U;
+		m_used = 0U;
+	}
+
+	unsigned int const RangeAllocator::allocate(unsigned int const& count) noexcept {
+		if (count == 0U) {
+			return RANGE_INVALID;
+		}
+		auto const it = m_sizes.lower_bound({ count, 0U });
+		if (it == m_sizes.end()) {
+			return RANGE_INVALID;
+		}
+
+		unsigned int const size = it->first;
+		unsigned int const offset = it->second;
+		erase(m_offsets.find(offset));
+		if (size > count) {
+			insert(offset + count, size - count);
+		}
+		m_used += count;
+		return offset;
+	}
+
+	void RangeAllocator::release(unsigned int const& offset, unsigned int const& count) noexcept {
+		if (offset == RANGE_INVALID || count == 0U) {
+			return;
+		}
+#if	defined(_DEBUG) || defined(DEBUG)
+		_ASSERT_EXPR(offset + count <= m_capacity, L"ERROR : RELEASED RANGE EXCEEDS CAPACITY.");
+#endif
+		unsigned int begin = offset;
+		unsigned int end = offset + count;
+
+		//	後ろの空き区間と結合する
+		auto next = m_offsets.lower_bound(begin);
+		if (next != m_offsets.end() && next->first == end) {
+			end += next->second;
+			auto const target = next++;
+			erase(target);
+		}
+		//	前の空き区間と結合する
+		if (next != m_offsets.begin()) {
+			auto const prev = std::prev(next);
+			if (prev->first + prev->second == begin) {
+				begin = prev->first;
+				erase(prev);
+			}
+		}
+
+		insert(begin, end - begin);
+		m_used -= count;
+	}
+
+	void RangeAllocator::reset() noexcept {
+		m_offsets.clear();
+		m_sizes.clear();
+		m_used = 0U;
+		if (m_capacity > 0U) {
+			insert(0U, m_capacity);
+		}
+	}
+
+	unsigned int const RangeAllocator::capacity() const noexcept {
+		return m_capacity;
+	}
+
+	unsigned int const RangeAllocator::used() const noexcept {
+		return m_used;
+	}
+
+	unsigned int const RangeAllocator::largest() const noexcept {
+		return m_sizes.empty() ? 0U : m_sizes.rbegin()->first;
+	}
+
+	size_t const RangeAllocator::fragments() const noexcept {
+		return m_offsets.size();
+	}
+
+	void RangeAllocator::insert(unsigned int const& offset, unsigned int const& count) noexcept {
+		m_offsets.emplace(offset, count);
+		m_sizes.emplace(count, offset);
+	}
+
+	void RangeAllocator::erase(std::map<unsigned int, unsigned int>::iterator const& it) noexcept {
+		m_sizes.erase({ it->second, it->first });
+		m_offsets.erase(it);
+	}
+}
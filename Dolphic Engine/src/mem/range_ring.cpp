@@ -0,0 +1,84 @@
+﻿/**	@file	range_ring.cpp
+ *	@brief	フレーム単位の環状区間確保器
+ */
+#include "mem/range_ring.hpp"
+#include <crtdbg.h>
+
+namespace dlph {
+	RangeRing::RangeRing() noexcept :
+		m_marks(),
+		m_head(0U),
+		m_tail(0U),
+		m_capacity(0U)
+	{}
+
+	bool const RangeRing::init(unsigned int const& capacity) noexcept {
+		exit();
+		if (capacity == 0U || capacity == RANGE_INVALID) {
+			OutputDebugStringA("ERROR : RANGE RING CAPACITY IS INVALID.\n");
+			return false;
+		}
+		m_capacity = capacity;
+		return true;
+	}
+
+	void RangeRing::exit() noexcept {
+		for (unsigned long long& mark : m_marks) {
+			mark = 0U;
+		}
+		m_head = 0U;
+		m_tail = 0U;
+		m_capacity = 0U;
+	}
+
+	void RangeRing::begin(unsigned int const& slot) noexcept {
+#if	defined(_DEBUG) || defined(DEBUG)
+		_ASSERT_EXPR(slot < FRAME_LATENCY_MAX, L"ERROR : FRAME SLOT OUT OF RANGE.");
+#endif
+		if (m_marks[slot] > m_head) {
+			m_head = m_marks[slot];
+		}
+	}
+
+	void RangeRing::end(unsigned int const& slot) noexcept {
+#if	defined(_DEBUG) || defined(DEBUG)
+		_ASSERT_EXPR(slot < FRAME_LATENCY_MAX, L"ERROR : FRAME SLOT OUT OF RANGE.");
+#endif
+		m_marks[slot] = m_tail;
+	}
+
+	void RangeRing::release() noexcept {
+		m_head = m_tail;
+	}
+
+	unsigned int const RangeRing::allocate(unsigned int const& count) noexcept {
+		if (count == 0U || count > m_capacity) {
+			return RANGE_INVALID;
+		}
+
+		unsigned long long position = m_tail;
+		unsigned long long const offset = position % m_capacity;
+		if (offset + count > m_capacity) {
+			//	折り返しをまたぐ区間は作らず、残りを捨てて先頭から取る
+			position += m_capacity - offset;
+			if (m_head == m_tail) {
+				//	空なら捨てた残りを使用量に数えない
+				m_head = position;
+			}
+		}
+		if (position + count - m_head > m_capacity) {
+			return RANGE_INVALID;
+		}
+
+		m_tail = position + count;
+		return static_cast<unsigned int>(position % m_capacity);
+	}
+
+	unsigned int const RangeRing::capacity() const noexcept {
+		return m_capacity;
+	}
+
+	unsigned int const RangeRing::used() const noexcept {
+		return static_cast<unsigned int>(m_tail - m_head);
+	}
+}
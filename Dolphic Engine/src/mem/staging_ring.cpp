@@ -0,0 +1,86 @@
+﻿/**	@file	staging_ring.cpp
+ *	@brief	フェンス値単位の環状区間確保器
+ */
+#include "mem/staging_ring.hpp"
+
+namespace dlph {
+	StagingRing::StagingRing() noexcept :
+		m_marks(),
+		m_head(0U),
+		m_tail(0U),
+		m_closed(0U),
+		m_capacity(0U)
+	{}
+
+	bool const StagingRing::init(unsigned long long const& capacity, unsigned int const& marks) noexcept {
+		exit();
+		if (capacity == 0U || capacity == STAGING_INVALID || !m_marks.init(marks)) {
+			OutputDebugStringA("ERROR : STAGING RING CAPACITY IS INVALID.\n");
+			return false;
+		}
+		m_capacity = capacity;
+		return true;
+	}
+
+	void StagingRing::exit() noexcept {
+		m_marks.exit();
+		m_head = 0U;
+		m_tail = 0U;
+		m_closed = 0U;
+		m_capacity = 0U;
+	}
+
+	unsigned long long const StagingRing::allocate(unsigned long long const& size, unsigned long long const& alignment) noexcept {
+		if (size == 0U || size > m_capacity) {
+			return STAGING_INVALID;
+		}
+
+		unsigned long long const mask = alignment > 0U ? alignment - 1U : 0U;
+		unsigned long long position = m_tail;
+		unsigned long long offset = ((position % m_capacity) + mask) & ~mask;
+		if (offset + size > m_capacity) {
+			//	折り返しをまたぐ区間は作らず、残りを捨てて先頭から取る
+			position += m_capacity - position % m_capacity;
+			offset = 0U;
+		}
+		else {
+			position += offset - position % m_capacity;
+		}
+		if (position + size - m_head > m_capacity) {
+			return STAGING_INVALID;
+		}
+
+		m_tail = position + size;
+		return offset;
+	}
+
+	bool const StagingRing::close(unsigned long long const& value) noexcept {
+		if (m_tail == m_closed) {
+			return true;
+		}
+		if (!m_marks.push_back({ m_tail, value })) {
+			return false;
+		}
+		m_closed = m_tail;
+		return true;
+	}
+
+	void StagingRing::retire(unsigned long long const& completed) noexcept {
+		while (!m_marks.empty() && m_marks.front().value <= completed) {
+			m_head = m_marks.front().tail;
+			m_marks.pop_front();
+		}
+	}
+
+	unsigned long long const StagingRing::capacity() const noexcept {
+		return m_capacity;
+	}
+
+	unsigned long long const StagingRing::used() const noexcept {
+		return m_tail - m_head;
+	}
+
+	bool const StagingRing::closable() const noexcept {
+		return !m_marks.full();
+	}
+}
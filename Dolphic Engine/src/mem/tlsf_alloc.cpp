@@ -0,0 +1,337 @@
+﻿/**	@file	tlsf_alloc.cpp
+ *	@brief	TLSF 区間確保器
+ */
+#include "mem/tlsf_alloc.hpp"
+#include <crtdbg.h>
+#if	defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+	using namespace dlph;
+
+	//!	@brief	最上位の立っているビットの位置 (value は 0 以外)
+	inline unsigned int const highestBit(unsigned long long const& value) noexcept {
+#if	defined(_MSC_VER)
+		unsigned long idx = 0U;
+		_BitScanReverse64(&idx, value);
+		return static_cast<unsigned int>(idx);
+#else
+		return 63U - static_cast<unsigned int>(__builtin_clzll(value));
+#endif
+	}
+
+	//!	@brief	最下位の立っているビットの位置 (value は 0 以外)
+	inline unsigned int const lowestBit(unsigned long long const& value) noexcept {
+#if	defined(_MSC_VER)
+		unsigned long idx = 0U;
+		_BitScanForward64(&idx, value);
+		return static_cast<unsigned int>(idx);
+#else
+		return static_cast<unsigned int>(__builtin_ctzll(value));
+#endif
+	}
+
+	//!	@brief	境界への切り上げ
+	inline unsigned long long const alignUp(unsigned long long const& value, unsigned long long const& alignment) noexcept {
+		return (value + alignment - 1U) & ~(alignment - 1U);
+	}
+}
+
+namespace dlph {
+	TlsfAllocator::TlsfAllocator() noexcept :
+		m_blocks(),
+		m_heads(),
+		m_slBitmaps(),
+		m_flBitmap(0U),
+		m_unused(TLSF_INVALID),
+		m_freeCount(0U),
+		m_capacity(0U),
+		m_used(0U)
+	{}
+
+	bool const TlsfAllocator::init(unsigned long long const& capacity) noexcept {
+		exit();
+		if (capacity == 0U) {
+			OutputDebugStringA("ERROR : TLSF ALLOCATOR CAPACITY IS INVALID.\n");
+			return false;
+		}
+		m_capacity = capacity;
+		reset();
+		return true;
+	}
+
+	void TlsfAllocator::exit() noexcept {
+		m_blocks.clear();
+		for (unsigned int fl = 0U; fl < TLSF_FL_COUNT; ++fl) {
+			for (unsigned int sl = 0U; sl < TLSF_SL_COUNT; ++sl) {
+				m_heads[fl][sl] = TLSF_INVALID;
+			}
+			m_slBitmaps[fl] = 0U;
+		}
+		m_flBitmap = 0U;
+		m_unused = TLSF_INVALID;
+		m_freeCount = 0U;
+		m_capacity = 0U;
+		m_used = 0U;
+	}
+
+	unsigned int const TlsfAllocator::allocate(unsigned long long const& size, unsigned long long const& alignment) noexcept {
+#if	defined(_DEBUG) || defined(DEBUG)
+		_ASSERT_EXPR(alignment != 0U && (alignment & (alignment - 1U)) == 0U, L"ERROR : ALIGNMENT IS NOT A POWER OF TWO.");
+#endif
+		if (size == 0U || size > m_capacity) {
+			return TLSF_INVALID;
+		}
+
+		//	まず大きさだけで探し、境界が合わなければ詰め物の分だけ大きいブロックを探し直す
+		unsigned int block = find(size);
+		if (block != TLSF_INVALID && alignment > 1U) {
+			Block const& candidate = m_blocks[block];
+			if (alignUp(candidate.offset, alignment) + size > candidate.offset + candidate.size) {
+				block = size + alignment - 1U > size ? find(size + alignment - 1U) : TLSF_INVALID;
+			}
+		}
+		if (block == TLSF_INVALID) {
+			return TLSF_INVALID;
+		}
+		remove(block);
+
+		//	先頭の詰め物を空きブロックとして切り離す (前のブロックは使用中なので結合は不要)
+		unsigned long long const padding = alignUp(m_blocks[block].offset, alignment) - m_blocks[block].offset;
+		if (padding > 0U) {
+			unsigned int const front = acquire();
+			Block& target = m_blocks[block];
+			Block& pad = m_blocks[front];
+			pad.offset = target.offset;
+			pad.size = padding;
+			pad.prevPhys = target.prevPhys;
+			pad.nextPhys = block;
+			if (target.prevPhys != TLSF_INVALID) {
+				m_blocks[target.prevPhys].nextPhys = front;
+			}
+			target.prevPhys = front;
+			target.offset += padding;
+			target.size -= padding;
+			insert(front);
+		}
+
+		if (m_blocks[block].size > size) {
+			split(block, size);
+		}
+		m_blocks[block].free = false;
+		m_used += m_blocks[block].size;
+		return block;
+	}
+
+	void TlsfAllocator::release(unsigned int const& block) noexcept {
+		if (block == TLSF_INVALID) {
+			return;
+		}
+#if	defined(_DEBUG) || defined(DEBUG)
+		_ASSERT_EXPR(block < m_blocks.size() && !m_blocks[block].free, L"ERROR : RELEASED BLOCK IS NOT ALLOCATED.");
+#endif
+		unsigned int target = block;
+		m_used -= m_blocks[target].size;
+
+		//	前のブロックと結合する
+		unsigned int const prev = m_blocks[target].prevPhys;
+		if (prev != TLSF_INVALID && m_blocks[prev].free) {
+			remove(prev);
+			m_blocks[prev].size += m_blocks[target].size;
+			m_blocks[prev].nextPhys = m_blocks[target].nextPhys;
+			if (m_blocks[target].nextPhys != TLSF_INVALID) {
+				m_blocks[m_blocks[target].nextPhys].prevPhys = prev;
+			}
+			discard(target);
+			target = prev;
+		}
+
+		//	後ろのブロックと結合する
+		unsigned int const next = m_blocks[target].nextPhys;
+		if (next != TLSF_INVALID && m_blocks[next].free) {
+			remove(next);
+			m_blocks[target].size += m_blocks[next].size;
+			m_blocks[target].nextPhys = m_blocks[next].nextPhys;
+			if (m_blocks[next].nextPhys != TLSF_INVALID) {
+				m_blocks[m_blocks[next].nextPhys].prevPhys = target;
+			}
+			discard(next);
+		}
+
+		insert(target);
+	}
+
+	void TlsfAllocator::reset() noexcept {
+		unsigned long long const capacity = m_capacity;
+		exit();
+		m_capacity = capacity;
+		if (m_capacity == 0U) {
+			return;
+		}
+
+		unsigned int const block = acquire();
+		m_blocks[block].offset = 0U;
+		m_blocks[block].size = m_capacity;
+		insert(block);
+	}
+
+	unsigned long long const TlsfAllocator::offset(unsigned int const& block) const noexcept {
+#if	defined(_DEBUG) || defined(DEBUG)
+		_ASSERT_EXPR(block < m_blocks.size(), L"ERROR : BLOCK NUMBER EXCEED ARRAY LENGTH.");
+#endif
+		return m_blocks[block].offset;
+	}
+
+	unsigned long long const TlsfAllocator::size(unsigned int const& block) const noexcept {
+#if	defined(_DEBUG) || defined(DEBUG)
+		_ASSERT_EXPR(block < m_blocks.size(), L"ERROR : BLOCK NUMBER EXCEED ARRAY LENGTH.");
+#endif
+		return m_blocks[block].size;
+	}
+
+	unsigned long long const TlsfAllocator::capacity() const noexcept {
+		return m_capacity;
+	}
+
+	unsigned long long const TlsfAllocator::used() const noexcept {
+		return m_used;
+	}
+
+	unsigned long long const TlsfAllocator::largest() const noexcept {
+		if (m_flBitmap == 0U) {
+			return 0U;
+		}
+		//	最も大きい区分のリストだけを調べれば足りる
+		unsigned int const fl = highestBit(m_flBitmap);
+		unsigned int const sl = highestBit(m_slBitmaps[fl]);
+		unsigned long long result = 0U;
+		for (unsigned int block = m_heads[fl][sl]; block != TLSF_INVALID; block = m_blocks[block].nextFree) {
+			if (m_blocks[block].size > result) {
+				result = m_blocks[block].size;
+			}
+		}
+		return result;
+	}
+
+	unsigned int const TlsfAllocator::fragments() const noexcept {
+		return m_freeCount;
+	}
+
+	void TlsfAllocator::mapping(unsigned long long const& size, unsigned int& fl, unsigned int& sl) noexcept {
+		if (size < TLSF_SL_COUNT) {
+			fl = 0U;
+			sl = static_cast<unsigned int>(size);
+			return;
+		}
+		unsigned int const msb = highestBit(size);
+		fl = msb - TLSF_SL_SHIFT + 1U;
+		sl = static_cast<unsigned int>(size >> (msb - TLSF_SL_SHIFT)) ^ TLSF_SL_COUNT;
+	}
+
+	unsigned int const TlsfAllocator::acquire() noexcept {
+		unsigned int block = m_unused;
+		if (block != TLSF_INVALID) {
+			m_unused = m_blocks[block].nextFree;
+		}
+		else {
+			block = static_cast<unsigned int>(m_blocks.size());
+			m_blocks.emplace_back();
+		}
+		m_blocks[block] = { 0U, 0U, TLSF_INVALID, TLSF_INVALID, TLSF_INVALID, TLSF_INVALID, false };
+		return block;
+	}
+
+	void TlsfAllocator::discard(unsigned int const& block) noexcept {
+		m_blocks[block].free = false;
+		m_blocks[block].nextFree = m_unused;
+		m_unused = block;
+	}
+
+	void TlsfAllocator::insert(unsigned int const& block) noexcept {
+		unsigned int fl = 0U, sl = 0U;
+		mapping(m_blocks[block].size, fl, sl);
+
+		Block& target = m_blocks[block];
+		target.free = true;
+		target.prevFree = TLSF_INVALID;
+		target.nextFree = m_heads[fl][sl];
+		if (target.nextFree != TLSF_INVALID) {
+			m_blocks[target.nextFree].prevFree = block;
+		}
+		m_heads[fl][sl] = block;
+		m_slBitmaps[fl] |= 1U << sl;
+		m_flBitmap |= 1ULL << fl;
+		++m_freeCount;
+	}
+
+	void TlsfAllocator::remove(unsigned int const& block) noexcept {
+		unsigned int fl = 0U, sl = 0U;
+		mapping(m_blocks[block].size, fl, sl);
+
+		Block& target = m_blocks[block];
+		if (target.prevFree != TLSF_INVALID) {
+			m_blocks[target.prevFree].nextFree = target.nextFree;
+		}
+		else {
+			m_heads[fl][sl] = target.nextFree;
+		}
+		if (target.nextFree != TLSF_INVALID) {
+			m_blocks[target.nextFree].prevFree = target.prevFree;
+		}
+		target.prevFree = TLSF_INVALID;
+		target.nextFree = TLSF_INVALID;
+		target.free = false;
+
+		if (m_heads[fl][sl] == TLSF_INVALID) {
+			m_slBitmaps[fl] &= ~(1U << sl);
+			if (m_slBitmaps[fl] == 0U) {
+				m_flBitmap &= ~(1ULL << fl);
+			}
+		}
+		--m_freeCount;
+	}
+
+	unsigned int const TlsfAllocator::find(unsigned long long const& size) const noexcept {
+		//	区分の上端まで切り上げ、その区分以上のリストの先頭なら必ず収まるようにする
+		unsigned long long request = size;
+		if (request >= TLSF_SL_COUNT) {
+			unsigned long long const round = (1ULL << (highestBit(request) - TLSF_SL_SHIFT)) - 1U;
+			if (request + round < request) {
+				return TLSF_INVALID;
+			}
+			request += round;
+		}
+
+		unsigned int fl = 0U, sl = 0U;
+		mapping(request, fl, sl);
+
+		unsigned int slMap = m_slBitmaps[fl] & (~0U << sl);
+		if (slMap == 0U) {
+			unsigned long long const flMap = fl + 1U < TLSF_FL_COUNT ? m_flBitmap & (~0ULL << (fl + 1U)) : 0U;
+			if (flMap == 0U) {
+				return TLSF_INVALID;
+			}
+			fl = lowestBit(flMap);
+			slMap = m_slBitmaps[fl];
+		}
+		sl = lowestBit(slMap);
+		return m_heads[fl][sl];
+	}
+
+	void TlsfAllocator::split(unsigned int const& block, unsigned long long const& size) noexcept {
+		unsigned int const rest = acquire();
+		Block& target = m_blocks[block];
+		Block& remain = m_blocks[rest];
+		remain.offset = target.offset + size;
+		remain.size = target.size - size;
+		remain.prevPhys = block;
+		remain.nextPhys = target.nextPhys;
+		if (target.nextPhys != TLSF_INVALID) {
+			m_blocks[target.nextPhys].prevPhys = rest;
+		}
+		target.nextPhys = rest;
+		target.size = size;
+		insert(rest);
+	}
+}
@@ -0,0 +1,133 @@
+﻿/**	@file	mapped_file.cpp
+ *	@brief	読み込み専用のメモリマップトファイル
+ */
+#include "util/mapped_file.hpp"
+#include <utility>
+#if	!defined(_WIN32)
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
+namespace dlph {
+	MappedFile::MappedFile(MappedFile&& arg) noexcept :
+		MappedFile()
+	{
+		*this = std::move(arg);
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& rhs) & noexcept {
+		if (this == &rhs) {
+			return *this;
+		}
+		exit();
+		m_data = rhs.m_data;
+		m_size = rhs.m_size;
+		rhs.m_data = nullptr;
+		rhs.m_size = 0U;
+#if	defined(_WIN32)
+		m_file = rhs.m_file;
+		m_mapping = rhs.m_mapping;
+		rhs.m_file = INVALID_HANDLE_VALUE;
+		rhs.m_mapping = nullptr;
+#endif
+		return *this;
+	}
+
+	MappedFile::MappedFile() noexcept :
+		INoncopyable(),
+		m_data(nullptr),
+		m_size(0U)
+#if	defined(_WIN32)
+		, m_file(INVALID_HANDLE_VALUE),
+		m_mapping(nullptr)
+#endif
+	{}
+
+	MappedFile::~MappedFile() noexcept {
+		exit();
+	}
+
+	bool const MappedFile::init(char const* const path) noexcept {
+		exit();
+#if	defined(_WIN32)
+		m_file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+		if (m_file == INVALID_HANDLE_VALUE) {
+			OutputDebugStringA("ERROR : OPENING FAILED MAPPED FILE.\n");
+			return false;
+		}
+		LARGE_INTEGER size = {};
+		if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0) {
+			OutputDebugStringA("ERROR : MAPPED FILE IS EMPTY.\n");
+			exit();
+			return false;
+		}
+		m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0U, 0U, nullptr);
+		if (m_mapping == nullptr) {
+			OutputDebugStringA("ERROR : CREATING FAILED FILE MAPPING.\n");
+			exit();
+			return false;
+		}
+		m_data = static_cast<unsigned char const*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0U, 0U, 0U));
+		if (m_data == nullptr) {
+			OutputDebugStringA("ERROR : MAPPING FAILED FILE VIEW.\n");
+			exit();
+			return false;
+		}
+		m_size = static_cast<size_t>(size.QuadPart);
+#else
+		int const file = open(path, O_RDONLY);
+		if (file < 0) {
+			OutputDebugStringA("ERROR : OPENING FAILED MAPPED FILE.\n");
+			return false;
+		}
+		struct stat info = {};
+		if (fstat(file, &info) != 0 || info.st_size <= 0) {
+			OutputDebugStringA("ERROR : MAPPED FILE IS EMPTY.\n");
+			close(file);
+			return false;
+		}
+		void* const ptr = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+		//	割り当てた後はファイル記述子が無くても参照できる
+		close(file);
+		if (ptr == MAP_FAILED) {
+			OutputDebugStringA("ERROR : MAPPING FAILED FILE VIEW.\n");
+			return false;
+		}
+		m_data = static_cast<unsigned char const*>(ptr);
+		m_size = static_cast<size_t>(info.st_size);
+#endif
+		return true;
+	}
+
+	void MappedFile::exit() noexcept {
+#if	defined(_WIN32)
+		if (m_data) {
+			UnmapViewOfFile(m_data);
+		}
+		if (m_mapping) {
+			CloseHandle(m_mapping);
+			m_mapping = nullptr;
+		}
+		if (m_file != INVALID_HANDLE_VALUE) {
+			CloseHandle(m_file);
+			m_file = INVALID_HANDLE_VALUE;
+		}
+#else
+		if (m_data) {
+			munmap(const_cast<unsigned char*>(m_data), m_size);
+		}
+#endif
+		m_data = nullptr;
+		m_size = 0U;
+	}
+
+	unsigned char const* const MappedFile::data() const noexcept {
+		return m_data;
+	}
+
+	size_t const MappedFile::size() const noexcept {
+		return m_size;
+	}
+}
@@ -0,0 +1,380 @@
+﻿/**	@file	vk_cmd_backend.cpp
+ *	@brief	描画コマンド列を Vulkan のコマンドバッファへ変換するバックエンド
+ */
+#include "vk/vk_cmd_backend.hpp"
+
+namespace {
+	using namespace dlph;
+
+	//!	@brief	シェーダから触れるパイプラインステージ
+	static VkPipelineStageFlags constexpr SHADER_STAGES = VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+		VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+	//!	@brief	描画コマンド列のハンドルからスロットマップのキーへの変換
+	template <typename T, typename H>
+	inline typename SlotMap<T>::KeyType const toKey(H const& handle) noexcept {
+		return SlotMap<T>::KeyType::make(handle.index(), handle.generation());
+	}
+
+	//!	@brief	リソースのサブリソース数
+	inline unsigned int const subresourceCount(VKResourceEntry const& entry) noexcept {
+		return entry.image != VK_NULL_HANDLE ? entry.mips * entry.layers : 1U;
+	}
+
+	//!	@brief	サブリソース番号から画像の範囲への変換
+	inline VkImageSubresourceRange const subresourceRange(VKResourceEntry const& entry, unsigned int const& subresource) noexcept {
+		VkImageSubresourceRange range = {};
+		range.aspectMask = entry.aspect;
+		if (subresource == SUBRESOURCE_ALL) {
+			range.levelCount = entry.mips;
+			range.layerCount = entry.layers;
+		}
+		else {
+			range.baseMipLevel = subresource % entry.mips;
+			range.baseArrayLayer = subresource / entry.mips;
+			range.levelCount = 1U;
+			range.layerCount = 1U;
+		}
+		return range;
+	}
+}
+
+namespace dlph {
+	VKStateAccess const to_vk_state(ResourceState const& state) noexcept {
+		switch (state) {
+		case ResourceState::VertexAndConstant:
+			return { VK_IMAGE_LAYOUT_GENERAL, VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_UNIFORM_READ_BIT,
+				VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | SHADER_STAGES };
+		case ResourceState::Index:
+			return { VK_IMAGE_LAYOUT_GENERAL, VK_ACCESS_INDEX_READ_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT };
+		case ResourceState::ShaderResource:
+			return { VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_ACCESS_SHADER_READ_BIT, SHADER_STAGES };
+		case ResourceState::UnorderedAccess:
+			return { VK_IMAGE_LAYOUT_GENERAL, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT, SHADER_STAGES };
+		case ResourceState::RenderTarget:
+			return { VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+				VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
+		case ResourceState::DepthWrite:
+			return { VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+				VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT };
+		case ResourceState::DepthRead:
+			return { VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_SHADER_READ_BIT,
+				VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | SHADER_STAGES };
+		case ResourceState::CopySource:
+			return { VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_ACCESS_TRANSFER_READ_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT };
+		case ResourceState::CopyDest:
+			return { VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT };
+		case ResourceState::Present:
+			//	表示の完了はセマフォで待つため、アクセスは無く、獲得の待ちを挟むステージとも繋がるよう全てのステージにする
+			return { VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, 0U, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT };
+		default:
+			return { VK_IMAGE_LAYOUT_GENERAL, VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT };
+		}
+	}
+
+	VKResourceTable::VKResourceTable() noexcept :
+		INonmovable(),
+		m_resources(),
+		m_pipelines(),
+		m_constants(VK_NULL_HANDLE)
+	{}
+
+	RenderResource const VKResourceTable::registerResource(VKResourceEntry const& entry) noexcept {
+		if ((entry.buffer == VK_NULL_HANDLE) == (entry.image == VK_NULL_HANDLE)) {
+			return {};
+		}
+		if (entry.image != VK_NULL_HANDLE && (entry.mips == 0U || entry.layers == 0U || entry.aspect == 0U)) {
+			return {};
+		}
+		auto const key = m_resources.insert(entry);
+		return RenderResource::make(key.index(), key.generation());
+	}
+
+	void VKResourceTable::unregisterResource(RenderResource const& handle) noexcept {
+		m_resources.erase(toKey<VKResourceEntry>(handle));
+	}
+
+	VKResourceEntry const* const VKResourceTable::getResource(RenderResource const& handle) const noexcept {
+		return m_resources.get(toKey<VKResourceEntry>(handle));
+	}
+
+	RenderPipeline const VKResourceTable::registerPipeline(VKPipelineEntry const& entry) noexcept {
+		if (entry.pipeline == VK_NULL_HANDLE || entry.layout == VK_NULL_HANDLE) {
+			return {};
+		}
+		auto const key = m_pipelines.insert(entry);
+		return RenderPipeline::make(key.index(), key.generation());
+	}
+
+	void VKResourceTable::unregisterPipeline(RenderPipeline const& handle) noexcept {
+		m_pipelines.erase(toKey<VKPipelineEntry>(handle));
+	}
+
+	VKPipelineEntry const* const VKResourceTable::getPipeline(RenderPipeline const& handle) const noexcept {
+		return m_pipelines.get(toKey<VKPipelineEntry>(handle));
+	}
+
+	void VKResourceTable::setConstants(VkDescriptorSet const& set) noexcept {
+		m_constants = set;
+	}
+
+	VkDescriptorSet VKResourceTable::getConstants() const noexcept {
+		return m_constants;
+	}
+
+	void VKResourceTable::clear() noexcept {
+		m_resources.clear();
+		m_pipelines.clear();
+		m_constants = VK_NULL_HANDLE;
+	}
+
+	VKCommandBackend::VKCommandBackend(VKResourceTable const& table, VKCommandList& list, VkRenderPassBeginInfo const* pass) noexcept :
+		IRenderBackend(),
+		m_table(table),
+		m_list(list),
+		m_pass(pass ? *pass : VkRenderPassBeginInfo{}),
+		m_hasPass(pass != nullptr),
+		m_graphicsLayout(VK_NULL_HANDLE),
+		m_computeLayout(VK_NULL_HANDLE),
+		m_compute(false),
+		m_tracker(),
+		m_images(),
+		m_buffers()
+	{}
+
+	void VKCommandBackend::draw(DrawCommand const& cmd) noexcept {
+		if (prepareDraw()) {
+			vkCmdDraw(m_list.get(), cmd.vertexCount, cmd.instanceCount, cmd.firstVertex, cmd.firstInstance);
+		}
+	}
+
+	void VKCommandBackend::drawIndexed(DrawIndexedCommand const& cmd) noexcept {
+		if (prepareDraw()) {
+			vkCmdDrawIndexed(m_list.get(), cmd.indexCount, cmd.instanceCount, cmd.firstIndex, cmd.baseVertex, cmd.firstInstance);
+		}
+	}
+
+	void VKCommandBackend::dispatch(DispatchCommand const& cmd) noexcept {
+		prepareOutside();
+		vkCmdDispatch(m_list.get(), cmd.x, cmd.y, cmd.z);
+	}
+
+	void VKCommandBackend::setPipeline(SetPipelineCommand const& cmd) noexcept {
+		VKPipelineEntry const* const entry = m_table.getPipeline(cmd.pipeline);
+		if (entry == nullptr) {
+			OutputDebugStringA("ERROR : PIPELINE HANDLE IS INVALID.\n");
+			return;
+		}
+		m_compute = entry->compute;
+		if (m_compute) {
+			m_computeLayout = entry->layout;
+		}
+		else {
+			m_graphicsLayout = entry->layout;
+		}
+		vkCmdBindPipeline(m_list.get(), bindPoint(), entry->pipeline);
+	}
+
+	void VKCommandBackend::bindVertexBuffer(BindVertexBufferCommand const& cmd) noexcept {
+		VKResourceEntry const* const entry = m_table.getResource(cmd.buffer);
+		if (entry == nullptr || entry->buffer == VK_NULL_HANDLE) {
+			OutputDebugStringA("ERROR : VERTEX BUFFER HANDLE IS INVALID.\n");
+			return;
+		}
+		VkDeviceSize const offset = cmd.offset;
+		vkCmdBindVertexBuffers(m_list.get(), cmd.slot, 1U, &entry->buffer, &offset);
+	}
+
+	void VKCommandBackend::bindIndexBuffer(BindIndexBufferCommand const& cmd) noexcept {
+		VKResourceEntry const* const entry = m_table.getResource(cmd.buffer);
+		if (entry == nullptr || entry->buffer == VK_NULL_HANDLE) {
+			OutputDebugStringA("ERROR : INDEX BUFFER HANDLE IS INVALID.\n");
+			return;
+		}
+		vkCmdBindIndexBuffer(m_list.get(), entry->buffer, cmd.offset, cmd.format == IndexFormat::UInt16 ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32);
+	}
+
+	void VKCommandBackend::bindConstants(BindConstantsCommand const& cmd) noexcept {
+		VkDescriptorSet const set = m_table.getConstants();
+		if (set == VK_NULL_HANDLE || layout() == VK_NULL_HANDLE) {
+			OutputDebugStringA("ERROR : CONSTANT DESCRIPTOR SET OR PIPELINE IS NOT SET.\n");
+			return;
+		}
+		if (cmd.address > ~0U) {
+			OutputDebugStringA("ERROR : CONSTANT OFFSET IS OUT OF RANGE.\n");
+			return;
+		}
+		//	Direct3D12 の GPU アドレスの代わりに、定数バッファ内の位置を動的オフセットで渡す
+		unsigned int const offset = static_cast<unsigned int>(cmd.address);
+		vkCmdBindDescriptorSets(m_list.get(), bindPoint(), layout(), cmd.root, 1U, &set, 1U, &offset);
+	}
+
+	void VKCommandBackend::bindResource(BindResourceCommand const& cmd) noexcept {
+		VKResourceEntry const* const entry = m_table.getResource(cmd.resource);
+		if (entry == nullptr || entry->set == VK_NULL_HANDLE) {
+			OutputDebugStringA("ERROR : RESOURCE HANDLE IS INVALID.\n");
+			return;
+		}
+		if (layout() == VK_NULL_HANDLE) {
+			OutputDebugStringA("ERROR : PIPELINE IS NOT SET.\n");
+			return;
+		}
+		vkCmdBindDescriptorSets(m_list.get(), bindPoint(), layout(), cmd.root, 1U, &entry->set, 0U, nullptr);
+	}
+
+	void VKCommandBackend::barrier(BarrierCommand const& cmd) noexcept {
+		VKResourceEntry const* const entry = m_table.getResource(cmd.resource);
+		if (entry == nullptr) {
+			OutputDebugStringA("ERROR : BARRIER RESOURCE HANDLE IS INVALID.\n");
+			return;
+		}
+		unsigned long long const key = cmd.resource.value;
+		switch (cmd.kind) {
+		case BarrierKind::UnorderedAccess:
+			m_tracker.uav(key);
+			break;
+		case BarrierKind::Transition:
+			//	この再生で初めて見るリソースはコマンドの遷移前の状態から追跡する (サブリソース単位の遷移に備えて数を合わせる)
+			if (!m_tracker.tracked(key)) {
+				m_tracker.track(key, cmd.before, subresourceCount(*entry));
+			}
+			if (!m_tracker.transition(key, cmd.after, cmd.subresource)) {
+				OutputDebugStringA("ERROR : BARRIER SUBRESOURCE IS OUT OF RANGE.\n");
+			}
+			break;
+		default:
+			if (cmd.kind == BarrierKind::Begin && !m_tracker.tracked(key)) {
+				m_tracker.track(key, cmd.before, subresourceCount(*entry));
+			}
+			m_tracker.barrier({ key, cmd.subresource, cmd.before, cmd.after, cmd.kind });
+			break;
+		}
+	}
+
+	void VKCommandBackend::copy(CopyCommand const& cmd) noexcept {
+		VKResourceEntry const* const dst = m_table.getResource(cmd.dst);
+		VKResourceEntry const* const src = m_table.getResource(cmd.src);
+		if (dst == nullptr || src == nullptr || dst->buffer == VK_NULL_HANDLE || src->buffer == VK_NULL_HANDLE) {
+			OutputDebugStringA("ERROR : COPY RESOURCE HANDLE IS INVALID.\n");
+			return;
+		}
+		prepareOutside();
+		VkBufferCopy region = {};
+		region.srcOffset = cmd.srcOffset;
+		region.dstOffset = cmd.dstOffset;
+		region.size = cmd.size;
+		vkCmdCopyBuffer(m_list.get(), src->buffer, dst->buffer, 1U, &region);
+	}
+
+	void VKCommandBackend::flush() noexcept {
+		if (m_tracker.pending()) {
+			prepareOutside();
+		}
+	}
+
+	StateTrackerStats const& VKCommandBackend::barrierStats() const noexcept {
+		return m_tracker.stats();
+	}
+
+	bool const VKCommandBackend::prepareDraw() noexcept {
+		if (m_tracker.pending()) {
+			prepareOutside();
+		}
+		if (!m_list.inPass()) {
+			if (!m_hasPass) {
+				OutputDebugStringA("ERROR : DRAW OUTSIDE RENDER PASS.\n");
+				return false;
+			}
+			m_list.beginPass(m_pass);
+		}
+		return true;
+	}
+
+	void VKCommandBackend::prepareOutside() noexcept {
+		m_list.endPass();
+		record();
+	}
+
+	void VKCommandBackend::record() noexcept {
+		if (!m_tracker.pending()) {
+			return;
+		}
+		m_images.clear();
+		m_buffers.clear();
+		VkMemoryBarrier memory = {};
+		memory.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		VkPipelineStageFlags srcStages = 0U;
+		VkPipelineStageFlags dstStages = 0U;
+
+		m_tracker.flush([this, &memory, &srcStages, &dstStages](StateTransition const& barrier) {
+			RenderResource const handle = { static_cast<unsigned int>(barrier.resource) };
+			VKResourceEntry const* const entry = m_table.getResource(handle);
+			if (entry == nullptr) {
+				return;
+			}
+			VKStateAccess src = to_vk_state(barrier.before);
+			VKStateAccess const dst = to_vk_state(barrier.after);
+			switch (barrier.kind) {
+			case BarrierKind::Begin:
+				//	イベントは使わず、終了のバリアで遷移前から遷移後へ一度に遷移する
+				return;
+			case BarrierKind::UnorderedAccess:
+				memory.srcAccessMask |= VK_ACCESS_SHADER_WRITE_BIT;
+				memory.dstAccessMask |= VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+				srcStages |= SHADER_STAGES;
+				dstStages |= SHADER_STAGES;
+				return;
+			case BarrierKind::Aliasing:
+				//	直前にメモリを使っていたリソースは問わず、全ての書き込みを待って内容を捨てる
+				src = { VK_IMAGE_LAYOUT_UNDEFINED, VK_ACCESS_MEMORY_WRITE_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT };
+				break;
+			default:
+				break;
+			}
+			srcStages |= src.stages;
+			dstStages |= dst.stages;
+			if (entry->image != VK_NULL_HANDLE) {
+				VkImageMemoryBarrier desc = {};
+				desc.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+				desc.srcAccessMask = src.access;
+				desc.dstAccessMask = dst.access;
+				desc.oldLayout = src.layout;
+				desc.newLayout = dst.layout;
+				desc.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+				desc.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+				desc.image = entry->image;
+				desc.subresourceRange = subresourceRange(*entry, barrier.subresource);
+				m_images.push_back(desc);
+			}
+			else {
+				VkBufferMemoryBarrier desc = {};
+				desc.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+				desc.srcAccessMask = src.access;
+				desc.dstAccessMask = dst.access;
+				desc.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+				desc.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+				desc.buffer = entry->buffer;
+				desc.size = VK_WHOLE_SIZE;
+				m_buffers.push_back(desc);
+			}
+		});
+
+		//	分割した遷移の開始だけなら記録するものは無い
+		if (srcStages == 0U) {
+			return;
+		}
+		bool const global = memory.srcAccessMask != 0U;
+		vkCmdPipelineBarrier(m_list.get(), srcStages, dstStages, 0U,
+			global ? 1U : 0U, global ? &memory : nullptr,
+			static_cast<unsigned int>(m_buffers.size()), m_buffers.data(),
+			static_cast<unsigned int>(m_images.size()), m_images.data());
+	}
+
+	VkPipelineBindPoint const VKCommandBackend::bindPoint() const noexcept {
+		return m_compute ? VK_PIPELINE_BIND_POINT_COMPUTE : VK_PIPELINE_BIND_POINT_GRAPHICS;
+	}
+
+	VkPipelineLayout const VKCommandBackend::layout() const noexcept {
+		return m_compute ? m_computeLayout : m_graphicsLayout;
+	}
+}
@@ -0,0 +1,137 @@
+﻿/**	@file	vk_cmd_list.cpp
+ *	@brief	Vulkan 用のコマンドリスト
+ */
+#include "vk/vk_cmd_list.hpp"
+#include "vk/vk_device.hpp"
+
+namespace dlph {
+	VKCommandList::VKCommandList(VKCommandList&& arg) noexcept :
+		VKCommandList()
+	{
+		m_pool = arg.m_pool;
+		m_list = arg.m_list;
+		m_inPass = arg.m_inPass;
+		arg.m_pool = VK_NULL_HANDLE;
+		arg.m_list = VK_NULL_HANDLE;
+		arg.m_inPass = false;
+	}
+
+	VKCommandList& VKCommandList::operator=(VKCommandList&& rhs) & noexcept {
+		exit();
+
+		m_pool = rhs.m_pool;
+		m_list = rhs.m_list;
+		m_inPass = rhs.m_inPass;
+		rhs.m_pool = VK_NULL_HANDLE;
+		rhs.m_list = VK_NULL_HANDLE;
+		rhs.m_inPass = false;
+
+		return *this;
+	}
+
+	VKCommandList::VKCommandList() noexcept :
+		INoncopyable(),
+		m_pool(VK_NULL_HANDLE),
+		m_list(VK_NULL_HANDLE),
+		m_inPass(false)
+	{}
+
+	VKCommandList::~VKCommandList() noexcept {
+		exit();
+	}
+
+	bool const VKCommandList::init(VKCommandType const& type) noexcept {
+		if (m_pool != VK_NULL_HANDLE && m_list != VK_NULL_HANDLE) {
+			return true;
+		}
+		if (type >= VKCommandType::Count) {
+			OutputDebugStringA("ERROR : THE TYPE SETTING IS INCOLLECT.\n");
+			return false;
+		}
+
+		VkDevice const device = VKDevice::getInstance().get();
+
+		VkCommandPoolCreateInfo pool = {};
+		pool.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		pool.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+		pool.queueFamilyIndex = VKDevice::getInstance().family(type);
+		if (vkCreateCommandPool(device, &pool, nullptr, &m_pool) != VK_SUCCESS) {
+			m_pool = VK_NULL_HANDLE;
+			OutputDebugStringA("ERROR : CREATE FAILD COMMAND POOL.\n");
+			return false;
+		}
+
+		VkCommandBufferAllocateInfo info = {};
+		info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		info.commandPool = m_pool;
+		info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		info.commandBufferCount = 1U;
+		if (vkAllocateCommandBuffers(device, &info, &m_list) != VK_SUCCESS) {
+			m_list = VK_NULL_HANDLE;
+			exit();
+			OutputDebugStringA("ERROR : CREATE FAILD COMMAND BUFFER.\n");
+			return false;
+		}
+
+		return true;
+	}
+
+	void VKCommandList::exit() noexcept {
+		//	コマンドバッファはプールと一緒に解放される
+		if (m_pool != VK_NULL_HANDLE) {
+			vkDestroyCommandPool(VKDevice::getInstance().get(), m_pool, nullptr);
+			m_pool = VK_NULL_HANDLE;
+		}
+		m_list = VK_NULL_HANDLE;
+		m_inPass = false;
+	}
+
+	bool const VKCommandList::recording() noexcept {
+		if (vkResetCommandPool(VKDevice::getInstance().get(), m_pool, 0U) != VK_SUCCESS) {
+			OutputDebugStringA("ERROR : RESET FAILD COMMAND POOL.\n");
+			return false;
+		}
+
+		VkCommandBufferBeginInfo info = {};
+		info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+		if (vkBeginCommandBuffer(m_list, &info) != VK_SUCCESS) {
+			OutputDebugStringA("ERROR : BEGIN FAILD COMMAND BUFFER.\n");
+			return false;
+		}
+
+		m_inPass = false;
+		return true;
+	}
+
+	bool const VKCommandList::closing() noexcept {
+		endPass();
+		if (vkEndCommandBuffer(m_list) != VK_SUCCESS) {
+			OutputDebugStringA("ERROR : CLOSE FAILD COMMAND BUFFER.\n");
+			return false;
+		}
+
+		return true;
+	}
+
+	void VKCommandList::beginPass(VkRenderPassBeginInfo const& info) noexcept {
+		endPass();
+		vkCmdBeginRenderPass(m_list, &info, VK_SUBPASS_CONTENTS_INLINE);
+		m_inPass = true;
+	}
+
+	void VKCommandList::endPass() noexcept {
+		if (m_inPass) {
+			vkCmdEndRenderPass(m_list);
+			m_inPass = false;
+		}
+	}
+
+	bool const VKCommandList::inPass() const noexcept {
+		return m_inPass;
+	}
+
+	VkCommandBuffer VKCommandList::get() const noexcept {
+		return m_list;
+	}
+}
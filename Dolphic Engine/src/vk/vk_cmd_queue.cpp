@@ -0,0 +1,141 @@
+﻿/**	@file	vk_cmd_queue.cpp
+ *	@brief	Vulkan 用のコマンドキュー
+ */
+#include "vk/vk_cmd_queue.hpp"
+#include "vk/vk_device.hpp"
+#include "vk/vk_fence.hpp"
+
+namespace dlph {
+	VKCommandQueue::VKCommandQueue(VKCommandQueue&& arg) noexcept :
+		VKCommandQueue()
+	{
+		m_queue = arg.m_queue;
+		m_type = arg.m_type;
+		arg.m_queue = VK_NULL_HANDLE;
+	}
+
+	VKCommandQueue& VKCommandQueue::operator=(VKCommandQueue&& rhs) & noexcept {
+		exit();
+
+		m_queue = rhs.m_queue;
+		m_type = rhs.m_type;
+		rhs.m_queue = VK_NULL_HANDLE;
+
+		return *this;
+	}
+
+	VKCommandQueue::VKCommandQueue() noexcept :
+		INoncopyable(),
+		m_queue(VK_NULL_HANDLE),
+		m_type(VKCommandType::Graphics)
+	{}
+
+	VKCommandQueue::~VKCommandQueue() noexcept {
+		exit();
+	}
+
+	bool const VKCommandQueue::init(VKCommandType const& type) noexcept {
+		if (type >= VKCommandType::Count) {
+			OutputDebugStringA("ERROR : THE TYPE SETTING IS INCOLLECT.\n");
+			return false;
+		}
+
+		m_queue = VKDevice::getInstance().queue(type);
+		m_type = type;
+		if (m_queue == VK_NULL_HANDLE) {
+			OutputDebugStringA("ERROR : VULKAN DEVICE IS NOT INITIALIZED.\n");
+			return false;
+		}
+
+		return true;
+	}
+
+	void VKCommandQueue::exit() noexcept {
+		m_queue = VK_NULL_HANDLE;
+	}
+
+	bool const VKCommandQueue::submit(VkCommandBuffer const* cmds, unsigned int const& count, VKFence const& fence, uint64_t const& value,
+		VKFence const* wait, uint64_t const& waitValue, VkPipelineStageFlags const& waitStage) const noexcept
+	{
+		VkSemaphore const signalSemaphore = fence.get();
+		VkSemaphore const waitSemaphore = wait ? wait->get() : VK_NULL_HANDLE;
+
+		VkTimelineSemaphoreSubmitInfo timeline = {};
+		timeline.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+		timeline.waitSemaphoreValueCount = wait ? 1U : 0U;
+		timeline.pWaitSemaphoreValues = wait ? &waitValue : nullptr;
+		timeline.signalSemaphoreValueCount = 1U;
+		timeline.pSignalSemaphoreValues = &value;
+
+		VkSubmitInfo info = {};
+		info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		info.pNext = &timeline;
+		info.waitSemaphoreCount = wait ? 1U : 0U;
+		info.pWaitSemaphores = wait ? &waitSemaphore : nullptr;
+		info.pWaitDstStageMask = wait ? &waitStage : nullptr;
+		info.commandBufferCount = count;
+		info.pCommandBuffers = cmds;
+		info.signalSemaphoreCount = 1U;
+		info.pSignalSemaphores = &signalSemaphore;
+
+		std::lock_guard<std::mutex> const lock(VKDevice::getInstance().queueMutex(m_type));
+		if (vkQueueSubmit(m_queue, 1U, &info, VK_NULL_HANDLE) != VK_SUCCESS) {
+			OutputDebugStringA("ERROR : VULKAN QUEUE SUBMISSION FAILED.\n");
+			return false;
+		}
+
+		return true;
+	}
+
+	bool const VKCommandQueue::submit(VkCommandBuffer const* cmds, unsigned int const& count, VKFence const& fence, uint64_t const& value,
+		VkSemaphore const& wait, VkPipelineStageFlags const& waitStage, VkSemaphore const& signal) const noexcept
+	{
+		VkSemaphore const signalSemaphores[] = { fence.get(), signal };
+		//	値の配列はセマフォの数と揃える (バイナリセマフォの値は無視される)
+		uint64_t const waitValue = 0U;
+		uint64_t const signalValues[] = { value, 0U };
+
+		VkTimelineSemaphoreSubmitInfo timeline = {};
+		timeline.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+		timeline.waitSemaphoreValueCount = 1U;
+		timeline.pWaitSemaphoreValues = &waitValue;
+		timeline.signalSemaphoreValueCount = 2U;
+		timeline.pSignalSemaphoreValues = signalValues;
+
+		VkSubmitInfo info = {};
+		info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		info.pNext = &timeline;
+		info.waitSemaphoreCount = 1U;
+		info.pWaitSemaphores = &wait;
+		info.pWaitDstStageMask = &waitStage;
+		info.commandBufferCount = count;
+		info.pCommandBuffers = cmds;
+		info.signalSemaphoreCount = 2U;
+		info.pSignalSemaphores = signalSemaphores;
+
+		std::lock_guard<std::mutex> const lock(VKDevice::getInstance().queueMutex(m_type));
+		if (vkQueueSubmit(m_queue, 1U, &info, VK_NULL_HANDLE) != VK_SUCCESS) {
+			OutputDebugStringA("ERROR : VULKAN QUEUE SUBMISSION FAILED.\n");
+			return false;
+		}
+
+		return true;
+	}
+
+	void VKCommandQueue::waitIdle() const noexcept {
+		std::lock_guard<std::mutex> const lock(VKDevice::getInstance().queueMutex(m_type));
+		vkQueueWaitIdle(m_queue);
+	}
+
+	VkQueue VKCommandQueue::get() const noexcept {
+		return m_queue;
+	}
+
+	VKCommandType const VKCommandQueue::type() const noexcept {
+		return m_type;
+	}
+
+	unsigned int const VKCommandQueue::family() const noexcept {
+		return VKDevice::getInstance().family(m_type);
+	}
+}
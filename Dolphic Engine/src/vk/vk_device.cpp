@@ -0,0 +1,273 @@
+﻿/**	@file	vk_device.cpp
+ *	@brief	Vulkan 用のデバイスクラス
+ */
+#include "vk/vk_device.hpp"
+#include "vk/vk_instance.hpp"
+#include <cstring>
+#include <vector>
+
+namespace {
+	using namespace dlph;
+
+	//!	@brief	物理デバイスの種類ごとの優先度
+	unsigned int const type_score(VkPhysicalDeviceType const& type) noexcept {
+		switch (type) {
+		case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:
+			return 4U;
+		case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU:
+			return 3U;
+		case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:
+			return 2U;
+		case VK_PHYSICAL_DEVICE_TYPE_CPU:
+			return 1U;
+		default:
+			return 0U;
+		}
+	}
+
+	//!	@brief	キューファミリーの取得関数
+	std::vector<VkQueueFamilyProperties> const queue_families(VkPhysicalDevice const& device) noexcept {
+		unsigned int count = 0U;
+		vkGetPhysicalDeviceQueueFamilyProperties(device, &count, nullptr);
+		std::vector<VkQueueFamilyProperties> families(count);
+		vkGetPhysicalDeviceQueueFamilyProperties(device, &count, families.data());
+		return families;
+	}
+
+	/**	@brief	キューファミリーの検索関数
+	 *	@param[in] families キューファミリー
+	 *	@param[in] flags 必要な機能
+	 *	@param[in] excluded 持っていてはいけない機能
+	 *	@return ファミリー番号 (無ければ ~0U)
+	 */
+	unsigned int const find_family(std::vector<VkQueueFamilyProperties> const& families, VkQueueFlags const& flags, VkQueueFlags const& excluded) noexcept {
+		for (unsigned int idx = 0U; idx < families.size(); ++idx) {
+			if (families[idx].queueCount > 0U && (families[idx].queueFlags & flags) == flags && (families[idx].queueFlags & excluded) == 0U) {
+				return idx;
+			}
+		}
+		return ~0U;
+	}
+
+	//!	@brief	デバイスの拡張があるかどうか
+	bool const has_extension(VkPhysicalDevice const& device, char const* name) noexcept {
+		unsigned int count = 0U;
+		vkEnumerateDeviceExtensionProperties(device, nullptr, &count, nullptr);
+		std::vector<VkExtensionProperties> extensions(count);
+		if (count == 0U || vkEnumerateDeviceExtensionProperties(device, nullptr, &count, extensions.data()) != VK_SUCCESS) {
+			return false;
+		}
+		for (VkExtensionProperties const& extension : extensions) {
+			if (std::strcmp(extension.extensionName, name) == 0) {
+				return true;
+			}
+		}
+		return false;
+	}
+}
+
+namespace dlph {
+	VKDevice::VKDevice() noexcept :
+		ISingleton(),
+		m_physical(VK_NULL_HANDLE),
+		m_device(VK_NULL_HANDLE),
+		m_queues(),
+		m_families(),
+		m_indices(),
+		m_locks(),
+		m_mutexes(),
+		m_properties(),
+		m_memory(),
+		m_presentable(false)
+	{}
+
+	VKDevice::~VKDevice() noexcept {
+		exit();
+	}
+
+	bool const VKDevice::init(char const* name) noexcept {
+		if (m_device != VK_NULL_HANDLE) {
+			return true;
+		}
+		if (!select(name)) {
+			return false;
+		}
+
+		//	コンピュートとコピーは専用のファミリーを優先し、無ければグラフィックスと共有する
+		std::vector<VkQueueFamilyProperties> const families = queue_families(m_physical);
+		unsigned int const graphics = find_family(families, VK_QUEUE_GRAPHICS_BIT, 0U);
+		unsigned int compute = find_family(families, VK_QUEUE_COMPUTE_BIT, VK_QUEUE_GRAPHICS_BIT);
+		if (compute == ~0U) {
+			compute = graphics;
+		}
+		unsigned int transfer = find_family(families, VK_QUEUE_TRANSFER_BIT, VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT);
+		if (transfer == ~0U) {
+			transfer = compute;
+		}
+		m_families[static_cast<unsigned int>(VKCommandType::Graphics)] = graphics;
+		m_families[static_cast<unsigned int>(VKCommandType::Compute)] = compute;
+		m_families[static_cast<unsigned int>(VKCommandType::Transfer)] = transfer;
+
+		//	同じファミリーに割り当てた種類は、キューが足りる限り別のキューを使う
+		std::vector<unsigned int> requested(families.size(), 0U);
+		for (unsigned int type = 0U; type < VK_QUEUE_TYPE_CNT; ++type) {
+			unsigned int const family = m_families[type];
+			m_indices[type] = requested[family] < families[family].queueCount ? requested[family]++ : families[family].queueCount - 1U;
+		}
+
+		float const priorities[VK_QUEUE_TYPE_CNT] = { 1.0f, 1.0f, 1.0f };
+		std::vector<VkDeviceQueueCreateInfo> queues;
+		for (unsigned int family = 0U; family < families.size(); ++family) {
+			if (requested[family] == 0U) {
+				continue;
+			}
+			VkDeviceQueueCreateInfo queue = {};
+			queue.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+			queue.queueFamilyIndex = family;
+			queue.queueCount = requested[family];
+			queue.pQueuePriorities = priorities;
+			queues.push_back(queue);
+		}
+
+		VkPhysicalDeviceTimelineSemaphoreFeatures timeline = {};
+		timeline.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+		timeline.timelineSemaphore = VK_TRUE;
+
+		//	表示はサーフェスの拡張があるときだけ使い、無くてもオフスクリーンで描ける
+		char const* const swapchain = VK_KHR_SWAPCHAIN_EXTENSION_NAME;
+		m_presentable = VKInstance::getInstance().enabled(VK_KHR_SURFACE_EXTENSION_NAME) && has_extension(m_physical, swapchain);
+
+		VkDeviceCreateInfo info = {};
+		info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+		info.pNext = &timeline;
+		info.queueCreateInfoCount = static_cast<unsigned int>(queues.size());
+		info.pQueueCreateInfos = queues.data();
+		info.enabledExtensionCount = m_presentable ? 1U : 0U;
+		info.ppEnabledExtensionNames = m_presentable ? &swapchain : nullptr;
+
+		if (vkCreateDevice(m_physical, &info, nullptr, &m_device) != VK_SUCCESS) {
+			m_device = VK_NULL_HANDLE;
+			m_presentable = false;
+			OutputDebugStringA("ERROR : CREATE FAILED VULKAN DEVICE.\n");
+			return false;
+		}
+
+		for (unsigned int type = 0U; type < VK_QUEUE_TYPE_CNT; ++type) {
+			vkGetDeviceQueue(m_device, m_families[type], m_indices[type], &m_queues[type]);
+			m_locks[type] = type;
+			for (unsigned int prev = 0U; prev < type; ++prev) {
+				if (m_families[prev] == m_families[type] && m_indices[prev] == m_indices[type]) {
+					m_locks[type] = m_locks[prev];
+					break;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	void VKDevice::exit() noexcept {
+		if (m_device != VK_NULL_HANDLE) {
+			vkDeviceWaitIdle(m_device);
+			vkDestroyDevice(m_device, nullptr);
+			m_device = VK_NULL_HANDLE;
+		}
+		m_physical = VK_NULL_HANDLE;
+		for (unsigned int type = 0U; type < VK_QUEUE_TYPE_CNT; ++type) {
+			m_queues[type] = VK_NULL_HANDLE;
+		}
+		m_presentable = false;
+	}
+
+	VkDevice VKDevice::get() const noexcept {
+		return m_device;
+	}
+
+	VkPhysicalDevice VKDevice::physical() const noexcept {
+		return m_physical;
+	}
+
+	VkQueue VKDevice::queue(VKCommandType const& type) const noexcept {
+		return m_queues[static_cast<unsigned int>(type)];
+	}
+
+	unsigned int const VKDevice::family(VKCommandType const& type) const noexcept {
+		return m_families[static_cast<unsigned int>(type)];
+	}
+
+	std::mutex& VKDevice::queueMutex(VKCommandType const& type) noexcept {
+		return m_mutexes[m_locks[static_cast<unsigned int>(type)]];
+	}
+
+	VkPhysicalDeviceProperties const& VKDevice::properties() const noexcept {
+		return m_properties;
+	}
+
+	VkPhysicalDeviceMemoryProperties const& VKDevice::memoryProperties() const noexcept {
+		return m_memory;
+	}
+
+	void VKDevice::waitIdle() const noexcept {
+		if (m_device != VK_NULL_HANDLE) {
+			vkDeviceWaitIdle(m_device);
+		}
+	}
+
+	bool const VKDevice::presentable() const noexcept {
+		return m_presentable;
+	}
+
+	bool const VKDevice::select(char const* name) noexcept {
+		VkInstance const instance = VKInstance::getInstance().get();
+		if (instance == VK_NULL_HANDLE) {
+			OutputDebugStringA("ERROR : VULKAN INSTANCE IS NOT INITIALIZED.\n");
+			return false;
+		}
+
+		unsigned int count = 0U;
+		vkEnumeratePhysicalDevices(instance, &count, nullptr);
+		std::vector<VkPhysicalDevice> devices(count);
+		if (count == 0U || vkEnumeratePhysicalDevices(instance, &count, devices.data()) != VK_SUCCESS) {
+			OutputDebugStringA("ERROR : VULKAN PHYSICAL DEVICE IS NOT FOUND.\n");
+			return false;
+		}
+
+		unsigned int best = 0U;
+		m_physical = VK_NULL_HANDLE;
+		for (VkPhysicalDevice const& device : devices) {
+			VkPhysicalDeviceProperties properties = {};
+			vkGetPhysicalDeviceProperties(device, &properties);
+			if (properties.apiVersion < VK_INSTANCE_API_VERSION) {
+				continue;
+			}
+
+			VkPhysicalDeviceTimelineSemaphoreFeatures timeline = {};
+			timeline.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+			VkPhysicalDeviceFeatures2 features = {};
+			features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+			features.pNext = &timeline;
+			vkGetPhysicalDeviceFeatures2(device, &features);
+			if (timeline.timelineSemaphore != VK_TRUE || find_family(queue_families(device), VK_QUEUE_GRAPHICS_BIT, 0U) == ~0U) {
+				continue;
+			}
+
+			//	名前の指定に合うものは種類に関係なく優先する
+			unsigned int score = type_score(properties.deviceType) + 1U;
+			if (name && std::strstr(properties.deviceName, name)) {
+				score += 8U;
+			}
+			if (score > best) {
+				best = score;
+				m_physical = device;
+				m_properties = properties;
+			}
+		}
+		if (m_physical == VK_NULL_HANDLE) {
+			OutputDebugStringA("ERROR : VULKAN 1.2 DEVICE WITH TIMELINE SEMAPHORE IS NOT FOUND.\n");
+			return false;
+		}
+
+		vkGetPhysicalDeviceMemoryProperties(m_physical, &m_memory);
+		return true;
+	}
+}
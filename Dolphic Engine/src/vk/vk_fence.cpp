@@ -0,0 +1,114 @@
+﻿/**	@file	vk_fence.cpp
+ *	@brief	Vulkan 用のフェンス (タイムラインセマフォ)
+ */
+#include "vk/vk_fence.hpp"
+#include "vk/vk_device.hpp"
+
+namespace dlph {
+	VKFence::VKFence(VKFence&& arg) noexcept :
+		VKFence()
+	{
+		m_semaphore = arg.m_semaphore;
+		arg.m_semaphore = VK_NULL_HANDLE;
+	}
+
+	VKFence& VKFence::operator=(VKFence&& rhs) & noexcept {
+		exit();
+
+		m_semaphore = rhs.m_semaphore;
+		rhs.m_semaphore = VK_NULL_HANDLE;
+
+		return *this;
+	}
+
+	VKFence::VKFence() noexcept :
+		INoncopyable(),
+		m_semaphore(VK_NULL_HANDLE)
+	{}
+
+	VKFence::~VKFence() noexcept {
+		exit();
+	}
+
+	bool const VKFence::init(uint64_t const& initial) noexcept {
+		if (m_semaphore != VK_NULL_HANDLE) {
+			return true;
+		}
+
+		VkSemaphoreTypeCreateInfo type = {};
+		type.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+		type.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+		type.initialValue = initial;
+
+		VkSemaphoreCreateInfo info = {};
+		info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+		info.pNext = &type;
+
+		if (vkCreateSemaphore(VKDevice::getInstance().get(), &info, nullptr, &m_semaphore) != VK_SUCCESS) {
+			m_semaphore = VK_NULL_HANDLE;
+			OutputDebugStringA("ERROR : CREATE FAILED VULKAN TIMELINE SEMAPHORE.\n");
+			return false;
+		}
+
+		return true;
+	}
+
+	void VKFence::exit() noexcept {
+		if (m_semaphore != VK_NULL_HANDLE) {
+			vkDestroySemaphore(VKDevice::getInstance().get(), m_semaphore, nullptr);
+			m_semaphore = VK_NULL_HANDLE;
+		}
+	}
+
+	bool const VKFence::signal(VKCommandQueue const& queue, uint64_t const& value) noexcept {
+		return queue.submit(nullptr, 0U, *this, value);
+	}
+
+	bool const VKFence::signal(uint64_t const& value) noexcept {
+		VkSemaphoreSignalInfo info = {};
+		info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SIGNAL_INFO;
+		info.semaphore = m_semaphore;
+		info.value = value;
+
+		if (vkSignalSemaphore(VKDevice::getInstance().get(), &info) != VK_SUCCESS) {
+			OutputDebugStringA("ERROR : SIGNAL PROCESS FAILED.\n");
+			return false;
+		}
+
+		return true;
+	}
+
+	bool const VKFence::waitFor(uint64_t const& value, uint64_t const& timeout) noexcept {
+		if (value == 0U || completed() >= value) {
+			return true;
+		}
+
+		VkSemaphoreWaitInfo info = {};
+		info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+		info.semaphoreCount = 1U;
+		info.pSemaphores = &m_semaphore;
+		info.pValues = &value;
+
+		VkResult const result = vkWaitSemaphores(VKDevice::getInstance().get(), &info, timeout);
+		if (result != VK_SUCCESS) {
+			if (result != VK_TIMEOUT) {
+				OutputDebugStringA("ERROR : WAITING FOR TIMELINE SEMAPHORE FAILED.\n");
+			}
+			return false;
+		}
+
+		return true;
+	}
+
+	uint64_t const VKFence::completed() const noexcept {
+		uint64_t value = 0U;
+		if (m_semaphore != VK_NULL_HANDLE) {
+			vkGetSemaphoreCounterValue(VKDevice::getInstance().get(), m_semaphore, &value);
+		}
+		return value;
+	}
+
+	VkSemaphore VKFence::get() const noexcept {
+		return m_semaphore;
+	}
+}
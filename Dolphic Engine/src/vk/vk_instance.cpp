@@ -0,0 +1,139 @@
+﻿/**	@file	vk_instance.cpp
+ *	@brief	Vulkan のインスタンスクラス
+ */
+#include "vk/vk_instance.hpp"
+#include <cstring>
+#include <vector>
+
+namespace {
+	//!	@brief	あれば有効にするサーフェスの拡張 (先頭の VK_KHR_surface が無ければ他も使いません)
+	static char const* const SURFACE_EXTENSIONS[] = {
+		VK_KHR_SURFACE_EXTENSION_NAME,
+#if	defined(_WIN32)
+		"VK_KHR_win32_surface",
+#endif
+		VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME,
+	};
+
+	//!	@brief	インスタンスの拡張があるかどうか
+	bool const has_extension(std::vector<VkExtensionProperties> const& extensions, char const* name) noexcept {
+		for (VkExtensionProperties const& extension : extensions) {
+			if (std::strcmp(extension.extensionName, name) == 0) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+#if	defined(_DEBUG) || defined(DEBUG)
+	//!	@brief	検証レイヤーの名前
+	static char const* const VALIDATION_LAYER = "VK_LAYER_KHRONOS_validation";
+
+	//!	@brief	レイヤーがあるかどうか
+	bool const has_layer(char const* name) noexcept {
+		unsigned int count = 0U;
+		if (vkEnumerateInstanceLayerProperties(&count, nullptr) != VK_SUCCESS) {
+			return false;
+		}
+		std::vector<VkLayerProperties> layers(count);
+		if (vkEnumerateInstanceLayerProperties(&count, layers.data()) != VK_SUCCESS) {
+			return false;
+		}
+		for (VkLayerProperties const& layer : layers) {
+			if (std::strcmp(layer.layerName, name) == 0) {
+				return true;
+			}
+		}
+		return false;
+	}
+#endif
+}
+
+namespace dlph {
+	VKInstance::VKInstance() noexcept :
+		ISingleton(),
+		m_instance(VK_NULL_HANDLE),
+		m_extensions()
+	{}
+
+	VKInstance::~VKInstance() noexcept {
+		exit();
+	}
+
+	bool const VKInstance::init(std::string const& name) noexcept {
+		if (m_instance != VK_NULL_HANDLE) {
+			return true;
+		}
+
+		unsigned int version = VK_API_VERSION_1_0;
+		if (vkEnumerateInstanceVersion(&version) != VK_SUCCESS || version < VK_INSTANCE_API_VERSION) {
+			OutputDebugStringA("ERROR : VULKAN LOADER DOES NOT SUPPORT VERSION 1.2.\n");
+			return false;
+		}
+
+		VkApplicationInfo app = {};
+		app.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+		app.pApplicationName = name.c_str();
+		app.applicationVersion = 1U;
+		app.pEngineName = "Dolphic Engine";
+		app.engineVersion = 1U;
+		app.apiVersion = VK_INSTANCE_API_VERSION;
+
+		unsigned int count = 0U;
+		vkEnumerateInstanceExtensionProperties(nullptr, &count, nullptr);
+		std::vector<VkExtensionProperties> extensions(count);
+		if (count > 0U && vkEnumerateInstanceExtensionProperties(nullptr, &count, extensions.data()) != VK_SUCCESS) {
+			extensions.clear();
+		}
+		m_extensions.clear();
+		if (has_extension(extensions, SURFACE_EXTENSIONS[0])) {
+			for (char const* const& name : SURFACE_EXTENSIONS) {
+				if (has_extension(extensions, name)) {
+					m_extensions.push_back(name);
+				}
+			}
+		}
+
+		VkInstanceCreateInfo info = {};
+		info.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+		info.pApplicationInfo = &app;
+		info.enabledExtensionCount = static_cast<unsigned int>(m_extensions.size());
+		info.ppEnabledExtensionNames = m_extensions.data();
+#if	defined(_DEBUG) || defined(DEBUG)
+		if (has_layer(VALIDATION_LAYER)) {
+			info.enabledLayerCount = 1U;
+			info.ppEnabledLayerNames = &VALIDATION_LAYER;
+		}
+#endif
+
+		if (vkCreateInstance(&info, nullptr, &m_instance) != VK_SUCCESS) {
+			m_instance = VK_NULL_HANDLE;
+			m_extensions.clear();
+			OutputDebugStringA("ERROR : CREATE FAILED VULKAN INSTANCE.\n");
+			return false;
+		}
+
+		return true;
+	}
+
+	void VKInstance::exit() noexcept {
+		if (m_instance != VK_NULL_HANDLE) {
+			vkDestroyInstance(m_instance, nullptr);
+			m_instance = VK_NULL_HANDLE;
+		}
+		m_extensions.clear();
+	}
+
+	VkInstance VKInstance::get() const noexcept {
+		return m_instance;
+	}
+
+	bool const VKInstance::enabled(char const* name) const noexcept {
+		for (char const* const& extension : m_extensions) {
+			if (std::strcmp(extension, name) == 0) {
+				return true;
+			}
+		}
+		return false;
+	}
+}
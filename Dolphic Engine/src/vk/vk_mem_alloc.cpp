@@ -0,0 +1,286 @@
+﻿/**	@file	vk_mem_alloc.cpp
+ *	@brief	Vulkan 用の GPU メモリ確保器
+ */
+#include "vk/vk_mem_alloc.hpp"
+#include "vk/vk_device.hpp"
+
+namespace dlph {
+	VKMemoryAllocator::VKMemoryAllocator() noexcept :
+		ISingleton(),
+		m_pages(),
+		m_mutex()
+	{}
+
+	VKMemoryAllocator::~VKMemoryAllocator() noexcept {
+		exit();
+	}
+
+	bool const VKMemoryAllocator::init() noexcept {
+		if (VKDevice::getInstance().get() == VK_NULL_HANDLE) {
+			OutputDebugStringA("ERROR : VULKAN DEVICE IS NOT INITIALIZED.\n");
+			return false;
+		}
+		//	ページは用途ごとに要求が来た時点で作る
+		return true;
+	}
+
+	void VKMemoryAllocator::exit() noexcept {
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		VkDevice const device = VKDevice::getInstance().get();
+		for (Page& page : m_pages) {
+			if (page.memory != VK_NULL_HANDLE) {
+				//	マップしたままのメモリも解放でアンマップされる
+				vkFreeMemory(device, page.memory, nullptr);
+				page.memory = VK_NULL_HANDLE;
+			}
+			page.blocks.exit();
+		}
+		m_pages.clear();
+	}
+
+	VKAllocation const VKMemoryAllocator::allocate(VkMemoryRequirements const& requirements, VKMemoryUsage const& usage, bool const& linear) noexcept {
+		VKAllocation result = {};
+		if (requirements.size == 0U) {
+			OutputDebugStringA("ERROR : RESOURCE ALLOCATION SIZE IS INVALID.\n");
+			return result;
+		}
+		unsigned int const type = findType(requirements.memoryTypeBits, usage);
+		if (type == ~0U) {
+			OutputDebugStringA("ERROR : NOT FOUND SUITABLE VULKAN MEMORY TYPE.\n");
+			return result;
+		}
+		uint64_t const alignment = requirements.alignment > 0U ? requirements.alignment : 1U;
+
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		unsigned int page = 0U;
+		unsigned int block = TLSF_INVALID;
+		if (requirements.size <= VK_MEMORY_PAGE_SIZE) {
+			for (; page < m_pages.size(); ++page) {
+				Page& target = m_pages[page];
+				if (target.memory == VK_NULL_HANDLE || target.type != type || target.linear != linear ||
+					target.blocks.capacity() != VK_MEMORY_PAGE_SIZE)
+				{
+					continue;
+				}
+				block = target.blocks.allocate(requirements.size, alignment);
+				if (block != TLSF_INVALID) {
+					break;
+				}
+			}
+		}
+		if (block == TLSF_INVALID) {
+			//	収まるページが無ければ増やす (大きすぎる要求は専用のページにする)
+			uint64_t const size = requirements.size > VK_MEMORY_PAGE_SIZE
+				? (requirements.size + alignment - 1U) & ~(alignment - 1U)
+				: VK_MEMORY_PAGE_SIZE;
+			page = createPage(size, type, linear);
+			if (page == TLSF_INVALID) {
+				return result;
+			}
+			block = m_pages[page].blocks.allocate(requirements.size, alignment);
+			if (block == TLSF_INVALID) {
+				OutputDebugStringA("ERROR : GPU MEMORY PAGE CAN NOT HOLD THE RESOURCE.\n");
+				return result;
+			}
+		}
+
+		Page const& target = m_pages[page];
+		result.memory = target.memory;
+		result.offset = target.blocks.offset(block);
+		result.size = target.blocks.size(block);
+		result.mapped = target.mapped ? static_cast<unsigned char*>(target.mapped) + result.offset : nullptr;
+		result.page = page;
+		result.block = block;
+		return result;
+	}
+
+	void VKMemoryAllocator::release(VKAllocation& allocation) noexcept {
+		if (allocation.memory == VK_NULL_HANDLE) {
+			return;
+		}
+
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		Page& page = m_pages[allocation.page];
+		page.blocks.release(allocation.block);
+		//	専用のページは空になった時点で返す
+		if (page.blocks.used() == 0U && page.blocks.capacity() != VK_MEMORY_PAGE_SIZE) {
+			vkFreeMemory(VKDevice::getInstance().get(), page.memory, nullptr);
+			page.memory = VK_NULL_HANDLE;
+			page.mapped = nullptr;
+			page.blocks.exit();
+		}
+		allocation = {};
+	}
+
+	bool const VKMemoryAllocator::createBuffer(uint64_t const& bytes, VkBufferUsageFlags const& flags, VKMemoryUsage const& usage,
+		VKAllocation& allocation, VkBuffer& buffer) noexcept
+	{
+		VkDevice const device = VKDevice::getInstance().get();
+
+		VkBufferCreateInfo info = {};
+		info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+		info.size = bytes;
+		info.usage = flags;
+		info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		if (vkCreateBuffer(device, &info, nullptr, &buffer) != VK_SUCCESS) {
+			buffer = VK_NULL_HANDLE;
+			OutputDebugStringA("ERROR : CREATE FAILED VULKAN BUFFER.\n");
+			return false;
+		}
+
+		VkMemoryRequirements requirements = {};
+		vkGetBufferMemoryRequirements(device, buffer, &requirements);
+		allocation = allocate(requirements, usage, true);
+		if (allocation.memory == VK_NULL_HANDLE) {
+			vkDestroyBuffer(device, buffer, nullptr);
+			buffer = VK_NULL_HANDLE;
+			return false;
+		}
+
+		if (vkBindBufferMemory(device, buffer, allocation.memory, allocation.offset) != VK_SUCCESS) {
+			destroyBuffer(allocation, buffer);
+			OutputDebugStringA("ERROR : BIND FAILED VULKAN BUFFER MEMORY.\n");
+			return false;
+		}
+
+		return true;
+	}
+
+	bool const VKMemoryAllocator::createImage(VkImageCreateInfo const& info, VKAllocation& allocation, VkImage& image) noexcept {
+		VkDevice const device = VKDevice::getInstance().get();
+
+		if (vkCreateImage(device, &info, nullptr, &image) != VK_SUCCESS) {
+			image = VK_NULL_HANDLE;
+			OutputDebugStringA("ERROR : CREATE FAILED VULKAN IMAGE.\n");
+			return false;
+		}
+
+		VkMemoryRequirements requirements = {};
+		vkGetImageMemoryRequirements(device, image, &requirements);
+		allocation = allocate(requirements, VKMemoryUsage::Device, info.tiling == VK_IMAGE_TILING_LINEAR);
+		if (allocation.memory == VK_NULL_HANDLE) {
+			vkDestroyImage(device, image, nullptr);
+			image = VK_NULL_HANDLE;
+			return false;
+		}
+
+		if (vkBindImageMemory(device, image, allocation.memory, allocation.offset) != VK_SUCCESS) {
+			destroyImage(allocation, image);
+			OutputDebugStringA("ERROR : BIND FAILED VULKAN IMAGE MEMORY.\n");
+			return false;
+		}
+
+		return true;
+	}
+
+	void VKMemoryAllocator::destroyBuffer(VKAllocation& allocation, VkBuffer& buffer) noexcept {
+		if (buffer != VK_NULL_HANDLE) {
+			vkDestroyBuffer(VKDevice::getInstance().get(), buffer, nullptr);
+			buffer = VK_NULL_HANDLE;
+		}
+		release(allocation);
+	}
+
+	void VKMemoryAllocator::destroyImage(VKAllocation& allocation, VkImage& image) noexcept {
+		if (image != VK_NULL_HANDLE) {
+			vkDestroyImage(VKDevice::getInstance().get(), image, nullptr);
+			image = VK_NULL_HANDLE;
+		}
+		release(allocation);
+	}
+
+	uint64_t const VKMemoryAllocator::used() noexcept {
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		uint64_t result = 0U;
+		for (Page const& page : m_pages) {
+			result += page.blocks.used();
+		}
+		return result;
+	}
+
+	uint64_t const VKMemoryAllocator::reserved() noexcept {
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		uint64_t result = 0U;
+		for (Page const& page : m_pages) {
+			result += page.blocks.capacity();
+		}
+		return result;
+	}
+
+	unsigned int const VKMemoryAllocator::findType(unsigned int const& bits, VKMemoryUsage const& usage) const noexcept {
+		VkPhysicalDeviceMemoryProperties const& properties = VKDevice::getInstance().memoryProperties();
+
+		VkMemoryPropertyFlags required = 0U;
+		VkMemoryPropertyFlags preferred = 0U;
+		switch (usage) {
+		case VKMemoryUsage::Device:
+			required = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+			break;
+		case VKMemoryUsage::Upload:
+			required = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+			break;
+		case VKMemoryUsage::Readback:
+			required = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+			preferred = VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+			break;
+		default:
+			return ~0U;
+		}
+
+		//	必須の性質を満たすもののうち、望ましい性質を持つ最初の型を選ぶ (型はドライバが性能順に並べている)
+		unsigned int result = ~0U;
+		for (unsigned int i = 0U; i < properties.memoryTypeCount; ++i) {
+			VkMemoryPropertyFlags const flags = properties.memoryTypes[i].propertyFlags;
+			if ((bits & (1U << i)) == 0U || (flags & required) != required) {
+				continue;
+			}
+			if ((flags & preferred) == preferred) {
+				return i;
+			}
+			if (result == ~0U) {
+				result = i;
+			}
+		}
+		return result;
+	}
+
+	unsigned int const VKMemoryAllocator::createPage(uint64_t const& size, unsigned int const& type, bool const& linear) noexcept {
+		VkDevice const device = VKDevice::getInstance().get();
+
+		VkMemoryAllocateInfo info = {};
+		info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		info.allocationSize = size;
+		info.memoryTypeIndex = type;
+
+		VkDeviceMemory memory = VK_NULL_HANDLE;
+		if (vkAllocateMemory(device, &info, nullptr, &memory) != VK_SUCCESS) {
+			OutputDebugStringA("ERROR : ALLOCATE FAILED VULKAN DEVICE MEMORY.\n");
+			return TLSF_INVALID;
+		}
+
+		void* mapped = nullptr;
+		VkMemoryPropertyFlags const flags = VKDevice::getInstance().memoryProperties().memoryTypes[type].propertyFlags;
+		if ((flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0U &&
+			vkMapMemory(device, memory, 0U, VK_WHOLE_SIZE, 0U, &mapped) != VK_SUCCESS)
+		{
+			vkFreeMemory(device, memory, nullptr);
+			OutputDebugStringA("ERROR : MAP FAILED VULKAN DEVICE MEMORY.\n");
+			return TLSF_INVALID;
+		}
+
+		//	専用ページを返した跡があれば使い回す
+		unsigned int page = 0U;
+		while (page < m_pages.size() && m_pages[page].memory != VK_NULL_HANDLE) {
+			++page;
+		}
+		if (page == m_pages.size()) {
+			m_pages.emplace_back();
+		}
+		m_pages[page].memory = memory;
+		m_pages[page].mapped = mapped;
+		m_pages[page].type = type;
+		m_pages[page].linear = linear;
+		m_pages[page].blocks.init(size);
+		return page;
+	}
+}
@@ -0,0 +1,578 @@
+﻿/**	@file	vk_rend.cpp
+ *	@brief	Vulkan を利用したレンダラ
+ */
+#include "vk/vk_rend.hpp"
+#include "vk/vk_instance.hpp"
+#include "vk/vk_device.hpp"
+#include "dlph/dlph_state_filter.hpp"
+#include <cstring>
+
+namespace {
+	using namespace dlph;
+
+	//!	@brief	深度の形式の候補 (先頭ほど優先します)
+	static VkFormat constexpr DEPTH_FORMATS[] = {
+		VK_FORMAT_D32_SFLOAT,
+		VK_FORMAT_X8_D24_UNORM_PACK32,
+		VK_FORMAT_D16_UNORM,
+	};
+
+	//!	@brief	画像ビュー生成関数
+	VkImageView create_view(VkImage const& image, VkFormat const& format, VkImageAspectFlags const& aspect) noexcept {
+		VkImageViewCreateInfo info = {};
+		info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		info.image = image;
+		info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		info.format = format;
+		info.subresourceRange.aspectMask = aspect;
+		info.subresourceRange.levelCount = 1U;
+		info.subresourceRange.layerCount = 1U;
+
+		VkImageView view = VK_NULL_HANDLE;
+		if (vkCreateImageView(VKDevice::getInstance().get(), &info, nullptr, &view) != VK_SUCCESS) {
+			OutputDebugStringA("ERROR : CREATE FAILED VULKAN IMAGE VIEW.\n");
+			return VK_NULL_HANDLE;
+		}
+		return view;
+	}
+}
+
+namespace dlph {
+	VKRenderer::VKRenderer() noexcept :
+		INoncopyable(),
+		m_width(0U),
+		m_height(0U),
+		m_color(),
+		m_depthFormat(VK_FORMAT_UNDEFINED),
+		m_queue(),
+		m_pacer(),
+		m_lists(),
+		m_list(nullptr),
+		m_fence(),
+		m_colorImage(VK_NULL_HANDLE),
+		m_colorMemory(),
+		m_colorView(VK_NULL_HANDLE),
+		m_depthImage(VK_NULL_HANDLE),
+		m_depthMemory(),
+		m_depthView(VK_NULL_HANDLE),
+		m_clearPass(VK_NULL_HANDLE),
+		m_loadPass(VK_NULL_HANDLE),
+		m_framebuffer(VK_NULL_HANDLE),
+		m_readbacks(),
+		m_readbackMemory(),
+		m_readSlot(0U),
+		m_chain(),
+		m_present(false),
+		m_resources()
+	{}
+
+	VKRenderer::~VKRenderer() noexcept {
+		exit();
+	}
+
+	bool const VKRenderer::init(VKRendererDesc const& desc) noexcept {
+		if (m_width > 0U) {
+			return true;
+		}
+		if (desc.width == 0U || desc.height == 0U) {
+			OutputDebugStringA("ERROR : RENDER TARGET SIZE IS INVALID.\n");
+			return false;
+		}
+
+		if (!VKInstance::getInstance().init(desc.application ? desc.application : "")) {
+			return false;
+		}
+
+		if (!VKDevice::getInstance().init(desc.device)) {
+			return false;
+		}
+
+		if (!VKMemoryAllocator::getInstance().init()) {
+			return false;
+		}
+
+		if (!m_queue.init(VKCommandType::Graphics)) {
+			return false;
+		}
+
+		if (!m_pacer.init(desc.latency > 0U ? desc.latency : FRAME_LATENCY_DEFAULT)) {
+			return false;
+		}
+
+		//	コマンドプールは同時に処理するフレームとリストごとに持つため、記録スレッド間で排他しなくてよい
+		if (!m_lists.init(m_pacer.latency(), VK_CMD_LIST_CNT, VK_CMD_LIST_RESERVED, VKCommandType::Graphics)) {
+			return false;
+		}
+
+		if (!m_fence.init()) {
+			return false;
+		}
+
+		m_width = desc.width;
+		m_height = desc.height;
+		m_color = desc.color;
+
+		if (!createTargets()) {
+			exit();
+			return false;
+		}
+
+		//	獲得を待つ間も前のフレームを処理できるよう、同時に処理するフレーム数より一枚多く持つ
+		m_present = desc.present;
+		if (m_present && !m_chain.init({ desc.window, desc.width, desc.height, m_pacer.latency() + 1U, desc.vsync })) {
+			exit();
+			return false;
+		}
+
+		return true;
+	}
+
+	void VKRenderer::exit() noexcept {
+		if (m_width == 0U && VKDevice::getInstance().get() == VK_NULL_HANDLE) {
+			return;
+		}
+		flush();
+		m_resources.clear();
+		m_chain.exit();
+		m_present = false;
+
+		VkDevice const device = VKDevice::getInstance().get();
+		VKMemoryAllocator& allocator = VKMemoryAllocator::getInstance();
+		if (device != VK_NULL_HANDLE) {
+			for (unsigned int idx = 0U; idx < FRAME_LATENCY_MAX; ++idx) {
+				allocator.destroyBuffer(m_readbackMemory[idx], m_readbacks[idx]);
+			}
+			if (m_framebuffer != VK_NULL_HANDLE) {
+				vkDestroyFramebuffer(device, m_framebuffer, nullptr);
+			}
+			if (m_loadPass != VK_NULL_HANDLE) {
+				vkDestroyRenderPass(device, m_loadPass, nullptr);
+			}
+			if (m_clearPass != VK_NULL_HANDLE) {
+				vkDestroyRenderPass(device, m_clearPass, nullptr);
+			}
+			if (m_depthView != VK_NULL_HANDLE) {
+				vkDestroyImageView(device, m_depthView, nullptr);
+			}
+			if (m_colorView != VK_NULL_HANDLE) {
+				vkDestroyImageView(device, m_colorView, nullptr);
+			}
+			allocator.destroyImage(m_depthMemory, m_depthImage);
+			allocator.destroyImage(m_colorMemory, m_colorImage);
+		}
+		m_framebuffer = VK_NULL_HANDLE;
+		m_loadPass = VK_NULL_HANDLE;
+		m_clearPass = VK_NULL_HANDLE;
+		m_depthView = VK_NULL_HANDLE;
+		m_colorView = VK_NULL_HANDLE;
+
+		m_fence.exit();
+		m_lists.exit();
+		m_list = nullptr;
+		m_queue.exit();
+		m_pacer.exit();
+
+		VKMemoryAllocator::getInstance().exit();
+		VKDevice::getInstance().exit();
+		VKInstance::getInstance().exit();
+
+		m_width = 0U;
+		m_height = 0U;
+		m_depthFormat = VK_FORMAT_UNDEFINED;
+		m_readSlot = 0U;
+
+		return;
+	}
+
+	bool const VKRenderer::before_rendering() noexcept {
+		//	この slot を前回使ったフレームが GPU で終わっていなければ、そこまでだけ待つ
+		if (!m_fence.waitFor(m_pacer.pending())) {
+			return false;
+		}
+
+		if (!m_lists.begin(m_pacer.slot())) {
+			return false;
+		}
+
+		m_list = m_lists.acquire(VK_ORDER_FIRST);
+		if (!m_list) {
+			return false;
+		}
+
+		//	消去はレンダーパスの読み込み操作で行う (タイル型の GPU で読み込みが省ける)
+		beginPass(*m_list, m_clearPass);
+
+		return true;
+	}
+
+	bool const VKRenderer::after_rendering() noexcept {
+		//	記録スレッドが使い切っても末尾のリストは予約分から取れる
+		VKCommandList* const last = m_lists.acquireReserved(VK_ORDER_LAST);
+		if (!last) {
+			//	開いたままのリストを次にこの slot でリセットしないよう、提出せずに閉じておく
+			m_lists.finish([](VKCommandList&) {});
+			m_list = nullptr;
+			return false;
+		}
+
+		unsigned int const slot = m_pacer.slot();
+		VkCommandBuffer const cmd = last->get();
+
+		//	画像を獲得できなければ、記録したリストは提出せずに閉じる
+		if (m_present && !m_chain.acquire(slot)) {
+			m_lists.finish([](VKCommandList&) {});
+			m_list = nullptr;
+			return false;
+		}
+
+		//	色を転送元にし、この slot の読み戻し先へ行を詰めてコピーする
+		VkImageMemoryBarrier image = {};
+		image.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		image.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		image.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+		image.oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+		image.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+		image.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		image.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		image.image = m_colorImage;
+		image.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		image.subresourceRange.levelCount = 1U;
+		image.subresourceRange.layerCount = 1U;
+		vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0U,
+			0U, nullptr, 0U, nullptr, 1U, &image);
+
+		VkBufferImageCopy region = {};
+		region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		region.imageSubresource.layerCount = 1U;
+		region.imageExtent.width = m_width;
+		region.imageExtent.height = m_height;
+		region.imageExtent.depth = 1U;
+		vkCmdCopyImageToBuffer(cmd, m_colorImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, m_readbacks[slot], 1U, &region);
+
+		VkBufferMemoryBarrier buffer = {};
+		buffer.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+		buffer.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		buffer.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+		buffer.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		buffer.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		buffer.buffer = m_readbacks[slot];
+		buffer.size = VK_WHOLE_SIZE;
+		vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0U,
+			0U, nullptr, 1U, &buffer, 0U, nullptr);
+
+		if (m_present) {
+			blitToSwapChain(*last);
+		}
+
+		//	記録したスレッドに関係なく提出順序で並べ、一度の呼び出しで提出する
+		VkCommandBuffer cmds[VK_CMD_LIST_CNT];
+		unsigned int count = 0U;
+		m_lists.finish([&cmds, &count](VKCommandList& list) {
+			cmds[count++] = list.get();
+		});
+		m_list = nullptr;
+
+		//	完了は待たず、次にこの slot を使うときに before_rendering で確かめる
+		m_readSlot = slot;
+		if (m_present) {
+			//	獲得の完了は転送の前で待てばよく、それまでの描画は先に進められる
+			return m_queue.submit(cmds, count, m_fence, m_pacer.submit(),
+				m_chain.acquired(slot), VK_PIPELINE_STAGE_TRANSFER_BIT, m_chain.rendered());
+		}
+		return m_queue.submit(cmds, count, m_fence, m_pacer.submit());
+	}
+
+	bool const VKRenderer::presenting() noexcept {
+		if (!m_present) {
+			return true;
+		}
+		return m_chain.present(m_queue);
+	}
+
+	bool const VKRenderer::readback(void* dst, size_t const& size) noexcept {
+		size_t const bytes = static_cast<size_t>(m_width) * m_height * 4U;
+		if (dst == nullptr || size < bytes) {
+			OutputDebugStringA("ERROR : READBACK DESTINATION IS TOO SMALL.\n");
+			return false;
+		}
+		if (m_pacer.last() == 0U) {
+			OutputDebugStringA("ERROR : NO FRAME HAS BEEN SUBMITTED.\n");
+			return false;
+		}
+		if (!m_fence.waitFor(m_pacer.last())) {
+			return false;
+		}
+
+		//	HOST_COHERENT のメモリなので、完了を待てば無効化せずに読める
+		std::memcpy(dst, m_readbackMemory[m_readSlot].mapped, bytes);
+		return true;
+	}
+
+	VKCommandList& VKRenderer::getCmdList() noexcept {
+		return *m_list;
+	}
+
+	VKCommandList* const VKRenderer::acquireCmdList(unsigned int const& order) noexcept {
+		VKCommandList* const list = m_lists.acquire(order);
+		if (list) {
+			beginPass(*list, m_loadPass);
+		}
+		return list;
+	}
+
+	bool const VKRenderer::execute(RenderCommandStream const& stream, unsigned int const& order) noexcept {
+		VKCommandList* const list = acquireCmdList(order);
+		if (list == nullptr) {
+			OutputDebugStringA("ERROR : COMMAND LIST POOL IS EXHAUSTED.\n");
+			return false;
+		}
+		//	バリアなどで閉じたパスは、次の描画の前に内容を残すパスで開き直す
+		VkRenderPassBeginInfo const pass = getPassInfo(m_loadPass);
+		VKCommandBackend backend(m_resources, *list, &pass);
+		RenderStateFilter filter(backend);
+		stream.submit(filter);
+		backend.flush();
+		return true;
+	}
+
+	VkRenderPass VKRenderer::getRenderPass() const noexcept {
+		return m_loadPass;
+	}
+
+	VkFormat const VKRenderer::getDepthFormat() const noexcept {
+		return m_depthFormat;
+	}
+
+	float const VKRenderer::getWidth() const noexcept {
+		return static_cast<float>(m_width);
+	}
+
+	float const VKRenderer::getHeight() const noexcept {
+		return static_cast<float>(m_height);
+	}
+
+	float const VKRenderer::getAspectRate() const noexcept {
+		return m_height > 0U ? getWidth() / getHeight() : 0.0f;
+	}
+
+	VKResourceTable& VKRenderer::getResourceTable() noexcept {
+		return m_resources;
+	}
+
+	bool const VKRenderer::createTargets() noexcept {
+		VkPhysicalDevice const physical = VKDevice::getInstance().physical();
+		VkDevice const device = VKDevice::getInstance().get();
+		VKMemoryAllocator& allocator = VKMemoryAllocator::getInstance();
+
+		m_depthFormat = VK_FORMAT_UNDEFINED;
+		for (VkFormat const& format : DEPTH_FORMATS) {
+			VkFormatProperties properties = {};
+			vkGetPhysicalDeviceFormatProperties(physical, format, &properties);
+			if ((properties.optimalTilingFeatures & VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT) != 0U) {
+				m_depthFormat = format;
+				break;
+			}
+		}
+		if (m_depthFormat == VK_FORMAT_UNDEFINED) {
+			OutputDebugStringA("ERROR : NOT FOUND SUPPORTED DEPTH FORMAT.\n");
+			return false;
+		}
+
+		VkImageCreateInfo info = {};
+		info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+		info.imageType = VK_IMAGE_TYPE_2D;
+		info.format = VK_COLOR_FORMAT;
+		info.extent.width = m_width;
+		info.extent.height = m_height;
+		info.extent.depth = 1U;
+		info.mipLevels = 1U;
+		info.arrayLayers = 1U;
+		info.samples = VK_SAMPLE_COUNT_1_BIT;
+		info.tiling = VK_IMAGE_TILING_OPTIMAL;
+		info.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+		info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		if (!allocator.createImage(info, m_colorMemory, m_colorImage)) {
+			return false;
+		}
+
+		info.format = m_depthFormat;
+		info.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+		if (!allocator.createImage(info, m_depthMemory, m_depthImage)) {
+			return false;
+		}
+
+		m_colorView = create_view(m_colorImage, VK_COLOR_FORMAT, VK_IMAGE_ASPECT_COLOR_BIT);
+		m_depthView = create_view(m_depthImage, m_depthFormat, VK_IMAGE_ASPECT_DEPTH_BIT);
+		if (m_colorView == VK_NULL_HANDLE || m_depthView == VK_NULL_HANDLE) {
+			return false;
+		}
+
+		if (!createPass(VK_ATTACHMENT_LOAD_OP_CLEAR, m_clearPass) || !createPass(VK_ATTACHMENT_LOAD_OP_LOAD, m_loadPass)) {
+			return false;
+		}
+
+		VkImageView const views[] = { m_colorView, m_depthView };
+		VkFramebufferCreateInfo frame = {};
+		frame.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+		frame.renderPass = m_loadPass;
+		frame.attachmentCount = 2U;
+		frame.pAttachments = views;
+		frame.width = m_width;
+		frame.height = m_height;
+		frame.layers = 1U;
+		if (vkCreateFramebuffer(device, &frame, nullptr, &m_framebuffer) != VK_SUCCESS) {
+			m_framebuffer = VK_NULL_HANDLE;
+			OutputDebugStringA("ERROR : CREATE FAILED VULKAN FRAMEBUFFER.\n");
+			return false;
+		}
+
+		//	GPU が前のフレームのコピーをしている間に上書きしないよう、読み戻し先は slot ごとに持つ
+		uint64_t const bytes = static_cast<uint64_t>(m_width) * m_height * 4U;
+		for (unsigned int idx = 0U; idx < m_pacer.latency(); ++idx) {
+			if (!allocator.createBuffer(bytes, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VKMemoryUsage::Readback, m_readbackMemory[idx], m_readbacks[idx])) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool const VKRenderer::createPass(VkAttachmentLoadOp const& load, VkRenderPass& pass) const noexcept {
+		bool const clear = load == VK_ATTACHMENT_LOAD_OP_CLEAR;
+
+		//	二つのパスは読み込み操作と初期レイアウトだけが違うため互換で、フレームバッファとパイプラインを共用できる
+		VkAttachmentDescription attachments[2] = {};
+		attachments[0].format = VK_COLOR_FORMAT;
+		attachments[0].samples = VK_SAMPLE_COUNT_1_BIT;
+		attachments[0].loadOp = load;
+		attachments[0].storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+		attachments[0].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+		attachments[0].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+		attachments[0].initialLayout = clear ? VK_IMAGE_LAYOUT_UNDEFINED : VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+		attachments[0].finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+		attachments[1] = attachments[0];
+		attachments[1].format = m_depthFormat;
+		attachments[1].initialLayout = clear ? VK_IMAGE_LAYOUT_UNDEFINED : VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+		attachments[1].finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+		VkAttachmentReference color = { 0U, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL };
+		VkAttachmentReference depth = { 1U, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL };
+
+		VkSubpassDescription subpass = {};
+		subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+		subpass.colorAttachmentCount = 1U;
+		subpass.pColorAttachments = &color;
+		subpass.pDepthStencilAttachment = &depth;
+
+		//	前のパス (前のフレームのコピーを含む) の書き込みを待ち、後のパスとコピーへ書き込みを見せる
+		VkPipelineStageFlags const attachment = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+			VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+		VkAccessFlags const writes = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+		VkAccessFlags const access = writes | VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+		VkSubpassDependency dependencies[2] = {};
+		dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+		dependencies[0].dstSubpass = 0U;
+		dependencies[0].srcStageMask = attachment | VK_PIPELINE_STAGE_TRANSFER_BIT;
+		dependencies[0].dstStageMask = attachment;
+		dependencies[0].srcAccessMask = writes;
+		dependencies[0].dstAccessMask = access;
+		dependencies[1].srcSubpass = 0U;
+		dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+		dependencies[1].srcStageMask = attachment;
+		dependencies[1].dstStageMask = attachment | VK_PIPELINE_STAGE_TRANSFER_BIT;
+		dependencies[1].srcAccessMask = writes;
+		dependencies[1].dstAccessMask = access | VK_ACCESS_TRANSFER_READ_BIT;
+
+		VkRenderPassCreateInfo info = {};
+		info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+		info.attachmentCount = 2U;
+		info.pAttachments = attachments;
+		info.subpassCount = 1U;
+		info.pSubpasses = &subpass;
+		info.dependencyCount = 2U;
+		info.pDependencies = dependencies;
+		if (vkCreateRenderPass(VKDevice::getInstance().get(), &info, nullptr, &pass) != VK_SUCCESS) {
+			pass = VK_NULL_HANDLE;
+			OutputDebugStringA("ERROR : CREATE FAILED VULKAN RENDER PASS.\n");
+			return false;
+		}
+
+		return true;
+	}
+
+	void VKRenderer::beginPass(VKCommandList& list, VkRenderPass const& pass) noexcept {
+		VkClearValue clears[2] = {};
+		std::memcpy(clears[0].color.float32, m_color.p, sizeof(clears[0].color.float32));
+		clears[1].depthStencil.depth = 1.0f;
+
+		VkRenderPassBeginInfo info = getPassInfo(pass);
+		info.clearValueCount = pass == m_clearPass ? 2U : 0U;
+		info.pClearValues = clears;
+		list.beginPass(info);
+
+		VkViewport viewport = {};
+		viewport.width = static_cast<float>(m_width);
+		viewport.height = static_cast<float>(m_height);
+		viewport.maxDepth = 1.0f;
+		VkRect2D scissor = {};
+		scissor.extent.width = m_width;
+		scissor.extent.height = m_height;
+		vkCmdSetViewport(list.get(), 0U, 1U, &viewport);
+		vkCmdSetScissor(list.get(), 0U, 1U, &scissor);
+	}
+
+	VkRenderPassBeginInfo const VKRenderer::getPassInfo(VkRenderPass const& pass) const noexcept {
+		VkRenderPassBeginInfo info = {};
+		info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+		info.renderPass = pass;
+		info.framebuffer = m_framebuffer;
+		info.renderArea.extent.width = m_width;
+		info.renderArea.extent.height = m_height;
+		return info;
+	}
+
+	void VKRenderer::blitToSwapChain(VKCommandList& list) noexcept {
+		VkCommandBuffer const cmd = list.get();
+
+		//	前の内容は使わないため未定義から遷移する (獲得の待ちは転送のステージに挟むので、それと繋げる)
+		VkImageMemoryBarrier image = {};
+		image.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		image.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		image.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		image.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		image.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		image.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		image.image = m_chain.current();
+		image.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		image.subresourceRange.levelCount = 1U;
+		image.subresourceRange.layerCount = 1U;
+		vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0U,
+			0U, nullptr, 0U, nullptr, 1U, &image);
+
+		//	形式と大きさが違ってもよいよう、コピーではなく拡縮付きの転送にする
+		VkExtent2D const extent = m_chain.extent();
+		VkImageBlit region = {};
+		region.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		region.srcSubresource.layerCount = 1U;
+		region.srcOffsets[1] = { static_cast<int>(m_width), static_cast<int>(m_height), 1 };
+		region.dstSubresource = region.srcSubresource;
+		region.dstOffsets[1] = { static_cast<int>(extent.width), static_cast<int>(extent.height), 1 };
+		vkCmdBlitImage(cmd, m_colorImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+			image.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1U, &region, VK_FILTER_LINEAR);
+
+		//	表示の待ちはセマフォで行うため、後のアクセスは無い
+		image.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		image.dstAccessMask = 0U;
+		image.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		image.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+		vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0U,
+			0U, nullptr, 0U, nullptr, 1U, &image);
+	}
+
+	void VKRenderer::flush() noexcept {
+		if (m_fence.get() != VK_NULL_HANDLE && m_pacer.last() > 0U) {
+			m_fence.waitFor(m_pacer.last());
+		}
+	}
+}
@@ -0,0 +1,419 @@
+﻿/**	@file	vk_swapchain.cpp
+ *	@brief	Vulkan 用のスワップチェイン
+ */
+#include "vk/vk_swapchain.hpp"
+#include "vk/vk_instance.hpp"
+#include "vk/vk_device.hpp"
+#include <algorithm>
+#if	defined(_WIN32)
+#	include <vulkan/vulkan_win32.h>
+#endif
+
+namespace {
+	using namespace dlph;
+
+	//!	@brief	優先する画像の形式 (先頭ほど優先します)
+	static VkFormat constexpr SURFACE_FORMATS[] = {
+		VK_FORMAT_B8G8R8A8_UNORM,
+		VK_FORMAT_R8G8B8A8_UNORM,
+	};
+
+	//!	@brief	バイナリセマフォ生成関数
+	VkSemaphore create_semaphore() noexcept {
+		VkSemaphoreCreateInfo info = {};
+		info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+		VkSemaphore semaphore = VK_NULL_HANDLE;
+		if (vkCreateSemaphore(VKDevice::getInstance().get(), &info, nullptr, &semaphore) != VK_SUCCESS) {
+			OutputDebugStringA("ERROR : CREATE FAILED VULKAN SEMAPHORE.\n");
+			return VK_NULL_HANDLE;
+		}
+		return semaphore;
+	}
+
+	//!	@brief	サーフェスの形式の選択関数
+	VkSurfaceFormatKHR const select_format(VkPhysicalDevice const& physical, VkSurfaceKHR const& surface) noexcept {
+		unsigned int count = 0U;
+		vkGetPhysicalDeviceSurfaceFormatsKHR(physical, surface, &count, nullptr);
+		std::vector<VkSurfaceFormatKHR> formats(count);
+		if (count == 0U || vkGetPhysicalDeviceSurfaceFormatsKHR(physical, surface, &count, formats.data()) != VK_SUCCESS) {
+			return { VK_FORMAT_UNDEFINED, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR };
+		}
+		for (VkFormat const& format : SURFACE_FORMATS) {
+			for (VkSurfaceFormatKHR const& candidate : formats) {
+				if (candidate.format == format && candidate.colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR) {
+					return candidate;
+				}
+			}
+		}
+		return formats[0];
+	}
+
+	//!	@brief	表示方法の選択関数 (垂直同期を待たないなら MAILBOX、IMMEDIATE の順に探します)
+	VkPresentModeKHR const select_mode(VkPhysicalDevice const& physical, VkSurfaceKHR const& surface, bool const& vsync) noexcept {
+		if (vsync) {
+			return VK_PRESENT_MODE_FIFO_KHR;
+		}
+		unsigned int count = 0U;
+		vkGetPhysicalDeviceSurfacePresentModesKHR(physical, surface, &count, nullptr);
+		std::vector<VkPresentModeKHR> modes(count);
+		if (count == 0U || vkGetPhysicalDeviceSurfacePresentModesKHR(physical, surface, &count, modes.data()) != VK_SUCCESS) {
+			return VK_PRESENT_MODE_FIFO_KHR;
+		}
+		for (VkPresentModeKHR const& mode : { VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_IMMEDIATE_KHR }) {
+			if (std::find(modes.begin(), modes.end(), mode) != modes.end()) {
+				return mode;
+			}
+		}
+		//	FIFO は全ての実装で使える
+		return VK_PRESENT_MODE_FIFO_KHR;
+	}
+
+	//!	@brief	合成時のアルファの扱いの選択関数
+	VkCompositeAlphaFlagBitsKHR const select_alpha(VkCompositeAlphaFlagsKHR const& supported) noexcept {
+		for (VkCompositeAlphaFlagBitsKHR const& alpha : { VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR, VK_COMPOSITE_ALPHA_INHERIT_BIT_KHR,
+			VK_COMPOSITE_ALPHA_PRE_MULTIPLIED_BIT_KHR, VK_COMPOSITE_ALPHA_POST_MULTIPLIED_BIT_KHR })
+		{
+			if ((supported & alpha) != 0U) {
+				return alpha;
+			}
+		}
+		return VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
+	}
+}
+
+namespace dlph {
+	VKSwapChain::VKSwapChain() noexcept :
+		INoncopyable(),
+		m_surface(VK_NULL_HANDLE),
+		m_chain(VK_NULL_HANDLE),
+		m_images(),
+		m_rendered(),
+		m_acquired(),
+		m_format(VK_FORMAT_UNDEFINED),
+		m_extent(),
+		m_bufferCount(0U),
+		m_index(0U),
+		m_vsync(true),
+		m_stale(false)
+	{}
+
+	VKSwapChain::~VKSwapChain() noexcept {
+		exit();
+	}
+
+	bool const VKSwapChain::init(VKSwapChainDesc const& desc) noexcept {
+		if (m_chain != VK_NULL_HANDLE) {
+			return true;
+		}
+		if (!VKDevice::getInstance().presentable()) {
+			OutputDebugStringA("ERROR : VULKAN DEVICE DOES NOT SUPPORT SWAPCHAIN.\n");
+			return false;
+		}
+
+		if (!createSurface(desc.window)) {
+			return false;
+		}
+
+		//	描画と同じキューから表示するため、グラフィックスのファミリーが表示できること
+		VkBool32 supported = VK_FALSE;
+		vkGetPhysicalDeviceSurfaceSupportKHR(VKDevice::getInstance().physical(), VKDevice::getInstance().family(VKCommandType::Graphics), m_surface, &supported);
+		if (supported != VK_TRUE) {
+			OutputDebugStringA("ERROR : GRAPHICS QUEUE CANNOT PRESENT TO THE SURFACE.\n");
+			exit();
+			return false;
+		}
+
+		for (VkSemaphore& semaphore : m_acquired) {
+			semaphore = create_semaphore();
+			if (semaphore == VK_NULL_HANDLE) {
+				exit();
+				return false;
+			}
+		}
+
+		m_bufferCount = desc.bSize;
+		m_vsync = desc.vsync;
+		if (!create(desc.width, desc.height)) {
+			exit();
+			return false;
+		}
+
+		return true;
+	}
+
+	void VKSwapChain::exit() noexcept {
+		VkDevice const device = VKDevice::getInstance().get();
+		if (device != VK_NULL_HANDLE) {
+			VKDevice::getInstance().waitIdle();
+			destroySemaphores();
+			for (VkSemaphore& semaphore : m_acquired) {
+				if (semaphore != VK_NULL_HANDLE) {
+					vkDestroySemaphore(device, semaphore, nullptr);
+				}
+			}
+			if (m_chain != VK_NULL_HANDLE) {
+				vkDestroySwapchainKHR(device, m_chain, nullptr);
+			}
+		}
+		for (VkSemaphore& semaphore : m_acquired) {
+			semaphore = VK_NULL_HANDLE;
+		}
+		m_rendered.clear();
+		m_chain = VK_NULL_HANDLE;
+
+		//	サーフェスはスワップチェインより後に破棄する
+		VkInstance const instance = VKInstance::getInstance().get();
+		if (m_surface != VK_NULL_HANDLE && instance != VK_NULL_HANDLE) {
+			vkDestroySurfaceKHR(instance, m_surface, nullptr);
+		}
+		m_surface = VK_NULL_HANDLE;
+
+		m_images.clear();
+		m_format = VK_FORMAT_UNDEFINED;
+		m_extent = {};
+		m_index = 0U;
+		m_stale = false;
+	}
+
+	bool const VKSwapChain::resize(unsigned int const& width, unsigned int const& height) noexcept {
+		if (m_surface == VK_NULL_HANDLE) {
+			OutputDebugStringA("ERROR : VULKAN SWAPCHAIN IS NOT INITIALIZED.\n");
+			return false;
+		}
+		//	古い画像を使うコマンドと表示が全て終わってから作り直す
+		VKDevice::getInstance().waitIdle();
+		return create(width, height);
+	}
+
+	bool const VKSwapChain::acquire(unsigned int const& slot) noexcept {
+		if (slot >= FRAME_LATENCY_MAX || m_chain == VK_NULL_HANDLE) {
+			OutputDebugStringA("ERROR : VULKAN SWAPCHAIN IS NOT INITIALIZED.\n");
+			return false;
+		}
+		if (m_stale && !resize(m_extent.width, m_extent.height)) {
+			return false;
+		}
+
+		VkDevice const device = VKDevice::getInstance().get();
+		VkResult result = vkAcquireNextImageKHR(device, m_chain, ~0ULL, m_acquired[slot], VK_NULL_HANDLE, &m_index);
+		if (result == VK_ERROR_OUT_OF_DATE_KHR) {
+			//	失敗した獲得はセマフォをシグナルしないため、作り直して同じセマフォで獲得し直せる
+			if (!resize(m_extent.width, m_extent.height)) {
+				return false;
+			}
+			result = vkAcquireNextImageKHR(device, m_chain, ~0ULL, m_acquired[slot], VK_NULL_HANDLE, &m_index);
+		}
+		if (result == VK_SUBOPTIMAL_KHR) {
+			//	獲得した画像は使えるため、このフレームは表示して次の獲得の前に作り直す
+			m_stale = true;
+		}
+		else if (result != VK_SUCCESS) {
+			OutputDebugStringA("ERROR : ACQUIRE FAILED VULKAN SWAPCHAIN IMAGE.\n");
+			return false;
+		}
+
+		return true;
+	}
+
+	bool const VKSwapChain::present(VKCommandQueue const& queue) noexcept {
+		VkSemaphore const wait = rendered();
+
+		VkPresentInfoKHR info = {};
+		info.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+		info.waitSemaphoreCount = 1U;
+		info.pWaitSemaphores = &wait;
+		info.swapchainCount = 1U;
+		info.pSwapchains = &m_chain;
+		info.pImageIndices = &m_index;
+
+		VkResult result = VK_SUCCESS;
+		{
+			std::lock_guard<std::mutex> const lock(VKDevice::getInstance().queueMutex(queue.type()));
+			result = vkQueuePresentKHR(queue.get(), &info);
+		}
+		//	古くなっていても待ちは行われるため、作り直しは次の獲得に任せる
+		if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) {
+			m_stale = true;
+			return true;
+		}
+		if (result != VK_SUCCESS) {
+			OutputDebugStringA("ERROR : PRESENT FAILED VULKAN SWAPCHAIN.\n");
+			return false;
+		}
+
+		return true;
+	}
+
+	VkSemaphore VKSwapChain::acquired(unsigned int const& slot) const noexcept {
+		return slot < FRAME_LATENCY_MAX ? m_acquired[slot] : VK_NULL_HANDLE;
+	}
+
+	VkSemaphore VKSwapChain::rendered() const noexcept {
+		return m_index < m_rendered.size() ? m_rendered[m_index] : VK_NULL_HANDLE;
+	}
+
+	VkImage VKSwapChain::current() const noexcept {
+		return m_index < m_images.size() ? m_images[m_index] : VK_NULL_HANDLE;
+	}
+
+	unsigned int const VKSwapChain::index() const noexcept {
+		return m_index;
+	}
+
+	unsigned int const VKSwapChain::count() const noexcept {
+		return static_cast<unsigned int>(m_images.size());
+	}
+
+	VkFormat const VKSwapChain::format() const noexcept {
+		return m_format;
+	}
+
+	VkExtent2D const VKSwapChain::extent() const noexcept {
+		return m_extent;
+	}
+
+	bool const VKSwapChain::createSurface(void* window) noexcept {
+		VKInstance const& instance = VKInstance::getInstance();
+#if	defined(_WIN32)
+		if (window != nullptr) {
+			if (!instance.enabled("VK_KHR_win32_surface")) {
+				OutputDebugStringA("ERROR : VULKAN WIN32 SURFACE IS NOT SUPPORTED.\n");
+				return false;
+			}
+			VkWin32SurfaceCreateInfoKHR info = {};
+			info.sType = VK_STRUCTURE_TYPE_WIN32_SURFACE_CREATE_INFO_KHR;
+			info.hinstance = GetModuleHandleA(nullptr);
+			info.hwnd = static_cast<HWND>(window);
+			if (vkCreateWin32SurfaceKHR(instance.get(), &info, nullptr, &m_surface) != VK_SUCCESS) {
+				m_surface = VK_NULL_HANDLE;
+				OutputDebugStringA("ERROR : CREATE FAILED VULKAN WIN32 SURFACE.\n");
+				return false;
+			}
+			return true;
+		}
+#else
+		if (window != nullptr) {
+			OutputDebugStringA("ERROR : VULKAN WINDOW SURFACE IS NOT SUPPORTED ON THIS PLATFORM.\n");
+			return false;
+		}
+#endif
+
+		//	ウィンドウが無ければヘッドレスのサーフェスに表示する (ローダーによっては関数を公開しないため取得して呼ぶ)
+		if (!instance.enabled(VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME)) {
+			OutputDebugStringA("ERROR : VULKAN HEADLESS SURFACE IS NOT SUPPORTED.\n");
+			return false;
+		}
+		PFN_vkCreateHeadlessSurfaceEXT const create = reinterpret_cast<PFN_vkCreateHeadlessSurfaceEXT>(
+			vkGetInstanceProcAddr(instance.get(), "vkCreateHeadlessSurfaceEXT"));
+		VkHeadlessSurfaceCreateInfoEXT info = {};
+		info.sType = VK_STRUCTURE_TYPE_HEADLESS_SURFACE_CREATE_INFO_EXT;
+		if (create == nullptr || create(instance.get(), &info, nullptr, &m_surface) != VK_SUCCESS) {
+			m_surface = VK_NULL_HANDLE;
+			OutputDebugStringA("ERROR : CREATE FAILED VULKAN HEADLESS SURFACE.\n");
+			return false;
+		}
+
+		return true;
+	}
+
+	bool const VKSwapChain::create(unsigned int const& width, unsigned int const& height) noexcept {
+		VkPhysicalDevice const physical = VKDevice::getInstance().physical();
+		VkDevice const device = VKDevice::getInstance().get();
+
+		VkSurfaceCapabilitiesKHR capabilities = {};
+		if (vkGetPhysicalDeviceSurfaceCapabilitiesKHR(physical, m_surface, &capabilities) != VK_SUCCESS) {
+			OutputDebugStringA("ERROR : GET FAILED VULKAN SURFACE CAPABILITIES.\n");
+			return false;
+		}
+		if ((capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_DST_BIT) == 0U) {
+			OutputDebugStringA("ERROR : VULKAN SURFACE CANNOT BE A TRANSFER DESTINATION.\n");
+			return false;
+		}
+
+		VkSurfaceFormatKHR const format = select_format(physical, m_surface);
+		if (format.format == VK_FORMAT_UNDEFINED) {
+			OutputDebugStringA("ERROR : NOT FOUND SUPPORTED SURFACE FORMAT.\n");
+			return false;
+		}
+
+		//	大きさを決めないサーフェス (ヘッドレスなど) は要求した大きさを範囲に収めて使う
+		VkExtent2D extent = capabilities.currentExtent;
+		if (extent.width == ~0U) {
+			extent.width = std::min(std::max(width, capabilities.minImageExtent.width), capabilities.maxImageExtent.width);
+			extent.height = std::min(std::max(height, capabilities.minImageExtent.height), capabilities.maxImageExtent.height);
+		}
+		if (extent.width == 0U || extent.height == 0U) {
+			OutputDebugStringA("ERROR : VULKAN SURFACE SIZE IS ZERO.\n");
+			return false;
+		}
+
+		unsigned int images = std::max(m_bufferCount, capabilities.minImageCount);
+		if (capabilities.maxImageCount > 0U) {
+			images = std::min(images, capabilities.maxImageCount);
+		}
+
+		VkSwapchainCreateInfoKHR info = {};
+		info.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
+		info.surface = m_surface;
+		info.minImageCount = images;
+		info.imageFormat = format.format;
+		info.imageColorSpace = format.colorSpace;
+		info.imageExtent = extent;
+		info.imageArrayLayers = 1U;
+		info.imageUsage = VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+		info.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		info.preTransform = capabilities.currentTransform;
+		info.compositeAlpha = select_alpha(capabilities.supportedCompositeAlpha);
+		info.presentMode = select_mode(physical, m_surface, m_vsync);
+		info.clipped = VK_TRUE;
+		info.oldSwapchain = m_chain;
+
+		VkSwapchainKHR chain = VK_NULL_HANDLE;
+		VkResult const result = vkCreateSwapchainKHR(device, &info, nullptr, &chain);
+		//	前のスワップチェインは作り直しの成否に関係なく使えなくなる
+		if (m_chain != VK_NULL_HANDLE) {
+			vkDestroySwapchainKHR(device, m_chain, nullptr);
+			m_chain = VK_NULL_HANDLE;
+		}
+		m_images.clear();
+		destroySemaphores();
+		if (result != VK_SUCCESS) {
+			OutputDebugStringA("ERROR : CREATE FAILED VULKAN SWAPCHAIN.\n");
+			return false;
+		}
+		m_chain = chain;
+
+		unsigned int count = 0U;
+		vkGetSwapchainImagesKHR(device, m_chain, &count, nullptr);
+		m_images.resize(count);
+		if (count == 0U || vkGetSwapchainImagesKHR(device, m_chain, &count, m_images.data()) != VK_SUCCESS) {
+			m_images.clear();
+			OutputDebugStringA("ERROR : GET FAILED VULKAN SWAPCHAIN IMAGES.\n");
+			return false;
+		}
+
+		m_rendered.resize(count, VK_NULL_HANDLE);
+		for (VkSemaphore& semaphore : m_rendered) {
+			semaphore = create_semaphore();
+			if (semaphore == VK_NULL_HANDLE) {
+				return false;
+			}
+		}
+
+		m_format = format.format;
+		m_extent = extent;
+		m_index = 0U;
+		m_stale = false;
+		return true;
+	}
+
+	void VKSwapChain::destroySemaphores() noexcept {
+		VkDevice const device = VKDevice::getInstance().get();
+		for (VkSemaphore& semaphore : m_rendered) {
+			if (semaphore != VK_NULL_HANDLE) {
+				vkDestroySemaphore(device, semaphore, nullptr);
+			}
+		}
+		m_rendered.clear();
+	}
+}
@@ -0,0 +1,107 @@
+﻿/**	@file	batch_test.cpp
+ *	@brief	インスタンス描画器のテストとベンチマーク
+ */
+#include "test.hpp"
+#include "dlph/dlph_batcher.hpp"
+#include "dlph/dlph_headless.hpp"
+#include "dlph/dlph_state_filter.hpp"
+#include <random>
+#include <vector>
+
+namespace {
+	using namespace dlph;
+
+	//!	@brief	登録するメッシュの数
+	static unsigned int constexpr MESH_CNT = 300U;
+	//!	@brief	マテリアルの数
+	static unsigned int constexpr MATERIAL_CNT = 4U;
+	//!	@brief	一フレームのオブジェクト数
+	static unsigned int constexpr OBJECT_CNT = 50000U;
+
+	//!	@brief	平行移動だけの変換行列
+	Float4x4 const translation(float const& x) noexcept {
+		Float4x4 world = {};
+		for (unsigned int idx = 0U; idx < 4U; ++idx) {
+			world.m[idx][idx] = 1.0f;
+		}
+		world.m[3][0] = x;
+		return world;
+	}
+
+	//!	@brief	同じ組がまとまり、インスタンスデータが組ごとに連続して並ぶかどうか
+	void correctness(DrawBatcher& batcher, std::vector<unsigned char>& instances) noexcept {
+		RenderCommandStream stream;
+		DLPH_CHECK(stream.init(1U << 16U, 1U << 10U));
+		HeadlessBackend backend;
+		RenderStateFilter filter(backend);
+
+		batcher.submit(2U, 7U, translation(5.0f));
+		batcher.submit(1U, 3U, translation(6.0f));
+		batcher.submit(2U, 7U, translation(7.0f));
+		DLPH_CHECK(batcher.build(instances.data(), instances.size()));
+		DLPH_CHECK(batcher.batchCount() == 2U);
+
+		DrawBatch const* const batches = batcher.batches();
+		BatchInstance const* const data = reinterpret_cast<BatchInstance const*>(instances.data());
+		DLPH_CHECK(batches[0].mesh == 1U && batches[0].instanceCount == 1U);
+		DLPH_CHECK(batches[1].mesh == 2U && batches[1].instanceCount == 2U && batches[1].firstInstance == 1U);
+		DLPH_CHECK(data[0].rows[0][3] == 6.0f && data[0].material == 3U);
+		DLPH_CHECK(data[1].rows[0][3] == 5.0f && data[2].rows[0][3] == 7.0f && data[1].material == 7U);
+
+		batcher.record(stream, RenderPipeline::make(1U, 1U), RenderResource::make(9999U, 1U), 256U);
+		stream.sort();
+		stream.submit(filter);
+		DLPH_CHECK(backend.valid());
+		DLPH_CHECK(backend.stats().draws == 2U);
+		DLPH_CHECK(backend.stats().indices == 36U * 2U + 36U * 3U * 2U);
+	}
+
+	//!	@brief	ばらばらに追加した大量のオブジェクトを一フレーム分まとめて再生する時間の計測
+	void bench(DrawBatcher& batcher, std::vector<unsigned char>& instances) noexcept {
+		RenderCommandStream stream;
+		DLPH_CHECK(stream.init(1U << 20U, 1U << 16U));
+		HeadlessBackend backend;
+		RenderStateFilter filter(backend);
+		std::mt19937 rng(3U);
+
+		size_t batches = 0U;
+		double const frame = test::measure(50U, [&]() noexcept {
+			batcher.reset();
+			stream.reset();
+			filter.reset();
+			backend.reset();
+			for (unsigned int idx = 0U; idx < OBJECT_CNT; ++idx) {
+				batcher.submit(rng() % MESH_CNT, rng() % MATERIAL_CNT, translation(static_cast<float>(idx)));
+			}
+			batcher.build(instances.data(), instances.size());
+			batcher.record(stream, RenderPipeline::make(1U, 1U), RenderResource::make(9999U, 1U), 0U);
+			stream.sort();
+			stream.submit(filter);
+			batches = batcher.batchCount();
+		});
+		DLPH_CHECK(backend.valid());
+		DLPH_CHECK(backend.stats().draws == batches);
+		std::printf("batch : %u objects -> %zu draws, %llu commands eliminated, %.2f ms/frame\n",
+			OBJECT_CNT, batches, filter.eliminated(), frame);
+	}
+}
+
+int main() {
+	using namespace dlph;
+	DrawBatcher batcher;
+	DLPH_CHECK(batcher.init(OBJECT_CNT));
+	for (unsigned int idx = 0U; idx < MESH_CNT; ++idx) {
+		BatchMesh mesh = {};
+		mesh.vertices = RenderResource::make(idx + 1U, 1U);
+		mesh.indices = RenderResource::make(idx + 1000U, 1U);
+		mesh.stride = 32U;
+		mesh.indexCount = 36U * (idx % 5U + 1U);
+		mesh.indexFormat = idx % 2U == 0U ? IndexFormat::UInt32 : IndexFormat::UInt16;
+		DLPH_CHECK(batcher.addMesh(mesh) == idx);
+	}
+	std::vector<unsigned char> instances(sizeof(BatchInstance) * OBJECT_CNT);
+
+	correctness(batcher, instances);
+	bench(batcher, instances);
+	return test::finish("batch_test");
+}
@@ -0,0 +1,154 @@
+﻿/**	@file	clsn_test.cpp
+ *	@brief	衝突判定のテストとベンチマーク
+ */
+#include "test.hpp"
+#include "clsn/clsn_shape.hpp"
+#include "clsn/clsn_hull.hpp"
+#include "clsn/clsn_gjk.hpp"
+#include "clsn/clsn_manifold.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <vector>
+
+namespace {
+	//!	@brief	ヒープの確保回数
+	std::atomic<unsigned long long> g_allocations(0ULL);
+}
+
+void* operator new(size_t size) {
+	++g_allocations;
+	if (void* const memory = std::malloc(size > 0U ? size : 1U)) {
+		return memory;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+	std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+	std::free(memory);
+}
+
+namespace {
+	using namespace dlph;
+
+	//!	@brief	箱の八隅と各面の中心 (同一平面上の点を含む点群)
+	std::vector<Float3> const boxPoints(float const& half) noexcept {
+		std::vector<Float3> points;
+		for (unsigned int idx = 0U; idx < 8U; ++idx) {
+			points.push_back(Float3((idx & 1U) ? half : -half, (idx & 2U) ? half : -half, (idx & 4U) ? half : -half));
+		}
+		for (unsigned int axis = 0U; axis < T3_CNT; ++axis) {
+			for (float const& sign : { -1.0f, 1.0f }) {
+				Float3 center(0.0f, 0.0f, 0.0f);
+				center.p[axis] = sign * half;
+				points.push_back(center);
+			}
+		}
+		return points;
+	}
+
+	//!	@brief	箱の凸包は六つの四角形の面になる
+	void hullFaces() noexcept {
+		std::vector<Float3> const points = boxPoints(1.0f);
+		ConvexHull3 hull;
+		DLPH_CHECK(hull.init(points.data(), points.size()));
+		DLPH_CHECK(hull.faces().size() == 6U);
+		for (HullFace const& face : hull.faces()) {
+			DLPH_CHECK(face.count == 4U);
+			DLPH_CHECK(fabsf(face.distance - 1.0f) < 1.0e-5f);
+			for (unsigned int idx = 0U; idx < face.count; ++idx) {
+				Float3 const& v = hull.vertices()[hull.indices()[face.first + idx]];
+				DLPH_CHECK(fabsf(face.normal.x * v.x + face.normal.y * v.y + face.normal.z * v.z - face.distance) < 1.0e-5f);
+			}
+		}
+
+		//	球面上の点群は面がまとまらず、全点が内側に入る
+		std::mt19937 rng(1U);
+		std::normal_distribution<float> normal;
+		std::vector<Float3> sphere;
+		for (unsigned int idx = 0U; idx < 500U; ++idx) {
+			FVector3 const p(normal(rng), normal(rng), normal(rng));
+			sphere.push_back(normalize(p));
+		}
+		DLPH_CHECK(hull.init(sphere.data(), sphere.size()));
+		unsigned int outside = 0U;
+		for (Float3 const& p : sphere) {
+			for (HullFace const& face : hull.faces()) {
+				if (face.normal.x * p.x + face.normal.y * p.y + face.normal.z * p.z - face.distance > 1.0e-4f) {
+					++outside;
+					break;
+				}
+			}
+		}
+		DLPH_CHECK(outside == 0U);
+	}
+
+	//!	@brief	凸包で作った箱を箱に載せると四隅で接する
+	void hullManifold() noexcept {
+		std::vector<Float3> const points = boxPoints(0.5f);
+		ConvexHull3 hull;
+		DLPH_CHECK(hull.init(points.data(), points.size()));
+
+		CollisionShape ground, box;
+		ground.initBox(FVector3(4.0f, 0.5f, 4.0f)).id(1U).position(FVector3(0.0f, -0.5f, 0.0f));
+		box.initHull(&hull).id(2U).position(FVector3(0.1f, 0.49f, -0.2f));
+		GjkCache cache;
+		ContactManifold manifold = {};
+		DLPH_CHECK(createManifold(ground, box, &cache, manifold));
+		DLPH_CHECK(manifold.count == 4U);
+
+		ContactManifold flipped = {};
+		DLPH_CHECK(createManifold(box, ground, &cache, flipped));
+		DLPH_CHECK(flipped.count == 4U);
+	}
+
+	//!	@brief	多数の組の判定の計測
+	void bench() noexcept {
+		std::vector<Float3> const points = boxPoints(0.5f);
+		ConvexHull3 hull;
+		hull.init(points.data(), points.size());
+
+		std::vector<CollisionShape> shapes(2000U);
+		for (unsigned int idx = 0U; idx < shapes.size(); ++idx) {
+			switch (idx % 3U) {
+			case 0U: shapes[idx].initSphere(0.5f); break;
+			case 1U: shapes[idx].initBox(FVector3(0.5f, 0.5f, 0.5f)); break;
+			default: shapes[idx].initHull(&hull); break;
+			}
+			shapes[idx].id(idx).position(FVector3((idx % 50U) * 0.9f, (idx / 50U) * 0.9f, 0.0f));
+		}
+
+		GjkCache cache;
+		unsigned int pairs = 0U, hits = 0U;
+		auto const frame = [&]() noexcept {
+			pairs = 0U;
+			hits = 0U;
+			for (unsigned int i = 0U; i + 1U < shapes.size(); ++i) {
+				for (unsigned int j = i + 1U; j < i + 20U && j < shapes.size(); ++j) {
+					ContactManifold manifold;
+					hits += createManifold(shapes[i], shapes[j], &cache, manifold) ? 1U : 0U;
+					++pairs;
+				}
+			}
+		};
+		double const ms = test::measure(5U, frame);
+
+		//	キャッシュと作業領域が温まった後のフレームはヒープを確保しない
+		unsigned long long const allocations = g_allocations;
+		frame();
+		DLPH_CHECK(g_allocations == allocations);
+		std::printf("clsn : %u pairs (%u touching) %.2f ms/frame, %.1f ns/pair\n", pairs, hits, ms, ms * 1.0e6 / pairs);
+	}
+}
+
+int main() {
+	hullFaces();
+	hullManifold();
+	bench();
+	return dlph::test::finish("clsn_test");
+}
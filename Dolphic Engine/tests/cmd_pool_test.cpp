@@ -0,0 +1,139 @@
+﻿/**	@file	cmd_pool_test.cpp
+ *	@brief	コマンドリストプールのテスト
+ */
+#include "test.hpp"
+#include "dlph/dlph_cmd_pool.hpp"
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+	using namespace dlph;
+
+	/**	@struct	StubList
+	 *	@brief	デバイスを使わないコマンドリスト
+	 */
+	struct StubList final {
+		//!	@brief	記録中かどうか
+		bool open;
+		//!	@brief	記録の開始に失敗させるかどうか
+		bool broken;
+		//!	@brief	記録した提出順序
+		unsigned int order;
+
+		bool const init(int const&) noexcept {
+			open = false;
+			broken = false;
+			order = 0U;
+			return true;
+		}
+		void exit() noexcept {}
+		bool const recording() noexcept {
+			open = !broken;
+			return open;
+		}
+		bool const closing() noexcept {
+			bool const result = open;
+			open = false;
+			return result;
+		}
+	};
+
+	//!	@brief	閉じたリストを提出順に集める関数
+	std::vector<StubList*> const drain(CommandListPool<StubList>& pool) noexcept {
+		std::vector<StubList*> result;
+		pool.finish([&result](StubList& list) {
+			result.push_back(&list);
+		});
+		return result;
+	}
+
+	//!	@brief	スレッドがばらばらの順でリストを取っても、提出順は順序番号だけで決まるかどうか
+	void ordering() noexcept {
+		unsigned int constexpr THREAD_CNT = 6U;
+		CommandListPool<StubList> pool;
+		DLPH_CHECK(pool.init(3U, THREAD_CNT + 2U, 1U, 0));
+
+		unsigned int mismatch = 0U;
+		for (unsigned int frame = 0U; frame < 300U; ++frame) {
+			DLPH_CHECK(pool.begin(frame % 3U));
+			StubList* const first = pool.acquire(0U);
+			first->order = 0U;
+
+			std::vector<std::thread> threads;
+			for (unsigned int idx = 0U; idx < THREAD_CNT; ++idx) {
+				threads.emplace_back([&pool, idx, frame]() noexcept {
+					std::mt19937 rng(frame * THREAD_CNT + idx);
+					std::this_thread::sleep_for(std::chrono::microseconds(rng() % 200U));
+					unsigned int const order = (idx + 1U) * 10U;
+					if (StubList* const list = pool.acquire(order)) {
+						list->order = order;
+					}
+				});
+			}
+			for (std::thread& thread : threads) {
+				thread.join();
+			}
+			StubList* const last = pool.acquireReserved(~0U);
+			last->order = ~0U;
+
+			std::vector<StubList*> const lists = drain(pool);
+			mismatch += lists.size() != THREAD_CNT + 2U ? 1U : 0U;
+			for (size_t idx = 0U; idx < lists.size(); ++idx) {
+				unsigned int const expected = idx == 0U ? 0U : idx == THREAD_CNT + 1U ? ~0U : static_cast<unsigned int>(idx) * 10U;
+				mismatch += lists[idx]->order != expected || lists[idx]->open ? 1U : 0U;
+			}
+		}
+		DLPH_CHECK(mismatch == 0U);
+	}
+
+	//!	@brief	予約分以外を使い切っても、末尾のリストは取れて全てのリストが閉じるかどうか
+	void reserved() noexcept {
+		CommandListPool<StubList> pool;
+		DLPH_CHECK(!pool.init(1U, 2U, 2U, 0));
+		DLPH_CHECK(pool.init(1U, 4U, 1U, 0));
+		DLPH_CHECK(pool.begin(0U));
+
+		StubList* lists[3] = {};
+		for (unsigned int idx = 0U; idx < 3U; ++idx) {
+			lists[idx] = pool.acquire(3U - idx);
+			DLPH_CHECK(lists[idx] != nullptr);
+		}
+		DLPH_CHECK(pool.acquire(7U) == nullptr);
+		StubList* const last = pool.acquireReserved(~0U);
+		DLPH_CHECK(last != nullptr);
+		DLPH_CHECK(pool.acquireReserved(~0U - 1U) == nullptr);
+		DLPH_CHECK(pool.used() == 4U);
+
+		std::vector<StubList*> const order = drain(pool);
+		DLPH_CHECK(order.size() == 4U);
+		DLPH_CHECK(order[0] == lists[2] && order[1] == lists[1] && order[2] == lists[0] && order[3] == last);
+		for (StubList* const& list : order) {
+			DLPH_CHECK(!list->open);
+		}
+		DLPH_CHECK(pool.used() == 0U);
+	}
+
+	//!	@brief	記録を開始できなかったリストは配らず、提出もしないかどうか
+	void broken() noexcept {
+		CommandListPool<StubList> pool;
+		DLPH_CHECK(pool.init(1U, 3U, 1U, 0));
+		DLPH_CHECK(pool.begin(0U));
+		StubList* const good = pool.acquire(1U);
+		DLPH_CHECK(good != nullptr);
+		good->broken = true;
+		DLPH_CHECK(drain(pool).size() == 1U);
+
+		DLPH_CHECK(pool.begin(0U));
+		DLPH_CHECK(pool.acquire(1U) == nullptr);
+		DLPH_CHECK(pool.acquire(2U) != nullptr);
+		DLPH_CHECK(drain(pool).size() == 1U);
+	}
+}
+
+int main() {
+	ordering();
+	reserved();
+	broken();
+	return dlph::test::finish("cmd_pool_test");
+}
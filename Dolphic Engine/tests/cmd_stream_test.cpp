@@ -0,0 +1,208 @@
+﻿/**	@file	cmd_stream_test.cpp
+ *	@brief	描画コマンド列のテストとベンチマーク
+ */
+#include "test.hpp"
+#include "dlph/dlph_cmd_stream.hpp"
+#include "dlph/dlph_headless.hpp"
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+	using namespace dlph;
+
+	//!	@brief	再生されたコマンド (種類と、主な引数をまとめた値)
+	using Replayed = std::pair<RenderCommandType, unsigned long long>;
+
+	/**	@class	RecordingBackend
+	 *	@brief	再生されたコマンドを順に書き留める描画バックエンド
+	 */
+	class RecordingBackend final : public IRenderBackend {
+	public	:
+		//!	@brief	書き留めたコマンド
+		std::vector<Replayed> log;
+
+		void draw(DrawCommand const& cmd) noexcept override {
+			log.emplace_back(cmd.TYPE, pack(cmd.vertexCount, cmd.instanceCount, cmd.firstVertex, cmd.firstInstance));
+		}
+		void drawIndexed(DrawIndexedCommand const& cmd) noexcept override {
+			log.emplace_back(cmd.TYPE, pack(cmd.indexCount, cmd.instanceCount, cmd.firstIndex, static_cast<unsigned int>(cmd.baseVertex) ^ cmd.firstInstance));
+		}
+		void dispatch(DispatchCommand const& cmd) noexcept override {
+			log.emplace_back(cmd.TYPE, pack(cmd.x, cmd.y, cmd.z, 0U));
+		}
+		void setPipeline(SetPipelineCommand const& cmd) noexcept override {
+			log.emplace_back(cmd.TYPE, cmd.pipeline.value);
+		}
+		void bindVertexBuffer(BindVertexBufferCommand const& cmd) noexcept override {
+			log.emplace_back(cmd.TYPE, pack(cmd.buffer.value, cmd.slot, cmd.stride, static_cast<unsigned int>(cmd.offset)));
+		}
+		void bindIndexBuffer(BindIndexBufferCommand const& cmd) noexcept override {
+			log.emplace_back(cmd.TYPE, pack(cmd.buffer.value, static_cast<unsigned int>(cmd.format), static_cast<unsigned int>(cmd.offset), 0U));
+		}
+		void bindConstants(BindConstantsCommand const& cmd) noexcept override {
+			log.emplace_back(cmd.TYPE, cmd.address + cmd.root);
+		}
+		void bindResource(BindResourceCommand const& cmd) noexcept override {
+			log.emplace_back(cmd.TYPE, pack(cmd.root, cmd.resource.value, 0U, 0U));
+		}
+		void barrier(BarrierCommand const& cmd) noexcept override {
+			log.emplace_back(cmd.TYPE, pack(cmd.resource.value, static_cast<unsigned int>(cmd.before) << 8U | static_cast<unsigned int>(cmd.after), static_cast<unsigned int>(cmd.kind), cmd.subresource));
+		}
+		void copy(CopyCommand const& cmd) noexcept override {
+			log.emplace_back(cmd.TYPE, pack(cmd.dst.value, cmd.src.value, static_cast<unsigned int>(cmd.dstOffset), static_cast<unsigned int>(cmd.srcOffset ^ cmd.size)));
+		}
+
+		//!	@brief	四つの値を一つにまとめる関数 (一致を比べるだけなので衝突は気にしません)
+		static unsigned long long const pack(unsigned int const& a, unsigned int const& b, unsigned int const& c, unsigned int const& d) noexcept {
+			return (static_cast<unsigned long long>(a) << 48U) ^ (static_cast<unsigned long long>(b) << 32U) ^ (static_cast<unsigned long long>(c) << 16U) ^ d;
+		}
+	};
+
+	//!	@brief	全ての種類のコマンドが記録したとおりの引数で、記録した順に再生されるかどうか
+	void roundTrip() noexcept {
+		RenderCommandStream stream;
+		DLPH_CHECK(stream.init(256U, 16U));
+		RenderResource const buffer = RenderResource::make(3U, 1U);
+		RenderResource const texture = RenderResource::make(4U, 2U);
+
+		stream.barrier(buffer, ResourceState::Common, ResourceState::CopyDest);
+		stream.copy(buffer, 64U, RenderResource::make(5U, 1U), 128U, 32U);
+		stream.barrier(buffer, ResourceState::CopyDest, ResourceState::VertexAndConstant);
+		stream.setPipeline(RenderPipeline::make(7U, 1U));
+		stream.bindVertexBuffer(1U, buffer, 24U, 48U);
+		stream.bindIndexBuffer(buffer, IndexFormat::UInt16, 512U);
+		stream.bindConstants(2U, 0x10000ULL);
+		stream.bindResource(3U, texture);
+		stream.draw(3U, 2U, 1U, 5U);
+		stream.drawIndexed(36U, 4U, 6U, -2, 1U);
+		stream.barrier(texture, ResourceState::ShaderResource, ResourceState::UnorderedAccess, BarrierKind::Transition, 2U);
+		stream.dispatch(8U, 4U, 2U);
+		DLPH_CHECK(stream.size() == 12U);
+
+		//	容量 256 バイトに収まらない分は上位のメモリに積まれるが、再生には影響しない
+		DLPH_CHECK(stream.bytes() <= 256U);
+
+		using R = RecordingBackend;
+		std::vector<Replayed> const expected = {
+			{ RenderCommandType::Barrier, R::pack(buffer.value, 0x0009U, 0U, SUBRESOURCE_ALL) },
+			{ RenderCommandType::Copy, R::pack(buffer.value, RenderResource::make(5U, 1U).value, 64U, 128U ^ 32U) },
+			{ RenderCommandType::Barrier, R::pack(buffer.value, 0x0901U, 0U, SUBRESOURCE_ALL) },
+			{ RenderCommandType::SetPipeline, RenderPipeline::make(7U, 1U).value },
+			{ RenderCommandType::BindVertexBuffer, R::pack(buffer.value, 1U, 24U, 48U) },
+			{ RenderCommandType::BindIndexBuffer, R::pack(buffer.value, 1U, 512U, 0U) },
+			{ RenderCommandType::BindConstants, 0x10002ULL },
+			{ RenderCommandType::BindResource, R::pack(3U, texture.value, 0U, 0U) },
+			{ RenderCommandType::Draw, R::pack(3U, 2U, 1U, 5U) },
+			{ RenderCommandType::DrawIndexed, R::pack(36U, 4U, 6U, static_cast<unsigned int>(-2) ^ 1U) },
+			{ RenderCommandType::Barrier, R::pack(texture.value, 0x0304U, 0U, 2U) },
+			{ RenderCommandType::Dispatch, R::pack(8U, 4U, 2U, 0U) },
+		};
+		RecordingBackend recorder;
+		stream.submit(recorder);
+		DLPH_CHECK(recorder.log == expected);
+
+		//	同じ列は何度でも再生でき、検証用のバックエンドでも誤りにならない
+		HeadlessBackend backend;
+		stream.submit(backend);
+		DLPH_CHECK(backend.valid());
+		DLPH_CHECK(backend.stats().draws == 2U && backend.stats().vertices == 6U && backend.stats().indices == 144U);
+		DLPH_CHECK(backend.stats().groups == 64U && backend.stats().copied == 32U);
+		DLPH_CHECK(backend.stats().commands[static_cast<unsigned int>(RenderCommandType::Barrier)] == 3U);
+
+		stream.reset();
+		DLPH_CHECK(stream.empty() && stream.bytes() == 0U);
+		recorder.log.clear();
+		stream.submit(recorder);
+		DLPH_CHECK(recorder.log.empty());
+	}
+
+	//!	@brief	並べ替えはキーの順になり、同じキーの中では記録順が保たれるかどうか
+	void sorting() noexcept {
+		RenderCommandStream stream;
+		DLPH_CHECK(stream.init(1U << 16U));
+		unsigned long long const keys[8] = { 5U, 1U, 5U, 0U, 1U, 9U, 0U, 5U };
+		for (unsigned int idx = 0U; idx < 8U; ++idx) {
+			stream.setKey(keys[idx]);
+			stream.draw(idx + 1U);
+		}
+		DLPH_CHECK(stream.getKey() == 5U);
+		stream.sort();
+
+		RecordingBackend recorder;
+		stream.submit(recorder);
+		unsigned int const order[8] = { 4U, 7U, 2U, 5U, 1U, 3U, 8U, 6U };
+		DLPH_CHECK(recorder.log.size() == 8U);
+		for (unsigned int idx = 0U; idx < 8U && idx < recorder.log.size(); ++idx) {
+			DLPH_CHECK(recorder.log[idx].second == RecordingBackend::pack(order[idx], 1U, 0U, 0U));
+		}
+		unsigned long long previous = 0U;
+		for (RenderCommandStream::Entry const* entry = stream.begin(); entry != stream.end(); ++entry) {
+			DLPH_CHECK(entry->key >= previous);
+			previous = entry->key;
+		}
+	}
+
+	//!	@brief	検証用のバックエンドが不正な列を誤りとして数えるかどうか
+	void validation() noexcept {
+		RenderCommandStream stream;
+		DLPH_CHECK(stream.init(1U << 12U));
+		RenderResource const target = RenderResource::make(1U, 1U);
+		stream.draw(3U);
+		stream.barrier(target, ResourceState::RenderTarget, ResourceState::ShaderResource);
+		stream.barrier(target, ResourceState::RenderTarget, ResourceState::Present);
+		stream.bindConstants(0U, 100U);
+
+		HeadlessBackend backend;
+		stream.submit(backend);
+		DLPH_CHECK(!backend.valid());
+		DLPH_CHECK(backend.stats().errors == 3U);
+		backend.reset();
+		DLPH_CHECK(backend.valid() && backend.stats().draws == 0U);
+	}
+
+	//!	@brief	一フレーム分の描画を記録し、並べ替えて再生する速さの計測
+	void bench() noexcept {
+		unsigned int constexpr DRAW_CNT = 100000U;
+		RenderCommandStream stream;
+		DLPH_CHECK(stream.init(DRAW_CNT * 6U * 32U, DRAW_CNT * 6U));
+		HeadlessBackend backend;
+		std::mt19937 rng(5U);
+		std::vector<unsigned long long> keys(DRAW_CNT);
+		for (unsigned long long& key : keys) {
+			key = SortKey::make(0U, 0U, rng() % 16U, rng() % 256U, rng() % 4096U).value;
+		}
+
+		double const record = test::measure(20U, [&]() noexcept {
+			stream.reset();
+			for (unsigned int idx = 0U; idx < DRAW_CNT; ++idx) {
+				SortKey const key = { keys[idx] };
+				stream.setKey(key);
+				stream.setPipeline(RenderPipeline::make(key.pipeline() + 1U, 1U));
+				stream.bindVertexBuffer(0U, RenderResource::make(key.material() + 1U, 1U), 32U);
+				stream.bindIndexBuffer(RenderResource::make(key.material() + 1U, 1U));
+				stream.bindConstants(0U, (idx + 1ULL) * 256ULL);
+				stream.bindResource(1U, RenderResource::make(key.material() + 1000U, 1U));
+				stream.drawIndexed(36U);
+			}
+		});
+		double const sort = test::measure(1U, [&]() noexcept {
+			stream.sort();
+		});
+		double const replay = test::measure(1U, [&]() noexcept {
+			backend.reset();
+			stream.submit(backend);
+		});
+		DLPH_CHECK(backend.valid() && backend.stats().draws == DRAW_CNT);
+		std::printf("cmd_stream : %u commands recorded in %.2f ms (%.1f M commands/s, %.1f MB), sort %.2f ms, headless replay %.2f ms\n",
+			DRAW_CNT * 6U, record, DRAW_CNT * 6U / record / 1000.0, stream.bytes() / 1.0e6, sort, replay);
+	}
+}
+
+int main() {
+	roundTrip();
+	sorting();
+	validation();
+	bench();
+	return dlph::test::finish("cmd_stream_test");
+}
@@ -0,0 +1,8 @@
+﻿/**	@file	crtdbg.h
+ *	@brief	Linux でテストを作るための crtdbg.h の代わり
+ */
+#pragma once
+#include <cassert>
+
+//!	@brief	式と文言を取る表明
+#define	_ASSERT_EXPR(expr, msg)	assert(expr)
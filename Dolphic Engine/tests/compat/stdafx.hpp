@@ -0,0 +1,26 @@
+﻿/**	@file	stdafx.hpp
+ *	@brief	Linux でテストを作るためのプリコンパイル済みヘッダーの代わり
+ */
+#pragma once
+#include <crtdbg.h>
+#include <cstdio>
+
+#include <string>
+#include <array>
+#include <initializer_list>
+
+#include <memory>
+#include <numeric>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+
+#if defined(_M_IX86) || defined(_M_X64)
+#	include <immintrin.h>
+#endif
+
+//!	@brief	デバッグ出力関数 (標準エラー出力へ書きます)
+inline void OutputDebugStringA(char const* str) noexcept {
+	std::fputs(str, stderr);
+}
@@ -0,0 +1,277 @@
+﻿/**	@file	frame_graph_test.cpp
+ *	@brief	フレームグラフのテストとベンチマーク
+ */
+#include "test.hpp"
+#include "dlph/dlph_frame_graph.hpp"
+#include "dlph/dlph_headless.hpp"
+#include <vector>
+
+namespace {
+	using namespace dlph;
+
+	//!	@brief	一時リソースの配置の境界
+	static unsigned long long constexpr PLACEMENT_ALIGNMENT = 65536U;
+	//!	@brief	1 MB
+	static unsigned long long constexpr MEGABYTE = 1ULL << 20U;
+
+	//!	@brief	バリアが一致するかどうか
+	bool const same(FrameGraphBarrier const& barrier, unsigned int const& resource, ResourceState const& before, ResourceState const& after, BarrierKind const& kind) noexcept {
+		return barrier.resource == resource && barrier.before == before && barrier.after == after && barrier.kind == kind;
+	}
+
+	//!	@brief	実行順の位置の前のバリアの数
+	size_t const barrierCount(FrameGraph const& graph, size_t const& slot) noexcept {
+		return static_cast<size_t>(graph.barrierEnd(slot) - graph.barrierBegin(slot));
+	}
+
+	//!	@brief	大きさ (MB 単位) を指定した一時リソースの作成関数
+	unsigned int const transientResource(FrameGraph& graph, unsigned long long const& megabytes) noexcept {
+		return graph.createResource({ megabytes * MEGABYTE, PLACEMENT_ALIGNMENT });
+	}
+
+	//!	@brief	結果の使われないパスと、後のパスに全て上書きされる書き込みしかないパスの除去
+	void culling() noexcept {
+		FrameGraph graph;
+		unsigned int const backBuffer = graph.importResource(RenderResource::make(1U, 1U), ResourceState::RenderTarget, ResourceState::RenderTarget);
+		unsigned int const unused = transientResource(graph, 1U);
+		unsigned int const scene = transientResource(graph, 1U);
+
+		unsigned int const orphan = graph.addPass();
+		graph.write(orphan, unused, ResourceState::RenderTarget);
+		unsigned int const overwritten = graph.addPass();
+		graph.write(overwritten, scene, ResourceState::RenderTarget);
+		unsigned int const draw = graph.addPass();
+		graph.write(draw, scene, ResourceState::RenderTarget);
+		unsigned int const compose = graph.addPass();
+		graph.read(compose, scene, ResourceState::ShaderResource);
+		graph.write(compose, backBuffer, ResourceState::RenderTarget);
+		unsigned int const readback = graph.addPass(true);
+		graph.read(readback, scene, ResourceState::CopySource);
+		DLPH_CHECK(!graph.write(readback, scene, ResourceState::CopyDest));
+		DLPH_CHECK(!graph.read(99U, scene, ResourceState::CopySource));
+
+		DLPH_CHECK(graph.compile());
+		DLPH_CHECK(graph.culled(orphan) && graph.culled(overwritten));
+		DLPH_CHECK(!graph.culled(draw) && !graph.culled(compose) && !graph.culled(readback));
+		DLPH_CHECK(graph.stats().passes == 3U && graph.stats().culled == 2U);
+		DLPH_CHECK(graph.passes() == 3U && graph.order()[0] == draw && graph.order()[1] == compose && graph.order()[2] == readback);
+		DLPH_CHECK(!graph.used(unused) && graph.used(scene));
+		DLPH_CHECK(graph.stats().transientBytes == MEGABYTE);
+	}
+
+	//!	@brief	間にパスを挟む状態遷移の分割、挟まない遷移、フレームの終わりの戻し
+	void splitBarriers() noexcept {
+		FrameGraph graph;
+		unsigned int const backBuffer = graph.importResource(RenderResource::make(1U, 1U), ResourceState::RenderTarget, ResourceState::RenderTarget);
+		unsigned int const target = transientResource(graph, 4U);
+		unsigned int const produce = graph.addPass();
+		graph.write(produce, target, ResourceState::RenderTarget);
+		graph.addPass(true);
+		unsigned int const consume = graph.addPass();
+		graph.read(consume, target, ResourceState::ShaderResource);
+		graph.write(consume, backBuffer, ResourceState::RenderTarget);
+		DLPH_CHECK(graph.compile());
+
+		//	間のパスの前で遷移を始め、使う直前で終える
+		DLPH_CHECK(graph.stats().splits == 1U && graph.stats().transitions == 1U);
+		DLPH_CHECK(barrierCount(graph, 0U) == 0U);
+		DLPH_CHECK(barrierCount(graph, 1U) == 1U && same(*graph.barrierBegin(1U), target, ResourceState::RenderTarget, ResourceState::ShaderResource, BarrierKind::Begin));
+		DLPH_CHECK(barrierCount(graph, 2U) == 1U && same(*graph.barrierBegin(2U), target, ResourceState::RenderTarget, ResourceState::ShaderResource, BarrierKind::End));
+		DLPH_CHECK(barrierCount(graph, 3U) == 1U && same(*graph.barrierBegin(3U), target, ResourceState::ShaderResource, ResourceState::RenderTarget, BarrierKind::Transition));
+		DLPH_CHECK(graph.firstState(target) == ResourceState::RenderTarget);
+
+		//	間のパスが無ければ分割しない
+		FrameGraph direct;
+		unsigned int const directBackBuffer = direct.importResource(RenderResource::make(1U, 1U), ResourceState::RenderTarget, ResourceState::RenderTarget);
+		unsigned int const directTarget = transientResource(direct, 4U);
+		unsigned int const first = direct.addPass();
+		direct.write(first, directTarget, ResourceState::RenderTarget);
+		unsigned int const second = direct.addPass();
+		direct.read(second, directTarget, ResourceState::ShaderResource);
+		direct.write(second, directBackBuffer, ResourceState::RenderTarget);
+		DLPH_CHECK(direct.compile());
+		DLPH_CHECK(direct.stats().splits == 0U && direct.stats().transitions == 2U);
+		DLPH_CHECK(barrierCount(direct, 1U) == 1U && same(*direct.barrierBegin(1U), directTarget, ResourceState::RenderTarget, ResourceState::ShaderResource, BarrierKind::Transition));
+	}
+
+	//!	@brief	順序無しアクセスの書き込みが続くときのバリアと、読むだけの使用で省くバリア
+	void uavBarriers() noexcept {
+		FrameGraph graph;
+		unsigned int const output = graph.importResource(RenderResource::make(1U, 1U), ResourceState::UnorderedAccess, ResourceState::UnorderedAccess);
+		unsigned int const buffer = transientResource(graph, 1U);
+		unsigned int const clear = graph.addPass();
+		graph.write(clear, buffer, ResourceState::UnorderedAccess);
+		unsigned int const accumulate = graph.addPass();
+		graph.read(accumulate, buffer, ResourceState::UnorderedAccess);
+		graph.write(accumulate, buffer, ResourceState::UnorderedAccess);
+		unsigned int const resolve = graph.addPass();
+		graph.read(resolve, buffer, ResourceState::UnorderedAccess);
+		graph.write(resolve, output, ResourceState::UnorderedAccess);
+		DLPH_CHECK(graph.compile());
+
+		DLPH_CHECK(graph.stats().uavs == 2U);
+		DLPH_CHECK(barrierCount(graph, 1U) == 1U && same(*graph.barrierBegin(1U), buffer, ResourceState::UnorderedAccess, ResourceState::UnorderedAccess, BarrierKind::UnorderedAccess));
+		DLPH_CHECK(barrierCount(graph, 2U) == 1U && same(*graph.barrierBegin(2U), buffer, ResourceState::UnorderedAccess, ResourceState::UnorderedAccess, BarrierKind::UnorderedAccess));
+		DLPH_CHECK(graph.stats().transitions == 0U && graph.stats().splits == 0U);
+		//	出力は最初から UnorderedAccess で、書き込みも一度きりなのでバリアは要らない
+		DLPH_CHECK(barrierCount(graph, 3U) == 0U);
+	}
+
+	//!	@brief	寿命の重ならない一時リソースが同じメモリに置かれ、使い始めにメモリ共有のバリアが入るかどうか
+	void aliasing() noexcept {
+		FrameGraph graph;
+		unsigned int const output1 = graph.importResource(RenderResource::make(1U, 1U), ResourceState::RenderTarget, ResourceState::RenderTarget);
+		unsigned int const output2 = graph.importResource(RenderResource::make(2U, 1U), ResourceState::RenderTarget, ResourceState::RenderTarget);
+		unsigned int const early = transientResource(graph, 8U);
+		unsigned int const late = transientResource(graph, 8U);
+		unsigned int const overlap = transientResource(graph, 2U);
+
+		unsigned int const pass0 = graph.addPass();
+		graph.write(pass0, early, ResourceState::RenderTarget);
+		unsigned int const pass1 = graph.addPass();
+		graph.read(pass1, early, ResourceState::ShaderResource);
+		graph.write(pass1, overlap, ResourceState::RenderTarget);
+		graph.write(pass1, output1, ResourceState::RenderTarget);
+		unsigned int const pass2 = graph.addPass();
+		graph.read(pass2, overlap, ResourceState::ShaderResource);
+		graph.write(pass2, late, ResourceState::RenderTarget);
+		unsigned int const pass3 = graph.addPass();
+		graph.read(pass3, late, ResourceState::ShaderResource);
+		graph.write(pass3, output2, ResourceState::RenderTarget);
+		DLPH_CHECK(graph.compile());
+
+		DLPH_CHECK(graph.offset(late) == graph.offset(early));
+		DLPH_CHECK(graph.offset(overlap) >= graph.offset(early) + 8U * MEGABYTE);
+		DLPH_CHECK(graph.offset(overlap) % PLACEMENT_ALIGNMENT == 0U);
+		DLPH_CHECK(graph.stats().transientBytes == 18U * MEGABYTE && graph.stats().heapBytes == 10U * MEGABYTE);
+		DLPH_CHECK(graph.stats().aliasing == 1U);
+
+		//	先に寿命の終わったリソースを最初の状態へ戻してから、メモリを引き継ぐ
+		DLPH_CHECK(barrierCount(graph, 2U) == 3U);
+		FrameGraphBarrier const* const barriers = graph.barrierBegin(2U);
+		DLPH_CHECK(same(barriers[0], early, ResourceState::ShaderResource, ResourceState::RenderTarget, BarrierKind::Transition));
+		DLPH_CHECK(same(barriers[1], late, ResourceState::RenderTarget, ResourceState::RenderTarget, BarrierKind::Aliasing));
+		DLPH_CHECK(same(barriers[2], overlap, ResourceState::RenderTarget, ResourceState::ShaderResource, BarrierKind::Transition));
+	}
+
+	/**	@brief	遅延描画を模した 8 パスのグラフの宣言関数
+	 *	@details	影、G バッファ、SSAO とそのぼかし、ライティング、ブルーム、トーンマップと、結果を使わないデバッグ表示のパスです。
+	 */
+	void deferred(FrameGraph& graph) noexcept {
+		graph.reset();
+		unsigned int const backBuffer = graph.importResource(RenderResource::make(1U, 1U), ResourceState::Present, ResourceState::Present);
+		unsigned int const shadow = transientResource(graph, 16U);
+		unsigned int const depth = transientResource(graph, 8U);
+		unsigned int const albedo = transientResource(graph, 8U);
+		unsigned int const normal = transientResource(graph, 8U);
+		unsigned int const ssao = transientResource(graph, 2U);
+		unsigned int const hdr = transientResource(graph, 16U);
+		unsigned int const bloom = transientResource(graph, 4U);
+		unsigned int const debug = transientResource(graph, 8U);
+
+		unsigned int pass = graph.addPass();
+		graph.write(pass, shadow, ResourceState::DepthWrite);
+		pass = graph.addPass();
+		graph.write(pass, depth, ResourceState::DepthWrite);
+		graph.write(pass, albedo, ResourceState::RenderTarget);
+		graph.write(pass, normal, ResourceState::RenderTarget);
+		pass = graph.addPass();
+		graph.read(pass, depth, ResourceState::DepthRead);
+		graph.read(pass, normal, ResourceState::ShaderResource);
+		graph.write(pass, ssao, ResourceState::UnorderedAccess);
+		pass = graph.addPass();
+		graph.read(pass, ssao, ResourceState::UnorderedAccess);
+		graph.write(pass, ssao, ResourceState::UnorderedAccess);
+		pass = graph.addPass();
+		graph.read(pass, shadow, ResourceState::ShaderResource);
+		graph.read(pass, depth, ResourceState::DepthRead);
+		graph.read(pass, albedo, ResourceState::ShaderResource);
+		graph.read(pass, normal, ResourceState::ShaderResource);
+		graph.read(pass, ssao, ResourceState::ShaderResource);
+		graph.write(pass, hdr, ResourceState::RenderTarget);
+		pass = graph.addPass();
+		graph.read(pass, hdr, ResourceState::ShaderResource);
+		graph.write(pass, bloom, ResourceState::UnorderedAccess);
+		pass = graph.addPass();
+		graph.read(pass, hdr, ResourceState::ShaderResource);
+		graph.read(pass, bloom, ResourceState::ShaderResource);
+		graph.write(pass, backBuffer, ResourceState::RenderTarget);
+		pass = graph.addPass();
+		graph.write(pass, debug, ResourceState::RenderTarget);
+	}
+
+	//!	@brief	コンパイルしたグラフを毎フレーム記録し、同じ検証用バックエンドで続けて再生しても誤りが無いかどうか
+	void headless() noexcept {
+		FrameGraph graph;
+		deferred(graph);
+		DLPH_CHECK(graph.compile());
+		DLPH_CHECK(graph.stats().passes == 7U && graph.stats().culled == 1U);
+		DLPH_CHECK(graph.stats().aliasing > 0U && graph.stats().heapBytes < graph.stats().transientBytes);
+		DLPH_CHECK(graph.stats().splits > 0U && graph.stats().uavs > 0U);
+		for (unsigned int idx = 0U; idx < graph.resourceCount(); ++idx) {
+			if (graph.transient(idx)) {
+				graph.setHandle(idx, RenderResource::make(100U + idx, 1U));
+			}
+		}
+
+		RenderCommandStream stream;
+		DLPH_CHECK(stream.init(1U << 14U));
+		HeadlessBackend backend;
+		for (unsigned int frame = 0U; frame < 4U; ++frame) {
+			stream.reset();
+			graph.execute(stream, [](unsigned int const& pass, RenderCommandStream& cmd) noexcept {
+				cmd.setPipeline(RenderPipeline::make(pass + 1U, 1U));
+				if (pass == 2U || pass == 3U || pass == 5U) {
+					cmd.dispatch(60U, 34U);
+				}
+				else {
+					cmd.draw(3U);
+				}
+			});
+			stream.submit(backend);
+		}
+		DLPH_CHECK(backend.valid());
+		DLPH_CHECK(backend.stats().draws == 4U * 4U);
+		std::printf("frame_graph : 8 passes -> %u run, %u transitions, %u split, %u uav, %u aliasing, heap %.0f MB of %.0f MB transient\n",
+			graph.stats().passes, graph.stats().transitions, graph.stats().splits, graph.stats().uavs, graph.stats().aliasing,
+			graph.stats().heapBytes / static_cast<double>(MEGABYTE), graph.stats().transientBytes / static_cast<double>(MEGABYTE));
+	}
+
+	//!	@brief	宣言とコンパイルにかかる時間の計測 (8 パスのグラフと、それを 16 回つないだグラフ)
+	void bench() noexcept {
+		FrameGraph graph;
+		double const small = test::measure(2000U, [&graph]() noexcept {
+			deferred(graph);
+			graph.compile();
+		});
+
+		FrameGraph large;
+		double const chained = test::measure(100U, [&large]() noexcept {
+			large.reset();
+			unsigned int const output = large.importResource(RenderResource::make(1U, 1U), ResourceState::Present, ResourceState::Present);
+			unsigned int previous = FRAME_GRAPH_INVALID;
+			for (unsigned int idx = 0U; idx < 128U; ++idx) {
+				unsigned int const target = transientResource(large, 1U + idx % 8U);
+				unsigned int const pass = large.addPass();
+				if (previous != FRAME_GRAPH_INVALID) {
+					large.read(pass, previous, ResourceState::ShaderResource);
+				}
+				large.write(pass, idx % 16U == 15U ? output : target, ResourceState::RenderTarget);
+				previous = idx % 16U == 15U ? previous : target;
+			}
+			large.compile();
+		});
+		std::printf("frame_graph : compile 8 passes %.1f us, 128 passes %.1f us (%u aliasing)\n",
+			small * 1000.0, chained * 1000.0, large.stats().aliasing);
+	}
+}
+
+int main() {
+	culling();
+	splitBarriers();
+	uavBarriers();
+	aliasing();
+	headless();
+	bench();
+	return dlph::test::finish("frame_graph_test");
+}
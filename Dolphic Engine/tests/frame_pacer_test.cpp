@@ -0,0 +1,86 @@
+﻿/**	@file	frame_pacer_test.cpp
+ *	@brief	フレームペーサーのテスト
+ */
+#include "test.hpp"
+#include "dlph/dlph_frame_pacer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+	using namespace dlph;
+
+	//!	@brief	slot の巡回とフェンス値の割り当て
+	void slots() noexcept {
+		FramePacer pacer;
+		DLPH_CHECK(!pacer.init(0U));
+		DLPH_CHECK(!pacer.init(FRAME_LATENCY_MAX + 1U));
+		DLPH_CHECK(pacer.init(3U));
+
+		//	一巡目の slot は一度も提出していないため待つ必要が無い
+		for (unsigned int idx = 0U; idx < 3U; ++idx) {
+			DLPH_CHECK(pacer.slot() == idx);
+			DLPH_CHECK(pacer.pending() == 0U);
+			DLPH_CHECK(!pacer.busy(0U));
+			DLPH_CHECK(pacer.submit() == idx + 1U);
+		}
+
+		//	二巡目は三フレーム前の値まで GPU が進んでいれば使える
+		DLPH_CHECK(pacer.slot() == 0U);
+		DLPH_CHECK(pacer.pending() == 1U);
+		DLPH_CHECK(pacer.busy(0U));
+		DLPH_CHECK(!pacer.busy(1U));
+		DLPH_CHECK(pacer.last() == 3U);
+		DLPH_CHECK(pacer.frame() == 3U);
+
+		pacer.exit();
+		DLPH_CHECK(pacer.last() == 0U && pacer.frame() == 0U && pacer.slot() == 0U);
+	}
+
+	/**	@brief	GPU を模した時間軸で一フレームの平均時間を求める関数
+	 *	@param[in] latency 同時に処理するフレーム数
+	 *	@param[in] cpu CPU の記録時間 (ミリ秒)
+	 *	@param[in] gpu GPU の処理時間 (ミリ秒)
+	 */
+	double const simulate(unsigned int const& latency, double const& cpu, double const& gpu) noexcept {
+		unsigned int constexpr FRAME_CNT = 100U;
+		FramePacer pacer;
+		pacer.init(latency);
+
+		//	フェンス値ごとに GPU が処理を終える時刻
+		std::vector<double> done(1U, 0.0);
+		double cpuEnd = 0.0;
+		double gpuEnd = 0.0;
+		for (unsigned int frame = 0U; frame < FRAME_CNT; ++frame) {
+			//	slot の資源を GPU が使い終えるまで記録を始められない
+			double const start = std::max(cpuEnd, done[static_cast<size_t>(pacer.pending())]);
+			cpuEnd = start + cpu;
+			unsigned long long const value = pacer.submit();
+			gpuEnd = std::max(cpuEnd, gpuEnd) + gpu;
+			done.push_back(gpuEnd);
+			DLPH_CHECK(value == done.size() - 1U);
+		}
+		return gpuEnd / FRAME_CNT;
+	}
+
+	//!	@brief	CPU と GPU の時間が等しいとき、二フレーム重ねると一フレームの時間が半分になるかどうか
+	void timeline() noexcept {
+		double const latency1 = simulate(1U, 10.0, 10.0);
+		double const latency2 = simulate(2U, 10.0, 10.0);
+		double const latency3 = simulate(3U, 10.0, 10.0);
+		DLPH_CHECK(std::fabs(latency1 - 20.0) < 0.2);
+		DLPH_CHECK(std::fabs(latency2 - 10.0) < 0.2);
+		DLPH_CHECK(std::fabs(latency3 - 10.0) < 0.2);
+
+		//	GPU が律速なら重ねるほど GPU の時間に近づき、CPU を待たせる
+		double const gpuBound = simulate(3U, 4.0, 10.0);
+		DLPH_CHECK(std::fabs(gpuBound - 10.0) < 0.2);
+		std::printf("frame_pacer : cpu 10 ms, gpu 10 ms -> latency 1 %.1f ms, 2 %.1f ms, 3 %.1f ms per frame\n", latency1, latency2, latency3);
+	}
+}
+
+int main() {
+	slots();
+	timeline();
+	return dlph::test::finish("frame_pacer_test");
+}
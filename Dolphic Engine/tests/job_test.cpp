@@ -0,0 +1,100 @@
+﻿/**	@file	job_test.cpp
+ *	@brief	ジョブシステムのテストとベンチマーク
+ */
+#include "test.hpp"
+#include "job/job_system.hpp"
+#include "util/parallel.hpp"
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+namespace dlph {
+	namespace test {
+		bool const pool_running() noexcept;
+		size_t const run_outside_pool(size_t const& count, size_t const& grain, unsigned long long& sum) noexcept;
+	}
+}
+
+namespace {
+	using namespace dlph;
+
+	//!	@brief	入れ子の待機を含む大量のジョブ
+	void nested() noexcept {
+		JobSystem& jobs = JobSystem::getInstance();
+		std::atomic<long> sum(0);
+		for (int round = 0; round < 50; ++round) {
+			JobCounter counter;
+			for (int idx = 0; idx < 2000; ++idx) {
+				jobs.run([&sum, &jobs, idx]() noexcept {
+					if (idx % 100 == 0) {
+						JobCounter inner;
+						for (int sub = 0; sub < 10; ++sub) {
+							jobs.run([&sum]() noexcept { sum.fetch_add(1); }, &inner);
+						}
+						jobs.wait(inner);
+					}
+					sum.fetch_add(1);
+				}, &counter);
+			}
+			jobs.wait(counter);
+			DLPH_CHECK(counter.done());
+		}
+		DLPH_CHECK(sum.load() == 50 * (2000 + 200));
+	}
+
+	//!	@brief	ワーカー以外のスレッドからの投入
+	void external() noexcept {
+		JobSystem& jobs = JobSystem::getInstance();
+		std::atomic<int> count(0);
+		std::thread thread([&jobs, &count]() noexcept {
+			JobCounter counter;
+			for (int idx = 0; idx < 1000; ++idx) {
+				jobs.run([&count]() noexcept { count.fetch_add(1); }, &counter);
+			}
+			jobs.wait(counter);
+		});
+		thread.join();
+		DLPH_CHECK(count.load() == 1000);
+	}
+
+	//!	@brief	別の翻訳単位から parallel_for がワーカーへ届くかどうか
+	void crossUnit() noexcept {
+		size_t const count = 1U << 20U;
+		unsigned long long sum = 0U;
+		DLPH_CHECK(test::pool_running());
+		size_t const outside = test::run_outside_pool(count, 1024U, sum);
+		DLPH_CHECK(outside == 0U);
+		DLPH_CHECK(sum == static_cast<unsigned long long>(count) * (count - 1U) / 2U);
+	}
+
+	//!	@brief	parallelFor と parallel_for の計測
+	void bench() noexcept {
+		JobSystem& jobs = JobSystem::getInstance();
+		std::vector<float> values(1U << 22U, 1.0f);
+		auto const kernel = [&values](size_t const& begin, size_t const& end) noexcept {
+			for (size_t idx = begin; idx < end; ++idx) {
+				values[idx] = std::sqrt(values[idx] * 2.0f + 1.0f);
+			}
+		};
+		double const serial = test::measure(5U, [&kernel, &values]() noexcept { kernel(0U, values.size()); });
+		double const pooled = test::measure(20U, [&jobs, &kernel, &values]() noexcept { jobs.parallelFor(values.size(), kernel); });
+		double const forwarded = test::measure(20U, [&kernel, &values]() noexcept { parallel_for(values.size(), 16384U, kernel); });
+		std::printf("job : 4M sqrt serial %.2f ms, parallelFor %.2f ms, parallel_for %.2f ms (%zu workers)\n",
+			serial, pooled, forwarded, jobs.workerCount());
+	}
+}
+
+int main() {
+	using namespace dlph;
+	JobSystem& jobs = JobSystem::getInstance();
+	DLPH_CHECK(jobs.init(3U));
+	DLPH_CHECK(jobs.running());
+	nested();
+	external();
+	crossUnit();
+	bench();
+	jobs.exit();
+	DLPH_CHECK(!jobs.running());
+	return test::finish("job_test");
+}
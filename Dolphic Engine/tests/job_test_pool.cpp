@@ -0,0 +1,33 @@
+﻿/**	@file	job_test_pool.cpp
+ *	@brief	ジョブシステムのテスト (init と別の翻訳単位から parallel_for を呼びます)
+ */
+#include "util/parallel.hpp"
+#include <atomic>
+#include <cstdint>
+
+namespace dlph {
+	namespace test {
+		//!	@brief	この翻訳単位から見たジョブシステムが動いているかどうか
+		bool const pool_running() noexcept {
+			return JobSystem::getInstance().running();
+		}
+
+		//!	@brief	ワーカー以外のスレッドで実行した区間の数を返す並列処理
+		size_t const run_outside_pool(size_t const& count, size_t const& grain, unsigned long long& sum) noexcept {
+			std::atomic<size_t> outside(0U);
+			std::atomic<unsigned long long> total(0U);
+			parallel_for(count, grain, [&outside, &total](size_t const& begin, size_t const& end) noexcept {
+				if (JobSystem::workerIndex() == SIZE_MAX) {
+					outside.fetch_add(1U);
+				}
+				unsigned long long local = 0U;
+				for (size_t idx = begin; idx < end; ++idx) {
+					local += idx;
+				}
+				total.fetch_add(local);
+			});
+			sum = total.load();
+			return outside.load();
+		}
+	}
+}
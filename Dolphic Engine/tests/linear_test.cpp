@@ -0,0 +1,184 @@
+﻿/**	@file	linear_test.cpp
+ *	@brief	スレッドセーフな線形区間確保器のテストとベンチマーク
+ */
+#include "test.hpp"
+#include "mem/atomic_linear.hpp"
+#include "dlph/dlph_frame_pacer.hpp"
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+	using namespace dlph;
+
+	//!	@brief	定数バッファの配置境界 (D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT)
+	static unsigned long long constexpr CONSTANT_ALIGNMENT = 256U;
+	//!	@brief	確保するスレッドの数
+	static unsigned int constexpr THREAD_CNT = 8U;
+
+	//!	@brief	切り上げ、境界、容量の端での失敗と、失敗後も進んだままの位置
+	void arithmetic() noexcept {
+		AtomicLinearAllocator linear;
+		DLPH_CHECK(!linear.init(0U, CONSTANT_ALIGNMENT));
+		DLPH_CHECK(!linear.init(1024U, 0U));
+		DLPH_CHECK(!linear.init(1024U, 384U));
+		DLPH_CHECK(linear.init(1024U, CONSTANT_ALIGNMENT));
+
+		DLPH_CHECK(linear.align(1U) == 256U && linear.align(256U) == 256U && linear.align(257U) == 512U);
+		DLPH_CHECK(linear.allocate(0U) == LINEAR_INVALID);
+		DLPH_CHECK(linear.allocate(1025U) == LINEAR_INVALID);
+
+		DLPH_CHECK(linear.allocate(1U) == 0U);
+		DLPH_CHECK(linear.allocate(300U) == 256U);
+		DLPH_CHECK(linear.allocate(256U) == 768U);
+		DLPH_CHECK(linear.used() == 1024U);
+		DLPH_CHECK(linear.allocate(1U) == LINEAR_INVALID);
+
+		//	溢れた確保でも位置は容量を超えて進むが、used は容量で止まる
+		DLPH_CHECK(linear.allocate(1U) == LINEAR_INVALID);
+		DLPH_CHECK(linear.used() == 1024U);
+
+		linear.reset();
+		DLPH_CHECK(linear.used() == 0U && linear.peak() == 1024U);
+		DLPH_CHECK(linear.allocate(1024U) == 0U);
+		linear.exit();
+		DLPH_CHECK(linear.capacity() == 0U && linear.peak() == 0U);
+	}
+
+	/**	@brief	複数のスレッドから確保した区間を集める関数
+	 *	@param[in] linear 確保器
+	 *	@param[in] count スレッドごとの確保数
+	 *	@return 確保できた (先頭位置, 切り上げた大きさ) の組
+	 */
+	std::vector<std::pair<unsigned long long, unsigned long long>> const gather(AtomicLinearAllocator& linear, unsigned int const& count) noexcept {
+		std::vector<std::vector<std::pair<unsigned long long, unsigned long long>>> slices(THREAD_CNT);
+		std::vector<std::thread> threads;
+		for (unsigned int idx = 0U; idx < THREAD_CNT; ++idx) {
+			threads.emplace_back([&linear, &slices, idx, count]() noexcept {
+				std::mt19937 rng(idx);
+				for (unsigned int op = 0U; op < count; ++op) {
+					unsigned long long const size = 1U + rng() % 1024U;
+					unsigned long long const offset = linear.allocate(size);
+					if (offset != LINEAR_INVALID) {
+						slices[idx].emplace_back(offset, linear.align(size));
+					}
+				}
+			});
+		}
+		for (std::thread& thread : threads) {
+			thread.join();
+		}
+
+		std::vector<std::pair<unsigned long long, unsigned long long>> result;
+		for (std::vector<std::pair<unsigned long long, unsigned long long>> const& slice : slices) {
+			result.insert(result.end(), slice.begin(), slice.end());
+		}
+		std::sort(result.begin(), result.end());
+		return result;
+	}
+
+	//!	@brief	区間が境界に揃い、重ならず、容量に収まるかどうかを数える関数
+	unsigned int const violations(std::vector<std::pair<unsigned long long, unsigned long long>> const& slices, unsigned long long const& capacity) noexcept {
+		unsigned int result = 0U;
+		for (size_t idx = 0U; idx < slices.size(); ++idx) {
+			unsigned long long const offset = slices[idx].first;
+			unsigned long long const end = offset + slices[idx].second;
+			result += offset % CONSTANT_ALIGNMENT != 0U || end > capacity ? 1U : 0U;
+			result += idx + 1U < slices.size() && end > slices[idx + 1U].first ? 1U : 0U;
+		}
+		return result;
+	}
+
+	//!	@brief	複数のスレッドから同時に確保した区間が重ならないかどうか (収まる場合と溢れる場合)
+	void threaded() noexcept {
+		unsigned int constexpr COUNT = 20000U;
+		AtomicLinearAllocator linear;
+		DLPH_CHECK(linear.init(THREAD_CNT * COUNT * 1024ULL, CONSTANT_ALIGNMENT));
+		std::vector<std::pair<unsigned long long, unsigned long long>> const slices = gather(linear, COUNT);
+		DLPH_CHECK(slices.size() == THREAD_CNT * COUNT);
+		DLPH_CHECK(violations(slices, linear.capacity()) == 0U);
+
+		//	隙間なく前から詰まっているので、大きさの合計が使用量に一致する
+		unsigned long long total = 0U;
+		for (std::pair<unsigned long long, unsigned long long> const& slice : slices) {
+			total += slice.second;
+		}
+		DLPH_CHECK(total == linear.used());
+
+		//	容量を超える数を奪い合っても、成功した区間だけは容量の中で重ならない
+		DLPH_CHECK(linear.init(1ULL << 20U, CONSTANT_ALIGNMENT));
+		std::vector<std::pair<unsigned long long, unsigned long long>> const crowded = gather(linear, COUNT);
+		DLPH_CHECK(!crowded.empty() && crowded.size() < THREAD_CNT * COUNT);
+		DLPH_CHECK(violations(crowded, linear.capacity()) == 0U);
+		DLPH_CHECK(linear.used() == linear.capacity());
+	}
+
+	//!	@brief	D3D12ConstantAllocator と同じく slot ごとの区画に分けたとき、区画の外に出ないかどうか
+	void slots() noexcept {
+		unsigned long long const frameSize = (1000U + CONSTANT_ALIGNMENT - 1U) & ~(CONSTANT_ALIGNMENT - 1U);
+		DLPH_CHECK(frameSize == 1024U);
+		AtomicLinearAllocator frames[FRAME_LATENCY_MAX];
+		for (AtomicLinearAllocator& frame : frames) {
+			DLPH_CHECK(frame.init(frameSize, CONSTANT_ALIGNMENT));
+		}
+
+		unsigned int outside = 0U;
+		for (unsigned int frame = 0U; frame < 30U; ++frame) {
+			unsigned int const slot = frame % FRAME_LATENCY_MAX;
+			frames[slot].reset();
+			for (unsigned int idx = 0U; idx < 8U; ++idx) {
+				unsigned long long const size = 1U + (frame * 7U + idx * 131U) % 512U;
+				unsigned long long const offset = frames[slot].allocate(size);
+				if (offset == LINEAR_INVALID) {
+					continue;
+				}
+				unsigned long long const position = frameSize * slot + offset;
+				outside += position % CONSTANT_ALIGNMENT != 0U ? 1U : 0U;
+				outside += position < frameSize * slot || position + frames[slot].align(size) > frameSize * (slot + 1U) ? 1U : 0U;
+			}
+		}
+		DLPH_CHECK(outside == 0U);
+	}
+
+	//!	@brief	一スレッドと全スレッドで確保した場合の計測
+	void bench() noexcept {
+		unsigned int constexpr COUNT = 1000000U;
+		AtomicLinearAllocator linear;
+		linear.init(THREAD_CNT * COUNT * CONSTANT_ALIGNMENT, CONSTANT_ALIGNMENT);
+
+		unsigned long long sink = 0U;
+		double const single = test::measure(1U, [&]() noexcept {
+			for (unsigned int op = 0U; op < COUNT; ++op) {
+				sink += linear.allocate(64U);
+			}
+		});
+		linear.reset();
+
+		double const shared = test::measure(1U, [&]() noexcept {
+			std::vector<std::thread> threads;
+			for (unsigned int idx = 0U; idx < THREAD_CNT; ++idx) {
+				threads.emplace_back([&linear]() noexcept {
+					for (unsigned int op = 0U; op < COUNT; ++op) {
+						linear.allocate(64U);
+					}
+				});
+			}
+			for (std::thread& thread : threads) {
+				thread.join();
+			}
+		});
+		DLPH_CHECK(linear.used() == THREAD_CNT * COUNT * CONSTANT_ALIGNMENT);
+		std::printf("linear : 1 thread %.1f M allocs/s, %u threads %.1f M allocs/s (%llu)\n",
+			COUNT / single / 1000.0, THREAD_CNT, THREAD_CNT * COUNT / shared / 1000.0, sink & 1U);
+	}
+}
+
+int main() {
+	arithmetic();
+	threaded();
+	slots();
+	bench();
+	return dlph::test::finish("linear_test");
+}
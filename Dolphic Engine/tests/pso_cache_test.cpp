@@ -0,0 +1,307 @@
+﻿/**	@file	pso_cache_test.cpp
+ *	@brief	パイプラインキャッシュとハッシュ関数のテスト
+ */
+#include "test.hpp"
+#include "dlph/dlph_pso_cache.hpp"
+#include "util/hash.hpp"
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+	using namespace dlph;
+
+	//!	@brief	パイプラインの数
+	static unsigned int constexpr PIPELINE_CNT = 64U;
+	//!	@brief	環境タグ
+	static unsigned long long constexpr TAG = 0x1234ULL;
+	//!	@brief	キャッシュのファイル (ctest の作業ディレクトリからの相対)
+	static char const* const CACHE_PATH = "pso_cache_data.bin";
+
+	//!	@brief	パイプラインの代わりに返す値
+	int g_pipelines[PIPELINE_CNT];
+	//!	@brief	作成関数を呼んだ回数
+	std::atomic<unsigned int> g_created(0U);
+	//!	@brief	保存したデータを受け取った回数
+	std::atomic<unsigned int> g_warm(0U);
+	//!	@brief	受け取ったデータが保存したものと違った回数
+	std::atomic<unsigned int> g_mismatch(0U);
+
+	//!	@brief	番号ごとのキー
+	unsigned long long const pipelineKey(unsigned int const& idx) noexcept {
+		return hash_bytes(&idx, sizeof(idx), 77U);
+	}
+
+	//!	@brief	番号ごとのキャッシュデータ (3 の倍数の番号は空)
+	std::vector<unsigned char> const pipelineBlob(unsigned int const& idx) noexcept {
+		std::vector<unsigned char> blob(idx % 3U == 0U ? 0U : 16U + idx * 37U);
+		for (size_t pos = 0U; pos < blob.size(); ++pos) {
+			blob[pos] = static_cast<unsigned char>(pos * 13U + idx);
+		}
+		return blob;
+	}
+
+	//!	@brief	番号ごとの作成関数 (失敗させる場合は nullptr を返します)
+	auto const creator(unsigned int const& idx, bool const& fail = false) noexcept {
+		return [idx, fail](unsigned char const* data, size_t const& size, std::vector<unsigned char>& out) noexcept -> void* {
+			++g_created;
+			if (data != nullptr) {
+				std::vector<unsigned char> const expected = pipelineBlob(idx);
+				++g_warm;
+				g_mismatch += size != expected.size() || std::memcmp(data, expected.data(), size) != 0 ? 1U : 0U;
+			}
+			if (fail) {
+				return nullptr;
+			}
+			out = pipelineBlob(idx);
+			return &g_pipelines[idx];
+		};
+	}
+
+	//!	@brief	何もしない解放関数
+	void discard(void*) noexcept {}
+
+	/**	@struct	RawEntry
+	 *	@brief	手で組み立てるファイルのデータ
+	 */
+	struct RawEntry final {
+		//!	@brief	キー
+		unsigned long long key;
+		//!	@brief	データ
+		std::vector<unsigned char> blob;
+		//!	@brief	見出しに書くハッシュを壊すかどうか
+		bool corrupt;
+	};
+
+	/**	@brief	ファイルの組み立て関数
+	 *	@param[in] magic 識別子
+	 *	@param[in] version 版
+	 *	@param[in] tag 環境タグ
+	 *	@param[in] entries データ
+	 *	@param[in] cut 末尾から削るバイト数
+	 */
+	void writeRaw(unsigned int const& magic, unsigned int const& version, unsigned long long const& tag, std::vector<RawEntry> const& entries, size_t const& cut = 0U) noexcept {
+		std::vector<unsigned char> bytes;
+		auto const append = [&bytes](void const* data, size_t const& size) noexcept {
+			unsigned char const* const ptr = static_cast<unsigned char const*>(data);
+			bytes.insert(bytes.end(), ptr, ptr + size);
+		};
+		unsigned int const count = static_cast<unsigned int>(entries.size());
+		unsigned int const reserved = 0U;
+		append(&magic, sizeof(magic));
+		append(&version, sizeof(version));
+		append(&count, sizeof(count));
+		append(&reserved, sizeof(reserved));
+		append(&tag, sizeof(tag));
+		for (RawEntry const& entry : entries) {
+			unsigned long long const size = entry.blob.size();
+			unsigned long long const hash = hash_bytes(entry.blob.data(), entry.blob.size()) ^ (entry.corrupt ? 1ULL : 0ULL);
+			append(&entry.key, sizeof(entry.key));
+			append(&size, sizeof(size));
+			append(&hash, sizeof(hash));
+			append(entry.blob.data(), entry.blob.size());
+		}
+		bytes.resize(bytes.size() - cut);
+		std::ofstream(CACHE_PATH, std::ios::binary | std::ios::trunc).write(reinterpret_cast<char const*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+	}
+
+	//!	@brief	XXH64 の参照値 (xxHash 0.8 の XXH64 で求めた値) と一致するかどうか
+	void hashVectors() noexcept {
+		char const* const text = "Nobody inspects the spammish repetition";
+		DLPH_CHECK(hash_bytes("", 0U) == 0xEF46DB3751D8E999ULL);
+		DLPH_CHECK(hash_bytes("a", 1U) == 0xD24EC4F1A98C6E5BULL);
+		DLPH_CHECK(hash_bytes("abc", 3U) == 0x44BC2CF5AD770999ULL);
+		DLPH_CHECK(hash_bytes(text, std::strlen(text)) == 0xFBCEA83C8A378BF1ULL);
+		DLPH_CHECK(hash_bytes(text, std::strlen(text), 20141025U) == 0xCE06936136852706ULL);
+
+		//	32 バイトの塊の前後と、塊を何周もする長さ
+		struct Vector final {
+			size_t size;
+			unsigned long long unseeded;
+			unsigned long long seeded;
+		};
+		Vector const vectors[] = {
+			{ 31U, 0x4A74F3A1A39AD4A1ULL, 0x8137041F5AF88413ULL },
+			{ 32U, 0x8D57D6A4671CC43DULL, 0x184EBCF3745CD46CULL },
+			{ 33U, 0x62C9FD21ED857664ULL, 0x52FAC3C981F3CC2EULL },
+			{ 64U, 0x7BBABBC45729D17EULL, 0xF7F22435FE1AB128ULL },
+			{ 100U, 0xEFA0AD2D3E70C151ULL, 0xBC7AB33BE7528C18ULL },
+			{ 1000U, 0x99594F4828043D35ULL, 0xDA717F741F399F3FULL },
+		};
+		std::vector<unsigned char> data(1001U);
+		for (size_t idx = 0U; idx < 1000U; ++idx) {
+			data[idx + 1U] = static_cast<unsigned char>(idx * 31U + 7U);
+		}
+		for (Vector const& vector : vectors) {
+			//	先頭を 1 バイトずらし、境界に揃っていない読み込みも確かめる
+			DLPH_CHECK(hash_bytes(data.data() + 1U, vector.size) == vector.unseeded);
+			DLPH_CHECK(hash_bytes(data.data() + 1U, vector.size, 0x9E3779B97F4A7C15ULL) == vector.seeded);
+		}
+	}
+
+	//!	@brief	作成、保存、読み込み、保存したデータを使った作成
+	void roundTrip() noexcept {
+		PipelineCache cache;
+		DLPH_CHECK(cache.init(TAG));
+		DLPH_CHECK(!cache.load("pso_cache_missing.bin"));
+		g_created = 0U;
+		g_warm = 0U;
+		for (unsigned int idx = 0U; idx < PIPELINE_CNT; ++idx) {
+			cache.request(pipelineKey(idx), creator(idx));
+		}
+		cache.wait();
+		unsigned int wrong = 0U;
+		for (unsigned int idx = 0U; idx < PIPELINE_CNT; ++idx) {
+			wrong += cache.status(pipelineKey(idx)) != PipelineStatus::Ready || cache.find(pipelineKey(idx)) != &g_pipelines[idx] ? 1U : 0U;
+		}
+		DLPH_CHECK(wrong == 0U);
+		DLPH_CHECK(g_created == PIPELINE_CNT && g_warm == 0U);
+		DLPH_CHECK(cache.request(pipelineKey(0U), creator(0U)) == PipelineStatus::Ready);
+		DLPH_CHECK(cache.find(pipelineKey(PIPELINE_CNT)) == nullptr);
+
+		//	空のデータは保存しない
+		unsigned int const stored = PIPELINE_CNT - (PIPELINE_CNT + 2U) / 3U;
+		DLPH_CHECK(cache.save(CACHE_PATH));
+		DLPH_CHECK(cache.stats().saved == stored);
+		cache.release(discard);
+		DLPH_CHECK(cache.status(pipelineKey(1U)) == PipelineStatus::Missing);
+
+		PipelineCache reloaded;
+		DLPH_CHECK(reloaded.init(TAG));
+		DLPH_CHECK(reloaded.load(CACHE_PATH));
+		DLPH_CHECK(reloaded.stats().loaded == stored);
+		g_created = 0U;
+		g_mismatch = 0U;
+		for (unsigned int idx = 0U; idx < PIPELINE_CNT; ++idx) {
+			reloaded.request(pipelineKey(idx), creator(idx));
+		}
+		reloaded.wait();
+		DLPH_CHECK(g_created == PIPELINE_CNT && g_warm == stored && g_mismatch == 0U);
+		DLPH_CHECK(reloaded.stats().warm == stored);
+		reloaded.release(discard);
+		cache.exit();
+	}
+
+	//!	@brief	識別子、版、環境タグの違うファイルと、最初の見出しで切れたファイルから何も読み込まないかどうか
+	void rejection() noexcept {
+		std::vector<RawEntry> const entries = { { pipelineKey(1U), pipelineBlob(1U), false } };
+		PipelineCache cache;
+		DLPH_CHECK(cache.init(TAG));
+
+		writeRaw(PIPELINE_CACHE_MAGIC + 1U, PIPELINE_CACHE_VERSION, TAG, entries);
+		DLPH_CHECK(!cache.load(CACHE_PATH));
+		writeRaw(PIPELINE_CACHE_MAGIC, PIPELINE_CACHE_VERSION + 1U, TAG, entries);
+		DLPH_CHECK(!cache.load(CACHE_PATH));
+		writeRaw(PIPELINE_CACHE_MAGIC, PIPELINE_CACHE_VERSION, TAG + 1U, entries);
+		DLPH_CHECK(!cache.load(CACHE_PATH));
+		writeRaw(PIPELINE_CACHE_MAGIC, PIPELINE_CACHE_VERSION, TAG, entries, entries[0].blob.size() + 30U);
+		DLPH_CHECK(!cache.load(CACHE_PATH));
+		DLPH_CHECK(cache.stats().loaded == 0U && cache.size() == 0U);
+
+		writeRaw(PIPELINE_CACHE_MAGIC, PIPELINE_CACHE_VERSION, TAG, entries);
+		DLPH_CHECK(cache.load(CACHE_PATH));
+		DLPH_CHECK(cache.stats().loaded == 1U);
+	}
+
+	//!	@brief	ハッシュの合わないデータは飛ばして続きを読み、途中で切れたデータと壊れた大きさで止まるかどうか
+	void broken() noexcept {
+		//	二つ目のハッシュを壊し、五つ目のデータを途中で切る
+		unsigned int const indices[5] = { 1U, 2U, 4U, 5U, 7U };
+		std::vector<RawEntry> entries;
+		for (unsigned int const& idx : indices) {
+			entries.push_back({ pipelineKey(idx), pipelineBlob(idx), idx == 2U });
+		}
+		PipelineCache cache;
+		DLPH_CHECK(cache.init(TAG));
+		writeRaw(PIPELINE_CACHE_MAGIC, PIPELINE_CACHE_VERSION, TAG, entries, entries[4].blob.size() / 2U);
+		DLPH_CHECK(!cache.load(CACHE_PATH));
+		DLPH_CHECK(cache.stats().loaded == 3U);
+
+		g_created = 0U;
+		g_warm = 0U;
+		g_mismatch = 0U;
+		for (unsigned int const& idx : indices) {
+			cache.request(pipelineKey(idx), creator(idx));
+		}
+		cache.wait();
+		DLPH_CHECK(g_created == 5U && g_warm == 3U && g_mismatch == 0U);
+		cache.release(discard);
+
+		//	大きさが上限を超える見出しでは、その後ろを読まない
+		PipelineCache oversized;
+		DLPH_CHECK(oversized.init(TAG));
+		std::vector<RawEntry> const first = { entries[0] };
+		writeRaw(PIPELINE_CACHE_MAGIC, PIPELINE_CACHE_VERSION, TAG, first);
+		std::vector<unsigned char> bytes;
+		{
+			std::ifstream file(CACHE_PATH, std::ios::binary | std::ios::ate);
+			bytes.resize(static_cast<size_t>(file.tellg()));
+			file.seekg(0);
+			file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+		}
+		unsigned int const two = 2U;
+		std::memcpy(bytes.data() + 8U, &two, sizeof(two));
+		unsigned long long const huge = PIPELINE_CACHE_BLOB_MAX + 1U;
+		unsigned long long const key = pipelineKey(9U);
+		bytes.insert(bytes.end(), reinterpret_cast<unsigned char const*>(&key), reinterpret_cast<unsigned char const*>(&key) + sizeof(key));
+		bytes.insert(bytes.end(), reinterpret_cast<unsigned char const*>(&huge), reinterpret_cast<unsigned char const*>(&huge) + sizeof(huge));
+		bytes.resize(bytes.size() + 8U + 64U, 0U);
+		std::ofstream(CACHE_PATH, std::ios::binary | std::ios::trunc).write(reinterpret_cast<char const*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+		DLPH_CHECK(!oversized.load(CACHE_PATH));
+		DLPH_CHECK(oversized.stats().loaded == 1U);
+		DLPH_CHECK(oversized.status(key) == PipelineStatus::Missing);
+	}
+
+	//!	@brief	複数のスレッドが同じキーを要求しながら探しても、作成は一度ずつで、失敗したものは作り直さないかどうか
+	void concurrent() noexcept {
+		unsigned int constexpr THREAD_CNT = 6U;
+		PipelineCache cache;
+		DLPH_CHECK(cache.init(TAG));
+		g_created = 0U;
+
+		std::atomic<unsigned int> wrong(0U);
+		std::vector<std::thread> threads;
+		for (unsigned int thread = 0U; thread < THREAD_CNT; ++thread) {
+			threads.emplace_back([&cache, &wrong, thread]() noexcept {
+				for (unsigned int step = 0U; step < PIPELINE_CNT * 4U; ++step) {
+					unsigned int const idx = (step + thread * 11U) % PIPELINE_CNT;
+					bool const fail = idx % 8U == 7U;
+					PipelineStatus const status = cache.request(pipelineKey(idx), creator(idx, fail));
+					void* const pipeline = cache.find(pipelineKey(idx));
+					//	作成中なら nullptr、作成済みなら必ず自分のパイプラインが返る
+					wrong += pipeline != nullptr && pipeline != &g_pipelines[idx] ? 1U : 0U;
+					wrong += fail && (pipeline != nullptr || status == PipelineStatus::Ready) ? 1U : 0U;
+				}
+			});
+		}
+		for (std::thread& thread : threads) {
+			thread.join();
+		}
+		cache.wait();
+
+		DLPH_CHECK(wrong == 0U);
+		DLPH_CHECK(g_created == PIPELINE_CNT);
+		PipelineCacheStats const stats = cache.stats();
+		DLPH_CHECK(stats.created == PIPELINE_CNT - PIPELINE_CNT / 8U && stats.failed == PIPELINE_CNT / 8U);
+		DLPH_CHECK(cache.status(pipelineKey(7U)) == PipelineStatus::Failed);
+		DLPH_CHECK(cache.size() == PIPELINE_CNT);
+		std::printf("pso_cache : %u threads, %llu finds (%llu hits), %llu created, %llu failed\n",
+			THREAD_CNT, stats.hits + stats.misses, stats.hits, stats.created, stats.failed);
+		cache.release(discard);
+	}
+}
+
+int main() {
+	JobSystem& jobs = JobSystem::getInstance();
+	DLPH_CHECK(jobs.init(3U));
+	hashVectors();
+	roundTrip();
+	rejection();
+	broken();
+	concurrent();
+	jobs.exit();
+	return dlph::test::finish("pso_cache_test");
+}
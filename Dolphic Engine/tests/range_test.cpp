@@ -0,0 +1,193 @@
+﻿/**	@file	range_test.cpp
+ *	@brief	区間アロケータと区間リングのテストとベンチマーク
+ */
+#include "test.hpp"
+#include "mem/range_alloc.hpp"
+#include "mem/range_ring.hpp"
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+	using namespace dlph;
+
+	//!	@brief	確保と解放、最も小さく収まる空き区間の選択、前後の空き区間との結合
+	void allocator() noexcept {
+		RangeAllocator ranges;
+		DLPH_CHECK(!ranges.init(0U));
+		DLPH_CHECK(ranges.init(100U));
+		DLPH_CHECK(ranges.allocate(0U) == RANGE_INVALID);
+
+		unsigned int const a = ranges.allocate(10U);
+		unsigned int const b = ranges.allocate(20U);
+		unsigned int const c = ranges.allocate(30U);
+		unsigned int const d = ranges.allocate(40U);
+		DLPH_CHECK(a == 0U && b == 10U && c == 30U && d == 60U);
+		DLPH_CHECK(ranges.used() == 100U && ranges.largest() == 0U && ranges.fragments() == 0U);
+		DLPH_CHECK(ranges.allocate(1U) == RANGE_INVALID);
+
+		//	20 と 40 の空きがあれば、15 は後ろの大きな区間を削らず 20 の区間から取る
+		ranges.release(b, 20U);
+		ranges.release(d, 40U);
+		DLPH_CHECK(ranges.fragments() == 2U && ranges.largest() == 40U);
+		unsigned int const e = ranges.allocate(15U);
+		DLPH_CHECK(e == 10U);
+		DLPH_CHECK(ranges.fragments() == 2U && ranges.largest() == 40U);
+		DLPH_CHECK(ranges.allocate(41U) == RANGE_INVALID);
+
+		//	後ろの空きと、前の空きと、両側の空きとの結合
+		ranges.release(e, 15U);
+		DLPH_CHECK(ranges.fragments() == 2U && ranges.largest() == 40U);
+		ranges.release(a, 10U);
+		DLPH_CHECK(ranges.fragments() == 2U && ranges.largest() == 40U);
+		ranges.release(c, 30U);
+		DLPH_CHECK(ranges.fragments() == 1U && ranges.largest() == 100U && ranges.used() == 0U);
+		DLPH_CHECK(ranges.allocate(100U) == 0U);
+
+		ranges.reset();
+		DLPH_CHECK(ranges.used() == 0U && ranges.largest() == 100U);
+		ranges.exit();
+		DLPH_CHECK(ranges.capacity() == 0U && ranges.allocate(1U) == RANGE_INVALID);
+	}
+
+	//!	@brief	乱数で確保と解放を繰り返しても区間が重ならず、全て返せば一つの空き区間に戻るかどうか
+	void shuffled() noexcept {
+		unsigned int constexpr CAPACITY = 4096U;
+		RangeAllocator ranges;
+		DLPH_CHECK(ranges.init(CAPACITY));
+		std::vector<unsigned char> owned(CAPACITY, 0U);
+		std::vector<std::pair<unsigned int, unsigned int>> live;
+		std::mt19937 rng(7U);
+
+		unsigned int overlap = 0U;
+		for (unsigned int step = 0U; step < 20000U; ++step) {
+			if (live.empty() || rng() % 3U != 0U) {
+				unsigned int const count = 1U + rng() % 64U;
+				unsigned int const offset = ranges.allocate(count);
+				if (offset == RANGE_INVALID) {
+					continue;
+				}
+				for (unsigned int idx = offset; idx < offset + count; ++idx) {
+					overlap += owned[idx]++ != 0U ? 1U : 0U;
+				}
+				live.emplace_back(offset, count);
+			}
+			else {
+				size_t const pick = rng() % live.size();
+				std::pair<unsigned int, unsigned int> const range = live[pick];
+				live[pick] = live.back();
+				live.pop_back();
+				for (unsigned int idx = range.first; idx < range.first + range.second; ++idx) {
+					--owned[idx];
+				}
+				ranges.release(range.first, range.second);
+			}
+		}
+		DLPH_CHECK(overlap == 0U);
+
+		for (std::pair<unsigned int, unsigned int> const& range : live) {
+			ranges.release(range.first, range.second);
+		}
+		DLPH_CHECK(ranges.used() == 0U && ranges.fragments() == 1U && ranges.largest() == CAPACITY);
+	}
+
+	//!	@brief	slot ごとの回収と、末尾に収まらない区間が先頭から取られる折り返し
+	void ring() noexcept {
+		RangeRing ring;
+		DLPH_CHECK(!ring.init(0U));
+		DLPH_CHECK(ring.init(100U));
+		DLPH_CHECK(ring.allocate(0U) == RANGE_INVALID);
+		DLPH_CHECK(ring.allocate(101U) == RANGE_INVALID);
+
+		//	二フレームを重ねる場合、slot 0 と 1 を交互に使う
+		ring.begin(0U);
+		DLPH_CHECK(ring.allocate(40U) == 0U);
+		ring.end(0U);
+		ring.begin(1U);
+		DLPH_CHECK(ring.allocate(40U) == 40U);
+		ring.end(1U);
+		DLPH_CHECK(ring.used() == 80U);
+
+		//	slot 0 の前回分が返り、末尾の 20 は捨てて先頭から取る
+		ring.begin(0U);
+		DLPH_CHECK(ring.used() == 40U);
+		DLPH_CHECK(ring.allocate(40U) == 0U);
+		DLPH_CHECK(ring.used() == 100U);
+		DLPH_CHECK(ring.allocate(1U) == RANGE_INVALID);
+		ring.end(0U);
+
+		ring.begin(1U);
+		DLPH_CHECK(ring.used() == 60U);
+		DLPH_CHECK(ring.allocate(40U) == 40U);
+		DLPH_CHECK(ring.allocate(1U) == RANGE_INVALID);
+		ring.end(1U);
+
+		//	空にすれば、末尾から折り返す位置でも容量いっぱいを取れる
+		ring.release();
+		DLPH_CHECK(ring.used() == 0U);
+		DLPH_CHECK(ring.allocate(100U) == 0U);
+		ring.exit();
+		DLPH_CHECK(ring.capacity() == 0U);
+	}
+
+	//!	@brief	区間アロケータの確保と解放、区間リングのフレームごとの確保の計測
+	void bench() noexcept {
+		unsigned int constexpr OP_CNT = 1000000U;
+		RangeAllocator ranges;
+		ranges.init(1U << 20U);
+		std::vector<std::pair<unsigned int, unsigned int>> live;
+		live.reserve(OP_CNT);
+		std::mt19937 rng(11U);
+		size_t worstFragments = 0U;
+		double const allocatorTime = test::measure(1U, [&]() noexcept {
+			for (unsigned int op = 0U; op < OP_CNT; ++op) {
+				if (live.size() < 2048U && (live.empty() || rng() % 2U == 0U)) {
+					unsigned int const count = 1U + rng() % 256U;
+					unsigned int const offset = ranges.allocate(count);
+					if (offset != RANGE_INVALID) {
+						live.emplace_back(offset, count);
+					}
+				}
+				else {
+					size_t const pick = rng() % live.size();
+					ranges.release(live[pick].first, live[pick].second);
+					live[pick] = live.back();
+					live.pop_back();
+				}
+				if ((op & 1023U) == 0U) {
+					worstFragments = std::max(worstFragments, ranges.fragments());
+				}
+			}
+		});
+
+		unsigned int constexpr FRAME_CNT = 10000U;
+		unsigned int constexpr FRAME_ALLOC_CNT = 256U;
+		RangeRing ring;
+		ring.init(1U << 16U);
+		unsigned int failed = 0U;
+		double const ringTime = test::measure(1U, [&]() noexcept {
+			for (unsigned int frame = 0U; frame < FRAME_CNT; ++frame) {
+				unsigned int const slot = frame % FRAME_LATENCY_MAX;
+				ring.begin(slot);
+				for (unsigned int idx = 0U; idx < FRAME_ALLOC_CNT; ++idx) {
+					failed += ring.allocate(1U + (frame + idx) % 64U) == RANGE_INVALID ? 1U : 0U;
+				}
+				ring.end(slot);
+			}
+		});
+		DLPH_CHECK(failed == 0U);
+
+		std::printf("range : allocator %.1f M ops/s (worst %zu fragments), ring %.1f M allocs/s\n",
+			OP_CNT / allocatorTime / 1000.0, worstFragments,
+			FRAME_CNT * FRAME_ALLOC_CNT / ringTime / 1000.0);
+	}
+}
+
+int main() {
+	allocator();
+	shuffled();
+	ring();
+	bench();
+	return dlph::test::finish("range_test");
+}
@@ -0,0 +1,262 @@
+﻿/**	@file	raster_test.cpp
+ *	@brief	CPU で動くラスタライザのテストとベンチマーク
+ */
+#include "test.hpp"
+#include "dlph/dlph_soft_raster.hpp"
+#include "util/hash.hpp"
+#include <atomic>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+	using namespace dlph;
+
+	//!	@brief	立方体の画像の正解 (三角形の番号で塗った色のハッシュ)
+	static unsigned long long constexpr CUBE_GOLDEN = 0x48E4F83905EEB86CULL;
+	//!	@brief	床の画像の正解 (三角形の番号で塗った色のハッシュ)
+	static unsigned long long constexpr FLOOR_GOLDEN = 0x80F82B594A5563A5ULL;
+
+	//!	@brief	左手系の透視投影行列
+	FMatrix4x4 const perspective(float const& fovy, float const& aspect, float const& zn, float const& zf) noexcept {
+		float const ys = 1.0f / std::tan(fovy * 0.5f);
+		float const q = zf / (zf - zn);
+		return FMatrix4x4({ ys / aspect, 0.0f, 0.0f, 0.0f, 0.0f, ys, 0.0f, 0.0f, 0.0f, 0.0f, q, 1.0f, 0.0f, 0.0f, -zn * q, 0.0f });
+	}
+
+	//!	@brief	単位行列
+	FMatrix4x4 const identity() noexcept {
+		return FMatrix4x4({ 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f });
+	}
+
+	//!	@brief	三角形の番号で塗るシェーディング (補間した値を使わないため、画像は被覆と深度テストだけで決まります)
+	unsigned int const primitiveColor(RasterFragment const& fragment) noexcept {
+		return 0xFF000000U | ((fragment.primitive + 1U) * 2654435761U & 0x00FFFFFFU);
+	}
+
+	//!	@brief	色のハッシュ
+	unsigned long long const colorHash(SoftRasterizer const& raster) noexcept {
+		return hash_bytes(raster.color(), sizeof(unsigned int) * raster.width() * raster.height());
+	}
+
+	/**	@brief	格子の頂点をずらした網
+	 *	@param[in] grid 一辺の分割数
+	 *	@param[in] extent 網の半分の大きさ (NDC)
+	 *	@param[in] seed 乱数の種
+	 */
+	std::vector<FVector4> const jitteredGrid(unsigned int const& grid, float const& extent, unsigned int const& seed) noexcept {
+		std::mt19937 rng(seed);
+		std::uniform_real_distribution<float> jitter(-0.3f, 0.3f);
+		float const cell = extent * 2.0f / grid;
+		std::vector<FVector4> vertices;
+		for (unsigned int y = 0U; y <= grid; ++y) {
+			for (unsigned int x = 0U; x <= grid; ++x) {
+				float const fx = -extent + cell * x + (x > 0U && x < grid ? jitter(rng) * cell : 0.0f);
+				float const fy = -extent + cell * y + (y > 0U && y < grid ? jitter(rng) * cell : 0.0f);
+				vertices.emplace_back(fx, fy, 0.5f, 1.0f);
+			}
+		}
+		return vertices;
+	}
+
+	//!	@brief	隙間なく並べた三角形が全てのピクセルをちょうど一度ずつ覆うかどうか (左上規則)
+	void coverage() noexcept {
+		unsigned int constexpr WIDTH = 333U;
+		unsigned int constexpr HEIGHT = 217U;
+		unsigned int constexpr GRID = 40U;
+		SoftRasterizer raster;
+		DLPH_CHECK(raster.init(WIDTH, HEIGHT));
+
+		//	巻き方向を混ぜ、画面外まで広げた網を深度の変わらない一回の描画で塗る
+		std::vector<FVector4> const vertices = jitteredGrid(GRID, 1.2f, 3U);
+		std::vector<unsigned int> indices;
+		for (unsigned int y = 0U; y < GRID; ++y) {
+			for (unsigned int x = 0U; x < GRID; ++x) {
+				unsigned int const a = y * (GRID + 1U) + x;
+				unsigned int const b = a + 1U;
+				unsigned int const c = a + GRID + 1U;
+				unsigned int const d = c + 1U;
+				if ((x + y) % 2U != 0U) {
+					indices.insert(indices.end(), { a, b, c, b, d, c });
+				}
+				else {
+					indices.insert(indices.end(), { a, d, c, a, b, d });
+				}
+			}
+		}
+		std::vector<std::atomic<unsigned int>> counts(WIDTH * HEIGHT);
+		for (std::atomic<unsigned int>& count : counts) {
+			count = 0U;
+		}
+		DLPH_CHECK(raster.drawShaded(vertices.data(), vertices.size(), indices.data(), indices.size(), identity(), RasterCull::None,
+			[&counts](RasterFragment const& fragment) noexcept {
+				++counts[fragment.y * WIDTH + fragment.x];
+				return 0xFFFFFFFFU;
+			}));
+		raster.flush();
+		unsigned int bad = 0U;
+		for (std::atomic<unsigned int> const& count : counts) {
+			bad += count != 1U ? 1U : 0U;
+		}
+		DLPH_CHECK(bad == 0U);
+		DLPH_CHECK(raster.stats().fragments == WIDTH * HEIGHT);
+
+		//	三角形ごとに手前へずらすと、後の三角形が辺を共有しても重ねて塗らない
+		unsigned int constexpr EDGE_GRID = 17U;
+		SoftRasterizer edge;
+		DLPH_CHECK(edge.init(200U, 150U));
+		std::vector<FVector4> const grid = jitteredGrid(EDGE_GRID, 1.0f, 5U);
+		std::vector<FVector4> triangles;
+		float z = 0.99f;
+		for (unsigned int y = 0U; y < EDGE_GRID; ++y) {
+			for (unsigned int x = 0U; x < EDGE_GRID; ++x) {
+				unsigned int const a = y * (EDGE_GRID + 1U) + x;
+				unsigned int const quad[6] = { a, a + 1U, a + EDGE_GRID + 1U, a + 1U, a + EDGE_GRID + 2U, a + EDGE_GRID + 1U };
+				for (unsigned int idx = 0U; idx < 6U; ++idx) {
+					triangles.emplace_back(grid[quad[idx]].x, grid[quad[idx]].y, idx < 3U ? z : z - 0.001f, 1.0f);
+				}
+				z -= 0.002f;
+			}
+		}
+		std::vector<unsigned int> edgeCounts(200U * 150U, 0U);
+		edge.drawShaded(triangles.data(), triangles.size(), nullptr, 0U, identity(), RasterCull::None,
+			[&edgeCounts](RasterFragment const& fragment) noexcept {
+				++edgeCounts[fragment.y * 200U + fragment.x];
+				return 0xFFFFFFFFU;
+			});
+		edge.flush();
+		bad = 0U;
+		for (unsigned int const& count : edgeCounts) {
+			bad += count != 1U ? 1U : 0U;
+		}
+		DLPH_CHECK(bad == 0U);
+	}
+
+	//!	@brief	近平面をまたぐ立方体と床の深度、クリッピング、正解画像との照合
+	void golden() noexcept {
+		unsigned int constexpr WIDTH = 640U;
+		unsigned int constexpr HEIGHT = 360U;
+		auto const shade = [](RasterFragment const& fragment) noexcept {
+			return primitiveColor(fragment);
+		};
+		SoftRasterizer cube;
+		DLPH_CHECK(cube.init(WIDTH, HEIGHT));
+		FVector4 corners[8];
+		for (unsigned int idx = 0U; idx < 8U; ++idx) {
+			corners[idx] = FVector4(idx & 1U ? 1.0f : -1.0f, idx & 2U ? 1.0f : -1.0f, (idx & 4U ? 1.0f : -1.0f) + 2.2f, 1.0f);
+		}
+		unsigned int const faces[36] = { 0, 2, 1, 1, 2, 3, 4, 5, 6, 5, 7, 6, 0, 1, 4, 1, 5, 4, 2, 6, 3, 3, 6, 7, 0, 4, 2, 2, 4, 6, 1, 3, 5, 3, 7, 5 };
+		cube.clear(1.0f, 0xFF402010U);
+		cube.drawShaded(corners, 8U, faces, 36U, perspective(1.2f, static_cast<float>(WIDTH) / HEIGHT, 0.5f, 50.0f), RasterCull::None, shade);
+		cube.flush();
+
+		//	中心に見える手前の面はビュー空間の z = 1.2 にある
+		float const q = 50.0f / 49.5f;
+		DLPH_CHECK(std::fabs(cube.depth(WIDTH / 2U, HEIGHT / 2U) - (q - 0.5f * q / 1.2f)) < 1.0e-4f);
+		std::printf("raster : cube golden %016llx\n", colorHash(cube));
+		DLPH_CHECK(colorHash(cube) == CUBE_GOLDEN);
+		DLPH_CHECK(cube.writeTGA("raster_test_cube.tga"));
+
+		//	カメラの下を通る床は近平面で二つ分割され、地平線より上は塗らない
+		SoftRasterizer floor;
+		DLPH_CHECK(floor.init(320U, 200U));
+		FVector4 const plane[4] = {
+			FVector4(-100.0f, -1.0f, -10.0f, 1.0f), FVector4(100.0f, -1.0f, -10.0f, 1.0f),
+			FVector4(-100.0f, -1.0f, 100.0f, 1.0f), FVector4(100.0f, -1.0f, 100.0f, 1.0f),
+		};
+		unsigned int const quad[6] = { 0, 2, 1, 1, 2, 3 };
+		floor.drawShaded(plane, 4U, quad, 6U, perspective(1.2f, 1.6f, 0.5f, 200.0f), RasterCull::None, shade);
+		floor.flush();
+		unsigned int const* const color = floor.color();
+		DLPH_CHECK(floor.stats().clipped == 2U);
+		DLPH_CHECK(color[199U * 320U + 160U] != 0xFF000000U);
+		DLPH_CHECK(color[160U] == 0xFF000000U);
+		DLPH_CHECK(color[97U * 320U + 160U] == 0xFF000000U);
+		std::printf("raster : floor golden %016llx\n", colorHash(floor));
+		DLPH_CHECK(colorHash(floor) == FLOOR_GOLDEN);
+	}
+
+	//!	@brief	深度のみのモードでの遮蔽判定
+	void occlusion() noexcept {
+		SoftRasterizer raster;
+		DLPH_CHECK(raster.init(256U, 128U, RasterMode::DepthOnly));
+		DLPH_CHECK(raster.color() == nullptr);
+		FMatrix4x4 const projection = perspective(1.2f, 2.0f, 0.5f, 100.0f);
+		FVector4 const wall[4] = {
+			FVector4(-3.0f, -2.0f, 10.0f, 1.0f), FVector4(3.0f, -2.0f, 10.0f, 1.0f),
+			FVector4(-3.0f, 2.0f, 10.0f, 1.0f), FVector4(3.0f, 2.0f, 10.0f, 1.0f),
+		};
+		unsigned int const quad[6] = { 0, 2, 1, 1, 2, 3 };
+		raster.draw(wall, 4U, quad, 6U, projection, RasterCull::Back);
+		raster.flush();
+
+		DLPH_CHECK(!raster.testBox(FVector4(-1.0f, -1.0f, 20.0f, 1.0f), FVector4(1.0f, 1.0f, 22.0f, 1.0f), projection));
+		DLPH_CHECK(raster.testBox(FVector4(-1.0f, -1.0f, 5.0f, 1.0f), FVector4(1.0f, 1.0f, 6.0f, 1.0f), projection));
+		DLPH_CHECK(raster.testBox(FVector4(2.0f, -1.0f, 20.0f, 1.0f), FVector4(8.0f, 1.0f, 22.0f, 1.0f), projection));
+		DLPH_CHECK(!raster.testBox(FVector4(200.0f, -1.0f, 20.0f, 1.0f), FVector4(208.0f, 1.0f, 22.0f, 1.0f), projection));
+		DLPH_CHECK(raster.testBox(FVector4(-1.0f, -1.0f, -1.0f, 1.0f), FVector4(1.0f, 1.0f, 1.0f, 1.0f), projection));
+	}
+
+	//!	@brief	1080p で 200k 個の三角形を描く時間と、遮蔽判定の時間の計測
+	void bench() noexcept {
+		unsigned int constexpr TRIANGLE_CNT = 200000U;
+		std::mt19937 rng(9U);
+		std::uniform_real_distribution<float> position(-1.0f, 1.0f);
+		std::uniform_real_distribution<float> size(0.005f, 0.06f);
+		std::uniform_real_distribution<float> depth(0.1f, 0.9f);
+		std::vector<FVector4> vertices;
+		for (unsigned int idx = 0U; idx < TRIANGLE_CNT; ++idx) {
+			float const x = position(rng);
+			float const y = position(rng);
+			float const z = depth(rng);
+			float const k = size(rng);
+			vertices.emplace_back(x, y, z, 1.0f);
+			vertices.emplace_back(x + k, y + position(rng) * k, z, 1.0f);
+			vertices.emplace_back(x + position(rng) * k, y + k, z, 1.0f);
+		}
+
+		SoftRasterizer raster;
+		DLPH_CHECK(raster.init(1920U, 1080U));
+		auto const shade = [](RasterFragment const& fragment) noexcept {
+			return 0xFF000000U | static_cast<unsigned int>(fragment.depth * 255.0f) << 8U;
+		};
+		double setup = 0.0;
+		double const frame = test::measure(3U, [&]() noexcept {
+			raster.clear();
+			raster.resetStats();
+			setup += test::measure(1U, [&]() noexcept {
+				raster.drawShaded(vertices.data(), vertices.size(), nullptr, 0U, identity(), RasterCull::None, shade);
+			});
+			raster.flush();
+		});
+		RasterStats const stats = raster.stats();
+		std::printf("raster : 1080p %u triangles, setup %.1f ms, raster %.1f ms, %.0f%% of tiles skipped by depth\n",
+			TRIANGLE_CNT, setup / 3.0, frame - setup / 3.0, stats.hiz * 100.0 / stats.tiles);
+
+		SoftRasterizer occluder;
+		DLPH_CHECK(occluder.init(320U, 180U, RasterMode::DepthOnly));
+		double const draw = test::measure(3U, [&]() noexcept {
+			occluder.clear();
+			occluder.draw(vertices.data(), 30000U, nullptr, 0U, identity(), RasterCull::None);
+			occluder.flush();
+		});
+		unsigned int visible = 0U;
+		double const query = test::measure(3U, [&]() noexcept {
+			visible = 0U;
+			for (unsigned int idx = 0U; idx < 10000U; ++idx) {
+				float const x = (idx % 100U) * 3.2f;
+				float const y = (idx / 100U) * 1.8f;
+				visible += occluder.testRect(x, y, x + 4.0f, y + 4.0f, 0.5f) ? 1U : 0U;
+			}
+		});
+		std::printf("raster : 320x180 depth only, 10k occluders %.2f ms, 10k rect tests %.2f ms (%u visible)\n", draw, query, visible);
+	}
+}
+
+int main() {
+	coverage();
+	golden();
+	occlusion();
+	bench();
+	return dlph::test::finish("raster_test");
+}
@@ -0,0 +1,197 @@
+﻿/**	@file	ray_test.cpp
+ *	@brief	光線束と三角形 BVH のテストとベンチマーク
+ */
+#include "test.hpp"
+#include "gmtry/ftribvh.hpp"
+#include <bitset>
+#include <cfloat>
+#include <random>
+#include <vector>
+
+namespace {
+	using namespace dlph;
+
+	//!	@brief	起伏のある格子と空中に散らばった三角形の場面
+	struct Scene final {
+		std::vector<Float3> positions;
+		std::vector<unsigned int> indices;
+	};
+
+	//!	@brief	格子の一辺の分割数
+	static unsigned int constexpr GRID = 200U;
+
+	Scene const makeScene(std::mt19937& rng) noexcept {
+		Scene scene;
+		for (unsigned int y = 0U; y <= GRID; ++y) {
+			for (unsigned int x = 0U; x <= GRID; ++x) {
+				float const fx = x / static_cast<float>(GRID) * 20.0f - 10.0f;
+				float const fy = y / static_cast<float>(GRID) * 20.0f - 10.0f;
+				scene.positions.push_back(Float3(fx, sinf(fx) * cosf(fy) * 0.5f, fy));
+			}
+		}
+		for (unsigned int y = 0U; y < GRID; ++y) {
+			for (unsigned int x = 0U; x < GRID; ++x) {
+				unsigned int const a = y * (GRID + 1U) + x, b = a + 1U, c = a + GRID + 1U, d = c + 1U;
+				scene.indices.insert(scene.indices.end(), { a, c, b, b, c, d });
+			}
+		}
+		std::uniform_real_distribution<float> random(-1.0f, 1.0f);
+		for (unsigned int idx = 0U; idx < 20000U; ++idx) {
+			Float3 const center(random(rng) * 8.0f, 1.5f + random(rng), random(rng) * 8.0f);
+			unsigned int const base = static_cast<unsigned int>(scene.positions.size());
+			for (unsigned int k = 0U; k < 3U; ++k) {
+				scene.positions.push_back(Float3(center.x + random(rng) * 0.3f, center.y + random(rng) * 0.3f, center.z + random(rng) * 0.3f));
+			}
+			scene.indices.insert(scene.indices.end(), { base, base + 1U, base + 2U });
+		}
+		return scene;
+	}
+
+	//!	@brief	全三角形との総当たりによる最近交差
+	unsigned int const bruteForce(Scene const& scene, FRay<FVector3> const& ray, float& distance) noexcept {
+		FRayPacket4 packet;
+		packet.set(0U, ray);
+		for (unsigned int tri = 0U; tri < scene.indices.size() / 3U; ++tri) {
+			packet.intersectWatertight(scene.positions[scene.indices[tri * 3U]], scene.positions[scene.indices[tri * 3U + 1U]],
+				scene.positions[scene.indices[tri * 3U + 2U]], tri, 1U);
+		}
+		distance = packet.distance(0U);
+		return packet.primitive(0U);
+	}
+
+	//!	@brief	光線束、光線列、遮蔽判定が総当たりと一致するかどうか
+	void correctness(Scene const& scene, FTriangleBvh const& bvh, std::mt19937& rng) noexcept {
+		std::uniform_real_distribution<float> random(-1.0f, 1.0f);
+		std::vector<FRay<FVector3>> rays;
+		for (unsigned int idx = 0U; idx < 256U; ++idx) {
+			FRay<FVector3> ray;
+			ray.center(FVector3(random(rng) * 10.0f, 5.0f + random(rng), random(rng) * 10.0f)).direction(FVector3(random(rng), -1.0f, random(rng)));
+			rays.push_back(ray);
+		}
+		std::vector<RayHit> hits(rays.size());
+		bvh.intersect(rays.data(), rays.size(), hits.data());
+		std::unique_ptr<bool[]> occluded(new bool[rays.size()]);
+		bvh.occluded(rays.data(), rays.size(), occluded.get());
+
+		unsigned int packetMiss = 0U, streamMiss = 0U, occludedMiss = 0U;
+		for (size_t base = 0U; base < rays.size(); base += 8U) {
+			FRayPacket8 packet;
+			for (unsigned int lane = 0U; lane < 8U; ++lane) {
+				packet.set(lane, rays[base + lane]);
+			}
+			bvh.intersect(packet);
+			for (unsigned int lane = 0U; lane < 8U; ++lane) {
+				float distance = FLT_MAX;
+				unsigned int const expect = bruteForce(scene, rays[base + lane], distance);
+				packetMiss += packet.primitive(lane) != expect ? 1U : 0U;
+				RayHit const& hit = hits[base + lane];
+				streamMiss += hit.primitive != expect || (expect != RAY_MISS && fabsf(hit.distance - distance) > 1.0e-4f) ? 1U : 0U;
+				occludedMiss += occluded[base + lane] != (expect != RAY_MISS) ? 1U : 0U;
+			}
+		}
+		DLPH_CHECK(packetMiss == 0U);
+		DLPH_CHECK(streamMiss == 0U);
+		DLPH_CHECK(occludedMiss == 0U);
+
+		//	格子の頂点をちょうど通る光線も水密判定ならすり抜けない
+		unsigned int leak = 0U;
+		for (unsigned int y = 1U; y < GRID; y += 7U) {
+			for (unsigned int x = 1U; x < GRID; x += 7U) {
+				Float3 const& v = scene.positions[y * (GRID + 1U) + x];
+				FRayPacket4 packet;
+				packet.set(0U, FVector3(v.x, 5.0f, v.z), FVector3(0.0f, -1.0f, 0.0f), 0.0f, FLT_MAX);
+				for (unsigned int tri = 0U; tri < GRID * GRID * 2U; ++tri) {
+					packet.intersectWatertight(scene.positions[scene.indices[tri * 3U]], scene.positions[scene.indices[tri * 3U + 1U]],
+						scene.positions[scene.indices[tri * 3U + 2U]], tri, 1U);
+				}
+				leak += packet.primitive(0U) == RAY_MISS ? 1U : 0U;
+			}
+		}
+		DLPH_CHECK(leak == 0U);
+	}
+
+	//!	@brief	一次光線 (揃った光線) とばらばらな光線の計測
+	void bench(FTriangleBvh const& bvh, std::mt19937& rng) noexcept {
+		unsigned int constexpr SIZE = 512U;
+		std::vector<FRay<FVector3>> primary;
+		for (unsigned int y = 0U; y < SIZE; ++y) {
+			for (unsigned int x = 0U; x < SIZE; ++x) {
+				float const px = (x + 0.5f) / SIZE * 2.0f - 1.0f, py = (y + 0.5f) / SIZE * 2.0f - 1.0f;
+				FRay<FVector3> ray;
+				ray.center(FVector3(0.0f, 4.0f, -12.0f)).direction(FVector3(px, -0.6f + py * 0.5f, 1.0f));
+				primary.push_back(ray);
+			}
+		}
+		std::vector<RayHit> hits(primary.size());
+		//	結果を使わないと光線束の処理が消えるため、当たった数を数えておく
+		size_t count4 = 0U, count8 = 0U, countScattered = 0U;
+		double const single = test::measure(1U, [&]() noexcept {
+			for (size_t idx = 0U; idx < primary.size(); ++idx) {
+				bvh.intersect(&primary[idx], 1U, &hits[idx]);
+			}
+		});
+		double const stream = test::measure(1U, [&]() noexcept { bvh.intersect(primary.data(), primary.size(), hits.data()); });
+		double const packet4 = test::measure(1U, [&]() noexcept {
+			for (unsigned int y = 0U; y < SIZE; y += 2U) {
+				for (unsigned int x = 0U; x < SIZE; x += 2U) {
+					FRayPacket4 packet;
+					for (unsigned int lane = 0U; lane < 4U; ++lane) {
+						packet.set(lane, primary[(y + lane / 2U) * SIZE + x + lane % 2U]);
+					}
+					count4 += std::bitset<4U>(bvh.intersect(packet)).count();
+				}
+			}
+		});
+		double const packet8 = test::measure(1U, [&]() noexcept {
+			for (unsigned int y = 0U; y < SIZE; y += 2U) {
+				for (unsigned int x = 0U; x < SIZE; x += 4U) {
+					FRayPacket8 packet;
+					for (unsigned int lane = 0U; lane < 8U; ++lane) {
+						packet.set(lane, primary[(y + lane / 4U) * SIZE + x + lane % 4U]);
+					}
+					count8 += std::bitset<8U>(bvh.intersect(packet)).count();
+				}
+			}
+		});
+		DLPH_CHECK(count4 == count8);
+		std::printf("ray : primary 512x512 single %.1f ms, stream %.1f ms, packet4 %.1f ms, packet8 %.1f ms (%zu hits)\n", single, stream, packet4, packet8, count8);
+
+		std::uniform_real_distribution<float> random(-1.0f, 1.0f);
+		std::vector<FRay<FVector3>> scattered;
+		for (size_t idx = 0U; idx < primary.size() / 4U; ++idx) {
+			FRay<FVector3> ray;
+			ray.center(FVector3(random(rng) * 8.0f, random(rng) + 1.0f, random(rng) * 8.0f)).direction(FVector3(random(rng), random(rng), random(rng)));
+			scattered.push_back(ray);
+		}
+		double const scatteredSingle = test::measure(1U, [&]() noexcept {
+			for (size_t idx = 0U; idx < scattered.size(); ++idx) {
+				bvh.intersect(&scattered[idx], 1U, &hits[idx]);
+			}
+		});
+		double const scatteredStream = test::measure(1U, [&]() noexcept { bvh.intersect(scattered.data(), scattered.size(), hits.data()); });
+		double const scatteredPacket = test::measure(1U, [&]() noexcept {
+			for (size_t base = 0U; base + 8U <= scattered.size(); base += 8U) {
+				FRayPacket8 packet;
+				for (unsigned int lane = 0U; lane < 8U; ++lane) {
+					packet.set(lane, scattered[base + lane]);
+				}
+				countScattered += std::bitset<8U>(bvh.intersect(packet)).count();
+			}
+		});
+		std::printf("ray : scattered 65536 single %.1f ms, stream %.1f ms, packet8 %.1f ms (%zu hits)\n", scatteredSingle, scatteredStream, scatteredPacket, countScattered);
+	}
+}
+
+int main() {
+	using namespace dlph;
+	std::mt19937 rng(1U);
+	Scene const scene = makeScene(rng);
+	FTriangleBvh bvh;
+	double const build = test::measure(1U, [&]() noexcept {
+		DLPH_CHECK(bvh.init(scene.positions.data(), scene.indices.data(), scene.indices.size()));
+	});
+	std::printf("ray : %zu triangles, %zu nodes, build %.1f ms\n", bvh.triangleCount(), bvh.nodes().size(), build);
+	correctness(scene, bvh, rng);
+	bench(bvh, rng);
+	return test::finish("ray_test");
+}
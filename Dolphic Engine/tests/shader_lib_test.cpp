@@ -0,0 +1,122 @@
+﻿/**	@file	shader_lib_test.cpp
+ *	@brief	シェーダライブラリのテストとベンチマーク
+ */
+#include "test.hpp"
+#include "dlph/dlph_shader_lib.hpp"
+#include "util/hash.hpp"
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+	using namespace dlph;
+
+	//!	@brief	シェーダの数
+	static unsigned int constexpr SHADER_CNT = 600U;
+	//!	@brief	内容の異なるシェーダの数 (残りは重複します)
+	static unsigned int constexpr UNIQUE_CNT = 400U;
+	//!	@brief	個別のファイルと書庫を置くディレクトリ (ctest の作業ディレクトリからの相対)
+	static char const* const WORK_DIR = "shader_lib_data";
+
+	//!	@brief	シェーダの名前
+	std::string const shaderName(unsigned int const& idx) noexcept {
+		char name[64];
+		std::snprintf(name, sizeof(name), "shaders/mat%03u_%s.cso", idx, idx % 2U ? "ps" : "vs");
+		return name;
+	}
+
+	//!	@brief	番号ごとに決まった内容のバイトコード (2 ～ 14 KB)
+	std::vector<unsigned char> const shaderCode(unsigned int const& unique) noexcept {
+		std::mt19937 rng(unique);
+		std::vector<unsigned char> code(2000U + rng() % 12000U);
+		for (unsigned char& byte : code) {
+			byte = static_cast<unsigned char>(rng());
+		}
+		return code;
+	}
+
+	//!	@brief	作成、重複の除去、名前とハッシュでの検索、壊れた索引の拒否
+	void roundTrip(std::vector<std::vector<unsigned char>> const& codes, std::string const& archive) noexcept {
+		ShaderLibraryBuilder builder;
+		for (unsigned int idx = 0U; idx < SHADER_CNT; ++idx) {
+			ShaderBinding const bindings[2] = {
+				{ ShaderBindingType::ConstantBuffer, 0U, 0U, 1U },
+				{ ShaderBindingType::ShaderResource, idx % UNIQUE_CNT, 1U, 1U },
+			};
+			std::vector<unsigned char> const& code = codes[idx];
+			DLPH_CHECK(builder.add(shaderName(idx).c_str(), idx % 2U ? ShaderStage::Pixel : ShaderStage::Vertex, code.data(), code.size(), bindings, 2U));
+		}
+		DLPH_CHECK(!builder.add(shaderName(0U).c_str(), ShaderStage::Vertex, "x", 1U));
+
+		ShaderLibraryStats const stats = builder.stats();
+		DLPH_CHECK(stats.entries == SHADER_CNT);
+		DLPH_CHECK(stats.blobs == UNIQUE_CNT);
+		std::printf("shader_lib : %u shaders (%u unique), %.1f MB in, %.1f MB stored\n",
+			stats.entries, stats.blobs, stats.inputBytes / 1.0e6, stats.uniqueBytes / 1.0e6);
+		DLPH_CHECK(builder.write(archive.c_str()));
+
+		ShaderLibrary library;
+		DLPH_CHECK(library.init(archive.c_str()));
+		unsigned int mismatch = 0U;
+		for (unsigned int idx = 0U; idx < SHADER_CNT; ++idx) {
+			std::vector<unsigned char> const& code = codes[idx];
+			ShaderView const view = library.find(shaderName(idx).c_str());
+			mismatch += view.data == nullptr || view.size != code.size() || std::memcmp(view.data, code.data(), view.size) != 0 ? 1U : 0U;
+			mismatch += view.bindingCount != 2U || view.bindings[1].reg != idx % UNIQUE_CNT ? 1U : 0U;
+			mismatch += library.find(hash_bytes(code.data(), code.size())).data != view.data ? 1U : 0U;
+		}
+		DLPH_CHECK(mismatch == 0U);
+		DLPH_CHECK(library.find("shaders/missing.cso").data == nullptr);
+		DLPH_CHECK(library.validate());
+
+		//	先頭の名前の索引が指すバイトコードの番号を範囲外にすると、開く時点で拒否する
+		std::vector<unsigned char> bytes;
+		builder.build(bytes);
+		bytes[80U + 16U] = 0xFFU;
+		bytes[80U + 17U] = 0xFFU;
+		ShaderLibrary broken;
+		DLPH_CHECK(!broken.init(bytes.data(), bytes.size()));
+	}
+
+	//!	@brief	個別のファイルを読む場合と、書庫を開いて全てのシェーダを探して触れる場合の計測
+	void bench(std::string const& archive) noexcept {
+		size_t touched = 0U;
+		double const files = test::measure(1U, [&]() noexcept {
+			for (unsigned int idx = 0U; idx < SHADER_CNT; ++idx) {
+				std::ifstream file(std::string(WORK_DIR) + "/" + shaderName(idx), std::ios::binary | std::ios::ate);
+				std::vector<char> data(static_cast<size_t>(file.tellg()));
+				file.seekg(0);
+				file.read(data.data(), static_cast<std::streamsize>(data.size()));
+				touched += static_cast<unsigned char>(data[0]) + data.size();
+			}
+		});
+		double const mapped = test::measure(1U, [&]() noexcept {
+			ShaderLibrary library;
+			library.init(archive.c_str());
+			for (unsigned int idx = 0U; idx < SHADER_CNT; ++idx) {
+				ShaderView const view = library.find(shaderName(idx).c_str());
+				touched += view.data[0] + view.size;
+			}
+		});
+		std::printf("shader_lib : %u files %.2f ms, archive %.2f ms (page cache warm, %zu)\n", SHADER_CNT, files, mapped, touched);
+	}
+}
+
+int main() {
+	using namespace dlph;
+	std::filesystem::create_directories(std::string(WORK_DIR) + "/shaders");
+	std::vector<std::vector<unsigned char>> codes;
+	for (unsigned int idx = 0U; idx < SHADER_CNT; ++idx) {
+		codes.push_back(shaderCode(idx % UNIQUE_CNT));
+		std::vector<unsigned char> const& code = codes.back();
+		std::ofstream(std::string(WORK_DIR) + "/" + shaderName(idx), std::ios::binary)
+			.write(reinterpret_cast<char const*>(code.data()), static_cast<std::streamsize>(code.size()));
+	}
+	std::string const archive = std::string(WORK_DIR) + "/shaders.dlsl";
+
+	roundTrip(codes, archive);
+	bench(archive);
+	return test::finish("shader_lib_test");
+}
@@ -0,0 +1,139 @@
+﻿/**	@file	state_filter_test.cpp
+ *	@brief	重複した状態設定を取り除く描画バックエンドのテスト
+ */
+#include "test.hpp"
+#include "dlph/dlph_state_filter.hpp"
+#include "dlph/dlph_headless.hpp"
+
+namespace {
+	using namespace dlph;
+
+	//!	@brief	種類ごとの取り除いたコマンド数
+	unsigned long long const eliminated(RenderStateFilter const& filter, RenderCommandType const& type) noexcept {
+		return filter.stats().eliminated[static_cast<unsigned int>(type)];
+	}
+
+	//!	@brief	受け取ったコマンド数の合計
+	unsigned long long const received(RenderStateFilter const& filter) noexcept {
+		unsigned long long result = 0U;
+		for (unsigned long long const& count : filter.stats().received) {
+			result += count;
+		}
+		return result;
+	}
+
+	//!	@brief	転送したコマンド数の合計
+	unsigned long long const forwarded(HeadlessBackend const& backend) noexcept {
+		unsigned long long result = 0U;
+		for (unsigned long long const& count : backend.stats().commands) {
+			result += count;
+		}
+		return result;
+	}
+
+	//!	@brief	決まった列から取り除かれる設定の数と種類、パイプラインの変更と invalidate で忘れる状態
+	void sequence() noexcept {
+		RenderPipeline const pipeline1 = RenderPipeline::make(1U, 1U);
+		RenderPipeline const pipeline2 = RenderPipeline::make(2U, 1U);
+		RenderResource const buffer = RenderResource::make(10U, 1U);
+		RenderResource const texture = RenderResource::make(20U, 1U);
+
+		RenderCommandStream stream;
+		DLPH_CHECK(stream.init(1U << 12U));
+		//	一つ目の描画は全て新しい設定
+		stream.setPipeline(pipeline1);
+		stream.bindVertexBuffer(0U, buffer, 32U);
+		stream.bindIndexBuffer(buffer);
+		stream.bindConstants(0U, 256U);
+		stream.bindResource(1U, texture);
+		stream.drawIndexed(36U);
+		//	二つ目の描画は一つ目と同じ設定を積み直す (5 個取り除く)
+		stream.setPipeline(pipeline1);
+		stream.bindVertexBuffer(0U, buffer, 32U);
+		stream.bindIndexBuffer(buffer);
+		stream.bindConstants(0U, 256U);
+		stream.bindResource(1U, texture);
+		stream.drawIndexed(36U);
+		//	定数の位置、頂点の大きさ、インデックスの形式が変われば残す
+		stream.bindConstants(0U, 512U);
+		stream.bindVertexBuffer(0U, buffer, 16U);
+		stream.bindIndexBuffer(buffer, IndexFormat::UInt16);
+		stream.drawIndexed(36U);
+		//	パイプラインが変わるとルートパラメータは設定し直すが、頂点とインデックスのバッファは残る (2 個取り除く)
+		stream.setPipeline(pipeline2);
+		stream.bindConstants(0U, 512U);
+		stream.bindResource(1U, texture);
+		stream.bindVertexBuffer(0U, buffer, 16U);
+		stream.bindIndexBuffer(buffer, IndexFormat::UInt16);
+		//	同じルートでも定数とリソースは別の設定として扱い、状態遷移とコピーは取り除かない
+		stream.bindResource(0U, RenderResource::make(512U, 0U));
+		stream.barrier(texture, ResourceState::ShaderResource, ResourceState::UnorderedAccess);
+		stream.barrier(texture, ResourceState::UnorderedAccess, ResourceState::UnorderedAccess, BarrierKind::UnorderedAccess);
+		stream.barrier(texture, ResourceState::UnorderedAccess, ResourceState::UnorderedAccess, BarrierKind::UnorderedAccess);
+		stream.copy(buffer, 0U, RenderResource::make(11U, 1U), 0U, 64U);
+		stream.copy(buffer, 0U, RenderResource::make(11U, 1U), 0U, 64U);
+		stream.drawIndexed(36U);
+
+		HeadlessBackend backend;
+		RenderStateFilter filter(backend);
+		stream.submit(filter);
+		DLPH_CHECK(filter.eliminated() == 7U);
+		DLPH_CHECK(eliminated(filter, RenderCommandType::SetPipeline) == 1U);
+		DLPH_CHECK(eliminated(filter, RenderCommandType::BindVertexBuffer) == 2U);
+		DLPH_CHECK(eliminated(filter, RenderCommandType::BindIndexBuffer) == 2U);
+		DLPH_CHECK(eliminated(filter, RenderCommandType::BindConstants) == 1U);
+		DLPH_CHECK(eliminated(filter, RenderCommandType::BindResource) == 1U);
+		DLPH_CHECK(eliminated(filter, RenderCommandType::DrawIndexed) == 0U);
+		DLPH_CHECK(eliminated(filter, RenderCommandType::Barrier) == 0U && eliminated(filter, RenderCommandType::Copy) == 0U);
+		DLPH_CHECK(received(filter) == stream.size());
+		DLPH_CHECK(forwarded(backend) == stream.size() - 7U);
+		DLPH_CHECK(backend.valid() && backend.stats().draws == 4U);
+
+		//	invalidate の後は同じ設定も転送し直すが、集計は残る
+		filter.invalidate();
+		backend.reset();
+		stream.submit(filter);
+		DLPH_CHECK(filter.eliminated() == 14U);
+		filter.reset();
+		DLPH_CHECK(filter.eliminated() == 0U && received(filter) == 0U);
+	}
+
+	/**	@brief	二つのマテリアルを交互に描く列を並べ替えずに、または並べ替えて再生したときに取り除かれる数
+	 *	@param[in] sorted 並べ替えるかどうか
+	 */
+	unsigned long long const interleaved(bool const& sorted) noexcept {
+		RenderCommandStream stream;
+		stream.init(1U << 12U);
+		for (unsigned int idx = 0U; idx < 4U; ++idx) {
+			unsigned int const material = idx % 2U;
+			stream.setKey(SortKey::make(0U, 0U, 1U, material, idx));
+			stream.setPipeline(RenderPipeline::make(1U, 1U));
+			stream.bindIndexBuffer(RenderResource::make(10U, 1U));
+			stream.bindResource(1U, RenderResource::make(20U + material, 1U));
+			stream.bindConstants(0U, (idx + 1U) * 256ULL);
+			stream.drawIndexed(36U);
+		}
+		if (sorted) {
+			stream.sort();
+		}
+		HeadlessBackend backend;
+		RenderStateFilter filter(backend);
+		stream.submit(filter);
+		DLPH_CHECK(backend.valid() && backend.stats().draws == 4U);
+		return filter.eliminated();
+	}
+
+	//!	@brief	並べ替えて同じマテリアルが隣り合えば、リソースの設定も取り除かれるかどうか
+	void sorting() noexcept {
+		//	並べ替えなければパイプラインとインデックスバッファの 3 回ずつだけ
+		DLPH_CHECK(interleaved(false) == 6U);
+		//	並べ替えると A A B B になり、同じマテリアルの二つ目でリソースの設定も消える
+		DLPH_CHECK(interleaved(true) == 8U);
+	}
+}
+
+int main() {
+	sequence();
+	sorting();
+	return dlph::test::finish("state_filter_test");
+}
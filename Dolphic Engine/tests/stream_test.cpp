@@ -0,0 +1,265 @@
+﻿/**	@file	stream_test.cpp
+ *	@brief	リソースの非同期転送のテストとベンチマーク
+ */
+#include "test.hpp"
+#include "dlph/dlph_transfer_sim.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+	using namespace dlph;
+
+	/**	@struct	Source
+	 *	@brief	読み込み元
+	 */
+	struct Source final {
+		//!	@brief	元データ
+		std::vector<unsigned char> data;
+		//!	@brief	最初に読み込まれた順番 (-1 は未読)
+		int order;
+	};
+
+	//!	@brief	読み込まれた順番の採番
+	std::atomic<int> g_order(0);
+
+	//!	@brief	元データを写す読み込み関数
+	bool read(void* context, void* dst, unsigned long long const& offset, unsigned long long const& size) noexcept {
+		Source* const source = static_cast<Source*>(context);
+		if (source->order < 0) {
+			source->order = g_order++;
+		}
+		std::memcpy(dst, source->data.data() + offset, static_cast<size_t>(size));
+		return true;
+	}
+
+	//!	@brief	必ず失敗する読み込み関数
+	bool fail(void*, void*, unsigned long long const&, unsigned long long const&) noexcept {
+		return false;
+	}
+
+	//!	@brief	位置と種から決まる元データ
+	Source make(size_t const& size, unsigned int const& seed) noexcept {
+		Source source = { std::vector<unsigned char>(size), -1 };
+		for (size_t idx = 0U; idx < size; ++idx) {
+			source.data[idx] = static_cast<unsigned char>(idx * 31U + seed * 7U + (idx >> 8U));
+		}
+		return source;
+	}
+
+	//!	@brief	バッファへの転送要求
+	StreamRequest const buffer(RenderResource const& target, Source& source, unsigned long long const& offset, unsigned int const& priority = 0U) noexcept {
+		StreamRequest request = {};
+		request.target = target;
+		request.type = StreamTarget::Buffer;
+		request.priority = priority;
+		request.offset = offset;
+		request.size = source.data.size();
+		request.read = read;
+		request.context = &source;
+		return request;
+	}
+
+	//!	@brief	小さな一時領域を何周もしながら、バッファとテクスチャが行の間隔と位置の境界を守って書き込まれるかどうか
+	void integrity() noexcept {
+		SimulatedTransferEngine engine;
+		DLPH_CHECK(engine.init(1U << 20U, 0U, 0U, 256U, 512U));
+		ResourceStreamer streamer;
+		DLPH_CHECK(streamer.init(engine));
+
+		unsigned int constexpr ROW_SIZE = 300U * 4U;
+		unsigned int constexpr ROW_CNT = 200U;
+		std::vector<unsigned char> memory(10U << 20U);
+		std::vector<unsigned char> texture(ROW_SIZE * ROW_CNT * 3U);
+		RenderResource const bufferTarget = engine.registerTarget({ memory.data(), memory.size(), 0U, 0U });
+		RenderResource const textureTarget = engine.registerTarget({ texture.data(), texture.size(), ROW_SIZE, ROW_SIZE * ROW_CNT });
+		Source bufferSource = make(9U << 20U, 1U);
+		Source textureSource = make(ROW_SIZE * ROW_CNT, 2U);
+
+		StreamRequest textureRequest = {};
+		textureRequest.target = textureTarget;
+		textureRequest.type = StreamTarget::Texture;
+		textureRequest.subresource = 2U;
+		textureRequest.rowSize = ROW_SIZE;
+		textureRequest.rowCount = ROW_CNT;
+		textureRequest.read = read;
+		textureRequest.context = &textureSource;
+		StreamTicket const bufferTicket = streamer.request(buffer(bufferTarget, bufferSource, 12345U));
+		streamer.request(textureRequest);
+		DLPH_CHECK(streamer.status(bufferTicket) == StreamStatus::Queued);
+		streamer.flush();
+
+		StreamCompletion completions[8];
+		size_t const count = streamer.poll(completions, 8U);
+		DLPH_CHECK(count == 2U);
+		for (size_t idx = 0U; idx < count; ++idx) {
+			DLPH_CHECK(completions[idx].status == StreamStatus::Completed);
+		}
+		DLPH_CHECK(std::memcmp(memory.data() + 12345U, bufferSource.data.data(), bufferSource.data.size()) == 0);
+		DLPH_CHECK(std::memcmp(texture.data() + 2U * ROW_SIZE * ROW_CNT, textureSource.data.data(), textureSource.data.size()) == 0);
+		DLPH_CHECK(streamer.pending() == 0U);
+		DLPH_CHECK(streamer.status(bufferTicket) == StreamStatus::Invalid);
+	}
+
+	//!	@brief	優先度の高い順、同じ優先度なら要求順に読み込み、変更した優先度が効くかどうか
+	void priority() noexcept {
+		SimulatedTransferEngine engine;
+		DLPH_CHECK(engine.init(64U << 20U));
+		ResourceStreamer streamer;
+		DLPH_CHECK(streamer.init(engine));
+		std::vector<unsigned char> memory(1U << 20U);
+		RenderResource const target = engine.registerTarget({ memory.data(), memory.size(), 0U, 0U });
+
+		unsigned int const priorities[5] = { 1U, 5U, 3U, 9U, 5U };
+		Source sources[5];
+		StreamTicket tickets[5];
+		for (unsigned int idx = 0U; idx < 5U; ++idx) {
+			sources[idx] = make(1024U, idx);
+			tickets[idx] = streamer.request(buffer(target, sources[idx], idx * 1024U, priorities[idx]));
+		}
+		DLPH_CHECK(streamer.setPriority(tickets[0], 100U));
+
+		g_order = 0;
+		for (unsigned int idx = 0U; idx < 5U; ++idx) {
+			streamer.update(1024U);
+		}
+		streamer.flush();
+		DLPH_CHECK(sources[0].order == 0 && sources[3].order == 1 && sources[1].order == 2 && sources[4].order == 3 && sources[2].order == 4);
+	}
+
+	//!	@brief	待機中と転送中の取り消し、読み込みの失敗、不正な要求
+	void cancel() noexcept {
+		SimulatedTransferEngine engine;
+		DLPH_CHECK(engine.init(64U << 20U, 1ULL << 30U, 2000U));
+		ResourceStreamer streamer;
+		DLPH_CHECK(streamer.init(engine));
+		std::vector<unsigned char> memory(64U << 20U);
+		RenderResource const target = engine.registerTarget({ memory.data(), memory.size(), 0U, 0U });
+
+		Source large = make(20U << 20U, 3U);
+		Source small = make(4096U, 4U);
+		StreamRequest failing = buffer(target, small, 40U << 20U);
+		failing.read = fail;
+		StreamTicket const largeTicket = streamer.request(buffer(target, large, 0U));
+		StreamTicket const smallTicket = streamer.request(buffer(target, small, 32U << 20U));
+		streamer.request(failing);
+
+		DLPH_CHECK(streamer.cancel(smallTicket));
+		streamer.update(STREAM_CHUNK_SIZE);
+		DLPH_CHECK(streamer.status(largeTicket) == StreamStatus::Transferring);
+		DLPH_CHECK(streamer.cancel(largeTicket));
+		streamer.flush();
+
+		StreamCompletion completions[8];
+		size_t const count = streamer.poll(completions, 8U);
+		DLPH_CHECK(count == 3U);
+		unsigned int canceled = 0U;
+		unsigned int failed = 0U;
+		for (size_t idx = 0U; idx < count; ++idx) {
+			canceled += completions[idx].status == StreamStatus::Canceled ? 1U : 0U;
+			failed += completions[idx].status == StreamStatus::Failed ? 1U : 0U;
+		}
+		DLPH_CHECK(canceled == 2U && failed == 1U);
+		DLPH_CHECK(streamer.stats().copies <= 2U);
+
+		StreamRequest empty = buffer(target, small, 0U);
+		empty.size = 0U;
+		DLPH_CHECK(!streamer.request(empty));
+	}
+
+	//!	@brief	大量の要求を転送しながら、別スレッドで完了通知を受け取って中身を確かめる計測
+	void throughput() noexcept {
+		unsigned int constexpr REQUEST_CNT = 2000U;
+		SimulatedTransferEngine engine;
+		DLPH_CHECK(engine.init(32U << 20U, 0U, 0U, 256U, 512U));
+		ResourceStreamer streamer;
+		DLPH_CHECK(streamer.init(engine));
+
+		std::vector<Source> sources(REQUEST_CNT);
+		std::vector<std::vector<unsigned char>> memories(REQUEST_CNT);
+		std::vector<RenderResource> targets(REQUEST_CNT);
+		unsigned long long total = 0U;
+		for (unsigned int idx = 0U; idx < REQUEST_CNT; ++idx) {
+			size_t const size = 4096U + idx * 7919U % (256U << 10U);
+			sources[idx] = make(size, idx);
+			memories[idx].resize(size);
+			targets[idx] = engine.registerTarget({ memories[idx].data(), size, 0U, 0U });
+			total += size;
+		}
+
+		std::atomic<unsigned int> received(0U);
+		std::atomic<unsigned int> bad(0U);
+		double const elapsed = test::measure(1U, [&]() noexcept {
+			std::thread render([&]() noexcept {
+				StreamCompletion completions[64];
+				while (received < REQUEST_CNT) {
+					size_t const count = streamer.poll(completions, 64U);
+					for (size_t idx = 0U; idx < count; ++idx) {
+						Source const* const source = static_cast<Source const*>(completions[idx].context);
+						std::vector<unsigned char> const& memory = memories[static_cast<size_t>(source - sources.data())];
+						bad += completions[idx].status != StreamStatus::Completed || std::memcmp(memory.data(), source->data.data(), memory.size()) != 0 ? 1U : 0U;
+					}
+					received += static_cast<unsigned int>(count);
+					std::this_thread::yield();
+				}
+			});
+			for (unsigned int idx = 0U; idx < REQUEST_CNT; ++idx) {
+				streamer.request(buffer(targets[idx], sources[idx], 0U, idx % 4U));
+				if (idx % 50U == 0U) {
+					streamer.update();
+				}
+			}
+			while (streamer.pending() > 0U) {
+				if (streamer.update() == 0U) {
+					std::this_thread::yield();
+				}
+			}
+			render.join();
+		});
+		DLPH_CHECK(bad == 0U);
+		StreamStats const stats = streamer.stats();
+		std::printf("stream : %u requests, %.1f MB in %.1f ms (%.2f GB/s), %llu submits, %llu stalls\n",
+			REQUEST_CNT, total / 1048576.0, elapsed, total / elapsed / 1.0e6, stats.submits, stats.stalls);
+	}
+
+	//!	@brief	帯域を絞った転送の間、完了通知の取り出しが待たされないかどうかの計測
+	void bandwidth() noexcept {
+		SimulatedTransferEngine engine;
+		DLPH_CHECK(engine.init(16U << 20U, 2ULL << 30U, 100U));
+		ResourceStreamer streamer;
+		DLPH_CHECK(streamer.init(engine));
+		std::vector<unsigned char> memory(64U << 20U);
+		RenderResource const target = engine.registerTarget({ memory.data(), memory.size(), 0U, 0U });
+		Source source = make(64U << 20U, 9U);
+		streamer.request(buffer(target, source, 0U));
+
+		double worst = 0.0;
+		unsigned int ticks = 0U;
+		double const elapsed = test::measure(1U, [&]() noexcept {
+			StreamCompletion completions[4];
+			size_t count = 0U;
+			while (count == 0U) {
+				streamer.update();
+				worst = std::max(worst, test::measure(1U, [&]() noexcept {
+					count = streamer.poll(completions, 4U);
+				}));
+				++ticks;
+				std::this_thread::sleep_for(std::chrono::microseconds(500));
+			}
+		});
+		DLPH_CHECK(std::memcmp(memory.data(), source.data.data(), source.data.size()) == 0);
+		std::printf("stream : 64 MB through a 16 MB ring at 2 GB/s, %.1f ms over %u ticks, worst poll %.0f us, %llu stalls\n",
+			elapsed, ticks, worst * 1000.0, streamer.stats().stalls);
+	}
+}
+
+int main() {
+	integrity();
+	priority();
+	cancel();
+	throughput();
+	bandwidth();
+	return dlph::test::finish("stream_test");
+}
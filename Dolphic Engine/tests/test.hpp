@@ -0,0 +1,44 @@
+﻿/**	@file	test.hpp
+ *	@brief	テストとベンチマークの共通処理
+ */
+#pragma once
+#include <chrono>
+#include <cstdio>
+
+namespace dlph {
+	namespace test {
+		//!	@brief	失敗した検査の数
+		inline int& failures() noexcept {
+			static int count = 0;
+			return count;
+		}
+
+		//!	@brief	検査の結果を終了コードにする関数
+		inline int const finish(char const* const name) noexcept {
+			if (failures() > 0) {
+				std::printf("%s : %d CHECK(S) FAILED\n", name, failures());
+				return 1;
+			}
+			std::printf("%s : OK\n", name);
+			return 0;
+		}
+
+		/**	@brief	経過時間の計測関数
+		 *	@param[in] count 繰り返し回数
+		 *	@param[in] func 計測する関数
+		 *	@return 一回あたりのミリ秒
+		 */
+		template <typename F>
+		inline double const measure(unsigned int const& count, F const& func) noexcept {
+			auto const start = std::chrono::steady_clock::now();
+			for (unsigned int idx = 0U; idx < count; ++idx) {
+				func();
+			}
+			auto const end = std::chrono::steady_clock::now();
+			return std::chrono::duration<double, std::milli>(end - start).count() / count;
+		}
+	}
+}
+
+//!	@brief	検査 (失敗しても続けます)
+#define	DLPH_CHECK(expr)	do { if (!(expr)) { std::printf("FAILED : %s(%d) : %s\n", __FILE__, __LINE__, #expr); ++dlph::test::failures(); } } while (false)
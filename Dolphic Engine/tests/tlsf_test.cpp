@@ -0,0 +1,174 @@
+﻿/**	@file	tlsf_test.cpp
+ *	@brief	TLSF 区間確保器のテストとベンチマーク
+ */
+#include "test.hpp"
+#include "mem/tlsf_alloc.hpp"
+#include "mem/range_alloc.hpp"
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+	using namespace dlph;
+
+	//!	@brief	ヒープの大きさ (D3D12MemoryAllocator と同じ 64 MB)
+	static unsigned long long constexpr HEAP_SIZE = 64ULL << 20U;
+	//!	@brief	計測の操作数
+	static unsigned int constexpr OP_CNT = 1000000U;
+	//!	@brief	同時に生きている区間の上限
+	static size_t constexpr LIVE_MAX = 192U;
+
+	/**	@struct	Request
+	 *	@brief	確保要求
+	 */
+	struct Request final {
+		//!	@brief	大きさ
+		unsigned int size;
+		//!	@brief	先頭位置の境界
+		unsigned int alignment;
+	};
+
+	//!	@brief	頂点と添字のバッファを模した大きさと境界 (256 B ～ 1 MB、ときどき 64 KB 境界)
+	Request const request(std::mt19937& rng) noexcept {
+		unsigned int const scale = 8U + rng() % 13U;
+		unsigned int const size = (1U << scale) + rng() % (1U << scale);
+		unsigned int const alignment = rng() % 8U == 0U ? 65536U : 256U;
+		return { size, alignment };
+	}
+
+	//!	@brief	空き容量のうち、最大の空きブロックに入らない割合
+	double const fragmentation(unsigned long long const& free, unsigned long long const& largest) noexcept {
+		return free == 0U ? 0.0 : 1.0 - static_cast<double>(largest) / static_cast<double>(free);
+	}
+
+	//!	@brief	境界の守られ方、区間の重なり、全て返したときの結合
+	void integrity() noexcept {
+		TlsfAllocator tlsf;
+		DLPH_CHECK(!tlsf.init(0U));
+		DLPH_CHECK(tlsf.init(1U << 20U));
+		DLPH_CHECK(tlsf.allocate(0U) == TLSF_INVALID);
+		DLPH_CHECK(tlsf.allocate((1U << 20U) + 1U) == TLSF_INVALID);
+
+		std::vector<unsigned char> owned(1U << 20U, 0U);
+		std::vector<unsigned int> live;
+		std::mt19937 rng(3U);
+		unsigned int misaligned = 0U;
+		unsigned int overlap = 0U;
+		for (unsigned int step = 0U; step < 20000U; ++step) {
+			if (live.empty() || rng() % 3U != 0U) {
+				unsigned long long const size = 1U + rng() % 4096U;
+				unsigned long long const alignment = 1ULL << (rng() % 13U);
+				unsigned int const block = tlsf.allocate(size, alignment);
+				if (block == TLSF_INVALID) {
+					continue;
+				}
+				unsigned long long const offset = tlsf.offset(block);
+				misaligned += offset % alignment != 0U || tlsf.size(block) < size ? 1U : 0U;
+				for (unsigned long long idx = offset; idx < offset + tlsf.size(block); ++idx) {
+					overlap += owned[static_cast<size_t>(idx)]++ != 0U ? 1U : 0U;
+				}
+				live.push_back(block);
+			}
+			else {
+				size_t const pick = rng() % live.size();
+				unsigned int const block = live[pick];
+				live[pick] = live.back();
+				live.pop_back();
+				for (unsigned long long idx = tlsf.offset(block); idx < tlsf.offset(block) + tlsf.size(block); ++idx) {
+					--owned[static_cast<size_t>(idx)];
+				}
+				tlsf.release(block);
+			}
+		}
+		DLPH_CHECK(misaligned == 0U);
+		DLPH_CHECK(overlap == 0U);
+
+		for (unsigned int const& block : live) {
+			tlsf.release(block);
+		}
+		DLPH_CHECK(tlsf.used() == 0U && tlsf.fragments() == 1U && tlsf.largest() == 1U << 20U);
+	}
+
+	/**	@brief	確保と解放を混ぜた負荷を流す関数
+	 *	@param[in] name 表示名
+	 *	@param[in] alloc 確保関数 (Request を受け取り、区間の識別子と成否の組を返します)
+	 *	@param[in] release 解放関数
+	 *	@param[in] sample 断片化の率を返す関数
+	 */
+	template <typename Alloc, typename Release, typename Sample>
+	void workload(char const* const name, Alloc const& alloc, Release const& release, Sample const& sample) noexcept {
+		std::mt19937 rng(17U);
+		std::vector<unsigned long long> live;
+		live.reserve(LIVE_MAX);
+		unsigned int failed = 0U;
+		double fragSum = 0.0;
+		double fragWorst = 0.0;
+		unsigned int samples = 0U;
+		double const elapsed = test::measure(1U, [&]() noexcept {
+			for (unsigned int op = 0U; op < OP_CNT; ++op) {
+				if (live.size() < LIVE_MAX && (live.empty() || rng() % 2U == 0U)) {
+					std::pair<unsigned long long, bool> const result = alloc(request(rng));
+					if (result.second) {
+						live.push_back(result.first);
+					}
+					else {
+						++failed;
+					}
+				}
+				else {
+					size_t const pick = rng() % live.size();
+					release(live[pick]);
+					live[pick] = live.back();
+					live.pop_back();
+				}
+				if ((op & 4095U) == 0U) {
+					double const frag = sample();
+					fragSum += frag;
+					fragWorst = std::max(fragWorst, frag);
+					++samples;
+				}
+			}
+		});
+		for (unsigned long long const& id : live) {
+			release(id);
+		}
+		std::printf("tlsf : %-5s %.2f M ops/s, fragmentation mean %.1f %% worst %.1f %%, %u failed\n",
+			name, OP_CNT / elapsed / 1000.0, fragSum / samples * 100.0, fragWorst * 100.0, failed);
+	}
+
+	//!	@brief	同じ負荷を TLSF と RangeAllocator (大きさ順の最良適合) に流す計測
+	void bench() noexcept {
+		TlsfAllocator tlsf;
+		tlsf.init(HEAP_SIZE);
+		workload("tlsf", [&tlsf](Request const& req) noexcept {
+			unsigned int const block = tlsf.allocate(req.size, req.alignment);
+			return std::make_pair(static_cast<unsigned long long>(block), block != TLSF_INVALID);
+		}, [&tlsf](unsigned long long const& id) noexcept {
+			tlsf.release(static_cast<unsigned int>(id));
+		}, [&tlsf]() noexcept {
+			return fragmentation(tlsf.capacity() - tlsf.used(), tlsf.largest());
+		});
+		DLPH_CHECK(tlsf.used() == 0U && tlsf.fragments() == 1U);
+
+		//	RangeAllocator は境界を持たないため、境界の分だけ余計に取って位置を丸めた場合と同じ量を使います
+		RangeAllocator ranges;
+		ranges.init(static_cast<unsigned int>(HEAP_SIZE));
+		workload("range", [&ranges](Request const& req) noexcept {
+			unsigned int const count = req.size + req.alignment - 1U;
+			unsigned int const offset = ranges.allocate(count);
+			return std::make_pair(static_cast<unsigned long long>(offset) << 32U | count, offset != RANGE_INVALID);
+		}, [&ranges](unsigned long long const& id) noexcept {
+			ranges.release(static_cast<unsigned int>(id >> 32U), static_cast<unsigned int>(id));
+		}, [&ranges]() noexcept {
+			return fragmentation(ranges.capacity() - ranges.used(), ranges.largest());
+		});
+		DLPH_CHECK(ranges.used() == 0U && ranges.fragments() == 1U);
+	}
+}
+
+int main() {
+	integrity();
+	bench();
+	return dlph::test::finish("tlsf_test");
+}
@@ -0,0 +1,164 @@
+﻿/**	@file	tracker_test.cpp
+ *	@brief	リソースの状態追跡器のテストとベンチマーク
+ */
+#include "test.hpp"
+#include "dlph/dlph_state_tracker.hpp"
+#include "dlph/dlph_headless.hpp"
+#include <vector>
+
+namespace {
+	using namespace dlph;
+
+	//!	@brief	検証と計測で使うサブリソース数
+	static unsigned int constexpr SUB_CNT = 6U;
+
+	//!	@brief	発行待ちを取り出して返す関数
+	std::vector<StateTransition> const drain(ResourceStateTracker& tracker) noexcept {
+		std::vector<StateTransition> result;
+		tracker.flush([&result](StateTransition const& barrier) {
+			result.push_back(barrier);
+		});
+		return result;
+	}
+
+	//!	@brief	線形合同法による乱数 (ResourceState の 1 ～ 4 と SUBRESOURCE_ALL を含むサブリソース番号を作ります)
+	struct Random final {
+		unsigned int x;
+
+		void next() noexcept {
+			x = x * 1664525U + 1013904223U;
+		}
+		ResourceState const state() const noexcept {
+			return static_cast<ResourceState>((x >> 16U) % 4U + 1U);
+		}
+		unsigned int const subresource() const noexcept {
+			unsigned int const sub = (x >> 20U) % 8U;
+			return sub < SUB_CNT ? sub : SUBRESOURCE_ALL;
+		}
+	};
+
+	//!	@brief	状態の変わらない遷移の除去、統合、打ち消し、サブリソース単位の遷移
+	void merging() noexcept {
+		ResourceStateTracker tracker;
+		tracker.track(1U, ResourceState::Common);
+		tracker.track(2U, ResourceState::ShaderResource, 4U);
+
+		DLPH_CHECK(tracker.transition(1U, ResourceState::Common));
+		DLPH_CHECK(!tracker.pending());
+
+		tracker.transition(1U, ResourceState::CopyDest);
+		tracker.transition(1U, ResourceState::ShaderResource);
+		std::vector<StateTransition> barriers = drain(tracker);
+		DLPH_CHECK(barriers.size() == 1U);
+		DLPH_CHECK(barriers[0].before == ResourceState::Common && barriers[0].after == ResourceState::ShaderResource);
+
+		tracker.transition(1U, ResourceState::Common);
+		tracker.transition(1U, ResourceState::ShaderResource);
+		DLPH_CHECK(drain(tracker).empty());
+
+		//	一つだけ遷移したサブリソースがあると、全体の遷移は残りのサブリソースごとに分かれる
+		tracker.transition(2U, ResourceState::RenderTarget, 1U);
+		tracker.transition(2U, ResourceState::RenderTarget);
+		barriers = drain(tracker);
+		DLPH_CHECK(barriers.size() == 4U);
+		DLPH_CHECK(barriers[0].subresource == 1U);
+		DLPH_CHECK(tracker.state(2U) == ResourceState::RenderTarget);
+		for (unsigned int sub = 0U; sub < 4U; ++sub) {
+			DLPH_CHECK(tracker.state(2U, sub) == ResourceState::RenderTarget);
+		}
+
+		DLPH_CHECK(!tracker.transition(9U, ResourceState::Common));
+		DLPH_CHECK(!tracker.transition(2U, ResourceState::Common, 4U));
+
+		tracker.uav(1U);
+		tracker.uav(1U);
+		DLPH_CHECK(drain(tracker).size() == 1U);
+	}
+
+	//!	@brief	ばらばらな遷移を取り出したバリアが、影の状態と常に食い違わないかどうか
+	void shadow() noexcept {
+		unsigned int constexpr RESOURCE_CNT = 64U;
+		ResourceStateTracker tracker;
+		ResourceState states[RESOURCE_CNT][SUB_CNT];
+		for (unsigned int idx = 0U; idx < RESOURCE_CNT; ++idx) {
+			tracker.track(idx, ResourceState::Common, SUB_CNT);
+			for (ResourceState& state : states[idx]) {
+				state = ResourceState::Common;
+			}
+		}
+
+		Random random = { 7U };
+		unsigned int mismatch = 0U;
+		for (unsigned int frame = 0U; frame < 20000U; ++frame) {
+			for (unsigned int idx = 0U; idx < 50U; ++idx) {
+				random.next();
+				tracker.transition((random.x >> 8U) % RESOURCE_CNT, random.state(), random.subresource());
+			}
+			tracker.flush([&](StateTransition const& barrier) {
+				mismatch += barrier.before == barrier.after ? 1U : 0U;
+				for (unsigned int sub = 0U; sub < SUB_CNT; ++sub) {
+					if (barrier.subresource != SUBRESOURCE_ALL && barrier.subresource != sub) {
+						continue;
+					}
+					mismatch += states[barrier.resource][sub] != barrier.before ? 1U : 0U;
+					states[barrier.resource][sub] = barrier.after;
+				}
+			});
+			for (unsigned int idx = 0U; idx < RESOURCE_CNT; ++idx) {
+				for (unsigned int sub = 0U; sub < SUB_CNT; ++sub) {
+					mismatch += tracker.state(idx, sub) != states[idx][sub] ? 1U : 0U;
+				}
+			}
+		}
+		DLPH_CHECK(mismatch == 0U);
+	}
+
+	//!	@brief	サブリソース単位のバリアコマンドが HeadlessBackend まで届くかどうか
+	void stream() noexcept {
+		RenderCommandStream stream;
+		DLPH_CHECK(stream.init(1U << 12U));
+		RenderResource const texture = RenderResource::make(1U, 1U);
+		stream.barrier(texture, ResourceState::ShaderResource, ResourceState::RenderTarget, BarrierKind::Transition, 2U);
+		stream.barrier(texture, ResourceState::RenderTarget, ResourceState::ShaderResource, BarrierKind::Transition, 2U);
+		stream.barrier(texture, ResourceState::ShaderResource, ResourceState::CopySource);
+
+		HeadlessBackend backend;
+		stream.submit(backend);
+		DLPH_CHECK(backend.valid());
+
+		//	サブリソースごとに照合するため、二つ目は通り、遷移前の食い違う三つ目だけが誤りになる
+		stream.reset();
+		stream.barrier(texture, ResourceState::CopySource, ResourceState::RenderTarget, BarrierKind::Transition, 0U);
+		stream.barrier(texture, ResourceState::CopySource, ResourceState::CopyDest, BarrierKind::Transition, 1U);
+		stream.barrier(texture, ResourceState::CopySource, ResourceState::ShaderResource, BarrierKind::Transition, 0U);
+		stream.submit(backend);
+		DLPH_CHECK(backend.stats().errors == 1U);
+	}
+
+	//!	@brief	256 個のリソースへ一フレーム 2000 回の遷移を要求する計測
+	void bench() noexcept {
+		ResourceStateTracker tracker;
+		for (unsigned int idx = 0U; idx < 256U; ++idx) {
+			tracker.track(idx, ResourceState::Common, SUB_CNT);
+		}
+		Random random = { 1U };
+		double const frame = test::measure(1000U, [&]() noexcept {
+			for (unsigned int idx = 0U; idx < 2000U; ++idx) {
+				random.next();
+				tracker.transition((random.x >> 8U) & 255U, random.state(), random.subresource());
+			}
+			tracker.flush([](StateTransition const&) {});
+		});
+		StateTrackerStats const& stats = tracker.stats();
+		std::printf("tracker : %llu requests, %llu skipped, %llu merged, %llu cancelled, %llu emitted, %.1f ns/request\n",
+			stats.requested, stats.skipped, stats.merged, stats.cancelled, stats.emitted, frame * 1.0e6 / 2000.0);
+	}
+}
+
+int main() {
+	merging();
+	shadow();
+	stream();
+	bench();
+	return dlph::test::finish("tracker_test");
+}
@@ -0,0 +1,414 @@
+﻿/**	@file	vk_replay_test.cpp
+ *	@brief	描画コマンド列を Vulkan で再生するテスト (Vulkan のデバイスが無ければ飛ばします)
+ */
+#include "test.hpp"
+#include "vk/vk_rend.hpp"
+#include "vk/vk_device.hpp"
+#include "dlph/dlph_headless.hpp"
+#include <cstring>
+#include <vector>
+
+namespace {
+	using namespace dlph;
+
+	//!	@brief	描画先の一辺の大きさ
+	static unsigned int constexpr TARGET_SIZE = 64U;
+	//!	@brief	飛ばしたときの終了コード (ctest の SKIP_RETURN_CODE と合わせます)
+	static int constexpr SKIPPED = 77;
+	//!	@brief	定数の間隔 (Direct3D12 の定数バッファと同じ境界)
+	static unsigned long long constexpr CONSTANT_STRIDE = 256U;
+	//!	@brief	再生するフレーム数 (スワップチェインの画像と slot が一巡するように)
+	static unsigned int constexpr FRAME_CNT = 4U;
+
+	/**	@brief	頂点シェーダ
+	 *	@details	layout(location = 0) in vec2 position; gl_Position = vec4(position, 0.0, 1.0); を手で組み立てた SPIR-V です。
+	 */
+	static unsigned int constexpr VERTEX_SHADER[] = {
+		0x07230203U, 0x00010000U, 0x00000000U, 0x00000012U, 0x00000000U, 0x00020011U, 0x00000001U, 0x0003000EU,
+		0x00000000U, 0x00000001U, 0x0007000FU, 0x00000000U, 0x00000001U, 0x6E69616DU, 0x00000000U, 0x00000002U,
+		0x00000003U, 0x00040047U, 0x00000002U, 0x0000001EU, 0x00000000U, 0x00040047U, 0x00000003U, 0x0000000BU,
+		0x00000000U, 0x00020013U, 0x00000004U, 0x00030021U, 0x00000005U, 0x00000004U, 0x00030016U, 0x00000006U,
+		0x00000020U, 0x00040017U, 0x00000007U, 0x00000006U, 0x00000002U, 0x00040017U, 0x00000008U, 0x00000006U,
+		0x00000004U, 0x00040020U, 0x00000009U, 0x00000001U, 0x00000007U, 0x00040020U, 0x0000000AU, 0x00000003U,
+		0x00000008U, 0x0004003BU, 0x00000009U, 0x00000002U, 0x00000001U, 0x0004003BU, 0x0000000AU, 0x00000003U,
+		0x00000003U, 0x0004002BU, 0x00000006U, 0x0000000BU, 0x00000000U, 0x0004002BU, 0x00000006U, 0x0000000CU,
+		0x3F800000U, 0x00050036U, 0x00000004U, 0x00000001U, 0x00000000U, 0x00000005U, 0x000200F8U, 0x0000000DU,
+		0x0004003DU, 0x00000007U, 0x0000000EU, 0x00000002U, 0x00050051U, 0x00000006U, 0x0000000FU, 0x0000000EU,
+		0x00000000U, 0x00050051U, 0x00000006U, 0x00000010U, 0x0000000EU, 0x00000001U, 0x00070050U, 0x00000008U,
+		0x00000011U, 0x0000000FU, 0x00000010U, 0x0000000BU, 0x0000000CU, 0x0003003EU, 0x00000003U, 0x00000011U,
+		0x000100FDU, 0x00010038U,
+	};
+	/**	@brief	ピクセルシェーダ
+	 *	@details	layout(set = 0, binding = 0) uniform Block { vec4 color; }; を出力するだけの SPIR-V です。
+	 */
+	static unsigned int constexpr PIXEL_SHADER[] = {
+		0x07230203U, 0x00010000U, 0x00000000U, 0x00000011U, 0x00000000U, 0x00020011U, 0x00000001U, 0x0003000EU,
+		0x00000000U, 0x00000001U, 0x0006000FU, 0x00000004U, 0x00000001U, 0x6E69616DU, 0x00000000U, 0x00000002U,
+		0x00030010U, 0x00000001U, 0x00000007U, 0x00040047U, 0x00000002U, 0x0000001EU, 0x00000000U, 0x00030047U,
+		0x00000003U, 0x00000002U, 0x00050048U, 0x00000003U, 0x00000000U, 0x00000023U, 0x00000000U, 0x00040047U,
+		0x00000004U, 0x00000022U, 0x00000000U, 0x00040047U, 0x00000004U, 0x00000021U, 0x00000000U, 0x00020013U,
+		0x00000005U, 0x00030021U, 0x00000006U, 0x00000005U, 0x00030016U, 0x00000007U, 0x00000020U, 0x00040017U,
+		0x00000008U, 0x00000007U, 0x00000004U, 0x0003001EU, 0x00000003U, 0x00000008U, 0x00040020U, 0x00000009U,
+		0x00000002U, 0x00000003U, 0x00040020U, 0x0000000AU, 0x00000002U, 0x00000008U, 0x00040020U, 0x0000000BU,
+		0x00000003U, 0x00000008U, 0x00040015U, 0x0000000CU, 0x00000020U, 0x00000001U, 0x0004002BU, 0x0000000CU,
+		0x0000000DU, 0x00000000U, 0x0004003BU, 0x00000009U, 0x00000004U, 0x00000002U, 0x0004003BU, 0x0000000BU,
+		0x00000002U, 0x00000003U, 0x00050036U, 0x00000005U, 0x00000001U, 0x00000000U, 0x00000006U, 0x000200F8U,
+		0x0000000EU, 0x00050041U, 0x0000000AU, 0x0000000FU, 0x00000004U, 0x0000000DU, 0x0004003DU, 0x00000008U,
+		0x00000010U, 0x0000000FU, 0x0003003EU, 0x00000002U, 0x00000010U, 0x000100FDU, 0x00010038U,
+	};
+
+	/**	@brief	頂点 (上半分の左右の四角形)
+	 *	@details	先頭の 6 頂点は左をインデックス無しで、後ろの 4 頂点は右をインデックス付きで描きます。
+	 */
+	static float constexpr VERTICES[] = {
+		-1.0f, -1.0f, 0.0f, -1.0f, -1.0f, 0.0f,
+		-1.0f, 0.0f, 0.0f, -1.0f, 0.0f, 0.0f,
+		0.0f, -1.0f, 1.0f, -1.0f, 0.0f, 0.0f, 1.0f, 0.0f,
+	};
+	//!	@brief	インデックス (右の四角形)
+	static unsigned short constexpr INDICES[] = { 0U, 1U, 2U, 2U, 1U, 3U };
+	//!	@brief	背景色 (描かない下半分に残ります)
+	static unsigned int constexpr BLUE = 0xFFFF0000U;
+	//!	@brief	左の四角形の色
+	static unsigned int constexpr RED = 0xFF0000FFU;
+	//!	@brief	右の四角形の色
+	static unsigned int constexpr GREEN = 0xFF00FF00U;
+
+	/**	@struct	Scene
+	 *	@brief	テストで描くための Vulkan のオブジェクト一式
+	 */
+	struct Scene final {
+		//!	@brief	定数の記述子セットレイアウト
+		VkDescriptorSetLayout setLayout;
+		//!	@brief	パイプラインレイアウト
+		VkPipelineLayout layout;
+		//!	@brief	記述子プール
+		VkDescriptorPool pool;
+		//!	@brief	定数の記述子セット
+		VkDescriptorSet set;
+		//!	@brief	パイプライン
+		VkPipeline pipeline;
+		//!	@brief	定数バッファ
+		VkBuffer constants;
+		//!	@brief	転送元
+		VkBuffer staging;
+		//!	@brief	頂点バッファ
+		VkBuffer vertices;
+		//!	@brief	インデックスバッファ
+		VkBuffer indices;
+		//!	@brief	定数バッファのメモリ
+		VKAllocation constantMemory;
+		//!	@brief	転送元のメモリ
+		VKAllocation stagingMemory;
+		//!	@brief	頂点バッファのメモリ
+		VKAllocation vertexMemory;
+		//!	@brief	インデックスバッファのメモリ
+		VKAllocation indexMemory;
+	};
+
+	//!	@brief	シェーダモジュール生成関数
+	VkShaderModule create_module(unsigned int const* code, size_t const& bytes) noexcept {
+		VkShaderModuleCreateInfo info = {};
+		info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+		info.codeSize = bytes;
+		info.pCode = code;
+		VkShaderModule module = VK_NULL_HANDLE;
+		if (vkCreateShaderModule(VKDevice::getInstance().get(), &info, nullptr, &module) != VK_SUCCESS) {
+			return VK_NULL_HANDLE;
+		}
+		return module;
+	}
+
+	//!	@brief	パイプライン生成関数 (頂点は vec2、深度は使いません)
+	VkPipeline create_pipeline(VKRenderer const& renderer, VkPipelineLayout const& layout) noexcept {
+		VkDevice const device = VKDevice::getInstance().get();
+		VkShaderModule const vs = create_module(VERTEX_SHADER, sizeof(VERTEX_SHADER));
+		VkShaderModule const ps = create_module(PIXEL_SHADER, sizeof(PIXEL_SHADER));
+
+		VkPipelineShaderStageCreateInfo stages[2] = {};
+		stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+		stages[0].module = vs;
+		stages[0].pName = "main";
+		stages[1] = stages[0];
+		stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+		stages[1].module = ps;
+
+		VkVertexInputBindingDescription const binding = { 0U, sizeof(float) * 2U, VK_VERTEX_INPUT_RATE_VERTEX };
+		VkVertexInputAttributeDescription const attribute = { 0U, 0U, VK_FORMAT_R32G32_SFLOAT, 0U };
+		VkPipelineVertexInputStateCreateInfo input = {};
+		input.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+		input.vertexBindingDescriptionCount = 1U;
+		input.pVertexBindingDescriptions = &binding;
+		input.vertexAttributeDescriptionCount = 1U;
+		input.pVertexAttributeDescriptions = &attribute;
+
+		VkPipelineInputAssemblyStateCreateInfo assembly = {};
+		assembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+		assembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+		VkPipelineViewportStateCreateInfo viewport = {};
+		viewport.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+		viewport.viewportCount = 1U;
+		viewport.scissorCount = 1U;
+
+		VkPipelineRasterizationStateCreateInfo raster = {};
+		raster.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+		raster.polygonMode = VK_POLYGON_MODE_FILL;
+		raster.cullMode = VK_CULL_MODE_NONE;
+		raster.frontFace = VK_FRONT_FACE_CLOCKWISE;
+		raster.lineWidth = 1.0f;
+
+		VkPipelineMultisampleStateCreateInfo multisample = {};
+		multisample.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+		multisample.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+		VkPipelineDepthStencilStateCreateInfo depth = {};
+		depth.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+		depth.depthCompareOp = VK_COMPARE_OP_ALWAYS;
+
+		VkPipelineColorBlendAttachmentState attachment = {};
+		attachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+		VkPipelineColorBlendStateCreateInfo blend = {};
+		blend.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+		blend.attachmentCount = 1U;
+		blend.pAttachments = &attachment;
+
+		//	ビューポートとシザー矩形はレンダラがリストごとに設定する
+		VkDynamicState const states[] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+		VkPipelineDynamicStateCreateInfo dynamic = {};
+		dynamic.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+		dynamic.dynamicStateCount = 2U;
+		dynamic.pDynamicStates = states;
+
+		VkGraphicsPipelineCreateInfo info = {};
+		info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+		info.stageCount = 2U;
+		info.pStages = stages;
+		info.pVertexInputState = &input;
+		info.pInputAssemblyState = &assembly;
+		info.pViewportState = &viewport;
+		info.pRasterizationState = &raster;
+		info.pMultisampleState = &multisample;
+		info.pDepthStencilState = &depth;
+		info.pColorBlendState = &blend;
+		info.pDynamicState = &dynamic;
+		info.layout = layout;
+		info.renderPass = renderer.getRenderPass();
+
+		VkPipeline pipeline = VK_NULL_HANDLE;
+		if (vs == VK_NULL_HANDLE || ps == VK_NULL_HANDLE ||
+			vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1U, &info, nullptr, &pipeline) != VK_SUCCESS)
+		{
+			pipeline = VK_NULL_HANDLE;
+		}
+		if (vs != VK_NULL_HANDLE) {
+			vkDestroyShaderModule(device, vs, nullptr);
+		}
+		if (ps != VK_NULL_HANDLE) {
+			vkDestroyShaderModule(device, ps, nullptr);
+		}
+		return pipeline;
+	}
+
+	//!	@brief	描画に使うオブジェクトの生成関数
+	bool const createScene(VKRenderer const& renderer, Scene& scene) noexcept {
+		VkDevice const device = VKDevice::getInstance().get();
+		VKMemoryAllocator& allocator = VKMemoryAllocator::getInstance();
+
+		//	定数は動的オフセット付きの定数バッファとして binding 0 に置く (VKResourceTable::setConstants の約束)
+		VkDescriptorSetLayoutBinding binding = {};
+		binding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+		binding.descriptorCount = 1U;
+		binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+		VkDescriptorSetLayoutCreateInfo setInfo = {};
+		setInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		setInfo.bindingCount = 1U;
+		setInfo.pBindings = &binding;
+		if (vkCreateDescriptorSetLayout(device, &setInfo, nullptr, &scene.setLayout) != VK_SUCCESS) {
+			return false;
+		}
+
+		VkPipelineLayoutCreateInfo layoutInfo = {};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		layoutInfo.setLayoutCount = 1U;
+		layoutInfo.pSetLayouts = &scene.setLayout;
+		if (vkCreatePipelineLayout(device, &layoutInfo, nullptr, &scene.layout) != VK_SUCCESS) {
+			return false;
+		}
+
+		VkDescriptorPoolSize const size = { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1U };
+		VkDescriptorPoolCreateInfo poolInfo = {};
+		poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+		poolInfo.maxSets = 1U;
+		poolInfo.poolSizeCount = 1U;
+		poolInfo.pPoolSizes = &size;
+		if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &scene.pool) != VK_SUCCESS) {
+			return false;
+		}
+
+		VkDescriptorSetAllocateInfo allocInfo = {};
+		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocInfo.descriptorPool = scene.pool;
+		allocInfo.descriptorSetCount = 1U;
+		allocInfo.pSetLayouts = &scene.setLayout;
+		if (vkAllocateDescriptorSets(device, &allocInfo, &scene.set) != VK_SUCCESS) {
+			return false;
+		}
+
+		scene.pipeline = create_pipeline(renderer, scene.layout);
+		if (scene.pipeline == VK_NULL_HANDLE) {
+			return false;
+		}
+
+		if (!allocator.createBuffer(CONSTANT_STRIDE * 3U, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VKMemoryUsage::Upload, scene.constantMemory, scene.constants) ||
+			!allocator.createBuffer(sizeof(VERTICES) + sizeof(INDICES), VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VKMemoryUsage::Upload, scene.stagingMemory, scene.staging) ||
+			!allocator.createBuffer(sizeof(VERTICES), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VKMemoryUsage::Device, scene.vertexMemory, scene.vertices) ||
+			!allocator.createBuffer(sizeof(INDICES), VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VKMemoryUsage::Device, scene.indexMemory, scene.indices))
+		{
+			return false;
+		}
+
+		//	左右の色を境界ごとに置き、bindConstants のアドレスで選ぶ (0 は GPU アドレスとして無効なので先頭は空ける)
+		float const colors[2][4] = { { 1.0f, 0.0f, 0.0f, 1.0f }, { 0.0f, 1.0f, 0.0f, 1.0f } };
+		unsigned char* const constants = static_cast<unsigned char*>(scene.constantMemory.mapped);
+		std::memcpy(constants + CONSTANT_STRIDE, colors[0], sizeof(colors[0]));
+		std::memcpy(constants + CONSTANT_STRIDE * 2U, colors[1], sizeof(colors[1]));
+		unsigned char* const staging = static_cast<unsigned char*>(scene.stagingMemory.mapped);
+		std::memcpy(staging, VERTICES, sizeof(VERTICES));
+		std::memcpy(staging + sizeof(VERTICES), INDICES, sizeof(INDICES));
+
+		VkDescriptorBufferInfo buffer = {};
+		buffer.buffer = scene.constants;
+		buffer.range = sizeof(colors[0]);
+		VkWriteDescriptorSet write = {};
+		write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		write.dstSet = scene.set;
+		write.descriptorCount = 1U;
+		write.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+		write.pBufferInfo = &buffer;
+		vkUpdateDescriptorSets(device, 1U, &write, 0U, nullptr);
+
+		return true;
+	}
+
+	//!	@brief	描画に使うオブジェクトの破棄関数 (GPU の処理が終わってから呼ぶこと)
+	void destroyScene(Scene& scene) noexcept {
+		VkDevice const device = VKDevice::getInstance().get();
+		VKMemoryAllocator& allocator = VKMemoryAllocator::getInstance();
+		allocator.destroyBuffer(scene.indexMemory, scene.indices);
+		allocator.destroyBuffer(scene.vertexMemory, scene.vertices);
+		allocator.destroyBuffer(scene.stagingMemory, scene.staging);
+		allocator.destroyBuffer(scene.constantMemory, scene.constants);
+		if (scene.pipeline != VK_NULL_HANDLE) {
+			vkDestroyPipeline(device, scene.pipeline, nullptr);
+		}
+		if (scene.pool != VK_NULL_HANDLE) {
+			vkDestroyDescriptorPool(device, scene.pool, nullptr);
+		}
+		if (scene.layout != VK_NULL_HANDLE) {
+			vkDestroyPipelineLayout(device, scene.layout, nullptr);
+		}
+		if (scene.setLayout != VK_NULL_HANDLE) {
+			vkDestroyDescriptorSetLayout(device, scene.setLayout, nullptr);
+		}
+		scene = {};
+	}
+
+	//!	@brief	読み戻した色の取得関数 (RGBA を下位から詰めた値)
+	unsigned int const pixel(std::vector<unsigned char> const& image, unsigned int const& x, unsigned int const& y) noexcept {
+		unsigned int value = 0U;
+		std::memcpy(&value, image.data() + (static_cast<size_t>(y) * TARGET_SIZE + x) * 4U, sizeof(value));
+		return value;
+	}
+
+	/**	@brief	記録したコマンド列を Vulkan で再生し、描いた色を読み戻して確かめる関数
+	 *	@details	転送とバリア、パイプラインと定数の設定、インデックス無しと付きの描画を一つの列に記録し、
+	 *				フレームごとに VKRenderer::execute で再生します。表示する場合はヘッドレスのサーフェスのスワップチェインへ表示します。
+	 *	@param[in] present スワップチェインへ表示するかどうか
+	 *	@return レンダラを初期化できたかどうか (できなければ何も確かめません)
+	 */
+	bool const replay(bool const& present) noexcept {
+		VKRendererDesc desc = {};
+		desc.application = "vk_replay_test";
+		desc.width = TARGET_SIZE;
+		desc.height = TARGET_SIZE;
+		desc.color = Float4(0.0f, 0.0f, 1.0f, 1.0f);
+		desc.present = present;
+		desc.vsync = false;
+
+		VKRenderer renderer;
+		if (!renderer.init(desc)) {
+			return false;
+		}
+
+		Scene scene = {};
+		bool const created = createScene(renderer, scene);
+		DLPH_CHECK(created);
+
+		VKResourceTable& table = renderer.getResourceTable();
+		RenderResource const staging = table.registerResource({ scene.staging, VK_NULL_HANDLE, 0U, 0U, 0U, VK_NULL_HANDLE });
+		RenderResource const vertices = table.registerResource({ scene.vertices, VK_NULL_HANDLE, 0U, 0U, 0U, VK_NULL_HANDLE });
+		RenderResource const indices = table.registerResource({ scene.indices, VK_NULL_HANDLE, 0U, 0U, 0U, VK_NULL_HANDLE });
+		RenderPipeline const pipeline = table.registerPipeline({ scene.pipeline, scene.layout, false });
+		table.setConstants(scene.set);
+		DLPH_CHECK(!created || (staging && vertices && indices && pipeline));
+
+		//	コピーと遷移はパスの外、描画はパスの中で記録される (バックエンドがパスを閉じて開き直す)
+		RenderCommandStream stream;
+		DLPH_CHECK(stream.init(1U << 12U));
+		stream.barrier(vertices, ResourceState::Common, ResourceState::CopyDest);
+		stream.barrier(indices, ResourceState::Common, ResourceState::CopyDest);
+		stream.copy(vertices, 0U, staging, 0U, sizeof(VERTICES));
+		stream.copy(indices, 0U, staging, sizeof(VERTICES), sizeof(INDICES));
+		stream.barrier(vertices, ResourceState::CopyDest, ResourceState::VertexAndConstant);
+		stream.barrier(indices, ResourceState::CopyDest, ResourceState::Index);
+		stream.setPipeline(pipeline);
+		stream.bindVertexBuffer(0U, vertices, sizeof(float) * 2U);
+		stream.bindConstants(0U, CONSTANT_STRIDE);
+		stream.draw(6U);
+		//	重複した設定は RenderStateFilter が取り除く
+		stream.setPipeline(pipeline);
+		stream.bindIndexBuffer(indices, IndexFormat::UInt16);
+		stream.bindConstants(0U, CONSTANT_STRIDE * 2U);
+		stream.drawIndexed(6U, 1U, 0U, 6);
+
+		//	同じ列は GPU を使わないバックエンドでも誤りにならない
+		HeadlessBackend headless;
+		stream.submit(headless);
+		DLPH_CHECK(headless.valid());
+		DLPH_CHECK(headless.stats().draws == 2U && headless.stats().copied == sizeof(VERTICES) + sizeof(INDICES));
+
+		std::vector<unsigned char> image(static_cast<size_t>(TARGET_SIZE) * TARGET_SIZE * 4U);
+		for (unsigned int frame = 0U; created && frame < FRAME_CNT; ++frame) {
+			DLPH_CHECK(renderer.before_rendering());
+			DLPH_CHECK(renderer.execute(stream, 1U));
+			DLPH_CHECK(renderer.after_rendering());
+			DLPH_CHECK(renderer.presenting());
+
+			std::memset(image.data(), 0, image.size());
+			DLPH_CHECK(renderer.readback(image.data(), image.size()));
+			DLPH_CHECK(pixel(image, TARGET_SIZE / 4U, TARGET_SIZE / 4U) == RED);
+			DLPH_CHECK(pixel(image, TARGET_SIZE * 3U / 4U, TARGET_SIZE / 4U) == GREEN);
+			DLPH_CHECK(pixel(image, TARGET_SIZE / 2U, TARGET_SIZE * 3U / 4U) == BLUE);
+		}
+
+		VKDevice::getInstance().waitIdle();
+		table.clear();
+		destroyScene(scene);
+		renderer.exit();
+		return true;
+	}
+}
+
+int main() {
+	if (!replay(false)) {
+		std::printf("vk_replay_test : SKIPPED (NO VULKAN DEVICE)\n");
+		return SKIPPED;
+	}
+	//	ヘッドレスのサーフェスが無い実装では表示だけを飛ばす
+	if (!replay(true)) {
+		std::printf("vk_replay_test : PRESENTATION SKIPPED (NO HEADLESS SURFACE)\n");
+	}
+	return dlph::test::finish("vk_replay_test");
+}